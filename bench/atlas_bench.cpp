@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_atlas.h"
+
+// Atlas packer benchmark: packing efficiency and speed of skyline vs maxrects on three sets
+// of small images, plus page composition throughput.
+// - icons:  1500 squares of 16/24/32/48/64 texels (UI icon sets);
+// - glyphs: 4000 rectangles 4-24 wide, 10-28 tall (font caches);
+// - mixed:  800 rectangles 8-160 on each side (decals, thumbnails).
+// Efficiency = image texels / used page texels (each page down to its lowest used row), with
+// 1 texel padding; "gutter+mip" adds a 2 texel gutter and 4-level mip alignment.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint32_t g_rng = 1u;
+static uint32_t randu() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+struct Set {
+    const char* name;
+    std::vector<int> sizes;
+};
+
+static Set makeSet(const char* name, int count, int kind) {
+    Set s{name, {}};
+    g_rng = 7u + (uint32_t)kind;
+    static const int kIcon[5] = {16, 24, 32, 48, 64};
+    for (int i = 0; i < count; i++) {
+        int w = 0, h = 0;
+        if (kind == 0) {
+            w = h = kIcon[randu() % 5];
+        } else if (kind == 1) {
+            w = 4 + (int)(randu() % 21);
+            h = 10 + (int)(randu() % 19);
+        } else {
+            w = 8 + (int)(randu() % 153);
+            h = 8 + (int)(randu() % 153);
+        }
+        s.sizes.push_back(w);
+        s.sizes.push_back(h);
+    }
+    return s;
+}
+
+static double usedEfficiency(const g4f_atlas_desc& d, const std::vector<g4f_atlas_rect>& rects, int pages) {
+    std::vector<int> lowest((size_t)pages, 0);
+    long long texels = 0;
+    for (const g4f_atlas_rect& r : rects) {
+        texels += (long long)r.width * r.height;
+        lowest[(size_t)r.page] = std::max(lowest[(size_t)r.page], std::min(d.pageHeight, r.y + r.height + d.gutter));
+    }
+    long long used = 0;
+    for (int rows : lowest) used += (long long)rows * d.pageWidth;
+    return used ? (double)texels / (double)used : 0.0;
+}
+
+int main() {
+    const Set sets[] = {makeSet("icons", 1500, 0), makeSet("glyphs", 4000, 1), makeSet("mixed", 800, 2)};
+    static const char* const kAlgorithms[] = {"skyline", "maxrects"};
+
+    std::printf("%-7s %-9s %-11s %6s %8s %10s %12s\n", "set", "packer", "options", "pages", "eff %", "pack ms", "rects/ms");
+    for (const Set& set : sets) {
+        const int count = (int)set.sizes.size() / 2;
+        for (int algorithm = 0; algorithm < 2; algorithm++) {
+            for (int variant = 0; variant < 2; variant++) {
+                g4f_atlas_desc d = g4f_atlas_desc_default();
+                d.algorithm = algorithm;
+                d.pageWidth = d.pageHeight = 1024;
+                d.padding = 1;
+                if (variant) {
+                    d.gutter = 2;
+                    d.mipLevels = 4;
+                }
+                std::vector<g4f_atlas_rect> rects((size_t)count);
+                int pages = 0;
+                double best = 1e9;
+                for (int run = 0; run < 5; run++) {
+                    const double t0 = secondsNow();
+                    pages = g4f_atlas_pack_rects(&d, set.sizes.data(), count, rects.data());
+                    best = std::min(best, secondsNow() - t0);
+                }
+                if (pages < 0) {
+                    std::printf("%s: pack failed: %s\n", set.name, g4f_last_error());
+                    return 1;
+                }
+                const double eff = usedEfficiency(d, rects, pages) * 100.0;
+                std::printf("%-7s %-9s %-11s %6d %8.1f %10.3f %12.0f\n", set.name, kAlgorithms[algorithm], variant ? "gutter+mip" : "pad 1",
+                            pages, eff, best * 1e3, (double)count / (best * 1e3));
+            }
+        }
+    }
+
+    // Full build of the icon set (copy + gutter extrusion), serial vs the job pool.
+    const Set& icons = sets[0];
+    const int count = (int)icons.sizes.size() / 2;
+    g4f_atlas_desc d = g4f_atlas_desc_default();
+    d.gutter = 2;
+    g4f_atlas* atlas = g4f_atlas_create(&d);
+    std::vector<uint8_t> pixels(64 * 64 * 4);
+    for (size_t i = 0; i < pixels.size(); i++) pixels[i] = (uint8_t)(i * 31u);
+    long long texels = 0;
+    for (int i = 0; i < count; i++) {
+        const int w = icons.sizes[(size_t)i * 2], h = icons.sizes[(size_t)i * 2 + 1];
+        g4f_atlas_add_rgba8(atlas, w, h, pixels.data(), 64 * 4);
+        texels += (long long)w * h;
+    }
+    g4f_jobs* jobs = g4f_jobs_create(0);
+    for (int pass = 0; pass < 2; pass++) {
+        g4f_jobs* pool = pass ? jobs : nullptr;
+        double best = 1e9;
+        int pages = 0;
+        for (int run = 0; run < 5; run++) {
+            const double t0 = secondsNow();
+            pages = g4f_atlas_build(atlas, pool);
+            best = std::min(best, secondsNow() - t0);
+        }
+        g4f_atlas_stats stats{};
+        g4f_atlas_get_stats(atlas, &stats);
+        std::printf("build icons (%s): %d pages, %.2f ms, %.0f MTexel/s of images, page eff %.1f %%\n",
+                    pool ? "jobs" : "serial", pages, best * 1e3, (double)texels / best / 1e6, stats.usedEfficiency * 100.0f);
+    }
+    g4f_jobs_destroy(jobs);
+    g4f_atlas_destroy(atlas);
+    return 0;
+}
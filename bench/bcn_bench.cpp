@@ -0,0 +1,98 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_bcn.h"
+#include "g4f/g4f_texsynth.h"
+
+// Block compression benchmark: four generated 512x512 textures (fBm color ramp, worley cells,
+// hard-edged checker, radial alpha gradient) encoded to BC1/BC3/BC7 at every quality level.
+// Reports encode throughput (single thread and on the job pool) and PSNR of the decoded result
+// against the source, for RGB and for alpha where the format stores it.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+struct Image {
+    const char* name;
+    std::vector<uint8_t> rgba;
+};
+
+static double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int c0, int c1) {
+    double sum = 0.0;
+    size_t n = 0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        for (int c = c0; c < c1; c++, n++) sum += ((double)a[i + (size_t)c] - b[i + (size_t)c]) * ((double)a[i + (size_t)c] - b[i + (size_t)c]);
+    }
+    const double mse = sum / (double)n;
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+int main() {
+    const int size = 512;
+    const g4f_texsynth_ramp_stop ramp[3] = {{0.0f, 0x1B2A12FFu}, {0.5f, 0x6E8B3DFFu}, {1.0f, 0xE4DCC8FFu}};
+    std::vector<Image> images;
+    auto add = [&](const char* name, int generator, bool withRamp, bool alphaFromRed) {
+        g4f_texsynth_desc desc = g4f_texsynth_desc_default(generator);
+        desc.octaves = 6;
+        if (withRamp) {
+            desc.ramp = ramp;
+            desc.rampCount = 3;
+        }
+        Image img{name, std::vector<uint8_t>((size_t)size * size * 4)};
+        g4f_texsynth_generate_rgba8(&desc, nullptr, size, size, img.rgba.data(), 0);
+        if (alphaFromRed) {
+            for (size_t i = 0; i < img.rgba.size(); i += 4) img.rgba[i + 3] = img.rgba[i];
+        }
+        images.push_back(std::move(img));
+    };
+    add("fbm ramp", G4F_TEXSYNTH_GRADIENT_NOISE, true, false);
+    add("worley", G4F_TEXSYNTH_WORLEY, true, false);
+    add("checker", G4F_TEXSYNTH_CHECKER, false, false);
+    add("radial alpha", G4F_TEXSYNTH_RADIAL_GRADIENT, false, true);
+
+    g4f_jobs* jobs = g4f_jobs_create(0);
+    std::printf("%dx%d images, %d job threads\n", size, size, g4f_jobs_thread_count(jobs));
+    std::printf("%-14s %-4s %-7s %10s %10s %8s %8s\n", "image", "fmt", "quality", "MPix/s 1T", "MPix/s MT", "PSNR rgb", "PSNR a");
+    static const char* const kFormats[] = {"", "bc1", "bc3", "bc7"};
+    static const char* const kQualities[] = {"fast", "normal", "high"};
+    std::vector<uint8_t> blocks, decoded((size_t)size * size * 4);
+    for (const Image& img : images) {
+        for (int format = G4F_BCN_BC1; format <= G4F_BCN_BC7; format++) {
+            // BC1 turns the low-alpha half into transparent black; its RGB PSNR would be meaningless.
+            if (format == G4F_BCN_BC1 && &img == &images.back()) continue;
+            blocks.resize(g4f_bcn_chain_bytes(format, size, size, 1));
+            for (int quality = G4F_BCN_QUALITY_FAST; quality <= G4F_BCN_QUALITY_HIGH; quality++) {
+                double start = secondsNow();
+                g4f_bcn_encode_rgba8(img.rgba.data(), size, size, 0, format, quality, nullptr, blocks.data());
+                const double single = secondsNow() - start;
+                double multi = 1e9;
+                for (int r = 0; r < 3; r++) {
+                    start = secondsNow();
+                    g4f_bcn_encode_rgba8(img.rgba.data(), size, size, 0, format, quality, jobs, blocks.data());
+                    multi = std::min(multi, secondsNow() - start);
+                }
+                g4f_bcn_decode_rgba8(blocks.data(), format, size, size, decoded.data(), 0);
+                const double mpix = (double)size * size / 1e6;
+                char alpha[16] = "-";
+                if (format != G4F_BCN_BC1) std::snprintf(alpha, sizeof(alpha), "%.2f", psnr(img.rgba, decoded, 3, 4));
+                std::printf("%-14s %-4s %-7s %10.2f %10.2f %8.2f %8s\n", img.name, kFormats[format], kQualities[quality], mpix / single, mpix / multi,
+                            psnr(img.rgba, decoded, 0, 3), alpha);
+            }
+        }
+    }
+
+    // Decoder throughput (the software path and the tests use it).
+    blocks.resize(g4f_bcn_chain_bytes(G4F_BCN_BC7, size, size, 1));
+    g4f_bcn_encode_rgba8(images[0].rgba.data(), size, size, 0, G4F_BCN_BC7, G4F_BCN_QUALITY_FAST, jobs, blocks.data());
+    for (int format = G4F_BCN_BC1; format <= G4F_BCN_BC7; format++) {
+        const double start = secondsNow();
+        for (int r = 0; r < 10; r++) g4f_bcn_decode_rgba8(blocks.data(), format, size, size, decoded.data(), 0);
+        std::printf("decode %s: %.1f MPix/s\n", kFormats[format], 10.0 * size * size / 1e6 / (secondsNow() - start));
+    }
+    g4f_jobs_destroy(jobs);
+    return 0;
+}
@@ -0,0 +1,172 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_bvh.h"
+
+// Reports BVH build time and ray throughput (Mrays/s) on generated meshes: one 512x512 terrain
+// (524k triangles) and a scene of 1024 instances of a 32k-triangle sphere, for coherent camera
+// rays and incoherent random rays, across thread counts. Also times a scene refit with every
+// instance moved.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint32_t g_rng = 1u;
+static float randf(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+struct Mesh {
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+static void gridIndices(Mesh& m, int nx, int nz) {
+    for (int z = 0; z < nz; z++) {
+        for (int x = 0; x < nx; x++) {
+            const uint32_t i = (uint32_t)(z * (nx + 1) + x);
+            const uint32_t row = (uint32_t)nx + 1u;
+            const uint32_t quad[6] = {i, i + row, i + 1u, i + 1u, i + row, i + row + 1u};
+            m.indices.insert(m.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+static Mesh makeTerrain(int n, float size) {
+    Mesh m;
+    for (int z = 0; z <= n; z++) {
+        for (int x = 0; x <= n; x++) {
+            const float fx = ((float)x / (float)n - 0.5f) * size;
+            const float fz = ((float)z / (float)n - 0.5f) * size;
+            m.positions.push_back(g4f_vec3{fx, 3.0f * std::sin(fx * 0.11f) * std::cos(fz * 0.07f) + 0.5f * std::sin(fx * 0.9f + fz * 0.6f), fz});
+        }
+    }
+    gridIndices(m, n, n);
+    return m;
+}
+
+static Mesh makeSphere(int rings, int segments) {
+    Mesh m;
+    for (int r = 0; r <= rings; r++) {
+        const float phi = 3.14159265f * (float)r / (float)rings;
+        for (int s = 0; s <= segments; s++) {
+            const float theta = 6.2831853f * (float)s / (float)segments;
+            m.positions.push_back(g4f_vec3{std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta)});
+        }
+    }
+    gridIndices(m, segments, rings);
+    return m;
+}
+
+static g4f_bvh_mesh* buildMesh(const Mesh& m, double* ms) {
+    g4f_bvh_mesh_desc d = g4f_bvh_mesh_desc_default();
+    d.positions = m.positions.data();
+    d.vertexCount = (int)m.positions.size();
+    d.indices32 = m.indices.data();
+    d.indexCount = (int)m.indices.size();
+    const double start = secondsNow();
+    g4f_bvh_mesh* bvh = g4f_bvh_mesh_create(&d);
+    *ms = (secondsNow() - start) * 1000.0;
+    return bvh;
+}
+
+// Camera rays over a 1024x1024 image looking down at the scene.
+static std::vector<g4f_bvh_ray> cameraRays(g4f_vec3 eye, float halfWidth, float height) {
+    std::vector<g4f_bvh_ray> rays;
+    const int res = 1024;
+    rays.reserve((size_t)res * res);
+    for (int y = 0; y < res; y++) {
+        for (int x = 0; x < res; x++) {
+            const float sx = ((float)x / (float)res * 2.0f - 1.0f) * halfWidth;
+            const float sz = ((float)y / (float)res * 2.0f - 1.0f) * halfWidth;
+            rays.push_back(g4f_bvh_ray{eye, g4f_vec3{sx, -height, sz + height * 0.5f}, 10.0f});
+        }
+    }
+    return rays;
+}
+
+static std::vector<g4f_bvh_ray> randomRays(float extent, int count) {
+    std::vector<g4f_bvh_ray> rays((size_t)count);
+    for (g4f_bvh_ray& r : rays) {
+        r.origin = g4f_vec3{randf(-extent, extent), randf(0.0f, 20.0f), randf(-extent, extent)};
+        r.dir = g4f_vec3{randf(-1.0f, 1.0f), randf(-1.0f, 0.2f), randf(-1.0f, 1.0f)};
+        r.tMax = 1000.0f;
+    }
+    return rays;
+}
+
+static void runRays(const char* name, const g4f_bvh_scene* scene, const std::vector<g4f_bvh_ray>& rays, const std::vector<int>& threadCounts) {
+    std::vector<g4f_bvh_hit> hits(rays.size());
+    for (int threads : threadCounts) {
+        g4f_jobs* jobs = g4f_jobs_create(threads);
+        int runs = 0;
+        int hitCount = 0;
+        double elapsed = 0.0;
+        for (double start = secondsNow(); elapsed < 0.5 || runs < 2; elapsed = secondsNow() - start) {
+            hitCount = g4f_bvh_scene_raycast_batch(scene, rays.data(), (int)rays.size(), hits.data(), jobs);
+            runs++;
+        }
+        const double mrays = (double)rays.size() * runs / elapsed / 1e6;
+        std::printf("%-22s %8d %10.2f %9.1f%%\n", name, threads, mrays, 100.0 * hitCount / (double)rays.size());
+        g4f_jobs_destroy(jobs);
+    }
+}
+
+int main() {
+    std::vector<int> threadCounts;
+    for (int t = 1; t < g4f_jobs_hardware_threads(); t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(g4f_jobs_hardware_threads());
+
+    const Mesh terrain = makeTerrain(512, 200.0f);
+    const Mesh sphere = makeSphere(128, 128);
+    double terrainMs = 0.0, sphereMs = 0.0;
+    g4f_bvh_mesh* terrainBvh = buildMesh(terrain, &terrainMs);
+    g4f_bvh_mesh* sphereBvh = buildMesh(sphere, &sphereMs);
+    g4f_bvh_stats stats{};
+    g4f_bvh_mesh_get_stats(terrainBvh, &stats);
+    std::printf("terrain: %d triangles, build %.1f ms, %d nodes, depth %d, SAH %.1f\n", stats.primitives, terrainMs, stats.nodes, stats.depth, stats.sahCost);
+    g4f_bvh_mesh_get_stats(sphereBvh, &stats);
+    std::printf("sphere: %d triangles, build %.1f ms, %d nodes, depth %d, SAH %.1f\n", stats.primitives, sphereMs, stats.nodes, stats.depth, stats.sahCost);
+
+    g4f_bvh_scene* terrainScene = g4f_bvh_scene_create();
+    g4f_bvh_scene_add(terrainScene, terrainBvh, nullptr);
+    g4f_bvh_scene_build(terrainScene);
+
+    g4f_bvh_scene* spheres = g4f_bvh_scene_create();
+    std::vector<g4f_mat4> transforms;
+    for (int i = 0; i < 1024; i++) {
+        const float s = randf(0.5f, 3.0f);
+        transforms.push_back(g4f_mat4_trs(g4f_vec3{randf(-90.0f, 90.0f), randf(0.0f, 10.0f), randf(-90.0f, 90.0f)}, g4f_quat_identity(), g4f_vec3{s, s, s}));
+        g4f_bvh_scene_add(spheres, sphereBvh, &transforms.back());
+    }
+    double start = secondsNow();
+    g4f_bvh_scene_build(spheres);
+    const double tlasMs = (secondsNow() - start) * 1000.0;
+    for (int i = 0; i < 1024; i++) {
+        transforms[(size_t)i].m[13] += 0.5f;
+        g4f_bvh_scene_set_transform(spheres, i, &transforms[(size_t)i]);
+    }
+    start = secondsNow();
+    g4f_bvh_scene_refit(spheres);
+    const double refitMs = (secondsNow() - start) * 1000.0;
+    std::printf("instances: 1024, TLAS build %.3f ms, refit (all moved) %.3f ms\n", tlasMs, refitMs);
+
+    const std::vector<g4f_bvh_ray> primary = cameraRays(g4f_vec3{0.0f, 60.0f, -30.0f}, 60.0f, 60.0f);
+    const std::vector<g4f_bvh_ray> incoherent = randomRays(100.0f, 1 << 20);
+    std::printf("%-22s %8s %10s %10s\n", "case", "threads", "Mrays/s", "hit");
+    runRays("terrain primary", terrainScene, primary, threadCounts);
+    runRays("terrain random", terrainScene, incoherent, threadCounts);
+    runRays("instances primary", spheres, primary, threadCounts);
+    runRays("instances random", spheres, incoherent, threadCounts);
+
+    g4f_bvh_scene_destroy(spheres);
+    g4f_bvh_scene_destroy(terrainScene);
+    g4f_bvh_mesh_destroy(sphereBvh);
+    g4f_bvh_mesh_destroy(terrainBvh);
+    return 0;
+}
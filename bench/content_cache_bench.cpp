@@ -0,0 +1,135 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <string>
+#include <vector>
+
+#include "g4f/g4f_content_cache.h"
+
+// Startup benchmark for a procedurally generated scene: 48 fBm/worley textures (256x256 RGBA8,
+// 6 octaves) and 24 noise terrain tiles (129x129 vertex grids with normals), about 24 MB.
+// - cold: empty cache directory, everything is generated on the job system and stored;
+// - warm: a new cache instance over the same directory maps every result instead (one byte per
+//   cache line is read so the pages are really faulted in).
+// The page cache is warm for the warm run; dropping the OS file cache first shows the disk cost.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint64_t touch(const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i += 64) sum += p[i];
+    return sum;
+}
+
+constexpr int kTextures = 48;
+constexpr int kTiles = 24;
+constexpr int kGrid = 129;
+
+struct TerrainParams {
+    uint32_t seed;
+    int tileX, tileZ;
+    float height;
+};
+
+// Heightfield from gradient-noise fBm, then a vertex grid with central-difference normals.
+static bool generateTerrain(const TerrainParams& p, g4f_jobs* jobs, std::vector<g4f_gfx_vertex_p3n3uv2>* out) {
+    g4f_texsynth_desc desc = g4f_texsynth_desc_default(G4F_TEXSYNTH_GRADIENT_NOISE);
+    desc.seed = p.seed;
+    desc.octaves = 8;
+    desc.frequency = 4.0f;
+    desc.offsetX = (float)(p.tileX * (kGrid - 1));
+    desc.offsetY = (float)(p.tileZ * (kGrid - 1));
+    std::vector<float> heights((size_t)kGrid * kGrid);
+    if (!g4f_texsynth_generate_r32f(&desc, jobs, kGrid, kGrid, heights.data(), 0)) return false;
+    out->resize(heights.size());
+    for (int z = 0; z < kGrid; z++) {
+        for (int x = 0; x < kGrid; x++) {
+            auto h = [&](int xi, int zi) {
+                xi = xi < 0 ? 0 : (xi >= kGrid ? kGrid - 1 : xi);
+                zi = zi < 0 ? 0 : (zi >= kGrid ? kGrid - 1 : zi);
+                return heights[(size_t)zi * kGrid + (size_t)xi] * p.height;
+            };
+            const float dx = h(x + 1, z) - h(x - 1, z), dz = h(x, z + 1) - h(x, z - 1);
+            const float len = std::sqrt(dx * dx + 4.0f + dz * dz);
+            (*out)[(size_t)z * kGrid + (size_t)x] = g4f_gfx_vertex_p3n3uv2{(float)x, h(x, z), (float)z, -dx / len, 2.0f / len, -dz / len,
+                                                                          (float)x / (kGrid - 1), (float)z / (kGrid - 1)};
+        }
+    }
+    return true;
+}
+
+// One startup: every texture and terrain tile through the cache. Returns seconds.
+static double loadScene(const std::string& dir, g4f_jobs* jobs, uint64_t* sink, g4f_content_cache_stats* stats) {
+    const double start = secondsNow();
+    g4f_content_cache_desc cacheDesc{};
+    cacheDesc.dirUtf8 = dir.c_str();
+    g4f_content_cache* cache = g4f_content_cache_open(&cacheDesc);
+    if (!cache) return -1.0;
+
+    const g4f_texsynth_ramp_stop ramp[3] = {{0.0f, 0x20301AFFu}, {0.55f, 0x6A7F3AFFu}, {1.0f, 0xD8D2C0FFu}};
+    for (int t = 0; t < kTextures; t++) {
+        g4f_texsynth_desc desc = g4f_texsynth_desc_default(t % 3 == 2 ? G4F_TEXSYNTH_WORLEY : G4F_TEXSYNTH_GRADIENT_NOISE);
+        desc.seed = (uint32_t)t * 7919u + 1u;
+        desc.octaves = 6;
+        desc.ramp = ramp;
+        desc.rampCount = 3;
+        const uint8_t* pixels = g4f_content_cache_texsynth_rgba8(cache, &desc, 256, 256, jobs);
+        if (!pixels) return -1.0;
+        *sink += touch(pixels, 256 * 256 * 4);
+    }
+
+    std::vector<g4f_gfx_vertex_p3n3uv2> vertices;
+    for (int i = 0; i < kTiles; i++) {
+        const TerrainParams params{42u, i % 6, i / 6, 24.0f};
+        const uint64_t key = g4f_content_cache_key("bench_terrain", 1, &params, sizeof(params));
+        size_t size = 0;
+        const void* hit = g4f_content_cache_get(cache, key, &size);
+        if (!hit) {
+            if (!generateTerrain(params, jobs, &vertices)) return -1.0;
+            g4f_content_cache_put(cache, key, vertices.data(), vertices.size() * sizeof(vertices[0]));
+            hit = vertices.data();
+            size = vertices.size() * sizeof(vertices[0]);
+        }
+        *sink += touch(hit, size);
+    }
+    g4f_content_cache_get_stats(cache, stats);
+    g4f_content_cache_close(cache);
+    return secondsNow() - start;
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "g4f_content_cache_bench";
+    const std::string dirUtf8 = dir.string();
+    g4f_jobs* jobs = g4f_jobs_create(0);
+    std::printf("%d textures + %d terrain tiles, %d job threads\n", kTextures, kTiles, g4f_jobs_hardware_threads());
+
+    uint64_t sink = 0;
+    const int runs = 5;
+    double coldBest = 1e9, warmBest = 1e9;
+    g4f_content_cache_stats cold{}, warm{};
+    for (int r = 0; r < runs; r++) {
+        std::filesystem::remove_all(dir);
+        const double c = loadScene(dirUtf8, jobs, &sink, &cold);
+        const double w = loadScene(dirUtf8, jobs, &sink, &warm);
+        if (c < 0.0 || w < 0.0) {
+            std::fprintf(stderr, "content cache failed: %s\n", g4f_last_error());
+            return 1;
+        }
+        coldBest = c < coldBest ? c : coldBest;
+        warmBest = w < warmBest ? w : warmBest;
+    }
+    std::printf("%-28s %10s %6s %6s %6s %10s\n", "startup", "best ms", "hits", "misses", "puts", "disk MB");
+    std::printf("%-28s %10.2f %6llu %6llu %6llu %10.1f\n", "cold (generate + store)", coldBest * 1000.0, (unsigned long long)cold.hits,
+                (unsigned long long)cold.misses, (unsigned long long)cold.puts, (double)cold.bytes / (1 << 20));
+    std::printf("%-28s %10.2f %6llu %6llu %6llu %10.1f\n", "warm (map hits)", warmBest * 1000.0, (unsigned long long)warm.hits,
+                (unsigned long long)warm.misses, (unsigned long long)warm.puts, (double)warm.bytes / (1 << 20));
+    std::printf("speedup %.1fx (checksum %llu)\n", coldBest / warmBest, (unsigned long long)(sink & 0xFFFF));
+    g4f_jobs_destroy(jobs);
+    std::filesystem::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,86 @@
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_ecs.h"
+
+// Reports ECS system throughput for 1M entities (TRANSFORM + WORLD + velocity): an integrate
+// system writing positions, the built-in transform update, and a read-only reduction, across
+// thread counts.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+struct Velocity {
+    float x, y, z;
+};
+
+static void integrate(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)user;
+    (void)workerIndex;
+    auto* t = static_cast<g4f_ecs_transform*>(chunk->columns[0]);
+    const auto* v = static_cast<const Velocity*>(chunk->columns[1]);
+    const float dt = 1.0f / 60.0f;
+    for (int i = 0; i < chunk->count; i++) {
+        t[i].position.x += v[i].x * dt;
+        t[i].position.y += v[i].y * dt;
+        t[i].position.z += v[i].z * dt;
+    }
+}
+
+static void sumHeights(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)workerIndex;
+    const auto* world = static_cast<const g4f_mat4*>(chunk->columns[0]);
+    float sum = 0.0f;
+    for (int i = 0; i < chunk->count; i++) sum += world[i].m[13];
+    static_cast<std::atomic<int>*>(user)->fetch_add((int)sum, std::memory_order_relaxed);
+}
+
+template <typename Fn>
+static double msPerRun(Fn&& fn) {
+    int runs = 0;
+    double elapsed = 0.0;
+    for (double start = secondsNow(); elapsed < 0.5 && runs < 1000; elapsed = secondsNow() - start) {
+        fn();
+        runs++;
+    }
+    return elapsed * 1000.0 / runs;
+}
+
+int main() {
+    const int kEntities = 1000000;
+    g4f_ecs* ecs = g4f_ecs_create();
+    const Velocity initial{1.0f, 0.5f, -1.0f};
+    const int velocity = g4f_ecs_register_component(ecs, "velocity", (int)sizeof(Velocity), 4, &initial);
+    const int comps[] = {G4F_ECS_TRANSFORM, G4F_ECS_WORLD, velocity};
+    g4f_ecs_spawn(ecs, comps, 3, kEntities, nullptr);
+
+    const int moveIds[] = {G4F_ECS_TRANSFORM, velocity};
+    const int worldIds[] = {G4F_ECS_WORLD};
+    g4f_ecs_query* moveQuery = g4f_ecs_query_create(ecs, moveIds, 2, nullptr, 0);
+    g4f_ecs_query* worldQuery = g4f_ecs_query_create(ecs, worldIds, 1, nullptr, 0);
+    const g4f_ecs_system move = {"integrate", moveQuery, G4F_ECS_BIT(G4F_ECS_TRANSFORM), integrate, nullptr};
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < g4f_jobs_hardware_threads(); t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(g4f_jobs_hardware_threads());
+
+    std::printf("%d entities\n", kEntities);
+    std::printf("%-18s %8s %10s %14s\n", "case", "threads", "ms/run", "Mentities/s");
+    for (int threads : threadCounts) {
+        g4f_jobs* jobs = g4f_jobs_create(threads);
+        const double msMove = msPerRun([&] { g4f_ecs_run_systems(ecs, &move, 1, jobs); });
+        const double msWorld = msPerRun([&] { g4f_ecs_update_transforms(ecs, jobs); });
+        std::atomic<int> sink{0};
+        const double msRead = msPerRun([&] { g4f_ecs_query_run(worldQuery, jobs, sumHeights, &sink); });
+        std::printf("%-18s %8d %10.3f %14.1f\n", "integrate", threads, msMove, kEntities / (msMove * 1000.0));
+        std::printf("%-18s %8d %10.3f %14.1f\n", "update_transforms", threads, msWorld, kEntities / (msWorld * 1000.0));
+        std::printf("%-18s %8d %10.3f %14.1f\n", "read world", threads, msRead, kEntities / (msRead * 1000.0));
+        g4f_jobs_destroy(jobs);
+    }
+    g4f_ecs_destroy(ecs);
+    return 0;
+}
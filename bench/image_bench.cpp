@@ -0,0 +1,416 @@
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "g4f/g4f_image.h"
+#include "g4f/g4f_texsynth.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <wincodec.h>
+#endif
+
+// Image decode benchmark.
+// - Corpus: the PNG/TGA/QOI files of a directory given on the command line, or a generated one:
+//   32 images of 256x256 (flat UI-style gradients and checkers with alpha, fBm and worley
+//   textures) written as PNG (adaptive filters, greedy LZ77 + fixed Huffman), RLE TGA and QOI.
+// - Reports single-thread decode throughput from memory and g4f_image_batch_load throughput
+//   (files mapped and decoded on the job pool).
+// - Reference: on Windows the same PNG bytes are also decoded through WIC (the g4f_bitmap_load
+//   path) to 32bpp RGBA.
+
+using Bytes = std::vector<uint8_t>;
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static void putBe32(Bytes& b, uint32_t v) {
+    for (int s = 24; s >= 0; s -= 8) b.push_back((uint8_t)(v >> s));
+}
+
+static uint32_t crc32(const uint8_t* p, size_t n) {
+    static uint32_t table[256];
+    if (!table[1]) {
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+            table[i] = c;
+        }
+    }
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++) c = table[(c ^ p[i]) & 255] ^ (c >> 8);
+    return ~c;
+}
+
+struct BitWriter {
+    Bytes out;
+    uint64_t acc = 0;
+    int count = 0;
+    void put(uint32_t v, int n) {
+        acc |= (uint64_t)v << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back((uint8_t)acc);
+            acc >>= 8;
+            count -= 8;
+        }
+    }
+    void putCode(uint32_t code, int n) {
+        uint32_t r = 0;
+        for (int i = 0; i < n; i++) r |= ((code >> i) & 1u) << (n - 1 - i);
+        put(r, n);
+    }
+};
+
+static void fixedSymbol(BitWriter& b, int v) {
+    if (v < 144) b.putCode(0x30u + (uint32_t)v, 8);
+    else if (v < 256) b.putCode(0x190u + (uint32_t)(v - 144), 9);
+    else if (v < 280) b.putCode((uint32_t)(v - 256), 7);
+    else b.putCode(0xC0u + (uint32_t)(v - 280), 8);
+}
+
+// zlib stream with greedy single-candidate LZ77 (about zlib level 1) and the fixed Huffman code.
+static Bytes deflateFixed(const Bytes& raw) {
+    static const int kLenBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+    static const int kLenExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+    static const int kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                      1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+    static const int kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+    BitWriter b;
+    b.put(0x78, 8);
+    b.put(0x01, 8);
+    b.put(1, 1);
+    b.put(1, 2);
+    std::vector<int> head(1 << 15, -1);
+    size_t i = 0;
+    while (i < raw.size()) {
+        size_t best = 0, dist = 0;
+        if (i + 3 <= raw.size()) {
+            const uint32_t h = ((uint32_t)raw[i] << 16 | (uint32_t)raw[i + 1] << 8 | raw[i + 2]) * 2654435761u >> 17;
+            const int cand = head[h];
+            head[h] = (int)i;
+            if (cand >= 0 && i - (size_t)cand <= 32768) {
+                size_t n = 0;
+                while (n < 258 && i + n < raw.size() && raw[(size_t)cand + n] == raw[i + n]) n++;
+                if (n >= 3) {
+                    best = n;
+                    dist = i - (size_t)cand;
+                }
+            }
+        }
+        if (!best) {
+            fixedSymbol(b, raw[i++]);
+            continue;
+        }
+        int lc = 28;
+        while (kLenBase[lc] > (int)best) lc--;
+        fixedSymbol(b, 257 + lc);
+        b.put((uint32_t)((int)best - kLenBase[lc]), kLenExtra[lc]);
+        int dc = 29;
+        while (kDistBase[dc] > (int)dist) dc--;
+        b.putCode((uint32_t)dc, 5);
+        b.put((uint32_t)((int)dist - kDistBase[dc]), kDistExtra[dc]);
+        i += best;
+    }
+    fixedSymbol(b, 256);
+    if (b.count) b.put(0, 8 - b.count);
+    uint32_t s1 = 1, s2 = 0;
+    for (uint8_t v : raw) {
+        s1 = (s1 + v) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+    putBe32(b.out, s2 << 16 | s1);
+    return b.out;
+}
+
+static void putChunk(Bytes& png, const char* type, const Bytes& body) {
+    putBe32(png, (uint32_t)body.size());
+    const size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), body.begin(), body.end());
+    putBe32(png, crc32(png.data() + start, png.size() - start));
+}
+
+// RGBA8 PNG; each row takes the filter with the smallest sum of absolute residuals (libpng's heuristic).
+static Bytes encodePng(const uint8_t* px, int w, int h) {
+    const size_t stride = (size_t)w * 4;
+    Bytes raw, zero(stride, 0), best, trial(stride);
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = px + (size_t)y * stride;
+        const uint8_t* prev = y ? row - stride : zero.data();
+        long bestSum = -1;
+        int bestFilter = 0;
+        for (int f = 0; f < 5; f++) {
+            long sum = 0;
+            for (size_t i = 0; i < stride; i++) {
+                const int a = i >= 4 ? row[i - 4] : 0, b = prev[i], c = i >= 4 ? prev[i - 4] : 0;
+                int pred = 0;
+                if (f == 1) pred = a;
+                if (f == 2) pred = b;
+                if (f == 3) pred = (a + b) / 2;
+                if (f == 4) {
+                    const int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    pred = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+                }
+                trial[i] = (uint8_t)(row[i] - pred);
+                sum += trial[i] < 128 ? trial[i] : 256 - trial[i];
+            }
+            if (bestSum < 0 || sum < bestSum) {
+                bestSum = sum;
+                bestFilter = f;
+                best = trial;
+            }
+        }
+        raw.push_back((uint8_t)bestFilter);
+        raw.insert(raw.end(), best.begin(), best.end());
+    }
+    Bytes png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    Bytes ihdr;
+    putBe32(ihdr, (uint32_t)w);
+    putBe32(ihdr, (uint32_t)h);
+    ihdr.insert(ihdr.end(), {8, 6, 0, 0, 0});
+    putChunk(png, "IHDR", ihdr);
+    putChunk(png, "IDAT", deflateFixed(raw));
+    putChunk(png, "IEND", {});
+    return png;
+}
+
+// 32-bit top-down RLE TGA.
+static Bytes encodeTga(const uint8_t* px, int w, int h) {
+    Bytes t(18, 0);
+    t[2] = 10;
+    t[12] = (uint8_t)w;
+    t[13] = (uint8_t)(w >> 8);
+    t[14] = (uint8_t)h;
+    t[15] = (uint8_t)(h >> 8);
+    t[16] = 32;
+    t[17] = 8 | 0x20;
+    const size_t n = (size_t)w * h;
+    auto same = [&](size_t a, size_t b) { return std::memcmp(px + a * 4, px + b * 4, 4) == 0; };
+    auto bgra = [&](size_t i) { t.insert(t.end(), {px[i * 4 + 2], px[i * 4 + 1], px[i * 4], px[i * 4 + 3]}); };
+    for (size_t i = 0; i < n;) {
+        // Packets never cross scanlines (TGA 2.0 recommendation; some readers depend on it).
+        const size_t rowEnd = (i / (size_t)w + 1) * (size_t)w;
+        size_t run = 1;
+        while (i + run < rowEnd && run < 128 && same(i, i + run)) run++;
+        if (run > 1) {
+            t.push_back((uint8_t)(0x80 | (run - 1)));
+            bgra(i);
+            i += run;
+            continue;
+        }
+        size_t lit = 1;
+        while (i + lit < rowEnd && lit < 128 && !(i + lit + 1 < rowEnd && same(i + lit, i + lit + 1))) lit++;
+        t.push_back((uint8_t)(lit - 1));
+        for (size_t k = 0; k < lit; k++) bgra(i + k);
+        i += lit;
+    }
+    return t;
+}
+
+static Bytes encodeQoi(const uint8_t* px, int w, int h) {
+    Bytes q = {'q', 'o', 'i', 'f'};
+    putBe32(q, (uint32_t)w);
+    putBe32(q, (uint32_t)h);
+    q.insert(q.end(), {4, 0});
+    uint8_t index[64][4] = {};
+    uint8_t prev[4] = {0, 0, 0, 255};
+    int run = 0;
+    const size_t n = (size_t)w * h;
+    for (size_t i = 0; i < n; i++) {
+        const uint8_t* p = px + i * 4;
+        if (std::memcmp(p, prev, 4) == 0) {
+            if (++run == 62 || i + 1 == n) {
+                q.push_back((uint8_t)(0xC0 | (run - 1)));
+                run = 0;
+            }
+            continue;
+        }
+        if (run) {
+            q.push_back((uint8_t)(0xC0 | (run - 1)));
+            run = 0;
+        }
+        const int slot = (p[0] * 3 + p[1] * 5 + p[2] * 7 + p[3] * 11) & 63;
+        if (std::memcmp(index[slot], p, 4) == 0) {
+            q.push_back((uint8_t)slot);
+        } else {
+            std::memcpy(index[slot], p, 4);
+            const int dr = (int8_t)(p[0] - prev[0]), dg = (int8_t)(p[1] - prev[1]), db = (int8_t)(p[2] - prev[2]);
+            if (p[3] != prev[3]) {
+                q.insert(q.end(), {0xFF, p[0], p[1], p[2], p[3]});
+            } else if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+                q.push_back((uint8_t)(0x40 | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+            } else if (dg >= -32 && dg <= 31 && dr - dg >= -8 && dr - dg <= 7 && db - dg >= -8 && db - dg <= 7) {
+                q.push_back((uint8_t)(0x80 | (dg + 32)));
+                q.push_back((uint8_t)((dr - dg + 8) << 4 | (db - dg + 8)));
+            } else {
+                q.insert(q.end(), {0xFE, p[0], p[1], p[2]});
+            }
+        }
+        std::memcpy(prev, p, 4);
+    }
+    q.insert(q.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+    return q;
+}
+
+struct CorpusFile {
+    std::string path;
+    Bytes data;
+    int format = 0;
+    int width = 0, height = 0;
+};
+
+static std::vector<CorpusFile> generateCorpus(const std::filesystem::path& dir) {
+    std::filesystem::create_directories(dir);
+    std::vector<CorpusFile> files;
+    const g4f_texsynth_ramp_stop ramp[3] = {{0.0f, 0x2A3B52FFu}, {0.5f, 0x9AB7D3FFu}, {1.0f, 0xF2EEE4FFu}};
+    const int size = 256;
+    std::vector<uint8_t> px((size_t)size * size * 4);
+    for (int i = 0; i < 32; i++) {
+        static const int kGenerators[4] = {G4F_TEXSYNTH_LINEAR_GRADIENT, G4F_TEXSYNTH_CHECKER, G4F_TEXSYNTH_GRADIENT_NOISE, G4F_TEXSYNTH_WORLEY};
+        g4f_texsynth_desc desc = g4f_texsynth_desc_default(kGenerators[i % 4]);
+        desc.seed = (uint32_t)i + 1u;
+        desc.octaves = 5;
+        desc.ramp = ramp;
+        desc.rampCount = 3;
+        g4f_texsynth_generate_rgba8(&desc, nullptr, size, size, px.data(), 0);
+        if (i % 4 < 2) {
+            // UI-style: quantized colors and a rounded-rect alpha mask.
+            for (int y = 0; y < size; y++) {
+                for (int x = 0; x < size; x++) {
+                    uint8_t* p = &px[((size_t)y * size + x) * 4];
+                    for (int c = 0; c < 3; c++) p[c] &= 0xF0;
+                    const int dx = std::max(0, std::abs(x - 128) - 96), dy = std::max(0, std::abs(y - 128) - 96);
+                    p[3] = dx * dx + dy * dy > 24 * 24 ? 0 : 255;
+                }
+            }
+        }
+        const Bytes encoded[3] = {encodePng(px.data(), size, size), encodeTga(px.data(), size, size), encodeQoi(px.data(), size, size)};
+        static const char* const kExt[3] = {".png", ".tga", ".qoi"};
+        for (int f = 0; f < 3; f++) {
+            CorpusFile file;
+            file.path = (dir / ("img" + std::to_string(i) + kExt[f])).string();
+            file.data = encoded[f];
+            std::ofstream(file.path, std::ios::binary).write((const char*)file.data.data(), (std::streamsize)file.data.size());
+            files.push_back(std::move(file));
+        }
+    }
+    return files;
+}
+
+static std::vector<CorpusFile> readCorpus(const char* dir) {
+    std::vector<CorpusFile> files;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        std::ifstream in(entry.path(), std::ios::binary);
+        CorpusFile file;
+        file.path = entry.path().string();
+        file.data.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+        files.push_back(std::move(file));
+    }
+    return files;
+}
+
+#ifdef _WIN32
+// WIC reference decode to 32bpp RGBA (straight alpha, like g4f_image).
+static bool wicDecode(IWICImagingFactory* factory, const Bytes& data, std::vector<uint8_t>& px) {
+    IWICStream* stream = nullptr;
+    IWICBitmapDecoder* decoder = nullptr;
+    IWICBitmapFrameDecode* frame = nullptr;
+    IWICFormatConverter* converter = nullptr;
+    UINT w = 0, h = 0;
+    bool ok = SUCCEEDED(factory->CreateStream(&stream)) && SUCCEEDED(stream->InitializeFromMemory((BYTE*)data.data(), (DWORD)data.size())) &&
+              SUCCEEDED(factory->CreateDecoderFromStream(stream, nullptr, WICDecodeMetadataCacheOnDemand, &decoder)) &&
+              SUCCEEDED(decoder->GetFrame(0, &frame)) && SUCCEEDED(factory->CreateFormatConverter(&converter)) &&
+              SUCCEEDED(converter->Initialize(frame, GUID_WICPixelFormat32bppRGBA, WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom)) &&
+              SUCCEEDED(frame->GetSize(&w, &h));
+    if (ok) {
+        px.resize((size_t)w * h * 4);
+        ok = SUCCEEDED(converter->CopyPixels(nullptr, w * 4, (UINT)px.size(), px.data()));
+    }
+    if (converter) converter->Release();
+    if (frame) frame->Release();
+    if (decoder) decoder->Release();
+    if (stream) stream->Release();
+    return ok;
+}
+#endif
+
+int main(int argc, char** argv) {
+    const std::filesystem::path tempDir = std::filesystem::temp_directory_path() / "g4f_image_bench";
+    std::vector<CorpusFile> files = argc > 1 ? readCorpus(argv[1]) : generateCorpus(tempDir);
+    std::vector<CorpusFile> usable;
+    for (CorpusFile& f : files) {
+        if (g4f_image_info(f.data.data(), f.data.size(), &f.format, &f.width, &f.height)) usable.push_back(std::move(f));
+    }
+    g4f_jobs* jobs = g4f_jobs_create(0);
+    std::printf("%zu images (%s), %d job threads\n", usable.size(), argc > 1 ? argv[1] : "generated 256x256", g4f_jobs_thread_count(jobs));
+    std::printf("%-6s %6s %10s %12s %12s %12s\n", "format", "files", "MB in", "MPix/s 1T", "MPix/s batch", "MPix/s WIC");
+
+    static const char* const kNames[4] = {"", "png", "tga", "qoi"};
+    std::vector<uint8_t> px;
+    for (int format = G4F_IMAGE_PNG; format <= G4F_IMAGE_QOI; format++) {
+        std::vector<const CorpusFile*> set;
+        double pixels = 0.0, bytes = 0.0;
+        for (const CorpusFile& f : usable) {
+            if (f.format != format) continue;
+            set.push_back(&f);
+            pixels += (double)f.width * f.height;
+            bytes += (double)f.data.size();
+        }
+        if (set.empty()) continue;
+
+        double single = 1e9;
+        for (int r = 0; r < 3; r++) {
+            const double start = secondsNow();
+            for (const CorpusFile* f : set) {
+                px.resize((size_t)f->width * f->height * 4);
+                if (!g4f_image_decode_rgba8(f->data.data(), f->data.size(), px.data(), 0)) {
+                    std::fprintf(stderr, "%s: %s\n", f->path.c_str(), g4f_last_error());
+                    return 1;
+                }
+            }
+            single = std::min(single, secondsNow() - start);
+        }
+
+        std::vector<const char*> paths;
+        for (const CorpusFile* f : set) paths.push_back(f->path.c_str());
+        double batch = 1e9;
+        for (int r = 0; r < 3; r++) {
+            const double start = secondsNow();
+            g4f_image_batch* b = g4f_image_batch_load(paths.data(), (int)paths.size(), jobs);
+            batch = std::min(batch, secondsNow() - start);
+            g4f_image_batch_destroy(b);
+        }
+
+        char wic[32] = "-";
+#ifdef _WIN32
+        static IWICImagingFactory* factory = nullptr;
+        if (!factory) {
+            CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+            CoCreateInstance(CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS(&factory));
+        }
+        if (factory && format == G4F_IMAGE_PNG) {
+            double best = 1e9;
+            for (int r = 0; r < 3; r++) {
+                const double start = secondsNow();
+                for (const CorpusFile* f : set) wicDecode(factory, f->data, px);
+                best = std::min(best, secondsNow() - start);
+            }
+            std::snprintf(wic, sizeof(wic), "%.1f", pixels / 1e6 / best);
+        }
+#endif
+        std::printf("%-6s %6zu %10.2f %12.1f %12.1f %12s\n", kNames[format], set.size(), bytes / (1 << 20), pixels / 1e6 / single,
+                    pixels / 1e6 / batch, wic);
+    }
+    g4f_jobs_destroy(jobs);
+    if (argc <= 1) std::filesystem::remove_all(tempDir);
+    return 0;
+}
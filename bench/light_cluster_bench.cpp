@@ -0,0 +1,68 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_light_clusters.h"
+
+// Reports clustered light culling time (16x9x24 froxels) for 1k-10k point/spot lights across thread counts.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint32_t g_rng = 1u;
+static float randf(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+int main() {
+    // Lights scattered through a 120x20x120 level around the camera, radius 1-8 units.
+    std::vector<g4f_light> lights(10000);
+    for (g4f_light& l : lights) {
+        l = g4f_light{};
+        l.type = (randf(0.0f, 1.0f) < 0.25f) ? G4F_LIGHT_SPOT : G4F_LIGHT_POINT;
+        l.position = g4f_vec3{randf(-60.0f, 60.0f), randf(0.0f, 20.0f), randf(-60.0f, 60.0f)};
+        l.radius = randf(1.0f, 8.0f);
+        l.direction = g4f_vec3{0.0f, -1.0f, 0.0f};
+        l.spotOuterCos = 0.7f;
+        l.spotInnerCos = 0.8f;
+        l.colorRgba = g4f_rgba_u32(255, 220, 180, 255);
+        l.intensity = 1.0f;
+    }
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < g4f_jobs_hardware_threads(); t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(g4f_jobs_hardware_threads());
+
+    g4f_light_clusters* clusters = g4f_light_clusters_create(nullptr);
+    const g4f_mat4 proj = g4f_mat4_perspective(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    std::printf("%8s %8s %10s %14s %10s\n", "lights", "threads", "ms/build", "avg/froxel", "dropped");
+    for (int lightCount : {1000, 2500, 5000, 10000}) {
+        for (int threads : threadCounts) {
+            g4f_jobs* jobs = g4f_jobs_create(threads);
+            int iterations = 0;
+            double start = secondsNow();
+            double elapsed = 0.0;
+            do {
+                // Orbit the camera so every build sees a different view.
+                float a = (float)iterations * 0.01f;
+                g4f_vec3 eye{std::sin(a) * 10.0f, 6.0f, std::cos(a) * 10.0f};
+                g4f_mat4 view = g4f_mat4_look_at(eye, g4f_vec3{0.0f, 4.0f, 0.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+                g4f_light_clusters_build(clusters, lights.data(), lightCount, &view, &proj, jobs);
+                iterations++;
+                elapsed = secondsNow() - start;
+            } while (elapsed < 0.25 && iterations < 2000);
+
+            g4f_light_cluster_result r{};
+            g4f_light_clusters_get_result(clusters, &r);
+            std::printf("%8d %8d %10.3f %14.2f %10d\n", lightCount, threads, elapsed * 1000.0 / iterations,
+                        (double)r.indexCount / (double)r.clusterCount, r.droppedCount);
+            g4f_jobs_destroy(jobs);
+        }
+    }
+    g4f_light_clusters_destroy(clusters);
+    return 0;
+}
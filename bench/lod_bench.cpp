@@ -0,0 +1,113 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_lod.h"
+
+// Reports LOD chain build time (the cost paid at mesh creation) for a sphere and a terrain at a
+// few sizes, the triangle count and error of each level, and per-instance selection cost for
+// 100k instances.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+struct Mesh {
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+static void gridIndices(Mesh& m, int nx, int nz) {
+    for (int z = 0; z < nz; z++) {
+        for (int x = 0; x < nx; x++) {
+            const uint32_t i = (uint32_t)(z * (nx + 1) + x);
+            const uint32_t row = (uint32_t)nx + 1u;
+            const uint32_t quad[6] = {i, i + row, i + 1u, i + 1u, i + row, i + row + 1u};
+            m.indices.insert(m.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+static Mesh makeSphere(int n) {
+    Mesh m;
+    for (int r = 0; r <= n; r++) {
+        const float phi = 3.14159265f * (float)r / (float)n;
+        const float ringRadius = (r == 0 || r == n) ? 0.0f : std::sin(phi);
+        for (int s = 0; s <= n; s++) {
+            const float theta = 6.2831853f * (float)(s % n) / (float)n;
+            m.positions.push_back(g4f_vec3{ringRadius * std::cos(theta), std::cos(phi), ringRadius * std::sin(theta)});
+        }
+    }
+    gridIndices(m, n, n);
+    return m;
+}
+
+static Mesh makeTerrain(int n) {
+    Mesh m;
+    for (int z = 0; z <= n; z++) {
+        for (int x = 0; x <= n; x++) {
+            const float fx = ((float)x / (float)n - 0.5f) * 100.0f;
+            const float fz = ((float)z / (float)n - 0.5f) * 100.0f;
+            m.positions.push_back(g4f_vec3{fx, 3.0f * std::sin(fx * 0.11f) * std::cos(fz * 0.07f) + 0.5f * std::sin(fx * 0.9f + fz * 0.6f), fz});
+        }
+    }
+    gridIndices(m, n, n);
+    return m;
+}
+
+static g4f_lod_chain* buildChain(const char* name, const Mesh& m) {
+    g4f_lod_mesh_desc d = g4f_lod_mesh_desc_default();
+    d.positions = m.positions.data();
+    d.vertexCount = (int)m.positions.size();
+    d.indices32 = m.indices.data();
+    d.indexCount = (int)m.indices.size();
+    const double start = secondsNow();
+    g4f_lod_chain* chain = g4f_lod_chain_create(&d, nullptr);
+    const double ms = (secondsNow() - start) * 1000.0;
+    std::printf("%-16s %9d tris  build %8.1f ms  (%.2f Mtris/s)  levels:", name, d.indexCount / 3, ms, (double)d.indexCount / 3.0 / ms / 1000.0);
+    for (int i = 0; i < g4f_lod_chain_level_count(chain); i++) {
+        const g4f_lod_level level = g4f_lod_chain_level(chain, i);
+        std::printf(" %d/%.4f", level.indexCount / 3, level.error);
+    }
+    std::printf("\n");
+    return chain;
+}
+
+int main() {
+    for (int n : {64, 256, 512}) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "sphere %dx%d", n, n);
+        g4f_lod_chain_destroy(buildChain(name, makeSphere(n)));
+        std::snprintf(name, sizeof(name), "terrain %dx%d", n, n);
+        g4f_lod_chain* chain = buildChain(name, makeTerrain(n));
+        if (n != 256) {
+            g4f_lod_chain_destroy(chain);
+            continue;
+        }
+
+        // Selection for 100k instances spread along a line, camera moving through them.
+        const int instances = 100000;
+        std::vector<g4f_mat4> models((size_t)instances);
+        std::vector<int> levels((size_t)instances, -1);
+        for (int i = 0; i < instances; i++) models[(size_t)i] = g4f_mat4_trs(g4f_vec3{0.0f, 0.0f, (float)i * 20.0f}, g4f_quat_identity(), g4f_vec3{0.1f, 0.1f, 0.1f});
+        g4f_camera_fps cam = g4f_camera_fps_default();
+        const int frames = 20;
+        long long switches = 0;
+        const double start = secondsNow();
+        for (int f = 0; f < frames; f++) {
+            cam.position = g4f_vec3{0.0f, 5.0f, (float)f * 50.0f};
+            const g4f_lod_view view = g4f_lod_view_from_camera(&cam, 1080, 1.0f);
+            for (int i = 0; i < instances; i++) {
+                const int level = g4f_lod_select(chain, &view, &models[(size_t)i], levels[(size_t)i]);
+                switches += level != levels[(size_t)i] && levels[(size_t)i] >= 0;
+                levels[(size_t)i] = level;
+            }
+        }
+        const double ns = (secondsNow() - start) * 1e9 / ((double)frames * instances);
+        std::printf("select: %d instances x %d frames, %.1f ns/instance, %lld level switches\n", instances, frames, ns, switches);
+        g4f_lod_chain_destroy(chain);
+    }
+    return 0;
+}
@@ -0,0 +1,191 @@
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_jobs.h"
+#include "g4f/g4f_occlusion.h"
+
+// Synthetic maze (a Backrooms-style corridor grid): 64x64 cells of 4 m with 3 m walls as
+// occluders and 8 props per cell as test boxes. A camera walks the corridors; each frame the
+// walls are rasterized and every prop box is tested. Reports rasterization time by thread count,
+// batch test time, and how many props survive frustum-only vs occlusion culling.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint32_t g_rng = 1u;
+static uint32_t randu() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+static float randf(float lo, float hi) {
+    return lo + (hi - lo) * (float)randu() * (1.0f / 16777216.0f);
+}
+
+static const int kCells = 64;
+static const float kCell = 4.0f;
+static const float kWallHeight = 3.0f;
+static const float kWallHalf = 0.1f;
+
+struct Maze {
+    // Walls on the +X and +Z side of each cell (outer walls included).
+    std::vector<uint8_t> wallX, wallZ;
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+static void addBox(Maze& m, g4f_vec3 lo, g4f_vec3 hi) {
+    const uint32_t base = (uint32_t)m.positions.size();
+    for (int i = 0; i < 8; i++) m.positions.push_back(g4f_vec3{(i & 1) ? hi.x : lo.x, (i & 2) ? hi.y : lo.y, (i & 4) ? hi.z : lo.z});
+    // Clockwise seen from outside (front faces for the default back-face culling).
+    static const uint32_t faces[36] = {0, 2, 3, 0, 3, 1, 4, 5, 7, 4, 7, 6, 0, 4, 6, 0, 6, 2,
+                                       1, 3, 7, 1, 7, 5, 0, 1, 5, 0, 5, 4, 2, 6, 7, 2, 7, 3};
+    for (uint32_t f : faces) m.indices.push_back(base + f);
+}
+
+static Maze makeMaze() {
+    Maze m;
+    m.wallX.assign((size_t)kCells * kCells, 1);
+    m.wallZ.assign((size_t)kCells * kCells, 1);
+    // Recursive backtracker, then knock out extra walls so corridors loop like an office floor.
+    std::vector<uint8_t> seen((size_t)kCells * kCells, 0);
+    std::vector<int> stack{0};
+    seen[0] = 1;
+    while (!stack.empty()) {
+        const int c = stack.back();
+        const int x = c % kCells, z = c / kCells;
+        int options[4], n = 0;
+        if (x > 0 && !seen[(size_t)c - 1]) options[n++] = 0;
+        if (x + 1 < kCells && !seen[(size_t)c + 1]) options[n++] = 1;
+        if (z > 0 && !seen[(size_t)(c - kCells)]) options[n++] = 2;
+        if (z + 1 < kCells && !seen[(size_t)(c + kCells)]) options[n++] = 3;
+        if (n == 0) {
+            stack.pop_back();
+            continue;
+        }
+        const int dir = options[randu() % (uint32_t)n];
+        const int next = dir == 0 ? c - 1 : dir == 1 ? c + 1 : dir == 2 ? c - kCells : c + kCells;
+        if (dir == 0) m.wallX[(size_t)next] = 0;
+        if (dir == 1) m.wallX[(size_t)c] = 0;
+        if (dir == 2) m.wallZ[(size_t)next] = 0;
+        if (dir == 3) m.wallZ[(size_t)c] = 0;
+        seen[(size_t)next] = 1;
+        stack.push_back(next);
+    }
+    for (int i = 0; i < kCells * kCells / 6; i++) {
+        const int c = (int)(randu() % (uint32_t)(kCells * kCells));
+        if (c % kCells + 1 < kCells) m.wallX[(size_t)c] = 0;
+    }
+
+    for (int z = 0; z < kCells; z++) {
+        for (int x = 0; x < kCells; x++) {
+            const float x1 = (float)(x + 1) * kCell, z1 = (float)(z + 1) * kCell;
+            if (m.wallX[(size_t)(z * kCells + x)]) addBox(m, g4f_vec3{x1 - kWallHalf, 0.0f, z1 - kCell - kWallHalf}, g4f_vec3{x1 + kWallHalf, kWallHeight, z1 + kWallHalf});
+            if (m.wallZ[(size_t)(z * kCells + x)]) addBox(m, g4f_vec3{x1 - kCell - kWallHalf, 0.0f, z1 - kWallHalf}, g4f_vec3{x1 + kWallHalf, kWallHeight, z1 + kWallHalf});
+            if (x == 0) addBox(m, g4f_vec3{-kWallHalf, 0.0f, z1 - kCell}, g4f_vec3{kWallHalf, kWallHeight, z1});
+            if (z == 0) addBox(m, g4f_vec3{x1 - kCell, 0.0f, -kWallHalf}, g4f_vec3{x1, kWallHeight, kWallHalf});
+        }
+    }
+    return m;
+}
+
+// Camera path: cell centers walked along open corridors, turning at walls.
+static std::vector<g4f_mat4> makeViewProjs(const Maze& m, int frames) {
+    std::vector<g4f_mat4> out;
+    const g4f_mat4 proj = g4f_mat4_perspective(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 200.0f);
+    int x = kCells / 2, z = kCells / 2, dir = 0; // 0 +X, 1 +Z, 2 -X, 3 -Z
+    for (int f = 0; f < frames; f++) {
+        for (int tries = 0; tries < 4; tries++) {
+            const int c = z * kCells + x;
+            const bool open = dir == 0 ? (x + 1 < kCells && !m.wallX[(size_t)c]) : dir == 1 ? (z + 1 < kCells && !m.wallZ[(size_t)c])
+                            : dir == 2 ? (x > 0 && !m.wallX[(size_t)c - 1]) : (z > 0 && !m.wallZ[(size_t)(c - kCells)]);
+            if (open && (randu() % 5u) != 0u) break;
+            dir = (dir + 1 + (int)(randu() % 3u)) % 4;
+        }
+        const int c = z * kCells + x;
+        const bool open = dir == 0 ? (x + 1 < kCells && !m.wallX[(size_t)c]) : dir == 1 ? (z + 1 < kCells && !m.wallZ[(size_t)c])
+                        : dir == 2 ? (x > 0 && !m.wallX[(size_t)c - 1]) : (z > 0 && !m.wallZ[(size_t)(c - kCells)]);
+        if (open) {
+            x += dir == 0 ? 1 : dir == 2 ? -1 : 0;
+            z += dir == 1 ? 1 : dir == 3 ? -1 : 0;
+        }
+        // Look along the walking direction (+Z turned by yaw), slightly off-axis.
+        const float yaw = (dir == 0 ? 1.5707963f : dir == 1 ? 0.0f : dir == 2 ? -1.5707963f : 3.14159265f) + randf(-0.3f, 0.3f);
+        const g4f_vec3 eye{((float)x + 0.5f) * kCell, 1.6f, ((float)z + 0.5f) * kCell};
+        const g4f_mat4 camera = g4f_mat4_trs(eye, g4f_quat_from_axis_angle(g4f_vec3{0.0f, 1.0f, 0.0f}, yaw), g4f_vec3{1.0f, 1.0f, 1.0f});
+        out.push_back(g4f_mat4_mul(g4f_mat4_inverse(camera), proj));
+    }
+    return out;
+}
+
+int main() {
+    const Maze maze = makeMaze();
+    std::vector<g4f_aabb> props;
+    for (int c = 0; c < kCells * kCells; c++) {
+        for (int i = 0; i < 8; i++) {
+            const float x = ((float)(c % kCells) + randf(0.15f, 0.85f)) * kCell;
+            const float z = ((float)(c / kCells) + randf(0.15f, 0.85f)) * kCell;
+            const float s = randf(0.1f, 0.5f), h = randf(0.2f, 1.8f);
+            props.push_back(g4f_aabb{g4f_vec3{x - s, 0.0f, z - s}, g4f_vec3{x + s, h, z + s}});
+        }
+    }
+    const int frames = 120;
+    const std::vector<g4f_mat4> viewProjs = makeViewProjs(maze, frames);
+    std::printf("maze %dx%d cells: %d occluder triangles, %d prop boxes, %d frames, 320x192 depth buffer\n", kCells, kCells,
+                (int)maze.indices.size() / 3, (int)props.size(), frames);
+
+    g4f_occluder occluder{};
+    occluder.positions = maze.positions.data();
+    occluder.vertexCount = (int)maze.positions.size();
+    occluder.indices32 = maze.indices.data();
+    occluder.indexCount = (int)maze.indices.size();
+
+    g4f_occlusion* occ = g4f_occlusion_create(nullptr);
+    g4f_occlusion* empty = g4f_occlusion_create(nullptr);
+    std::vector<uint8_t> visible(props.size());
+    const int hw = g4f_jobs_hardware_threads();
+    std::printf("%-8s %12s %12s %12s %12s\n", "threads", "raster ms", "test ms", "ns/box", "tris drawn");
+    for (int threads : {1, 2, 4, 8}) {
+        if (threads > 1 && threads > hw) break;
+        g4f_jobs* jobs = threads > 1 ? g4f_jobs_create(threads) : nullptr;
+        double raster = 0.0, test = 0.0;
+        long long drawn = 0;
+        for (int f = 0; f < frames; f++) {
+            double start = secondsNow();
+            g4f_occlusion_begin(occ, &viewProjs[(size_t)f]);
+            g4f_occlusion_add(occ, &occluder);
+            g4f_occlusion_end(occ, jobs);
+            raster += secondsNow() - start;
+            start = secondsNow();
+            g4f_occlusion_test_boxes(occ, props.data(), nullptr, (int)props.size(), visible.data(), jobs);
+            test += secondsNow() - start;
+            g4f_occlusion_stats stats{};
+            g4f_occlusion_get_stats(occ, &stats);
+            drawn += stats.rasterized;
+        }
+        std::printf("%-8d %12.3f %12.3f %12.1f %12lld\n", threads, raster * 1000.0 / frames, test * 1000.0 / frames,
+                    test * 1e9 / ((double)frames * (double)props.size()), drawn / frames);
+        g4f_jobs_destroy(jobs);
+    }
+
+    // Culling efficiency: frustum-only (an empty depth buffer) vs with the maze walls.
+    long long inFrustum = 0, unoccluded = 0;
+    for (int f = 0; f < frames; f++) {
+        g4f_occlusion_begin(empty, &viewProjs[(size_t)f]);
+        g4f_occlusion_end(empty, nullptr);
+        inFrustum += g4f_occlusion_test_boxes(empty, props.data(), nullptr, (int)props.size(), visible.data(), nullptr);
+        g4f_occlusion_begin(occ, &viewProjs[(size_t)f]);
+        g4f_occlusion_add(occ, &occluder);
+        g4f_occlusion_end(occ, nullptr);
+        unoccluded += g4f_occlusion_test_boxes(occ, props.data(), nullptr, (int)props.size(), visible.data(), nullptr);
+    }
+    std::printf("props per frame: %d total, %.0f in frustum, %.0f after occlusion (%.1f%% of frustum survivors culled)\n",
+                (int)props.size(), (double)inFrustum / frames, (double)unoccluded / frames,
+                inFrustum ? 100.0 * (1.0 - (double)unoccluded / (double)inFrustum) : 0.0);
+    g4f_occlusion_destroy(empty);
+    g4f_occlusion_destroy(occ);
+    return 0;
+}
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "g4f/g4f_mipgen.h"
+#include "g4f/g4f_pack.h"
+
+// Loader benchmark: the same content (192 meshes of 4k vertices, 48 mipped 256x256 RGBA8
+// textures, 64 small config blobs, about 48 MB in total) loaded three ways:
+// - loose files: one file per asset, each read into its own heap buffer (the per-file path);
+// - pack, open only: map the pack and validate its table of contents;
+// - pack, touch all: open, look every entry up by name and read one byte per cache line, i.e.
+//   everything a gfx upload would read, straight from the mapping.
+// The page cache is warm after the first run; for cold numbers drop the OS file cache between
+// runs (e.g. `echo 3 > /proc/sys/vm/drop_caches` on Linux).
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint32_t g_rng = 1u;
+static uint32_t randu() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+struct Asset {
+    std::string name;
+    std::vector<uint8_t> bytes; // loose-file contents
+};
+
+static uint64_t touch(const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    uint64_t sum = 0;
+    for (size_t i = 0; i < size; i += 64) sum += p[i];
+    return sum;
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "g4f_pack_bench";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir / "loose");
+
+    g4f_pack_writer* writer = g4f_pack_writer_create();
+    std::vector<Asset> assets;
+    const int meshVertices = 4096, meshIndices = 6 * 4096;
+    std::vector<g4f_gfx_vertex_p3n3uv2> vertices((size_t)meshVertices);
+    std::vector<uint16_t> indices((size_t)meshIndices);
+    for (int m = 0; m < 192; m++) {
+        for (auto& v : vertices) v = g4f_gfx_vertex_p3n3uv2{(float)randu(), (float)randu(), (float)randu(), 0.0f, 1.0f, 0.0f, 0.5f, 0.5f};
+        for (auto& i : indices) i = (uint16_t)(randu() % (uint32_t)meshVertices);
+        Asset a;
+        a.name = "meshes/m" + std::to_string(m);
+        g4f_pack_writer_add_mesh(writer, a.name.c_str(), vertices.data(), meshVertices, indices.data(), meshIndices);
+        a.bytes.resize(sizeof(g4f_gfx_vertex_p3n3uv2) * vertices.size() + sizeof(uint16_t) * indices.size());
+        std::memcpy(a.bytes.data(), vertices.data(), sizeof(g4f_gfx_vertex_p3n3uv2) * vertices.size());
+        std::memcpy(a.bytes.data() + sizeof(g4f_gfx_vertex_p3n3uv2) * vertices.size(), indices.data(), sizeof(uint16_t) * indices.size());
+        assets.push_back(std::move(a));
+    }
+    std::vector<uint8_t> pixels(256 * 256 * 4);
+    for (int t = 0; t < 48; t++) {
+        for (auto& p : pixels) p = (uint8_t)randu();
+        Asset a;
+        a.name = "textures/t" + std::to_string(t);
+        g4f_pack_writer_add_texture_rgba8(writer, a.name.c_str(), 256, 256, pixels.data(), 0, 0, G4F_MIPGEN_FILTER_BOX, 0, nullptr);
+        a.bytes.resize(g4f_mipgen_chain_bytes(256, 256, g4f_mipgen_level_count(256, 256)));
+        g4f_mipgen_build_chain_rgba8(pixels.data(), 256, 256, 0, 0, G4F_MIPGEN_FILTER_BOX, 0, nullptr, a.bytes.data());
+        assets.push_back(std::move(a));
+    }
+    for (int b = 0; b < 64; b++) {
+        Asset a;
+        a.name = "config/c" + std::to_string(b);
+        a.bytes.resize(256 + randu() % 1024);
+        for (auto& c : a.bytes) c = (uint8_t)('a' + randu() % 26);
+        g4f_pack_writer_add_blob(writer, a.name.c_str(), a.bytes.data(), a.bytes.size());
+        assets.push_back(std::move(a));
+    }
+
+    const std::string packPath = (dir / "content.pack").string();
+    if (!g4f_pack_writer_save(writer, packPath.c_str())) {
+        std::fprintf(stderr, "pack write failed: %s\n", g4f_last_error());
+        return 1;
+    }
+    g4f_pack_writer_destroy(writer);
+    size_t looseBytes = 0;
+    for (size_t i = 0; i < assets.size(); i++) {
+        std::ofstream out(dir / "loose" / (std::to_string(i) + ".bin"), std::ios::binary);
+        out.write((const char*)assets[i].bytes.data(), (std::streamsize)assets[i].bytes.size());
+        looseBytes += assets[i].bytes.size();
+    }
+    std::printf("%d assets, %.1f MB loose, %.1f MB pack\n", (int)assets.size(), (double)looseBytes / (1 << 20),
+                (double)std::filesystem::file_size(packPath) / (1 << 20));
+
+    const int runs = 7;
+    std::vector<double> loose, openOnly, touchAll;
+    uint64_t sink = 0;
+    for (int r = 0; r < runs; r++) {
+        double start = secondsNow();
+        std::vector<std::vector<uint8_t>> loaded(assets.size());
+        for (size_t i = 0; i < assets.size(); i++) {
+            std::ifstream in(dir / "loose" / (std::to_string(i) + ".bin"), std::ios::binary | std::ios::ate);
+            loaded[i].resize((size_t)in.tellg());
+            in.seekg(0);
+            in.read((char*)loaded[i].data(), (std::streamsize)loaded[i].size());
+            sink += touch(loaded[i].data(), loaded[i].size());
+        }
+        loose.push_back(secondsNow() - start);
+
+        start = secondsNow();
+        g4f_pack* pack = g4f_pack_open(packPath.c_str());
+        openOnly.push_back(secondsNow() - start);
+        for (const Asset& a : assets) {
+            g4f_pack_entry e{};
+            g4f_pack_get(pack, g4f_pack_find(pack, a.name.c_str()), &e);
+            sink += touch(e.data, e.size);
+        }
+        g4f_pack_close(pack);
+        touchAll.push_back(secondsNow() - start);
+    }
+    auto median = [](std::vector<double> v) {
+        std::sort(v.begin(), v.end());
+        return v[v.size() / 2] * 1000.0;
+    };
+    std::printf("%-24s %10s\n", "path", "median ms");
+    std::printf("%-24s %10.3f\n", "loose files", median(loose));
+    std::printf("%-24s %10.3f\n", "pack open (mmap + toc)", median(openOnly));
+    std::printf("%-24s %10.3f\n", "pack open + touch all", median(touchAll));
+
+    // Name lookups: binary search over the table of contents.
+    g4f_pack* pack = g4f_pack_open(packPath.c_str());
+    const int lookups = 1000000;
+    double start = secondsNow();
+    for (int i = 0; i < lookups; i++) sink += (uint64_t)g4f_pack_find(pack, assets[(size_t)i % assets.size()].name.c_str());
+    std::printf("g4f_pack_find: %.1f ns per lookup over %d entries (checksum %llu)\n", (secondsNow() - start) * 1e9 / lookups,
+                g4f_pack_entry_count(pack), (unsigned long long)(sink & 0xFFFF));
+    g4f_pack_close(pack);
+    std::filesystem::remove_all(dir);
+    return 0;
+}
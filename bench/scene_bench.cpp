@@ -0,0 +1,118 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_scene.h"
+
+// Reports scene transform update time for 100k nodes (1000 roots, 4 levels) with 1% of the nodes
+// moved per frame, a full re-propagation, and a naive recompute-everything baseline, across thread counts.
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+static uint32_t g_rng = 1u;
+static uint32_t randu() {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return g_rng >> 8;
+}
+
+static float randf(float lo, float hi) {
+    return lo + (hi - lo) * (float)randu() * (1.0f / 16777216.0f);
+}
+
+static void addChildren(g4f_scene* scene, g4f_scene_node parent, int depth, std::vector<g4f_scene_node>& nodes) {
+    // 1 + 3 + 12 + 84 = 100 nodes per root.
+    static const int kFanout[] = {3, 4, 7, 0};
+    for (int i = 0; i < kFanout[depth]; i++) {
+        g4f_scene_node n = g4f_scene_node_create(scene, parent);
+        g4f_scene_set_local(scene, n, g4f_vec3{randf(-2.0f, 2.0f), randf(0.0f, 1.0f), randf(-2.0f, 2.0f)},
+                            g4f_quat_from_axis_angle(g4f_vec3{0.0f, 1.0f, 0.0f}, randf(0.0f, 6.28f)), g4f_vec3{1.0f, 1.0f, 1.0f});
+        nodes.push_back(n);
+        addChildren(scene, n, depth + 1, nodes);
+    }
+}
+
+int main() {
+    const int kRoots = 1000;
+    g4f_scene* scene = g4f_scene_create(kRoots * 100);
+    std::vector<g4f_scene_node> nodes;
+    for (int r = 0; r < kRoots; r++) {
+        g4f_scene_node root = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+        g4f_scene_set_translation(scene, root, g4f_vec3{(float)(r % 32) * 10.0f, 0.0f, (float)(r / 32) * 10.0f});
+        nodes.push_back(root);
+        addChildren(scene, root, 0, nodes);
+    }
+    g4f_scene_update(scene, nullptr);
+    const int nodeCount = (int)nodes.size();
+    const int changedPerFrame = nodeCount / 100;
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < g4f_jobs_hardware_threads(); t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(g4f_jobs_hardware_threads());
+
+    std::printf("%d nodes, %d changed per frame\n", nodeCount, changedPerFrame);
+    std::printf("%-16s %8s %10s %12s\n", "case", "threads", "ms/frame", "nodes/frame");
+    for (int threads : threadCounts) {
+        g4f_jobs* jobs = g4f_jobs_create(threads);
+
+        // 1% of the nodes (random depths) move every frame.
+        int frames = 0;
+        long long updated = 0;
+        double elapsed = 0.0;
+        for (double start = secondsNow(); elapsed < 0.5 && frames < 5000; elapsed = secondsNow() - start) {
+            for (int k = 0; k < changedPerFrame; k++) {
+                g4f_scene_set_translation(scene, nodes[randu() % (uint32_t)nodeCount], g4f_vec3{randf(-2.0f, 2.0f), 0.5f, randf(-2.0f, 2.0f)});
+            }
+            g4f_scene_update(scene, jobs);
+            g4f_scene_stats stats{};
+            g4f_scene_get_stats(scene, &stats);
+            updated += stats.updatedNodes;
+            frames++;
+        }
+        std::printf("%-16s %8d %10.3f %12lld\n", "1% changed", threads, elapsed * 1000.0 / frames, updated / frames);
+
+        // Every root moves: the whole hierarchy re-propagates.
+        frames = 0;
+        elapsed = 0.0;
+        for (double start = secondsNow(); elapsed < 0.5 && frames < 1000; elapsed = secondsNow() - start) {
+            for (int r = 0; r < kRoots; r++) g4f_scene_set_rotation(scene, nodes[(size_t)r * 100], g4f_quat_from_axis_angle(g4f_vec3{0.0f, 1.0f, 0.0f}, (float)frames * 0.01f));
+            g4f_scene_update(scene, jobs);
+            frames++;
+        }
+        std::printf("%-16s %8d %10.3f %12d\n", "all roots moved", threads, elapsed * 1000.0 / frames, nodeCount);
+        g4f_jobs_destroy(jobs);
+    }
+
+    // Baseline: rebuild every world matrix with g4f_mat4_mul, parents before children, every frame.
+    std::vector<int> parentIndex((size_t)nodeCount, -1);
+    for (int i = 0; i < nodeCount; i++) {
+        g4f_scene_node p = g4f_scene_parent(scene, nodes[(size_t)i]);
+        if (p == G4F_SCENE_NODE_NULL) continue;
+        for (int j = i - 1; j >= 0; j--) {
+            if (nodes[(size_t)j] == p) {
+                parentIndex[(size_t)i] = j;
+                break;
+            }
+        }
+    }
+    std::vector<g4f_mat4> world((size_t)nodeCount);
+    int frames = 0;
+    double elapsed = 0.0;
+    for (double start = secondsNow(); elapsed < 0.5 && frames < 1000; elapsed = secondsNow() - start) {
+        for (int i = 0; i < nodeCount; i++) {
+            g4f_vec3 t{}, s{};
+            g4f_quat q{};
+            g4f_scene_get_local(scene, nodes[(size_t)i], &t, &q, &s);
+            g4f_mat4 local = g4f_mat4_mul(g4f_mat4_mul(g4f_mat4_scale(s.x, s.y, s.z), g4f_quat_to_mat4(q)), g4f_mat4_translation(t.x, t.y, t.z));
+            const int p = parentIndex[(size_t)i];
+            world[(size_t)i] = p < 0 ? local : g4f_mat4_mul(local, world[(size_t)p]);
+        }
+        frames++;
+    }
+    std::printf("%-16s %8d %10.3f %12d\n", "naive mat4_mul", 1, elapsed * 1000.0 / frames, nodeCount);
+
+    g4f_scene_destroy(scene);
+    return 0;
+}
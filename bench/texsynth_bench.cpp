@@ -0,0 +1,60 @@
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_texsynth.h"
+
+// Reports Mpixels/s per generator across thread counts (RGBA8 output, 1024x1024).
+
+static const char* kGeneratorNames[G4F_TEXSYNTH_GENERATOR_COUNT] = {
+    "value", "gradient", "simplex", "worley", "linear", "radial", "checker",
+};
+
+static double secondsNow() {
+    using clock = std::chrono::steady_clock;
+    return std::chrono::duration<double>(clock::now().time_since_epoch()).count();
+}
+
+int main() {
+    const int w = 1024, h = 1024;
+    std::vector<uint32_t> pixels((size_t)w * (size_t)h);
+    const g4f_texsynth_ramp_stop ramp[] = {
+        {0.0f, g4f_rgba_u32(10, 12, 30, 255)},
+        {0.5f, g4f_rgba_u32(90, 140, 200, 255)},
+        {1.0f, g4f_rgba_u32(250, 250, 240, 255)},
+    };
+
+    std::vector<int> threadCounts;
+    for (int t = 1; t < g4f_jobs_hardware_threads(); t *= 2) threadCounts.push_back(t);
+    threadCounts.push_back(g4f_jobs_hardware_threads());
+
+    std::printf("%-10s %-7s %8s %12s\n", "generator", "octaves", "threads", "Mpix/s");
+    for (int threads : threadCounts) {
+        g4f_jobs* jobs = g4f_jobs_create(threads);
+        for (int g = 0; g < G4F_TEXSYNTH_GENERATOR_COUNT; g++) {
+            for (int octaves : {1, 4}) {
+                if (octaves > 1 && g >= G4F_TEXSYNTH_LINEAR_GRADIENT) continue;
+                g4f_texsynth_desc d = g4f_texsynth_desc_default(g);
+                d.octaves = octaves;
+                d.ramp = ramp;
+                d.rampCount = 3;
+
+                g4f_texsynth_generate_rgba8(&d, jobs, w, h, pixels.data(), 0); // warm-up
+                int iterations = 0;
+                double start = secondsNow();
+                double elapsed = 0.0;
+                do {
+                    d.offsetX = (float)iterations;
+                    g4f_texsynth_generate_rgba8(&d, jobs, w, h, pixels.data(), 0);
+                    iterations++;
+                    elapsed = secondsNow() - start;
+                } while (elapsed < 0.25 && iterations < 200);
+
+                double mpix = (double)w * (double)h * (double)iterations / elapsed / 1e6;
+                std::printf("%-10s %-7d %8d %12.1f\n", kGeneratorNames[g], octaves, threads, mpix);
+            }
+        }
+        g4f_jobs_destroy(jobs);
+    }
+    return 0;
+}
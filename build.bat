@@ -61,6 +61,32 @@ set "ENGINE_OBJ=%OBJ%\engine"
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_error.cpp -o "%ENGINE_OBJ%\g4f_error.o" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_math.cpp -o "%ENGINE_OBJ%\g4f_math.o" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_camera.cpp -o "%ENGINE_OBJ%\g4f_camera.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_jobs.cpp -o "%ENGINE_OBJ%\g4f_jobs.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_texsynth.cpp -o "%ENGINE_OBJ%\g4f_texsynth.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_mipgen.cpp -o "%ENGINE_OBJ%\g4f_mipgen.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_dirty_rects.cpp -o "%ENGINE_OBJ%\g4f_dirty_rects.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_pass_stack.cpp -o "%ENGINE_OBJ%\g4f_pass_stack.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_dynres.cpp -o "%ENGINE_OBJ%\g4f_dynres.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_shader_cache.cpp -o "%ENGINE_OBJ%\g4f_shader_cache.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_material_key.cpp -o "%ENGINE_OBJ%\g4f_material_key.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_light_clusters.cpp -o "%ENGINE_OBJ%\g4f_light_clusters.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_gpu_timings.cpp -o "%ENGINE_OBJ%\g4f_gpu_timings.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_frame_stats.cpp -o "%ENGINE_OBJ%\g4f_frame_stats.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_scene.cpp -o "%ENGINE_OBJ%\g4f_scene.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_ecs.cpp -o "%ENGINE_OBJ%\g4f_ecs.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_bvh.cpp -o "%ENGINE_OBJ%\g4f_bvh.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_collision.cpp -o "%ENGINE_OBJ%\g4f_collision.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_lod.cpp -o "%ENGINE_OBJ%\g4f_lod.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_occlusion.cpp -o "%ENGINE_OBJ%\g4f_occlusion.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_stream.cpp -o "%ENGINE_OBJ%\g4f_stream.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_file_map.cpp -o "%ENGINE_OBJ%\g4f_file_map.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_pack.cpp -o "%ENGINE_OBJ%\g4f_pack.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_content_cache.cpp -o "%ENGINE_OBJ%\g4f_content_cache.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_bcn.cpp -o "%ENGINE_OBJ%\g4f_bcn.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_image.cpp -o "%ENGINE_OBJ%\g4f_image.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_atlas.cpp -o "%ENGINE_OBJ%\g4f_atlas.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_sprite.cpp -o "%ENGINE_OBJ%\g4f_sprite.o" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_particles.cpp -o "%ENGINE_OBJ%\g4f_particles.o" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_keycodes_win32.cpp -o "%ENGINE_OBJ%\g4f_keycodes_win32.o" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_win32_window.cpp -o "%ENGINE_OBJ%\g4f_win32_window.o" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_d2d_renderer.cpp -o "%ENGINE_OBJ%\g4f_d2d_renderer.o" || goto :fail
@@ -70,19 +96,47 @@ set "ENGINE_OBJ=%OBJ%\engine"
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_ctx3d_ui.cpp -o "%ENGINE_OBJ%\g4f_ctx3d_ui.o" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% -c engine\src\g4f_ui.cpp -o "%ENGINE_OBJ%\g4f_ui.o" || goto :fail
 
-%AR% rcs "%LIB%\libg4f.a" "%ENGINE_OBJ%\g4f_utf8_win32.o" "%ENGINE_OBJ%\g4f_error.o" "%ENGINE_OBJ%\g4f_math.o" "%ENGINE_OBJ%\g4f_camera.o" "%ENGINE_OBJ%\g4f_keycodes_win32.o" "%ENGINE_OBJ%\g4f_win32_window.o" "%ENGINE_OBJ%\g4f_d2d_renderer.o" "%ENGINE_OBJ%\g4f_ctx.o" "%ENGINE_OBJ%\g4f_d3d11_gfx.o" "%ENGINE_OBJ%\g4f_ctx3d.o" "%ENGINE_OBJ%\g4f_ctx3d_ui.o" "%ENGINE_OBJ%\g4f_ui.o" || goto :fail
+%AR% rcs "%LIB%\libg4f.a" "%ENGINE_OBJ%\g4f_utf8_win32.o" "%ENGINE_OBJ%\g4f_error.o" "%ENGINE_OBJ%\g4f_math.o" "%ENGINE_OBJ%\g4f_camera.o" "%ENGINE_OBJ%\g4f_jobs.o" "%ENGINE_OBJ%\g4f_texsynth.o" "%ENGINE_OBJ%\g4f_mipgen.o" "%ENGINE_OBJ%\g4f_dirty_rects.o" "%ENGINE_OBJ%\g4f_pass_stack.o" "%ENGINE_OBJ%\g4f_dynres.o" "%ENGINE_OBJ%\g4f_shader_cache.o" "%ENGINE_OBJ%\g4f_material_key.o" "%ENGINE_OBJ%\g4f_light_clusters.o" "%ENGINE_OBJ%\g4f_gpu_timings.o" "%ENGINE_OBJ%\g4f_frame_stats.o" "%ENGINE_OBJ%\g4f_scene.o" "%ENGINE_OBJ%\g4f_ecs.o" "%ENGINE_OBJ%\g4f_bvh.o" "%ENGINE_OBJ%\g4f_collision.o" "%ENGINE_OBJ%\g4f_lod.o" "%ENGINE_OBJ%\g4f_occlusion.o" "%ENGINE_OBJ%\g4f_stream.o" "%ENGINE_OBJ%\g4f_file_map.o" "%ENGINE_OBJ%\g4f_pack.o" "%ENGINE_OBJ%\g4f_content_cache.o" "%ENGINE_OBJ%\g4f_bcn.o" "%ENGINE_OBJ%\g4f_image.o" "%ENGINE_OBJ%\g4f_atlas.o" "%ENGINE_OBJ%\g4f_sprite.o" "%ENGINE_OBJ%\g4f_particles.o" "%ENGINE_OBJ%\g4f_keycodes_win32.o" "%ENGINE_OBJ%\g4f_win32_window.o" "%ENGINE_OBJ%\g4f_d2d_renderer.o" "%ENGINE_OBJ%\g4f_ctx.o" "%ENGINE_OBJ%\g4f_d3d11_gfx.o" "%ENGINE_OBJ%\g4f_ctx3d.o" "%ENGINE_OBJ%\g4f_ctx3d_ui.o" "%ENGINE_OBJ%\g4f_ui.o" || goto :fail
 
 echo === Build: samples ===
 %CXX% %CXXFLAGS% %INC_ENGINE% samples\hello2d\main.cpp -L"%LIB%" -lg4f %LD_ENGINE% -o "%BIN%\hello2d.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% samples\backrooms_menu_smoke\main.cpp -L"%LIB%" -lg4f %LD_ENGINE% -o "%BIN%\backrooms_menu_smoke.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% samples\spin_cube\main.cpp -L"%LIB%" -lg4f %LD_ENGINE_3D% -o "%BIN%\spin_cube.exe" || goto :fail
 
+echo === Build: tools ===
+%CXX% %CXXFLAGS% %INC_ENGINE% tools\g4f_pack\main.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\g4f_pack.exe" || goto :fail
+
 echo === Build: engine tests ===
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\engine_keycodes_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\engine_keycodes_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\ui_layout_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\ui_layout_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\math_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\math_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\error_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\error_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\camera_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\camera_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\jobs_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\jobs_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\texsynth_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\texsynth_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\mipgen_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\mipgen_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\dirty_rects_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\dirty_rects_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\pass_stack_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\pass_stack_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\dynres_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\dynres_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\shader_cache_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\shader_cache_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\material_key_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\material_key_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\light_clusters_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\light_clusters_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\gpu_timings_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\gpu_timings_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\frame_stats_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\frame_stats_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\scene_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\scene_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\ecs_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\ecs_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\bvh_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\bvh_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\collision_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\collision_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\lod_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\lod_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\occlusion_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\occlusion_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\stream_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\stream_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\pack_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\pack_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\content_cache_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\content_cache_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\bcn_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\bcn_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\image_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\image_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\atlas_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\atlas_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\sprite_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\sprite_tests.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% tests\particles_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\particles_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\ctx2d_smoke_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\ctx2d_smoke_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\ui_widget_smoke_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\ui_widget_smoke_tests.exe" || goto :fail
 %CXX% %CXXFLAGS% %INC_ENGINE% tests\gfx_api_smoke_tests.cpp -L"%LIB%" -lg4f %LD_ENGINE_3D% -o "%BIN%\gfx_api_smoke_tests.exe" || goto :fail
@@ -94,11 +148,72 @@ call :run_with_timeout "%BIN%\ui_layout_tests.exe" 10000 || goto :fail
 call :run_with_timeout "%BIN%\math_tests.exe" 10000 || goto :fail
 call :run_with_timeout "%BIN%\error_tests.exe" 10000 || goto :fail
 call :run_with_timeout "%BIN%\camera_tests.exe" 15000 || goto :fail
+call :run_with_timeout "%BIN%\jobs_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\texsynth_tests.exe" 15000 || goto :fail
+call :run_with_timeout "%BIN%\mipgen_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\dirty_rects_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\pass_stack_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\dynres_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\shader_cache_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\material_key_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\light_clusters_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\gpu_timings_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\frame_stats_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\scene_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\ecs_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\bvh_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\collision_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\lod_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\occlusion_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\stream_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\pack_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\content_cache_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\bcn_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\image_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\atlas_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\sprite_tests.exe" 10000 || goto :fail
+call :run_with_timeout "%BIN%\particles_tests.exe" 10000 || goto :fail
 call :run_with_timeout "%BIN%\ctx2d_smoke_tests.exe" 15000 || goto :fail
 call :run_with_timeout "%BIN%\ui_widget_smoke_tests.exe" 15000 || goto :fail
 call :run_with_timeout "%BIN%\gfx_api_smoke_tests.exe" 20000 || goto :fail
 call :run_with_timeout "%BIN%\gfx_smoke_tests.exe" 15000 || goto :fail
 
+echo === Build: benchmarks ===
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\texsynth_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\texsynth_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\light_cluster_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\light_cluster_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\scene_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\scene_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\ecs_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\ecs_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\bvh_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\bvh_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\collision_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\collision_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\lod_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\lod_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\occlusion_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\occlusion_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\pack_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\pack_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\content_cache_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\content_cache_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\bcn_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\bcn_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\image_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\image_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\atlas_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\atlas_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\sprite_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\sprite_bench.exe" || goto :fail
+%CXX% %CXXFLAGS% %INC_ENGINE% bench\particles_bench.cpp -L"%LIB%" -lg4f %LD_ENGINE_ALL% -o "%BIN%\particles_bench.exe" || goto :fail
+
+if /i "%1"=="bench" (
+  echo === Run: benchmarks ===
+  "%BIN%\texsynth_bench.exe" || goto :fail
+  "%BIN%\light_cluster_bench.exe" || goto :fail
+  "%BIN%\scene_bench.exe" || goto :fail
+  "%BIN%\ecs_bench.exe" || goto :fail
+  "%BIN%\bvh_bench.exe" || goto :fail
+  "%BIN%\collision_bench.exe" || goto :fail
+  "%BIN%\lod_bench.exe" || goto :fail
+  "%BIN%\occlusion_bench.exe" || goto :fail
+  "%BIN%\pack_bench.exe" || goto :fail
+  "%BIN%\content_cache_bench.exe" || goto :fail
+  "%BIN%\bcn_bench.exe" || goto :fail
+  "%BIN%\image_bench.exe" || goto :fail
+  "%BIN%\atlas_bench.exe" || goto :fail
+  "%BIN%\sprite_bench.exe" || goto :fail
+  "%BIN%\particles_bench.exe" || goto :fail
+)
+
 if exist "Backrooms-master\tests" (
   echo === Build: Backrooms tests [no GLFW] ===
   for %%F in (Backrooms-master\tests\*.cpp) do (
@@ -18,6 +18,7 @@ typedef struct g4f_ctx3d g4f_ctx3d;
 typedef struct g4f_gfx_texture g4f_gfx_texture;
 typedef struct g4f_gfx_material g4f_gfx_material;
 typedef struct g4f_gfx_mesh g4f_gfx_mesh;
+typedef struct g4f_gfx_target g4f_gfx_target;
 
 typedef struct g4f_window_desc {
     const char* title_utf8;
@@ -184,6 +185,54 @@ g4f_mat4 g4f_mat4_rotation_z(float radians);
 g4f_mat4 g4f_mat4_scale(float x, float y, float z);
 g4f_mat4 g4f_mat4_perspective(float fovYRadians, float aspect, float zn, float zf);
 g4f_mat4 g4f_mat4_look_at(g4f_vec3 eye, g4f_vec3 at, g4f_vec3 up);
+g4f_mat4 g4f_mat4_inverse(g4f_mat4 m); // identity if m is singular
+
+// Unit quaternion rotation (right-hand rule about the axis; about +Z it matches g4f_mat4_rotation_z).
+typedef struct g4f_quat {
+    float x;
+    float y;
+    float z;
+    float w;
+} g4f_quat;
+
+g4f_quat g4f_quat_identity(void);
+g4f_quat g4f_quat_from_axis_angle(g4f_vec3 axis, float radians); // axis need not be normalized
+g4f_quat g4f_quat_mul(g4f_quat a, g4f_quat b); // rotate by b, then by a
+g4f_quat g4f_quat_normalize(g4f_quat q);       // identity for a zero quaternion
+g4f_mat4 g4f_quat_to_mat4(g4f_quat q);
+// Scale, then rotate, then translate (row vectors: S * R * T).
+g4f_mat4 g4f_mat4_trs(g4f_vec3 translation, g4f_quat rotation, g4f_vec3 scale);
+
+// Directional light shadow cascades (CPU side; rendered with g4f_gfx_shadow_*).
+// Each cascade covers one depth range of the camera frustum with an orthographic light projection
+// fitted to the slice's bounding sphere and snapped to whole shadow-map texels, so the fit is
+// deterministic and shadow edges do not shimmer when the camera moves or turns.
+#define G4F_SHADOW_MAX_CASCADES 4
+
+typedef struct g4f_shadow_cascade {
+    g4f_mat4 viewProj;    // world -> light clip space (x, y in [-1, 1], z in [0, 1])
+    float splitNear;      // camera view distance range covered by this cascade
+    float splitFar;
+    g4f_vec3 center;      // bounding sphere of the frustum slice (world space, texel snapped)
+    float radius;
+    float depthRange;     // light-space z extent (world units) mapped to [0, 1]
+    float texelWorldSize; // world size of one shadow-map texel
+} g4f_shadow_cascade;
+
+// Split distances blending logarithmic (lambda 1) and uniform (lambda 0) schemes.
+// Writes cascadeCount + 1 values: outSplits[0] = nearZ ... outSplits[cascadeCount] = farZ.
+void g4f_shadow_cascade_splits(float nearZ, float farZ, int cascadeCount, float lambda, float* outSplits);
+// Fits one cascade per split range. `view`/`proj` are the camera matrices used for rendering;
+// `lightDir` is the direction the light travels. Casters up to `casterDistance` beyond the slice
+// (towards the light) keep full depth precision; closer casters are clamped by the depth-only pass.
+// Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_shadow_cascades_fit(const g4f_mat4* view, const g4f_mat4* proj, g4f_vec3 lightDir, const float* splits,
+                            int cascadeCount, int shadowMapSize, float casterDistance, g4f_shadow_cascade* outCascades);
+// Caster culling: spheres are packed (x, y, z, radius). outMasks[i] gets bit c set when caster i can
+// shadow cascade c (it overlaps the cascade's light-space box and is not behind it).
+// Returns the number of caster/cascade pairs kept, i.e. shadow-pass draws.
+int g4f_shadow_cascades_cull(const g4f_shadow_cascade* cascades, int cascadeCount, const float* spheres, int sphereCount,
+                             uint8_t* outMasks);
 
 // Lifecycle / platform.
 const char* g4f_version_string(void);
@@ -223,6 +272,22 @@ void g4f_gfx_get_size(const g4f_gfx* gfx, int* width, int* height);
 float g4f_gfx_aspect(const g4f_gfx* gfx);
 void g4f_gfx_set_vsync(g4f_gfx* gfx, int enabled);
 
+// Shader bytecode is cached on disk (g4f_shader_cache.h), so warm starts skip D3DCompile.
+// Call before g4f_gfx_create. nullptr restores the default (%TEMP%/g4f_shader_cache), "" disables caching.
+// Pointing it at a directory shipped with the executable gives compile-free cold starts.
+void g4f_gfx_set_shader_cache_dir(const char* dirUtf8);
+
+typedef struct g4f_gfx_startup_stats {
+    int shaderCount;
+    int shaderCacheHits;
+    int shaderCacheMisses;
+    double shaderCompileMs;   // D3DCompile on cache misses
+    double shaderCacheLoadMs; // reading cache hits from disk
+    double createMs;          // whole g4f_gfx_create
+} g4f_gfx_startup_stats;
+
+void g4f_gfx_get_startup_stats(const g4f_gfx* gfx, g4f_gfx_startup_stats* out);
+
 // Global lighting state (used by lit materials).
 void g4f_gfx_set_light_dir(g4f_gfx* gfx, float x, float y, float z); // direction light travels
 void g4f_gfx_set_light_colors(g4f_gfx* gfx, uint32_t lightRgba, uint32_t ambientRgba);
@@ -247,12 +312,36 @@ void g4f_gfx_draw_debug_cube(g4f_gfx* gfx, float timeSeconds);
 g4f_gfx_texture* g4f_gfx_texture_create_rgba8(g4f_gfx* gfx, int width, int height, const void* rgbaPixels, int rowPitchBytes);
 // Creates a CPU-updatable texture (use with g4f_gfx_texture_update_rgba8).
 g4f_gfx_texture* g4f_gfx_texture_create_rgba8_dynamic(g4f_gfx* gfx, int width, int height);
+// Creates a texture for frequent partial updates: writes go to a CPU copy and are tracked as dirty
+// rects, which are uploaded through a ring of staging textures before the next draw (or on flush).
+g4f_gfx_texture* g4f_gfx_texture_create_rgba8_streaming(g4f_gfx* gfx, int width, int height);
 // Updates the texture pixels. Returns 1 on success, 0 on failure.
 int g4f_gfx_texture_update_rgba8(g4f_gfx_texture* texture, const void* rgbaPixels, int rowPitchBytes);
+// Updates a sub-rectangle; rgbaPixels points at the region's top-left pixel.
+// Supported on static and streaming textures (dynamic textures discard on map: full updates only).
+int g4f_gfx_texture_update_region_rgba8(g4f_gfx_texture* texture, int x, int y, int width, int height, const void* rgbaPixels, int rowPitchBytes);
+// Uploads pending streaming-texture writes now (draws do this automatically). No-op for other textures.
+int g4f_gfx_texture_flush(g4f_gfx_texture* texture);
 g4f_gfx_texture* g4f_gfx_texture_create_solid_rgba8(g4f_gfx* gfx, uint32_t rgba);
 g4f_gfx_texture* g4f_gfx_texture_create_checker_rgba8(g4f_gfx* gfx, int width, int height, int cellSizePx, uint32_t rgbaA, uint32_t rgbaB);
+// Creates an immutable texture with a full mip chain generated on the CPU (see g4f_mipgen.h).
+// mipFilter is G4F_MIPGEN_FILTER_*, mipFlags is a G4F_MIPGEN_FLAG_* mask (WRAP for tiling textures).
+g4f_gfx_texture* g4f_gfx_texture_create_rgba8_mipmapped(g4f_gfx* gfx, int width, int height, const void* rgbaPixels, int rowPitchBytes, int mipFilter, int mipFlags);
 void g4f_gfx_texture_destroy(g4f_gfx_texture* texture);
 void g4f_gfx_texture_get_size(const g4f_gfx_texture* texture, int* width, int* height);
+int g4f_gfx_texture_mip_levels(const g4f_gfx_texture* texture);
+
+// Per-material sampler selection.
+enum {
+    G4F_GFX_FILTER_LINEAR = 0,      // trilinear
+    G4F_GFX_FILTER_POINT = 1,       // nearest texel and mip (pixel art)
+    G4F_GFX_FILTER_ANISOTROPIC = 2, // 8x anisotropic (floors, grazing angles)
+};
+
+enum {
+    G4F_GFX_ADDRESS_CLAMP = 0,
+    G4F_GFX_ADDRESS_WRAP = 1,
+};
 
 typedef struct g4f_gfx_material_unlit_desc {
     uint32_t tintRgba;            // multiplies output
@@ -261,16 +350,79 @@ typedef struct g4f_gfx_material_unlit_desc {
     int depthTest;               // 0/1 (default 1)
     int depthWrite;              // 0/1 (default 1)
     int cullMode;                // 0 back (default), 1 none, 2 front
+    int samplerFilter;           // G4F_GFX_FILTER_* (default linear)
+    int samplerAddress;          // G4F_GFX_ADDRESS_* (default clamp)
+    int alphaTest;               // 0/1: discard pixels with alpha < 0.5 (default 0)
+    int clusteredLights;         // 0/1: lit materials add g4f_gfx_set_light_clusters lights (default 0)
 } g4f_gfx_material_unlit_desc;
 
+// Materials are baked into immutable state bundles (shader permutation + blend/depth/raster/sampler),
+// deduplicated by key (g4f_material_key.h). Setters re-resolve the bundle; draws compare the bundle ID.
+
 g4f_gfx_material* g4f_gfx_material_create_unlit(g4f_gfx* gfx, const g4f_gfx_material_unlit_desc* desc);
 g4f_gfx_material* g4f_gfx_material_create_lit(g4f_gfx* gfx, const g4f_gfx_material_unlit_desc* desc);
 void g4f_gfx_material_destroy(g4f_gfx_material* material);
 void g4f_gfx_material_set_tint_rgba(g4f_gfx_material* material, uint32_t rgba);
 void g4f_gfx_material_set_texture(g4f_gfx_material* material, g4f_gfx_texture* texture);
+void g4f_gfx_material_set_alpha_test(g4f_gfx_material* material, int enabled);
 void g4f_gfx_material_set_alpha_blend(g4f_gfx_material* material, int enabled);
 void g4f_gfx_material_set_depth(g4f_gfx_material* material, int depthTest, int depthWrite);
 void g4f_gfx_material_set_cull(g4f_gfx_material* material, int cullMode);
+void g4f_gfx_material_set_sampler(g4f_gfx_material* material, int filter, int address);
+int g4f_gfx_material_bundle_id(const g4f_gfx_material* material); // small dense ID, equal for equal state; -1 if null
+
+// Render-to-texture targets and offscreen passes.
+enum {
+    G4F_GFX_FORMAT_RGBA8 = 0,
+    G4F_GFX_FORMAT_RGBA16F = 1, // HDR
+    G4F_GFX_FORMAT_R32F = 2,
+};
+
+enum {
+    G4F_GFX_PASS_CLEAR_COLOR = 1 << 0,
+    G4F_GFX_PASS_CLEAR_DEPTH = 1 << 1,
+};
+
+// depth: 0/1, attaches a private depth buffer.
+g4f_gfx_target* g4f_gfx_target_create(g4f_gfx* gfx, int width, int height, int format, int depth);
+void g4f_gfx_target_destroy(g4f_gfx_target* target);
+// Color buffer, usable with g4f_gfx_material_set_texture. Owned by the target (do not destroy).
+g4f_gfx_texture* g4f_gfx_target_texture(g4f_gfx_target* target);
+void g4f_gfx_target_get_size(const g4f_gfx_target* target, int* width, int* height);
+
+// Draws between begin/end go to the target (viewport = target size). Passes nest; end restores the
+// outer target (the backbuffer at the bottom). Call inside g4f_gfx_begin/end, before the UI overlay.
+// Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_gfx_pass_begin(g4f_gfx* gfx, g4f_gfx_target* target, int clearFlags, uint32_t clearRgba);
+void g4f_gfx_pass_end(g4f_gfx* gfx);
+// Size of the current pass (the backbuffer when no pass is open).
+void g4f_gfx_pass_get_size(const g4f_gfx* gfx, int* width, int* height);
+// Stretches a texture over the whole current pass (bilinear, no depth/blend), e.g. upscaling a
+// low-resolution pass to the backbuffer.
+void g4f_gfx_blit(g4f_gfx* gfx, const g4f_gfx_texture* texture);
+
+// Cascaded shadow map for the directional light (cascades from g4f_shadow_cascades_fit).
+// Per frame: for each cascade, shadow_pass_begin -> draw_shadow_caster (only casters whose
+// g4f_shadow_cascades_cull mask has the cascade bit) -> shadow_pass_end; then set_shadow_cascades
+// and draw lit materials as usual. The depth-only pass reuses mesh buffers; casters in front of the
+// cascade are clamped to its near plane instead of clipped.
+typedef struct g4f_gfx_shadow_desc {
+    int size;          // texels per side (default 2048)
+    int cascadeCount;  // 1..G4F_SHADOW_MAX_CASCADES (default 4)
+    int depthBias;     // rasterizer constant bias (default 16)
+    float slopeBias;   // rasterizer slope-scaled bias (default 2.0)
+    float compareBias; // subtracted from the receiver's light-space depth (default 0.001)
+} g4f_gfx_shadow_desc;
+
+g4f_gfx_shadow_desc g4f_gfx_shadow_desc_default(void);
+// (Re)creates the shadow map; desc null frees it and disables shadows.
+int g4f_gfx_shadow_configure(g4f_gfx* gfx, const g4f_gfx_shadow_desc* desc);
+// Binds cascade `index` as a depth-only target and clears it. Returns 1 on success, 0 on failure.
+int g4f_gfx_shadow_pass_begin(g4f_gfx* gfx, int index, const g4f_shadow_cascade* cascade);
+void g4f_gfx_draw_shadow_caster(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_mat4* model);
+void g4f_gfx_shadow_pass_end(g4f_gfx* gfx);
+// Cascades sampled by lit materials (ordered near to far); count 0 turns shadows off.
+int g4f_gfx_set_shadow_cascades(g4f_gfx* gfx, const g4f_shadow_cascade* cascades, int count);
 
 typedef struct g4f_gfx_vertex_p3n3uv2 {
     float px, py, pz;
@@ -348,6 +500,10 @@ void g4f_clip_pop(g4f_renderer* renderer);
 // Bitmaps.
 g4f_bitmap* g4f_bitmap_load(g4f_renderer* renderer, const char* path_utf8);
 g4f_bitmap* g4f_bitmap_create_rgba8(g4f_renderer* renderer, int width, int height, const void* rgbaPixels, int rowPitchBytes);
+// View of a sub-rectangle of another bitmap (an atlas page, a sprite sheet): shares its pixels,
+// reports the sub-rectangle's size and draws only that part. Destroy it like any bitmap; the
+// source may be destroyed first. Pack with a gutter (g4f_atlas) so filtering stays inside the region.
+g4f_bitmap* g4f_bitmap_create_region(const g4f_bitmap* source, int x, int y, int width, int height);
 void g4f_bitmap_destroy(g4f_bitmap* bitmap);
 void g4f_bitmap_get_size(const g4f_bitmap* bitmap, int* width, int* height);
 void g4f_draw_bitmap(g4f_renderer* renderer, const g4f_bitmap* bitmap, g4f_rect_f dst, float opacity);
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Texture atlas packing for UI bitmaps and small RGBA8 textures.
+// - Packs many small images into a few fixed-size pages: skyline (bottom-left) or maxrects
+//   (best short side fit). Rotation is not used, so regions map to plain UV rectangles.
+// - Deterministic: the layout depends only on the desc and the image sizes in insertion order
+//   (larger images first, ties broken by index); composing with or without jobs gives the same pages.
+// - Padding keeps transparent texels between neighbours; gutters repeat each image's edge texels
+//   outwards so bilinear sampling at the border stays inside the image.
+// - mipLevels > 1 aligns every slot to 2^(mipLevels-1) texels so the first mipLevels levels of a
+//   page never blend two images into one texel (combine with gutters for filtered minification).
+// - Draw with g4f_atlas_create_bitmaps (2D renderer, UI) or the page texture + region UVs (gfx).
+
+enum {
+    G4F_ATLAS_SKYLINE = 0,  // fastest, good for similar heights (icons, glyphs)
+    G4F_ATLAS_MAXRECTS = 1, // tighter for mixed sizes, O(free rects) per insert
+};
+
+typedef struct g4f_atlas_desc {
+    int pageWidth;  // 0 = 1024
+    int pageHeight; // 0 = 1024
+    int padding;    // transparent texels between slots (right/bottom of each slot)
+    int gutter;     // edge texels repeated around each image
+    int mipLevels;  // 0/1 = no alignment; N aligns slots for N mip levels
+    int algorithm;  // G4F_ATLAS_SKYLINE or G4F_ATLAS_MAXRECTS
+} g4f_atlas_desc;
+
+g4f_atlas_desc g4f_atlas_desc_default(void);
+
+typedef struct g4f_atlas_rect {
+    int page; // -1 when the image does not fit on an empty page
+    int x;    // image texels, excluding gutter and padding
+    int y;
+    int width;
+    int height;
+} g4f_atlas_rect;
+
+// Packs `count` rectangles (sizes[i * 2] = width, sizes[i * 2 + 1] = height) without pixels.
+// Returns the number of pages used, -1 if any rectangle is larger than a page (its page is -1,
+// the rest are still placed).
+int g4f_atlas_pack_rects(const g4f_atlas_desc* desc, const int* sizes, int count, g4f_atlas_rect* outRects);
+
+typedef struct g4f_atlas g4f_atlas;
+
+g4f_atlas* g4f_atlas_create(const g4f_atlas_desc* desc);
+void g4f_atlas_destroy(g4f_atlas* atlas);
+
+// Copies the pixels (pitch <= 0 = tightly packed). Returns the image index, -1 on failure.
+// Adding after g4f_atlas_build invalidates the pages until the next build.
+int g4f_atlas_add_rgba8(g4f_atlas* atlas, int width, int height, const void* rgbaPixels, int pitchBytes);
+int g4f_atlas_image_count(const g4f_atlas* atlas);
+
+// Packs every image added so far and composes the pages (image copies run on jobs).
+// Returns the page count, 0 on failure (see g4f_last_error()).
+int g4f_atlas_build(g4f_atlas* atlas, g4f_jobs* jobs);
+
+typedef struct g4f_atlas_region {
+    int page;
+    int x; // texels in the page
+    int y;
+    int width;
+    int height;
+    float u0; // normalized page coordinates of the image edges
+    float v0;
+    float u1;
+    float v1;
+} g4f_atlas_region;
+
+// Valid after g4f_atlas_build. Returns 0 for unknown indices.
+int g4f_atlas_get_region(const g4f_atlas* atlas, int index, g4f_atlas_region* outRegion);
+int g4f_atlas_page_count(const g4f_atlas* atlas);
+// Tightly packed RGBA8 page (pageWidth x pageHeight), transparent where unused.
+const uint8_t* g4f_atlas_page_pixels(const g4f_atlas* atlas, int page, int* outWidth, int* outHeight);
+
+typedef struct g4f_atlas_stats {
+    int pages;
+    long long imageTexels;  // sum of image areas (without gutter/padding)
+    long long pageTexels;   // pages * pageWidth * pageHeight
+    long long usedTexels;   // like pageTexels, but each page only down to its lowest used row
+    float efficiency;       // imageTexels / pageTexels
+    float usedEfficiency;   // imageTexels / usedTexels (ignores the empty tail of partly filled pages)
+} g4f_atlas_stats;
+
+void g4f_atlas_get_stats(const g4f_atlas* atlas, g4f_atlas_stats* outStats);
+
+// ---- renderer integration ----
+
+// One g4f_bitmap per image (g4f_atlas_image_count entries), each a region of a shared page bitmap,
+// ready for g4f_draw_bitmap / g4f_ui_image. Pages are uploaded once; destroying every image
+// bitmap frees them. Returns 1 on success, 0 on failure (nothing is left allocated).
+int g4f_atlas_create_bitmaps(const g4f_atlas* atlas, g4f_renderer* renderer, g4f_bitmap** outBitmaps);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
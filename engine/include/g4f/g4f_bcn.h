@@ -0,0 +1,58 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Block compression of RGBA8 images to BC1/BC3/BC7 and CPU decoding back to RGBA8
+// (platform-neutral; the gfx helpers at the end are implemented by the D3D11 backend).
+// - 4x4 blocks, block rows spread over an optional g4f_jobs pool, 4-wide SIMD index search.
+// - Partial edge blocks (levels smaller than 4 pixels, odd sizes) replicate the edge pixels.
+// - Errors are measured on the stored byte values with equal channel weights, i.e. the encoder
+//   maximizes PSNR of the values the sampler sees.
+// - The decoder follows the D3D interpolation rules and decodes every BC7 mode, not only the
+//   ones the encoder writes.
+
+enum {
+    G4F_BCN_BC1 = 1, // 8 bytes per block: RGB + 1-bit alpha (pixels with alpha < 128 become transparent black)
+    G4F_BCN_BC3 = 2, // 16 bytes per block: BC1-style RGB + interpolated 8-bit alpha
+    G4F_BCN_BC7 = 3, // 16 bytes per block: RGBA, much higher quality, slower to encode
+};
+// Format values match G4F_PACK_FORMAT_BC1/BC3/BC7, so encoded chains go straight into packs.
+
+enum {
+    G4F_BCN_QUALITY_FAST = 0,   // BC1/BC3: principal axis fit; BC7: mode 6 only
+    G4F_BCN_QUALITY_NORMAL = 1, // + least-squares endpoint refinement; BC7: + best 4 two-subset partitions
+    G4F_BCN_QUALITY_HIGH = 2,   // + second refinement pass; BC7: + best 16 partitions and mode 3
+};
+
+// Bytes for `levels` tightly packed levels starting at width x height (D3D level sizes, rows of
+// ceil(w / 4) blocks). 0 for an invalid format or size.
+size_t g4f_bcn_chain_bytes(int format, int width, int height, int levels);
+
+// Encodes one image. outBlocks receives ceil(height / 4) rows of ceil(width / 4) blocks.
+// srcPitchBytes <= 0 means tightly packed. Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_bcn_encode_rgba8(const void* src, int width, int height, int srcPitchBytes, int format, int quality, g4f_jobs* jobs, void* outBlocks);
+// Encodes a tightly packed RGBA8 mip chain (g4f_mipgen_build_chain_rgba8 layout) level by level into
+// g4f_bcn_chain_bytes(format, width, height, levels) bytes.
+int g4f_bcn_encode_chain_rgba8(const void* chain, int width, int height, int levels, int format, int quality, g4f_jobs* jobs, void* outChain);
+
+// Decodes one level of blocks (layout as above) to RGBA8. dstPitchBytes <= 0 means tightly packed.
+int g4f_bcn_decode_rgba8(const void* blocks, int format, int width, int height, void* dst, int dstPitchBytes);
+
+// ---- gfx integration ----
+
+// Immutable texture from `mipLevels` tightly packed levels of blocks (level 0 first). D3D needs
+// width and height to be multiples of 4.
+g4f_gfx_texture* g4f_gfx_texture_create_bcn(g4f_gfx* gfx, int format, int width, int height, int mipLevels, const void* blocks);
+// g4f_gfx_texture_create_rgba8_mipmapped, but the chain is block-compressed before upload
+// (4x to 8x less VRAM and bandwidth). Encoding runs on `jobs` when given.
+g4f_gfx_texture* g4f_gfx_texture_create_rgba8_compressed(g4f_gfx* gfx, int width, int height, const void* rgbaPixels, int rowPitchBytes,
+                                                         int format, int quality, int mipFilter, int mipFlags, g4f_jobs* jobs);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
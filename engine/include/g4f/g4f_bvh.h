@@ -0,0 +1,101 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Bounding volume hierarchies for ray, segment and sphere queries (platform-neutral, CPU only).
+// Two levels: a g4f_bvh_mesh (bottom level) is built once over a triangle mesh in its local
+// space; a g4f_bvh_scene (top level) holds transformed instances of meshes. Both are built with
+// binned SAH and stored as 4-wide nodes whose four child boxes are tested together with SIMD.
+//
+// Moving instances only need g4f_bvh_scene_refit (bounds update, same tree); adding or removing
+// instances takes effect on the next g4f_bvh_scene_build. Queries are read-only and may run
+// concurrently from several threads, but not during a build or refit.
+
+typedef struct g4f_bvh_mesh g4f_bvh_mesh;
+typedef struct g4f_bvh_scene g4f_bvh_scene;
+
+typedef struct g4f_bvh_mesh_desc {
+    const void* positions; // xyz floats per vertex (e.g. &vertices[0].px)
+    int positionStride;    // bytes between vertices (0 = 12)
+    int vertexCount;
+    // Triangle list indices: indices32 or indices16; when both are null the vertices themselves
+    // form the triangle list.
+    const uint32_t* indices32;
+    const uint16_t* indices16;
+    int indexCount;
+    int maxLeafTriangles; // 0 = 4 (max 16)
+} g4f_bvh_mesh_desc;
+
+g4f_bvh_mesh_desc g4f_bvh_mesh_desc_default(void);
+
+typedef struct g4f_bvh_hit {
+    float t;       // distance along the ray in units of |dir|
+    int instance;  // scene queries: instance id; mesh queries: -1
+    int triangle;  // triangle index in the source mesh
+    float u, v;    // barycentrics: p = (1-u-v)*v0 + u*v1 + v*v2
+} g4f_bvh_hit;
+
+typedef struct g4f_bvh_stats {
+    int nodes; // 4-wide nodes
+    int leaves;
+    int depth;
+    int primitives; // triangles (mesh) or instances (scene)
+    float sahCost;  // relative traversal cost estimate of the tree
+} g4f_bvh_stats;
+
+// Copies positions and builds the tree; returns null on failure (see g4f_last_error()).
+g4f_bvh_mesh* g4f_bvh_mesh_create(const g4f_bvh_mesh_desc* desc);
+void g4f_bvh_mesh_destroy(g4f_bvh_mesh* mesh);
+void g4f_bvh_mesh_bounds(const g4f_bvh_mesh* mesh, g4f_vec3* outMin, g4f_vec3* outMax);
+void g4f_bvh_mesh_get_stats(const g4f_bvh_mesh* mesh, g4f_bvh_stats* out);
+
+// Closest hit along origin + t * dir for t in [0, tMax]; returns 1 and fills `hit` on a hit.
+int g4f_bvh_mesh_raycast(const g4f_bvh_mesh* mesh, g4f_vec3 origin, g4f_vec3 dir, float tMax, g4f_bvh_hit* hit);
+// Line of sight: 1 when any triangle crosses the segment from a to b (stops at the first hit).
+int g4f_bvh_mesh_segment_blocked(const g4f_bvh_mesh* mesh, g4f_vec3 a, g4f_vec3 b);
+// Triangles touching the sphere: writes up to `maxHits` (t = 0, u = v = 0) and returns the total count.
+int g4f_bvh_mesh_overlap_sphere(const g4f_bvh_mesh* mesh, g4f_vec3 center, float radius, g4f_bvh_hit* hits, int maxHits);
+// Calls fn with the vertices of every triangle whose bounds overlap the box (mesh space);
+// a non-zero return from fn stops the query. Used by narrowphase code (g4f_collision.h).
+typedef int (*g4f_bvh_triangle_fn)(void* user, int triangle, const g4f_vec3* vertices);
+void g4f_bvh_mesh_query_box(const g4f_bvh_mesh* mesh, g4f_vec3 boxMin, g4f_vec3 boxMax, g4f_bvh_triangle_fn fn, void* user);
+
+// Instances reference meshes (which must outlive the scene) with a local-to-world transform.
+g4f_bvh_scene* g4f_bvh_scene_create(void);
+void g4f_bvh_scene_destroy(g4f_bvh_scene* scene);
+// Returns the instance id (>= 0), or -1 on failure. Ids of removed instances are reused.
+int g4f_bvh_scene_add(g4f_bvh_scene* scene, const g4f_bvh_mesh* mesh, const g4f_mat4* transform);
+void g4f_bvh_scene_remove(g4f_bvh_scene* scene, int instance);
+void g4f_bvh_scene_set_transform(g4f_bvh_scene* scene, int instance, const g4f_mat4* transform);
+// Rebuilds the top-level tree from every current instance.
+void g4f_bvh_scene_build(g4f_bvh_scene* scene);
+// Updates the bounds of instances moved since the last build/refit without changing the tree.
+void g4f_bvh_scene_refit(g4f_bvh_scene* scene);
+void g4f_bvh_scene_get_stats(const g4f_bvh_scene* scene, g4f_bvh_stats* out);
+
+int g4f_bvh_scene_raycast(const g4f_bvh_scene* scene, g4f_vec3 origin, g4f_vec3 dir, float tMax, g4f_bvh_hit* hit);
+int g4f_bvh_scene_segment_blocked(const g4f_bvh_scene* scene, g4f_vec3 a, g4f_vec3 b);
+int g4f_bvh_scene_overlap_sphere(const g4f_bvh_scene* scene, g4f_vec3 center, float radius, g4f_bvh_hit* hits, int maxHits);
+
+typedef struct g4f_bvh_ray {
+    g4f_vec3 origin;
+    g4f_vec3 dir;
+    float tMax;
+} g4f_bvh_ray;
+
+// Closest hits for many rays, spread over `jobs` (null runs inline). hits[i].t < 0 marks a miss.
+// Returns the number of rays that hit.
+int g4f_bvh_scene_raycast_batch(const g4f_bvh_scene* scene, const g4f_bvh_ray* rays, int count, g4f_bvh_hit* hits, g4f_jobs* jobs);
+
+// Picking ray through a pixel: unprojects (px, py) in a width x height viewport with the
+// inverse of viewProj. The ray starts on the near plane; |dir| is the near-to-far distance.
+g4f_bvh_ray g4f_bvh_ray_from_screen(const g4f_mat4* viewProj, float px, float py, float width, float height);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -18,6 +18,9 @@ typedef struct g4f_camera_fps {
 
 g4f_camera_fps g4f_camera_fps_default(void);
 void g4f_camera_fps_update(g4f_camera_fps* cam, const g4f_window* window, float dtSeconds);
+// Mouse look only: returns this frame's WASD/SPACE/CTRL displacement without moving the camera,
+// for callers that resolve collisions themselves (see g4f_character_update_fps).
+g4f_vec3 g4f_camera_fps_update_look(g4f_camera_fps* cam, const g4f_window* window, float dtSeconds);
 
 g4f_mat4 g4f_camera_fps_view(const g4f_camera_fps* cam);
 g4f_mat4 g4f_camera_fps_proj(const g4f_camera_fps* cam, float aspect);
@@ -0,0 +1,126 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_bvh.h"
+#include "g4f_camera.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Collision detection (platform-neutral except g4f_character_update_fps, which reads input).
+// - Broadphase: overlapping pairs among moving AABBs. Incremental sort-and-sweep on X keeps the
+//   previous frame's order, so re-sorting nearly sorted bodies is close to linear; when too many
+//   bodies share X intervals (dense piles, bodies lined up along X) a uniform spatial hash is used
+//   instead. Both paths report the same pairs.
+// - Narrowphase: AABB, sphere and capsule against a triangle mesh (g4f_bvh_mesh, mesh space).
+// - Character controller: a capsule that collides and slides against a static mesh, with
+//   gravity, ground detection and a g4f_camera_fps adapter.
+
+typedef struct g4f_aabb {
+    g4f_vec3 min;
+    g4f_vec3 max;
+} g4f_aabb;
+
+// ---- Broadphase ----
+
+typedef struct g4f_broadphase g4f_broadphase;
+
+enum {
+    G4F_BROADPHASE_AUTO = 0, // sort-and-sweep, or the spatial hash when X overlaps get dense
+    G4F_BROADPHASE_SAP = 1,
+    G4F_BROADPHASE_GRID = 2,
+};
+
+typedef struct g4f_broadphase_desc {
+    int mode;               // G4F_BROADPHASE_*
+    float cellSize;         // spatial hash cell edge; 0 = twice the average body extent
+    float denseCandidates;  // AUTO switches to the hash above this many X overlaps per body (0 = 16)
+} g4f_broadphase_desc;
+
+g4f_broadphase_desc g4f_broadphase_desc_default(void);
+
+typedef struct g4f_broadphase_pair {
+    int a; // a < b
+    int b;
+} g4f_broadphase_pair;
+
+typedef struct g4f_broadphase_stats {
+    int bodies;
+    int pairs;
+    int usedGrid;       // 1 when the last update ran the spatial hash
+    long long xOverlaps; // body pairs overlapping on X (the sort-and-sweep candidate count)
+    long long tests;    // box tests performed by the last update
+    int swaps;          // insertion-sort swaps in the last update
+} g4f_broadphase_stats;
+
+g4f_broadphase* g4f_broadphase_create(const g4f_broadphase_desc* desc); // null desc = defaults
+void g4f_broadphase_destroy(g4f_broadphase* bp);
+
+// Returns the body id (>= 0), or -1 on failure. Ids of removed bodies are reused.
+int g4f_broadphase_add(g4f_broadphase* bp, const g4f_aabb* box);
+void g4f_broadphase_move(g4f_broadphase* bp, int body, const g4f_aabb* box);
+void g4f_broadphase_remove(g4f_broadphase* bp, int body);
+
+// Finds all overlapping pairs (touching boxes overlap). Returns the pair count.
+int g4f_broadphase_update(g4f_broadphase* bp);
+// Pairs of the last update sorted by (a, b); valid until the next update or destroy.
+const g4f_broadphase_pair* g4f_broadphase_pairs(const g4f_broadphase* bp, int* count);
+void g4f_broadphase_get_stats(const g4f_broadphase* bp, g4f_broadphase_stats* out);
+
+// ---- Narrowphase against a triangle mesh ----
+
+typedef struct g4f_contact {
+    g4f_vec3 point;  // closest point on the triangle
+    g4f_vec3 normal; // unit, from the triangle towards the shape
+    float depth;     // penetration along normal (>= 0)
+    int triangle;
+} g4f_contact;
+
+// Each returns the number of touching triangles, writing up to maxContacts contacts (one per
+// triangle). Triangles are two-sided.
+int g4f_collide_sphere_mesh(const g4f_bvh_mesh* mesh, g4f_vec3 center, float radius, g4f_contact* contacts, int maxContacts);
+// Capsule = all points within `radius` of the segment a-b.
+int g4f_collide_capsule_mesh(const g4f_bvh_mesh* mesh, g4f_vec3 a, g4f_vec3 b, float radius, g4f_contact* contacts, int maxContacts);
+// Separating-axis test; the contact normal is the axis of least penetration.
+int g4f_collide_aabb_mesh(const g4f_bvh_mesh* mesh, const g4f_aabb* box, g4f_contact* contacts, int maxContacts);
+
+// ---- Character controller ----
+
+typedef struct g4f_character_desc {
+    float radius;      // capsule radius (0 = 0.3)
+    float height;      // feet to top of head, >= 2 * radius (0 = 1.8)
+    float eyeHeight;   // camera height above the feet (0 = 1.6)
+    float maxSlopeCos; // surfaces with normal.y >= this are ground (0 = cos 50 degrees)
+    float gravity;     // units/s^2 downwards (0 = 20; ignored when flying)
+    float jumpSpeed;   // units/s (0 = 6)
+    int flying;        // 1: no gravity, free vertical movement like g4f_camera_fps_update
+} g4f_character_desc;
+
+g4f_character_desc g4f_character_desc_default(void);
+
+typedef struct g4f_character {
+    g4f_character_desc desc;
+    g4f_vec3 position; // feet (bottom of the capsule)
+    g4f_vec3 velocity; // only the vertical part persists between steps when walking
+    int grounded;
+} g4f_character;
+
+void g4f_character_init(g4f_character* ch, const g4f_character_desc* desc, g4f_vec3 feet); // null desc = defaults
+
+// Collide-and-slide: moves by `displacement` in sub-steps no longer than half the radius,
+// pushing out of penetrations and sliding along what it hits. Ground contacts push straight
+// up so characters do not creep down walkable slopes. Returns the displacement applied.
+g4f_vec3 g4f_character_move(g4f_character* ch, const g4f_bvh_mesh* world, g4f_vec3 displacement);
+
+// One simulation step: horizontal `wishVelocity` (plus vertical when flying), gravity, and a
+// jump when `jump` is set and the character is grounded.
+void g4f_character_step(g4f_character* ch, const g4f_bvh_mesh* world, g4f_vec3 wishVelocity, int jump, float dtSeconds);
+
+// FPS adapter: mouse look and WASD from g4f_camera_fps_update_look drive the character
+// (SPACE jumps unless flying) and the camera is placed at eye height.
+void g4f_character_update_fps(g4f_character* ch, g4f_camera_fps* cam, const g4f_window* window, const g4f_bvh_mesh* world, float dtSeconds);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+#include "g4f_texsynth.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Content-addressed disk cache for procedural results (platform-neutral).
+// Generated pixels, vertices or any other blob are stored under a 64-bit key derived from the
+// generator ID, its version and its parameters, so changing any of them is a miss rather than a
+// stale hit. On the next launch hits are memory-mapped instead of regenerated.
+// - One file per entry (header + 64-byte aligned data), written to a temporary file and renamed,
+//   so a crash never leaves a partial entry behind.
+// - The directory is capped at maxBytes: least recently used entries are deleted first. Use
+//   order is tracked in memory and persisted through file modification times.
+// - Thread-safe: generators running on g4f_jobs workers may get/put concurrently.
+
+typedef struct g4f_content_cache g4f_content_cache;
+
+typedef struct g4f_content_cache_desc {
+    const char* dirUtf8;  // created if missing
+    uint64_t maxBytes;    // total entry file bytes (0 = 512 MB)
+    int verifyChecksums;  // 0/1: hash the data of every hit (reads the whole entry; default 0)
+} g4f_content_cache_desc;
+
+typedef struct g4f_content_cache_stats {
+    int entries;
+    uint64_t bytes;       // on disk, headers included
+    uint64_t hits;
+    uint64_t misses;
+    uint64_t hitBytes;
+    uint64_t puts;
+    uint64_t evictions;
+    uint64_t rejected;    // corrupt or truncated entries found (deleted, counted as misses)
+} g4f_content_cache_stats;
+
+// Key for a generator: `generatorId` names the algorithm, `generatorVersion` must change whenever
+// its output changes, and `params` are the raw parameter bytes (no pointers or padding garbage).
+uint64_t g4f_content_cache_key(const char* generatorId, uint32_t generatorVersion, const void* params, size_t paramsSize);
+// Extends a key with more parameter bytes (e.g. arrays a parameter struct points to).
+uint64_t g4f_content_cache_key_append(uint64_t key, const void* bytes, size_t size);
+
+// Scans the directory and trims it to maxBytes. Returns null on failure (see g4f_last_error()).
+g4f_content_cache* g4f_content_cache_open(const g4f_content_cache_desc* desc);
+// Unmaps every hit returned by g4f_content_cache_get.
+void g4f_content_cache_close(g4f_content_cache* cache);
+
+// Hit: returns the mapped data (valid until g4f_content_cache_close; mapped entries are never
+// evicted) and its size. Miss: returns null; not an error and does not touch g4f_last_error().
+const void* g4f_content_cache_get(g4f_content_cache* cache, uint64_t key, size_t* outSize);
+// Stores a blob (replacing an unmapped entry with the same key), then evicts least recently used
+// entries while over maxBytes. Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_content_cache_put(g4f_content_cache* cache, uint64_t key, const void* data, size_t size);
+
+void g4f_content_cache_get_stats(const g4f_content_cache* cache, g4f_content_cache_stats* out);
+
+// Procedural texture through the cache: maps a previous result or runs g4f_texsynth_generate_rgba8
+// (on `jobs`) and stores it. Returns tightly packed RGBA8 pixels valid until
+// g4f_content_cache_close, or null on failure.
+const uint8_t* g4f_content_cache_texsynth_rgba8(g4f_content_cache* cache, const g4f_texsynth_desc* desc, int width, int height, g4f_jobs* jobs);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -20,6 +20,7 @@ double g4f_ctx3d_ui_time(const g4f_ctx3d_ui* ctx);
 float g4f_ctx3d_ui_dt(const g4f_ctx3d_ui* ctx); // seconds since last poll
 
 g4f_window* g4f_ctx3d_ui_window(g4f_ctx3d_ui* ctx);
+g4f_ctx3d* g4f_ctx3d_ui_ctx3d(g4f_ctx3d_ui* ctx); // e.g. for g4f_ctx3d_set_dynamic_resolution
 g4f_gfx* g4f_ctx3d_ui_gfx(g4f_ctx3d_ui* ctx);
 g4f_renderer* g4f_ctx3d_ui_renderer(g4f_ctx3d_ui* ctx);
 g4f_ui* g4f_ctx3d_ui_ui(g4f_ctx3d_ui* ctx);
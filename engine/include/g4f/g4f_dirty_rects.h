@@ -0,0 +1,41 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Fixed-capacity dirty-rectangle accumulator (platform-neutral, no allocations).
+// - Rects are clipped to the bounds. Overlapping rects are merged into their union, as are
+//   edge-adjacent rects whose union wastes no area, so stored rects never overlap.
+// - When full, the new rect is merged with the existing rect whose union wastes the least area.
+// Used by streaming textures to upload only the regions that changed since the last flush.
+
+#define G4F_DIRTY_RECTS_MAX 8
+
+typedef struct g4f_rect_i {
+    int x;
+    int y;
+    int w;
+    int h;
+} g4f_rect_i;
+
+typedef struct g4f_dirty_rects {
+    g4f_rect_i rects[G4F_DIRTY_RECTS_MAX];
+    int count;
+    int boundsW;
+    int boundsH;
+} g4f_dirty_rects;
+
+void g4f_dirty_rects_reset(g4f_dirty_rects* dirty, int boundsW, int boundsH);
+void g4f_dirty_rects_clear(g4f_dirty_rects* dirty); // keeps the bounds
+void g4f_dirty_rects_add(g4f_dirty_rects* dirty, int x, int y, int w, int h);
+void g4f_dirty_rects_add_all(g4f_dirty_rects* dirty);
+
+// Total pixels covered by the stored rects.
+int g4f_dirty_rects_area(const g4f_dirty_rects* dirty);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Dynamic resolution controller (platform-neutral, deterministic, no allocations).
+// Fed with per-frame CPU and GPU times, it picks a render scale in [minScale, maxScale]:
+// - frame cost is the slower of the two (CPU and GPU overlap), smoothed with an exponential moving
+//   average. Waits in Present are not cost: with vsync on they pin the frame at the refresh
+//   interval however cheap it is, and the scale would never rise again;
+// - the scale drops only after `lowerFrames` consecutive frames above the upper band and rises
+//   one step only after `raiseFrames` consecutive frames below the lower band (hysteresis);
+// - drops assume cost ~ pixel count (scale^2) and jump straight to the estimated scale.
+// Scales are quantized to `scaleStep` so render targets are not recreated every frame.
+
+typedef struct g4f_dynres_desc {
+    float targetFrameMs; // frame budget (e.g. 16.67 for 60 Hz)
+    float minScale;      // per axis, e.g. 0.5
+    float maxScale;      // per axis, usually 1.0
+    float scaleStep;     // quantization / raise step
+    float upperBand;     // lower the scale when avg > target * upperBand
+    float lowerBand;     // raise the scale when avg < target * lowerBand
+    int lowerFrames;
+    int raiseFrames;
+    float smoothing;     // EMA weight of the newest sample, (0, 1]
+} g4f_dynres_desc;
+
+typedef struct g4f_dynres {
+    g4f_dynres_desc desc;
+    float scale;
+    float avgFrameMs; // 0 until the first sample after a reset/scale change
+    int overFrames;
+    int underFrames;
+    int changes;      // number of scale changes so far (diagnostics)
+} g4f_dynres;
+
+// 60 Hz budget, scale 0.5..1.0 in 0.05 steps, bands 1.05 / 0.85, lower after 3 frames, raise after 30.
+g4f_dynres_desc g4f_dynres_desc_default(void);
+
+void g4f_dynres_init(g4f_dynres* dynres, const g4f_dynres_desc* desc); // null desc: defaults
+// Feeds one frame and returns the scale to use for the next frame. gpuMs <= 0 means unknown
+// (the CPU time alone is used).
+float g4f_dynres_update(g4f_dynres* dynres, float cpuMs, float gpuMs);
+
+// g4f_ctx3d integration: the 3D frame renders into a scaled offscreen target which is upscaled
+// to the backbuffer by g4f_ctx3d_resolve (called automatically by g4f_frame3d_end and before the
+// g4f_ctx3d_ui overlay). The controller is fed the CPU time before Present and the GPU frame time
+// from g4f_gfx_gpu_timings; GPU results lag a few frames, so ones recorded before a scale change
+// are skipped. Without GPU timestamps (CPU clock fallback) only the CPU time is seen.
+void g4f_ctx3d_set_dynamic_resolution(g4f_ctx3d* ctx, const g4f_dynres_desc* desc); // null disables
+float g4f_ctx3d_render_scale(const g4f_ctx3d* ctx); // 1 when disabled
+void g4f_ctx3d_resolve(g4f_ctx3d* ctx);
+// Timings of the last completed frame: begin..before Present, and Present itself.
+void g4f_ctx3d_frame_timings(const g4f_ctx3d* ctx, float* cpuMs, float* presentMs);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
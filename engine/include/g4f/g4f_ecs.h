@@ -0,0 +1,135 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Archetype entity-component-system (platform-neutral, headless).
+// Entities with the same component set share an archetype whose storage is a list of fixed-size
+// chunks (16 KB); inside a chunk every component is its own tightly packed column, so systems
+// stream through plain arrays. Adding or removing a component moves the entity to another
+// archetype; removal keeps chunks dense by moving the archetype's last entity into the hole.
+//
+// Queries cache their matching archetypes and only look at archetypes created since the last
+// use. Systems run a function per chunk of a query; g4f_ecs_run_systems batches systems whose
+// component access does not conflict and runs each batch's chunks in parallel on g4f_jobs.
+//
+// Structural changes (create/destroy entities, add/remove components) must not happen while a
+// query or system is iterating.
+
+// Entity handle; 0 is never a valid entity. Handles of destroyed entities stay invalid: a slot
+// is retired after 1023 entities instead of reusing a handle.
+typedef uint32_t g4f_entity;
+#define G4F_ENTITY_NULL 0u
+
+#define G4F_ECS_MAX_COMPONENTS 64
+#define G4F_ECS_QUERY_MAX 8   // components a query can read/write (plus any number excluded)
+#define G4F_ECS_BIT(component) (1ull << (component))
+
+// Built-in components, registered by g4f_ecs_create.
+enum {
+    G4F_ECS_TRANSFORM = 0,  // g4f_ecs_transform (default: identity)
+    G4F_ECS_WORLD = 1,      // g4f_mat4, written by g4f_ecs_update_transforms (default: identity)
+    G4F_ECS_RENDERABLE = 2, // g4f_ecs_renderable
+    G4F_ECS_BUILTIN_COUNT = 3,
+};
+
+typedef struct g4f_ecs_transform {
+    g4f_vec3 position;
+    g4f_quat rotation;
+    g4f_vec3 scale;
+} g4f_ecs_transform;
+
+typedef struct g4f_ecs_renderable {
+    const g4f_gfx_mesh* mesh;
+    const g4f_gfx_material* material;
+} g4f_ecs_renderable;
+
+typedef struct g4f_ecs g4f_ecs;
+typedef struct g4f_ecs_query g4f_ecs_query;
+
+g4f_ecs* g4f_ecs_create(void);
+void g4f_ecs_destroy(g4f_ecs* ecs); // also destroys its queries
+
+// Registers a component type of `size` bytes (0 = tag without data); `align` <= 64 (0 = 16).
+// New components start as a copy of `defaultValue` (null = zeroed).
+// Returns the component id, or -1 on failure (see g4f_last_error()).
+int g4f_ecs_register_component(g4f_ecs* ecs, const char* name, int size, int align, const void* defaultValue);
+int g4f_ecs_component_size(const g4f_ecs* ecs, int component); // -1 for unknown ids
+
+// Creates `count` entities with the given components (default values) and writes their handles
+// to `outEntities` (may be null). Returns the number created.
+int g4f_ecs_spawn(g4f_ecs* ecs, const int* components, int componentCount, int count, g4f_entity* outEntities);
+g4f_entity g4f_ecs_create_entity(g4f_ecs* ecs); // no components
+void g4f_ecs_destroy_entity(g4f_ecs* ecs, g4f_entity entity);
+int g4f_ecs_alive(const g4f_ecs* ecs, g4f_entity entity);
+int g4f_ecs_entity_count(const g4f_ecs* ecs);
+
+// Adds a component (copying `value`, or the default when null); an existing one is overwritten.
+// Returns 0 for an invalid entity or component.
+int g4f_ecs_add(g4f_ecs* ecs, g4f_entity entity, int component, const void* value);
+int g4f_ecs_remove(g4f_ecs* ecs, g4f_entity entity, int component);
+int g4f_ecs_has(const g4f_ecs* ecs, g4f_entity entity, int component);
+// Component data, null when absent (or for tags). Valid until the next structural change.
+void* g4f_ecs_get(g4f_ecs* ecs, g4f_entity entity, int component);
+
+// Matches entities having every `with` component and none of the `without` ones.
+// Returns null on failure (see g4f_last_error()).
+g4f_ecs_query* g4f_ecs_query_create(g4f_ecs* ecs, const int* with, int withCount, const int* without, int withoutCount);
+void g4f_ecs_query_destroy(g4f_ecs_query* query);
+int g4f_ecs_query_entity_count(g4f_ecs_query* query);
+
+// One chunk of matching entities: columns[i] holds `count` values of the query's with[i]
+// component (null for tags).
+typedef struct g4f_ecs_chunk {
+    int count;
+    const g4f_entity* entities;
+    void* columns[G4F_ECS_QUERY_MAX];
+} g4f_ecs_chunk;
+
+typedef void (*g4f_ecs_chunk_fn)(void* user, const g4f_ecs_chunk* chunk, int workerIndex);
+
+// Calls fn for every matching chunk: inline, or spread over `jobs` (null runs inline).
+void g4f_ecs_query_each(g4f_ecs_query* query, g4f_ecs_chunk_fn fn, void* user);
+void g4f_ecs_query_run(g4f_ecs_query* query, g4f_jobs* jobs, g4f_ecs_chunk_fn fn, void* user);
+
+typedef struct g4f_ecs_system {
+    const char* name;
+    g4f_ecs_query* query;
+    uint64_t writes; // G4F_ECS_BIT mask of components fn writes; the query's others are read-only
+    g4f_ecs_chunk_fn fn;
+    void* user;
+} g4f_ecs_system;
+
+// Runs systems in order. Consecutive systems without conflicting access (one writes what the
+// other reads or writes) form a batch whose chunks run together on `jobs`.
+// Returns the number of batches, or -1 on invalid args.
+int g4f_ecs_run_systems(g4f_ecs* ecs, const g4f_ecs_system* systems, int systemCount, g4f_jobs* jobs);
+
+// Built-in system: WORLD = g4f_mat4_trs(TRANSFORM) for entities with both.
+void g4f_ecs_update_transforms(g4f_ecs* ecs, g4f_jobs* jobs);
+
+typedef struct g4f_ecs_draw {
+    const g4f_gfx_mesh* mesh;
+    const g4f_gfx_material* material;
+    g4f_mat4 model;
+    g4f_mat4 mvp; // model * viewProj
+    g4f_entity entity;
+} g4f_ecs_draw;
+
+// Fills the draw list from entities with WORLD and a RENDERABLE that has mesh and material,
+// grouped by material and mesh. Returns the draw count (0 on invalid args).
+int g4f_ecs_build_draws(g4f_ecs* ecs, const g4f_mat4* viewProj, g4f_jobs* jobs);
+// Last built draw list; valid until the next build or destroy.
+const g4f_ecs_draw* g4f_ecs_draws(const g4f_ecs* ecs, int* count);
+
+// gfx integration: updates transforms, builds the draw list and submits it through
+// g4f_gfx_draw_mesh_xform. Returns the number of draws submitted.
+int g4f_gfx_draw_ecs(g4f_gfx* gfx, g4f_ecs* ecs, const g4f_mat4* viewProj, g4f_jobs* jobs);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Per-frame renderer counters (platform-neutral helpers, no allocations).
+// g4f_gfx and the 2D renderer count draws, state binds issued, binds filtered by their state
+// caches, uploaded bytes and created device objects from one frame end to the next; the snapshot
+// of the last ended frame is what the getters return. Budgets turn the counters into pass/fail
+// checks for automated headless runs.
+
+// State kinds; the 2D renderer only uses TARGET, TEXTURE, BRUSH and CLIP.
+enum {
+    G4F_GFX_STATE_SHADER = 0,       // VS/PS
+    G4F_GFX_STATE_INPUT_LAYOUT = 1,
+    G4F_GFX_STATE_VERTEX_BUFFER = 2,
+    G4F_GFX_STATE_INDEX_BUFFER = 3,
+    G4F_GFX_STATE_TOPOLOGY = 4,
+    G4F_GFX_STATE_BLEND = 5,
+    G4F_GFX_STATE_DEPTH = 6,
+    G4F_GFX_STATE_RASTERIZER = 7,
+    G4F_GFX_STATE_SAMPLER = 8,
+    G4F_GFX_STATE_TEXTURE = 9,      // shader resource views / bitmaps
+    G4F_GFX_STATE_CONSTANT_BUFFER = 10,
+    G4F_GFX_STATE_TARGET = 11,      // render/depth targets + viewport
+    G4F_GFX_STATE_MATERIAL = 12,    // material state bundle switches
+    G4F_GFX_STATE_BRUSH = 13,       // 2D brush color
+    G4F_GFX_STATE_CLIP = 14,        // 2D clip push/pop
+    G4F_GFX_STATE_COUNT = 15,
+};
+
+typedef struct g4f_gfx_frame_stats {
+    uint64_t frameIndex;                      // frames ended before this one
+    int drawCalls;
+    uint64_t triangles;                       // 0 for the 2D renderer
+    int stateChanges[G4F_GFX_STATE_COUNT];     // binds issued
+    int redundantAvoided[G4F_GFX_STATE_COUNT]; // binds skipped because the state was already set
+    uint64_t constantBytes;                   // constant buffer updates
+    uint64_t bufferBytes;                     // vertex/index/structured buffer data
+    uint64_t textureBytes;                    // texture and bitmap data (initial contents included)
+    int resourcesCreated;                     // buffers, textures, views, states, text layouts
+} g4f_gfx_frame_stats;
+
+void g4f_gfx_frame_stats_reset(g4f_gfx_frame_stats* stats);
+int g4f_gfx_frame_stats_state_changes(const g4f_gfx_frame_stats* stats); // sum over kinds
+int g4f_gfx_frame_stats_redundant_avoided(const g4f_gfx_frame_stats* stats);
+uint64_t g4f_gfx_frame_stats_upload_bytes(const g4f_gfx_frame_stats* stats); // constant + buffer + texture
+// Adds `frame` into `sum` (totals over a run); sum->frameIndex becomes frame->frameIndex.
+void g4f_gfx_frame_stats_add(g4f_gfx_frame_stats* sum, const g4f_gfx_frame_stats* frame);
+
+// Per-frame limits; negative means unlimited.
+typedef struct g4f_gfx_frame_budget {
+    int maxDrawCalls;
+    int64_t maxTriangles;
+    int maxStateChanges;
+    int64_t maxUploadBytes;
+    int maxResourcesCreated;
+} g4f_gfx_frame_budget;
+
+g4f_gfx_frame_budget g4f_gfx_frame_budget_default(void); // everything unlimited
+// Returns 1 when `stats` fits the budget. Otherwise returns 0 and, when msg is given, writes the
+// exceeded counters ("drawCalls 812 > 500; ...") truncated to msgCap bytes.
+int g4f_gfx_frame_stats_check(const g4f_gfx_frame_stats* stats, const g4f_gfx_frame_budget* budget, char* msg, int msgCap);
+
+// Counters of the last ended frame (g4f_gfx_end / g4f_renderer_end); zeroed for null handles.
+void g4f_gfx_get_frame_stats(const g4f_gfx* gfx, g4f_gfx_frame_stats* out);
+void g4f_renderer_get_frame_stats(const g4f_renderer* renderer, g4f_gfx_frame_stats* out);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
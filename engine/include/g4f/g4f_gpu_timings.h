@@ -0,0 +1,78 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Frame/scope timer over a multi-frame ring (platform-neutral).
+// Each frame records begin/end marks for nested named scopes into one slot of a
+// G4F_GPU_TIMER_RING ring. A backend stamps the marks (D3D11 timestamp queries in g4f_gfx, or a
+// CPU clock) and resolves a slot once its data is available, several frames later on a GPU.
+// Results are never waited for: a slot whose data is still in flight when the ring wraps around
+// makes the timer skip that frame instead of stalling.
+
+#define G4F_GPU_TIMER_RING 4
+#define G4F_GPU_TIMER_MAX_SCOPES 32
+#define G4F_GPU_TIMER_MAX_MARKS (2 + 2 * G4F_GPU_TIMER_MAX_SCOPES)
+#define G4F_GPU_TIMER_NAME_MAX 32
+
+enum {
+    G4F_GPU_TIMINGS_NONE = 0, // nothing resolved yet
+    G4F_GPU_TIMINGS_GPU = 1,  // GPU timestamps
+    G4F_GPU_TIMINGS_CPU = 2,  // CPU clock around command submission (software / headless)
+};
+
+typedef struct g4f_gpu_timing_scope {
+    char name[G4F_GPU_TIMER_NAME_MAX];
+    int depth;  // 0 = top level
+    int parent; // index into scopes, -1 for top level
+    float ms;
+} g4f_gpu_timing_scope;
+
+typedef struct g4f_gpu_timings {
+    int source;            // G4F_GPU_TIMINGS_*
+    uint64_t frameIndex;   // frame the numbers belong to (lags the current frame)
+    float frameMs;         // whole frame
+    int scopeCount;        // scopes in begin order
+    int droppedScopes;     // over G4F_GPU_TIMER_MAX_SCOPES this frame
+    int skippedFrames;     // total frames not measured because the ring was full
+    int invalidFrames;     // total frames discarded by the backend (e.g. disjoint GPU clock)
+    g4f_gpu_timing_scope scopes[G4F_GPU_TIMER_MAX_SCOPES];
+} g4f_gpu_timings;
+
+typedef struct g4f_gpu_timer_backend {
+    void* user;
+    void (*frame_begin)(void* user, int slot);
+    void (*mark)(void* user, int slot, int mark); // stamp mark `mark` of `slot` now
+    void (*frame_end)(void* user, int slot);
+    // Returns 1 and fills ticks[0..markCount) and *ticksPerSecond when the slot is ready,
+    // 0 when it is still in flight, -1 when the data is unusable.
+    int (*resolve)(void* user, int slot, int markCount, uint64_t* ticks, uint64_t* ticksPerSecond);
+} g4f_gpu_timer_backend;
+
+typedef struct g4f_gpu_timer g4f_gpu_timer;
+
+// backend null: CPU clock (resolves at frame end). `source` tags the results (G4F_GPU_TIMINGS_*).
+g4f_gpu_timer* g4f_gpu_timer_create(const g4f_gpu_timer_backend* backend, int source);
+void g4f_gpu_timer_destroy(g4f_gpu_timer* timer);
+
+void g4f_gpu_timer_frame_begin(g4f_gpu_timer* timer);
+void g4f_gpu_timer_scope_begin(g4f_gpu_timer* timer, const char* name);
+void g4f_gpu_timer_scope_end(g4f_gpu_timer* timer);
+void g4f_gpu_timer_frame_end(g4f_gpu_timer* timer); // closes scopes left open
+// Latest resolved frame (source NONE until the first one). Valid until the timer is destroyed.
+const g4f_gpu_timings* g4f_gpu_timer_results(const g4f_gpu_timer* timer);
+// Milliseconds of the first scope named `name` in `timings`, or -1.
+float g4f_gpu_timings_find_ms(const g4f_gpu_timings* timings, const char* name);
+
+// gfx integration (D3D11 timestamp + disjoint queries): frames are g4f_gfx_begin..g4f_gfx_end;
+// offscreen and shadow passes get scopes automatically. Returns null for a null gfx.
+const g4f_gpu_timings* g4f_gfx_gpu_timings(const g4f_gfx* gfx);
+void g4f_gfx_gpu_scope_begin(g4f_gfx* gfx, const char* name);
+void g4f_gfx_gpu_scope_end(g4f_gfx* gfx);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Built-in PNG, TGA and QOI decoders (platform-neutral, no WIC or third-party libraries).
+// Output is straight-alpha RGBA8, the layout g4f_bitmap_create_rgba8,
+// g4f_gfx_texture_create_rgba8 and g4f_mipgen expect.
+// - PNG: every color type and bit depth (16-bit channels keep the high byte), palettes, tRNS
+//   and Adam7 interlacing. Chunk CRCs and the zlib Adler-32 are not verified; malformed data
+//   fails cleanly instead of reading or writing out of bounds.
+// - TGA: true-color (15/16/24/32-bit), grayscale (8-bit, 16-bit gray+alpha) and color-mapped,
+//   raw or RLE, any origin.
+// - QOI: 3 and 4 channel images.
+// - Images wider or taller than 32768 pixels are rejected.
+// - Decoding is reentrant; decode independent files in parallel with g4f_image_batch_load.
+
+enum {
+    G4F_IMAGE_UNKNOWN = 0,
+    G4F_IMAGE_PNG = 1,
+    G4F_IMAGE_TGA = 2,
+    G4F_IMAGE_QOI = 3,
+};
+
+// Identifies the container (PNG and QOI by signature, TGA by a header sanity check) and reads the
+// size without decoding. Returns 1 on success, 0 for unknown or malformed headers (see g4f_last_error()).
+int g4f_image_info(const void* data, size_t size, int* outFormat, int* outWidth, int* outHeight);
+
+// Decodes into dst (width * height pixels as reported by g4f_image_info). dstPitchBytes <= 0
+// means tightly packed. Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_image_decode_rgba8(const void* data, size_t size, void* dst, int dstPitchBytes);
+
+// Loads and decodes many files, one file per job (files are memory-mapped, not read).
+// Per-file failures do not fail the batch; check g4f_image_batch_pixels / g4f_image_batch_error.
+typedef struct g4f_image_batch g4f_image_batch;
+
+g4f_image_batch* g4f_image_batch_load(const char* const* pathsUtf8, int count, g4f_jobs* jobs);
+void g4f_image_batch_destroy(g4f_image_batch* batch);
+int g4f_image_batch_count(const g4f_image_batch* batch);
+// Tightly packed RGBA8 pixels owned by the batch, or null if that file failed to load.
+const uint8_t* g4f_image_batch_pixels(const g4f_image_batch* batch, int index, int* outWidth, int* outHeight);
+// Empty string for images that loaded.
+const char* g4f_image_batch_error(const g4f_image_batch* batch, int index);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Small fork/join worker pool for CPU-side engine work (texture synthesis, culling, etc.).
+// - The calling thread participates as worker 0, so a pool of N threads spawns N-1 workers.
+// - Passing a null pool to g4f_jobs_parallel_for runs the work inline on the caller.
+// - Nested parallel_for calls from inside a job run inline (no deadlock, no oversubscription).
+typedef struct g4f_jobs g4f_jobs;
+
+// Called with a half-open range [begin, end) and the index of the executing worker.
+typedef void (*g4f_jobs_range_fn)(void* user, int begin, int end, int workerIndex);
+
+int g4f_jobs_hardware_threads(void);
+
+// threadCount <= 0 uses g4f_jobs_hardware_threads().
+g4f_jobs* g4f_jobs_create(int threadCount);
+void g4f_jobs_destroy(g4f_jobs* jobs);
+int g4f_jobs_thread_count(const g4f_jobs* jobs); // includes the calling thread; 1 for null
+
+// Splits [0, count) into chunks of `grain` items (<= 0 picks a balanced size) and blocks
+// until every chunk has run. workerIndex is always < g4f_jobs_thread_count(jobs).
+void g4f_jobs_parallel_for(g4f_jobs* jobs, int count, int grain, g4f_jobs_range_fn fn, void* user);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,91 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Point/spot light list + CPU clustered light culling (platform-neutral).
+// Each frame the view frustum is split into tilesX * tilesY screen tiles and `slices` exponential
+// depth slices ("froxels"); every light is binned into the froxels its bounding sphere touches.
+// Shading then loops over one short per-froxel list instead of every light.
+//
+// Depth and tile mapping come from the projection passed to g4f_light_clusters_build, so the
+// froxels match what is rendered: depth = depthSign * z_view is the clip-space w up to scale
+// (g4f_mat4_perspective has w = +z_view, so with g4f_camera_fps_view the visible side is z_view > 0),
+// and tanHalfX/Y are read from the projection's x/y scale.
+// Froxel coordinates of a view-space point p (the shader uses the same mapping):
+//   tileX = floor((p.x / (depth * tanHalfX) * 0.5 + 0.5) * tilesX)   (tileY likewise with y)
+//   slice = floor(log(depth / nearZ) * sliceScale)
+// The binning is conservative: a light that reaches a point is always in that point's froxel list.
+
+enum {
+    G4F_LIGHT_POINT = 0,
+    G4F_LIGHT_SPOT = 1,
+};
+
+typedef struct g4f_light {
+    int type;           // G4F_LIGHT_*
+    g4f_vec3 position;  // world space
+    float radius;       // influence reaches zero here
+    g4f_vec3 direction; // spot: direction light travels (normalized)
+    float spotInnerCos; // spot: full intensity inside this cone
+    float spotOuterCos; // spot: no light outside this cone
+    uint32_t colorRgba;
+    float intensity;
+} g4f_light;
+
+typedef struct g4f_light_cluster_desc {
+    int tilesX;              // default 16
+    int tilesY;              // default 9
+    int slices;              // default 24
+    float nearZ;             // clustered depth range (need not match the projection's planes)
+    float farZ;
+    int maxLightsPerCluster; // default 128; extra lights in a froxel are dropped (see droppedCount)
+} g4f_light_cluster_desc;
+
+g4f_light_cluster_desc g4f_light_cluster_desc_default(void);
+
+typedef struct g4f_light_clusters g4f_light_clusters;
+
+g4f_light_clusters* g4f_light_clusters_create(const g4f_light_cluster_desc* desc);
+void g4f_light_clusters_destroy(g4f_light_clusters* clusters);
+// Changes the grid or depth range; takes effect on the next build.
+int g4f_light_clusters_set_desc(g4f_light_clusters* clusters, const g4f_light_cluster_desc* desc);
+
+// Bins lights for the camera matrices used for rendering (`proj` must be a perspective projection,
+// e.g. g4f_mat4_perspective or g4f_camera_fps_proj). Light transforms and per-slice binning run on
+// `jobs` (null runs inline); results are identical for any thread count.
+// Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_light_clusters_build(g4f_light_clusters* clusters, const g4f_light* lights, int lightCount, const g4f_mat4* view,
+                             const g4f_mat4* proj, g4f_jobs* jobs);
+
+typedef struct g4f_light_cluster_result {
+    const uint32_t* ranges;  // 2 per froxel: offset into indices, count
+    const uint32_t* indices; // light indices, grouped by froxel, ascending within a froxel
+    int clusterCount;        // tilesX * tilesY * slices; froxel = (slice * tilesY + tileY) * tilesX + tileX
+    int indexCount;
+    int droppedCount;        // light/froxel pairs over maxLightsPerCluster
+    int tilesX, tilesY, slices;
+    float tanHalfX, tanHalfY;
+    float depthSign;         // +1 or -1: depth = depthSign * z_view
+    float nearZ;
+    float sliceScale;        // slices / log(farZ / nearZ)
+    g4f_mat4 view;
+} g4f_light_cluster_result;
+
+// Pointers stay valid until the next build, set_desc or destroy.
+void g4f_light_clusters_get_result(const g4f_light_clusters* clusters, g4f_light_cluster_result* out);
+// Froxel index containing a view-space point (mapping of the last build), -1 outside the clustered frustum.
+int g4f_light_clusters_froxel_index(const g4f_light_clusters* clusters, g4f_vec3 viewPos);
+
+// gfx integration (implemented by the D3D11 backend): uploads lights + the last build into structured
+// buffers read by lit materials created with `clusteredLights = 1`. Pass lightCount 0 to clear.
+// `lights` must be the array the clusters were built from.
+int g4f_gfx_set_light_clusters(g4f_gfx* gfx, const g4f_light* lights, int lightCount, const g4f_light_clusters* clusters);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
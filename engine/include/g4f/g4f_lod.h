@@ -0,0 +1,99 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_camera.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Level of detail (platform-neutral; the gfx integration at the end is implemented by the D3D11 backend).
+// - Simplification: quadric-error-metric edge collapses onto existing vertices. Only the index
+//   list changes, so every level shares the source vertex buffer (normals, UVs untouched).
+//   Vertices that share a position are welded for topology; attribute seams (one position, several
+//   vertices) and, optionally, open borders stay fixed.
+// - Chain: one simplification run snapshotted at successive triangle targets, so each level's
+//   error bounds the levels before it.
+// - Selection: projected screen-space error against a pixel threshold, with a hysteresis band so
+//   instances hovering around a switch distance do not flip levels every frame.
+//
+// Errors are in mesh units: the square root of the area-weighted quadric error of the collapsed
+// vertices, i.e. an RMS distance from kept vertices to the planes of the triangles they replaced.
+
+#define G4F_LOD_MAX_LEVELS 8
+
+typedef struct g4f_lod_chain g4f_lod_chain;
+
+typedef struct g4f_lod_mesh_desc {
+    const void* positions; // xyz floats per vertex (e.g. &vertices[0].px)
+    int positionStride;    // bytes between vertices (0 = 12)
+    int vertexCount;
+    const uint32_t* indices32; // triangle list: indices32 or indices16
+    const uint16_t* indices16;
+    int indexCount;
+    int lockBorder; // 1: vertices on open borders never move (e.g. terrain tiles that must not crack)
+} g4f_lod_mesh_desc;
+
+g4f_lod_mesh_desc g4f_lod_mesh_desc_default(void);
+
+// Collapses edges until at most targetIndexCount indices remain or the next collapse would exceed
+// maxError (<= 0 = no limit). Writes the new triangle list to outIndices (capacity indexCount) and
+// the reached error to outError (may be null). Degenerate input triangles are dropped. Returns the
+// new index count, or -1 on invalid input (see g4f_last_error()).
+int g4f_lod_simplify(const g4f_lod_mesh_desc* mesh, int targetIndexCount, float maxError, uint32_t* outIndices, float* outError);
+
+typedef struct g4f_lod_chain_desc {
+    int maxLevels;     // including level 0 (0 = 6, max G4F_LOD_MAX_LEVELS)
+    float reduction;   // triangle ratio between consecutive levels (0 = 0.5)
+    float maxError;    // stop adding levels past this error (0 = 5% of the bounding radius)
+    int minTriangles;  // stop adding levels below this (0 = 8)
+} g4f_lod_chain_desc;
+
+g4f_lod_chain_desc g4f_lod_chain_desc_default(void);
+
+typedef struct g4f_lod_level {
+    int firstIndex; // into g4f_lod_chain_indices
+    int indexCount;
+    float error;    // 0 for level 0; non-decreasing along the chain
+} g4f_lod_level;
+
+// Level 0 is the source triangle list. Returns null on failure (see g4f_last_error()).
+g4f_lod_chain* g4f_lod_chain_create(const g4f_lod_mesh_desc* mesh, const g4f_lod_chain_desc* desc); // null desc = defaults
+void g4f_lod_chain_destroy(g4f_lod_chain* chain);
+int g4f_lod_chain_level_count(const g4f_lod_chain* chain);
+g4f_lod_level g4f_lod_chain_level(const g4f_lod_chain* chain, int level);
+// All levels' indices back to back (ranges from g4f_lod_chain_level).
+const uint32_t* g4f_lod_chain_indices(const g4f_lod_chain* chain, int* count);
+// Bounding sphere of the source vertices, in mesh space.
+void g4f_lod_chain_bounds(const g4f_lod_chain* chain, g4f_vec3* outCenter, float* outRadius);
+
+// ---- Selection ----
+
+typedef struct g4f_lod_view {
+    g4f_vec3 eye;
+    float pixelScale;      // pixels per unit at distance 1: viewportHeight / (2 tan(fovY / 2))
+    float thresholdPixels; // acceptable projected error (0 = 1 pixel)
+    float hysteresis;      // band around the threshold, as a fraction (0 = 0.25)
+} g4f_lod_view;
+
+g4f_lod_view g4f_lod_view_from_camera(const g4f_camera_fps* cam, int viewportHeight, float thresholdPixels);
+
+// Picks the coarsest level whose projected error stays under the threshold. Moving to a coarser
+// level needs the error under threshold * (1 - hysteresis); leaving the current level for a finer
+// one needs its error over threshold * (1 + hysteresis). currentLevel < 0 selects without
+// hysteresis. `model` (may be null) scales errors and places the bounding sphere; the distance is
+// measured to the sphere's surface.
+int g4f_lod_select(const g4f_lod_chain* chain, const g4f_lod_view* view, const g4f_mat4* model, int currentLevel);
+
+// ---- gfx integration ----
+
+// Builds the chain at creation and uploads every level into one index buffer (levels share the
+// vertex buffer). The mesh owns the chain. Plain meshes draw as a single level.
+g4f_gfx_mesh* g4f_gfx_mesh_create_lod_p3n3uv2(g4f_gfx* gfx, const g4f_gfx_vertex_p3n3uv2* vertices, int vertexCount, const uint16_t* indices, int indexCount, const g4f_lod_chain_desc* desc);
+const g4f_lod_chain* g4f_gfx_mesh_lod_chain(const g4f_gfx_mesh* mesh); // null for plain meshes
+// g4f_gfx_draw_mesh_xform with one level (clamped to the mesh's last level).
+void g4f_gfx_draw_mesh_lod(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material, const g4f_mat4* model, const g4f_mat4* mvp, int level);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
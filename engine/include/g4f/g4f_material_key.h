@@ -0,0 +1,58 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Material permutation keys (platform-neutral, no allocations).
+// A material's fixed-function state and shader permutation are packed into one normalized key;
+// the backend bakes each distinct key once into an immutable state bundle and draws compare a
+// small bundle ID instead of individual fields.
+// Normalization folds states that render identically (depth write without depth test,
+// sampler choice on untextured materials, clustered lights on unlit materials) so they share a bundle.
+
+typedef struct g4f_material_state {
+    int lit;            // 0/1
+    int textured;       // 0/1
+    int alphaTest;      // 0/1 (discard alpha < 0.5)
+    int clustered;      // 0/1: lit shading also loops over the clustered light lists (lit only)
+    int alphaBlend;     // 0/1
+    int depthTest;      // 0/1
+    int depthWrite;     // 0/1
+    int cullMode;       // 0 back, 1 none, 2 front
+    int samplerFilter;  // G4F_GFX_FILTER_*
+    int samplerAddress; // G4F_GFX_ADDRESS_*
+} g4f_material_state;
+
+// Pixel shader permutation bits; G4F_MATERIAL_SHADER_COUNT shaders cover every key.
+enum {
+    G4F_MATERIAL_SHADER_LIT = 1 << 0,
+    G4F_MATERIAL_SHADER_TEXTURED = 1 << 1,
+    G4F_MATERIAL_SHADER_ALPHA_TEST = 1 << 2,
+    G4F_MATERIAL_SHADER_CLUSTERED = 1 << 3,
+    G4F_MATERIAL_SHADER_COUNT = 16,
+};
+
+uint32_t g4f_material_key_make(const g4f_material_state* state);
+void g4f_material_key_unpack(uint32_t key, g4f_material_state* out);
+int g4f_material_key_shader(uint32_t key); // G4F_MATERIAL_SHADER_* mask
+
+// Key -> bundle ID table. IDs are dense, stable and assigned in first-seen order.
+// Capacity covers every normalized key, so lookups never fail on valid keys.
+#define G4F_MATERIAL_BUNDLE_MAX 1024
+
+typedef struct g4f_material_bundle_table {
+    uint32_t keys[G4F_MATERIAL_BUNDLE_MAX];
+    int count;
+} g4f_material_bundle_table;
+
+void g4f_material_bundle_table_reset(g4f_material_bundle_table* table);
+// Returns the bundle ID for key (adding it when new, *outAdded = 1), or -1 when full.
+int g4f_material_bundle_table_intern(g4f_material_bundle_table* table, uint32_t key, int* outAdded);
+int g4f_material_bundle_table_find(const g4f_material_bundle_table* table, uint32_t key);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
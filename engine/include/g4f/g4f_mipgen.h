@@ -0,0 +1,51 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU mip chain generation for RGBA8 images (byte order R,G,B,A).
+// - Color channels are treated as sRGB-encoded and filtered in linear space (gamma-correct);
+//   pass G4F_MIPGEN_FLAG_LINEAR for data textures (masks, normal maps). Alpha is always linear.
+// - Separable filters, 4-wide SIMD per pixel, rows spread over an optional g4f_jobs pool.
+// - Level sizes follow the D3D convention: max(1, size >> level).
+
+enum {
+    G4F_MIPGEN_FILTER_BOX = 0,    // area average (2x2 for even sizes)
+    G4F_MIPGEN_FILTER_KAISER = 1, // Kaiser-windowed sinc, sharper minification
+};
+
+enum {
+    G4F_MIPGEN_FLAG_LINEAR = 1 << 0, // color channels are linear data, skip sRGB decode/encode
+    G4F_MIPGEN_FLAG_WRAP = 1 << 1,   // filter taps wrap at the edges (tiling textures)
+};
+
+// Full chain length for a width x height image (1 for 1x1).
+int g4f_mipgen_level_count(int width, int height);
+void g4f_mipgen_level_size(int width, int height, int level, int* outWidth, int* outHeight);
+
+// Bytes needed for `levels` tightly packed RGBA8 levels starting at width x height.
+size_t g4f_mipgen_chain_bytes(int width, int height, int levels);
+
+// Resamples one RGBA8 image into another (typically the next level: dst = src / 2).
+// Pitches <= 0 mean tightly packed. Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_mipgen_downsample_rgba8(
+    const void* src, int srcWidth, int srcHeight, int srcPitchBytes,
+    void* dst, int dstWidth, int dstHeight, int dstPitchBytes,
+    int filter, int flags, g4f_jobs* jobs
+);
+
+// Writes `levels` (<= 0: full chain) tightly packed levels into outChain; level 0 is a copy of src.
+// Intermediate levels stay in linear float so quantization error does not accumulate.
+// Returns the number of levels written, 0 on failure (see g4f_last_error()).
+int g4f_mipgen_build_chain_rgba8(
+    const void* src, int width, int height, int srcPitchBytes,
+    int levels, int filter, int flags, g4f_jobs* jobs, void* outChain
+);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_collision.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Occlusion culling with a CPU software depth buffer (platform-neutral).
+// Each frame a few occluder meshes (walls, floors, large props) are rasterized at low resolution
+// into a depth buffer, which is then reduced into a hierarchical depth pyramid (each texel keeps
+// the farthest depth below it). Bounding boxes are tested against the pyramid level where their
+// screen footprint covers a handful of texels, so a test costs about the same for any box size.
+//
+// - Depth is stored as 1/w, which interpolates linearly across the screen; larger is nearer.
+// - viewProj maps world space to D3D-style clip space with w > 0 in front of the camera (as
+//   g4f_mat4_perspective, where w = +z_view, e.g. g4f_camera_fps_view * g4f_camera_fps_proj).
+// - Rasterization runs on g4f_jobs in two passes: occluder triangles are transformed, clipped
+//   and binned into screen tiles in parallel, then tiles are rasterized in parallel (each tile
+//   by one worker, 4 pixels at a time). Results do not depend on the thread count.
+// - A box is hidden only when occluders are in front of it across its whole footprint; boxes
+//   crossing the near plane are always visible.
+
+typedef struct g4f_occlusion g4f_occlusion;
+
+typedef struct g4f_occlusion_desc {
+    int width;  // depth buffer size in pixels (0 = 320; rounded up to a multiple of 8)
+    int height; // 0 = 192
+} g4f_occlusion_desc;
+
+g4f_occlusion_desc g4f_occlusion_desc_default(void);
+
+typedef struct g4f_occluder {
+    const void* positions; // xyz floats per vertex (e.g. &vertices[0].px)
+    int positionStride;    // bytes between vertices (0 = 12)
+    int vertexCount;
+    const uint32_t* indices32; // triangle list: indices32 or indices16
+    const uint16_t* indices16;
+    int indexCount;
+    const g4f_mat4* model; // mesh to world (null = identity); copied by g4f_occlusion_add
+    int twoSided;          // 0: triangles facing away are skipped (clockwise front, like gfx culling)
+} g4f_occluder;
+
+typedef struct g4f_occlusion_stats {
+    int occluders;
+    int triangles;  // occluder triangles submitted
+    int rasterized; // triangles left after back-face, off-screen and near-plane culling
+    int binned;     // triangle-tile pairs rasterized
+    int tiles;
+} g4f_occlusion_stats;
+
+g4f_occlusion* g4f_occlusion_create(const g4f_occlusion_desc* desc); // null desc = defaults
+void g4f_occlusion_destroy(g4f_occlusion* occ);
+
+// Starts a frame: forgets the previous occluders. The depth pyramid of the previous frame stays
+// usable until g4f_occlusion_end.
+void g4f_occlusion_begin(g4f_occlusion* occ, const g4f_mat4* viewProj);
+// Queues an occluder. Its vertex and index arrays are read by g4f_occlusion_end and must stay
+// valid until then. Returns 0 on invalid input (see g4f_last_error()).
+int g4f_occlusion_add(g4f_occlusion* occ, const g4f_occluder* occluder);
+// Rasterizes the queued occluders on `jobs` (null runs inline) and builds the depth pyramid.
+void g4f_occlusion_end(g4f_occlusion* occ, g4f_jobs* jobs);
+
+// 1 when any part of the box may be visible, 0 when it is hidden behind occluders or entirely
+// outside the view. `model` (null = identity) places the box in world space. Read-only; tests
+// may run concurrently, but not during g4f_occlusion_end.
+int g4f_occlusion_test_box(const g4f_occlusion* occ, const g4f_aabb* box, const g4f_mat4* model);
+// Tests `count` boxes on `jobs`, writing 1/0 to outVisible. `models` may be null (world-space
+// boxes). Returns the number of visible boxes.
+int g4f_occlusion_test_boxes(const g4f_occlusion* occ, const g4f_aabb* boxes, const g4f_mat4* models, int count, uint8_t* outVisible, g4f_jobs* jobs);
+
+// Depth buffer of the last g4f_occlusion_end (1/w, 0 where nothing was drawn), row-major, for
+// debugging views. The pointer is valid until the next g4f_occlusion_end or destroy.
+const float* g4f_occlusion_depth(const g4f_occlusion* occ, int* width, int* height);
+void g4f_occlusion_get_stats(const g4f_occlusion* occ, g4f_occlusion_stats* out);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
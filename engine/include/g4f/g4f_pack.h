@@ -0,0 +1,110 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Binary asset packs (platform-neutral file format; the gfx helpers at the end are implemented by
+// the D3D11 backend).
+// A pack is one file: a 64-byte header, a table of contents sorted by name hash, a name table,
+// then 64-byte aligned blobs. Meshes are stored as g4f_gfx_vertex_p3n3uv2 + uint16 index arrays
+// and textures as tightly packed mip chains (RGBA8 or BC blocks), i.e. exactly what the gfx
+// creation functions take.
+// - g4f_pack_open memory-maps the file and validates the header, table of contents and blob
+//   bounds. Mesh index arrays are scanned (every index must be < vertexCount, since they go
+//   straight into index buffers); other blob contents are not touched, so their pages are read
+//   on first use.
+// - Entry pointers point straight into the mapping (no copies) and stay valid until
+//   g4f_pack_close.
+// - All integers are little-endian.
+
+typedef struct g4f_pack g4f_pack;
+typedef struct g4f_pack_writer g4f_pack_writer;
+
+enum {
+    G4F_PACK_ENTRY_BLOB = 0,
+    G4F_PACK_ENTRY_MESH = 1,
+    G4F_PACK_ENTRY_TEXTURE = 2,
+};
+
+enum {
+    G4F_PACK_FORMAT_RGBA8 = 0,
+    G4F_PACK_FORMAT_BC1 = 1, // 8 bytes per 4x4 block
+    G4F_PACK_FORMAT_BC3 = 2, // 16 bytes per 4x4 block
+    G4F_PACK_FORMAT_BC7 = 3, // 16 bytes per 4x4 block
+};
+
+typedef struct g4f_pack_entry {
+    const char* name; // NUL-terminated, inside the pack
+    int type;         // G4F_PACK_ENTRY_*
+    const void* data; // whole blob
+    size_t size;
+
+    // G4F_PACK_ENTRY_MESH
+    const g4f_gfx_vertex_p3n3uv2* vertices;
+    int vertexCount;
+    const uint16_t* indices;
+    int indexCount;
+
+    // G4F_PACK_ENTRY_TEXTURE (levels follow the D3D size convention, level 0 first)
+    int format; // G4F_PACK_FORMAT_*
+    int width;
+    int height;
+    int mipLevels;
+} g4f_pack_entry;
+
+// Maps and validates a pack file. Returns null on failure (see g4f_last_error()).
+g4f_pack* g4f_pack_open(const char* pathUtf8);
+// Same for a pack already in memory (embedded resource, network buffer); the memory is borrowed
+// and must outlive the pack. Blobs are aligned relative to `data`.
+g4f_pack* g4f_pack_open_memory(const void* data, size_t size);
+void g4f_pack_close(g4f_pack* pack);
+
+int g4f_pack_entry_count(const g4f_pack* pack);
+// Index of the entry called `name`, or -1 (binary search on the name hash).
+int g4f_pack_find(const g4f_pack* pack, const char* name);
+// Returns 1 and fills *out for a valid index, 0 otherwise. Entries are ordered by name hash.
+int g4f_pack_get(const g4f_pack* pack, int index, g4f_pack_entry* out);
+
+// Bytes of a tightly packed chain of `mipLevels` levels (0 for invalid input).
+size_t g4f_pack_texture_bytes(int format, int width, int height, int mipLevels);
+// Pointer to one level of a texture entry; row pitch is per row of pixels (RGBA8) or of 4x4
+// blocks (BC). Returns null for an invalid entry or level.
+const void* g4f_pack_texture_level(const g4f_pack_entry* entry, int level, int* outWidth, int* outHeight, int* outRowPitchBytes, size_t* outBytes);
+
+// ---- writer ----
+
+// Collects entries in memory (inputs are copied) and writes the pack in one go.
+g4f_pack_writer* g4f_pack_writer_create(void);
+void g4f_pack_writer_destroy(g4f_pack_writer* writer);
+
+// Add functions return 1 on success, 0 on invalid input or a duplicate name (see g4f_last_error()).
+int g4f_pack_writer_add_blob(g4f_pack_writer* writer, const char* name, const void* data, size_t size);
+// Indices are validated against vertexCount.
+int g4f_pack_writer_add_mesh(g4f_pack_writer* writer, const char* name, const g4f_gfx_vertex_p3n3uv2* vertices, int vertexCount, const uint16_t* indices, int indexCount);
+// Builds `mipLevels` levels with g4f_mipgen (0 = full chain, 1 = no mips); mipFilter/mipFlags as
+// g4f_gfx_texture_create_rgba8_mipmapped. rowPitchBytes <= 0 means tightly packed.
+int g4f_pack_writer_add_texture_rgba8(g4f_pack_writer* writer, const char* name, int width, int height, const void* rgbaPixels, int rowPitchBytes,
+                                      int mipLevels, int mipFilter, int mipFlags, g4f_jobs* jobs);
+// Pre-built levels: g4f_pack_texture_bytes(format, width, height, mipLevels) bytes, level 0 first.
+// BC formats need width and height to be multiples of 4.
+int g4f_pack_writer_add_texture(g4f_pack_writer* writer, const char* name, int format, int width, int height, int mipLevels, const void* data, size_t size);
+
+// Writes to a temporary file next to `pathUtf8` and renames it. The output depends only on the
+// entries, not on the order they were added. Returns 1 on success, 0 on failure.
+int g4f_pack_writer_save(const g4f_pack_writer* writer, const char* pathUtf8);
+
+// ---- gfx integration ----
+
+// Create GPU resources straight from the mapped entry (no intermediate copies). Return null when
+// the entry has the wrong type or creation fails (see g4f_last_error()).
+g4f_gfx_mesh* g4f_gfx_mesh_create_from_pack(g4f_gfx* gfx, const g4f_pack_entry* entry);
+// Immutable texture with every mip level stored in the entry (RGBA8, BC1, BC3 or BC7).
+g4f_gfx_texture* g4f_gfx_texture_create_from_pack(g4f_gfx* gfx, const g4f_pack_entry* entry);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,124 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// CPU particle system (platform-neutral, headless) with an instanced billboard draw on the gfx path.
+// - A g4f_particles pool has a fixed capacity and keeps every attribute in its own array
+//   (structure of arrays), so g4f_particles_update streams through plain float columns four
+//   particles at a time: integrate (gravity, drag), age, and kill expired particles.
+// - Dead particles are removed by stream compaction: each job chunk packs its survivors to the
+//   front, then the holes below the new count are filled from the tail. Live particles stay
+//   contiguous in [0, count); their order is not preserved across updates.
+// - Emitters spawn after the simulation step; spawn slots are reserved serially, then filled in
+//   parallel. Randomness is a hash of (emitter seed, spawn serial), so results do not depend on
+//   the number of job threads.
+// - Spawns beyond the capacity are dropped (counted in g4f_particles_stats).
+
+typedef struct g4f_particles g4f_particles;
+
+typedef struct g4f_particles_desc {
+    int capacity;         // maximum live particles
+    g4f_vec3 gravity;     // acceleration, units/s^2
+    float drag;           // velocity damping per second (0 = none): v *= 1 / (1 + drag * dt)
+    float endSizeScale;   // billboard size multiplier reached at the end of life (1 = constant)
+    int fadeOut;          // nonzero: alpha fades linearly to 0 over the lifetime
+} g4f_particles_desc;
+
+// capacity 65536, gravity (0, -9.81, 0), no drag, constant size, fadeOut on.
+g4f_particles_desc g4f_particles_desc_default(void);
+
+typedef struct g4f_particle_emitter_desc {
+    g4f_vec3 position;
+    g4f_vec3 positionJitter; // half extents of the spawn box around position
+    g4f_vec3 velocity;
+    g4f_vec3 velocityJitter; // half extents of the velocity box around velocity
+    float lifeMin;           // seconds; each particle picks uniformly in [lifeMin, lifeMax]
+    float lifeMax;
+    float sizeMin;           // billboard size in world units
+    float sizeMax;
+    uint32_t rgba;           // tint (g4f_rgba_u32)
+    float rate;              // particles per second for continuous emitters (ignored by bursts)
+    uint32_t seed;
+} g4f_particle_emitter_desc;
+
+// Point emitter at the origin, 100 particles/s upwards, life 1-2 s, size 0.1, white.
+g4f_particle_emitter_desc g4f_particle_emitter_desc_default(void);
+
+g4f_particles* g4f_particles_create(const g4f_particles_desc* desc); // null desc = defaults
+void g4f_particles_destroy(g4f_particles* particles);
+void g4f_particles_clear(g4f_particles* particles); // kills every particle, keeps emitters
+int g4f_particles_capacity(const g4f_particles* particles);
+int g4f_particles_count(const g4f_particles* particles);
+
+// Continuous emitters. Returns the emitter id (>= 0), or -1 on failure; ids of removed emitters
+// are reused. Changing a desc keeps the emitter's spawn accumulator and serial.
+int g4f_particles_add_emitter(g4f_particles* particles, const g4f_particle_emitter_desc* desc);
+int g4f_particles_set_emitter(g4f_particles* particles, int emitter, const g4f_particle_emitter_desc* desc);
+void g4f_particles_remove_emitter(g4f_particles* particles, int emitter);
+
+// One-shot emission of `count` particles, spawned during the next update.
+void g4f_particles_burst(g4f_particles* particles, const g4f_particle_emitter_desc* desc, int count);
+
+// Simulates dt seconds (kill, integrate, compact), then spawns. Null jobs runs inline.
+void g4f_particles_update(g4f_particles* particles, float dt, g4f_jobs* jobs);
+
+typedef struct g4f_particles_stats {
+    int alive;   // after the last update
+    int spawned; // during the last update
+    int killed;
+    int dropped; // spawns that did not fit in the capacity
+} g4f_particles_stats;
+
+void g4f_particles_get_stats(const g4f_particles* particles, g4f_particles_stats* out);
+
+// Read-only views of the live particles, valid until the next update/clear/burst.
+typedef struct g4f_particle_streams {
+    int count;
+    const float* x;
+    const float* y;
+    const float* z;
+    const float* vx;
+    const float* vy;
+    const float* vz;
+    const float* age;  // seconds since spawn
+    const float* life; // total lifetime in seconds
+    const float* size;
+    const uint32_t* rgba;
+} g4f_particle_streams;
+
+void g4f_particles_get_streams(const g4f_particles* particles, g4f_particle_streams* out);
+
+// Per-particle billboard data (20 bytes) with size-over-life and fade applied.
+typedef struct g4f_particle_instance {
+    float x;
+    float y;
+    float z;
+    float size;
+    uint32_t rgba;
+} g4f_particle_instance;
+
+// Writes up to maxCount instances; returns the number written.
+int g4f_particles_write_instances(const g4f_particles* particles, g4f_particle_instance* out, int maxCount, g4f_jobs* jobs);
+
+// ---- gfx integration ----
+
+enum {
+    G4F_PARTICLE_BLEND_ALPHA = 0,
+    G4F_PARTICLE_BLEND_ADDITIVE = 1,
+};
+
+// Draws every live particle as a camera-facing quad in one instanced draw: depth tested against
+// the scene without writing depth, unsorted. `view`/`proj` are the camera matrices (row vectors,
+// as for g4f_gfx_draw_mesh). A null texture draws solid tinted quads. Instances are written into
+// the mapped GPU buffer on `jobs` (may be null).
+void g4f_gfx_draw_particles(g4f_gfx* gfx, const g4f_particles* particles, const g4f_gfx_texture* texture,
+                            const g4f_mat4* view, const g4f_mat4* proj, int blendMode, g4f_jobs* jobs);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
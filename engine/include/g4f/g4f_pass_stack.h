@@ -0,0 +1,43 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Render pass bookkeeping shared by the gfx backends (platform-neutral, no allocations).
+// Tracks which target is bound and its size, restores the outer target on pop, and rejects
+// misuse (unbalanced end, nesting too deep, a target rendered into while already open).
+// A null target means the backbuffer; the stack bottom is always the backbuffer.
+
+#define G4F_PASS_STACK_MAX 8
+
+typedef struct g4f_pass_state {
+    const void* target; // backend target handle, null = backbuffer
+    int width;
+    int height;
+} g4f_pass_state;
+
+typedef struct g4f_pass_stack {
+    g4f_pass_state entries[G4F_PASS_STACK_MAX];
+    int depth; // open offscreen passes
+    int backbufferW;
+    int backbufferH;
+} g4f_pass_stack;
+
+void g4f_pass_stack_reset(g4f_pass_stack* stack, int backbufferW, int backbufferH);
+// Keeps open passes; only the size reported while no pass is open changes.
+void g4f_pass_stack_set_backbuffer_size(g4f_pass_stack* stack, int backbufferW, int backbufferH);
+
+// Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_pass_stack_push(g4f_pass_stack* stack, const void* target, int width, int height);
+int g4f_pass_stack_pop(g4f_pass_stack* stack);
+
+// State of the innermost pass (the backbuffer when no pass is open).
+g4f_pass_state g4f_pass_stack_current(const g4f_pass_stack* stack);
+int g4f_pass_stack_is_open(const g4f_pass_stack* stack, const void* target);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
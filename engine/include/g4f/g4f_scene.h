@@ -0,0 +1,111 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+#include "g4f_lod.h"
+#include "g4f_occlusion.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Transform hierarchy (platform-neutral).
+// Nodes live in flat per-field arrays (local translation/rotation/scale, world matrix, parent,
+// subtree size) kept in depth-first order, so every subtree is one contiguous range and parents
+// come before their children. Setting a local transform only flags the node; g4f_scene_update
+// recomputes the world matrices of flagged subtrees and nothing else, running independent
+// subtrees in parallel. Structural edits (create/destroy/reparent) re-sort the arrays lazily on
+// the next update.
+//
+// World = local * parentWorld (row vectors), local = g4f_mat4_trs(translation, rotation, scale).
+
+// Node handle; 0 is never a valid node. Handles of destroyed nodes stay invalid (generation check;
+// a slot is retired after 1023 nodes instead of reusing a handle).
+typedef uint32_t g4f_scene_node;
+#define G4F_SCENE_NODE_NULL 0u
+
+typedef struct g4f_scene g4f_scene;
+
+// nodeCapacity pre-sizes storage (0 = grow on demand).
+g4f_scene* g4f_scene_create(int nodeCapacity);
+void g4f_scene_destroy(g4f_scene* scene);
+
+// New node with an identity local transform, under `parent` (G4F_SCENE_NODE_NULL for a root).
+// Returns G4F_SCENE_NODE_NULL on failure (see g4f_last_error()).
+g4f_scene_node g4f_scene_node_create(g4f_scene* scene, g4f_scene_node parent);
+// Destroys the node and its whole subtree.
+void g4f_scene_node_destroy(g4f_scene* scene, g4f_scene_node node);
+int g4f_scene_node_alive(const g4f_scene* scene, g4f_scene_node node);
+int g4f_scene_node_count(const g4f_scene* scene);
+
+// Moves a node (with its subtree) under `parent` (NULL = make it a root). Returns 0 for invalid
+// handles or when `parent` lies inside the node's own subtree.
+int g4f_scene_set_parent(g4f_scene* scene, g4f_scene_node node, g4f_scene_node parent);
+g4f_scene_node g4f_scene_parent(const g4f_scene* scene, g4f_scene_node node);
+
+void g4f_scene_set_local(g4f_scene* scene, g4f_scene_node node, g4f_vec3 translation, g4f_quat rotation, g4f_vec3 scale);
+void g4f_scene_set_translation(g4f_scene* scene, g4f_scene_node node, g4f_vec3 translation);
+void g4f_scene_set_rotation(g4f_scene* scene, g4f_scene_node node, g4f_quat rotation);
+void g4f_scene_set_scale(g4f_scene* scene, g4f_scene_node node, g4f_vec3 scale);
+// Any output may be null. Returns 0 for an invalid handle.
+int g4f_scene_get_local(const g4f_scene* scene, g4f_scene_node node, g4f_vec3* translation, g4f_quat* rotation, g4f_vec3* scale);
+
+// Recomputes world matrices of changed subtrees on `jobs` (null runs inline); results do not
+// depend on the thread count.
+void g4f_scene_update(g4f_scene* scene, g4f_jobs* jobs);
+// World matrix as of the last update (identity for a node created since). Null for an invalid
+// handle; the pointer is valid until the next scene call that creates, destroys, reparents or updates.
+const g4f_mat4* g4f_scene_world(const g4f_scene* scene, g4f_scene_node node);
+
+typedef struct g4f_scene_stats {
+    int nodeCount;
+    int rootCount;
+    int updatedNodes;   // world matrices recomputed by the last update
+    int updatedRanges;  // disjoint changed subtrees processed by the last update
+    int layoutRebuilds; // total re-sorts caused by structural edits
+    int occludedDraws;  // renderables dropped by occlusion culling in the last g4f_scene_build_draws
+} g4f_scene_stats;
+
+void g4f_scene_get_stats(const g4f_scene* scene, g4f_scene_stats* out);
+
+// Renderables: a node with a mesh and a material is drawn with its world matrix.
+// Pass null mesh or material to stop drawing the node.
+void g4f_scene_set_renderable(g4f_scene* scene, g4f_scene_node node, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material);
+
+// Level of detail: with a chain on the node and a view set, g4f_scene_build_draws picks each
+// draw's level through g4f_lod_select, keeping the node's previous level for hysteresis.
+// Usually the chain of the node's mesh (g4f_gfx_mesh_lod_chain). Null chain = always level 0.
+void g4f_scene_set_lod(g4f_scene* scene, g4f_scene_node node, const g4f_lod_chain* chain);
+// Null view disables selection (every draw uses level 0). Copied; set it again when the camera moves.
+void g4f_scene_set_lod_view(g4f_scene* scene, const g4f_lod_view* view);
+
+// Occlusion culling: with an occlusion buffer set, g4f_scene_build_draws drops renderables whose
+// bounds (local space, placed by the world matrix) g4f_occlusion_test_box reports hidden. Nodes
+// without bounds are always drawn. Null bounds clears them.
+void g4f_scene_set_bounds(g4f_scene* scene, g4f_scene_node node, const g4f_aabb* localBounds);
+// Not copied; rasterize it (g4f_occlusion_end) for the frame before building draws. Null disables.
+void g4f_scene_set_occlusion(g4f_scene* scene, const g4f_occlusion* occlusion);
+
+typedef struct g4f_scene_draw {
+    const g4f_gfx_mesh* mesh;
+    const g4f_gfx_material* material;
+    g4f_mat4 model;
+    g4f_mat4 mvp; // model * viewProj
+    g4f_scene_node node;
+    int lod; // level to draw (0 without a chain or view)
+} g4f_scene_draw;
+
+// Updates the scene, then fills the draw list: one entry per renderable not occlusion culled,
+// grouped by material and mesh so consecutive draws reuse bound state. Returns the draw count
+// (0 on invalid args).
+int g4f_scene_build_draws(g4f_scene* scene, const g4f_mat4* viewProj, g4f_jobs* jobs);
+// Last built draw list; valid until the next build or destroy.
+const g4f_scene_draw* g4f_scene_draws(const g4f_scene* scene, int* count);
+
+// gfx integration: builds the draw list and submits it through g4f_gfx_draw_mesh_lod.
+// Returns the number of draws submitted.
+int g4f_gfx_draw_scene(g4f_gfx* gfx, g4f_scene* scene, const g4f_mat4* viewProj, g4f_jobs* jobs);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,27 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// On-disk cache for compiled shader bytecode (platform-neutral file format, no D3D dependency).
+// - Entries are keyed by a 64-bit hash of source, entry point, profile, compiler version and flags,
+//   so any change to one of them is a miss rather than a stale hit.
+// - Files carry a header with the key, size and a checksum; truncated or corrupt files are misses.
+// - Stores write to a temporary file and rename it, so concurrent processes never see partial files.
+// A directory pre-populated at build/install time works as a shipped shader cache.
+
+uint64_t g4f_shader_cache_key(const char* source, const char* entryPoint, const char* profile, uint32_t compilerVersion, uint32_t flags);
+
+// Returns 1 on a hit (*outBytes allocated, release with g4f_shader_cache_free), 0 on a miss.
+// A miss is not an error and does not touch g4f_last_error().
+int g4f_shader_cache_load(const char* dirUtf8, uint64_t key, void** outBytes, size_t* outSize);
+// Creates the directory if needed. Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_shader_cache_store(const char* dirUtf8, uint64_t key, const void* bytes, size_t size);
+void g4f_shader_cache_free(void* bytes);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "g4f.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Sprite batching: textured, tinted, rotated 2D quads collected per frame and drawn in a few
+// indexed draws (one per texture run) instead of one draw per sprite.
+// - The batch is CPU-only (platform-neutral): it sorts, expands sprites into a vertex stream and
+//   reports texture ranges. g4f_gfx_draw_sprite_batch uploads and draws it on the gfx path.
+// - Coordinates are pixels of the current pass, origin top-left, y down. Positive rotation is
+//   clockwise on screen.
+// - G4F_SPRITE_SORT_TEXTURE orders by layer, then texture, then submission: fewest draws, but
+//   overlapping sprites on one layer with different textures may swap. G4F_SPRITE_SORT_SUBMISSION
+//   keeps submission order (painter's algorithm) and only merges consecutive same-texture sprites.
+// - Output is deterministic: texture order is first-use order within the batch, not pointer order.
+
+enum {
+    G4F_SPRITE_SORT_TEXTURE = 0,
+    G4F_SPRITE_SORT_SUBMISSION = 1,
+};
+
+typedef struct g4f_sprite {
+    float x; // pivot position in pixels
+    float y;
+    float width;
+    float height;
+    float pivotX;   // pivot inside the quad, 0..1 (0 = left/top, 0.5 = center)
+    float pivotY;
+    float rotation; // radians
+    float u0;       // texture rectangle (0,0)-(1,1) = whole texture; u0 > u1 flips
+    float v0;
+    float u1;
+    float v1;
+    uint32_t rgba;  // tint multiplied with the texture (g4f_rgba_u32)
+    int layer;      // lower layers draw first; clamped to [-32768, 32767]
+} g4f_sprite;
+
+// Axis-aligned, unrotated, untinted sprite covering the whole texture, pivot top-left.
+g4f_sprite g4f_sprite_make(float x, float y, float width, float height);
+
+// 20 bytes per vertex; 4 per sprite in the order top-left, top-right, bottom-left, bottom-right
+// (two triangles: 0,1,2 and 2,1,3).
+typedef struct g4f_sprite_vertex {
+    float x;
+    float y;
+    float u;
+    float v;
+    uint32_t rgba; // same packing as g4f_rgba_u32 (0xRRGGBBAA)
+} g4f_sprite_vertex;
+
+typedef struct g4f_sprite_range {
+    const g4f_gfx_texture* texture; // null = untextured (tint only)
+    int firstSprite;                // in the built vertex stream (vertex = sprite * 4)
+    int spriteCount;
+} g4f_sprite_range;
+
+typedef struct g4f_sprite_batch g4f_sprite_batch;
+
+g4f_sprite_batch* g4f_sprite_batch_create(int sortMode);
+void g4f_sprite_batch_destroy(g4f_sprite_batch* batch);
+void g4f_sprite_batch_set_sort_mode(g4f_sprite_batch* batch, int sortMode);
+
+// Clears the sprites (keeps allocations); call once per frame.
+void g4f_sprite_batch_clear(g4f_sprite_batch* batch);
+// Texture pointers are only compared and handed back in ranges; the CPU side never dereferences them.
+void g4f_sprite_batch_add(g4f_sprite_batch* batch, const g4f_gfx_texture* texture, const g4f_sprite* sprite);
+void g4f_sprite_batch_add_many(g4f_sprite_batch* batch, const g4f_gfx_texture* texture, const g4f_sprite* sprites, int count);
+int g4f_sprite_batch_count(const g4f_sprite_batch* batch);
+
+// Sorts and expands the sprites added since the last clear. Returns the number of ranges
+// (one draw each). Adding after a build requires another build.
+int g4f_sprite_batch_build(g4f_sprite_batch* batch);
+const g4f_sprite_vertex* g4f_sprite_batch_vertices(const g4f_sprite_batch* batch, int* outVertexCount);
+int g4f_sprite_batch_range_count(const g4f_sprite_batch* batch);
+int g4f_sprite_batch_get_range(const g4f_sprite_batch* batch, int index, g4f_sprite_range* outRange);
+
+// ---- gfx integration ----
+
+// Builds the batch if needed, uploads the vertices and draws each range with alpha blending,
+// no depth, straight-alpha textures and the given sampler filter (G4F_GFX_FILTER_*). Ranges
+// larger than 16384 sprites are split. Call between g4f_gfx_begin/end (or inside a pass).
+void g4f_gfx_draw_sprite_batch(g4f_gfx* gfx, g4f_sprite_batch* batch, int samplerFilter);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,138 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_camera.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Chunked world streaming (platform-neutral; the gfx backend at the end is implemented by the
+// D3D11 backend).
+// The world is a grid of square cells on XZ. Each g4f_stream_update looks at the cells within
+// loadRadius of the camera and, nearest first:
+// - requests missing cells from background generator threads (a bounded number in flight, so a
+//   moving camera re-prioritizes instead of working through a stale backlog; requests that fall
+//   out of range before a generator picks them up are dropped);
+// - uploads generated cells on the calling thread under a per-frame byte and count budget
+//   (at least one per frame, so oversized cells still make progress); cells generated for a
+//   spot the camera already left are discarded instead;
+// - evicts least recently used cells outside the radius while resident memory is over budget.
+//
+// The backend splits content from residency: `generate` runs on generator threads and returns
+// a CPU-side payload; `upload`, `evict` and `discard` run on the thread calling g4f_stream_update
+// (or g4f_stream_destroy) and own the GPU side. Tests can plug in a stand-in backend.
+
+typedef struct g4f_stream g4f_stream;
+
+// Generator thread: builds the cell's payload (null = failed; the update that sees the failure
+// requests the cell again). *outUploadBytes is the cost charged against the per-frame upload budget.
+typedef void* (*g4f_stream_generate_fn)(void* user, int cellX, int cellZ, size_t* outUploadBytes);
+// Calling thread: turns a payload into a resident handle and takes ownership of the payload.
+// Returns null on failure (the payload is still consumed). *outResidentBytes counts toward the cap.
+typedef void* (*g4f_stream_upload_fn)(void* user, int cellX, int cellZ, void* payload, size_t* outResidentBytes);
+// Calling thread: releases a resident handle (evict) or a payload that was never uploaded (discard).
+typedef void (*g4f_stream_release_fn)(void* user, int cellX, int cellZ, void* handle);
+
+typedef struct g4f_stream_backend {
+    g4f_stream_generate_fn generate;
+    void* generateUser;
+    g4f_stream_upload_fn upload;
+    g4f_stream_release_fn evict;
+    g4f_stream_release_fn discard;
+    void* residencyUser; // passed to upload, evict and discard
+} g4f_stream_backend;
+
+typedef struct g4f_stream_desc {
+    float cellSize;              // world units per cell edge (0 = 16)
+    int loadRadius;              // cells whose center lies within this many cells of the camera's cell (0 = 4)
+    size_t memoryBudgetBytes;    // resident bytes before out-of-range cells are evicted (0 = 256 MB)
+    size_t uploadBudgetBytes;    // upload bytes per update (0 = 4 MB)
+    int maxUploadsPerUpdate;     // 0 = no count limit
+    int generatorThreads;        // 0 = hardware threads - 1 (at least 1)
+    int maxInFlight;             // requested but not yet resident cells (0 = 4 per generator thread)
+} g4f_stream_desc;
+
+g4f_stream_desc g4f_stream_desc_default(void);
+
+typedef struct g4f_stream_stats {
+    int resident;
+    size_t residentBytes;
+    int inFlight;           // requested, generating, or generated and waiting for upload
+    int uploadsLastUpdate;
+    size_t uploadBytesLastUpdate;
+    int evictionsLastUpdate;
+    int overBudget;         // 1 when in-range cells alone exceed memoryBudgetBytes
+    long long generated;    // totals since creation
+    long long uploaded;
+    long long evicted;
+    long long discarded;    // generated payloads dropped without upload
+    long long failed;       // generate or upload returned null
+} g4f_stream_stats;
+
+typedef struct g4f_stream_cell {
+    int x;
+    int z;
+    void* handle; // resident handle from upload
+} g4f_stream_cell;
+
+// Starts the generator threads. Returns null on invalid input (see g4f_last_error()).
+g4f_stream* g4f_stream_create(const g4f_stream_desc* desc, const g4f_stream_backend* backend); // null desc = defaults
+// Waits for running generators, discards pending payloads and evicts every resident cell.
+void g4f_stream_destroy(g4f_stream* stream);
+
+// Once per frame on the thread that owns the residency side (usually the render thread).
+void g4f_stream_update(g4f_stream* stream, const g4f_camera_fps* cam);
+// Blocks until no request is queued or generating (generated payloads still wait for updates).
+// Mostly for tests, tools and loading screens.
+void g4f_stream_wait_idle(g4f_stream* stream);
+
+void g4f_stream_cell_of(const g4f_stream* stream, g4f_vec3 position, int* cellX, int* cellZ);
+// Resident handle of a cell, or null.
+void* g4f_stream_get(const g4f_stream* stream, int cellX, int cellZ);
+// Writes up to maxCells resident cells, nearest to the last update's camera first; returns the
+// number written.
+int g4f_stream_resident_cells(const g4f_stream* stream, g4f_stream_cell* out, int maxCells);
+void g4f_stream_get_stats(const g4f_stream* stream, g4f_stream_stats* out);
+
+// ---- gfx backend ----
+
+// CPU-side chunk for the gfx backend, built by the generator. g4f_stream_chunk_create allocates
+// every array in one block; the model matrix starts as identity.
+typedef struct g4f_stream_chunk {
+    g4f_gfx_vertex_p3n3uv2* vertices;
+    int vertexCount;
+    uint16_t* indices;
+    int indexCount;
+    uint8_t* rgba; // textureWidth * textureHeight RGBA8 pixels; null without a texture
+    int textureWidth;
+    int textureHeight;
+    g4f_mat4 model;
+    // With a texture the chunk gets its own material from this desc (texture field ignored).
+    g4f_gfx_material_unlit_desc material;
+    int lit;
+} g4f_stream_chunk;
+
+g4f_stream_chunk* g4f_stream_chunk_create(int vertexCount, int indexCount, int textureWidth, int textureHeight);
+void g4f_stream_chunk_destroy(g4f_stream_chunk* chunk);
+// GPU bytes the chunk will occupy (vertices, indices, texture); use as the generator's upload cost.
+size_t g4f_stream_chunk_bytes(const g4f_stream_chunk* chunk);
+
+// Resident handle of the gfx backend.
+typedef struct g4f_gfx_stream_chunk {
+    g4f_gfx_mesh* mesh;
+    g4f_gfx_texture* texture;   // null without a texture
+    g4f_gfx_material* material; // null without a texture
+    g4f_mat4 model;
+} g4f_gfx_stream_chunk;
+
+// Backend whose generator returns g4f_stream_chunk payloads: uploads create the mesh, texture and
+// material; evictions destroy them.
+g4f_stream_backend g4f_gfx_stream_backend(g4f_gfx* gfx, g4f_stream_generate_fn generate, void* generateUser);
+// Draws every resident chunk with its own material, or `material` for chunks without a texture.
+// Returns the number of draws.
+int g4f_gfx_draw_stream(g4f_gfx* gfx, const g4f_stream* stream, const g4f_gfx_material* material, const g4f_mat4* viewProj);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
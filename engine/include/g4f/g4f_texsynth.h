@@ -0,0 +1,62 @@
+#pragma once
+
+#include "g4f.h"
+#include "g4f_jobs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Procedural texture synthesis (CPU, 4-wide SIMD, parallel tiles).
+// - Generators produce a scalar field in [0,1] which is mapped through a color ramp.
+// - Output is RGBA8 (byte order R,G,B,A), ready for g4f_gfx_texture_create_rgba8,
+//   g4f_gfx_texture_update_rgba8 and g4f_bitmap_create_rgba8.
+// - Results are deterministic for a given desc/size, independent of the thread count.
+
+enum {
+    G4F_TEXSYNTH_VALUE_NOISE = 0,
+    G4F_TEXSYNTH_GRADIENT_NOISE = 1, // Perlin-style
+    G4F_TEXSYNTH_SIMPLEX_NOISE = 2,
+    G4F_TEXSYNTH_WORLEY = 3,         // F1 cell distance
+    G4F_TEXSYNTH_LINEAR_GRADIENT = 4,
+    G4F_TEXSYNTH_RADIAL_GRADIENT = 5,
+    G4F_TEXSYNTH_CHECKER = 6,
+    G4F_TEXSYNTH_GENERATOR_COUNT = 7,
+};
+
+typedef struct g4f_texsynth_ramp_stop {
+    float t;       // position in [0,1], stops must be sorted by t
+    uint32_t rgba; // 0xRRGGBBAA
+} g4f_texsynth_ramp_stop;
+
+typedef struct g4f_texsynth_desc {
+    int generator;          // G4F_TEXSYNTH_*
+    uint32_t seed;
+    float frequency;        // noise/worley/checker: cells across the texture width
+    int octaves;            // fBm octaves for noise/worley (<= 1: single octave)
+    float lacunarity;       // fBm frequency multiplier per octave
+    float gain;             // fBm amplitude multiplier per octave
+    float offsetX;          // domain offset in pixels (scrolling/animation)
+    float offsetY;
+    float x0, y0, x1, y1;   // gradients: start/end in normalized [0,1] texture space
+    const g4f_texsynth_ramp_stop* ramp; // optional; null maps 0..1 to black..white
+    int rampCount;
+} g4f_texsynth_desc;
+
+// Sensible defaults (frequency 8, 1 octave, lacunarity 2, gain 0.5, gradient left->right).
+g4f_texsynth_desc g4f_texsynth_desc_default(int generator);
+
+// Scalar field in [0,1] for pixel center (x + 0.5, y + 0.5) of a width x height texture.
+float g4f_texsynth_sample(const g4f_texsynth_desc* desc, int width, int height, int x, int y);
+
+// Writes width*height floats in [0,1]. rowPitchFloats <= 0 means tightly packed.
+// Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_texsynth_generate_r32f(const g4f_texsynth_desc* desc, g4f_jobs* jobs, int width, int height, float* out, int rowPitchFloats);
+
+// Writes RGBA8 pixels. rowPitchBytes <= 0 means width * 4. jobs may be null (single thread).
+// Returns 1 on success, 0 on failure (see g4f_last_error()).
+int g4f_texsynth_generate_rgba8(const g4f_texsynth_desc* desc, g4f_jobs* jobs, int width, int height, void* outRgba, int rowPitchBytes);
+
+#ifdef __cplusplus
+} // extern "C"
+#endif
@@ -0,0 +1,438 @@
+#include "../include/g4f/g4f_atlas.h"
+
+#include "g4f_error_internal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <numeric>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxPageSize = 16384;
+constexpr int kMaxMipLevels = 15;
+
+struct Bin {
+    int x;
+    int y;
+    int w;
+    int h;
+};
+
+// Skyline bottom-left: the top edge of the used area as horizontal segments, left to right.
+class SkylinePage {
+public:
+    SkylinePage(int w, int h) : width_(w), height_(h) { nodes_.push_back({0, 0, w, 0}); }
+
+    bool insert(int w, int h, int* outX, int* outY) {
+        int bestIndex = -1, bestBottom = height_ + 1, bestWidth = 0, bestY = 0;
+        for (size_t i = 0; i < nodes_.size(); i++) {
+            int y = 0;
+            if (!fits(i, w, h, &y)) continue;
+            // Lowest resulting bottom edge first, then the narrowest segment (less wasted skyline).
+            if (y + h < bestBottom || (y + h == bestBottom && nodes_[i].w < bestWidth)) {
+                bestIndex = (int)i;
+                bestBottom = y + h;
+                bestWidth = nodes_[i].w;
+                bestY = y;
+            }
+        }
+        if (bestIndex < 0) return false;
+        *outX = nodes_[(size_t)bestIndex].x;
+        *outY = bestY;
+        place((size_t)bestIndex, *outX, bestY + h, w);
+        return true;
+    }
+
+private:
+    // Node::y is the first free row above the segment; h is unused.
+    bool fits(size_t index, int w, int h, int* outY) const {
+        const int x = nodes_[index].x;
+        if (x + w > width_) return false;
+        int y = 0, remaining = w;
+        for (size_t i = index; remaining > 0; i++) {
+            y = std::max(y, nodes_[i].y);
+            if (y + h > height_) return false;
+            remaining -= nodes_[i].w;
+        }
+        *outY = y;
+        return true;
+    }
+
+    void place(size_t index, int x, int bottom, int w) {
+        nodes_.insert(nodes_.begin() + (std::ptrdiff_t)index, Bin{x, bottom, w, 0});
+        const int right = x + w;
+        size_t i = index + 1;
+        while (i < nodes_.size() && nodes_[i].x < right) {
+            const int end = nodes_[i].x + nodes_[i].w;
+            if (end <= right) {
+                nodes_.erase(nodes_.begin() + (std::ptrdiff_t)i);
+                continue;
+            }
+            nodes_[i].w = end - right;
+            nodes_[i].x = right;
+            break;
+        }
+        for (size_t j = 0; j + 1 < nodes_.size();) {
+            if (nodes_[j].y == nodes_[j + 1].y) {
+                nodes_[j].w += nodes_[j + 1].w;
+                nodes_.erase(nodes_.begin() + (std::ptrdiff_t)j + 1);
+            } else {
+                j++;
+            }
+        }
+    }
+
+    int width_;
+    int height_;
+    std::vector<Bin> nodes_;
+};
+
+// MaxRects with best-short-side-fit: free space as (overlapping) maximal rectangles.
+class MaxRectsPage {
+public:
+    MaxRectsPage(int w, int h) { free_.push_back({0, 0, w, h}); }
+
+    bool insert(int w, int h, int* outX, int* outY) {
+        int best = -1, bestShort = 0, bestLong = 0;
+        for (size_t i = 0; i < free_.size(); i++) {
+            const Bin& f = free_[i];
+            if (f.w < w || f.h < h) continue;
+            const int dw = f.w - w, dh = f.h - h;
+            const int shortSide = std::min(dw, dh), longSide = std::max(dw, dh);
+            if (best < 0 || shortSide < bestShort || (shortSide == bestShort && longSide < bestLong)) {
+                best = (int)i;
+                bestShort = shortSide;
+                bestLong = longSide;
+            }
+        }
+        if (best < 0) return false;
+        const Bin used{free_[(size_t)best].x, free_[(size_t)best].y, w, h};
+        *outX = used.x;
+        *outY = used.y;
+        split(used);
+        return true;
+    }
+
+private:
+    static bool contains(const Bin& a, const Bin& b) {
+        return b.x >= a.x && b.y >= a.y && b.x + b.w <= a.x + a.w && b.y + b.h <= a.y + a.h;
+    }
+
+    void split(const Bin& used) {
+        // Free rects that overlap `used` are replaced by up to four maximal remainders.
+        std::vector<Bin>& added = scratch_;
+        added.clear();
+        size_t keep = 0;
+        for (size_t i = 0; i < free_.size(); i++) {
+            const Bin f = free_[i];
+            if (used.x >= f.x + f.w || used.x + used.w <= f.x || used.y >= f.y + f.h || used.y + used.h <= f.y) {
+                free_[keep++] = f;
+                continue;
+            }
+            if (used.x > f.x) added.push_back({f.x, f.y, used.x - f.x, f.h});
+            if (used.x + used.w < f.x + f.w) added.push_back({used.x + used.w, f.y, f.x + f.w - used.x - used.w, f.h});
+            if (used.y > f.y) added.push_back({f.x, f.y, f.w, used.y - f.y});
+            if (used.y + used.h < f.y + f.h) added.push_back({f.x, used.y + used.h, f.w, f.y + f.h - used.y - used.h});
+        }
+        free_.resize(keep);
+        // Remainders are inside a former free rect, so they never contain an untouched one; only
+        // drop remainders covered by another remainder (first of identical twins wins) or an untouched rect.
+        for (size_t i = 0; i < added.size(); i++) {
+            bool redundant = false;
+            for (size_t j = 0; j < added.size() && !redundant; j++) {
+                if (i != j && contains(added[j], added[i]) && (!contains(added[i], added[j]) || j < i)) redundant = true;
+            }
+            for (size_t j = 0; j < keep && !redundant; j++) redundant = contains(free_[j], added[i]);
+            if (!redundant) free_.push_back(added[i]);
+        }
+    }
+
+    std::vector<Bin> free_;
+    std::vector<Bin> scratch_;
+};
+
+static bool resolveDesc(const g4f_atlas_desc* in, g4f_atlas_desc* out, const char* fn) {
+    *out = in ? *in : g4f_atlas_desc_default();
+    if (out->pageWidth == 0) out->pageWidth = 1024;
+    if (out->pageHeight == 0) out->pageHeight = 1024;
+    if (out->pageWidth < 0 || out->pageHeight < 0 || out->pageWidth > kMaxPageSize || out->pageHeight > kMaxPageSize) {
+        g4f_set_last_errorf("%s: page size %dx%d out of range", fn, out->pageWidth, out->pageHeight);
+        return false;
+    }
+    if (out->padding < 0 || out->gutter < 0 || out->mipLevels < 0 || out->mipLevels > kMaxMipLevels) {
+        g4f_set_last_errorf("%s: invalid padding/gutter/mipLevels", fn);
+        return false;
+    }
+    if (out->algorithm != G4F_ATLAS_SKYLINE && out->algorithm != G4F_ATLAS_MAXRECTS) {
+        g4f_set_last_errorf("%s: unknown algorithm %d", fn, out->algorithm);
+        return false;
+    }
+    return true;
+}
+
+static int alignUp(int v, int a) {
+    return (v + a - 1) / a * a;
+}
+
+template <typename Page>
+static int packInto(const g4f_atlas_desc& d, const int* sizes, int count, g4f_atlas_rect* out) {
+    const int align = d.mipLevels > 1 ? 1 << (d.mipLevels - 1) : 1;
+    // Slots carry their padding on the right/bottom; bins are one padding larger than the page so
+    // the last slot's padding may hang off the edge while its gutter still ends inside the page.
+    const int binW = d.pageWidth + d.padding, binH = d.pageHeight + d.padding;
+    const int border = d.gutter * 2 + d.padding;
+
+    std::vector<int> order((size_t)count);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&](int a, int b) {
+        const int aw = sizes[a * 2], ah = sizes[a * 2 + 1], bw = sizes[b * 2], bh = sizes[b * 2 + 1];
+        // Skyline wants height-sorted input (rows of similar height); maxrects does best with the longest side.
+        const int aKey = d.algorithm == G4F_ATLAS_SKYLINE ? ah : std::max(aw, ah);
+        const int bKey = d.algorithm == G4F_ATLAS_SKYLINE ? bh : std::max(bw, bh);
+        if (aKey != bKey) return aKey > bKey;
+        return aw * ah > bw * bh;
+    });
+
+    std::vector<Page> pages;
+    // Free space only shrinks, so a slot at least as large as one that already failed on a page
+    // fails there again; skipping those keeps full pages from being rescanned.
+    std::vector<Bin> lastFailure;
+    bool allPlaced = true;
+    for (int index : order) {
+        g4f_atlas_rect& r = out[index];
+        r.width = sizes[index * 2];
+        r.height = sizes[index * 2 + 1];
+        r.page = -1;
+        r.x = r.y = 0;
+        const int slotW = alignUp(r.width + border, align), slotH = alignUp(r.height + border, align);
+        if (r.width <= 0 || r.height <= 0 || slotW > binW || slotH > binH) {
+            allPlaced = false;
+            continue;
+        }
+        int x = 0, y = 0;
+        for (size_t p = 0; p < pages.size() && r.page < 0; p++) {
+            if (slotW >= lastFailure[p].w && slotH >= lastFailure[p].h) continue;
+            if (pages[p].insert(slotW, slotH, &x, &y)) r.page = (int)p;
+            else lastFailure[p] = Bin{0, 0, slotW, slotH};
+        }
+        if (r.page < 0) {
+            pages.emplace_back(binW, binH);
+            lastFailure.push_back(Bin{0, 0, binW + 1, binH + 1});
+            if (!pages.back().insert(slotW, slotH, &x, &y)) {
+                pages.pop_back();
+                allPlaced = false;
+                continue;
+            }
+            r.page = (int)pages.size() - 1;
+        }
+        r.x = x + d.gutter;
+        r.y = y + d.gutter;
+    }
+    return allPlaced ? (int)pages.size() : -1;
+}
+
+static int packRects(const g4f_atlas_desc& d, const int* sizes, int count, g4f_atlas_rect* out) {
+    return d.algorithm == G4F_ATLAS_MAXRECTS ? packInto<MaxRectsPage>(d, sizes, count, out) : packInto<SkylinePage>(d, sizes, count, out);
+}
+
+struct Image {
+    int width;
+    int height;
+    size_t offset; // into g4f_atlas::pixels
+};
+
+} // namespace
+
+struct g4f_atlas {
+    g4f_atlas_desc desc{};
+    std::vector<Image> images;
+    std::vector<uint8_t> pixels;
+    std::vector<g4f_atlas_rect> rects;
+    std::vector<std::vector<uint8_t>> pages;
+    bool built = false;
+};
+
+namespace {
+
+struct ComposeJob {
+    g4f_atlas* atlas;
+};
+
+// Copies one image and extrudes its edge texels into the gutter. Slots never overlap, so images
+// can be composed in parallel.
+static void composeImages(void* user, int begin, int end, int) {
+    g4f_atlas* a = ((ComposeJob*)user)->atlas;
+    const int g = a->desc.gutter;
+    const size_t pitch = (size_t)a->desc.pageWidth * 4;
+    for (int i = begin; i < end; i++) {
+        const Image& img = a->images[(size_t)i];
+        const g4f_atlas_rect& r = a->rects[(size_t)i];
+        uint8_t* page = a->pages[(size_t)r.page].data();
+        const uint8_t* src = a->pixels.data() + img.offset;
+        const size_t rowBytes = (size_t)img.width * 4;
+        for (int y = 0; y < img.height; y++) {
+            uint8_t* row = page + (size_t)(r.y + y) * pitch + (size_t)r.x * 4;
+            const uint8_t* s = src + (size_t)y * rowBytes;
+            std::memcpy(row, s, rowBytes);
+            for (int k = 1; k <= g; k++) {
+                std::memcpy(row - (size_t)k * 4, s, 4);
+                std::memcpy(row + rowBytes + (size_t)(k - 1) * 4, s + rowBytes - 4, 4);
+            }
+        }
+        if (g) {
+            const size_t spanBytes = rowBytes + (size_t)g * 8;
+            uint8_t* first = page + (size_t)r.y * pitch + (size_t)(r.x - g) * 4;
+            uint8_t* last = first + (size_t)(img.height - 1) * pitch;
+            for (int k = 1; k <= g; k++) {
+                std::memcpy(first - (size_t)k * pitch, first, spanBytes);
+                std::memcpy(last + (size_t)k * pitch, last, spanBytes);
+            }
+        }
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+g4f_atlas_desc g4f_atlas_desc_default(void) {
+    g4f_atlas_desc d{};
+    d.pageWidth = 1024;
+    d.pageHeight = 1024;
+    d.padding = 1;
+    d.gutter = 0;
+    d.mipLevels = 0;
+    d.algorithm = G4F_ATLAS_SKYLINE;
+    return d;
+}
+
+int g4f_atlas_pack_rects(const g4f_atlas_desc* desc, const int* sizes, int count, g4f_atlas_rect* outRects) {
+    g4f_atlas_desc d{};
+    if (!resolveDesc(desc, &d, "g4f_atlas_pack_rects")) return -1;
+    if (count < 0 || (count > 0 && (!sizes || !outRects))) {
+        g4f_set_last_error("g4f_atlas_pack_rects: invalid args");
+        return -1;
+    }
+    const int pages = packRects(d, sizes, count, outRects);
+    if (pages < 0) g4f_set_last_error("g4f_atlas_pack_rects: a rectangle does not fit on a page");
+    return pages;
+}
+
+g4f_atlas* g4f_atlas_create(const g4f_atlas_desc* desc) {
+    g4f_atlas_desc d{};
+    if (!resolveDesc(desc, &d, "g4f_atlas_create")) return nullptr;
+    auto* atlas = new g4f_atlas();
+    atlas->desc = d;
+    return atlas;
+}
+
+void g4f_atlas_destroy(g4f_atlas* atlas) {
+    delete atlas;
+}
+
+int g4f_atlas_add_rgba8(g4f_atlas* atlas, int width, int height, const void* rgbaPixels, int pitchBytes) {
+    if (!atlas || !rgbaPixels || width <= 0 || height <= 0) {
+        g4f_set_last_error("g4f_atlas_add_rgba8: invalid args");
+        return -1;
+    }
+    if (width > atlas->desc.pageWidth || height > atlas->desc.pageHeight) {
+        g4f_set_last_errorf("g4f_atlas_add_rgba8: %dx%d image is larger than the %dx%d page", width, height, atlas->desc.pageWidth,
+                            atlas->desc.pageHeight);
+        return -1;
+    }
+    const size_t rowBytes = (size_t)width * 4;
+    const size_t pitch = pitchBytes > 0 ? (size_t)pitchBytes : rowBytes;
+    if (pitch < rowBytes) {
+        g4f_set_last_error("g4f_atlas_add_rgba8: pitch smaller than a row");
+        return -1;
+    }
+    Image img{width, height, atlas->pixels.size()};
+    atlas->pixels.resize(img.offset + rowBytes * (size_t)height);
+    const uint8_t* src = (const uint8_t*)rgbaPixels;
+    for (int y = 0; y < height; y++) std::memcpy(atlas->pixels.data() + img.offset + rowBytes * (size_t)y, src + pitch * (size_t)y, rowBytes);
+    atlas->images.push_back(img);
+    atlas->built = false;
+    return (int)atlas->images.size() - 1;
+}
+
+int g4f_atlas_image_count(const g4f_atlas* atlas) {
+    return atlas ? (int)atlas->images.size() : 0;
+}
+
+int g4f_atlas_build(g4f_atlas* atlas, g4f_jobs* jobs) {
+    if (!atlas) {
+        g4f_set_last_error("g4f_atlas_build: invalid args");
+        return 0;
+    }
+    atlas->built = false;
+    const int count = (int)atlas->images.size();
+    std::vector<int> sizes((size_t)count * 2);
+    for (int i = 0; i < count; i++) {
+        sizes[(size_t)i * 2] = atlas->images[(size_t)i].width;
+        sizes[(size_t)i * 2 + 1] = atlas->images[(size_t)i].height;
+    }
+    atlas->rects.resize((size_t)count);
+    const int pages = packRects(atlas->desc, sizes.data(), count, atlas->rects.data());
+    if (pages < 0) {
+        // add_rgba8 rejects images larger than a page, so only gutter/padding/alignment can overflow.
+        g4f_set_last_error("g4f_atlas_build: an image plus its gutter, padding and alignment does not fit on a page");
+        return 0;
+    }
+    const size_t pageBytes = (size_t)atlas->desc.pageWidth * (size_t)atlas->desc.pageHeight * 4;
+    // Rebuilds reuse the page allocations.
+    atlas->pages.resize((size_t)pages);
+    for (std::vector<uint8_t>& page : atlas->pages) page.assign(pageBytes, 0);
+    ComposeJob job{atlas};
+    g4f_jobs_parallel_for(jobs, count, 16, composeImages, &job);
+    atlas->built = true;
+    return pages;
+}
+
+int g4f_atlas_get_region(const g4f_atlas* atlas, int index, g4f_atlas_region* outRegion) {
+    if (!atlas || !outRegion || !atlas->built || index < 0 || index >= (int)atlas->rects.size()) return 0;
+    const g4f_atlas_rect& r = atlas->rects[(size_t)index];
+    const float invW = 1.0f / (float)atlas->desc.pageWidth, invH = 1.0f / (float)atlas->desc.pageHeight;
+    outRegion->page = r.page;
+    outRegion->x = r.x;
+    outRegion->y = r.y;
+    outRegion->width = r.width;
+    outRegion->height = r.height;
+    outRegion->u0 = (float)r.x * invW;
+    outRegion->v0 = (float)r.y * invH;
+    outRegion->u1 = (float)(r.x + r.width) * invW;
+    outRegion->v1 = (float)(r.y + r.height) * invH;
+    return 1;
+}
+
+int g4f_atlas_page_count(const g4f_atlas* atlas) {
+    return atlas && atlas->built ? (int)atlas->pages.size() : 0;
+}
+
+const uint8_t* g4f_atlas_page_pixels(const g4f_atlas* atlas, int page, int* outWidth, int* outHeight) {
+    if (outWidth) *outWidth = 0;
+    if (outHeight) *outHeight = 0;
+    if (!atlas || !atlas->built || page < 0 || page >= (int)atlas->pages.size()) return nullptr;
+    if (outWidth) *outWidth = atlas->desc.pageWidth;
+    if (outHeight) *outHeight = atlas->desc.pageHeight;
+    return atlas->pages[(size_t)page].data();
+}
+
+void g4f_atlas_get_stats(const g4f_atlas* atlas, g4f_atlas_stats* outStats) {
+    if (!outStats) return;
+    *outStats = g4f_atlas_stats{};
+    if (!atlas || !atlas->built) return;
+    const g4f_atlas_desc& d = atlas->desc;
+    std::vector<int> lowest(atlas->pages.size(), 0);
+    for (const g4f_atlas_rect& r : atlas->rects) {
+        outStats->imageTexels += (long long)r.width * r.height;
+        lowest[(size_t)r.page] = std::max(lowest[(size_t)r.page], std::min(d.pageHeight, r.y + r.height + d.gutter));
+    }
+    outStats->pages = (int)atlas->pages.size();
+    outStats->pageTexels = (long long)outStats->pages * d.pageWidth * d.pageHeight;
+    for (int rows : lowest) outStats->usedTexels += (long long)rows * d.pageWidth;
+    if (outStats->pageTexels) outStats->efficiency = (float)((double)outStats->imageTexels / (double)outStats->pageTexels);
+    if (outStats->usedTexels) outStats->usedEfficiency = (float)((double)outStats->imageTexels / (double)outStats->usedTexels);
+}
+
+} // extern "C"
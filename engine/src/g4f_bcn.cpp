@@ -0,0 +1,988 @@
+#include "../include/g4f/g4f_bcn.h"
+#include "../include/g4f/g4f_mipgen.h"
+#include "../include/g4f/g4f_pack.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+using namespace g4f::simd;
+
+static_assert((int)G4F_BCN_BC1 == (int)G4F_PACK_FORMAT_BC1 && (int)G4F_BCN_BC3 == (int)G4F_PACK_FORMAT_BC3 && (int)G4F_BCN_BC7 == (int)G4F_PACK_FORMAT_BC7,
+              "BC format values are shared with g4f_pack");
+
+namespace {
+
+// ---- BC7 tables (D3D11 / BPTC specification) ----
+
+// Two subsets: bit i is the subset of pixel i (pixels in row-major order).
+constexpr uint16_t kPartition2[64] = {
+    0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+    0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+    0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+    0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+// Three subsets: bits 2i..2i+1 are the subset of pixel i.
+constexpr uint32_t kPartition3[64] = {
+    0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+    0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+    0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+    0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+    0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+    0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+    0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+    0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+// Anchor pixels (their index loses its top bit); subset 0 is always anchored at pixel 0.
+constexpr uint8_t kAnchor2[64] = {
+    15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+    15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6, 6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+constexpr uint8_t kAnchor3a[64] = {
+    3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3, 3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+    8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15, 3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+};
+constexpr uint8_t kAnchor3b[64] = {
+    15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8, 15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+    15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8, 15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+};
+
+constexpr int kWeights2[4] = {0, 21, 43, 64};
+constexpr int kWeights3[8] = {0, 9, 18, 27, 37, 46, 55, 64};
+constexpr int kWeights4[16] = {0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64};
+
+struct Bc7Mode {
+    int subsets;
+    int partitionBits;
+    int rotationBits;
+    int indexSelectionBits;
+    int colorBits;
+    int alphaBits;     // 0: alpha is 255
+    int endpointPBits; // one p-bit per endpoint
+    int sharedPBits;   // one p-bit per subset
+    int indexBits;
+    int indexBits2;    // separate alpha indices (modes 4 and 5)
+};
+
+constexpr Bc7Mode kBc7Modes[8] = {
+    {3, 4, 0, 0, 4, 0, 1, 0, 3, 0},
+    {2, 6, 0, 0, 6, 0, 0, 1, 3, 0},
+    {3, 6, 0, 0, 5, 0, 0, 0, 2, 0},
+    {2, 6, 0, 0, 7, 0, 1, 0, 2, 0},
+    {1, 0, 2, 1, 5, 6, 0, 0, 2, 3},
+    {1, 0, 2, 0, 7, 8, 0, 0, 2, 2},
+    {1, 0, 0, 0, 7, 7, 1, 0, 4, 0},
+    {2, 6, 0, 0, 5, 5, 1, 0, 2, 0},
+};
+
+// Block fields shared by the packer and the unpacker; endpoints are stored without p-bits.
+struct Bc7Block {
+    int mode = 0;
+    int partition = 0;
+    int rotation = 0;
+    int indexSelection = 0;
+    int endpoints[3][2][4] = {}; // [subset][endpoint][channel]
+    int pbits[3][2] = {};
+    uint8_t indices[16] = {};
+    uint8_t indices2[16] = {};
+};
+
+static const int* bc7Weights(int indexBits) { return indexBits == 2 ? kWeights2 : (indexBits == 3 ? kWeights3 : kWeights4); }
+
+static int bc7Subset(int subsets, int partition, int pixel) {
+    if (subsets == 2) return (kPartition2[partition] >> pixel) & 1;
+    if (subsets == 3) return (int)(kPartition3[partition] >> (pixel * 2)) & 3;
+    return 0;
+}
+
+static int bc7Anchor(int subsets, int partition, int subset) {
+    if (subset == 0) return 0;
+    if (subsets == 2) return kAnchor2[partition];
+    return subset == 1 ? kAnchor3a[partition] : kAnchor3b[partition];
+}
+
+static bool bc7IsAnchor(int subsets, int partition, int pixel) {
+    for (int s = 0; s < subsets; s++) {
+        if (bc7Anchor(subsets, partition, s) == pixel) return true;
+    }
+    return false;
+}
+
+static int bc7Expand(int value, int bits) {
+    value <<= 8 - bits;
+    return value | (value >> bits);
+}
+
+struct BitWriter {
+    uint8_t* out;
+    int pos = 0;
+    void put(uint32_t value, int bits) {
+        for (int i = 0; i < bits; i++, pos++) out[pos >> 3] |= (uint8_t)(((value >> i) & 1u) << (pos & 7));
+    }
+};
+
+struct BitReader {
+    const uint8_t* in;
+    int pos = 0;
+    int get(int bits) {
+        int value = 0;
+        for (int i = 0; i < bits; i++, pos++) value |= ((in[pos >> 3] >> (pos & 7)) & 1) << i;
+        return value;
+    }
+};
+
+static void bc7Pack(const Bc7Block& b, uint8_t out[16]) {
+    const Bc7Mode& m = kBc7Modes[b.mode];
+    std::memset(out, 0, 16);
+    BitWriter w{out};
+    w.put(1u << b.mode, b.mode + 1);
+    w.put((uint32_t)b.partition, m.partitionBits);
+    w.put((uint32_t)b.rotation, m.rotationBits);
+    w.put((uint32_t)b.indexSelection, m.indexSelectionBits);
+    for (int c = 0; c < 4; c++) {
+        for (int s = 0; s < m.subsets; s++) {
+            for (int e = 0; e < 2; e++) w.put((uint32_t)b.endpoints[s][e][c], c < 3 ? m.colorBits : m.alphaBits);
+        }
+    }
+    for (int s = 0; s < m.subsets; s++) {
+        if (m.endpointPBits) {
+            w.put((uint32_t)b.pbits[s][0], 1);
+            w.put((uint32_t)b.pbits[s][1], 1);
+        }
+        if (m.sharedPBits) w.put((uint32_t)b.pbits[s][0], 1);
+    }
+    for (int i = 0; i < 16; i++) w.put(b.indices[i], m.indexBits - (bc7IsAnchor(m.subsets, b.partition, i) ? 1 : 0));
+    if (m.indexBits2) {
+        for (int i = 0; i < 16; i++) w.put(b.indices2[i], m.indexBits2 - (i == 0 ? 1 : 0));
+    }
+}
+
+// Returns false for the reserved mode (first byte 0).
+static bool bc7Unpack(const uint8_t in[16], Bc7Block& b) {
+    if (in[0] == 0) return false;
+    b.mode = 0;
+    while (!((in[0] >> b.mode) & 1)) b.mode++;
+    const Bc7Mode& m = kBc7Modes[b.mode];
+    BitReader r{in, b.mode + 1};
+    b.partition = r.get(m.partitionBits);
+    b.rotation = r.get(m.rotationBits);
+    b.indexSelection = r.get(m.indexSelectionBits);
+    for (int c = 0; c < 4; c++) {
+        for (int s = 0; s < m.subsets; s++) {
+            for (int e = 0; e < 2; e++) b.endpoints[s][e][c] = r.get(c < 3 ? m.colorBits : m.alphaBits);
+        }
+    }
+    for (int s = 0; s < m.subsets; s++) {
+        if (m.endpointPBits) {
+            b.pbits[s][0] = r.get(1);
+            b.pbits[s][1] = r.get(1);
+        }
+        if (m.sharedPBits) b.pbits[s][0] = b.pbits[s][1] = r.get(1);
+    }
+    for (int i = 0; i < 16; i++) b.indices[i] = (uint8_t)r.get(m.indexBits - (bc7IsAnchor(m.subsets, b.partition, i) ? 1 : 0));
+    if (m.indexBits2) {
+        for (int i = 0; i < 16; i++) b.indices2[i] = (uint8_t)r.get(m.indexBits2 - (i == 0 ? 1 : 0));
+    }
+    return true;
+}
+
+// 8-bit endpoint value of a stored field (p-bit appended when the mode has one).
+static int bc7EndpointValue(const Bc7Mode& m, int stored, int pbit, int channel) {
+    int bits = channel < 3 ? m.colorBits : m.alphaBits;
+    if (bits == 0) return 255;
+    if (m.endpointPBits || m.sharedPBits) {
+        stored = (stored << 1) | pbit;
+        bits++;
+    }
+    return bc7Expand(stored, bits);
+}
+
+static int bc7Interpolate(int e0, int e1, int weight) { return ((64 - weight) * e0 + weight * e1 + 32) >> 6; }
+
+static void bc7Decode(const uint8_t in[16], uint8_t out[16][4]) {
+    Bc7Block b;
+    if (!bc7Unpack(in, b)) {
+        std::memset(out, 0, 64);
+        return;
+    }
+    const Bc7Mode& m = kBc7Modes[b.mode];
+    int ends[3][2][4];
+    for (int s = 0; s < m.subsets; s++) {
+        for (int e = 0; e < 2; e++) {
+            for (int c = 0; c < 4; c++) ends[s][e][c] = bc7EndpointValue(m, b.endpoints[s][e][c], b.pbits[s][e], c);
+        }
+    }
+    for (int i = 0; i < 16; i++) {
+        const int s = bc7Subset(m.subsets, b.partition, i);
+        int colorBits = m.indexBits, alphaBits = m.indexBits2 ? m.indexBits2 : m.indexBits;
+        int colorIndex = b.indices[i], alphaIndex = m.indexBits2 ? b.indices2[i] : b.indices[i];
+        if (b.indexSelection) {
+            std::swap(colorBits, alphaBits);
+            std::swap(colorIndex, alphaIndex);
+        }
+        for (int c = 0; c < 3; c++) out[i][c] = (uint8_t)bc7Interpolate(ends[s][0][c], ends[s][1][c], bc7Weights(colorBits)[colorIndex]);
+        out[i][3] = (uint8_t)bc7Interpolate(ends[s][0][3], ends[s][1][3], bc7Weights(alphaBits)[alphaIndex]);
+        if (b.rotation) std::swap(out[i][b.rotation - 1], out[i][3]);
+    }
+}
+
+// ---- BC1 / BC3 ----
+
+static void rgb565(uint16_t c, int out[3]) {
+    const int r = (c >> 11) & 31, g = (c >> 5) & 63, b = c & 31;
+    out[0] = (r << 3) | (r >> 2);
+    out[1] = (g << 2) | (g >> 4);
+    out[2] = (b << 3) | (b >> 2);
+}
+
+// BC1 palette: four colors when c0 > c1 (always in BC3), otherwise three plus transparent black.
+static void bc1Palette(uint16_t c0, uint16_t c1, bool alwaysFourColors, int pal[4][4]) {
+    int a[3], b[3];
+    rgb565(c0, a);
+    rgb565(c1, b);
+    const bool four = alwaysFourColors || c0 > c1;
+    for (int c = 0; c < 3; c++) {
+        pal[0][c] = a[c];
+        pal[1][c] = b[c];
+        pal[2][c] = four ? (2 * a[c] + b[c] + 1) / 3 : (a[c] + b[c] + 1) / 2;
+        pal[3][c] = four ? (a[c] + 2 * b[c] + 1) / 3 : 0;
+    }
+    pal[0][3] = pal[1][3] = pal[2][3] = 255;
+    pal[3][3] = four ? 255 : 0;
+}
+
+static void bc3AlphaPalette(int a0, int a1, int pal[8]) {
+    pal[0] = a0;
+    pal[1] = a1;
+    if (a0 > a1) {
+        for (int i = 1; i < 7; i++) pal[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+    } else {
+        for (int i = 1; i < 5; i++) pal[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+        pal[6] = 0;
+        pal[7] = 255;
+    }
+}
+
+static void decodeColorBlock(const uint8_t in[8], bool bc1, uint8_t out[16][4]) {
+    int pal[4][4];
+    bc1Palette((uint16_t)(in[0] | (in[1] << 8)), (uint16_t)(in[2] | (in[3] << 8)), !bc1, pal);
+    const uint32_t bits = (uint32_t)in[4] | ((uint32_t)in[5] << 8) | ((uint32_t)in[6] << 16) | ((uint32_t)in[7] << 24);
+    for (int i = 0; i < 16; i++) {
+        const int* p = pal[(bits >> (i * 2)) & 3];
+        for (int c = 0; c < (bc1 ? 4 : 3); c++) out[i][c] = (uint8_t)p[c];
+    }
+}
+
+static void decodeAlphaBlock(const uint8_t in[8], uint8_t out[16][4]) {
+    int pal[8];
+    bc3AlphaPalette(in[0], in[1], pal);
+    uint64_t bits = 0;
+    for (int i = 0; i < 6; i++) bits |= (uint64_t)in[2 + i] << (8 * i);
+    for (int i = 0; i < 16; i++) out[i][3] = (uint8_t)pal[(bits >> (i * 3)) & 7];
+}
+
+// ---- encoder ----
+
+// One 4x4 block, channel-major so four pixels of a channel load as one F4.
+struct Block {
+    float ch[4][16]; // R, G, B, A as 0..255
+    uint8_t px[16][4];
+    bool opaque;     // every alpha is 255
+};
+
+static void loadBlock(const uint8_t* src, int pitch, int width, int height, int bx, int by, Block& b) {
+    b.opaque = true;
+    for (int y = 0; y < 4; y++) {
+        const int sy = std::min(by * 4 + y, height - 1);
+        for (int x = 0; x < 4; x++) {
+            const int sx = std::min(bx * 4 + x, width - 1);
+            const uint8_t* p = src + (size_t)sy * (size_t)pitch + (size_t)sx * 4;
+            const int i = y * 4 + x;
+            for (int c = 0; c < 4; c++) {
+                b.px[i][c] = p[c];
+                b.ch[c][i] = (float)p[c];
+            }
+            if (p[3] != 255) b.opaque = false;
+        }
+    }
+}
+
+// Nearest palette entry over channels [c0, c1) for all 16 pixels, four at a time.
+// Returns the squared error summed over the pixels in `mask`.
+static float selectIndices(const Block& b, uint32_t mask, int c0, int c1, const float (*pal)[4], int palCount, uint8_t idx[16]) {
+    float err = 0.0f;
+    for (int g = 0; g < 4; g++) {
+        F4 px[4];
+        for (int c = c0; c < c1; c++) px[c] = f4Load(b.ch[c] + g * 4);
+        F4 best = f4Set1(1e30f), bestIndex = f4Set1(0.0f);
+        for (int k = 0; k < palCount; k++) {
+            F4 d = f4Set1(0.0f);
+            for (int c = c0; c < c1; c++) {
+                const F4 diff = px[c] - f4Set1(pal[k][c]);
+                d = f4MulAdd(diff, diff, d);
+            }
+            const F4 closer = f4Lt(d, best);
+            best = f4Select(closer, d, best);
+            bestIndex = f4Select(closer, f4Set1((float)k), bestIndex);
+        }
+        float e[4], ix[4];
+        f4Store(e, best);
+        f4Store(ix, bestIndex);
+        for (int i = 0; i < 4; i++) {
+            idx[g * 4 + i] = (uint8_t)ix[i];
+            if ((mask >> (g * 4 + i)) & 1) err += e[i];
+        }
+    }
+    return err;
+}
+
+// Mean and covariance of the pixels in `mask` over channels [c0, c1).
+static int covariance(const Block& b, uint32_t mask, int c0, int c1, float mean[4], float cov[4][4]) {
+    int n = 0;
+    for (int c = 0; c < 4; c++) {
+        mean[c] = 0.0f;
+        for (int k = 0; k < 4; k++) cov[c][k] = 0.0f;
+    }
+    for (int i = 0; i < 16; i++) {
+        if (!((mask >> i) & 1)) continue;
+        for (int c = c0; c < c1; c++) mean[c] += b.ch[c][i];
+        n++;
+    }
+    if (n == 0) return 0;
+    for (int c = c0; c < c1; c++) mean[c] /= (float)n;
+    for (int i = 0; i < 16; i++) {
+        if (!((mask >> i) & 1)) continue;
+        float d[4];
+        for (int c = c0; c < c1; c++) d[c] = b.ch[c][i] - mean[c];
+        for (int r = c0; r < c1; r++) {
+            for (int c = r; c < c1; c++) cov[r][c] += d[r] * d[c];
+        }
+    }
+    for (int r = c0; r < c1; r++) {
+        for (int c = c0; c < r; c++) cov[r][c] = cov[c][r];
+    }
+    return n;
+}
+
+// Unit principal axis by power iteration, seeded with the covariance row of the largest variance
+// (never orthogonal to the answer, unlike a fixed seed). Returns the variance along the axis.
+static float principalAxis(const float cov[4][4], int c0, int c1, int iterations, float axis[4]) {
+    int seed = c0;
+    for (int c = c0; c < c1; c++) {
+        axis[c] = 0.0f;
+        if (cov[c][c] > cov[seed][seed]) seed = c;
+    }
+    for (int c = c0; c < c1; c++) axis[c] = cov[seed][c];
+    for (int it = 0; it < iterations; it++) {
+        float next[4] = {}, top = 0.0f;
+        for (int r = c0; r < c1; r++) {
+            for (int c = c0; c < c1; c++) next[r] += cov[r][c] * axis[c];
+            top = std::max(top, std::fabs(next[r]));
+        }
+        if (top <= 1e-12f) break;
+        for (int c = c0; c < c1; c++) axis[c] = next[c] / top;
+    }
+    float len = 0.0f;
+    for (int c = c0; c < c1; c++) len += axis[c] * axis[c];
+    if (len <= 1e-12f) {
+        for (int c = c0; c < c1; c++) axis[c] = 0.0f;
+        return 0.0f;
+    }
+    len = 1.0f / std::sqrt(len);
+    float variance = 0.0f;
+    for (int c = c0; c < c1; c++) axis[c] *= len;
+    for (int r = c0; r < c1; r++) {
+        for (int c = c0; c < c1; c++) variance += axis[r] * cov[r][c] * axis[c];
+    }
+    return variance;
+}
+
+// Endpoints at the extreme projections of the pixels in `mask` on their principal axis.
+static void fitLine(const Block& b, uint32_t mask, int c0, int c1, float e0[4], float e1[4]) {
+    float mean[4], cov[4][4], axis[4];
+    covariance(b, mask, c0, c1, mean, cov);
+    principalAxis(cov, c0, c1, 8, axis);
+    float tMin = 0.0f, tMax = 0.0f;
+    for (int i = 0; i < 16; i++) {
+        if (!((mask >> i) & 1)) continue;
+        float t = 0.0f;
+        for (int c = c0; c < c1; c++) t += (b.ch[c][i] - mean[c]) * axis[c];
+        tMin = std::min(tMin, t);
+        tMax = std::max(tMax, t);
+    }
+    for (int c = 0; c < 4; c++) {
+        e0[c] = c >= c0 && c < c1 ? std::clamp(mean[c] + axis[c] * tMin, 0.0f, 255.0f) : 255.0f;
+        e1[c] = c >= c0 && c < c1 ? std::clamp(mean[c] + axis[c] * tMax, 0.0f, 255.0f) : 255.0f;
+    }
+}
+
+// Least-squares endpoints for fixed indices: minimizes sum |(1 - w) e0 + w e1 - p|^2 over `mask`,
+// with w = weights[index]. Returns false when the system is singular (one distinct index).
+static bool refitLine(const Block& b, uint32_t mask, int c0, int c1, const uint8_t idx[16], const float* weights, float e0[4], float e1[4]) {
+    float aa = 0.0f, ab = 0.0f, bb = 0.0f, ax[4] = {}, bx[4] = {};
+    for (int i = 0; i < 16; i++) {
+        if (!((mask >> i) & 1)) continue;
+        const float w = weights[idx[i]];
+        aa += (1.0f - w) * (1.0f - w);
+        ab += (1.0f - w) * w;
+        bb += w * w;
+        for (int c = c0; c < c1; c++) {
+            ax[c] += (1.0f - w) * b.ch[c][i];
+            bx[c] += w * b.ch[c][i];
+        }
+    }
+    const float det = aa * bb - ab * ab;
+    if (std::fabs(det) < 1e-6f) return false;
+    const float inv = 1.0f / det;
+    for (int c = c0; c < c1; c++) {
+        e0[c] = std::clamp((bb * ax[c] - ab * bx[c]) * inv, 0.0f, 255.0f);
+        e1[c] = std::clamp((aa * bx[c] - ab * ax[c]) * inv, 0.0f, 255.0f);
+    }
+    return true;
+}
+
+static uint16_t quantize565(const float e[4]) {
+    const int r = std::clamp((int)std::lround(e[0] * (31.0f / 255.0f)), 0, 31);
+    const int g = std::clamp((int)std::lround(e[1] * (63.0f / 255.0f)), 0, 63);
+    const int b = std::clamp((int)std::lround(e[2] * (31.0f / 255.0f)), 0, 31);
+    return (uint16_t)((r << 11) | (g << 5) | b);
+}
+
+// Endpoint pairs whose 2/3 interpolant reproduces each 8-bit value best (solid-color blocks).
+struct SolidTables {
+    uint8_t match5[256][2];
+    uint8_t match6[256][2];
+
+    SolidTables() {
+        build(match5, 5);
+        build(match6, 6);
+    }
+
+    static void build(uint8_t table[256][2], int bits) {
+        const int levels = 1 << bits;
+        for (int v = 0; v < 256; v++) {
+            int bestErr = 1 << 30;
+            for (int a = 0; a < levels; a++) {
+                for (int b = 0; b < levels; b++) {
+                    const int ea = bc7Expand(a, bits), eb = bc7Expand(b, bits);
+                    const int err = std::abs((2 * ea + eb + 1) / 3 - v) * 100 + std::abs(ea - eb); // prefer close endpoints
+                    if (err < bestErr) {
+                        bestErr = err;
+                        table[v][0] = (uint8_t)a;
+                        table[v][1] = (uint8_t)b;
+                    }
+                }
+            }
+        }
+    }
+};
+
+static const SolidTables& solidTables() {
+    static const SolidTables tables;
+    return tables;
+}
+
+static void putU16(uint8_t* out, uint16_t v) {
+    out[0] = (uint8_t)(v & 0xFF);
+    out[1] = (uint8_t)(v >> 8);
+}
+
+// BC1 color block (also the color half of BC3, where `bc1` is false and there is no punch-through).
+static void encodeColorBlock(const Block& b, int quality, bool bc1, uint8_t out[8]) {
+    uint32_t opaqueMask = 0xFFFF;
+    if (bc1) {
+        for (int i = 0; i < 16; i++) {
+            if (b.px[i][3] < 128) opaqueMask &= ~(1u << i);
+        }
+    }
+    if (opaqueMask == 0) {
+        // Three-color mode, every pixel transparent.
+        std::memset(out, 0, 4);
+        std::memset(out + 4, 0xFF, 4);
+        return;
+    }
+    // Punch-through alpha needs three-color mode (c0 <= c1), whose index 3 is transparent.
+    const bool fourColor = opaqueMask == 0xFFFF;
+    const int palCount = fourColor ? 4 : 3;
+    static const float kFourWeights[4] = {0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f};
+    static const float kThreeWeights[4] = {0.0f, 1.0f, 0.5f, 0.0f};
+
+    float bestErr = 1e30f;
+    uint16_t best0 = 0, best1 = 0;
+    uint8_t bestIdx[16] = {};
+    auto tryPair = [&](uint16_t q0, uint16_t q1, uint8_t idx[16]) {
+        if (fourColor ? q0 < q1 : q0 > q1) std::swap(q0, q1);
+        if (fourColor && bc1 && q0 == q1) {
+            // Equal endpoints would switch BC1 to three-color mode; one step apart keeps index 0 exact.
+            if (q1 > 0) q1--;
+            else q0++;
+        }
+        int ipal[4][4];
+        bc1Palette(q0, q1, !bc1, ipal);
+        float pal[4][4];
+        for (int k = 0; k < 4; k++) {
+            for (int c = 0; c < 4; c++) pal[k][c] = (float)ipal[k][c];
+        }
+        const float err = selectIndices(b, opaqueMask, 0, 3, pal, palCount, idx);
+        if (err < bestErr) {
+            bestErr = err;
+            best0 = q0;
+            best1 = q1;
+            std::memcpy(bestIdx, idx, 16);
+        }
+        return err;
+    };
+
+    uint8_t idx[16];
+    bool solid = fourColor;
+    for (int i = 1; i < 16 && solid; i++) solid = std::memcmp(b.px[i], b.px[0], 3) == 0;
+    if (solid) {
+        const SolidTables& t = solidTables();
+        const uint8_t* r = t.match5[b.px[0][0]];
+        const uint8_t* g = t.match6[b.px[0][1]];
+        const uint8_t* bl = t.match5[b.px[0][2]];
+        tryPair((uint16_t)((r[0] << 11) | (g[0] << 5) | bl[0]), (uint16_t)((r[1] << 11) | (g[1] << 5) | bl[1]), idx);
+    }
+
+    float e0[4], e1[4];
+    fitLine(b, opaqueMask, 0, 3, e0, e1);
+    if (fourColor) {
+        // Pull the ends in slightly: the extreme pixels rarely need to be reproduced exactly.
+        for (int c = 0; c < 3; c++) {
+            const float inset = (e1[c] - e0[c]) / 16.0f;
+            e0[c] += inset;
+            e1[c] -= inset;
+        }
+    }
+    float err = tryPair(quantize565(e0), quantize565(e1), idx);
+    for (int it = 0; it < quality && err > 0.0f; it++) {
+        if (!refitLine(b, opaqueMask, 0, 3, idx, fourColor ? kFourWeights : kThreeWeights, e0, e1)) break;
+        err = tryPair(quantize565(e0), quantize565(e1), idx);
+    }
+
+    putU16(out, best0);
+    putU16(out + 2, best1);
+    uint32_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint32_t)(((opaqueMask >> i) & 1) ? bestIdx[i] : 3) << (i * 2);
+    for (int i = 0; i < 4; i++) out[4 + i] = (uint8_t)(bits >> (i * 8));
+}
+
+static int alphaIndices(const Block& b, int a0, int a1, uint8_t idx[16]) {
+    int pal[8];
+    bc3AlphaPalette(a0, a1, pal);
+    int err = 0;
+    for (int i = 0; i < 16; i++) {
+        int best = 0, bestErr = 1 << 30;
+        for (int k = 0; k < 8; k++) {
+            const int d = (pal[k] - b.px[i][3]) * (pal[k] - b.px[i][3]);
+            if (d < bestErr) {
+                bestErr = d;
+                best = k;
+            }
+        }
+        idx[i] = (uint8_t)best;
+        err += bestErr;
+    }
+    return err;
+}
+
+static void encodeAlphaBlock(const Block& b, int quality, uint8_t out[8]) {
+    int lo = 255, hi = 0, innerLo = 255, innerHi = 0;
+    for (int i = 0; i < 16; i++) {
+        const int a = b.px[i][3];
+        lo = std::min(lo, a);
+        hi = std::max(hi, a);
+        if (a != 0 && a != 255) {
+            innerLo = std::min(innerLo, a);
+            innerHi = std::max(innerHi, a);
+        }
+    }
+    int best0 = hi, best1 = lo;
+    uint8_t bestIdx[16], idx[16];
+    int bestErr = alphaIndices(b, hi, lo, bestIdx);
+    auto tryPair = [&](int a0, int a1) {
+        const int err = alphaIndices(b, a0, a1, idx);
+        if (err < bestErr) {
+            bestErr = err;
+            best0 = a0;
+            best1 = a1;
+            std::memcpy(bestIdx, idx, 16);
+        }
+    };
+    if (quality >= 1 && bestErr > 0) {
+        // Six-value mode has exact 0 and 255, so the interpolated range only spans the rest.
+        if ((lo == 0 || hi == 255) && innerLo <= innerHi) tryPair(innerLo, innerHi);
+        // Least-squares refit of the eight-value ramp (index 0 = a0, 1 = a1, 2..7 in between).
+        static const float kRamp[8] = {0.0f, 1.0f, 1.0f / 7.0f, 2.0f / 7.0f, 3.0f / 7.0f, 4.0f / 7.0f, 5.0f / 7.0f, 6.0f / 7.0f};
+        float e0[4], e1[4];
+        if (hi > lo && refitLine(b, 0xFFFF, 3, 4, bestIdx, kRamp, e0, e1)) {
+            const int a0 = (int)std::lround(e0[3]), a1 = (int)std::lround(e1[3]);
+            if (a0 > a1) tryPair(a0, a1);
+        }
+    }
+    out[0] = (uint8_t)best0;
+    out[1] = (uint8_t)best1;
+    uint64_t bits = 0;
+    for (int i = 0; i < 16; i++) bits |= (uint64_t)bestIdx[i] << (i * 3);
+    for (int i = 0; i < 6; i++) out[2 + i] = (uint8_t)(bits >> (i * 8));
+}
+
+// BC7 endpoint channel: nearest stored value whose expansion (with `pbit` appended, -1 for none)
+// is closest to v. Returns the stored value and writes the expanded one.
+static int bc7QuantizeChannel(float v, int bits, int pbit, int* expanded) {
+    const int total = bits + (pbit >= 0 ? 1 : 0);
+    const float scaled = v * (float)((1 << total) - 1) / 255.0f;
+    const int guess = (int)std::lround(pbit >= 0 ? (scaled - (float)pbit) * 0.5f : scaled);
+    int best = 0;
+    float bestErr = 1e30f;
+    for (int q = guess - 1; q <= guess + 1; q++) {
+        if (q < 0 || q >= (1 << bits)) continue;
+        const int e = bc7Expand(pbit >= 0 ? (q << 1) | pbit : q, total);
+        const float err = std::fabs((float)e - v);
+        if (err < bestErr) {
+            bestErr = err;
+            best = q;
+            *expanded = e;
+        }
+    }
+    return best;
+}
+
+struct SubsetFit {
+    int q[2][4];
+    int pbits[2];
+    uint8_t idx[16];
+    float err;
+};
+
+enum { kPBitNone = 0, kPBitEndpoint = 1, kPBitShared = 2 };
+
+// Endpoint pair quantized to `bits` over channels [c0, c1), p-bits picked by endpoint error.
+// keepOpaque forces the p-bits that expand alpha 255 to exactly 255.
+static void bc7QuantizePair(const float e0[4], const float e1[4], int c0, int c1, int bits, int pbitMode, bool keepOpaque, int q[2][4], int pbits[2],
+                            int rec[2][4]) {
+    const float* ends[2] = {e0, e1};
+    auto quantizeEnd = [&](int e, int pbit, int outQ[4], int outRec[4]) {
+        float err = 0.0f;
+        for (int c = c0; c < c1; c++) {
+            outQ[c] = bc7QuantizeChannel(ends[e][c], bits, pbit, &outRec[c]);
+            err += ((float)outRec[c] - ends[e][c]) * ((float)outRec[c] - ends[e][c]);
+        }
+        return err;
+    };
+    pbits[0] = pbits[1] = 0;
+    if (pbitMode == kPBitNone) {
+        quantizeEnd(0, -1, q[0], rec[0]);
+        quantizeEnd(1, -1, q[1], rec[1]);
+    } else if (pbitMode == kPBitEndpoint) {
+        for (int e = 0; e < 2; e++) {
+            float bestErr = 1e30f;
+            for (int p = keepOpaque ? 1 : 0; p < 2; p++) {
+                int qp[4], rp[4];
+                const float err = quantizeEnd(e, p, qp, rp);
+                if (err < bestErr) {
+                    bestErr = err;
+                    std::memcpy(q[e], qp, sizeof(qp));
+                    std::memcpy(rec[e], rp, sizeof(rp));
+                    pbits[e] = p;
+                }
+            }
+        }
+    } else {
+        int q1[2][4], r1[2][4];
+        const float err0 = quantizeEnd(0, 0, q[0], rec[0]) + quantizeEnd(1, 0, q[1], rec[1]);
+        if (quantizeEnd(0, 1, q1[0], r1[0]) + quantizeEnd(1, 1, q1[1], r1[1]) < err0) {
+            std::memcpy(q, q1, sizeof(q1));
+            std::memcpy(rec, r1, sizeof(r1));
+            pbits[0] = pbits[1] = 1;
+        }
+    }
+}
+
+// Fits one subset: principal-axis endpoints, then `iterations` least-squares refinements.
+static SubsetFit bc7FitSubset(const Block& b, uint32_t mask, int c0, int c1, int bits, int pbitMode, int indexBits, int iterations) {
+    const int* weights = bc7Weights(indexBits);
+    const int count = 1 << indexBits;
+    float unit[16];
+    for (int k = 0; k < count; k++) unit[k] = (float)weights[k] / 64.0f;
+
+    float e0[4], e1[4];
+    fitLine(b, mask, c0, c1, e0, e1);
+    SubsetFit best;
+    best.err = 1e30f;
+    for (int it = 0;; it++) {
+        SubsetFit fit;
+        int rec[2][4] = {};
+        bc7QuantizePair(e0, e1, c0, c1, bits, pbitMode, b.opaque && c1 == 4, fit.q, fit.pbits, rec);
+        float pal[16][4];
+        for (int k = 0; k < count; k++) {
+            for (int c = c0; c < c1; c++) pal[k][c] = (float)bc7Interpolate(rec[0][c], rec[1][c], weights[k]);
+        }
+        fit.err = selectIndices(b, mask, c0, c1, pal, count, fit.idx);
+        if (fit.err < best.err) best = fit;
+        if (it >= iterations || best.err == 0.0f || !refitLine(b, mask, c0, c1, fit.idx, unit, e0, e1)) break;
+    }
+    return best;
+}
+
+static uint32_t bc7SubsetMask(int subsets, int partition, int subset) {
+    uint32_t mask = 0;
+    for (int i = 0; i < 16; i++) {
+        if (bc7Subset(subsets, partition, i) == subset) mask |= 1u << i;
+    }
+    return mask;
+}
+
+// The anchor index of every subset must have its top bit clear: swap the endpoints and mirror
+// the indices where it is set.
+static void bc7FixAnchors(Bc7Block& blk) {
+    const Bc7Mode& m = kBc7Modes[blk.mode];
+    const int top = (1 << m.indexBits) - 1;
+    const int colorChannels = m.indexBits2 ? 3 : 4;
+    for (int s = 0; s < m.subsets; s++) {
+        if (blk.indices[bc7Anchor(m.subsets, blk.partition, s)] <= top / 2) continue;
+        for (int c = 0; c < colorChannels; c++) std::swap(blk.endpoints[s][0][c], blk.endpoints[s][1][c]);
+        std::swap(blk.pbits[s][0], blk.pbits[s][1]);
+        for (int i = 0; i < 16; i++) {
+            if (bc7Subset(m.subsets, blk.partition, i) == s) blk.indices[i] = (uint8_t)(top - blk.indices[i]);
+        }
+    }
+    if (m.indexBits2) {
+        const int top2 = (1 << m.indexBits2) - 1;
+        if (blk.indices2[0] > top2 / 2) {
+            std::swap(blk.endpoints[0][0][3], blk.endpoints[0][1][3]);
+            for (int i = 0; i < 16; i++) blk.indices2[i] = (uint8_t)(top2 - blk.indices2[i]);
+        }
+    }
+}
+
+// Modes 1, 3, 6 and 7: one line per subset over RGB (alpha 255) or RGBA.
+static float bc7EncodeSubsets(const Block& b, int mode, int partition, int iterations, Bc7Block& blk) {
+    const Bc7Mode& m = kBc7Modes[mode];
+    const int channels = m.alphaBits ? 4 : 3;
+    const int pbitMode = m.endpointPBits ? kPBitEndpoint : (m.sharedPBits ? kPBitShared : kPBitNone);
+    blk = Bc7Block{};
+    blk.mode = mode;
+    blk.partition = partition;
+    float err = 0.0f;
+    for (int s = 0; s < m.subsets; s++) {
+        const uint32_t mask = bc7SubsetMask(m.subsets, partition, s);
+        const SubsetFit fit = bc7FitSubset(b, mask, 0, channels, m.colorBits, pbitMode, m.indexBits, iterations);
+        for (int e = 0; e < 2; e++) {
+            for (int c = 0; c < channels; c++) blk.endpoints[s][e][c] = fit.q[e][c];
+            blk.pbits[s][e] = fit.pbits[e];
+        }
+        for (int i = 0; i < 16; i++) {
+            if ((mask >> i) & 1) blk.indices[i] = fit.idx[i];
+        }
+        err += fit.err;
+    }
+    bc7FixAnchors(blk);
+    return err;
+}
+
+// Mode 5: RGB and alpha fitted independently (uncorrelated alpha), no rotation.
+static float bc7EncodeMode5(const Block& b, int iterations, Bc7Block& blk) {
+    blk = Bc7Block{};
+    blk.mode = 5;
+    const SubsetFit color = bc7FitSubset(b, 0xFFFF, 0, 3, 7, kPBitNone, 2, iterations);
+    const SubsetFit alpha = bc7FitSubset(b, 0xFFFF, 3, 4, 8, kPBitNone, 2, iterations);
+    for (int e = 0; e < 2; e++) {
+        for (int c = 0; c < 3; c++) blk.endpoints[0][e][c] = color.q[e][c];
+        blk.endpoints[0][e][3] = alpha.q[e][3];
+    }
+    std::memcpy(blk.indices, color.idx, 16);
+    std::memcpy(blk.indices2, alpha.idx, 16);
+    bc7FixAnchors(blk);
+    return color.err + alpha.err;
+}
+
+// Orders the two-subset partitions so the first `count` have the least variance left over after
+// fitting a line per subset. Subset sums come from per-pixel moments, four moments per F4 add.
+static void rankPartitions(const Block& b, int channels, int count, int order[64]) {
+    F4 moments[16][4]; // x_c for c < 4, then x_r * x_c for r <= c (10 products), padded to 16
+    F4 total[4] = {f4Set1(0.0f), f4Set1(0.0f), f4Set1(0.0f), f4Set1(0.0f)};
+    for (int i = 0; i < 16; i++) {
+        float m[16] = {};
+        int k = 4;
+        for (int c = 0; c < channels; c++) m[c] = b.ch[c][i];
+        for (int r = 0; r < channels; r++) {
+            for (int c = r; c < channels; c++) m[k++] = b.ch[r][i] * b.ch[c][i];
+        }
+        for (int j = 0; j < 4; j++) {
+            moments[i][j] = f4Load(m + j * 4);
+            total[j] = total[j] + moments[i][j];
+        }
+    }
+    float residual[64];
+    for (int p = 0; p < 64; p++) {
+        F4 sum[4] = {f4Set1(0.0f), f4Set1(0.0f), f4Set1(0.0f), f4Set1(0.0f)};
+        int n1 = 0;
+        for (int i = 0; i < 16; i++) {
+            if (!((kPartition2[p] >> i) & 1)) continue;
+            for (int j = 0; j < 4; j++) sum[j] = sum[j] + moments[i][j];
+            n1++;
+        }
+        residual[p] = 0.0f;
+        order[p] = p;
+        for (int s = 0; s < 2; s++) {
+            float m[16];
+            for (int j = 0; j < 4; j++) f4Store(m + j * 4, s == 1 ? sum[j] : total[j] - sum[j]);
+            const float n = (float)(s == 1 ? n1 : 16 - n1);
+            float cov[4][4], axis[4], trace = 0.0f;
+            int k = 4;
+            for (int r = 0; r < channels; r++) {
+                for (int c = r; c < channels; c++, k++) cov[r][c] = cov[c][r] = m[k] - m[r] * m[c] / n;
+                trace += cov[r][r];
+            }
+            residual[p] += trace - principalAxis(cov, 0, channels, 2, axis);
+        }
+    }
+    std::partial_sort(order, order + count, order + 64, [&](int x, int y) { return residual[x] < residual[y]; });
+}
+
+static void encodeBc7Block(const Block& b, int quality, uint8_t out[16]) {
+    Bc7Block best, candidate;
+    float bestErr = bc7EncodeSubsets(b, 6, 0, quality, best);
+    auto consider = [&](float err) {
+        if (err < bestErr) {
+            bestErr = err;
+            best = candidate;
+        }
+    };
+    // Stop when the single-subset fit is already within about one step per pixel (normal) or
+    // half a step (high) -- partitions rarely win there and cost most of the encode time.
+    const float goodEnough = quality >= 2 ? 16.0f : 16.0f * 4.0f;
+    if (quality >= 1 && bestErr > goodEnough) {
+        if (!b.opaque) consider(bc7EncodeMode5(b, quality, candidate));
+
+        const int tries = quality >= 2 ? 16 : 4;
+        int order[64];
+        rankPartitions(b, b.opaque ? 3 : 4, tries, order);
+        for (int t = 0; t < tries && bestErr > 0.0f; t++) {
+            if (b.opaque) {
+                consider(bc7EncodeSubsets(b, 1, order[t], quality, candidate));
+                if (quality >= 2) consider(bc7EncodeSubsets(b, 3, order[t], quality, candidate));
+            } else {
+                consider(bc7EncodeSubsets(b, 7, order[t], quality, candidate));
+            }
+        }
+    }
+    bc7Pack(best, out);
+}
+
+static int blockBytes(int format) {
+    switch (format) {
+    case G4F_BCN_BC1: return 8;
+    case G4F_BCN_BC3:
+    case G4F_BCN_BC7: return 16;
+    default: return 0;
+    }
+}
+
+struct EncodeJob {
+    const uint8_t* src;
+    int pitch;
+    int width;
+    int height;
+    int format;
+    int quality;
+    uint8_t* out;
+};
+
+static void encodeBlockRows(void* user, int begin, int end, int) {
+    const EncodeJob& job = *(const EncodeJob*)user;
+    const int blocksX = (job.width + 3) / 4;
+    const int bytes = blockBytes(job.format);
+    Block b;
+    for (int by = begin; by < end; by++) {
+        uint8_t* dst = job.out + (size_t)by * (size_t)blocksX * (size_t)bytes;
+        for (int bx = 0; bx < blocksX; bx++, dst += bytes) {
+            loadBlock(job.src, job.pitch, job.width, job.height, bx, by, b);
+            if (job.format == G4F_BCN_BC1) {
+                encodeColorBlock(b, job.quality, true, dst);
+            } else if (job.format == G4F_BCN_BC3) {
+                encodeAlphaBlock(b, job.quality, dst);
+                encodeColorBlock(b, job.quality, false, dst + 8);
+            } else {
+                encodeBc7Block(b, job.quality, dst);
+            }
+        }
+    }
+}
+
+} // namespace
+
+size_t g4f_bcn_chain_bytes(int format, int width, int height, int levels) {
+    const int bytes = blockBytes(format);
+    if (!bytes || width <= 0 || height <= 0 || levels <= 0 || levels > g4f_mipgen_level_count(width, height)) return 0;
+    size_t total = 0;
+    for (int i = 0; i < levels; i++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, i, &w, &h);
+        total += (size_t)((w + 3) / 4) * (size_t)((h + 3) / 4) * (size_t)bytes;
+    }
+    return total;
+}
+
+int g4f_bcn_encode_rgba8(const void* src, int width, int height, int srcPitchBytes, int format, int quality, g4f_jobs* jobs, void* outBlocks) {
+    if (!src || !outBlocks || !blockBytes(format)) { g4f_set_last_error("g4f_bcn_encode_rgba8: invalid args"); return 0; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_bcn_encode_rgba8: invalid size"); return 0; }
+    if (srcPitchBytes <= 0) srcPitchBytes = width * 4;
+    if (srcPitchBytes < width * 4) { g4f_set_last_error("g4f_bcn_encode_rgba8: pitch too small"); return 0; }
+
+    EncodeJob job{(const uint8_t*)src, srcPitchBytes, width, height, format, std::clamp(quality, 0, 2), (uint8_t*)outBlocks};
+    g4f_jobs_parallel_for(jobs, (height + 3) / 4, 0, encodeBlockRows, &job);
+    return 1;
+}
+
+int g4f_bcn_encode_chain_rgba8(const void* chain, int width, int height, int levels, int format, int quality, g4f_jobs* jobs, void* outChain) {
+    if (!chain || !outChain || g4f_bcn_chain_bytes(format, width, height, levels) == 0) {
+        g4f_set_last_error("g4f_bcn_encode_chain_rgba8: invalid args");
+        return 0;
+    }
+    const uint8_t* src = (const uint8_t*)chain;
+    uint8_t* dst = (uint8_t*)outChain;
+    for (int i = 0; i < levels; i++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, i, &w, &h);
+        if (!g4f_bcn_encode_rgba8(src, w, h, 0, format, quality, jobs, dst)) return 0;
+        src += (size_t)w * (size_t)h * 4;
+        dst += g4f_bcn_chain_bytes(format, w, h, 1);
+    }
+    return 1;
+}
+
+int g4f_bcn_decode_rgba8(const void* blocks, int format, int width, int height, void* dst, int dstPitchBytes) {
+    if (!blocks || !dst || !blockBytes(format)) { g4f_set_last_error("g4f_bcn_decode_rgba8: invalid args"); return 0; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_bcn_decode_rgba8: invalid size"); return 0; }
+    if (dstPitchBytes <= 0) dstPitchBytes = width * 4;
+    if (dstPitchBytes < width * 4) { g4f_set_last_error("g4f_bcn_decode_rgba8: pitch too small"); return 0; }
+
+    const uint8_t* in = (const uint8_t*)blocks;
+    uint8_t* out = (uint8_t*)dst;
+    const int bytes = blockBytes(format);
+    uint8_t px[16][4];
+    for (int by = 0; by < (height + 3) / 4; by++) {
+        for (int bx = 0; bx < (width + 3) / 4; bx++, in += bytes) {
+            if (format == G4F_BCN_BC1) {
+                decodeColorBlock(in, true, px);
+            } else if (format == G4F_BCN_BC3) {
+                decodeColorBlock(in + 8, false, px);
+                decodeAlphaBlock(in, px);
+            } else {
+                bc7Decode(in, px);
+            }
+            for (int y = 0; y < 4 && by * 4 + y < height; y++) {
+                const int n = std::min(4, width - bx * 4);
+                std::memcpy(out + (size_t)(by * 4 + y) * (size_t)dstPitchBytes + (size_t)bx * 16, px[y * 4], (size_t)n * 4);
+            }
+        }
+    }
+    return 1;
+}
@@ -0,0 +1,1017 @@
+#include "../include/g4f/g4f_bvh.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+#include <numeric>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+constexpr int kBins = 16;
+constexpr int kMaxLeafLimit = 16;
+// Deeper than this, splits fall back to the median, which bounds the tree depth (and so the
+// traversal stack) even for pathological SAH splits: at most 48 + log2(2^27) binary levels.
+constexpr int kMaxSahDepth = 48;
+// Each visited node pushes at most 3 entries beyond the one it popped.
+constexpr int kStackSize = 256;
+constexpr float kTraversalCost = 1.0f; // relative to one triangle/instance test
+constexpr int kMaxPrimitives = 1 << 27;
+constexpr int kParallelBatchGrain = 64;
+
+// Child references: node index, or a leaf holding primitives [first, first + count).
+constexpr uint32_t kLeafBit = 0x80000000u;
+constexpr uint32_t kEmptyRef = 0x7FFFFFFFu;
+
+static uint32_t leafRef(int first, int count) { return kLeafBit | ((uint32_t)(count - 1) << 27) | (uint32_t)first; }
+static bool isLeaf(uint32_t ref) { return (ref & kLeafBit) != 0; }
+static int leafFirst(uint32_t ref) { return (int)(ref & 0x07FFFFFFu); }
+static int leafCount(uint32_t ref) { return (int)((ref >> 27) & 15u) + 1; }
+
+struct Box {
+    float mn[3];
+    float mx[3];
+};
+
+static Box emptyBox() { return Box{{FLT_MAX, FLT_MAX, FLT_MAX}, {-FLT_MAX, -FLT_MAX, -FLT_MAX}}; }
+
+static void boxGrow(Box& b, const float* p) {
+    for (int k = 0; k < 3; k++) {
+        b.mn[k] = std::min(b.mn[k], p[k]);
+        b.mx[k] = std::max(b.mx[k], p[k]);
+    }
+}
+
+static void boxUnion(Box& b, const Box& o) {
+    for (int k = 0; k < 3; k++) {
+        b.mn[k] = std::min(b.mn[k], o.mn[k]);
+        b.mx[k] = std::max(b.mx[k], o.mx[k]);
+    }
+}
+
+// Half the surface area; 0 for empty boxes.
+static float boxArea(const Box& b) {
+    const float dx = std::max(0.0f, b.mx[0] - b.mn[0]);
+    const float dy = std::max(0.0f, b.mx[1] - b.mn[1]);
+    const float dz = std::max(0.0f, b.mx[2] - b.mn[2]);
+    return dx * dy + dy * dz + dz * dx;
+}
+
+// Four child boxes in SoA layout. Unused lanes hold inverted boxes, which every test rejects.
+struct alignas(16) Node4 {
+    float bmin[3][4];
+    float bmax[3][4];
+    uint32_t child[4];
+};
+
+static void setLane(Node4& node, int lane, const Box& box, uint32_t ref) {
+    for (int k = 0; k < 3; k++) {
+        node.bmin[k][lane] = box.mn[k];
+        node.bmax[k][lane] = box.mx[k];
+    }
+    node.child[lane] = ref;
+}
+
+static void clearNode(Node4& node) {
+    for (int lane = 0; lane < 4; lane++) setLane(node, lane, emptyBox(), kEmptyRef);
+}
+
+struct Tree {
+    std::vector<Node4> nodes; // nodes[0] is the root; children always follow their parent
+    std::vector<int> order;   // primitive ids in leaf order
+    Box bounds = emptyBox();
+    int leaves = 0;
+    int depth = 0;
+    float sahCost = 0.0f;
+};
+
+// ---- Build: binned SAH over primitive boxes into a binary tree, then collapsed to 4-wide nodes ----
+
+struct BuildNode {
+    Box box;
+    int left = -1;
+    int right = -1;
+    int first = 0;
+    int count = 0;
+};
+
+struct BuildState {
+    const Box* boxes = nullptr;
+    const float* centroids = nullptr; // xyz per primitive
+    int maxLeaf = 4;
+    std::vector<int>* order = nullptr;
+    std::vector<BuildNode> nodes;
+};
+
+static int binOf(float c, float lo, float scale) {
+    const int b = (int)((c - lo) * scale);
+    return std::clamp(b, 0, kBins - 1);
+}
+
+// Returns the split point in [first, first + count), or -1 to make a leaf.
+static int chooseSplit(BuildState& st, int first, int count, const Box& box, const Box& centroidBox, int depth) {
+    int* order = st.order->data();
+    if (depth < kMaxSahDepth) {
+        float bestCost = FLT_MAX;
+        int bestAxis = -1;
+        int bestBin = 0;
+        for (int axis = 0; axis < 3; axis++) {
+            const float lo = centroidBox.mn[axis];
+            const float extent = centroidBox.mx[axis] - lo;
+            if (!(extent > 0.0f)) continue;
+            const float scale = (float)kBins / extent;
+
+            Box bins[kBins];
+            int counts[kBins] = {};
+            for (int b = 0; b < kBins; b++) bins[b] = emptyBox();
+            for (int i = first; i < first + count; i++) {
+                const int p = order[i];
+                const int b = binOf(st.centroids[p * 3 + axis], lo, scale);
+                counts[b]++;
+                boxUnion(bins[b], st.boxes[p]);
+            }
+
+            float rightArea[kBins] = {};
+            int rightCount[kBins] = {};
+            Box acc = emptyBox();
+            int n = 0;
+            for (int b = kBins - 1; b > 0; b--) {
+                boxUnion(acc, bins[b]);
+                n += counts[b];
+                rightArea[b] = boxArea(acc);
+                rightCount[b] = n;
+            }
+            acc = emptyBox();
+            n = 0;
+            for (int b = 0; b < kBins - 1; b++) {
+                boxUnion(acc, bins[b]);
+                n += counts[b];
+                if (n == 0 || rightCount[b + 1] == 0) continue;
+                const float cost = boxArea(acc) * (float)n + rightArea[b + 1] * (float)rightCount[b + 1];
+                if (cost < bestCost) {
+                    bestCost = cost;
+                    bestAxis = axis;
+                    bestBin = b + 1;
+                }
+            }
+        }
+
+        if (bestAxis >= 0) {
+            const float splitCost = kTraversalCost + bestCost / std::max(boxArea(box), 1e-30f);
+            if (count <= st.maxLeaf && splitCost >= (float)count) return -1;
+            const float lo = centroidBox.mn[bestAxis];
+            const float scale = (float)kBins / (centroidBox.mx[bestAxis] - lo);
+            int* mid = std::partition(order + first, order + first + count, [&](int p) {
+                return binOf(st.centroids[p * 3 + bestAxis], lo, scale) < bestBin;
+            });
+            const int split = (int)(mid - order);
+            if (split > first && split < first + count) return split;
+        } else if (count <= st.maxLeaf) {
+            return -1;
+        }
+    } else if (count <= st.maxLeaf) {
+        return -1;
+    }
+
+    // Median split along the widest centroid axis (index order when every centroid coincides).
+    int axis = 0;
+    for (int k = 1; k < 3; k++) {
+        if (centroidBox.mx[k] - centroidBox.mn[k] > centroidBox.mx[axis] - centroidBox.mn[axis]) axis = k;
+    }
+    const int split = first + count / 2;
+    if (centroidBox.mx[axis] > centroidBox.mn[axis]) {
+        std::nth_element(order + first, order + split, order + first + count,
+                         [&](int a, int b) { return st.centroids[a * 3 + axis] < st.centroids[b * 3 + axis]; });
+    }
+    return split;
+}
+
+static int buildRecursive(BuildState& st, int first, int count, int depth) {
+    BuildNode node;
+    node.box = emptyBox();
+    Box centroidBox = emptyBox();
+    const int* order = st.order->data();
+    for (int i = first; i < first + count; i++) {
+        boxUnion(node.box, st.boxes[order[i]]);
+        boxGrow(centroidBox, &st.centroids[order[i] * 3]);
+    }
+    const int index = (int)st.nodes.size();
+    st.nodes.push_back(node);
+
+    const int split = count > 1 ? chooseSplit(st, first, count, node.box, centroidBox, depth) : -1;
+    if (split < 0) {
+        st.nodes[(size_t)index].first = first;
+        st.nodes[(size_t)index].count = count;
+        return index;
+    }
+    const int left = buildRecursive(st, first, split - first, depth + 1);
+    const int right = buildRecursive(st, split, first + count - split, depth + 1);
+    st.nodes[(size_t)index].left = left;
+    st.nodes[(size_t)index].right = right;
+    return index;
+}
+
+// Turns the binary subtree at `b` into 4-wide nodes: repeatedly opens the largest internal child
+// until four children are gathered. Returns the child reference for the parent's lane.
+static uint32_t collapse(Tree& tree, const std::vector<BuildNode>& bnodes, int b, int depth, float invRootArea) {
+    const BuildNode& bn = bnodes[(size_t)b];
+    if (bn.left < 0) {
+        tree.leaves++;
+        tree.sahCost += boxArea(bn.box) * invRootArea * (float)bn.count;
+        return leafRef(bn.first, bn.count);
+    }
+    int kids[4] = {bn.left, bn.right, -1, -1};
+    int n = 2;
+    while (n < 4) {
+        int pick = -1;
+        float pickArea = -1.0f;
+        for (int i = 0; i < n; i++) {
+            const BuildNode& k = bnodes[(size_t)kids[i]];
+            if (k.left >= 0 && boxArea(k.box) > pickArea) {
+                pick = i;
+                pickArea = boxArea(k.box);
+            }
+        }
+        if (pick < 0) break;
+        const BuildNode& opened = bnodes[(size_t)kids[pick]];
+        kids[pick] = opened.left;
+        kids[n++] = opened.right;
+    }
+
+    const int index = (int)tree.nodes.size();
+    tree.nodes.emplace_back();
+    tree.depth = std::max(tree.depth, depth);
+    tree.sahCost += kTraversalCost * boxArea(bn.box) * invRootArea;
+    uint32_t refs[4];
+    for (int i = 0; i < n; i++) refs[i] = collapse(tree, bnodes, kids[i], depth + 1, invRootArea);
+    Node4& node = tree.nodes[(size_t)index];
+    clearNode(node);
+    for (int i = 0; i < n; i++) setLane(node, i, bnodes[(size_t)kids[i]].box, refs[i]);
+    return (uint32_t)index;
+}
+
+static void buildTree(Tree& tree, const std::vector<Box>& boxes, const std::vector<float>& centroids, int maxLeaf) {
+    const int count = (int)boxes.size();
+    tree.nodes.clear();
+    tree.order.resize((size_t)count);
+    std::iota(tree.order.begin(), tree.order.end(), 0);
+    tree.bounds = emptyBox();
+    tree.leaves = 0;
+    tree.depth = 0;
+    tree.sahCost = 0.0f;
+    if (count == 0) return;
+
+    BuildState st;
+    st.boxes = boxes.data();
+    st.centroids = centroids.data();
+    st.maxLeaf = maxLeaf;
+    st.order = &tree.order;
+    st.nodes.reserve((size_t)(2 * count / maxLeaf + 1));
+    buildRecursive(st, 0, count, 0);
+
+    const BuildNode& root = st.nodes[0];
+    tree.bounds = root.box;
+    const float invRootArea = 1.0f / std::max(boxArea(root.box), 1e-30f);
+    if (root.left < 0) {
+        // A single leaf still gets a root node so traversal always starts at nodes[0].
+        Node4 node;
+        clearNode(node);
+        setLane(node, 0, root.box, leafRef(0, count));
+        tree.nodes.push_back(node);
+        tree.leaves = 1;
+        tree.depth = 1;
+        tree.sahCost = kTraversalCost + (float)count;
+        return;
+    }
+    collapse(tree, st.nodes, 0, 1, invRootArea);
+}
+
+static void fillStats(const Tree& tree, g4f_bvh_stats* out) {
+    out->nodes = (int)tree.nodes.size();
+    out->leaves = tree.leaves;
+    out->depth = tree.depth;
+    out->primitives = (int)tree.order.size();
+    out->sahCost = tree.sahCost;
+}
+
+// ---- Queries ----
+
+struct Ray {
+    float o[3];
+    float d[3];
+    F4 ox, oy, oz;
+    F4 ix, iy, iz;
+};
+
+static float safeInverse(float x) {
+    // Keeps slab distances finite for axis-parallel rays.
+    if (std::fabs(x) < 1e-30f) x = std::signbit(x) ? -1e-30f : 1e-30f;
+    return 1.0f / x;
+}
+
+static Ray makeRay(const float* o, const float* d) {
+    Ray r;
+    for (int k = 0; k < 3; k++) {
+        r.o[k] = o[k];
+        r.d[k] = d[k];
+    }
+    r.ox = f4Set1(o[0]);
+    r.oy = f4Set1(o[1]);
+    r.oz = f4Set1(o[2]);
+    r.ix = f4Set1(safeInverse(d[0]));
+    r.iy = f4Set1(safeInverse(d[1]));
+    r.iz = f4Set1(safeInverse(d[2]));
+    return r;
+}
+
+// Slab test of a ray against the node's four boxes; writes entry distances and returns the hit lanes.
+static int rayNode(const Node4& node, const Ray& r, float tBest, float* tEnter) {
+    const F4 minX = f4Load(node.bmin[0]);
+    const F4 maxX = f4Load(node.bmax[0]);
+    const F4 x0 = (minX - r.ox) * r.ix;
+    const F4 x1 = (maxX - r.ox) * r.ix;
+    const F4 y0 = (f4Load(node.bmin[1]) - r.oy) * r.iy;
+    const F4 y1 = (f4Load(node.bmax[1]) - r.oy) * r.iy;
+    const F4 z0 = (f4Load(node.bmin[2]) - r.oz) * r.iz;
+    const F4 z1 = (f4Load(node.bmax[2]) - r.oz) * r.iz;
+    const F4 tNear = f4Max(f4Max(f4Min(x0, x1), f4Min(y0, y1)), f4Max(f4Min(z0, z1), f4Set1(0.0f)));
+    const F4 tFar = f4Min(f4Min(f4Max(x0, x1), f4Max(y0, y1)), f4Min(f4Max(z0, z1), f4Set1(tBest)));
+    f4Store(tEnter, tNear);
+    // Inverted (unused) boxes pass the slab test, so reject them explicitly.
+    return f4MoveMask(f4And(f4Le(tNear, tFar), f4Le(minX, maxX)));
+}
+
+static int boxNode(const Node4& node, const Box& q) {
+    F4 m = f4And(f4Le(f4Load(node.bmin[0]), f4Set1(q.mx[0])), f4Ge(f4Load(node.bmax[0]), f4Set1(q.mn[0])));
+    m = f4And(m, f4And(f4Le(f4Load(node.bmin[1]), f4Set1(q.mx[1])), f4Ge(f4Load(node.bmax[1]), f4Set1(q.mn[1]))));
+    m = f4And(m, f4And(f4Le(f4Load(node.bmin[2]), f4Set1(q.mx[2])), f4Ge(f4Load(node.bmax[2]), f4Set1(q.mn[2]))));
+    return f4MoveMask(m);
+}
+
+struct StackEntry {
+    uint32_t ref;
+    float t;
+};
+
+// Pushes the hit lanes far-to-near so the nearest child is visited first.
+static void pushSorted(StackEntry* stack, int* sp, const Node4& node, int mask, const float* tEnter) {
+    int lanes[4];
+    int n = 0;
+    for (int lane = 0; lane < 4; lane++) {
+        if (!(mask & (1 << lane))) continue;
+        int i = n++;
+        while (i > 0 && tEnter[lanes[i - 1]] < tEnter[lane]) {
+            lanes[i] = lanes[i - 1];
+            i--;
+        }
+        lanes[i] = lane;
+    }
+    for (int i = 0; i < n; i++) stack[(*sp)++] = StackEntry{node.child[lanes[i]], tEnter[lanes[i]]};
+}
+
+// Triangles in leaf order as v0 and two edges (Moller-Trumbore layout).
+struct Tri {
+    float v0[3];
+    float e1[3];
+    float e2[3];
+};
+
+static bool rayTriangle(const Tri& tri, const float* o, const float* d, float tBest, float* outT, float* outU, float* outV) {
+    const float px = d[1] * tri.e2[2] - d[2] * tri.e2[1];
+    const float py = d[2] * tri.e2[0] - d[0] * tri.e2[2];
+    const float pz = d[0] * tri.e2[1] - d[1] * tri.e2[0];
+    const float det = tri.e1[0] * px + tri.e1[1] * py + tri.e1[2] * pz;
+    if (std::fabs(det) < 1e-20f) return false;
+    const float inv = 1.0f / det;
+    const float sx = o[0] - tri.v0[0];
+    const float sy = o[1] - tri.v0[1];
+    const float sz = o[2] - tri.v0[2];
+    const float u = (sx * px + sy * py + sz * pz) * inv;
+    if (u < 0.0f || u > 1.0f) return false;
+    const float qx = sy * tri.e1[2] - sz * tri.e1[1];
+    const float qy = sz * tri.e1[0] - sx * tri.e1[2];
+    const float qz = sx * tri.e1[1] - sy * tri.e1[0];
+    const float v = (d[0] * qx + d[1] * qy + d[2] * qz) * inv;
+    if (v < 0.0f || u + v > 1.0f) return false;
+    const float t = (tri.e2[0] * qx + tri.e2[1] * qy + tri.e2[2] * qz) * inv;
+    if (!(t >= 0.0f && t < tBest)) return false;
+    *outT = t;
+    *outU = u;
+    *outV = v;
+    return true;
+}
+
+static float dot3(const float* a, const float* b) { return a[0] * b[0] + a[1] * b[1] + a[2] * b[2]; }
+
+// Squared distance from p to the triangle (a, b, c) via its closest point (Voronoi regions).
+static float pointTriangleDistSq(const float* p, const float* a, const float* b, const float* c) {
+    float ab[3], ac[3], ap[3];
+    for (int k = 0; k < 3; k++) {
+        ab[k] = b[k] - a[k];
+        ac[k] = c[k] - a[k];
+        ap[k] = p[k] - a[k];
+    }
+    float q[3];
+    auto at = [&](float s, float t) {
+        for (int k = 0; k < 3; k++) q[k] = a[k] + ab[k] * s + ac[k] * t;
+    };
+    const float d1 = dot3(ab, ap);
+    const float d2 = dot3(ac, ap);
+    float bp[3], cp[3];
+    for (int k = 0; k < 3; k++) {
+        bp[k] = p[k] - b[k];
+        cp[k] = p[k] - c[k];
+    }
+    const float d3 = dot3(ab, bp);
+    const float d4 = dot3(ac, bp);
+    const float d5 = dot3(ab, cp);
+    const float d6 = dot3(ac, cp);
+    const float va = d3 * d6 - d5 * d4;
+    const float vb = d5 * d2 - d1 * d6;
+    const float vc = d1 * d4 - d3 * d2;
+    if (d1 <= 0.0f && d2 <= 0.0f) {
+        at(0.0f, 0.0f);
+    } else if (d3 >= 0.0f && d4 <= d3) {
+        at(1.0f, 0.0f);
+    } else if (d6 >= 0.0f && d5 <= d6) {
+        at(0.0f, 1.0f);
+    } else if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) {
+        at(d1 / (d1 - d3), 0.0f);
+    } else if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) {
+        at(0.0f, d2 / (d2 - d6));
+    } else if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        const float w = (d4 - d3) / ((d4 - d3) + (d5 - d6));
+        at(1.0f - w, w);
+    } else {
+        const float denom = 1.0f / (va + vb + vc);
+        at(vb * denom, vc * denom);
+    }
+    const float dx = p[0] - q[0];
+    const float dy = p[1] - q[1];
+    const float dz = p[2] - q[2];
+    return dx * dx + dy * dy + dz * dz;
+}
+
+static void transformPoint(const g4f_mat4& m, const float* p, float* out) {
+    for (int k = 0; k < 3; k++) out[k] = p[0] * m.m[k] + p[1] * m.m[4 + k] + p[2] * m.m[8 + k] + m.m[12 + k];
+}
+
+static void transformVector(const g4f_mat4& m, const float* v, float* out) {
+    for (int k = 0; k < 3; k++) out[k] = v[0] * m.m[k] + v[1] * m.m[4 + k] + v[2] * m.m[8 + k];
+}
+
+static Box transformBox(const g4f_mat4& m, const Box& b) {
+    Box out = emptyBox();
+    if (b.mn[0] > b.mx[0]) return out;
+    for (int corner = 0; corner < 8; corner++) {
+        const float p[3] = {(corner & 1) ? b.mx[0] : b.mn[0], (corner & 2) ? b.mx[1] : b.mn[1], (corner & 4) ? b.mx[2] : b.mn[2]};
+        float q[3];
+        transformPoint(m, p, q);
+        boxGrow(out, q);
+    }
+    return out;
+}
+
+// Collects sphere overlaps into the caller's array while counting all of them.
+struct SphereHits {
+    g4f_bvh_hit* hits;
+    int maxHits;
+    int count;
+};
+
+static void addSphereHit(SphereHits& out, int instance, int triangle) {
+    if (out.count < out.maxHits) out.hits[out.count] = g4f_bvh_hit{0.0f, instance, triangle, 0.0f, 0.0f};
+    out.count++;
+}
+
+} // namespace
+
+struct g4f_bvh_mesh {
+    Tree tree;
+    std::vector<Tri> tris;         // leaf order
+    std::vector<int> triangleIds;  // leaf order -> source triangle index
+};
+
+namespace {
+
+// Closest (or any) hit of a ray in mesh space; tBest shrinks with every hit found.
+static bool meshRay(const g4f_bvh_mesh* mesh, const Ray& r, bool anyHit, float* tBest, g4f_bvh_hit* hit) {
+    if (mesh->tree.nodes.empty()) return false;
+    const Node4* nodes = mesh->tree.nodes.data();
+    StackEntry stack[kStackSize];
+    int sp = 0;
+    stack[sp++] = StackEntry{0u, 0.0f};
+    bool found = false;
+    while (sp > 0) {
+        const StackEntry e = stack[--sp];
+        if (e.t > *tBest) continue;
+        if (isLeaf(e.ref)) {
+            const int first = leafFirst(e.ref);
+            const int last = first + leafCount(e.ref);
+            for (int i = first; i < last; i++) {
+                float t, u, v;
+                if (!rayTriangle(mesh->tris[(size_t)i], r.o, r.d, *tBest, &t, &u, &v)) continue;
+                *tBest = t;
+                hit->t = t;
+                hit->triangle = mesh->triangleIds[(size_t)i];
+                hit->u = u;
+                hit->v = v;
+                found = true;
+                if (anyHit) return true;
+            }
+            continue;
+        }
+        const Node4& node = nodes[e.ref];
+        alignas(16) float tEnter[4];
+        const int mask = rayNode(node, r, *tBest, tEnter);
+        if (anyHit) {
+            for (int lane = 0; lane < 4; lane++) {
+                if (mask & (1 << lane)) stack[sp++] = StackEntry{node.child[lane], tEnter[lane]};
+            }
+        } else {
+            pushSorted(stack, &sp, node, mask, tEnter);
+        }
+    }
+    return found;
+}
+
+// Calls fn(leafIndex) for every primitive in leaves whose box overlaps `q`; fn returns true to stop.
+template <typename Fn>
+static void treeBoxQuery(const Tree& tree, const Box& q, Fn&& fn) {
+    if (tree.nodes.empty()) return;
+    uint32_t stack[kStackSize];
+    int sp = 0;
+    stack[sp++] = 0u;
+    while (sp > 0) {
+        const uint32_t ref = stack[--sp];
+        if (isLeaf(ref)) {
+            const int first = leafFirst(ref);
+            const int last = first + leafCount(ref);
+            for (int i = first; i < last; i++) {
+                if (fn(i)) return;
+            }
+            continue;
+        }
+        const Node4& node = tree.nodes[ref];
+        const int mask = boxNode(node, q);
+        for (int lane = 0; lane < 4; lane++) {
+            if (mask & (1 << lane)) stack[sp++] = node.child[lane];
+        }
+    }
+}
+
+static void meshSphere(const g4f_bvh_mesh* mesh, const g4f_mat4* toWorld, const Box& localBox, const float* center, float radius,
+                       int instance, SphereHits& out) {
+    const float r2 = radius * radius;
+    treeBoxQuery(mesh->tree, localBox, [&](int i) {
+        const Tri& tri = mesh->tris[(size_t)i];
+        float v[3][3];
+        for (int k = 0; k < 3; k++) {
+            v[0][k] = tri.v0[k];
+            v[1][k] = tri.v0[k] + tri.e1[k];
+            v[2][k] = tri.v0[k] + tri.e2[k];
+        }
+        if (toWorld) {
+            float w[3][3];
+            for (int j = 0; j < 3; j++) transformPoint(*toWorld, v[j], w[j]);
+            if (pointTriangleDistSq(center, w[0], w[1], w[2]) <= r2) addSphereHit(out, instance, mesh->triangleIds[(size_t)i]);
+        } else if (pointTriangleDistSq(center, v[0], v[1], v[2]) <= r2) {
+            addSphereHit(out, instance, mesh->triangleIds[(size_t)i]);
+        }
+        return false;
+    });
+}
+
+static Box sphereBox(const float* c, float r) { return Box{{c[0] - r, c[1] - r, c[2] - r}, {c[0] + r, c[1] + r, c[2] + r}}; }
+
+} // namespace
+
+g4f_bvh_mesh_desc g4f_bvh_mesh_desc_default(void) {
+    g4f_bvh_mesh_desc d{};
+    d.positionStride = (int)(3 * sizeof(float));
+    d.maxLeafTriangles = 4;
+    return d;
+}
+
+g4f_bvh_mesh* g4f_bvh_mesh_create(const g4f_bvh_mesh_desc* desc) {
+    if (!desc || !desc->positions || desc->vertexCount <= 0) {
+        g4f_set_last_error("g4f_bvh_mesh_create: invalid desc");
+        return nullptr;
+    }
+    const int stride = desc->positionStride > 0 ? desc->positionStride : (int)(3 * sizeof(float));
+    const int maxLeaf = desc->maxLeafTriangles > 0 ? desc->maxLeafTriangles : 4;
+    if (stride < (int)(3 * sizeof(float)) || maxLeaf > kMaxLeafLimit) {
+        g4f_set_last_error("g4f_bvh_mesh_create: invalid stride or leaf size");
+        return nullptr;
+    }
+    const bool indexed = desc->indices32 || desc->indices16;
+    const int indexCount = indexed ? desc->indexCount : desc->vertexCount;
+    if (indexCount <= 0 || indexCount % 3 != 0 || indexCount / 3 > kMaxPrimitives) {
+        g4f_set_last_error("g4f_bvh_mesh_create: index count must be a positive multiple of 3");
+        return nullptr;
+    }
+
+    const auto* bytes = static_cast<const unsigned char*>(desc->positions);
+    auto vertex = [&](int i) { return reinterpret_cast<const float*>(bytes + (size_t)i * (size_t)stride); };
+    auto index = [&](int i) -> int64_t {
+        if (desc->indices32) return desc->indices32[i];
+        if (desc->indices16) return desc->indices16[i];
+        return i;
+    };
+
+    const int triCount = indexCount / 3;
+    std::vector<Tri> tris((size_t)triCount);
+    std::vector<Box> boxes((size_t)triCount);
+    std::vector<float> centroids((size_t)triCount * 3);
+    for (int t = 0; t < triCount; t++) {
+        const float* v[3];
+        for (int j = 0; j < 3; j++) {
+            const int64_t vi = index(t * 3 + j);
+            if (vi < 0 || vi >= desc->vertexCount) {
+                g4f_set_last_error("g4f_bvh_mesh_create: index out of range");
+                return nullptr;
+            }
+            v[j] = vertex((int)vi);
+        }
+        Tri& tri = tris[(size_t)t];
+        Box& box = boxes[(size_t)t];
+        box = emptyBox();
+        for (int k = 0; k < 3; k++) {
+            tri.v0[k] = v[0][k];
+            tri.e1[k] = v[1][k] - v[0][k];
+            tri.e2[k] = v[2][k] - v[0][k];
+        }
+        for (int j = 0; j < 3; j++) boxGrow(box, v[j]);
+        for (int k = 0; k < 3; k++) centroids[(size_t)t * 3 + (size_t)k] = (box.mn[k] + box.mx[k]) * 0.5f;
+    }
+
+    auto* mesh = new g4f_bvh_mesh();
+    buildTree(mesh->tree, boxes, centroids, maxLeaf);
+    mesh->tris.resize((size_t)triCount);
+    mesh->triangleIds = mesh->tree.order;
+    for (int i = 0; i < triCount; i++) mesh->tris[(size_t)i] = tris[(size_t)mesh->tree.order[(size_t)i]];
+    return mesh;
+}
+
+void g4f_bvh_mesh_destroy(g4f_bvh_mesh* mesh) {
+    delete mesh;
+}
+
+void g4f_bvh_mesh_bounds(const g4f_bvh_mesh* mesh, g4f_vec3* outMin, g4f_vec3* outMax) {
+    const Box b = mesh ? mesh->tree.bounds : Box{{0.0f, 0.0f, 0.0f}, {0.0f, 0.0f, 0.0f}};
+    if (outMin) *outMin = g4f_vec3{b.mn[0], b.mn[1], b.mn[2]};
+    if (outMax) *outMax = g4f_vec3{b.mx[0], b.mx[1], b.mx[2]};
+}
+
+void g4f_bvh_mesh_get_stats(const g4f_bvh_mesh* mesh, g4f_bvh_stats* out) {
+    if (!out) return;
+    *out = g4f_bvh_stats{};
+    if (mesh) fillStats(mesh->tree, out);
+}
+
+int g4f_bvh_mesh_raycast(const g4f_bvh_mesh* mesh, g4f_vec3 origin, g4f_vec3 dir, float tMax, g4f_bvh_hit* hit) {
+    if (!mesh) return 0;
+    const float o[3] = {origin.x, origin.y, origin.z};
+    const float d[3] = {dir.x, dir.y, dir.z};
+    g4f_bvh_hit h{-1.0f, -1, -1, 0.0f, 0.0f};
+    float tBest = tMax;
+    if (!meshRay(mesh, makeRay(o, d), false, &tBest, &h)) return 0;
+    if (hit) *hit = h;
+    return 1;
+}
+
+int g4f_bvh_mesh_segment_blocked(const g4f_bvh_mesh* mesh, g4f_vec3 a, g4f_vec3 b) {
+    if (!mesh) return 0;
+    const float o[3] = {a.x, a.y, a.z};
+    const float d[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+    g4f_bvh_hit h{};
+    float tBest = 1.0f;
+    return meshRay(mesh, makeRay(o, d), true, &tBest, &h) ? 1 : 0;
+}
+
+int g4f_bvh_mesh_overlap_sphere(const g4f_bvh_mesh* mesh, g4f_vec3 center, float radius, g4f_bvh_hit* hits, int maxHits) {
+    if (!mesh || !(radius >= 0.0f)) return 0;
+    const float c[3] = {center.x, center.y, center.z};
+    SphereHits out{hits, hits ? maxHits : 0, 0};
+    meshSphere(mesh, nullptr, sphereBox(c, radius), c, radius, -1, out);
+    return out.count;
+}
+
+void g4f_bvh_mesh_query_box(const g4f_bvh_mesh* mesh, g4f_vec3 boxMin, g4f_vec3 boxMax, g4f_bvh_triangle_fn fn, void* user) {
+    if (!mesh || !fn) return;
+    const Box q{{boxMin.x, boxMin.y, boxMin.z}, {boxMax.x, boxMax.y, boxMax.z}};
+    treeBoxQuery(mesh->tree, q, [&](int i) {
+        const Tri& tri = mesh->tris[(size_t)i];
+        const g4f_vec3 v[3] = {
+            g4f_vec3{tri.v0[0], tri.v0[1], tri.v0[2]},
+            g4f_vec3{tri.v0[0] + tri.e1[0], tri.v0[1] + tri.e1[1], tri.v0[2] + tri.e1[2]},
+            g4f_vec3{tri.v0[0] + tri.e2[0], tri.v0[1] + tri.e2[1], tri.v0[2] + tri.e2[2]},
+        };
+        return fn(user, mesh->triangleIds[(size_t)i], v) != 0;
+    });
+}
+
+// ---- Scene (top level) ----
+
+namespace {
+
+struct Instance {
+    const g4f_bvh_mesh* mesh = nullptr;
+    g4f_mat4 transform{};
+    g4f_mat4 inverse{};
+    Box bounds = emptyBox();
+    bool alive = false;
+    bool moved = false;
+};
+
+} // namespace
+
+struct g4f_bvh_scene {
+    std::vector<Instance> instances;
+    std::vector<int> freeIds;
+    std::vector<int> moved;
+    Tree tree; // leaf primitives are instance ids
+};
+
+namespace {
+
+static void updateInstanceBounds(Instance& inst) {
+    inst.bounds = inst.alive ? transformBox(inst.transform, inst.mesh->tree.bounds) : emptyBox();
+}
+
+static bool instanceValid(const g4f_bvh_scene* scene, int instance) {
+    return scene && instance >= 0 && instance < (int)scene->instances.size() && scene->instances[(size_t)instance].alive;
+}
+
+// Closest (or any) hit over all instances: the ray is moved into each mesh's space, where t is
+// unchanged because dir is transformed without renormalizing.
+static bool sceneRay(const g4f_bvh_scene* scene, const float* o, const float* d, float tMax, bool anyHit, g4f_bvh_hit* hit) {
+    const Tree& tree = scene->tree;
+    if (tree.nodes.empty()) return false;
+    const Ray r = makeRay(o, d);
+    float tBest = tMax;
+    StackEntry stack[kStackSize];
+    int sp = 0;
+    stack[sp++] = StackEntry{0u, 0.0f};
+    bool found = false;
+    while (sp > 0) {
+        const StackEntry e = stack[--sp];
+        if (e.t > tBest) continue;
+        if (isLeaf(e.ref)) {
+            const int first = leafFirst(e.ref);
+            const int last = first + leafCount(e.ref);
+            for (int i = first; i < last; i++) {
+                const int id = tree.order[(size_t)i];
+                const Instance& inst = scene->instances[(size_t)id];
+                if (!inst.alive) continue;
+                float lo[3], ld[3];
+                transformPoint(inst.inverse, o, lo);
+                transformVector(inst.inverse, d, ld);
+                if (!meshRay(inst.mesh, makeRay(lo, ld), anyHit, &tBest, hit)) continue;
+                hit->instance = id;
+                found = true;
+                if (anyHit) return true;
+            }
+            continue;
+        }
+        const Node4& node = tree.nodes[e.ref];
+        alignas(16) float tEnter[4];
+        const int mask = rayNode(node, r, tBest, tEnter);
+        if (anyHit) {
+            for (int lane = 0; lane < 4; lane++) {
+                if (mask & (1 << lane)) stack[sp++] = StackEntry{node.child[lane], tEnter[lane]};
+            }
+        } else {
+            pushSorted(stack, &sp, node, mask, tEnter);
+        }
+    }
+    return found;
+}
+
+struct BatchJob {
+    const g4f_bvh_scene* scene;
+    const g4f_bvh_ray* rays;
+    g4f_bvh_hit* hits;
+    std::atomic<int> hitCount{0};
+};
+
+static void raycastBatchJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    auto* job = static_cast<BatchJob*>(user);
+    int local = 0;
+    for (int i = begin; i < end; i++) {
+        const g4f_bvh_ray& ray = job->rays[i];
+        const float o[3] = {ray.origin.x, ray.origin.y, ray.origin.z};
+        const float d[3] = {ray.dir.x, ray.dir.y, ray.dir.z};
+        g4f_bvh_hit h{-1.0f, -1, -1, 0.0f, 0.0f};
+        if (sceneRay(job->scene, o, d, ray.tMax, false, &h)) {
+            local++;
+        } else {
+            h = g4f_bvh_hit{-1.0f, -1, -1, 0.0f, 0.0f};
+        }
+        job->hits[i] = h;
+    }
+    job->hitCount.fetch_add(local, std::memory_order_relaxed);
+}
+
+} // namespace
+
+g4f_bvh_scene* g4f_bvh_scene_create(void) {
+    return new g4f_bvh_scene();
+}
+
+void g4f_bvh_scene_destroy(g4f_bvh_scene* scene) {
+    delete scene;
+}
+
+int g4f_bvh_scene_add(g4f_bvh_scene* scene, const g4f_bvh_mesh* mesh, const g4f_mat4* transform) {
+    if (!scene || !mesh) {
+        g4f_set_last_error("g4f_bvh_scene_add: invalid scene or mesh");
+        return -1;
+    }
+    int id;
+    if (!scene->freeIds.empty()) {
+        id = scene->freeIds.back();
+        scene->freeIds.pop_back();
+    } else {
+        if ((int)scene->instances.size() >= kMaxPrimitives) {
+            g4f_set_last_error("g4f_bvh_scene_add: too many instances");
+            return -1;
+        }
+        id = (int)scene->instances.size();
+        scene->instances.emplace_back();
+    }
+    Instance& inst = scene->instances[(size_t)id];
+    inst.mesh = mesh;
+    inst.transform = transform ? *transform : g4f_mat4_identity();
+    inst.inverse = g4f_mat4_inverse(inst.transform);
+    inst.alive = true;
+    updateInstanceBounds(inst);
+    // A reused id may still sit in the current tree; let the next refit pick up its bounds.
+    if (!inst.moved) {
+        inst.moved = true;
+        scene->moved.push_back(id);
+    }
+    return id;
+}
+
+void g4f_bvh_scene_remove(g4f_bvh_scene* scene, int instance) {
+    if (!instanceValid(scene, instance)) return;
+    Instance& inst = scene->instances[(size_t)instance];
+    inst.alive = false;
+    inst.mesh = nullptr;
+    updateInstanceBounds(inst);
+    scene->freeIds.push_back(instance);
+}
+
+void g4f_bvh_scene_set_transform(g4f_bvh_scene* scene, int instance, const g4f_mat4* transform) {
+    if (!instanceValid(scene, instance) || !transform) return;
+    Instance& inst = scene->instances[(size_t)instance];
+    inst.transform = *transform;
+    inst.inverse = g4f_mat4_inverse(*transform);
+    if (!inst.moved) {
+        inst.moved = true;
+        scene->moved.push_back(instance);
+    }
+}
+
+void g4f_bvh_scene_build(g4f_bvh_scene* scene) {
+    if (!scene) return;
+    for (int id : scene->moved) {
+        Instance& inst = scene->instances[(size_t)id];
+        inst.moved = false;
+        updateInstanceBounds(inst);
+    }
+    scene->moved.clear();
+
+    std::vector<int> ids;
+    std::vector<Box> boxes;
+    std::vector<float> centroids;
+    for (int id = 0; id < (int)scene->instances.size(); id++) {
+        const Instance& inst = scene->instances[(size_t)id];
+        if (!inst.alive) continue;
+        ids.push_back(id);
+        boxes.push_back(inst.bounds);
+        for (int k = 0; k < 3; k++) centroids.push_back((inst.bounds.mn[k] + inst.bounds.mx[k]) * 0.5f);
+    }
+    buildTree(scene->tree, boxes, centroids, 4);
+    for (int& p : scene->tree.order) p = ids[(size_t)p];
+}
+
+void g4f_bvh_scene_refit(g4f_bvh_scene* scene) {
+    if (!scene) return;
+    for (int id : scene->moved) {
+        Instance& inst = scene->instances[(size_t)id];
+        inst.moved = false;
+        updateInstanceBounds(inst);
+    }
+    scene->moved.clear();
+
+    Tree& tree = scene->tree;
+    // Children are stored after their parents, so a reverse sweep sees every child first.
+    for (int n = (int)tree.nodes.size() - 1; n >= 0; n--) {
+        Node4& node = tree.nodes[(size_t)n];
+        for (int lane = 0; lane < 4; lane++) {
+            const uint32_t ref = node.child[lane];
+            if (ref == kEmptyRef) continue;
+            Box box = emptyBox();
+            if (isLeaf(ref)) {
+                const int first = leafFirst(ref);
+                for (int i = first; i < first + leafCount(ref); i++) boxUnion(box, scene->instances[(size_t)tree.order[(size_t)i]].bounds);
+            } else {
+                const Node4& childNode = tree.nodes[ref];
+                for (int c = 0; c < 4; c++) {
+                    if (childNode.child[c] == kEmptyRef) continue;
+                    for (int k = 0; k < 3; k++) {
+                        box.mn[k] = std::min(box.mn[k], childNode.bmin[k][c]);
+                        box.mx[k] = std::max(box.mx[k], childNode.bmax[k][c]);
+                    }
+                }
+            }
+            setLane(node, lane, box, ref);
+        }
+    }
+    if (!tree.nodes.empty()) {
+        tree.bounds = emptyBox();
+        const Node4& root = tree.nodes[0];
+        for (int lane = 0; lane < 4; lane++) {
+            if (root.child[lane] == kEmptyRef) continue;
+            for (int k = 0; k < 3; k++) {
+                tree.bounds.mn[k] = std::min(tree.bounds.mn[k], root.bmin[k][lane]);
+                tree.bounds.mx[k] = std::max(tree.bounds.mx[k], root.bmax[k][lane]);
+            }
+        }
+    }
+}
+
+void g4f_bvh_scene_get_stats(const g4f_bvh_scene* scene, g4f_bvh_stats* out) {
+    if (!out) return;
+    *out = g4f_bvh_stats{};
+    if (scene) fillStats(scene->tree, out);
+}
+
+int g4f_bvh_scene_raycast(const g4f_bvh_scene* scene, g4f_vec3 origin, g4f_vec3 dir, float tMax, g4f_bvh_hit* hit) {
+    if (!scene) return 0;
+    const float o[3] = {origin.x, origin.y, origin.z};
+    const float d[3] = {dir.x, dir.y, dir.z};
+    g4f_bvh_hit h{-1.0f, -1, -1, 0.0f, 0.0f};
+    if (!sceneRay(scene, o, d, tMax, false, &h)) return 0;
+    if (hit) *hit = h;
+    return 1;
+}
+
+int g4f_bvh_scene_segment_blocked(const g4f_bvh_scene* scene, g4f_vec3 a, g4f_vec3 b) {
+    if (!scene) return 0;
+    const float o[3] = {a.x, a.y, a.z};
+    const float d[3] = {b.x - a.x, b.y - a.y, b.z - a.z};
+    g4f_bvh_hit h{};
+    return sceneRay(scene, o, d, 1.0f, true, &h) ? 1 : 0;
+}
+
+int g4f_bvh_scene_overlap_sphere(const g4f_bvh_scene* scene, g4f_vec3 center, float radius, g4f_bvh_hit* hits, int maxHits) {
+    if (!scene || !(radius >= 0.0f)) return 0;
+    const float c[3] = {center.x, center.y, center.z};
+    const Box worldBox = sphereBox(c, radius);
+    SphereHits out{hits, hits ? maxHits : 0, 0};
+    treeBoxQuery(scene->tree, worldBox, [&](int i) {
+        const int id = scene->tree.order[(size_t)i];
+        const Instance& inst = scene->instances[(size_t)id];
+        if (!inst.alive) return false;
+        meshSphere(inst.mesh, &inst.transform, transformBox(inst.inverse, worldBox), c, radius, id, out);
+        return false;
+    });
+    return out.count;
+}
+
+int g4f_bvh_scene_raycast_batch(const g4f_bvh_scene* scene, const g4f_bvh_ray* rays, int count, g4f_bvh_hit* hits, g4f_jobs* jobs) {
+    if (!scene || !rays || !hits || count <= 0) return 0;
+    BatchJob job{scene, rays, hits};
+    g4f_jobs_parallel_for(jobs, count, kParallelBatchGrain, raycastBatchJob, &job);
+    return job.hitCount.load();
+}
+
+g4f_bvh_ray g4f_bvh_ray_from_screen(const g4f_mat4* viewProj, float px, float py, float width, float height) {
+    g4f_bvh_ray ray{};
+    if (!viewProj || width <= 0.0f || height <= 0.0f) return ray;
+    const g4f_mat4 inv = g4f_mat4_inverse(*viewProj);
+    const float ndcX = px / width * 2.0f - 1.0f;
+    const float ndcY = 1.0f - py / height * 2.0f;
+    float ends[2][3];
+    for (int e = 0; e < 2; e++) {
+        const float p[4] = {ndcX, ndcY, (float)e, 1.0f};
+        float q[4];
+        for (int k = 0; k < 4; k++) q[k] = p[0] * inv.m[k] + p[1] * inv.m[4 + k] + p[2] * inv.m[8 + k] + p[3] * inv.m[12 + k];
+        const float invW = q[3] != 0.0f ? 1.0f / q[3] : 1.0f;
+        for (int k = 0; k < 3; k++) ends[e][k] = q[k] * invW;
+    }
+    ray.origin = g4f_vec3{ends[0][0], ends[0][1], ends[0][2]};
+    ray.dir = g4f_vec3{ends[1][0] - ends[0][0], ends[1][1] - ends[0][1], ends[1][2] - ends[0][2]};
+    ray.tMax = 1.0f;
+    return ray;
+}
@@ -46,8 +46,8 @@ g4f_camera_fps g4f_camera_fps_default(void) {
     return cam;
 }
 
-void g4f_camera_fps_update(g4f_camera_fps* cam, const g4f_window* window, float dtSeconds) {
-    if (!cam || !window) return;
+g4f_vec3 g4f_camera_fps_update_look(g4f_camera_fps* cam, const g4f_window* window, float dtSeconds) {
+    if (!cam || !window) return g4f_vec3{0.0f, 0.0f, 0.0f};
     if (dtSeconds < 0.0f) dtSeconds = 0.0f;
     if (dtSeconds > 0.25f) dtSeconds = 0.25f;
 
@@ -75,10 +75,13 @@ void g4f_camera_fps_update(g4f_camera_fps* cam, const g4f_window* window, float
     if (g4f_key_down(window, G4F_KEY_LEFT_CONTROL) || g4f_key_down(window, G4F_KEY_RIGHT_CONTROL)) wish = vec3Sub(wish, worldUp);
 
     float len2 = vec3Dot(wish, wish);
-    if (len2 > 0.0f) {
-        wish = vec3Normalize(wish);
-        cam->position = vec3Add(cam->position, vec3Mul(wish, speed * dtSeconds));
-    }
+    if (len2 <= 0.0f) return g4f_vec3{0.0f, 0.0f, 0.0f};
+    return vec3Mul(vec3Normalize(wish), speed * dtSeconds);
+}
+
+void g4f_camera_fps_update(g4f_camera_fps* cam, const g4f_window* window, float dtSeconds) {
+    if (!cam || !window) return;
+    cam->position = vec3Add(cam->position, g4f_camera_fps_update_look(cam, window, dtSeconds));
 }
 
 g4f_mat4 g4f_camera_fps_view(const g4f_camera_fps* cam) {
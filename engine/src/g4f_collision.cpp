@@ -0,0 +1,654 @@
+#include "../include/g4f/g4f_collision.h"
+
+#include "g4f_error_internal.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxCellsPerBody = 64; // larger bodies are tested against everyone instead
+constexpr int kCellBits = 21;
+constexpr int kCellLimit = (1 << (kCellBits - 1)) - 1;
+constexpr int kResolveIterations = 4;
+constexpr int kMaxSubsteps = 64;
+constexpr int kMaxCharacterContacts = 16;
+constexpr float kSkin = 1e-4f;
+
+static g4f_vec3 vec3Add(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.x + b.x, a.y + b.y, a.z + b.z}; }
+static g4f_vec3 vec3Sub(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+static g4f_vec3 vec3Mul(g4f_vec3 a, float s) { return g4f_vec3{a.x * s, a.y * s, a.z * s}; }
+static float vec3Dot(g4f_vec3 a, g4f_vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static float vec3Len(g4f_vec3 a) { return std::sqrt(vec3Dot(a, a)); }
+
+static g4f_vec3 vec3Cross(g4f_vec3 a, g4f_vec3 b) {
+    return g4f_vec3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x};
+}
+
+static g4f_vec3 vec3Normalize(g4f_vec3 v) {
+    const float len = vec3Len(v);
+    return len > 0.0f ? vec3Mul(v, 1.0f / len) : g4f_vec3{0.0f, 0.0f, 0.0f};
+}
+
+static bool boxesOverlap(const g4f_aabb& a, const g4f_aabb& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z &&
+           b.min.z <= a.max.z;
+}
+
+static bool boxValid(const g4f_aabb& b) {
+    return b.min.x <= b.max.x && b.min.y <= b.max.y && b.min.z <= b.max.z;
+}
+
+// Hash-grid cell coordinate, clamped so keys never alias; clamping only merges far-away cells,
+// which costs extra candidate tests but never a missed or duplicated pair.
+static int cellCoord(float v, float invCell) {
+    const float c = std::floor(v * invCell);
+    if (!(c > (float)-kCellLimit)) return -kCellLimit;
+    if (c > (float)kCellLimit) return kCellLimit;
+    return (int)c;
+}
+
+static uint64_t cellKey(int x, int y, int z) {
+    const uint64_t mask = (1ull << kCellBits) - 1ull;
+    return (((uint64_t)(x + kCellLimit) & mask) << (2 * kCellBits)) | (((uint64_t)(y + kCellLimit) & mask) << kCellBits) |
+           ((uint64_t)(z + kCellLimit) & mask);
+}
+
+struct CellEntry {
+    uint64_t key;
+    int body; // index into the sorted arrays
+};
+
+} // namespace
+
+struct g4f_broadphase {
+    g4f_broadphase_desc desc{};
+    std::vector<g4f_aabb> boxes;
+    std::vector<uint8_t> alive;
+    std::vector<int> freeIds;
+    std::vector<int> order;   // live bodies sorted by min.x, kept across updates
+    std::vector<int> removed; // ids leave the order on the next update before they are reused
+
+    // Per-update scratch: boxes in sweep order.
+    std::vector<g4f_aabb> sorted;
+    std::vector<float> minX;
+    std::vector<CellEntry> cells;
+    std::vector<int> large;
+    std::vector<g4f_broadphase_pair> pairs;
+    g4f_broadphase_stats stats{};
+};
+
+namespace {
+
+static void addPair(g4f_broadphase* bp, int i, int j) {
+    const int a = bp->order[(size_t)i];
+    const int b = bp->order[(size_t)j];
+    bp->pairs.push_back(a < b ? g4f_broadphase_pair{a, b} : g4f_broadphase_pair{b, a});
+}
+
+static void sweepAndPrune(g4f_broadphase* bp) {
+    const int n = (int)bp->sorted.size();
+    long long tests = 0;
+    for (int i = 0; i < n; i++) {
+        const g4f_aabb& a = bp->sorted[(size_t)i];
+        for (int j = i + 1; j < n && bp->minX[(size_t)j] <= a.max.x; j++) {
+            tests++;
+            const g4f_aabb& b = bp->sorted[(size_t)j];
+            if (a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z) addPair(bp, i, j);
+        }
+    }
+    bp->stats.tests = tests;
+}
+
+static void spatialHash(g4f_broadphase* bp) {
+    const int n = (int)bp->sorted.size();
+    float cell = bp->desc.cellSize;
+    if (!(cell > 0.0f)) {
+        double extent = 0.0;
+        for (const g4f_aabb& b : bp->sorted) {
+            extent += std::max(b.max.x - b.min.x, std::max(b.max.y - b.min.y, b.max.z - b.min.z));
+        }
+        cell = (float)(2.0 * extent / std::max(n, 1));
+        if (!(cell > 0.0f)) cell = 1.0f;
+    }
+    const float inv = 1.0f / cell;
+
+    bp->cells.clear();
+    bp->large.clear();
+    for (int i = 0; i < n; i++) {
+        const g4f_aabb& b = bp->sorted[(size_t)i];
+        const int x0 = cellCoord(b.min.x, inv), x1 = cellCoord(b.max.x, inv);
+        const int y0 = cellCoord(b.min.y, inv), y1 = cellCoord(b.max.y, inv);
+        const int z0 = cellCoord(b.min.z, inv), z1 = cellCoord(b.max.z, inv);
+        const long long span = (long long)(x1 - x0 + 1) * (y1 - y0 + 1) * (z1 - z0 + 1);
+        if (span > kMaxCellsPerBody) {
+            bp->large.push_back(i);
+            continue;
+        }
+        for (int z = z0; z <= z1; z++) {
+            for (int y = y0; y <= y1; y++) {
+                for (int x = x0; x <= x1; x++) bp->cells.push_back(CellEntry{cellKey(x, y, z), i});
+            }
+        }
+    }
+    std::sort(bp->cells.begin(), bp->cells.end(), [](const CellEntry& a, const CellEntry& b) {
+        return a.key != b.key ? a.key < b.key : a.body < b.body;
+    });
+
+    long long tests = 0;
+    const size_t count = bp->cells.size();
+    for (size_t g = 0; g < count;) {
+        size_t end = g + 1;
+        while (end < count && bp->cells[end].key == bp->cells[g].key) end++;
+        const uint64_t key = bp->cells[g].key;
+        for (size_t p = g; p < end; p++) {
+            const int i = bp->cells[p].body;
+            const g4f_aabb& a = bp->sorted[(size_t)i];
+            for (size_t q = p + 1; q < end; q++) {
+                const int j = bp->cells[q].body;
+                const g4f_aabb& b = bp->sorted[(size_t)j];
+                tests++;
+                if (!boxesOverlap(a, b)) continue;
+                // Report the pair only from the cell holding the overlap's min corner.
+                const uint64_t owner = cellKey(cellCoord(std::max(a.min.x, b.min.x), inv), cellCoord(std::max(a.min.y, b.min.y), inv),
+                                               cellCoord(std::max(a.min.z, b.min.z), inv));
+                if (owner == key) addPair(bp, i, j);
+            }
+        }
+        g = end;
+    }
+
+    // Large bodies against everything (pairs of two large bodies once).
+    for (size_t k = 0; k < bp->large.size(); k++) {
+        const int i = bp->large[k];
+        const g4f_aabb& a = bp->sorted[(size_t)i];
+        for (int j = 0; j < n; j++) {
+            if (j == i) continue;
+            const bool otherLarge = std::binary_search(bp->large.begin(), bp->large.end(), j);
+            if (otherLarge && j < i) continue;
+            tests++;
+            if (boxesOverlap(a, bp->sorted[(size_t)j])) addPair(bp, i, j);
+        }
+    }
+    bp->stats.tests = tests;
+}
+
+} // namespace
+
+g4f_broadphase_desc g4f_broadphase_desc_default(void) {
+    g4f_broadphase_desc d{};
+    d.mode = G4F_BROADPHASE_AUTO;
+    d.cellSize = 0.0f;
+    d.denseCandidates = 16.0f;
+    return d;
+}
+
+g4f_broadphase* g4f_broadphase_create(const g4f_broadphase_desc* desc) {
+    g4f_broadphase_desc d = desc ? *desc : g4f_broadphase_desc_default();
+    if (d.mode < G4F_BROADPHASE_AUTO || d.mode > G4F_BROADPHASE_GRID || d.cellSize < 0.0f) {
+        g4f_set_last_error("g4f_broadphase_create: invalid desc");
+        return nullptr;
+    }
+    if (!(d.denseCandidates > 0.0f)) d.denseCandidates = 16.0f;
+    auto* bp = new g4f_broadphase();
+    bp->desc = d;
+    return bp;
+}
+
+void g4f_broadphase_destroy(g4f_broadphase* bp) {
+    delete bp;
+}
+
+int g4f_broadphase_add(g4f_broadphase* bp, const g4f_aabb* box) {
+    if (!bp || !box || !boxValid(*box)) {
+        g4f_set_last_error("g4f_broadphase_add: invalid broadphase or box");
+        return -1;
+    }
+    int id;
+    if (!bp->freeIds.empty()) {
+        id = bp->freeIds.back();
+        bp->freeIds.pop_back();
+    } else {
+        id = (int)bp->boxes.size();
+        bp->boxes.emplace_back();
+        bp->alive.push_back(0);
+    }
+    bp->boxes[(size_t)id] = *box;
+    bp->alive[(size_t)id] = 1;
+    bp->order.push_back(id); // the next update's insertion sort moves it into place
+    return id;
+}
+
+void g4f_broadphase_move(g4f_broadphase* bp, int body, const g4f_aabb* box) {
+    if (!bp || !box || body < 0 || body >= (int)bp->boxes.size() || !bp->alive[(size_t)body] || !boxValid(*box)) return;
+    bp->boxes[(size_t)body] = *box;
+}
+
+void g4f_broadphase_remove(g4f_broadphase* bp, int body) {
+    if (!bp || body < 0 || body >= (int)bp->boxes.size() || !bp->alive[(size_t)body]) return;
+    bp->alive[(size_t)body] = 0;
+    bp->removed.push_back(body);
+}
+
+int g4f_broadphase_update(g4f_broadphase* bp) {
+    if (!bp) return 0;
+    if (!bp->removed.empty()) {
+        std::vector<int>& order = bp->order;
+        order.erase(std::remove_if(order.begin(), order.end(), [&](int id) { return !bp->alive[(size_t)id]; }), order.end());
+        bp->freeIds.insert(bp->freeIds.end(), bp->removed.begin(), bp->removed.end());
+        bp->removed.clear();
+    }
+
+    // Insertion sort on min.x: bodies move little between frames, so this is nearly linear.
+    std::vector<int>& order = bp->order;
+    const int n = (int)order.size();
+    int swaps = 0;
+    for (int i = 1; i < n; i++) {
+        const int id = order[(size_t)i];
+        const float key = bp->boxes[(size_t)id].min.x;
+        int j = i - 1;
+        while (j >= 0 && bp->boxes[(size_t)order[(size_t)j]].min.x > key) {
+            order[(size_t)j + 1] = order[(size_t)j];
+            j--;
+            swaps++;
+        }
+        order[(size_t)j + 1] = id;
+    }
+
+    bp->sorted.resize((size_t)n);
+    bp->minX.resize((size_t)n);
+    for (int i = 0; i < n; i++) {
+        bp->sorted[(size_t)i] = bp->boxes[(size_t)order[(size_t)i]];
+        bp->minX[(size_t)i] = bp->sorted[(size_t)i].min.x;
+    }
+
+    // Exact sort-and-sweep candidate count from the sorted starts, without enumerating pairs.
+    long long xOverlaps = 0;
+    for (int i = 0; i < n; i++) {
+        const auto end = std::upper_bound(bp->minX.begin() + i + 1, bp->minX.end(), bp->sorted[(size_t)i].max.x);
+        xOverlaps += (long long)(end - (bp->minX.begin() + i + 1));
+    }
+
+    const bool useGrid = bp->desc.mode == G4F_BROADPHASE_GRID ||
+                         (bp->desc.mode == G4F_BROADPHASE_AUTO && (double)xOverlaps > (double)bp->desc.denseCandidates * n);
+    bp->pairs.clear();
+    if (useGrid) {
+        spatialHash(bp);
+    } else {
+        sweepAndPrune(bp);
+    }
+    std::sort(bp->pairs.begin(), bp->pairs.end(), [](const g4f_broadphase_pair& a, const g4f_broadphase_pair& b) {
+        return a.a != b.a ? a.a < b.a : a.b < b.b;
+    });
+
+    bp->stats.bodies = n;
+    bp->stats.pairs = (int)bp->pairs.size();
+    bp->stats.usedGrid = useGrid ? 1 : 0;
+    bp->stats.xOverlaps = xOverlaps;
+    bp->stats.swaps = swaps;
+    return (int)bp->pairs.size();
+}
+
+const g4f_broadphase_pair* g4f_broadphase_pairs(const g4f_broadphase* bp, int* count) {
+    if (count) *count = bp ? (int)bp->pairs.size() : 0;
+    return (bp && !bp->pairs.empty()) ? bp->pairs.data() : nullptr;
+}
+
+void g4f_broadphase_get_stats(const g4f_broadphase* bp, g4f_broadphase_stats* out) {
+    if (!out) return;
+    *out = bp ? bp->stats : g4f_broadphase_stats{};
+}
+
+// ---- Narrowphase ----
+
+namespace {
+
+// Closest point on triangle (a, b, c) to p (Voronoi region walk).
+static g4f_vec3 closestOnTriangle(g4f_vec3 p, g4f_vec3 a, g4f_vec3 b, g4f_vec3 c) {
+    const g4f_vec3 ab = vec3Sub(b, a);
+    const g4f_vec3 ac = vec3Sub(c, a);
+    const g4f_vec3 ap = vec3Sub(p, a);
+    const float d1 = vec3Dot(ab, ap);
+    const float d2 = vec3Dot(ac, ap);
+    if (d1 <= 0.0f && d2 <= 0.0f) return a;
+    const g4f_vec3 bp = vec3Sub(p, b);
+    const float d3 = vec3Dot(ab, bp);
+    const float d4 = vec3Dot(ac, bp);
+    if (d3 >= 0.0f && d4 <= d3) return b;
+    const float vc = d1 * d4 - d3 * d2;
+    if (vc <= 0.0f && d1 >= 0.0f && d3 <= 0.0f) return vec3Add(a, vec3Mul(ab, d1 / (d1 - d3)));
+    const g4f_vec3 cp = vec3Sub(p, c);
+    const float d5 = vec3Dot(ab, cp);
+    const float d6 = vec3Dot(ac, cp);
+    if (d6 >= 0.0f && d5 <= d6) return c;
+    const float vb = d5 * d2 - d1 * d6;
+    if (vb <= 0.0f && d2 >= 0.0f && d6 <= 0.0f) return vec3Add(a, vec3Mul(ac, d2 / (d2 - d6)));
+    const float va = d3 * d6 - d5 * d4;
+    if (va <= 0.0f && (d4 - d3) >= 0.0f && (d5 - d6) >= 0.0f) {
+        return vec3Add(b, vec3Mul(vec3Sub(c, b), (d4 - d3) / ((d4 - d3) + (d5 - d6))));
+    }
+    const float denom = 1.0f / (va + vb + vc);
+    return vec3Add(a, vec3Add(vec3Mul(ab, vb * denom), vec3Mul(ac, vc * denom)));
+}
+
+// Closest points between segments p1-q1 and p2-q2.
+static void closestSegmentSegment(g4f_vec3 p1, g4f_vec3 q1, g4f_vec3 p2, g4f_vec3 q2, g4f_vec3* c1, g4f_vec3* c2) {
+    const g4f_vec3 d1 = vec3Sub(q1, p1);
+    const g4f_vec3 d2 = vec3Sub(q2, p2);
+    const g4f_vec3 r = vec3Sub(p1, p2);
+    const float a = vec3Dot(d1, d1);
+    const float e = vec3Dot(d2, d2);
+    const float f = vec3Dot(d2, r);
+    float s = 0.0f;
+    float t = 0.0f;
+    if (a <= 1e-12f && e <= 1e-12f) {
+        // both degenerate
+    } else if (a <= 1e-12f) {
+        t = std::clamp(f / e, 0.0f, 1.0f);
+    } else {
+        const float c = vec3Dot(d1, r);
+        if (e <= 1e-12f) {
+            s = std::clamp(-c / a, 0.0f, 1.0f);
+        } else {
+            const float b = vec3Dot(d1, d2);
+            const float denom = a * e - b * b;
+            s = denom > 1e-12f ? std::clamp((b * f - c * e) / denom, 0.0f, 1.0f) : 0.0f;
+            t = (b * s + f) / e;
+            if (t < 0.0f) {
+                t = 0.0f;
+                s = std::clamp(-c / a, 0.0f, 1.0f);
+            } else if (t > 1.0f) {
+                t = 1.0f;
+                s = std::clamp((b - c) / a, 0.0f, 1.0f);
+            }
+        }
+    }
+    *c1 = vec3Add(p1, vec3Mul(d1, s));
+    *c2 = vec3Add(p2, vec3Mul(d2, t));
+}
+
+// Where segment p-q crosses the triangle, if it does.
+static bool segmentHitsTriangle(g4f_vec3 p, g4f_vec3 q, const g4f_vec3* v, g4f_vec3* hit) {
+    const g4f_vec3 d = vec3Sub(q, p);
+    const g4f_vec3 e1 = vec3Sub(v[1], v[0]);
+    const g4f_vec3 e2 = vec3Sub(v[2], v[0]);
+    const g4f_vec3 h = vec3Cross(d, e2);
+    const float det = vec3Dot(e1, h);
+    if (std::fabs(det) < 1e-12f) return false;
+    const float inv = 1.0f / det;
+    const g4f_vec3 s = vec3Sub(p, v[0]);
+    const float u = vec3Dot(s, h) * inv;
+    if (u < 0.0f || u > 1.0f) return false;
+    const g4f_vec3 qv = vec3Cross(s, e1);
+    const float w = vec3Dot(d, qv) * inv;
+    if (w < 0.0f || u + w > 1.0f) return false;
+    const float t = vec3Dot(e2, qv) * inv;
+    if (t < 0.0f || t > 1.0f) return false;
+    *hit = vec3Add(p, vec3Mul(d, t));
+    return true;
+}
+
+static g4f_vec3 triangleNormal(const g4f_vec3* v) {
+    return vec3Normalize(vec3Cross(vec3Sub(v[1], v[0]), vec3Sub(v[2], v[0])));
+}
+
+struct ContactSink {
+    g4f_contact* contacts;
+    int maxContacts;
+    int count;
+};
+
+static void addContact(ContactSink& sink, g4f_vec3 point, g4f_vec3 normal, float depth, int triangle) {
+    if (sink.count < sink.maxContacts) sink.contacts[sink.count] = g4f_contact{point, normal, depth, triangle};
+    sink.count++;
+}
+
+struct CapsuleQuery {
+    g4f_vec3 a;
+    g4f_vec3 b;
+    float radius;
+    ContactSink sink;
+};
+
+// Sphere and capsule contacts share this: a sphere is a capsule with a == b.
+static int capsuleTriangle(void* user, int triangle, const g4f_vec3* v) {
+    auto* q = static_cast<CapsuleQuery*>(user);
+    const float r = q->radius;
+    g4f_vec3 crossing;
+    if (segmentHitsTriangle(q->a, q->b, v, &crossing)) {
+        // The core segment pierces the triangle: push out along the face normal, on the side of
+        // the capsule's midpoint, far enough to clear the deeper end point.
+        g4f_vec3 n = triangleNormal(v);
+        const g4f_vec3 mid = vec3Mul(vec3Add(q->a, q->b), 0.5f);
+        if (vec3Dot(vec3Sub(mid, v[0]), n) < 0.0f) n = vec3Mul(n, -1.0f);
+        const float da = vec3Dot(vec3Sub(q->a, v[0]), n);
+        const float db = vec3Dot(vec3Sub(q->b, v[0]), n);
+        addContact(q->sink, crossing, n, r - std::min(da, db), triangle);
+        return 0;
+    }
+
+    // Closest pair among: segment end points vs the face, and the segment vs each edge.
+    g4f_vec3 bestSeg = q->a;
+    g4f_vec3 bestTri = closestOnTriangle(q->a, v[0], v[1], v[2]);
+    float best = vec3Dot(vec3Sub(bestSeg, bestTri), vec3Sub(bestSeg, bestTri));
+    auto consider = [&](g4f_vec3 s, g4f_vec3 t) {
+        const g4f_vec3 d = vec3Sub(s, t);
+        const float d2 = vec3Dot(d, d);
+        if (d2 < best) {
+            best = d2;
+            bestSeg = s;
+            bestTri = t;
+        }
+    };
+    if (q->b.x != q->a.x || q->b.y != q->a.y || q->b.z != q->a.z) {
+        consider(q->b, closestOnTriangle(q->b, v[0], v[1], v[2]));
+        for (int e = 0; e < 3; e++) {
+            g4f_vec3 s, t;
+            closestSegmentSegment(q->a, q->b, v[e], v[(e + 1) % 3], &s, &t);
+            consider(s, t);
+        }
+    }
+    if (best > r * r) return 0;
+    const float dist = std::sqrt(best);
+    g4f_vec3 n;
+    if (dist > 1e-6f) {
+        n = vec3Mul(vec3Sub(bestSeg, bestTri), 1.0f / dist);
+    } else {
+        n = triangleNormal(v);
+    }
+    addContact(q->sink, bestTri, n, r - dist, triangle);
+    return 0;
+}
+
+struct BoxQuery {
+    g4f_vec3 center;
+    g4f_vec3 half;
+    ContactSink sink;
+};
+
+// Separating-axis test of a box against a triangle (box axes, face normal, 9 edge crosses).
+static int boxTriangle(void* user, int triangle, const g4f_vec3* vIn) {
+    auto* q = static_cast<BoxQuery*>(user);
+    const g4f_vec3 v[3] = {vec3Sub(vIn[0], q->center), vec3Sub(vIn[1], q->center), vec3Sub(vIn[2], q->center)};
+    const g4f_vec3 edges[3] = {vec3Sub(v[1], v[0]), vec3Sub(v[2], v[1]), vec3Sub(v[0], v[2])};
+    const g4f_vec3 boxAxes[3] = {{1.0f, 0.0f, 0.0f}, {0.0f, 1.0f, 0.0f}, {0.0f, 0.0f, 1.0f}};
+
+    g4f_vec3 axes[13];
+    int axisCount = 0;
+    for (const g4f_vec3& a : boxAxes) axes[axisCount++] = a;
+    axes[axisCount++] = vec3Cross(edges[0], edges[1]);
+    for (const g4f_vec3& a : boxAxes) {
+        for (const g4f_vec3& e : edges) axes[axisCount++] = vec3Cross(a, e);
+    }
+
+    float bestDepth = FLT_MAX;
+    g4f_vec3 bestNormal{0.0f, 1.0f, 0.0f};
+    for (int i = 0; i < axisCount; i++) {
+        const float len = vec3Len(axes[i]);
+        if (len < 1e-8f) continue;
+        const g4f_vec3 l = vec3Mul(axes[i], 1.0f / len);
+        const float p0 = vec3Dot(v[0], l), p1 = vec3Dot(v[1], l), p2 = vec3Dot(v[2], l);
+        const float pMin = std::min(p0, std::min(p1, p2));
+        const float pMax = std::max(p0, std::max(p1, p2));
+        const float r = q->half.x * std::fabs(l.x) + q->half.y * std::fabs(l.y) + q->half.z * std::fabs(l.z);
+        if (pMin > r || pMax < -r) return 0; // separating axis
+        // Moving the box along +l by (pMax + r), or along -l by (r - pMin), separates it.
+        const float up = pMax + r;
+        const float down = r - pMin;
+        if (up < bestDepth) {
+            bestDepth = up;
+            bestNormal = l;
+        }
+        if (down < bestDepth) {
+            bestDepth = down;
+            bestNormal = vec3Mul(l, -1.0f);
+        }
+    }
+    addContact(q->sink, closestOnTriangle(q->center, vIn[0], vIn[1], vIn[2]), bestNormal, bestDepth, triangle);
+    return 0;
+}
+
+static int collideCapsule(const g4f_bvh_mesh* mesh, g4f_vec3 a, g4f_vec3 b, float radius, g4f_contact* contacts, int maxContacts) {
+    if (!mesh || !(radius >= 0.0f)) return 0;
+    CapsuleQuery q{a, b, radius, ContactSink{contacts, contacts ? maxContacts : 0, 0}};
+    const g4f_vec3 lo{std::min(a.x, b.x) - radius, std::min(a.y, b.y) - radius, std::min(a.z, b.z) - radius};
+    const g4f_vec3 hi{std::max(a.x, b.x) + radius, std::max(a.y, b.y) + radius, std::max(a.z, b.z) + radius};
+    g4f_bvh_mesh_query_box(mesh, lo, hi, capsuleTriangle, &q);
+    return q.sink.count;
+}
+
+} // namespace
+
+int g4f_collide_sphere_mesh(const g4f_bvh_mesh* mesh, g4f_vec3 center, float radius, g4f_contact* contacts, int maxContacts) {
+    return collideCapsule(mesh, center, center, radius, contacts, maxContacts);
+}
+
+int g4f_collide_capsule_mesh(const g4f_bvh_mesh* mesh, g4f_vec3 a, g4f_vec3 b, float radius, g4f_contact* contacts, int maxContacts) {
+    return collideCapsule(mesh, a, b, radius, contacts, maxContacts);
+}
+
+int g4f_collide_aabb_mesh(const g4f_bvh_mesh* mesh, const g4f_aabb* box, g4f_contact* contacts, int maxContacts) {
+    if (!mesh || !box || !boxValid(*box)) return 0;
+    BoxQuery q{vec3Mul(vec3Add(box->min, box->max), 0.5f), vec3Mul(vec3Sub(box->max, box->min), 0.5f),
+               ContactSink{contacts, contacts ? maxContacts : 0, 0}};
+    g4f_bvh_mesh_query_box(mesh, box->min, box->max, boxTriangle, &q);
+    return q.sink.count;
+}
+
+// ---- Character controller ----
+
+g4f_character_desc g4f_character_desc_default(void) {
+    g4f_character_desc d{};
+    d.radius = 0.3f;
+    d.height = 1.8f;
+    d.eyeHeight = 1.6f;
+    d.maxSlopeCos = 0.6427876f; // cos(50 degrees)
+    d.gravity = 20.0f;
+    d.jumpSpeed = 6.0f;
+    d.flying = 0;
+    return d;
+}
+
+void g4f_character_init(g4f_character* ch, const g4f_character_desc* desc, g4f_vec3 feet) {
+    if (!ch) return;
+    const g4f_character_desc defaults = g4f_character_desc_default();
+    g4f_character_desc d = desc ? *desc : defaults;
+    if (!(d.radius > 0.0f)) d.radius = defaults.radius;
+    if (!(d.height > 0.0f)) d.height = defaults.height;
+    if (d.height < 2.0f * d.radius) d.height = 2.0f * d.radius;
+    if (!(d.eyeHeight > 0.0f)) d.eyeHeight = defaults.eyeHeight;
+    if (!(d.maxSlopeCos > 0.0f)) d.maxSlopeCos = defaults.maxSlopeCos;
+    if (!(d.gravity > 0.0f)) d.gravity = defaults.gravity;
+    if (!(d.jumpSpeed > 0.0f)) d.jumpSpeed = defaults.jumpSpeed;
+    *ch = g4f_character{};
+    ch->desc = d;
+    ch->position = feet;
+}
+
+g4f_vec3 g4f_character_move(g4f_character* ch, const g4f_bvh_mesh* world, g4f_vec3 displacement) {
+    if (!ch) return g4f_vec3{0.0f, 0.0f, 0.0f};
+    const g4f_vec3 start = ch->position;
+    if (!world) {
+        ch->position = vec3Add(ch->position, displacement);
+        return displacement;
+    }
+    const float r = ch->desc.radius;
+    const float len = vec3Len(displacement);
+    const int steps = std::clamp((int)std::ceil(len / (0.5f * r)), 1, kMaxSubsteps);
+    g4f_vec3 step = vec3Mul(displacement, 1.0f / (float)steps);
+
+    g4f_contact contacts[kMaxCharacterContacts];
+    for (int s = 0; s < steps; s++) {
+        ch->position = vec3Add(ch->position, step);
+        for (int iter = 0; iter < kResolveIterations; iter++) {
+            const g4f_vec3 a{ch->position.x, ch->position.y + r, ch->position.z};
+            const g4f_vec3 b{ch->position.x, ch->position.y + ch->desc.height - r, ch->position.z};
+            const int count = std::min(collideCapsule(world, a, b, r, contacts, kMaxCharacterContacts), kMaxCharacterContacts);
+            int deepest = -1;
+            for (int i = 0; i < count; i++) {
+                if (contacts[i].depth > kSkin && (deepest < 0 || contacts[i].depth > contacts[deepest].depth)) deepest = i;
+            }
+            if (deepest < 0) break;
+            const g4f_contact& c = contacts[deepest];
+            const bool ground = c.normal.y >= ch->desc.maxSlopeCos;
+            if (ground) {
+                // Straight up by the amount that clears the slope, so standing still on a ramp stays put.
+                ch->position.y += (c.depth + kSkin) / c.normal.y;
+                ch->grounded = 1;
+                if (ch->velocity.y < 0.0f) ch->velocity.y = 0.0f;
+            } else {
+                ch->position = vec3Add(ch->position, vec3Mul(c.normal, c.depth + kSkin));
+                if (c.normal.y < -0.5f && ch->velocity.y > 0.0f) ch->velocity.y = 0.0f; // head hit a ceiling
+            }
+            // Slide: drop the rest of the motion that goes into the surface.
+            const float into = vec3Dot(step, c.normal);
+            if (into < 0.0f) step = vec3Sub(step, vec3Mul(c.normal, into));
+        }
+    }
+    return vec3Sub(ch->position, start);
+}
+
+void g4f_character_step(g4f_character* ch, const g4f_bvh_mesh* world, g4f_vec3 wishVelocity, int jump, float dtSeconds) {
+    if (!ch) return;
+    if (dtSeconds < 0.0f) dtSeconds = 0.0f;
+    if (dtSeconds > 0.25f) dtSeconds = 0.25f;
+    g4f_vec3 displacement;
+    if (ch->desc.flying) {
+        ch->velocity = wishVelocity;
+        displacement = vec3Mul(wishVelocity, dtSeconds);
+    } else {
+        if (jump && ch->grounded) {
+            ch->velocity.y = ch->desc.jumpSpeed;
+        } else {
+            ch->velocity.y -= ch->desc.gravity * dtSeconds;
+        }
+        ch->velocity.x = wishVelocity.x;
+        ch->velocity.z = wishVelocity.z;
+        displacement = vec3Mul(ch->velocity, dtSeconds);
+    }
+    ch->grounded = 0;
+    g4f_character_move(ch, world, displacement);
+}
+
+void g4f_character_update_fps(g4f_character* ch, g4f_camera_fps* cam, const g4f_window* window, const g4f_bvh_mesh* world, float dtSeconds) {
+    if (!ch || !cam || !window) return;
+    g4f_vec3 move = g4f_camera_fps_update_look(cam, window, dtSeconds);
+    g4f_vec3 wish{0.0f, 0.0f, 0.0f};
+    int jump = 0;
+    if (dtSeconds > 0.0f) {
+        const float dt = std::min(dtSeconds, 0.25f);
+        if (ch->desc.flying) {
+            wish = vec3Mul(move, 1.0f / dt);
+        } else {
+            // Walking ignores pitch: keep the full speed in the horizontal plane.
+            const float speed = vec3Len(move) / dt;
+            const g4f_vec3 flat = vec3Normalize(g4f_vec3{move.x, 0.0f, move.z});
+            wish = vec3Mul(flat, speed);
+            jump = g4f_key_pressed(window, G4F_KEY_SPACE);
+        }
+    }
+    g4f_character_step(ch, world, wish, jump, dtSeconds);
+    cam->position = g4f_vec3{ch->position.x, ch->position.y + ch->desc.eyeHeight, ch->position.z};
+}
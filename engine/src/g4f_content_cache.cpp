@@ -0,0 +1,334 @@
+#include "../include/g4f/g4f_content_cache.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_file_map_internal.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr char kMagic[4] = {'G', '4', 'F', 'C'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kDefaultMaxBytes = (uint64_t)512 << 20;
+// Bump when g4f_texsynth output changes for the same desc.
+constexpr uint32_t kTexsynthVersion = 1;
+
+struct EntryHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint64_t size;
+    uint64_t checksum;
+    uint8_t reserved[32]; // keeps the data 64-byte aligned in the mapping
+};
+
+static_assert(sizeof(EntryHeader) == 64, "cache entry header layout");
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+template <typename T>
+static uint64_t fnv1aValue(uint64_t h, T v) {
+    return fnv1a(h, &v, sizeof(v));
+}
+
+struct CacheEntry {
+    uint64_t fileBytes = 0;
+    uint64_t lastUse = 0;
+    g4f_file_map map;
+    bool mapped = false;
+};
+
+static std::atomic<uint64_t> g_tmpCounter{0};
+
+} // namespace
+
+struct g4f_content_cache {
+    std::filesystem::path dir;
+    uint64_t maxBytes = kDefaultMaxBytes;
+    bool verify = false;
+
+    mutable std::mutex mutex;
+    std::unordered_map<uint64_t, CacheEntry> entries;
+    uint64_t clock = 0;
+    g4f_content_cache_stats stats{};
+    std::vector<std::unique_ptr<uint8_t[]>> owned; // results that could not stay in the cache
+};
+
+static std::filesystem::path cacheEntryPath(const g4f_content_cache* cache, uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.g4fc", (unsigned long long)key);
+    return cache->dir / name;
+}
+
+static void cacheRemove(g4f_content_cache* cache, std::unordered_map<uint64_t, CacheEntry>::iterator it) {
+    std::error_code ec;
+    g4f_file_map_close(&it->second.map);
+    std::filesystem::remove(cacheEntryPath(cache, it->first), ec);
+    cache->stats.bytes -= it->second.fileBytes;
+    cache->stats.entries -= 1;
+    cache->entries.erase(it);
+}
+
+// Caller holds the mutex.
+static void cacheTrim(g4f_content_cache* cache) {
+    if (cache->stats.bytes <= cache->maxBytes) return;
+    std::vector<std::pair<uint64_t, uint64_t>> order; // lastUse, key
+    for (const auto& kv : cache->entries) {
+        if (!kv.second.mapped) order.push_back({kv.second.lastUse, kv.first});
+    }
+    std::sort(order.begin(), order.end());
+    for (const auto& o : order) {
+        if (cache->stats.bytes <= cache->maxBytes) break;
+        cacheRemove(cache, cache->entries.find(o.second));
+        cache->stats.evictions += 1;
+    }
+}
+
+uint64_t g4f_content_cache_key(const char* generatorId, uint32_t generatorVersion, const void* params, size_t paramsSize) {
+    if (!generatorId) generatorId = "";
+    uint64_t h = fnv1a(kFnvOffset, generatorId, std::strlen(generatorId) + 1);
+    h = fnv1aValue(h, generatorVersion);
+    h = fnv1aValue(h, (uint64_t)paramsSize);
+    return params ? fnv1a(h, params, paramsSize) : h;
+}
+
+uint64_t g4f_content_cache_key_append(uint64_t key, const void* bytes, size_t size) {
+    key = fnv1aValue(key, (uint64_t)size);
+    return bytes ? fnv1a(key, bytes, size) : key;
+}
+
+g4f_content_cache* g4f_content_cache_open(const g4f_content_cache_desc* desc) {
+    if (!desc || !desc->dirUtf8 || !desc->dirUtf8[0]) {
+        g4f_set_last_error("g4f_content_cache_open: invalid desc");
+        return nullptr;
+    }
+    auto* cache = new g4f_content_cache();
+    cache->dir = std::filesystem::path(std::u8string((const char8_t*)desc->dirUtf8));
+    if (desc->maxBytes > 0) cache->maxBytes = desc->maxBytes;
+    cache->verify = desc->verifyChecksums != 0;
+
+    std::error_code ec;
+    std::filesystem::create_directories(cache->dir, ec);
+    if (ec) {
+        g4f_set_last_errorf("g4f_content_cache_open: cannot create directory (%s)", ec.message().c_str());
+        delete cache;
+        return nullptr;
+    }
+
+    // Rebuild the index from the directory; modification times give the use order of previous runs.
+    struct Found {
+        std::filesystem::file_time_type time;
+        uint64_t key;
+        uint64_t bytes;
+    };
+    std::vector<Found> found;
+    std::vector<std::filesystem::path> stale;
+    for (std::filesystem::directory_iterator it(cache->dir, ec), end; !ec && it != end; it.increment(ec)) {
+        if (!it->is_regular_file(ec)) continue;
+        const std::string name = it->path().filename().string();
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            stale.push_back(it->path()); // left behind by a crashed put
+            continue;
+        }
+        unsigned long long key = 0;
+        char tail[8] = {};
+        if (name.size() != 21 || std::sscanf(name.c_str(), "%16llx.%4s", &key, tail) != 2 || std::strcmp(tail, "g4fc") != 0) continue;
+        const uint64_t bytes = (uint64_t)it->file_size(ec);
+        if (ec) continue;
+        found.push_back(Found{it->last_write_time(ec), (uint64_t)key, bytes});
+    }
+    for (const auto& p : stale) std::filesystem::remove(p, ec);
+    std::sort(found.begin(), found.end(), [](const Found& a, const Found& b) { return a.time != b.time ? a.time < b.time : a.key < b.key; });
+    for (const Found& f : found) {
+        CacheEntry& e = cache->entries[f.key];
+        e.fileBytes = f.bytes;
+        e.lastUse = ++cache->clock;
+        cache->stats.bytes += f.bytes;
+        cache->stats.entries += 1;
+    }
+    cacheTrim(cache);
+    return cache;
+}
+
+void g4f_content_cache_close(g4f_content_cache* cache) {
+    if (!cache) return;
+    for (auto& kv : cache->entries) g4f_file_map_close(&kv.second.map);
+    delete cache;
+}
+
+// `count` is false for the re-read after a put, which is neither a hit nor a miss.
+static const void* cacheGet(g4f_content_cache* cache, uint64_t key, size_t* outSize, bool count) {
+    if (outSize) *outSize = 0;
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->entries.find(key);
+    if (it == cache->entries.end()) {
+        if (count) cache->stats.misses += 1;
+        return nullptr;
+    }
+    CacheEntry& e = it->second;
+    if (!e.mapped) {
+        // Persist the use order for the next run before mapping the file.
+        const std::filesystem::path path = cacheEntryPath(cache, key);
+        std::error_code ec;
+        std::filesystem::last_write_time(path, std::filesystem::file_time_type::clock::now(), ec);
+
+        EntryHeader header{};
+        bool ok = g4f_file_map_open(&e.map, (const char*)path.u8string().c_str(), "g4f_content_cache_get") && e.map.size >= sizeof(header);
+        if (ok) {
+            std::memcpy(&header, e.map.data, sizeof(header));
+            ok = std::memcmp(header.magic, kMagic, sizeof(kMagic)) == 0 && header.version == kFormatVersion && header.key == key &&
+                 header.size == e.map.size - sizeof(header);
+        }
+        if (ok && cache->verify) ok = fnv1a(kFnvOffset, (const uint8_t*)e.map.data + sizeof(header), (size_t)header.size) == header.checksum;
+        if (!ok) {
+            cacheRemove(cache, it);
+            cache->stats.rejected += 1;
+            if (count) cache->stats.misses += 1;
+            return nullptr;
+        }
+        e.mapped = true;
+    }
+    e.lastUse = ++cache->clock;
+    const size_t size = e.map.size - sizeof(EntryHeader);
+    if (count) {
+        cache->stats.hits += 1;
+        cache->stats.hitBytes += size;
+    }
+    if (outSize) *outSize = size;
+    return (const uint8_t*)e.map.data + sizeof(EntryHeader);
+}
+
+const void* g4f_content_cache_get(g4f_content_cache* cache, uint64_t key, size_t* outSize) {
+    if (!cache) {
+        if (outSize) *outSize = 0;
+        return nullptr;
+    }
+    return cacheGet(cache, key, outSize, true);
+}
+
+int g4f_content_cache_put(g4f_content_cache* cache, uint64_t key, const void* data, size_t size) {
+    if (!cache || (!data && size)) {
+        g4f_set_last_error("g4f_content_cache_put: invalid args");
+        return 0;
+    }
+    EntryHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.key = key;
+    header.size = size;
+    header.checksum = fnv1a(kFnvOffset, data, size);
+
+    // Write outside the lock under a unique name so concurrent puts do not serialize on I/O.
+    const std::filesystem::path finalPath = cacheEntryPath(cache, key);
+    std::filesystem::path tmpPath = finalPath;
+    tmpPath += "." + std::to_string(g_tmpCounter.fetch_add(1)) + ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            g4f_set_last_error("g4f_content_cache_put: cannot open temporary file");
+            return 0;
+        }
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)data, (std::streamsize)size);
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            g4f_set_last_error("g4f_content_cache_put: write failed");
+            return 0;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    auto it = cache->entries.find(key);
+    if (it != cache->entries.end() && it->second.mapped) {
+        // Same key, same content: keep the mapped file (it cannot be replaced while mapped on Win32).
+        std::filesystem::remove(tmpPath, ec);
+        cache->stats.puts += 1;
+        return 1;
+    }
+    std::filesystem::rename(tmpPath, finalPath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        g4f_set_last_error("g4f_content_cache_put: rename failed");
+        return 0;
+    }
+    if (it == cache->entries.end()) {
+        it = cache->entries.emplace(key, CacheEntry{}).first;
+        cache->stats.entries += 1;
+    } else {
+        cache->stats.bytes -= it->second.fileBytes;
+    }
+    CacheEntry& e = it->second;
+    e.fileBytes = sizeof(header) + size;
+    e.lastUse = ++cache->clock;
+    cache->stats.bytes += e.fileBytes;
+    cache->stats.puts += 1;
+    cacheTrim(cache);
+    return 1;
+}
+
+void g4f_content_cache_get_stats(const g4f_content_cache* cache, g4f_content_cache_stats* out) {
+    if (!out) return;
+    if (!cache) {
+        *out = g4f_content_cache_stats{};
+        return;
+    }
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    *out = cache->stats;
+}
+
+const uint8_t* g4f_content_cache_texsynth_rgba8(g4f_content_cache* cache, const g4f_texsynth_desc* desc, int width, int height, g4f_jobs* jobs) {
+    if (!cache || !desc || width <= 0 || height <= 0 || desc->rampCount < 0 || (desc->rampCount > 0 && !desc->ramp)) {
+        g4f_set_last_error("g4f_content_cache_texsynth_rgba8: invalid args");
+        return nullptr;
+    }
+    // Field by field: the struct has a pointer and may have padding.
+    uint64_t key = g4f_content_cache_key("g4f_texsynth_rgba8", kTexsynthVersion, nullptr, 0);
+    const int ints[5] = {desc->generator, desc->octaves, desc->rampCount, width, height};
+    const float floats[9] = {desc->frequency, desc->lacunarity, desc->gain, desc->offsetX, desc->offsetY, desc->x0, desc->y0, desc->x1, desc->y1};
+    key = g4f_content_cache_key_append(key, ints, sizeof(ints));
+    key = g4f_content_cache_key_append(key, floats, sizeof(floats));
+    key = g4f_content_cache_key_append(key, &desc->seed, sizeof(desc->seed));
+    for (int i = 0; i < desc->rampCount; i++) {
+        key = g4f_content_cache_key_append(key, &desc->ramp[i].t, sizeof(float));
+        key = g4f_content_cache_key_append(key, &desc->ramp[i].rgba, sizeof(uint32_t));
+    }
+
+    const size_t bytes = (size_t)width * (size_t)height * 4;
+    size_t size = 0;
+    const void* hit = g4f_content_cache_get(cache, key, &size);
+    if (hit && size == bytes) return (const uint8_t*)hit;
+
+    std::unique_ptr<uint8_t[]> pixels(new uint8_t[bytes]);
+    if (!g4f_texsynth_generate_rgba8(desc, jobs, width, height, pixels.get(), 0)) return nullptr;
+    if (!hit && g4f_content_cache_put(cache, key, pixels.get(), bytes)) {
+        hit = cacheGet(cache, key, &size, false);
+        if (hit && size == bytes) return (const uint8_t*)hit;
+    }
+    // Could not be stored (I/O error, larger than the cap): the cache still owns the result.
+    std::lock_guard<std::mutex> lock(cache->mutex);
+    cache->owned.push_back(std::move(pixels));
+    return cache->owned.back().get();
+}
@@ -2,6 +2,8 @@
 #include "g4f_error_internal.h"
 
 #include "../include/g4f/g4f.h"
+#include "../include/g4f/g4f_dynres.h"
+#include "../include/g4f/g4f_gpu_timings.h"
 
 struct g4f_ctx3d {
     g4f_app* app = nullptr;
@@ -11,6 +13,17 @@ struct g4f_ctx3d {
     double timeSeconds = 0.0;
     double lastTimeSeconds = 0.0;
     float dtSeconds = 0.0f;
+
+    // Frame timings (g4f_ctx3d_frame_timings) and dynamic resolution.
+    double frameBeginSeconds = 0.0;
+    float cpuMs = 0.0f;
+    float presentMs = 0.0f;
+    int dynresEnabled = 0;
+    g4f_dynres dynres{};
+    uint64_t gpuFrameSeen = 0;  // newest g4f_gfx_gpu_timings frame fed to dynres (+1, 0 = none)
+    uint64_t gpuFrameFirst = 0; // GPU results before this frame were rendered at an older scale
+    g4f_gfx_target* sceneTarget = nullptr;
+    int scenePassOpen = 0;
 };
 
 g4f_ctx3d* g4f_ctx3d_create(const g4f_window_desc* windowDesc) {
@@ -50,6 +63,7 @@ g4f_ctx3d* g4f_ctx3d_create(const g4f_window_desc* windowDesc) {
 
 void g4f_ctx3d_destroy(g4f_ctx3d* ctx) {
     if (!ctx) return;
+    g4f_gfx_target_destroy(ctx->sceneTarget);
     if (ctx->gfx) g4f_gfx_destroy(ctx->gfx);
     if (ctx->window) g4f_window_destroy(ctx->window);
     if (ctx->app) g4f_app_destroy(ctx->app);
@@ -85,12 +99,91 @@ g4f_gfx* g4f_ctx3d_gfx(g4f_ctx3d* ctx) {
     return ctx ? ctx->gfx : nullptr;
 }
 
+// Recreates the scaled scene target when the window size or the quantized scale changes.
+static bool ensureSceneTarget(g4f_ctx3d* ctx) {
+    int bw = 0, bh = 0;
+    g4f_gfx_get_size(ctx->gfx, &bw, &bh);
+    int w = (int)((float)bw * ctx->dynres.scale + 0.5f);
+    int h = (int)((float)bh * ctx->dynres.scale + 0.5f);
+    w = (w <= 0) ? 1 : w;
+    h = (h <= 0) ? 1 : h;
+
+    int tw = 0, th = 0;
+    g4f_gfx_target_get_size(ctx->sceneTarget, &tw, &th);
+    if (ctx->sceneTarget && tw == w && th == h) return true;
+
+    g4f_gfx_target_destroy(ctx->sceneTarget);
+    ctx->sceneTarget = g4f_gfx_target_create(ctx->gfx, w, h, G4F_GFX_FORMAT_RGBA8, 1);
+    return ctx->sceneTarget != nullptr;
+}
+
+// Present (vsync wait included) is left out: the cost is the CPU time and the GPU frame time.
+static void updateDynres(g4f_ctx3d* ctx) {
+    const g4f_gpu_timings* gpu = g4f_gfx_gpu_timings(ctx->gfx);
+    if (!gpu || gpu->source != G4F_GPU_TIMINGS_GPU) {
+        g4f_dynres_update(&ctx->dynres, ctx->cpuMs, 0.0f);
+        return;
+    }
+    // Feed each resolved GPU frame once, with the CPU time of the frame that just ended.
+    if (gpu->frameIndex + 1 == ctx->gpuFrameSeen) return;
+    ctx->gpuFrameSeen = gpu->frameIndex + 1;
+    if (gpu->frameIndex < ctx->gpuFrameFirst) return;
+
+    const float scale = ctx->dynres.scale;
+    g4f_dynres_update(&ctx->dynres, ctx->cpuMs, gpu->frameMs);
+    // Frames still in flight (at most the timer ring) were rendered at the old scale.
+    if (ctx->dynres.scale != scale) ctx->gpuFrameFirst = gpu->frameIndex + 1 + G4F_GPU_TIMER_RING;
+}
+
 void g4f_frame3d_begin(g4f_ctx3d* ctx, uint32_t clearRgba) {
     if (!ctx || !ctx->gfx) return;
+    ctx->frameBeginSeconds = g4f_time_seconds(ctx->app);
     g4f_gfx_begin(ctx->gfx, clearRgba);
+
+    ctx->scenePassOpen = 0;
+    if (ctx->dynresEnabled && ensureSceneTarget(ctx)) {
+        ctx->scenePassOpen = g4f_gfx_pass_begin(
+            ctx->gfx, ctx->sceneTarget, G4F_GFX_PASS_CLEAR_COLOR | G4F_GFX_PASS_CLEAR_DEPTH, clearRgba);
+    }
 }
 
 void g4f_frame3d_end(g4f_ctx3d* ctx) {
     if (!ctx || !ctx->gfx) return;
+    g4f_ctx3d_resolve(ctx);
+
+    double presentBegin = g4f_time_seconds(ctx->app);
     g4f_gfx_end(ctx->gfx);
+    double presentEnd = g4f_time_seconds(ctx->app);
+
+    ctx->cpuMs = (float)((presentBegin - ctx->frameBeginSeconds) * 1000.0);
+    ctx->presentMs = (float)((presentEnd - presentBegin) * 1000.0);
+    if (ctx->dynresEnabled) updateDynres(ctx);
+}
+
+void g4f_ctx3d_resolve(g4f_ctx3d* ctx) {
+    if (!ctx || !ctx->gfx || !ctx->scenePassOpen) return;
+    ctx->scenePassOpen = 0;
+    g4f_gfx_pass_end(ctx->gfx);
+    g4f_gfx_blit(ctx->gfx, g4f_gfx_target_texture(ctx->sceneTarget));
+}
+
+void g4f_ctx3d_set_dynamic_resolution(g4f_ctx3d* ctx, const g4f_dynres_desc* desc) {
+    if (!ctx) return;
+    if (!desc) {
+        ctx->dynresEnabled = 0;
+        g4f_gfx_target_destroy(ctx->sceneTarget);
+        ctx->sceneTarget = nullptr;
+        return;
+    }
+    g4f_dynres_init(&ctx->dynres, desc);
+    ctx->dynresEnabled = 1;
+}
+
+float g4f_ctx3d_render_scale(const g4f_ctx3d* ctx) {
+    return (ctx && ctx->dynresEnabled) ? ctx->dynres.scale : 1.0f;
+}
+
+void g4f_ctx3d_frame_timings(const g4f_ctx3d* ctx, float* cpuMs, float* presentMs) {
+    if (cpuMs) *cpuMs = ctx ? ctx->cpuMs : 0.0f;
+    if (presentMs) *presentMs = ctx ? ctx->presentMs : 0.0f;
 }
@@ -1,4 +1,5 @@
 #include "../include/g4f/g4f_ctx3d_ui.h"
+#include "../include/g4f/g4f_dynres.h"
 #include "g4f_error_internal.h"
 
 struct g4f_ctx3d_ui {
@@ -66,6 +67,10 @@ g4f_window* g4f_ctx3d_ui_window(g4f_ctx3d_ui* ctx) {
     return (ctx && ctx->ctx3d) ? g4f_ctx3d_window(ctx->ctx3d) : nullptr;
 }
 
+g4f_ctx3d* g4f_ctx3d_ui_ctx3d(g4f_ctx3d_ui* ctx) {
+    return ctx ? ctx->ctx3d : nullptr;
+}
+
 g4f_gfx* g4f_ctx3d_ui_gfx(g4f_ctx3d_ui* ctx) {
     return (ctx && ctx->ctx3d) ? g4f_ctx3d_gfx(ctx->ctx3d) : nullptr;
 }
@@ -91,6 +96,8 @@ void g4f_ctx3d_ui_frame3d_end(g4f_ctx3d_ui* ctx) {
 void g4f_ctx3d_ui_overlay_begin(g4f_ctx3d_ui* ctx) {
     if (!ctx || !ctx->overlay || !ctx->ui) return;
     g4f_window* window = g4f_ctx3d_ui_window(ctx);
+    // The overlay draws at backbuffer resolution: finish (upscale) a scaled 3D pass first.
+    g4f_ctx3d_resolve(ctx->ctx3d);
     g4f_renderer_begin(ctx->overlay);
     g4f_ui_begin(ctx->ui, ctx->overlay, window);
 }
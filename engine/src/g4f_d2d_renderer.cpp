@@ -1,6 +1,10 @@
 #include "g4f_platform_win32.h"
 #include "g4f_platform_d3d11.h"
 #include "g4f_error_internal.h"
+#include "../include/g4f/g4f_atlas.h"
+#include "../include/g4f/g4f_frame_stats.h"
+#include "../include/g4f/g4f_image.h"
+#include "g4f_file_map_internal.h"
 
 #include <unordered_map>
 #include <string>
@@ -36,15 +40,24 @@ struct g4f_renderer {
     uint64_t boundBackbufferGeneration = 0;
 
     ID2D1SolidColorBrush* brush = nullptr;
+    uint32_t brushRgba = 0xFFFFFFFFu; // brushes are created white
 
     std::unordered_map<int, IDWriteTextFormat*> textFormatsBySizePx;
     int clipDepth = 0;
+
+    // Counters since the last g4f_renderer_end, and the snapshot taken there.
+    g4f_gfx_frame_stats frameStats{};
+    g4f_gfx_frame_stats lastFrameStats{};
+    uint64_t framesEnded = 0;
 };
 
 struct g4f_bitmap {
     ID2D1Bitmap* bitmap = nullptr;
     int width = 0;
     int height = 0;
+    // Regions (g4f_bitmap_create_region) share the source's bitmap and draw this part of it.
+    bool region = false;
+    D2D1_RECT_F source{};
 };
 
 static ID2D1RenderTarget* g4f_active_target(g4f_renderer* renderer) {
@@ -54,6 +67,17 @@ static ID2D1RenderTarget* g4f_active_target(g4f_renderer* renderer) {
     return nullptr;
 }
 
+// Skips SetColor when consecutive primitives share a color (counted in the frame stats).
+static void g4f_renderer_set_brush_color(g4f_renderer* renderer, uint32_t rgba) {
+    if (renderer->brushRgba == rgba) {
+        renderer->frameStats.redundantAvoided[G4F_GFX_STATE_BRUSH]++;
+        return;
+    }
+    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    renderer->brushRgba = rgba;
+    renderer->frameStats.stateChanges[G4F_GFX_STATE_BRUSH]++;
+}
+
 static HRESULT g4f_renderer_create_hwnd_target(g4f_renderer* renderer) {
     RECT rc{};
     GetClientRect(renderer->window->state.hwnd, &rc);
@@ -149,6 +173,8 @@ static HRESULT g4f_renderer_bind_gfx_backbuffer(g4f_renderer* renderer) {
 
     renderer->gfxContext->SetTarget(renderer->ctxTargetBitmap);
     renderer->boundBackbufferGeneration = renderer->gfx->backbufferGeneration;
+    renderer->frameStats.resourcesCreated++;
+    renderer->frameStats.stateChanges[G4F_GFX_STATE_TARGET]++;
     return S_OK;
 }
 
@@ -172,13 +198,18 @@ void g4f_renderer_begin(g4f_renderer* renderer) {
 
 void g4f_renderer_end(g4f_renderer* renderer) {
     if (!renderer) return;
-    if (renderer->hwndTarget) {
-        renderer->hwndTarget->EndDraw();
-        return;
-    }
-    if (renderer->gfxContext) {
-        renderer->gfxContext->EndDraw();
-    }
+    if (renderer->hwndTarget) renderer->hwndTarget->EndDraw();
+    else if (renderer->gfxContext) renderer->gfxContext->EndDraw();
+
+    renderer->frameStats.frameIndex = renderer->framesEnded++;
+    renderer->lastFrameStats = renderer->frameStats;
+    g4f_gfx_frame_stats_reset(&renderer->frameStats);
+}
+
+void g4f_renderer_get_frame_stats(const g4f_renderer* renderer, g4f_gfx_frame_stats* out) {
+    if (!out) return;
+    if (renderer) *out = renderer->lastFrameStats;
+    else g4f_gfx_frame_stats_reset(out);
 }
 
 void g4f_renderer_clear(g4f_renderer* renderer, uint32_t rgba) {
@@ -194,25 +225,28 @@ void g4f_renderer_clear(g4f_renderer* renderer, uint32_t rgba) {
 
 void g4f_draw_rect(g4f_renderer* renderer, g4f_rect_f rect, uint32_t rgba) {
     if (!renderer || !renderer->brush) return;
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
     D2D1_RECT_F r{rect.x, rect.y, rect.x + rect.w, rect.y + rect.h};
     if (renderer->hwndTarget) renderer->hwndTarget->FillRectangle(r, renderer->brush);
     else if (renderer->gfxContext) renderer->gfxContext->FillRectangle(r, renderer->brush);
+    renderer->frameStats.drawCalls++;
 }
 
 void g4f_draw_rect_outline(g4f_renderer* renderer, g4f_rect_f rect, float thickness, uint32_t rgba) {
     if (!renderer || !renderer->brush) return;
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
     D2D1_RECT_F r{rect.x, rect.y, rect.x + rect.w, rect.y + rect.h};
     if (renderer->hwndTarget) renderer->hwndTarget->DrawRectangle(r, renderer->brush, thickness);
     else if (renderer->gfxContext) renderer->gfxContext->DrawRectangle(r, renderer->brush, thickness);
+    renderer->frameStats.drawCalls++;
 }
 
 void g4f_draw_line(g4f_renderer* renderer, float x1, float y1, float x2, float y2, float thickness, uint32_t rgba) {
     if (!renderer || !renderer->brush) return;
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
     if (renderer->hwndTarget) renderer->hwndTarget->DrawLine(D2D1::Point2F(x1, y1), D2D1::Point2F(x2, y2), renderer->brush, thickness);
     else if (renderer->gfxContext) renderer->gfxContext->DrawLine(D2D1::Point2F(x1, y1), D2D1::Point2F(x2, y2), renderer->brush, thickness);
+    renderer->frameStats.drawCalls++;
 }
 
 static IDWriteTextFormat* g4f_get_text_format(g4f_renderer* renderer, int sizePx, bool wrap, const char* contextUtf8) {
@@ -243,6 +277,7 @@ static IDWriteTextFormat* g4f_get_text_format(g4f_renderer* renderer, int sizePx
         return nullptr;
     }
     format->SetWordWrapping(wrap ? DWRITE_WORD_WRAPPING_WRAP : DWRITE_WORD_WRAPPING_NO_WRAP);
+    renderer->frameStats.resourcesCreated++;
 
     renderer->textFormatsBySizePx.emplace(key, format);
     return format;
@@ -257,13 +292,14 @@ void g4f_draw_text(g4f_renderer* renderer, const char* text_utf8, float x, float
     IDWriteTextFormat* format = g4f_get_text_format(renderer, sizePx, false, "g4f_draw_text");
     if (!format) return;
 
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
 
     // Large layout box; DirectWrite needs a rect.
     D2D1_SIZE_F rtSize = renderer->hwndTarget ? renderer->hwndTarget->GetSize() : renderer->gfxContext->GetSize();
     D2D1_RECT_F layout{ x, y, rtSize.width, rtSize.height };
     if (renderer->hwndTarget) renderer->hwndTarget->DrawText(text.c_str(), (UINT32)text.size(), format, layout, renderer->brush);
     else if (renderer->gfxContext) renderer->gfxContext->DrawText(text.c_str(), (UINT32)text.size(), format, layout, renderer->brush);
+    renderer->frameStats.drawCalls++;
 }
 
 void g4f_draw_text_wrapped(g4f_renderer* renderer, const char* text_utf8, g4f_rect_f bounds, float size_px, uint32_t rgba) {
@@ -275,7 +311,7 @@ void g4f_draw_text_wrapped(g4f_renderer* renderer, const char* text_utf8, g4f_re
     IDWriteTextFormat* format = g4f_get_text_format(renderer, sizePx, true, "g4f_draw_text_wrapped");
     if (!format) return;
 
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
 
     float w = (bounds.w > 0.0f) ? bounds.w : 1.0f;
     float h = (bounds.h > 0.0f) ? bounds.h : 1.0f;
@@ -286,9 +322,13 @@ void g4f_draw_text_wrapped(g4f_renderer* renderer, const char* text_utf8, g4f_re
         g4f_set_last_hresult_error("g4f_draw_text_wrapped: CreateTextLayout failed", hr);
         return;
     }
+    renderer->frameStats.resourcesCreated++;
 
     ID2D1RenderTarget* target = g4f_active_target(renderer);
-    if (target) target->DrawTextLayout(D2D1::Point2F(bounds.x, bounds.y), layout, renderer->brush);
+    if (target) {
+        target->DrawTextLayout(D2D1::Point2F(bounds.x, bounds.y), layout, renderer->brush);
+        renderer->frameStats.drawCalls++;
+    }
     layout->Release();
 }
 
@@ -302,6 +342,21 @@ g4f_bitmap* g4f_bitmap_load(g4f_renderer* renderer, const char* path_utf8) {
     std::wstring path = g4f_utf8_to_wide(path_utf8);
     if (path.empty()) { g4f_set_last_error("g4f_bitmap_load: empty path"); return nullptr; }
 
+    // PNG/TGA/QOI go through the built-in decoders; other formats (and anything they reject) use WIC.
+    {
+        g4f_file_map map;
+        if (g4f_file_map_open(&map, path_utf8, "g4f_bitmap_load")) {
+            int format = 0, w = 0, h = 0;
+            std::vector<uint8_t> pixels;
+            if (g4f_image_info(map.data, map.size, &format, &w, &h)) {
+                pixels.resize((size_t)w * (size_t)h * 4);
+                if (!g4f_image_decode_rgba8(map.data, map.size, pixels.data(), 0)) pixels.clear();
+            }
+            g4f_file_map_close(&map);
+            if (!pixels.empty()) return g4f_bitmap_create_rgba8(renderer, w, h, pixels.data(), 0);
+        }
+    }
+
     IWICBitmapDecoder* decoder = nullptr;
     HRESULT hr = renderer->wicFactory->CreateDecoderFromFilename(path.c_str(), nullptr, GENERIC_READ, WICDecodeMetadataCacheOnLoad, &decoder);
     if (FAILED(hr) || !decoder) { g4f_set_last_hresult_error("g4f_bitmap_load: CreateDecoderFromFilename failed", hr); return nullptr; }
@@ -328,6 +383,9 @@ g4f_bitmap* g4f_bitmap_load(g4f_renderer* renderer, const char* path_utf8) {
     frame->Release();
     decoder->Release();
 
+    renderer->frameStats.resourcesCreated++;
+    renderer->frameStats.textureBytes += (uint64_t)w * (uint64_t)h * 4;
+
     auto* out = new g4f_bitmap();
     out->bitmap = bitmap;
     out->width = (int)w;
@@ -371,6 +429,8 @@ g4f_bitmap* g4f_bitmap_create_rgba8(g4f_renderer* renderer, int width, int heigh
     ID2D1Bitmap* bitmap = nullptr;
     HRESULT hr = target->CreateBitmap(D2D1::SizeU((UINT32)width, (UINT32)height), premulBgra.data(), (UINT32)(width * 4), &props, &bitmap);
     if (FAILED(hr) || !bitmap) { g4f_set_last_hresult_error("g4f_bitmap_create_rgba8: CreateBitmap failed", hr); return nullptr; }
+    renderer->frameStats.resourcesCreated++;
+    renderer->frameStats.textureBytes += premulBgra.size();
 
     auto* out = new g4f_bitmap();
     out->bitmap = bitmap;
@@ -379,6 +439,56 @@ g4f_bitmap* g4f_bitmap_create_rgba8(g4f_renderer* renderer, int width, int heigh
     return out;
 }
 
+g4f_bitmap* g4f_bitmap_create_region(const g4f_bitmap* source, int x, int y, int width, int height) {
+    if (!source || !source->bitmap) { g4f_set_last_error("g4f_bitmap_create_region: invalid args"); return nullptr; }
+    if (x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > source->width || y + height > source->height) {
+        g4f_set_last_error("g4f_bitmap_create_region: rectangle outside the source bitmap");
+        return nullptr;
+    }
+    const float ox = source->region ? source->source.left : 0.0f;
+    const float oy = source->region ? source->source.top : 0.0f;
+    auto* out = new g4f_bitmap();
+    out->bitmap = source->bitmap;
+    out->bitmap->AddRef();
+    out->width = width;
+    out->height = height;
+    out->region = true;
+    out->source = D2D1::RectF(ox + (float)x, oy + (float)y, ox + (float)(x + width), oy + (float)(y + height));
+    return out;
+}
+
+int g4f_atlas_create_bitmaps(const g4f_atlas* atlas, g4f_renderer* renderer, g4f_bitmap** outBitmaps) {
+    const int count = g4f_atlas_image_count(atlas);
+    if (!renderer || !outBitmaps || count <= 0 || g4f_atlas_page_count(atlas) <= 0) {
+        g4f_set_last_error("g4f_atlas_create_bitmaps: invalid args or atlas not built");
+        return 0;
+    }
+    std::vector<g4f_bitmap*> pages((size_t)g4f_atlas_page_count(atlas), nullptr);
+    bool ok = true;
+    for (size_t p = 0; p < pages.size() && ok; p++) {
+        int w = 0, h = 0;
+        const uint8_t* pixels = g4f_atlas_page_pixels(atlas, (int)p, &w, &h);
+        pages[p] = g4f_bitmap_create_rgba8(renderer, w, h, pixels, w * 4);
+        ok = pages[p] != nullptr;
+    }
+    int created = 0;
+    for (; ok && created < count; created++) {
+        g4f_atlas_region r{};
+        g4f_atlas_get_region(atlas, created, &r);
+        outBitmaps[created] = g4f_bitmap_create_region(pages[(size_t)r.page], r.x, r.y, r.width, r.height);
+        ok = outBitmaps[created] != nullptr;
+    }
+    if (!ok) {
+        for (int i = 0; i < created; i++) {
+            g4f_bitmap_destroy(outBitmaps[i]);
+            outBitmaps[i] = nullptr;
+        }
+    }
+    // Regions hold their own reference to the page bitmap.
+    for (g4f_bitmap* page : pages) g4f_bitmap_destroy(page);
+    return ok ? 1 : 0;
+}
+
 void g4f_bitmap_destroy(g4f_bitmap* bitmap) {
     if (!bitmap) return;
     g4f_safe_release((IUnknown**)&bitmap->bitmap);
@@ -395,32 +505,36 @@ void g4f_draw_bitmap(g4f_renderer* renderer, const g4f_bitmap* bitmap, g4f_rect_
     if (opacity < 0.0f) opacity = 0.0f;
     if (opacity > 1.0f) opacity = 1.0f;
     D2D1_RECT_F r{dst.x, dst.y, dst.x + dst.w, dst.y + dst.h};
-    if (renderer->hwndTarget) renderer->hwndTarget->DrawBitmap(bitmap->bitmap, r, opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, nullptr);
-    else if (renderer->gfxContext) renderer->gfxContext->DrawBitmap(bitmap->bitmap, r, opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, nullptr);
+    const D2D1_RECT_F* src = bitmap->region ? &bitmap->source : nullptr;
+    if (renderer->hwndTarget) renderer->hwndTarget->DrawBitmap(bitmap->bitmap, r, opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, src);
+    else if (renderer->gfxContext) renderer->gfxContext->DrawBitmap(bitmap->bitmap, r, opacity, D2D1_BITMAP_INTERPOLATION_MODE_LINEAR, src);
+    renderer->frameStats.drawCalls++;
 }
 
 void g4f_draw_round_rect(g4f_renderer* renderer, g4f_rect_f rect, float radius, uint32_t rgba) {
     if (!renderer || !renderer->brush) return;
     if (radius < 0.0f) radius = 0.0f;
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
     D2D1_ROUNDED_RECT rr{};
     rr.rect = D2D1::RectF(rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
     rr.radiusX = radius;
     rr.radiusY = radius;
     if (renderer->hwndTarget) renderer->hwndTarget->FillRoundedRectangle(rr, renderer->brush);
     else if (renderer->gfxContext) renderer->gfxContext->FillRoundedRectangle(rr, renderer->brush);
+    renderer->frameStats.drawCalls++;
 }
 
 void g4f_draw_round_rect_outline(g4f_renderer* renderer, g4f_rect_f rect, float radius, float thickness, uint32_t rgba) {
     if (!renderer || !renderer->brush) return;
     if (radius < 0.0f) radius = 0.0f;
-    renderer->brush->SetColor(g4f_color_from_rgba_u32(rgba));
+    g4f_renderer_set_brush_color(renderer, rgba);
     D2D1_ROUNDED_RECT rr{};
     rr.rect = D2D1::RectF(rect.x, rect.y, rect.x + rect.w, rect.y + rect.h);
     rr.radiusX = radius;
     rr.radiusY = radius;
     if (renderer->hwndTarget) renderer->hwndTarget->DrawRoundedRectangle(rr, renderer->brush, thickness);
     else if (renderer->gfxContext) renderer->gfxContext->DrawRoundedRectangle(rr, renderer->brush, thickness);
+    renderer->frameStats.drawCalls++;
 }
 
 void g4f_measure_text(g4f_renderer* renderer, const char* text_utf8, float size_px, float* out_w, float* out_h) {
@@ -439,6 +553,7 @@ void g4f_measure_text(g4f_renderer* renderer, const char* text_utf8, float size_
         g4f_set_last_hresult_error("g4f_measure_text: CreateTextLayout failed", hr);
         return;
     }
+    renderer->frameStats.resourcesCreated++;
     DWRITE_TEXT_METRICS m{};
     layout->GetMetrics(&m);
     layout->Release();
@@ -465,6 +580,7 @@ void g4f_measure_text_wrapped(g4f_renderer* renderer, const char* text_utf8, flo
         g4f_set_last_hresult_error("g4f_measure_text_wrapped: CreateTextLayout failed", hr);
         return;
     }
+    renderer->frameStats.resourcesCreated++;
     DWRITE_TEXT_METRICS m{};
     layout->GetMetrics(&m);
     layout->Release();
@@ -479,6 +595,7 @@ void g4f_clip_push(g4f_renderer* renderer, g4f_rect_f rect) {
     D2D1_RECT_F r{rect.x, rect.y, rect.x + rect.w, rect.y + rect.h};
     target->PushAxisAlignedClip(r, D2D1_ANTIALIAS_MODE_PER_PRIMITIVE);
     renderer->clipDepth += 1;
+    renderer->frameStats.stateChanges[G4F_GFX_STATE_CLIP]++;
 }
 
 void g4f_clip_pop(g4f_renderer* renderer) {
@@ -488,6 +605,7 @@ void g4f_clip_pop(g4f_renderer* renderer) {
     if (renderer->clipDepth <= 0) return;
     target->PopAxisAlignedClip();
     renderer->clipDepth -= 1;
+    renderer->frameStats.stateChanges[G4F_GFX_STATE_CLIP]++;
 }
 
 g4f_renderer* g4f_renderer_create_for_gfx(g4f_gfx* gfx) {
@@ -528,5 +646,6 @@ g4f_renderer* g4f_renderer_create_for_gfx(g4f_gfx* gfx) {
     // Bind backbuffer now.
     hr = g4f_renderer_bind_gfx_backbuffer(renderer);
     if (FAILED(hr)) { g4f_set_last_hresult_error("g4f_renderer_create_for_gfx: bind backbuffer failed", hr); g4f_renderer_destroy(renderer); return nullptr; }
+    g4f_gfx_frame_stats_reset(&renderer->frameStats); // creation is not part of frame 0
     return renderer;
 }
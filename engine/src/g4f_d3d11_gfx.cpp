@@ -2,6 +2,21 @@
 #include "g4f_error_internal.h"
 
 #include "../include/g4f/g4f.h"
+#include "../include/g4f/g4f_bcn.h"
+#include "../include/g4f/g4f_dirty_rects.h"
+#include "../include/g4f/g4f_ecs.h"
+#include "../include/g4f/g4f_frame_stats.h"
+#include "../include/g4f/g4f_gpu_timings.h"
+#include "../include/g4f/g4f_light_clusters.h"
+#include "../include/g4f/g4f_lod.h"
+#include "../include/g4f/g4f_material_key.h"
+#include "../include/g4f/g4f_mipgen.h"
+#include "../include/g4f/g4f_pack.h"
+#include "../include/g4f/g4f_particles.h"
+#include "../include/g4f/g4f_scene.h"
+#include "../include/g4f/g4f_shader_cache.h"
+#include "../include/g4f/g4f_sprite.h"
+#include "../include/g4f/g4f_stream.h"
 
 #ifndef WIN32_LEAN_AND_MEAN
 #define WIN32_LEAN_AND_MEAN
@@ -12,9 +27,13 @@
 
 #include <d3dcompiler.h>
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <cstdio>
 #include <cstring>
 #include <cstdint>
+#include <string>
 #include <vector>
 
 namespace {
@@ -110,7 +129,48 @@ static g4f_mat4 mat4NormalMatrix(g4f_mat4 model) {
     return out;
 }
 
+#ifndef D3D_COMPILER_VERSION
+#define D3D_COMPILER_VERSION 0
+#endif
+
+// Process-wide so it can be configured before the first g4f_gfx_create.
+static bool g_shaderCacheDirSet = false;
+static std::string g_shaderCacheDir;
+
+static std::string shaderCacheDir() {
+    if (g_shaderCacheDirSet) return g_shaderCacheDir;
+    wchar_t tempPath[MAX_PATH + 1]{};
+    DWORD len = GetTempPathW(MAX_PATH + 1, tempPath);
+    if (len == 0 || len > MAX_PATH) return std::string();
+    return g4f_wide_to_utf8(tempPath) + "g4f_shader_cache";
+}
+
+static double msSince(std::chrono::steady_clock::time_point t0) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+}
+
+// Frame stats: counts a cached bind as issued or avoided and passes `changed` through.
+static bool gfxStateDiffers(g4f_gfx* gfx, int kind, bool changed) {
+    if (changed) gfx->frameStats.stateChanges[kind]++;
+    else gfx->frameStats.redundantAvoided[kind]++;
+    return changed;
+}
+
+static void gfxCountBind(g4f_gfx* gfx, int kind) {
+    gfx->frameStats.stateChanges[kind]++;
+}
+
+static void gfxCountDraw(g4f_gfx* gfx, UINT vertexCount) {
+    gfx->frameStats.drawCalls++;
+    gfx->frameStats.triangles += vertexCount / 3;
+}
+
+static void gfxCountCreated(g4f_gfx* gfx, int count) {
+    gfx->frameStats.resourcesCreated += count;
+}
+
 static HRESULT compileHlsl(
+    g4f_gfx* gfx,
     const char* source,
     const char* entryPoint,
     const char* target,
@@ -124,8 +184,31 @@ static HRESULT compileHlsl(
     flags |= D3DCOMPILE_OPTIMIZATION_LEVEL3;
 #endif
 
+    gfx->startup.shaderCount++;
+    const std::string cacheDir = shaderCacheDir();
+    const uint64_t key = g4f_shader_cache_key(source, entryPoint, target, D3D_COMPILER_VERSION, flags);
+    if (!cacheDir.empty()) {
+        auto t0 = std::chrono::steady_clock::now();
+        void* bytes = nullptr;
+        size_t size = 0;
+        if (g4f_shader_cache_load(cacheDir.c_str(), key, &bytes, &size)) {
+            HRESULT hr = D3DCreateBlob(size, outBlob);
+            if (SUCCEEDED(hr)) std::memcpy((*outBlob)->GetBufferPointer(), bytes, size);
+            g4f_shader_cache_free(bytes);
+            if (SUCCEEDED(hr)) {
+                gfx->startup.shaderCacheHits++;
+                gfx->startup.shaderCacheLoadMs += msSince(t0);
+                return hr;
+            }
+        }
+        gfx->startup.shaderCacheLoadMs += msSince(t0);
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
     ID3DBlob* errors = nullptr;
     HRESULT hr = D3DCompile(source, std::strlen(source), nullptr, nullptr, nullptr, entryPoint, target, flags, 0, outBlob, &errors);
+    gfx->startup.shaderCompileMs += msSince(t0);
+    gfx->startup.shaderCacheMisses++;
     if (FAILED(hr)) {
         const char* errorText = nullptr;
         if (errors && errors->GetBufferPointer() && errors->GetBufferSize() > 0) {
@@ -137,6 +220,12 @@ static HRESULT compileHlsl(
         } else {
             setLastHresultErrorIfEmptyWithPrefix(contextUtf8, "D3DCompile failed", hr);
         }
+    } else if (!cacheDir.empty()) {
+        // A read-only or full cache directory only costs the next start a recompile.
+        const bool hadError = g4f_last_error()[0] != 0;
+        if (!g4f_shader_cache_store(cacheDir.c_str(), key, (*outBlob)->GetBufferPointer(), (*outBlob)->GetBufferSize()) && !hadError) {
+            g4f_clear_error();
+        }
     }
     if (errors) errors->Release();
     return hr;
@@ -150,8 +239,7 @@ struct Vertex {
 struct CbMaterial {
     g4f_mat4 mvp;
     float tint[4];
-    float hasTex;
-    float pad[3];
+    float pad[4];
     g4f_mat4 model;
     g4f_mat4 normal;
     float lightDir[4];
@@ -159,6 +247,24 @@ struct CbMaterial {
     float ambientColor[4];
 };
 
+struct CbClusters {
+    g4f_mat4 view;     // z column scaled by depthSign, so the shader's depth is v.z
+    float params[4];   // tanHalfX, tanHalfY, sliceScale, nearZ
+    uint32_t dims[4];  // tilesX, tilesY, slices, lightCount (0 disables clustered shading)
+};
+
+struct CbShadow {
+    g4f_mat4 viewProj[G4F_SHADOW_MAX_CASCADES];
+    float params[4]; // cascadeCount (0 disables), compareBias, texel size in uv, unused
+};
+
+// Matches GpuLight in the material shader.
+struct GpuLight {
+    float posRadius[4];
+    float colorInner[4]; // rgb * intensity, spot inner cos
+    float dirOuter[4];   // spot direction, spot outer cos (points use a cone that covers everything)
+};
+
 } // namespace
 
 static bool gfxCreateTargets(g4f_gfx* gfx, int w, int h, const char* contextUtf8) {
@@ -217,6 +323,7 @@ static bool gfxCreateTargets(g4f_gfx* gfx, int w, int h, const char* contextUtf8
     gfx->cachedW = w;
     gfx->cachedH = h;
     gfx->backbufferGeneration += 1;
+    g4f_pass_stack_set_backbuffer_size(&gfx->passes, w, h);
     return true;
 }
 
@@ -246,9 +353,9 @@ float4 PSMain(PSIn i) : SV_Target { return i.col; }
 
     ID3DBlob* vsBlob = nullptr;
     ID3DBlob* psBlob = nullptr;
-    HRESULT hr = compileHlsl(kShader, "VSMain", "vs_5_0", "g4f_gfx_create: compile VSMain (debug cube)", &vsBlob);
+    HRESULT hr = compileHlsl(gfx, kShader, "VSMain", "vs_5_0", "g4f_gfx_create: compile VSMain (debug cube)", &vsBlob);
     if (FAILED(hr) || !vsBlob) return false;
-    hr = compileHlsl(kShader, "PSMain", "ps_5_0", "g4f_gfx_create: compile PSMain (debug cube)", &psBlob);
+    hr = compileHlsl(gfx, kShader, "PSMain", "ps_5_0", "g4f_gfx_create: compile PSMain (debug cube)", &psBlob);
     if (FAILED(hr) || !psBlob) { vsBlob->Release(); return false; }
 
     hr = gfx->device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &gfx->vs);
@@ -437,8 +544,7 @@ static bool gfxCreateUnlitPipeline(g4f_gfx* gfx) {
 cbuffer CB0 : register(b0) {
   row_major float4x4 uMvp;
   float4 uTint;
-  float uHasTex;
-  float3 _pad;
+  float4 _pad0;
   row_major float4x4 uModel;
   row_major float4x4 uNormal;
   float4 uLightDir;
@@ -448,62 +554,132 @@ cbuffer CB0 : register(b0) {
 Texture2D uTex0 : register(t0);
 SamplerState uSamp0 : register(s0);
 struct VSIn { float3 pos : POSITION; float3 n : NORMAL; float2 uv : TEXCOORD0; };
-struct PSIn { float4 pos : SV_Position; float2 uv : TEXCOORD0; float3 n : NORMAL; };
+struct PSIn { float4 pos : SV_Position; float2 uv : TEXCOORD0; float3 n : NORMAL; float3 wpos : TEXCOORD1; };
 PSIn VSMain(VSIn i){
   PSIn o;
   o.pos = mul(float4(i.pos,1.0), uMvp);
   o.uv = i.uv;
   o.n = mul(float4(i.n, 0.0), uNormal).xyz;
+  o.wpos = mul(float4(i.pos,1.0), uModel).xyz;
   return o;
 }
-float4 PSUnlit(PSIn i) : SV_Target {
-  float4 c = uTint;
-  if (uHasTex > 0.5) c *= uTex0.Sample(uSamp0, i.uv);
-  return c;
+#if G4F_LIT
+cbuffer CB2 : register(b2) {
+  row_major float4x4 uShadowViewProj[4];
+  float4 uShadowParams; // cascadeCount, compareBias, texel size (uv), -
+};
+Texture2DArray<float> uShadowMap : register(t4);
+SamplerComparisonState uShadowSamp : register(s1);
+// Directional light visibility; the first (nearest) cascade containing the point wins. 2x2 PCF.
+float shadowFactor(float3 wpos) {
+  uint count = (uint)uShadowParams.x;
+  [loop] for (uint c = 0; c < count; c++) {
+    float3 p = mul(float4(wpos, 1.0), uShadowViewProj[c]).xyz;
+    if (any(abs(p.xy) > 1.0 - 2.0 * uShadowParams.z) || p.z > 1.0) continue;
+    float2 uv = p.xy * float2(0.5, -0.5) + 0.5;
+    float z = p.z - uShadowParams.y;
+    float o = uShadowParams.z * 0.5;
+    float s = uShadowMap.SampleCmpLevelZero(uShadowSamp, float3(uv + float2(-o, -o), c), z);
+    s += uShadowMap.SampleCmpLevelZero(uShadowSamp, float3(uv + float2(o, -o), c), z);
+    s += uShadowMap.SampleCmpLevelZero(uShadowSamp, float3(uv + float2(-o, o), c), z);
+    s += uShadowMap.SampleCmpLevelZero(uShadowSamp, float3(uv + float2(o, o), c), z);
+    return s * 0.25;
+  }
+  return 1.0;
 }
-float4 PSLit(PSIn i) : SV_Target {
-  float4 base = uTint;
-  if (uHasTex > 0.5) base *= uTex0.Sample(uSamp0, i.uv);
+#endif
+#if G4F_CLUSTERED
+cbuffer CB1 : register(b1) {
+  row_major float4x4 uView; // view.z points into the screen (depthSign folded in)
+  float4 uClusterParams; // tanHalfX, tanHalfY, sliceScale, nearZ
+  uint4 uClusterDims;    // tilesX, tilesY, slices, lightCount
+};
+struct GpuLight { float4 posRadius; float4 colorInner; float4 dirOuter; };
+StructuredBuffer<GpuLight> uLights : register(t1);
+StructuredBuffer<uint2> uClusterRanges : register(t2);
+StructuredBuffer<uint> uLightIndices : register(t3);
+// Same froxel mapping as g4f_light_clusters_froxel_index.
+float3 clusteredLighting(float3 wpos, float3 n) {
+  float3 v = mul(float4(wpos, 1.0), uView).xyz;
+  float depth = v.z;
+  if (uClusterDims.w == 0 || depth < uClusterParams.w) return 0;
+  float slice = floor(log(depth / uClusterParams.w) * uClusterParams.z);
+  if (slice >= (float)uClusterDims.z) return 0;
+  float2 ndc = v.xy / (depth * uClusterParams.xy) * 0.5 + 0.5;
+  uint2 tile = (uint2)clamp(floor(ndc * (float2)uClusterDims.xy), 0.0, (float2)uClusterDims.xy - 1.0);
+  uint2 range = uClusterRanges[((uint)slice * uClusterDims.y + tile.y) * uClusterDims.x + tile.x];
+  float3 sum = 0;
+  for (uint k = 0; k < range.y; k++) {
+    GpuLight L = uLights[uLightIndices[range.x + k]];
+    float3 d = L.posRadius.xyz - wpos;
+    float d2 = dot(d, d);
+    float r2 = L.posRadius.w * L.posRadius.w;
+    if (d2 >= r2) continue;
+    float3 l = d * rsqrt(max(d2, 1e-8));
+    float att = saturate(1.0 - d2 / r2);
+    float spot = smoothstep(L.dirOuter.w, L.colorInner.w, dot(-l, L.dirOuter.xyz));
+    sum += L.colorInner.rgb * (att * att * spot * saturate(dot(n, l)));
+  }
+  return sum;
+}
+#endif
+// One compile per G4F_MATERIAL_SHADER_* mask; the defines are prepended by gfxCreateUnlitPipeline.
+float4 PSMain(PSIn i) : SV_Target {
+  float4 c = uTint;
+#if G4F_TEXTURED
+  c *= uTex0.Sample(uSamp0, i.uv);
+#endif
+#if G4F_ALPHA_TEST
+  clip(c.a - 0.5);
+#endif
+#if G4F_LIT
   float3 n = normalize(i.n);
   float3 l = normalize(-uLightDir.xyz);
-  float ndl = saturate(dot(n, l));
-  float3 lit = base.rgb * (uAmbientColor.rgb + ndl * uLightColor.rgb);
-  return float4(lit, base.a);
+  float ndl = saturate(dot(n, l)) * shadowFactor(i.wpos);
+  float3 light = uAmbientColor.rgb + ndl * uLightColor.rgb;
+#if G4F_CLUSTERED
+  light += clusteredLighting(i.wpos, n);
+#endif
+  c.rgb *= light;
+#endif
+  return c;
 }
     )";
 
     ID3DBlob* vsBlob = nullptr;
-    ID3DBlob* psBlob = nullptr;
-    HRESULT hr = compileHlsl(kShader, "VSMain", "vs_5_0", "g4f_gfx_create: compile VSMain (unlit)", &vsBlob);
+    HRESULT hr = compileHlsl(gfx, kShader, "VSMain", "vs_5_0", "g4f_gfx_create: compile VSMain (unlit)", &vsBlob);
     if (FAILED(hr) || !vsBlob) return false;
-    hr = compileHlsl(kShader, "PSUnlit", "ps_5_0", "g4f_gfx_create: compile PSUnlit", &psBlob);
-    if (FAILED(hr) || !psBlob) { vsBlob->Release(); return false; }
 
     hr = gfx->device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &gfx->vsUnlit);
     if (FAILED(hr)) {
         setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateVertexShader (unlit) failed", hr);
         vsBlob->Release();
-        psBlob->Release();
-        return false;
-    }
-    hr = gfx->device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &gfx->psUnlit);
-    psBlob->Release();
-    if (FAILED(hr)) {
-        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreatePixelShader (unlit) failed", hr);
-        vsBlob->Release();
         return false;
     }
 
-    ID3DBlob* psLitBlob = nullptr;
-    hr = compileHlsl(kShader, "PSLit", "ps_5_0", "g4f_gfx_create: compile PSLit", &psLitBlob);
-    if (FAILED(hr) || !psLitBlob) { vsBlob->Release(); return false; }
-    hr = gfx->device->CreatePixelShader(psLitBlob->GetBufferPointer(), psLitBlob->GetBufferSize(), nullptr, &gfx->psLit);
-    psLitBlob->Release();
-    if (FAILED(hr) || !gfx->psLit) {
-        if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreatePixelShader (lit) failed", hr);
-        else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreatePixelShader (lit) returned null");
-        vsBlob->Release();
-        return false;
+    for (int perm = 0; perm < G4F_MATERIAL_SHADER_COUNT; perm++) {
+        // Keys never combine clustered with unlit (see g4f_material_key_make); skip those shaders.
+        if ((perm & G4F_MATERIAL_SHADER_CLUSTERED) && !(perm & G4F_MATERIAL_SHADER_LIT)) continue;
+        char defines[128];
+        std::snprintf(defines, sizeof(defines),
+                      "#define G4F_LIT %d\n#define G4F_TEXTURED %d\n#define G4F_ALPHA_TEST %d\n#define G4F_CLUSTERED %d\n",
+                      (perm & G4F_MATERIAL_SHADER_LIT) ? 1 : 0,
+                      (perm & G4F_MATERIAL_SHADER_TEXTURED) ? 1 : 0,
+                      (perm & G4F_MATERIAL_SHADER_ALPHA_TEST) ? 1 : 0,
+                      (perm & G4F_MATERIAL_SHADER_CLUSTERED) ? 1 : 0);
+        const std::string source = std::string(defines) + kShader;
+
+        ID3DBlob* psBlob = nullptr;
+        hr = compileHlsl(gfx, source.c_str(), "PSMain", "ps_5_0", "g4f_gfx_create: compile PSMain (material permutation)", &psBlob);
+        if (FAILED(hr) || !psBlob) { vsBlob->Release(); return false; }
+        hr = gfx->device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &gfx->psMesh[perm]);
+        psBlob->Release();
+        if (FAILED(hr) || !gfx->psMesh[perm]) {
+            if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreatePixelShader (material permutation) failed", hr);
+            else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreatePixelShader (material permutation) returned null");
+            vsBlob->Release();
+            return false;
+        }
     }
 
     D3D11_INPUT_ELEMENT_DESC il[] = {
@@ -530,29 +706,192 @@ float4 PSLit(PSIn i) : SV_Target {
         return false;
     }
 
-    D3D11_SAMPLER_DESC samp{};
-    samp.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
-    samp.AddressU = D3D11_TEXTURE_ADDRESS_CLAMP;
-    samp.AddressV = D3D11_TEXTURE_ADDRESS_CLAMP;
-    samp.AddressW = D3D11_TEXTURE_ADDRESS_CLAMP;
-    samp.ComparisonFunc = D3D11_COMPARISON_NEVER;
-    samp.MinLOD = 0;
-    samp.MaxLOD = D3D11_FLOAT32_MAX;
-    hr = gfx->device->CreateSamplerState(&samp, &gfx->sampLinearClamp);
-    if (FAILED(hr) || !gfx->sampLinearClamp) {
-        if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateSamplerState failed", hr);
-        else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateSamplerState returned null");
+    // Zero-filled: cascadeCount 0 keeps lit shaders unshadowed until g4f_gfx_set_shadow_cascades.
+    const CbShadow noShadow{};
+    D3D11_SUBRESOURCE_DATA noShadowData{};
+    noShadowData.pSysMem = &noShadow;
+    cbDesc.ByteWidth = (UINT)sizeof(CbShadow);
+    hr = gfx->device->CreateBuffer(&cbDesc, &noShadowData, &gfx->cbShadow);
+    if (FAILED(hr) || !gfx->cbShadow) {
+        if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateBuffer(cbShadow) failed", hr);
+        else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateBuffer(cbShadow) returned null");
+        return false;
+    }
+
+    // Zero-filled: lightCount 0 keeps clustered shaders on the directional light until lights are set.
+    const CbClusters noClusters{};
+    D3D11_SUBRESOURCE_DATA noClustersData{};
+    noClustersData.pSysMem = &noClusters;
+    cbDesc.ByteWidth = (UINT)sizeof(CbClusters);
+    hr = gfx->device->CreateBuffer(&cbDesc, &noClustersData, &gfx->cbClusters);
+    if (FAILED(hr) || !gfx->cbClusters) {
+        if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateBuffer(cbClusters) failed", hr);
+        else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateBuffer(cbClusters) returned null");
+        return false;
+    }
+
+    static const D3D11_FILTER kFilters[3] = {
+        D3D11_FILTER_MIN_MAG_MIP_LINEAR,
+        D3D11_FILTER_MIN_MAG_MIP_POINT,
+        D3D11_FILTER_ANISOTROPIC,
+    };
+    static const D3D11_TEXTURE_ADDRESS_MODE kAddress[2] = {
+        D3D11_TEXTURE_ADDRESS_CLAMP,
+        D3D11_TEXTURE_ADDRESS_WRAP,
+    };
+    for (int f = 0; f < 3; f++) {
+        for (int a = 0; a < 2; a++) {
+            D3D11_SAMPLER_DESC samp{};
+            samp.Filter = kFilters[f];
+            samp.AddressU = kAddress[a];
+            samp.AddressV = kAddress[a];
+            samp.AddressW = kAddress[a];
+            samp.MaxAnisotropy = (f == G4F_GFX_FILTER_ANISOTROPIC) ? 8u : 1u;
+            samp.ComparisonFunc = D3D11_COMPARISON_NEVER;
+            samp.MinLOD = 0;
+            samp.MaxLOD = D3D11_FLOAT32_MAX;
+            hr = gfx->device->CreateSamplerState(&samp, &gfx->samplers[f][a]);
+            if (FAILED(hr) || !gfx->samplers[f][a]) {
+                if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateSamplerState failed", hr);
+                else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateSamplerState returned null");
+                return false;
+            }
+        }
+    }
+
+    // Shadow compare: bilinear PCF; outside the map counts as lit.
+    D3D11_SAMPLER_DESC shadowSamp{};
+    shadowSamp.Filter = D3D11_FILTER_COMPARISON_MIN_MAG_LINEAR_MIP_POINT;
+    shadowSamp.AddressU = D3D11_TEXTURE_ADDRESS_BORDER;
+    shadowSamp.AddressV = D3D11_TEXTURE_ADDRESS_BORDER;
+    shadowSamp.AddressW = D3D11_TEXTURE_ADDRESS_BORDER;
+    shadowSamp.BorderColor[0] = shadowSamp.BorderColor[1] = shadowSamp.BorderColor[2] = shadowSamp.BorderColor[3] = 1.0f;
+    shadowSamp.ComparisonFunc = D3D11_COMPARISON_LESS_EQUAL;
+    shadowSamp.MaxLOD = D3D11_FLOAT32_MAX;
+    hr = gfx->device->CreateSamplerState(&shadowSamp, &gfx->sampShadow);
+    if (FAILED(hr) || !gfx->sampShadow) {
+        if (FAILED(hr)) setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateSamplerState(shadow) failed", hr);
+        else setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateSamplerState(shadow) returned null");
         return false;
     }
 
     return true;
 }
 
+// Fullscreen-triangle copy used for upscaling offscreen passes (no vertex buffer, SV_VertexID).
+static bool gfxCreateBlitPipeline(g4f_gfx* gfx) {
+    static const char* kShader = R"(
+Texture2D uTex0 : register(t0);
+SamplerState uSamp0 : register(s0);
+struct PSIn { float4 pos : SV_Position; float2 uv : TEXCOORD0; };
+PSIn VSBlit(uint id : SV_VertexID) {
+  PSIn o;
+  float2 uv = float2((id << 1) & 2, id & 2);
+  o.pos = float4(uv * float2(2.0, -2.0) + float2(-1.0, 1.0), 0.0, 1.0);
+  o.uv = uv;
+  return o;
+}
+float4 PSBlit(PSIn i) : SV_Target { return uTex0.Sample(uSamp0, i.uv); }
+    )";
+
+    ID3DBlob* vsBlob = nullptr;
+    ID3DBlob* psBlob = nullptr;
+    HRESULT hr = compileHlsl(gfx, kShader, "VSBlit", "vs_5_0", "g4f_gfx_create: compile VSBlit", &vsBlob);
+    if (FAILED(hr) || !vsBlob) return false;
+    hr = compileHlsl(gfx, kShader, "PSBlit", "ps_5_0", "g4f_gfx_create: compile PSBlit", &psBlob);
+    if (FAILED(hr) || !psBlob) { vsBlob->Release(); return false; }
+
+    hr = gfx->device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &gfx->vsBlit);
+    vsBlob->Release();
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreateVertexShader (blit) failed", hr);
+        psBlob->Release();
+        return false;
+    }
+    hr = gfx->device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &gfx->psBlit);
+    psBlob->Release();
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_create", "device->CreatePixelShader (blit) failed", hr);
+        return false;
+    }
+    return true;
+}
+
+static void gpuTimerFrameBegin(void* user, int slot) {
+    auto* gfx = static_cast<g4f_gfx*>(user);
+    gfx->ctx->Begin(gfx->tsDisjoint[slot]);
+}
+
+static void gpuTimerMark(void* user, int slot, int mark) {
+    auto* gfx = static_cast<g4f_gfx*>(user);
+    gfx->ctx->End(gfx->tsMarks[slot][mark]);
+}
+
+static void gpuTimerFrameEnd(void* user, int slot) {
+    auto* gfx = static_cast<g4f_gfx*>(user);
+    gfx->ctx->End(gfx->tsDisjoint[slot]);
+}
+
+// Polls without flushing; the timer only asks for slots submitted in earlier frames.
+static int gpuTimerResolve(void* user, int slot, int markCount, uint64_t* ticks, uint64_t* ticksPerSecond) {
+    auto* gfx = static_cast<g4f_gfx*>(user);
+    D3D11_QUERY_DATA_TIMESTAMP_DISJOINT dj{};
+    HRESULT hr = gfx->ctx->GetData(gfx->tsDisjoint[slot], &dj, sizeof(dj), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+    if (hr == S_FALSE) return 0;
+    if (FAILED(hr) || dj.Disjoint || dj.Frequency == 0) return -1;
+    for (int i = 0; i < markCount; i++) {
+        UINT64 t = 0;
+        hr = gfx->ctx->GetData(gfx->tsMarks[slot][i], &t, sizeof(t), D3D11_ASYNC_GETDATA_DONOTFLUSH);
+        if (hr == S_FALSE) return 0;
+        if (FAILED(hr)) return -1;
+        ticks[i] = (uint64_t)t;
+    }
+    *ticksPerSecond = (uint64_t)dj.Frequency;
+    return 1;
+}
+
+static void gfxReleaseGpuTimer(g4f_gfx* gfx) {
+    g4f_gpu_timer_destroy(gfx->gpuTimer);
+    gfx->gpuTimer = nullptr;
+    for (auto*& q : gfx->tsDisjoint) safeRelease((IUnknown**)&q);
+    for (auto& row : gfx->tsMarks) {
+        for (auto*& q : row) safeRelease((IUnknown**)&q);
+    }
+}
+
+// Timings are diagnostics: when the queries cannot be created, fall back to CPU clock timings.
+static void gfxCreateGpuTimer(g4f_gfx* gfx) {
+    D3D11_QUERY_DESC disjointDesc{};
+    disjointDesc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+    D3D11_QUERY_DESC stampDesc{};
+    stampDesc.Query = D3D11_QUERY_TIMESTAMP;
+    bool ok = true;
+    for (int slot = 0; slot < G4F_GPU_TIMER_RING && ok; slot++) {
+        ok = SUCCEEDED(gfx->device->CreateQuery(&disjointDesc, &gfx->tsDisjoint[slot]));
+        for (int mark = 0; mark < G4F_GPU_TIMER_MAX_MARKS && ok; mark++) {
+            ok = SUCCEEDED(gfx->device->CreateQuery(&stampDesc, &gfx->tsMarks[slot][mark]));
+        }
+    }
+    if (!ok) {
+        gfxReleaseGpuTimer(gfx);
+        gfx->gpuTimer = g4f_gpu_timer_create(nullptr, G4F_GPU_TIMINGS_CPU);
+        return;
+    }
+    g4f_gpu_timer_backend backend{};
+    backend.user = gfx;
+    backend.frame_begin = gpuTimerFrameBegin;
+    backend.mark = gpuTimerMark;
+    backend.frame_end = gpuTimerFrameEnd;
+    backend.resolve = gpuTimerResolve;
+    gfx->gpuTimer = g4f_gpu_timer_create(&backend, G4F_GPU_TIMINGS_GPU);
+}
+
 g4f_gfx* g4f_gfx_create(g4f_window* window) {
     if (!window) {
         g4f_set_last_error("g4f_gfx_create: window is null");
         return nullptr;
     }
+    const auto createBegin = std::chrono::steady_clock::now();
     auto* gfx = new g4f_gfx();
     gfx->window = window;
 
@@ -617,16 +956,67 @@ g4f_gfx* g4f_gfx_create(g4f_window* window) {
         return nullptr;
     }
 
+    if (!gfxCreateBlitPipeline(gfx)) {
+        setLastErrorIfEmptyWithPrefix("g4f_gfx_create", "blit pipeline creation failed");
+        g4f_gfx_destroy(gfx);
+        return nullptr;
+    }
+
+    gfxCreateGpuTimer(gfx);
+    g4f_gfx_frame_stats_reset(&gfx->frameStats); // startup objects are not part of frame 0
+
+    gfx->startup.createMs = msSince(createBegin);
     return gfx;
 }
 
+void g4f_gfx_set_shader_cache_dir(const char* dirUtf8) {
+    g_shaderCacheDirSet = dirUtf8 != nullptr;
+    g_shaderCacheDir = dirUtf8 ? dirUtf8 : "";
+}
+
+void g4f_gfx_get_startup_stats(const g4f_gfx* gfx, g4f_gfx_startup_stats* out) {
+    if (!out) return;
+    *out = gfx ? gfx->startup : g4f_gfx_startup_stats{};
+}
+
 void g4f_gfx_destroy(g4f_gfx* gfx) {
     if (!gfx) return;
-    safeRelease((IUnknown**)&gfx->sampLinearClamp);
+    gfxReleaseGpuTimer(gfx);
+    g4f_gfx_texture_destroy(gfx->particleWhite);
+    safeRelease((IUnknown**)&gfx->bsAdditive);
+    safeRelease((IUnknown**)&gfx->vbParticle);
+    safeRelease((IUnknown**)&gfx->cbParticle);
+    safeRelease((IUnknown**)&gfx->ilParticle);
+    safeRelease((IUnknown**)&gfx->psParticle);
+    safeRelease((IUnknown**)&gfx->vsParticle);
+    g4f_gfx_texture_destroy(gfx->spriteWhite);
+    safeRelease((IUnknown**)&gfx->ibSprite);
+    safeRelease((IUnknown**)&gfx->vbSprite);
+    safeRelease((IUnknown**)&gfx->cbSprite);
+    safeRelease((IUnknown**)&gfx->ilSprite);
+    safeRelease((IUnknown**)&gfx->psSprite);
+    safeRelease((IUnknown**)&gfx->vsSprite);
+    for (auto& row : gfx->samplers) {
+        for (auto*& samp : row) safeRelease((IUnknown**)&samp);
+    }
+    safeRelease((IUnknown**)&gfx->psBlit);
+    safeRelease((IUnknown**)&gfx->vsBlit);
+    for (auto*& dsv : gfx->shadowDsv) safeRelease((IUnknown**)&dsv);
+    safeRelease((IUnknown**)&gfx->shadowSrv);
+    safeRelease((IUnknown**)&gfx->shadowTex);
+    safeRelease((IUnknown**)&gfx->rsShadow);
+    safeRelease((IUnknown**)&gfx->sampShadow);
+    safeRelease((IUnknown**)&gfx->cbShadow);
+    safeRelease((IUnknown**)&gfx->lightIndexSrv);
+    safeRelease((IUnknown**)&gfx->lightIndexBuf);
+    safeRelease((IUnknown**)&gfx->clusterRangeSrv);
+    safeRelease((IUnknown**)&gfx->clusterRangeBuf);
+    safeRelease((IUnknown**)&gfx->lightSrv);
+    safeRelease((IUnknown**)&gfx->lightBuf);
+    safeRelease((IUnknown**)&gfx->cbClusters);
     safeRelease((IUnknown**)&gfx->cbUnlit);
     safeRelease((IUnknown**)&gfx->ilUnlit);
-    safeRelease((IUnknown**)&gfx->psLit);
-    safeRelease((IUnknown**)&gfx->psUnlit);
+    for (auto*& ps : gfx->psMesh) safeRelease((IUnknown**)&ps);
     safeRelease((IUnknown**)&gfx->vsUnlit);
     safeRelease((IUnknown**)&gfx->cbMvp);
     safeRelease((IUnknown**)&gfx->ib);
@@ -654,11 +1044,14 @@ void g4f_gfx_destroy(g4f_gfx* gfx) {
 void g4f_gfx_begin(g4f_gfx* gfx, uint32_t clearRgba) {
     if (!gfx || !gfx->ctx) return;
     if (!gfxEnsureSize(gfx, "g4f_gfx_begin")) return;
+    g4f_gpu_timer_frame_begin(gfx->gpuTimer);
 
     float clear[4];
     rgbaU32ToFloat4(clearRgba, clear);
 
+    g4f_pass_stack_reset(&gfx->passes, gfx->cachedW, gfx->cachedH);
     gfx->ctx->OMSetRenderTargets(1, &gfx->rtv, gfx->dsv);
+    gfxCountBind(gfx, G4F_GFX_STATE_TARGET);
     gfx->ctx->ClearRenderTargetView(gfx->rtv, clear);
     gfx->ctx->ClearDepthStencilView(gfx->dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
 
@@ -666,9 +1059,13 @@ void g4f_gfx_begin(g4f_gfx* gfx, uint32_t clearRgba) {
     gfx->ctx->OMSetDepthStencilState(gfx->dsDepthLess, 0);
     float blendFactor[4] = {0, 0, 0, 0};
     gfx->ctx->OMSetBlendState(gfx->bsOpaque, blendFactor, 0xFFFFFFFFu);
+    gfxCountBind(gfx, G4F_GFX_STATE_RASTERIZER);
+    gfxCountBind(gfx, G4F_GFX_STATE_DEPTH);
+    gfxCountBind(gfx, G4F_GFX_STATE_BLEND);
 
     // Reset state cache each frame (simple + robust).
     gfx->cachePipeline = 0;
+    gfx->cacheBundle = -1;
     gfx->cacheIL = nullptr;
     gfx->cacheVS = nullptr;
     gfx->cachePS = nullptr;
@@ -684,6 +1081,9 @@ void g4f_gfx_begin(g4f_gfx* gfx, uint32_t clearRgba) {
     gfx->cacheSamp0 = nullptr;
     gfx->cacheCB0VS = nullptr;
     gfx->cacheCB0PS = nullptr;
+    gfx->clustersBound = 0;
+    gfx->shadowBound = 0;
+    gfx->shadowPassActive = 0;
 
     D3D11_VIEWPORT vp{};
     vp.TopLeftX = 0;
@@ -731,6 +1131,128 @@ void g4f_gfx_set_light_colors(g4f_gfx* gfx, uint32_t lightRgba, uint32_t ambient
     rgbaU32ToFloat4(ambientRgba, gfx->ambientColor);
 }
 
+// Grows (power of two) a dynamic structured buffer + SRV and maps it for a full rewrite.
+static void* gfxMapStructured(g4f_gfx* gfx, ID3D11Buffer** buf, ID3D11ShaderResourceView** srv, UINT* capacity,
+                              UINT count, UINT stride, const char* what) {
+    if (count == 0) count = 1;
+    if (!*buf || *capacity < count) {
+        UINT cap = 64;
+        while (cap < count) cap *= 2;
+        safeRelease((IUnknown**)srv);
+        safeRelease((IUnknown**)buf);
+        *capacity = 0;
+
+        D3D11_BUFFER_DESC desc{};
+        desc.ByteWidth = cap * stride;
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        desc.StructureByteStride = stride;
+        HRESULT hr = gfx->device->CreateBuffer(&desc, nullptr, buf);
+        if (FAILED(hr) || !*buf) {
+            g4f_set_last_errorf("g4f_gfx_set_light_clusters: CreateBuffer(%s) failed (hr=0x%08lX)", what, (unsigned long)hr);
+            return nullptr;
+        }
+        D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+        sd.Format = DXGI_FORMAT_UNKNOWN;
+        sd.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        sd.Buffer.FirstElement = 0;
+        sd.Buffer.NumElements = cap;
+        hr = gfx->device->CreateShaderResourceView(*buf, &sd, srv);
+        if (FAILED(hr) || !*srv) {
+            safeRelease((IUnknown**)buf);
+            g4f_set_last_errorf("g4f_gfx_set_light_clusters: CreateShaderResourceView(%s) failed (hr=0x%08lX)", what, (unsigned long)hr);
+            return nullptr;
+        }
+        *capacity = cap;
+        gfx->clustersBound = 0;
+        gfxCountCreated(gfx, 2);
+    }
+
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    HRESULT hr = gfx->ctx->Map(*buf, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr) || !mapped.pData) {
+        g4f_set_last_errorf("g4f_gfx_set_light_clusters: Map(%s) failed (hr=0x%08lX)", what, (unsigned long)hr);
+        return nullptr;
+    }
+    gfx->frameStats.bufferBytes += (uint64_t)count * stride;
+    return mapped.pData;
+}
+
+int g4f_gfx_set_light_clusters(g4f_gfx* gfx, const g4f_light* lights, int lightCount, const g4f_light_clusters* clusters) {
+    if (!gfx || !gfx->ctx || !gfx->cbClusters) { g4f_set_last_error("g4f_gfx_set_light_clusters: invalid gfx"); return 0; }
+    if (lightCount < 0 || (lightCount > 0 && (!lights || !clusters))) {
+        g4f_set_last_error("g4f_gfx_set_light_clusters: invalid args");
+        return 0;
+    }
+
+    CbClusters cb{};
+    cb.view = g4f_mat4_identity();
+    if (lightCount > 0) {
+        g4f_light_cluster_result r{};
+        g4f_light_clusters_get_result(clusters, &r);
+        if (r.clusterCount <= 0 || !r.ranges) { g4f_set_last_error("g4f_gfx_set_light_clusters: clusters were not built"); return 0; }
+
+        auto* gpuLights = (GpuLight*)gfxMapStructured(gfx, &gfx->lightBuf, &gfx->lightSrv, &gfx->lightCapacity,
+                                                       (UINT)lightCount, (UINT)sizeof(GpuLight), "lights");
+        if (!gpuLights) return 0;
+        for (int i = 0; i < lightCount; i++) {
+            const g4f_light& l = lights[i];
+            GpuLight& g = gpuLights[i];
+            float color[4];
+            rgbaU32ToFloat4(l.colorRgba, color);
+            g.posRadius[0] = l.position.x;
+            g.posRadius[1] = l.position.y;
+            g.posRadius[2] = l.position.z;
+            g.posRadius[3] = l.radius;
+            g.colorInner[0] = color[0] * l.intensity;
+            g.colorInner[1] = color[1] * l.intensity;
+            g.colorInner[2] = color[2] * l.intensity;
+            if (l.type == G4F_LIGHT_SPOT) {
+                // smoothstep(outer, inner, x) needs inner > outer.
+                const float inner = l.spotInnerCos > l.spotOuterCos ? l.spotInnerCos : l.spotOuterCos + 1e-4f;
+                g.colorInner[3] = inner;
+                g.dirOuter[0] = l.direction.x;
+                g.dirOuter[1] = l.direction.y;
+                g.dirOuter[2] = l.direction.z;
+                g.dirOuter[3] = l.spotOuterCos;
+            } else {
+                g.colorInner[3] = -1.0f;
+                g.dirOuter[0] = g.dirOuter[1] = g.dirOuter[2] = 0.0f;
+                g.dirOuter[3] = -2.0f;
+            }
+        }
+        gfx->ctx->Unmap(gfx->lightBuf, 0);
+
+        void* ranges = gfxMapStructured(gfx, &gfx->clusterRangeBuf, &gfx->clusterRangeSrv, &gfx->clusterRangeCapacity,
+                                        (UINT)r.clusterCount, (UINT)(sizeof(uint32_t) * 2), "ranges");
+        if (!ranges) return 0;
+        std::memcpy(ranges, r.ranges, sizeof(uint32_t) * 2 * (size_t)r.clusterCount);
+        gfx->ctx->Unmap(gfx->clusterRangeBuf, 0);
+
+        void* indices = gfxMapStructured(gfx, &gfx->lightIndexBuf, &gfx->lightIndexSrv, &gfx->lightIndexCapacity,
+                                         (UINT)r.indexCount, (UINT)sizeof(uint32_t), "indices");
+        if (!indices) return 0;
+        if (r.indexCount > 0) std::memcpy(indices, r.indices, sizeof(uint32_t) * (size_t)r.indexCount);
+        gfx->ctx->Unmap(gfx->lightIndexBuf, 0);
+
+        cb.view = r.view;
+        for (int row = 0; row < 4; row++) cb.view.m[row * 4 + 2] *= r.depthSign;
+        cb.params[0] = r.tanHalfX;
+        cb.params[1] = r.tanHalfY;
+        cb.params[2] = r.sliceScale;
+        cb.params[3] = r.nearZ;
+        cb.dims[0] = (uint32_t)r.tilesX;
+        cb.dims[1] = (uint32_t)r.tilesY;
+        cb.dims[2] = (uint32_t)r.slices;
+        cb.dims[3] = (uint32_t)lightCount;
+    }
+    gfx->ctx->UpdateSubresource(gfx->cbClusters, 0, nullptr, &cb, 0, 0);
+    gfx->frameStats.constantBytes += sizeof(cb);
+    return 1;
+}
+
 void g4f_gfx_draw_debug_cube(g4f_gfx* gfx, float timeSeconds) {
     if (!gfx || !gfx->ctx) return;
 
@@ -748,32 +1270,32 @@ void g4f_gfx_draw_debug_cube(g4f_gfx* gfx, float timeSeconds) {
         gfx->cacheSamp0 = nullptr;
     }
 
-    if (gfx->cacheIL != gfx->inputLayout) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INPUT_LAYOUT, gfx->cacheIL != gfx->inputLayout)) {
         gfx->ctx->IASetInputLayout(gfx->inputLayout);
         gfx->cacheIL = gfx->inputLayout;
     }
-    if (gfx->cacheVS != gfx->vs) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cacheVS != gfx->vs)) {
         gfx->ctx->VSSetShader(gfx->vs, nullptr, 0);
         gfx->cacheVS = gfx->vs;
     }
-    if (gfx->cachePS != gfx->ps) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cachePS != gfx->ps)) {
         gfx->ctx->PSSetShader(gfx->ps, nullptr, 0);
         gfx->cachePS = gfx->ps;
     }
 
     UINT stride = sizeof(Vertex);
     UINT offset = 0;
-    if (gfx->cacheVB != gfx->vb || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_VERTEX_BUFFER, gfx->cacheVB != gfx->vb || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset)) {
         gfx->ctx->IASetVertexBuffers(0, 1, &gfx->vb, &stride, &offset);
         gfx->cacheVB = gfx->vb;
         gfx->cacheVBStride = stride;
         gfx->cacheVBOffset = offset;
     }
-    if (gfx->cacheIB != gfx->ib) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INDEX_BUFFER, gfx->cacheIB != gfx->ib)) {
         gfx->ctx->IASetIndexBuffer(gfx->ib, DXGI_FORMAT_R16_UINT, 0);
         gfx->cacheIB = gfx->ib;
     }
-    if (gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TOPOLOGY, gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)) {
         gfx->ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         gfx->cacheTopo = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
     }
@@ -785,12 +1307,14 @@ void g4f_gfx_draw_debug_cube(g4f_gfx* gfx, float timeSeconds) {
     g4f_mat4 mvp = g4f_mat4_mul(g4f_mat4_mul(rot, view), proj);
 
     gfx->ctx->UpdateSubresource(gfx->cbMvp, 0, nullptr, &mvp, 0, 0);
-    if (gfx->cacheCB0VS != gfx->cbMvp) {
+    gfx->frameStats.constantBytes += sizeof(mvp);
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_CONSTANT_BUFFER, gfx->cacheCB0VS != gfx->cbMvp)) {
         gfx->ctx->VSSetConstantBuffers(0, 1, &gfx->cbMvp);
         gfx->cacheCB0VS = gfx->cbMvp;
     }
 
     gfx->ctx->DrawIndexed(gfx->indexCount, 0, 0);
+    gfxCountDraw(gfx, gfx->indexCount);
 }
 
 struct g4f_gfx_texture {
@@ -800,22 +1324,41 @@ struct g4f_gfx_texture {
     int width = 0;
     int height = 0;
     int dynamic = 0;
+    int mipLevels = 1;
+
+    // Streaming textures: CPU writes land in `shadow` and are tracked as dirty rects; on flush the
+    // rects are copied into the next staging texture of the ring and then into `tex`, so the CPU can
+    // fill frame N+1 while the GPU is still copying/sampling frame N.
+    int ownedByTarget = 0; // color buffer of a g4f_gfx_target, destroyed with it
+
+    int streaming = 0;
+    std::vector<uint8_t> shadow;
+    ID3D11Texture2D* staging[3]{};
+    int stagingIndex = 0;
+    g4f_dirty_rects dirty{};
 };
 
 struct g4f_gfx_material {
+    g4f_gfx* owner = nullptr;
     float tint[4]{1.0f, 1.0f, 1.0f, 1.0f};
     ID3D11ShaderResourceView* srv = nullptr; // optional
     int lit = 0;
+    int clustered = 0; // lit materials only; adds the g4f_gfx_set_light_clusters lights
+    int alphaTest = 0;
     int alphaBlend = 0;
     int depthTest = 1;
     int depthWrite = 1;
     int cullMode = 0; // 0 back, 1 none, 2 front
+    int samplerFilter = G4F_GFX_FILTER_LINEAR;
+    int samplerAddress = G4F_GFX_ADDRESS_CLAMP;
+    int bundle = -1; // index into owner->bundles; the draw path only looks at this
 };
 
 struct g4f_gfx_mesh {
     ID3D11Buffer* vb = nullptr;
     ID3D11Buffer* ib = nullptr;
-    UINT indexCount = 0;
+    UINT indexCount = 0;          // level 0
+    g4f_lod_chain* lod = nullptr; // levels share vb; ib holds every level back to back
 };
 
 g4f_gfx_texture* g4f_gfx_texture_create_rgba8(g4f_gfx* gfx, int width, int height, const void* rgbaPixels, int rowPitchBytes) {
@@ -863,6 +1406,8 @@ g4f_gfx_texture* g4f_gfx_texture_create_rgba8(g4f_gfx* gfx, int width, int heigh
         return nullptr;
     }
 
+    gfxCountCreated(gfx, 2);
+    gfx->frameStats.textureBytes += (uint64_t)width * (uint64_t)height * 4;
     return texture;
 }
 
@@ -907,9 +1452,198 @@ g4f_gfx_texture* g4f_gfx_texture_create_rgba8_dynamic(g4f_gfx* gfx, int width, i
         return nullptr;
     }
 
+    gfxCountCreated(gfx, 2);
+    return texture;
+}
+
+g4f_gfx_texture* g4f_gfx_texture_create_rgba8_streaming(g4f_gfx* gfx, int width, int height) {
+    if (!gfx || !gfx->device) { g4f_set_last_error("g4f_gfx_texture_create_rgba8_streaming: invalid gfx"); return nullptr; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_gfx_texture_create_rgba8_streaming: invalid size"); return nullptr; }
+
+    auto* texture = new g4f_gfx_texture();
+    texture->owner = gfx;
+    texture->width = width;
+    texture->height = height;
+    texture->streaming = 1;
+    texture->shadow.assign((size_t)width * (size_t)height * 4, 0);
+    g4f_dirty_rects_reset(&texture->dirty, width, height);
+
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width = (UINT)width;
+    desc.Height = (UINT)height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    D3D11_SUBRESOURCE_DATA data{};
+    data.pSysMem = texture->shadow.data();
+    data.SysMemPitch = (UINT)(width * 4);
+
+    HRESULT hr = gfx->device->CreateTexture2D(&desc, &data, &texture->tex);
+    if (FAILED(hr) || !texture->tex) {
+        g4f_set_last_hresult_error("g4f_gfx_texture_create_rgba8_streaming: CreateTexture2D failed", hr);
+        g4f_gfx_texture_destroy(texture);
+        return nullptr;
+    }
+
+    D3D11_TEXTURE2D_DESC stagingDesc = desc;
+    stagingDesc.Usage = D3D11_USAGE_STAGING;
+    stagingDesc.BindFlags = 0;
+    stagingDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+    for (auto*& st : texture->staging) {
+        hr = gfx->device->CreateTexture2D(&stagingDesc, nullptr, &st);
+        if (FAILED(hr) || !st) {
+            g4f_set_last_hresult_error("g4f_gfx_texture_create_rgba8_streaming: CreateTexture2D(staging) failed", hr);
+            g4f_gfx_texture_destroy(texture);
+            return nullptr;
+        }
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = 1;
+
+    hr = gfx->device->CreateShaderResourceView(texture->tex, &srvDesc, &texture->srv);
+    if (FAILED(hr) || !texture->srv) {
+        g4f_set_last_hresult_error("g4f_gfx_texture_create_rgba8_streaming: CreateShaderResourceView failed", hr);
+        g4f_gfx_texture_destroy(texture);
+        return nullptr;
+    }
+
+    gfxCountCreated(gfx, 2 + (int)(sizeof(texture->staging) / sizeof(texture->staging[0])));
+    gfx->frameStats.textureBytes += (uint64_t)width * (uint64_t)height * 4;
     return texture;
 }
 
+namespace {
+
+static void streamingWriteRegion(g4f_gfx_texture* texture, int x, int y, int w, int h, const void* rgbaPixels, int rowPitchBytes) {
+    if (texture->dirty.count == 0) texture->owner->pendingUploads.push_back(texture);
+    const uint8_t* src = (const uint8_t*)rgbaPixels;
+    const size_t dstPitch = (size_t)texture->width * 4;
+    for (int row = 0; row < h; row++) {
+        std::memcpy(texture->shadow.data() + (size_t)(y + row) * dstPitch + (size_t)x * 4, src + (size_t)row * (size_t)rowPitchBytes, (size_t)w * 4);
+    }
+    g4f_dirty_rects_add(&texture->dirty, x, y, w, h);
+}
+
+static int streamingFlush(g4f_gfx_texture* texture) {
+    if (texture->dirty.count == 0) return 1;
+    ID3D11DeviceContext* ctx = texture->owner->ctx;
+    ID3D11Texture2D* st = texture->staging[texture->stagingIndex];
+
+    // D3D11_MAP_WRITE keeps the untouched parts of the staging texture; only the dirty rects are
+    // refreshed from the shadow copy and then copied into the sampled texture.
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    HRESULT hr = ctx->Map(st, 0, D3D11_MAP_WRITE, 0, &mapped);
+    if (FAILED(hr)) {
+        g4f_set_last_hresult_error("g4f_gfx_texture_flush: Map(staging) failed", hr);
+        return 0;
+    }
+    const size_t srcPitch = (size_t)texture->width * 4;
+    for (int i = 0; i < texture->dirty.count; i++) {
+        const g4f_rect_i& r = texture->dirty.rects[i];
+        for (int row = 0; row < r.h; row++) {
+            size_t srcOffset = (size_t)(r.y + row) * srcPitch + (size_t)r.x * 4;
+            size_t dstOffset = (size_t)(r.y + row) * (size_t)mapped.RowPitch + (size_t)r.x * 4;
+            std::memcpy((uint8_t*)mapped.pData + dstOffset, texture->shadow.data() + srcOffset, (size_t)r.w * 4);
+        }
+    }
+    ctx->Unmap(st, 0);
+
+    for (int i = 0; i < texture->dirty.count; i++) {
+        const g4f_rect_i& r = texture->dirty.rects[i];
+        D3D11_BOX box{};
+        box.left = (UINT)r.x;
+        box.top = (UINT)r.y;
+        box.front = 0;
+        box.right = (UINT)(r.x + r.w);
+        box.bottom = (UINT)(r.y + r.h);
+        box.back = 1;
+        ctx->CopySubresourceRegion(texture->tex, 0, (UINT)r.x, (UINT)r.y, 0, st, 0, &box);
+        texture->owner->frameStats.textureBytes += (uint64_t)r.w * (uint64_t)r.h * 4;
+    }
+
+    texture->stagingIndex = (texture->stagingIndex + 1) % (int)(sizeof(texture->staging) / sizeof(texture->staging[0]));
+    g4f_dirty_rects_clear(&texture->dirty);
+    return 1;
+}
+
+static void gfxFlushPendingUploads(g4f_gfx* gfx) {
+    // Textures whose staging Map failed stay queued and are retried on the next flush.
+    auto& pending = gfx->pendingUploads;
+    size_t keep = 0;
+    for (g4f_gfx_texture* texture : pending) {
+        if (!streamingFlush(texture)) pending[keep++] = texture;
+    }
+    pending.resize(keep);
+}
+
+} // namespace
+
+int g4f_gfx_texture_update_region_rgba8(g4f_gfx_texture* texture, int x, int y, int width, int height, const void* rgbaPixels, int rowPitchBytes) {
+    if (!texture || !texture->owner || !texture->owner->ctx || !texture->tex) {
+        g4f_set_last_error("g4f_gfx_texture_update_region_rgba8: invalid texture/owner");
+        return 0;
+    }
+    if (!rgbaPixels || width <= 0 || height <= 0) {
+        g4f_set_last_error("g4f_gfx_texture_update_region_rgba8: invalid args");
+        return 0;
+    }
+    if (x < 0 || y < 0 || x + width > texture->width || y + height > texture->height) {
+        g4f_set_last_error("g4f_gfx_texture_update_region_rgba8: region out of bounds");
+        return 0;
+    }
+    if (rowPitchBytes <= 0) rowPitchBytes = width * 4;
+    if (rowPitchBytes < width * 4) {
+        g4f_set_last_error("g4f_gfx_texture_update_region_rgba8: rowPitchBytes too small");
+        return 0;
+    }
+    if (texture->mipLevels > 1) {
+        g4f_set_last_error("g4f_gfx_texture_update_region_rgba8: mipmapped textures are immutable");
+        return 0;
+    }
+    if (texture->dynamic) {
+        // WRITE_DISCARD throws away the previous contents, so partial writes need the streaming path.
+        g4f_set_last_error("g4f_gfx_texture_update_region_rgba8: dynamic textures only support full updates (use g4f_gfx_texture_create_rgba8_streaming)");
+        return 0;
+    }
+
+    if (texture->streaming) {
+        streamingWriteRegion(texture, x, y, width, height, rgbaPixels, rowPitchBytes);
+        return 1;
+    }
+
+    D3D11_BOX box{};
+    box.left = (UINT)x;
+    box.top = (UINT)y;
+    box.front = 0;
+    box.right = (UINT)(x + width);
+    box.bottom = (UINT)(y + height);
+    box.back = 1;
+    texture->owner->ctx->UpdateSubresource(texture->tex, 0, &box, rgbaPixels, (UINT)rowPitchBytes, 0);
+    texture->owner->frameStats.textureBytes += (uint64_t)width * (uint64_t)height * 4;
+    return 1;
+}
+
+int g4f_gfx_texture_flush(g4f_gfx_texture* texture) {
+    if (!texture || !texture->owner || !texture->owner->ctx) {
+        g4f_set_last_error("g4f_gfx_texture_flush: invalid texture/owner");
+        return 0;
+    }
+    if (!texture->streaming || texture->dirty.count == 0) return 1;
+    auto& pending = texture->owner->pendingUploads;
+    pending.erase(std::remove(pending.begin(), pending.end(), texture), pending.end());
+    if (streamingFlush(texture)) return 1;
+    pending.push_back(texture);
+    return 0;
+}
+
 int g4f_gfx_texture_update_rgba8(g4f_gfx_texture* texture, const void* rgbaPixels, int rowPitchBytes) {
     if (!texture || !texture->owner || !texture->owner->ctx) {
         g4f_set_last_error("g4f_gfx_texture_update_rgba8: invalid texture/owner");
@@ -919,6 +1653,10 @@ int g4f_gfx_texture_update_rgba8(g4f_gfx_texture* texture, const void* rgbaPixel
         g4f_set_last_error("g4f_gfx_texture_update_rgba8: invalid args");
         return 0;
     }
+    if (texture->mipLevels > 1) {
+        g4f_set_last_error("g4f_gfx_texture_update_rgba8: mipmapped textures are immutable");
+        return 0;
+    }
     if (texture->width <= 0 || texture->height <= 0) {
         g4f_set_last_error("g4f_gfx_texture_update_rgba8: invalid texture size");
         return 0;
@@ -930,6 +1668,11 @@ int g4f_gfx_texture_update_rgba8(g4f_gfx_texture* texture, const void* rgbaPixel
         return 0;
     }
 
+    if (texture->streaming) {
+        streamingWriteRegion(texture, 0, 0, texture->width, texture->height, rgbaPixels, rowPitchBytes);
+        return 1;
+    }
+
     if (texture->dynamic) {
         D3D11_MAPPED_SUBRESOURCE mapped{};
         HRESULT hr = texture->owner->ctx->Map(texture->tex, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
@@ -946,6 +1689,7 @@ int g4f_gfx_texture_update_rgba8(g4f_gfx_texture* texture, const void* rgbaPixel
         }
 
         texture->owner->ctx->Unmap(texture->tex, 0);
+        texture->owner->frameStats.textureBytes += (uint64_t)minRowPitchBytes * (uint64_t)texture->height;
         return 1;
     }
 
@@ -957,6 +1701,7 @@ int g4f_gfx_texture_update_rgba8(g4f_gfx_texture* texture, const void* rgbaPixel
     box.bottom = (UINT)texture->height;
     box.back = 1;
     texture->owner->ctx->UpdateSubresource(texture->tex, 0, &box, rgbaPixels, (UINT)rowPitchBytes, 0);
+    texture->owner->frameStats.textureBytes += (uint64_t)minRowPitchBytes * (uint64_t)texture->height;
     return 1;
 }
 
@@ -981,44 +1726,569 @@ g4f_gfx_texture* g4f_gfx_texture_create_checker_rgba8(g4f_gfx* gfx, int width, i
     return g4f_gfx_texture_create_rgba8(gfx, width, height, pixels.data(), width * 4);
 }
 
-void g4f_gfx_texture_destroy(g4f_gfx_texture* texture) {
-    if (!texture) return;
-    safeRelease((IUnknown**)&texture->srv);
-    safeRelease((IUnknown**)&texture->tex);
-    delete texture;
-}
-
-void g4f_gfx_texture_get_size(const g4f_gfx_texture* texture, int* width, int* height) {
-    if (!texture) return;
-    if (width) *width = texture->width;
-    if (height) *height = texture->height;
-}
-
-g4f_gfx_material* g4f_gfx_material_create_unlit(g4f_gfx* gfx, const g4f_gfx_material_unlit_desc* desc) {
-    if (!gfx) { g4f_set_last_error("g4f_gfx_material_create_unlit: gfx is null"); return nullptr; }
-    auto* material = new g4f_gfx_material();
-
-    uint32_t rgba = desc ? desc->tintRgba : g4f_rgba_u32(255, 255, 255, 255);
-    rgbaU32ToFloat4(rgba, material->tint);
+g4f_gfx_texture* g4f_gfx_texture_create_rgba8_mipmapped(g4f_gfx* gfx, int width, int height, const void* rgbaPixels, int rowPitchBytes, int mipFilter, int mipFlags) {
+    if (!gfx || !gfx->device || !rgbaPixels) { g4f_set_last_error("g4f_gfx_texture_create_rgba8_mipmapped: invalid args"); return nullptr; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_gfx_texture_create_rgba8_mipmapped: invalid size"); return nullptr; }
 
-    if (desc && desc->texture && desc->texture->srv) {
-        material->srv = desc->texture->srv;
-        material->srv->AddRef();
+    const int levels = g4f_mipgen_level_count(width, height);
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(width, height, levels));
+    if (g4f_mipgen_build_chain_rgba8(rgbaPixels, width, height, rowPitchBytes, levels, mipFilter, mipFlags, nullptr, chain.data()) != levels) {
+        setLastErrorIfEmptyWithPrefix("g4f_gfx_texture_create_rgba8_mipmapped", "mip chain generation failed");
+        return nullptr;
     }
 
-    material->alphaBlend = (desc && desc->alphaBlend) ? 1 : 0;
-    material->depthTest = (!desc || desc->depthTest) ? 1 : 0;
-    material->depthWrite = (!desc || desc->depthWrite) ? 1 : 0;
-    material->cullMode = desc ? desc->cullMode : 0;
-    if (material->cullMode < 0) material->cullMode = 0;
-    if (material->cullMode > 2) material->cullMode = 2;
+    std::vector<D3D11_SUBRESOURCE_DATA> data((size_t)levels);
+    size_t offset = 0;
+    for (int i = 0; i < levels; i++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, i, &w, &h);
+        data[(size_t)i].pSysMem = chain.data() + offset;
+        data[(size_t)i].SysMemPitch = (UINT)(w * 4);
+        offset += (size_t)w * (size_t)h * 4;
+    }
 
+    auto* texture = new g4f_gfx_texture();
+    texture->owner = gfx;
+    texture->width = width;
+    texture->height = height;
+    texture->dynamic = 0;
+    texture->mipLevels = levels;
+
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width = (UINT)width;
+    desc.Height = (UINT)height;
+    desc.MipLevels = (UINT)levels;
+    desc.ArraySize = 1;
+    desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    HRESULT hr = gfx->device->CreateTexture2D(&desc, data.data(), &texture->tex);
+    if (FAILED(hr) || !texture->tex) {
+        g4f_set_last_hresult_error("g4f_gfx_texture_create_rgba8_mipmapped: CreateTexture2D failed", hr);
+        g4f_gfx_texture_destroy(texture);
+        return nullptr;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = (UINT)levels;
+
+    hr = gfx->device->CreateShaderResourceView(texture->tex, &srvDesc, &texture->srv);
+    if (FAILED(hr) || !texture->srv) {
+        g4f_set_last_hresult_error("g4f_gfx_texture_create_rgba8_mipmapped: CreateShaderResourceView failed", hr);
+        g4f_gfx_texture_destroy(texture);
+        return nullptr;
+    }
+
+    gfxCountCreated(gfx, 2);
+    gfx->frameStats.textureBytes += chain.size();
+    return texture;
+}
+
+void g4f_gfx_texture_destroy(g4f_gfx_texture* texture) {
+    if (!texture) return;
+    if (texture->ownedByTarget) {
+        g4f_set_last_error("g4f_gfx_texture_destroy: texture belongs to a render target (use g4f_gfx_target_destroy)");
+        return;
+    }
+    if (texture->owner && texture->dirty.count > 0) {
+        auto& pending = texture->owner->pendingUploads;
+        pending.erase(std::remove(pending.begin(), pending.end(), texture), pending.end());
+    }
+    for (auto*& st : texture->staging) safeRelease((IUnknown**)&st);
+    safeRelease((IUnknown**)&texture->srv);
+    safeRelease((IUnknown**)&texture->tex);
+    delete texture;
+}
+
+void g4f_gfx_texture_get_size(const g4f_gfx_texture* texture, int* width, int* height) {
+    if (!texture) return;
+    if (width) *width = texture->width;
+    if (height) *height = texture->height;
+}
+
+int g4f_gfx_texture_mip_levels(const g4f_gfx_texture* texture) {
+    return texture ? texture->mipLevels : 0;
+}
+
+struct g4f_gfx_target {
+    g4f_gfx* owner = nullptr;
+    int width = 0;
+    int height = 0;
+    int format = G4F_GFX_FORMAT_RGBA8;
+    g4f_gfx_texture* color = nullptr;
+    ID3D11RenderTargetView* rtv = nullptr;
+    ID3D11Texture2D* depthTex = nullptr; // optional
+    ID3D11DepthStencilView* dsv = nullptr;
+};
+
+namespace {
+
+static DXGI_FORMAT targetDxgiFormat(int format) {
+    switch (format) {
+        case G4F_GFX_FORMAT_RGBA16F: return DXGI_FORMAT_R16G16B16A16_FLOAT;
+        case G4F_GFX_FORMAT_R32F: return DXGI_FORMAT_R32_FLOAT;
+        default: return DXGI_FORMAT_R8G8B8A8_UNORM;
+    }
+}
+
+static void gfxBindPassState(g4f_gfx* gfx, const g4f_pass_state& state) {
+    const auto* target = (const g4f_gfx_target*)state.target;
+    ID3D11RenderTargetView* rtv = target ? target->rtv : gfx->rtv;
+    ID3D11DepthStencilView* dsv = target ? target->dsv : gfx->dsv;
+    gfx->ctx->OMSetRenderTargets(1, &rtv, dsv);
+    gfxCountBind(gfx, G4F_GFX_STATE_TARGET);
+
+    D3D11_VIEWPORT vp{};
+    vp.TopLeftX = 0;
+    vp.TopLeftY = 0;
+    vp.Width = (FLOAT)state.width;
+    vp.Height = (FLOAT)state.height;
+    vp.MinDepth = 0.0f;
+    vp.MaxDepth = 1.0f;
+    gfx->ctx->RSSetViewports(1, &vp);
+}
+
+} // namespace
+
+g4f_gfx_target* g4f_gfx_target_create(g4f_gfx* gfx, int width, int height, int format, int depth) {
+    if (!gfx || !gfx->device) { g4f_set_last_error("g4f_gfx_target_create: invalid gfx"); return nullptr; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_gfx_target_create: invalid size"); return nullptr; }
+    if (format < G4F_GFX_FORMAT_RGBA8 || format > G4F_GFX_FORMAT_R32F) { g4f_set_last_error("g4f_gfx_target_create: invalid format"); return nullptr; }
+
+    auto* target = new g4f_gfx_target();
+    target->owner = gfx;
+    target->width = width;
+    target->height = height;
+    target->format = format;
+    target->color = new g4f_gfx_texture();
+    target->color->owner = gfx;
+    target->color->width = width;
+    target->color->height = height;
+    target->color->ownedByTarget = 1;
+
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width = (UINT)width;
+    desc.Height = (UINT)height;
+    desc.MipLevels = 1;
+    desc.ArraySize = 1;
+    desc.Format = targetDxgiFormat(format);
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_DEFAULT;
+    desc.BindFlags = D3D11_BIND_RENDER_TARGET | D3D11_BIND_SHADER_RESOURCE;
+
+    HRESULT hr = gfx->device->CreateTexture2D(&desc, nullptr, &target->color->tex);
+    if (FAILED(hr) || !target->color->tex) {
+        g4f_set_last_hresult_error("g4f_gfx_target_create: CreateTexture2D(color) failed", hr);
+        g4f_gfx_target_destroy(target);
+        return nullptr;
+    }
+    hr = gfx->device->CreateRenderTargetView(target->color->tex, nullptr, &target->rtv);
+    if (FAILED(hr) || !target->rtv) {
+        g4f_set_last_hresult_error("g4f_gfx_target_create: CreateRenderTargetView failed", hr);
+        g4f_gfx_target_destroy(target);
+        return nullptr;
+    }
+    hr = gfx->device->CreateShaderResourceView(target->color->tex, nullptr, &target->color->srv);
+    if (FAILED(hr) || !target->color->srv) {
+        g4f_set_last_hresult_error("g4f_gfx_target_create: CreateShaderResourceView failed", hr);
+        g4f_gfx_target_destroy(target);
+        return nullptr;
+    }
+
+    if (depth) {
+        D3D11_TEXTURE2D_DESC depthDesc = desc;
+        depthDesc.Format = DXGI_FORMAT_D24_UNORM_S8_UINT;
+        depthDesc.BindFlags = D3D11_BIND_DEPTH_STENCIL;
+        hr = gfx->device->CreateTexture2D(&depthDesc, nullptr, &target->depthTex);
+        if (FAILED(hr) || !target->depthTex) {
+            g4f_set_last_hresult_error("g4f_gfx_target_create: CreateTexture2D(depth) failed", hr);
+            g4f_gfx_target_destroy(target);
+            return nullptr;
+        }
+        hr = gfx->device->CreateDepthStencilView(target->depthTex, nullptr, &target->dsv);
+        if (FAILED(hr) || !target->dsv) {
+            g4f_set_last_hresult_error("g4f_gfx_target_create: CreateDepthStencilView failed", hr);
+            g4f_gfx_target_destroy(target);
+            return nullptr;
+        }
+    }
+
+    gfxCountCreated(gfx, depth ? 5 : 3);
+    return target;
+}
+
+void g4f_gfx_target_destroy(g4f_gfx_target* target) {
+    if (!target) return;
+    if (target->owner && g4f_pass_stack_is_open(&target->owner->passes, target)) {
+        g4f_set_last_error("g4f_gfx_target_destroy: target has an open pass");
+        return;
+    }
+    if (target->owner && target->color && target->owner->cacheSRV0 == target->color->srv) {
+        target->owner->cacheSRV0 = nullptr;
+    }
+    safeRelease((IUnknown**)&target->dsv);
+    safeRelease((IUnknown**)&target->depthTex);
+    safeRelease((IUnknown**)&target->rtv);
+    if (target->color) {
+        target->color->ownedByTarget = 0;
+        g4f_gfx_texture_destroy(target->color);
+    }
+    delete target;
+}
+
+g4f_gfx_texture* g4f_gfx_target_texture(g4f_gfx_target* target) {
+    return target ? target->color : nullptr;
+}
+
+void g4f_gfx_target_get_size(const g4f_gfx_target* target, int* width, int* height) {
+    if (!target) return;
+    if (width) *width = target->width;
+    if (height) *height = target->height;
+}
+
+int g4f_gfx_pass_begin(g4f_gfx* gfx, g4f_gfx_target* target, int clearFlags, uint32_t clearRgba) {
+    if (!gfx || !gfx->ctx || !target || target->owner != gfx) {
+        g4f_set_last_error("g4f_gfx_pass_begin: invalid args");
+        return 0;
+    }
+    if (!g4f_pass_stack_push(&gfx->passes, target, target->width, target->height)) {
+        setLastErrorIfEmptyWithPrefix("g4f_gfx_pass_begin", "pass stack push failed");
+        return 0;
+    }
+
+    // A texture cannot be sampled while it is bound for output.
+    if (gfx->cacheSRV0 == target->color->srv) {
+        ID3D11ShaderResourceView* nullSrv = nullptr;
+        gfx->ctx->PSSetShaderResources(0, 1, &nullSrv);
+        gfx->cacheSRV0 = nullptr;
+        gfxCountBind(gfx, G4F_GFX_STATE_TEXTURE);
+    }
+    gfxBindPassState(gfx, g4f_pass_stack_current(&gfx->passes));
+    g4f_gpu_timer_scope_begin(gfx->gpuTimer, "offscreen pass");
+
+    if (clearFlags & G4F_GFX_PASS_CLEAR_COLOR) {
+        float clear[4];
+        rgbaU32ToFloat4(clearRgba, clear);
+        gfx->ctx->ClearRenderTargetView(target->rtv, clear);
+    }
+    if ((clearFlags & G4F_GFX_PASS_CLEAR_DEPTH) && target->dsv) {
+        gfx->ctx->ClearDepthStencilView(target->dsv, D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+    }
+    return 1;
+}
+
+void g4f_gfx_pass_end(g4f_gfx* gfx) {
+    if (!gfx || !gfx->ctx) return;
+    if (!g4f_pass_stack_pop(&gfx->passes)) return;
+    g4f_gpu_timer_scope_end(gfx->gpuTimer);
+    gfxBindPassState(gfx, g4f_pass_stack_current(&gfx->passes));
+}
+
+void g4f_gfx_pass_get_size(const g4f_gfx* gfx, int* width, int* height) {
+    if (!gfx) return;
+    g4f_pass_state state = g4f_pass_stack_current(&gfx->passes);
+    if (width) *width = state.width;
+    if (height) *height = state.height;
+}
+
+g4f_gfx_shadow_desc g4f_gfx_shadow_desc_default(void) {
+    g4f_gfx_shadow_desc desc{};
+    desc.size = 2048;
+    desc.cascadeCount = 4;
+    desc.depthBias = 16;
+    desc.slopeBias = 2.0f;
+    desc.compareBias = 0.001f;
+    return desc;
+}
+
+static void gfxShadowRelease(g4f_gfx* gfx) {
+    if (gfx->cacheRS == gfx->rsShadow) gfx->cacheRS = nullptr; // a new state may reuse the address
+    for (auto*& dsv : gfx->shadowDsv) safeRelease((IUnknown**)&dsv);
+    safeRelease((IUnknown**)&gfx->shadowSrv);
+    safeRelease((IUnknown**)&gfx->shadowTex);
+    safeRelease((IUnknown**)&gfx->rsShadow);
+    gfx->shadowSize = 0;
+    gfx->shadowCascades = 0;
+}
+
+int g4f_gfx_shadow_configure(g4f_gfx* gfx, const g4f_gfx_shadow_desc* desc) {
+    if (!gfx || !gfx->device) { g4f_set_last_error("g4f_gfx_shadow_configure: invalid gfx"); return 0; }
+    if (gfx->shadowPassActive) { g4f_set_last_error("g4f_gfx_shadow_configure: shadow pass is open"); return 0; }
+    if (desc && (desc->size <= 0 || desc->size > D3D11_REQ_TEXTURE2D_U_OR_V_DIMENSION ||
+                 desc->cascadeCount <= 0 || desc->cascadeCount > G4F_SHADOW_MAX_CASCADES)) {
+        g4f_set_last_error("g4f_gfx_shadow_configure: invalid desc");
+        return 0;
+    }
+
+    // Lit shaders must not keep sampling the old map.
+    if (gfx->ctx) {
+        ID3D11ShaderResourceView* nullSrv = nullptr;
+        gfx->ctx->PSSetShaderResources(4, 1, &nullSrv);
+        if (gfx->cbShadow) {
+            const CbShadow off{};
+            gfx->ctx->UpdateSubresource(gfx->cbShadow, 0, nullptr, &off, 0, 0);
+            gfx->frameStats.constantBytes += sizeof(off);
+        }
+    }
+    gfx->shadowBound = 0;
+    gfxShadowRelease(gfx);
+    if (!desc) return 1;
+
+    D3D11_TEXTURE2D_DESC td{};
+    td.Width = (UINT)desc->size;
+    td.Height = (UINT)desc->size;
+    td.MipLevels = 1;
+    td.ArraySize = (UINT)desc->cascadeCount;
+    td.Format = DXGI_FORMAT_R32_TYPELESS;
+    td.SampleDesc.Count = 1;
+    td.Usage = D3D11_USAGE_DEFAULT;
+    td.BindFlags = D3D11_BIND_DEPTH_STENCIL | D3D11_BIND_SHADER_RESOURCE;
+    HRESULT hr = gfx->device->CreateTexture2D(&td, nullptr, &gfx->shadowTex);
+    if (FAILED(hr) || !gfx->shadowTex) {
+        g4f_set_last_hresult_error("g4f_gfx_shadow_configure: CreateTexture2D failed", hr);
+        gfxShadowRelease(gfx);
+        return 0;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC sd{};
+    sd.Format = DXGI_FORMAT_R32_FLOAT;
+    sd.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+    sd.Texture2DArray.MipLevels = 1;
+    sd.Texture2DArray.ArraySize = td.ArraySize;
+    hr = gfx->device->CreateShaderResourceView(gfx->shadowTex, &sd, &gfx->shadowSrv);
+    if (FAILED(hr) || !gfx->shadowSrv) {
+        g4f_set_last_hresult_error("g4f_gfx_shadow_configure: CreateShaderResourceView failed", hr);
+        gfxShadowRelease(gfx);
+        return 0;
+    }
+
+    for (int c = 0; c < desc->cascadeCount; c++) {
+        D3D11_DEPTH_STENCIL_VIEW_DESC dd{};
+        dd.Format = DXGI_FORMAT_D32_FLOAT;
+        dd.ViewDimension = D3D11_DSV_DIMENSION_TEXTURE2DARRAY;
+        dd.Texture2DArray.FirstArraySlice = (UINT)c;
+        dd.Texture2DArray.ArraySize = 1;
+        hr = gfx->device->CreateDepthStencilView(gfx->shadowTex, &dd, &gfx->shadowDsv[c]);
+        if (FAILED(hr) || !gfx->shadowDsv[c]) {
+            g4f_set_last_hresult_error("g4f_gfx_shadow_configure: CreateDepthStencilView failed", hr);
+            gfxShadowRelease(gfx);
+            return 0;
+        }
+    }
+
+    // Depth clip off: casters in front of the cascade's near plane are clamped to it ("pancaking"),
+    // so the light projection only has to cover the receivers.
+    D3D11_RASTERIZER_DESC rs{};
+    rs.FillMode = D3D11_FILL_SOLID;
+    rs.CullMode = D3D11_CULL_BACK;
+    rs.DepthBias = desc->depthBias;
+    rs.SlopeScaledDepthBias = desc->slopeBias;
+    rs.DepthClipEnable = FALSE;
+    hr = gfx->device->CreateRasterizerState(&rs, &gfx->rsShadow);
+    if (FAILED(hr) || !gfx->rsShadow) {
+        g4f_set_last_hresult_error("g4f_gfx_shadow_configure: CreateRasterizerState failed", hr);
+        gfxShadowRelease(gfx);
+        return 0;
+    }
+
+    gfx->shadowSize = desc->size;
+    gfx->shadowCascades = desc->cascadeCount;
+    gfx->shadowCompareBias = desc->compareBias;
+    gfxCountCreated(gfx, 3 + desc->cascadeCount);
+    return 1;
+}
+
+int g4f_gfx_shadow_pass_begin(g4f_gfx* gfx, int index, const g4f_shadow_cascade* cascade) {
+    if (!gfx || !gfx->ctx || !cascade) { g4f_set_last_error("g4f_gfx_shadow_pass_begin: invalid args"); return 0; }
+    if (index < 0 || index >= gfx->shadowCascades) { g4f_set_last_error("g4f_gfx_shadow_pass_begin: cascade index out of range"); return 0; }
+    if (gfx->shadowPassActive) { g4f_set_last_error("g4f_gfx_shadow_pass_begin: shadow pass already open"); return 0; }
+    if (!gfx->pendingUploads.empty()) gfxFlushPendingUploads(gfx);
+    char scopeName[G4F_GPU_TIMER_NAME_MAX];
+    std::snprintf(scopeName, sizeof(scopeName), "shadow cascade %d", index);
+    g4f_gpu_timer_scope_begin(gfx->gpuTimer, scopeName);
+
+    // The map cannot be sampled while one of its slices is bound for depth output.
+    ID3D11ShaderResourceView* nullSrv = nullptr;
+    gfx->ctx->PSSetShaderResources(4, 1, &nullSrv);
+    gfx->shadowBound = 0;
+    gfxCountBind(gfx, G4F_GFX_STATE_TEXTURE);
+
+    gfx->ctx->OMSetRenderTargets(0, nullptr, gfx->shadowDsv[index]);
+    gfxCountBind(gfx, G4F_GFX_STATE_TARGET);
+    gfx->ctx->ClearDepthStencilView(gfx->shadowDsv[index], D3D11_CLEAR_DEPTH, 1.0f, 0);
+    D3D11_VIEWPORT vp{};
+    vp.Width = (FLOAT)gfx->shadowSize;
+    vp.Height = (FLOAT)gfx->shadowSize;
+    vp.MaxDepth = 1.0f;
+    gfx->ctx->RSSetViewports(1, &vp);
+
+    // Depth-only pipeline: the mesh vertex shader with no pixel shader.
+    if (gfx->cachePipeline != 4) {
+        gfx->cachePipeline = 4;
+        gfx->cacheVB = nullptr;
+        gfx->cacheIB = nullptr;
+        gfx->cacheCB0VS = nullptr;
+        gfx->cacheBundle = -1;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INPUT_LAYOUT, gfx->cacheIL != gfx->ilUnlit)) {
+        gfx->ctx->IASetInputLayout(gfx->ilUnlit);
+        gfx->cacheIL = gfx->ilUnlit;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cacheVS != gfx->vsUnlit)) {
+        gfx->ctx->VSSetShader(gfx->vsUnlit, nullptr, 0);
+        gfx->cacheVS = gfx->vsUnlit;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cachePS != nullptr)) {
+        gfx->ctx->PSSetShader(nullptr, nullptr, 0);
+        gfx->cachePS = nullptr;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TOPOLOGY, gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)) {
+        gfx->ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        gfx->cacheTopo = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_DEPTH, gfx->cacheDepth != gfx->dsDepthLess)) {
+        gfx->ctx->OMSetDepthStencilState(gfx->dsDepthLess, 0);
+        gfx->cacheDepth = gfx->dsDepthLess;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_RASTERIZER, gfx->cacheRS != gfx->rsShadow)) {
+        gfx->ctx->RSSetState(gfx->rsShadow);
+        gfx->cacheRS = gfx->rsShadow;
+    }
+
+    gfx->shadowPassViewProj = cascade->viewProj;
+    gfx->shadowPassActive = 1;
+    return 1;
+}
+
+void g4f_gfx_draw_shadow_caster(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_mat4* model) {
+    if (!gfx || !gfx->ctx || !gfx->shadowPassActive) return;
+    if (!mesh || !mesh->vb || !mesh->ib) return;
+
+    UINT stride = (UINT)sizeof(g4f_gfx_vertex_p3n3uv2);
+    UINT offset = 0;
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_VERTEX_BUFFER, gfx->cacheVB != mesh->vb || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset)) {
+        gfx->ctx->IASetVertexBuffers(0, 1, &mesh->vb, &stride, &offset);
+        gfx->cacheVB = mesh->vb;
+        gfx->cacheVBStride = stride;
+        gfx->cacheVBOffset = offset;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INDEX_BUFFER, gfx->cacheIB != mesh->ib)) {
+        gfx->ctx->IASetIndexBuffer(mesh->ib, DXGI_FORMAT_R16_UINT, 0);
+        gfx->cacheIB = mesh->ib;
+    }
+
+    CbMaterial cb{};
+    cb.model = model ? *model : g4f_mat4_identity();
+    cb.mvp = g4f_mat4_mul(cb.model, gfx->shadowPassViewProj);
+    gfx->ctx->UpdateSubresource(gfx->cbUnlit, 0, nullptr, &cb, 0, 0);
+    gfx->frameStats.constantBytes += sizeof(cb);
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_CONSTANT_BUFFER, gfx->cacheCB0VS != gfx->cbUnlit)) {
+        gfx->ctx->VSSetConstantBuffers(0, 1, &gfx->cbUnlit);
+        gfx->cacheCB0VS = gfx->cbUnlit;
+    }
+
+    gfx->ctx->DrawIndexed(mesh->indexCount, 0, 0);
+    gfxCountDraw(gfx, mesh->indexCount);
+}
+
+void g4f_gfx_shadow_pass_end(g4f_gfx* gfx) {
+    if (!gfx || !gfx->ctx || !gfx->shadowPassActive) return;
+    gfx->shadowPassActive = 0;
+    g4f_gpu_timer_scope_end(gfx->gpuTimer);
+    gfxBindPassState(gfx, g4f_pass_stack_current(&gfx->passes));
+}
+
+int g4f_gfx_set_shadow_cascades(g4f_gfx* gfx, const g4f_shadow_cascade* cascades, int count) {
+    if (!gfx || !gfx->ctx || !gfx->cbShadow) { g4f_set_last_error("g4f_gfx_set_shadow_cascades: invalid gfx"); return 0; }
+    if (count < 0 || count > gfx->shadowCascades || (count > 0 && !cascades)) {
+        g4f_set_last_error("g4f_gfx_set_shadow_cascades: invalid args (configure the shadow map first)");
+        return 0;
+    }
+    CbShadow cb{};
+    for (int c = 0; c < count; c++) cb.viewProj[c] = cascades[c].viewProj;
+    cb.params[0] = (float)count;
+    cb.params[1] = gfx->shadowCompareBias;
+    cb.params[2] = gfx->shadowSize > 0 ? 1.0f / (float)gfx->shadowSize : 0.0f;
+    gfx->ctx->UpdateSubresource(gfx->cbShadow, 0, nullptr, &cb, 0, 0);
+    gfx->frameStats.constantBytes += sizeof(cb);
+    return 1;
+}
+
+static void gfxBakeStateBundle(g4f_gfx* gfx, int id, uint32_t key) {
+    g4f_material_state state{};
+    g4f_material_key_unpack(key, &state);
+    g4f_gfx_state_bundle& bundle = gfx->bundles[id];
+    bundle.ps = gfx->psMesh[g4f_material_key_shader(key)];
+    bundle.blend = state.alphaBlend ? gfx->bsAlpha : gfx->bsOpaque;
+    if (!state.depthTest) bundle.depth = gfx->dsDisabled;
+    else bundle.depth = state.depthWrite ? gfx->dsDepthLess : gfx->dsDepthLessNoWrite;
+    bundle.rs = gfx->rsCullBack;
+    if (state.cullMode == 1) bundle.rs = gfx->rsCullNone;
+    if (state.cullMode == 2) bundle.rs = gfx->rsCullFront;
+    bundle.samp = gfx->samplers[state.samplerFilter][state.samplerAddress];
+}
+
+// Re-resolves the material's bundle after a state change; identical states share one bundle.
+static void materialRebake(g4f_gfx_material* material) {
+    g4f_gfx* gfx = material->owner;
+    g4f_material_state state{};
+    state.lit = material->lit;
+    state.textured = material->srv ? 1 : 0;
+    state.alphaTest = material->alphaTest;
+    state.clustered = material->clustered;
+    state.alphaBlend = material->alphaBlend;
+    state.depthTest = material->depthTest;
+    state.depthWrite = material->depthWrite;
+    state.cullMode = material->cullMode;
+    state.samplerFilter = material->samplerFilter;
+    state.samplerAddress = material->samplerAddress;
+    const uint32_t key = g4f_material_key_make(&state);
+
+    int added = 0;
+    const int id = g4f_material_bundle_table_intern(&gfx->bundleKeys, key, &added);
+    if (id < 0) return; // unreachable: the table holds every normalized key
+    if (added) gfxBakeStateBundle(gfx, id, key);
+    material->bundle = id;
+}
+
+g4f_gfx_material* g4f_gfx_material_create_unlit(g4f_gfx* gfx, const g4f_gfx_material_unlit_desc* desc) {
+    if (!gfx) { g4f_set_last_error("g4f_gfx_material_create_unlit: gfx is null"); return nullptr; }
+    auto* material = new g4f_gfx_material();
+    material->owner = gfx;
+
+    uint32_t rgba = desc ? desc->tintRgba : g4f_rgba_u32(255, 255, 255, 255);
+    rgbaU32ToFloat4(rgba, material->tint);
+
+    if (desc && desc->texture && desc->texture->srv) {
+        material->srv = desc->texture->srv;
+        material->srv->AddRef();
+    }
+
+    material->alphaTest = (desc && desc->alphaTest) ? 1 : 0;
+    material->clustered = (desc && desc->clusteredLights) ? 1 : 0;
+    material->alphaBlend = (desc && desc->alphaBlend) ? 1 : 0;
+    material->depthTest = (!desc || desc->depthTest) ? 1 : 0;
+    material->depthWrite = (!desc || desc->depthWrite) ? 1 : 0;
+    material->cullMode = desc ? desc->cullMode : 0;
+    if (material->cullMode < 0) material->cullMode = 0;
+    if (material->cullMode > 2) material->cullMode = 2;
+    if (desc) g4f_gfx_material_set_sampler(material, desc->samplerFilter, desc->samplerAddress);
+
+    materialRebake(material);
     return material;
 }
 
 g4f_gfx_material* g4f_gfx_material_create_lit(g4f_gfx* gfx, const g4f_gfx_material_unlit_desc* desc) {
     g4f_gfx_material* m = g4f_gfx_material_create_unlit(gfx, desc);
-    if (m) m->lit = 1;
+    if (m) {
+        m->lit = 1;
+        materialRebake(m);
+    }
     return m;
 }
 
@@ -1040,17 +2310,26 @@ void g4f_gfx_material_set_texture(g4f_gfx_material* material, g4f_gfx_texture* t
         material->srv = texture->srv;
         material->srv->AddRef();
     }
+    materialRebake(material);
+}
+
+void g4f_gfx_material_set_alpha_test(g4f_gfx_material* material, int enabled) {
+    if (!material) return;
+    material->alphaTest = enabled ? 1 : 0;
+    materialRebake(material);
 }
 
 void g4f_gfx_material_set_alpha_blend(g4f_gfx_material* material, int enabled) {
     if (!material) return;
     material->alphaBlend = enabled ? 1 : 0;
+    materialRebake(material);
 }
 
 void g4f_gfx_material_set_depth(g4f_gfx_material* material, int depthTest, int depthWrite) {
     if (!material) return;
     material->depthTest = depthTest ? 1 : 0;
     material->depthWrite = depthWrite ? 1 : 0;
+    materialRebake(material);
 }
 
 void g4f_gfx_material_set_cull(g4f_gfx_material* material, int cullMode) {
@@ -1059,6 +2338,18 @@ void g4f_gfx_material_set_cull(g4f_gfx_material* material, int cullMode) {
     if (cm < 0) cm = 0;
     if (cm > 2) cm = 2;
     material->cullMode = cm;
+    materialRebake(material);
+}
+
+void g4f_gfx_material_set_sampler(g4f_gfx_material* material, int filter, int address) {
+    if (!material) return;
+    material->samplerFilter = (filter >= G4F_GFX_FILTER_LINEAR && filter <= G4F_GFX_FILTER_ANISOTROPIC) ? filter : G4F_GFX_FILTER_LINEAR;
+    material->samplerAddress = (address == G4F_GFX_ADDRESS_WRAP) ? G4F_GFX_ADDRESS_WRAP : G4F_GFX_ADDRESS_CLAMP;
+    materialRebake(material);
+}
+
+int g4f_gfx_material_bundle_id(const g4f_gfx_material* material) {
+    return material ? material->bundle : -1;
 }
 
 g4f_gfx_mesh* g4f_gfx_mesh_create_p3n3uv2(g4f_gfx* gfx, const g4f_gfx_vertex_p3n3uv2* vertices, int vertexCount, const uint16_t* indices, int indexCount) {
@@ -1095,6 +2386,8 @@ g4f_gfx_mesh* g4f_gfx_mesh_create_p3n3uv2(g4f_gfx* gfx, const g4f_gfx_vertex_p3n
         return nullptr;
     }
 
+    gfxCountCreated(gfx, 2);
+    gfx->frameStats.bufferBytes += (uint64_t)vbDesc.ByteWidth + ibDesc.ByteWidth;
     return mesh;
 }
 
@@ -1144,10 +2437,41 @@ g4f_gfx_mesh* g4f_gfx_mesh_create_plane_xz_p3n3uv2(g4f_gfx* gfx, float halfExten
     return g4f_gfx_mesh_create_p3n3uv2(gfx, vertices, 4, indices, 6);
 }
 
+g4f_gfx_mesh* g4f_gfx_mesh_create_lod_p3n3uv2(g4f_gfx* gfx, const g4f_gfx_vertex_p3n3uv2* vertices, int vertexCount, const uint16_t* indices, int indexCount, const g4f_lod_chain_desc* desc) {
+    if (!gfx || !gfx->device) { g4f_set_last_error("g4f_gfx_mesh_create_lod_p3n3uv2: invalid gfx"); return nullptr; }
+    if (!vertices || vertexCount <= 0) { g4f_set_last_error("g4f_gfx_mesh_create_lod_p3n3uv2: invalid vertices"); return nullptr; }
+
+    g4f_lod_mesh_desc source = g4f_lod_mesh_desc_default();
+    source.positions = &vertices[0].px;
+    source.positionStride = (int)sizeof(g4f_gfx_vertex_p3n3uv2);
+    source.vertexCount = vertexCount;
+    source.indices16 = indices;
+    source.indexCount = indexCount;
+    g4f_lod_chain* chain = g4f_lod_chain_create(&source, desc);
+    if (!chain) return nullptr;
+
+    int chainIndexCount = 0;
+    const uint32_t* chainIndices = g4f_lod_chain_indices(chain, &chainIndexCount);
+    const std::vector<uint16_t> packed(chainIndices, chainIndices + chainIndexCount); // levels only reuse source vertices
+    g4f_gfx_mesh* mesh = g4f_gfx_mesh_create_p3n3uv2(gfx, vertices, vertexCount, packed.data(), chainIndexCount);
+    if (!mesh) {
+        g4f_lod_chain_destroy(chain);
+        return nullptr;
+    }
+    mesh->indexCount = (UINT)g4f_lod_chain_level(chain, 0).indexCount;
+    mesh->lod = chain;
+    return mesh;
+}
+
+const g4f_lod_chain* g4f_gfx_mesh_lod_chain(const g4f_gfx_mesh* mesh) {
+    return mesh ? mesh->lod : nullptr;
+}
+
 void g4f_gfx_mesh_destroy(g4f_gfx_mesh* mesh) {
     if (!mesh) return;
     safeRelease((IUnknown**)&mesh->ib);
     safeRelease((IUnknown**)&mesh->vb);
+    g4f_lod_chain_destroy(mesh->lod);
     delete mesh;
 }
 
@@ -1155,10 +2479,13 @@ void g4f_gfx_draw_mesh(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_gfx_mat
     g4f_gfx_draw_mesh_xform(gfx, mesh, material, nullptr, mvp);
 }
 
-void g4f_gfx_draw_mesh_xform(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material, const g4f_mat4* model, const g4f_mat4* mvp) {
+namespace {
+
+static void gfxDrawMeshRange(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material, const g4f_mat4* model, const g4f_mat4* mvp, UINT firstIndex, UINT indexCount) {
     if (!gfx || !gfx->ctx) return;
     if (!mesh || !mesh->vb || !mesh->ib) return;
-    if (!material || !mvp) return;
+    if (!material || material->bundle < 0 || !mvp) return;
+    if (!gfx->pendingUploads.empty()) gfxFlushPendingUploads(gfx);
 
     if (gfx->cachePipeline != 2) {
         gfx->cachePipeline = 2;
@@ -1172,59 +2499,62 @@ void g4f_gfx_draw_mesh_xform(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_g
         gfx->cacheCB0PS = nullptr;
         gfx->cacheSRV0 = nullptr;
         gfx->cacheSamp0 = nullptr;
+        gfx->cacheBundle = -1;
+        gfx->clustersBound = 0;
+        gfx->shadowBound = 0;
     }
 
-    if (gfx->cacheIL != gfx->ilUnlit) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INPUT_LAYOUT, gfx->cacheIL != gfx->ilUnlit)) {
         gfx->ctx->IASetInputLayout(gfx->ilUnlit);
         gfx->cacheIL = gfx->ilUnlit;
     }
-    if (gfx->cacheVS != gfx->vsUnlit) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cacheVS != gfx->vsUnlit)) {
         gfx->ctx->VSSetShader(gfx->vsUnlit, nullptr, 0);
         gfx->cacheVS = gfx->vsUnlit;
     }
-    ID3D11PixelShader* desiredPS = material->lit ? gfx->psLit : gfx->psUnlit;
-    if (gfx->cachePS != desiredPS) {
-        gfx->ctx->PSSetShader(desiredPS, nullptr, 0);
-        gfx->cachePS = desiredPS;
-    }
 
     UINT stride = (UINT)sizeof(g4f_gfx_vertex_p3n3uv2);
     UINT offset = 0;
-    if (gfx->cacheVB != mesh->vb || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_VERTEX_BUFFER, gfx->cacheVB != mesh->vb || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset)) {
         gfx->ctx->IASetVertexBuffers(0, 1, &mesh->vb, &stride, &offset);
         gfx->cacheVB = mesh->vb;
         gfx->cacheVBStride = stride;
         gfx->cacheVBOffset = offset;
     }
-    if (gfx->cacheIB != mesh->ib) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INDEX_BUFFER, gfx->cacheIB != mesh->ib)) {
         gfx->ctx->IASetIndexBuffer(mesh->ib, DXGI_FORMAT_R16_UINT, 0);
         gfx->cacheIB = mesh->ib;
     }
-    if (gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TOPOLOGY, gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)) {
         gfx->ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
         gfx->cacheTopo = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
     }
 
-    // Per-material pipeline state.
-    float blendFactor[4] = {0, 0, 0, 0};
-    ID3D11BlendState* desiredBlend = material->alphaBlend ? gfx->bsAlpha : gfx->bsOpaque;
-    if (gfx->cacheBlend != desiredBlend) {
-        gfx->ctx->OMSetBlendState(desiredBlend, blendFactor, 0xFFFFFFFFu);
-        gfx->cacheBlend = desiredBlend;
-    }
-    ID3D11DepthStencilState* desiredDepth = nullptr;
-    if (!material->depthTest) desiredDepth = gfx->dsDisabled;
-    else desiredDepth = material->depthWrite ? gfx->dsDepthLess : gfx->dsDepthLessNoWrite;
-    if (gfx->cacheDepth != desiredDepth) {
-        gfx->ctx->OMSetDepthStencilState(desiredDepth, 0);
-        gfx->cacheDepth = desiredDepth;
-    }
-    ID3D11RasterizerState* rs = gfx->rsCullBack;
-    if (material->cullMode == 1) rs = gfx->rsCullNone;
-    if (material->cullMode == 2) rs = gfx->rsCullFront;
-    if (gfx->cacheRS != rs) {
-        gfx->ctx->RSSetState(rs);
-        gfx->cacheRS = rs;
+    // Per-material pipeline state: one ID compare while consecutive draws share a bundle.
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_MATERIAL, gfx->cacheBundle != material->bundle)) {
+        const g4f_gfx_state_bundle& bundle = gfx->bundles[material->bundle];
+        if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cachePS != bundle.ps)) {
+            gfx->ctx->PSSetShader(bundle.ps, nullptr, 0);
+            gfx->cachePS = bundle.ps;
+        }
+        if (gfxStateDiffers(gfx, G4F_GFX_STATE_BLEND, gfx->cacheBlend != bundle.blend)) {
+            float blendFactor[4] = {0, 0, 0, 0};
+            gfx->ctx->OMSetBlendState(bundle.blend, blendFactor, 0xFFFFFFFFu);
+            gfx->cacheBlend = bundle.blend;
+        }
+        if (gfxStateDiffers(gfx, G4F_GFX_STATE_DEPTH, gfx->cacheDepth != bundle.depth)) {
+            gfx->ctx->OMSetDepthStencilState(bundle.depth, 0);
+            gfx->cacheDepth = bundle.depth;
+        }
+        if (gfxStateDiffers(gfx, G4F_GFX_STATE_RASTERIZER, gfx->cacheRS != bundle.rs)) {
+            gfx->ctx->RSSetState(bundle.rs);
+            gfx->cacheRS = bundle.rs;
+        }
+        if (gfxStateDiffers(gfx, G4F_GFX_STATE_SAMPLER, gfx->cacheSamp0 != bundle.samp)) {
+            gfx->ctx->PSSetSamplers(0, 1, &bundle.samp);
+            gfx->cacheSamp0 = bundle.samp;
+        }
+        gfx->cacheBundle = material->bundle;
     }
 
     CbMaterial cb{};
@@ -1233,7 +2563,6 @@ void g4f_gfx_draw_mesh_xform(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_g
     cb.tint[1] = material->tint[1];
     cb.tint[2] = material->tint[2];
     cb.tint[3] = material->tint[3];
-    cb.hasTex = material->srv ? 1.0f : 0.0f;
     cb.model = model ? *model : g4f_mat4_identity();
     cb.normal = mat4NormalMatrix(cb.model);
     cb.lightDir[0] = gfx->lightDir[0];
@@ -1249,29 +2578,787 @@ void g4f_gfx_draw_mesh_xform(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_g
     cb.ambientColor[2] = gfx->ambientColor[2];
     cb.ambientColor[3] = gfx->ambientColor[3];
     gfx->ctx->UpdateSubresource(gfx->cbUnlit, 0, nullptr, &cb, 0, 0);
-    if (gfx->cacheCB0VS != gfx->cbUnlit) {
+    gfx->frameStats.constantBytes += sizeof(cb);
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_CONSTANT_BUFFER, gfx->cacheCB0VS != gfx->cbUnlit)) {
         gfx->ctx->VSSetConstantBuffers(0, 1, &gfx->cbUnlit);
         gfx->cacheCB0VS = gfx->cbUnlit;
     }
-    if (gfx->cacheCB0PS != gfx->cbUnlit) {
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_CONSTANT_BUFFER, gfx->cacheCB0PS != gfx->cbUnlit)) {
         gfx->ctx->PSSetConstantBuffers(0, 1, &gfx->cbUnlit);
         gfx->cacheCB0PS = gfx->cbUnlit;
     }
 
     ID3D11ShaderResourceView* srv = material->srv;
-    if (gfx->cacheSRV0 != srv) {
+    const auto* passTarget = (const g4f_gfx_target*)g4f_pass_stack_current(&gfx->passes).target;
+    if (passTarget && srv == passTarget->color->srv) srv = nullptr; // feedback loop: target is bound for output
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TEXTURE, gfx->cacheSRV0 != srv)) {
         gfx->ctx->PSSetShaderResources(0, 1, &srv);
         gfx->cacheSRV0 = srv;
     }
-    if (gfx->cacheSamp0 != gfx->sampLinearClamp) {
-        gfx->ctx->PSSetSamplers(0, 1, &gfx->sampLinearClamp);
-        gfx->cacheSamp0 = gfx->sampLinearClamp;
-    }
-
-    gfx->ctx->DrawIndexed(mesh->indexCount, 0, 0);
+    if (material->clustered && !gfx->clustersBound) {
+        ID3D11ShaderResourceView* lightSrvs[3] = {gfx->lightSrv, gfx->clusterRangeSrv, gfx->lightIndexSrv};
+        gfx->ctx->PSSetConstantBuffers(1, 1, &gfx->cbClusters);
+        gfx->ctx->PSSetShaderResources(1, 3, lightSrvs);
+        gfx->clustersBound = 1;
+        gfxCountBind(gfx, G4F_GFX_STATE_CONSTANT_BUFFER);
+        gfxCountBind(gfx, G4F_GFX_STATE_TEXTURE);
+    }
+    if (material->lit && !gfx->shadowBound) {
+        gfx->ctx->PSSetConstantBuffers(2, 1, &gfx->cbShadow);
+        gfx->ctx->PSSetShaderResources(4, 1, &gfx->shadowSrv);
+        gfx->ctx->PSSetSamplers(1, 1, &gfx->sampShadow);
+        gfx->shadowBound = 1;
+        gfxCountBind(gfx, G4F_GFX_STATE_CONSTANT_BUFFER);
+        gfxCountBind(gfx, G4F_GFX_STATE_TEXTURE);
+        gfxCountBind(gfx, G4F_GFX_STATE_SAMPLER);
+    }
+
+    gfx->ctx->DrawIndexed(indexCount, firstIndex, 0);
+    gfxCountDraw(gfx, indexCount);
+}
+
+} // namespace
+
+void g4f_gfx_draw_mesh_xform(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material, const g4f_mat4* model, const g4f_mat4* mvp) {
+    if (!mesh) return;
+    gfxDrawMeshRange(gfx, mesh, material, model, mvp, 0, mesh->indexCount);
+}
+
+void g4f_gfx_draw_mesh_lod(g4f_gfx* gfx, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material, const g4f_mat4* model, const g4f_mat4* mvp, int level) {
+    if (!mesh) return;
+    if (!mesh->lod || level <= 0) {
+        gfxDrawMeshRange(gfx, mesh, material, model, mvp, 0, mesh->indexCount);
+        return;
+    }
+    const int last = g4f_lod_chain_level_count(mesh->lod) - 1;
+    const g4f_lod_level range = g4f_lod_chain_level(mesh->lod, level < last ? level : last);
+    gfxDrawMeshRange(gfx, mesh, material, model, mvp, (UINT)range.firstIndex, (UINT)range.indexCount);
+}
+
+int g4f_gfx_draw_scene(g4f_gfx* gfx, g4f_scene* scene, const g4f_mat4* viewProj, g4f_jobs* jobs) {
+    if (!gfx || !gfx->ctx || !scene || !viewProj) return 0;
+    const int count = g4f_scene_build_draws(scene, viewProj, jobs);
+    const g4f_scene_draw* draws = g4f_scene_draws(scene, nullptr);
+    for (int i = 0; i < count; i++) {
+        g4f_gfx_draw_mesh_lod(gfx, draws[i].mesh, draws[i].material, &draws[i].model, &draws[i].mvp, draws[i].lod);
+    }
+    return count;
+}
+
+int g4f_gfx_draw_ecs(g4f_gfx* gfx, g4f_ecs* ecs, const g4f_mat4* viewProj, g4f_jobs* jobs) {
+    if (!gfx || !gfx->ctx || !ecs || !viewProj) return 0;
+    g4f_ecs_update_transforms(ecs, jobs);
+    const int count = g4f_ecs_build_draws(ecs, viewProj, jobs);
+    const g4f_ecs_draw* draws = g4f_ecs_draws(ecs, nullptr);
+    for (int i = 0; i < count; i++) {
+        g4f_gfx_draw_mesh_xform(gfx, draws[i].mesh, draws[i].material, &draws[i].model, &draws[i].mvp);
+    }
+    return count;
+}
+
+static void* gfxStreamUpload(void* user, int, int, void* payload, size_t* outResidentBytes) {
+    auto* gfx = (g4f_gfx*)user;
+    auto* chunk = (g4f_stream_chunk*)payload;
+    auto* resident = new g4f_gfx_stream_chunk();
+    resident->model = chunk->model;
+    resident->mesh = g4f_gfx_mesh_create_p3n3uv2(gfx, chunk->vertices, chunk->vertexCount, chunk->indices, chunk->indexCount);
+    if (resident->mesh && chunk->rgba) {
+        resident->texture = g4f_gfx_texture_create_rgba8(gfx, chunk->textureWidth, chunk->textureHeight, chunk->rgba, chunk->textureWidth * 4);
+        if (resident->texture) {
+            g4f_gfx_material_unlit_desc desc = chunk->material;
+            desc.texture = resident->texture;
+            resident->material = chunk->lit ? g4f_gfx_material_create_lit(gfx, &desc) : g4f_gfx_material_create_unlit(gfx, &desc);
+        }
+    }
+    const bool ok = resident->mesh && (!chunk->rgba || resident->material);
+    *outResidentBytes = g4f_stream_chunk_bytes(chunk);
+    g4f_stream_chunk_destroy(chunk);
+    if (!ok) {
+        g4f_gfx_material_destroy(resident->material);
+        g4f_gfx_texture_destroy(resident->texture);
+        g4f_gfx_mesh_destroy(resident->mesh);
+        delete resident;
+        return nullptr;
+    }
+    return resident;
+}
+
+static void gfxStreamEvict(void*, int, int, void* handle) {
+    auto* resident = (g4f_gfx_stream_chunk*)handle;
+    g4f_gfx_material_destroy(resident->material);
+    g4f_gfx_texture_destroy(resident->texture);
+    g4f_gfx_mesh_destroy(resident->mesh);
+    delete resident;
+}
+
+static void gfxStreamDiscard(void*, int, int, void* payload) { g4f_stream_chunk_destroy((g4f_stream_chunk*)payload); }
+
+g4f_stream_backend g4f_gfx_stream_backend(g4f_gfx* gfx, g4f_stream_generate_fn generate, void* generateUser) {
+    g4f_stream_backend backend{};
+    backend.generate = generate;
+    backend.generateUser = generateUser;
+    backend.upload = gfxStreamUpload;
+    backend.evict = gfxStreamEvict;
+    backend.discard = gfxStreamDiscard;
+    backend.residencyUser = gfx;
+    return backend;
+}
+
+int g4f_gfx_draw_stream(g4f_gfx* gfx, const g4f_stream* stream, const g4f_gfx_material* material, const g4f_mat4* viewProj) {
+    if (!gfx || !gfx->ctx || !stream || !viewProj) return 0;
+    g4f_stream_stats stats{};
+    g4f_stream_get_stats(stream, &stats);
+    std::vector<g4f_stream_cell> cells((size_t)stats.resident);
+    const int count = g4f_stream_resident_cells(stream, cells.data(), stats.resident);
+    int draws = 0;
+    for (int i = 0; i < count; i++) {
+        const auto* chunk = (const g4f_gfx_stream_chunk*)cells[(size_t)i].handle;
+        const g4f_gfx_material* m = chunk->material ? chunk->material : material;
+        if (!m) continue;
+        const g4f_mat4 mvp = g4f_mat4_mul(chunk->model, *viewProj);
+        g4f_gfx_draw_mesh_xform(gfx, chunk->mesh, m, &chunk->model, &mvp);
+        draws++;
+    }
+    return draws;
+}
+
+g4f_gfx_mesh* g4f_gfx_mesh_create_from_pack(g4f_gfx* gfx, const g4f_pack_entry* entry) {
+    if (!entry || entry->type != G4F_PACK_ENTRY_MESH) { g4f_set_last_error("g4f_gfx_mesh_create_from_pack: not a mesh entry"); return nullptr; }
+    return g4f_gfx_mesh_create_p3n3uv2(gfx, entry->vertices, entry->vertexCount, entry->indices, entry->indexCount);
+}
+
+// Immutable texture with a full SRV from pre-built levels; `fn` prefixes the errors.
+static g4f_gfx_texture* gfxTextureCreateImmutable(g4f_gfx* gfx, const char* fn, DXGI_FORMAT format, int width, int height,
+                                                  const std::vector<D3D11_SUBRESOURCE_DATA>& data, size_t bytes) {
+    const int levels = (int)data.size();
+    auto* texture = new g4f_gfx_texture();
+    texture->owner = gfx;
+    texture->width = width;
+    texture->height = height;
+    texture->dynamic = 0;
+    texture->mipLevels = levels;
+
+    D3D11_TEXTURE2D_DESC desc{};
+    desc.Width = (UINT)width;
+    desc.Height = (UINT)height;
+    desc.MipLevels = (UINT)levels;
+    desc.ArraySize = 1;
+    desc.Format = format;
+    desc.SampleDesc.Count = 1;
+    desc.Usage = D3D11_USAGE_IMMUTABLE;
+    desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+    HRESULT hr = gfx->device->CreateTexture2D(&desc, data.data(), &texture->tex);
+    if (FAILED(hr) || !texture->tex) {
+        g4f_set_last_hresult_error((std::string(fn) + ": CreateTexture2D failed").c_str(), hr);
+        g4f_gfx_texture_destroy(texture);
+        return nullptr;
+    }
+
+    D3D11_SHADER_RESOURCE_VIEW_DESC srvDesc{};
+    srvDesc.Format = desc.Format;
+    srvDesc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2D;
+    srvDesc.Texture2D.MostDetailedMip = 0;
+    srvDesc.Texture2D.MipLevels = (UINT)levels;
+
+    hr = gfx->device->CreateShaderResourceView(texture->tex, &srvDesc, &texture->srv);
+    if (FAILED(hr) || !texture->srv) {
+        g4f_set_last_hresult_error((std::string(fn) + ": CreateShaderResourceView failed").c_str(), hr);
+        g4f_gfx_texture_destroy(texture);
+        return nullptr;
+    }
+
+    gfxCountCreated(gfx, 2);
+    gfx->frameStats.textureBytes += bytes;
+    return texture;
+}
+
+g4f_gfx_texture* g4f_gfx_texture_create_from_pack(g4f_gfx* gfx, const g4f_pack_entry* entry) {
+    if (!gfx || !gfx->device) { g4f_set_last_error("g4f_gfx_texture_create_from_pack: invalid gfx"); return nullptr; }
+    if (!entry || entry->type != G4F_PACK_ENTRY_TEXTURE || entry->mipLevels <= 0) { g4f_set_last_error("g4f_gfx_texture_create_from_pack: not a texture entry"); return nullptr; }
+
+    DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM;
+    if (entry->format == G4F_PACK_FORMAT_BC1) format = DXGI_FORMAT_BC1_UNORM;
+    if (entry->format == G4F_PACK_FORMAT_BC3) format = DXGI_FORMAT_BC3_UNORM;
+    if (entry->format == G4F_PACK_FORMAT_BC7) format = DXGI_FORMAT_BC7_UNORM;
+
+    // Subresources point into the pack mapping; D3D copies them into the texture.
+    std::vector<D3D11_SUBRESOURCE_DATA> data((size_t)entry->mipLevels);
+    for (int i = 0; i < entry->mipLevels; i++) {
+        int pitch = 0;
+        data[(size_t)i].pSysMem = g4f_pack_texture_level(entry, i, nullptr, nullptr, &pitch, nullptr);
+        data[(size_t)i].SysMemPitch = (UINT)pitch;
+        if (!data[(size_t)i].pSysMem) { g4f_set_last_error("g4f_gfx_texture_create_from_pack: invalid level"); return nullptr; }
+    }
+    return gfxTextureCreateImmutable(gfx, "g4f_gfx_texture_create_from_pack", format, entry->width, entry->height, data, entry->size);
+}
+
+g4f_gfx_texture* g4f_gfx_texture_create_bcn(g4f_gfx* gfx, int format, int width, int height, int mipLevels, const void* blocks) {
+    if (!gfx || !gfx->device || !blocks) { g4f_set_last_error("g4f_gfx_texture_create_bcn: invalid args"); return nullptr; }
+    const size_t bytes = g4f_bcn_chain_bytes(format, width, height, mipLevels);
+    if (bytes == 0 || width % 4 != 0 || height % 4 != 0) {
+        g4f_set_last_error("g4f_gfx_texture_create_bcn: invalid format or size (width and height must be multiples of 4)");
+        return nullptr;
+    }
+
+    const DXGI_FORMAT dxgi = format == G4F_BCN_BC1 ? DXGI_FORMAT_BC1_UNORM : (format == G4F_BCN_BC3 ? DXGI_FORMAT_BC3_UNORM : DXGI_FORMAT_BC7_UNORM);
+    std::vector<D3D11_SUBRESOURCE_DATA> data((size_t)mipLevels);
+    size_t offset = 0;
+    for (int i = 0; i < mipLevels; i++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, i, &w, &h);
+        const size_t levelBytes = g4f_bcn_chain_bytes(format, w, h, 1);
+        data[(size_t)i].pSysMem = (const uint8_t*)blocks + offset;
+        data[(size_t)i].SysMemPitch = (UINT)(levelBytes / (size_t)((h + 3) / 4));
+        offset += levelBytes;
+    }
+    return gfxTextureCreateImmutable(gfx, "g4f_gfx_texture_create_bcn", dxgi, width, height, data, bytes);
+}
+
+g4f_gfx_texture* g4f_gfx_texture_create_rgba8_compressed(g4f_gfx* gfx, int width, int height, const void* rgbaPixels, int rowPitchBytes,
+                                                         int format, int quality, int mipFilter, int mipFlags, g4f_jobs* jobs) {
+    if (!gfx || !gfx->device || !rgbaPixels) { g4f_set_last_error("g4f_gfx_texture_create_rgba8_compressed: invalid args"); return nullptr; }
+    if (width <= 0 || height <= 0 || width % 4 != 0 || height % 4 != 0) {
+        g4f_set_last_error("g4f_gfx_texture_create_rgba8_compressed: width and height must be positive multiples of 4");
+        return nullptr;
+    }
+
+    const int levels = g4f_mipgen_level_count(width, height);
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(width, height, levels));
+    if (g4f_mipgen_build_chain_rgba8(rgbaPixels, width, height, rowPitchBytes, levels, mipFilter, mipFlags, jobs, chain.data()) != levels) {
+        setLastErrorIfEmptyWithPrefix("g4f_gfx_texture_create_rgba8_compressed", "mip chain generation failed");
+        return nullptr;
+    }
+    std::vector<uint8_t> blocks(g4f_bcn_chain_bytes(format, width, height, levels));
+    if (blocks.empty() || !g4f_bcn_encode_chain_rgba8(chain.data(), width, height, levels, format, quality, jobs, blocks.data())) {
+        setLastErrorIfEmptyWithPrefix("g4f_gfx_texture_create_rgba8_compressed", "block compression failed");
+        return nullptr;
+    }
+    return g4f_gfx_texture_create_bcn(gfx, format, width, height, levels, blocks.data());
+}
+
+void g4f_gfx_blit(g4f_gfx* gfx, const g4f_gfx_texture* texture) {
+    if (!gfx || !gfx->ctx || !texture || !texture->srv) return;
+    const auto* passTarget = (const g4f_gfx_target*)g4f_pass_stack_current(&gfx->passes).target;
+    if (passTarget && passTarget->color == texture) return; // cannot read the bound target
+
+    if (gfx->cachePipeline != 3) {
+        gfx->cachePipeline = 3;
+        gfx->cacheVB = nullptr;
+        gfx->cacheIB = nullptr;
+        gfx->cacheCB0VS = nullptr;
+        gfx->cacheCB0PS = nullptr;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INPUT_LAYOUT, gfx->cacheIL != nullptr)) {
+        gfx->ctx->IASetInputLayout(nullptr);
+        gfx->cacheIL = nullptr;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cacheVS != gfx->vsBlit)) {
+        gfx->ctx->VSSetShader(gfx->vsBlit, nullptr, 0);
+        gfx->cacheVS = gfx->vsBlit;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cachePS != gfx->psBlit)) {
+        gfx->ctx->PSSetShader(gfx->psBlit, nullptr, 0);
+        gfx->cachePS = gfx->psBlit;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TOPOLOGY, gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)) {
+        gfx->ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        gfx->cacheTopo = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    }
+    float blendFactor[4] = {0, 0, 0, 0};
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_BLEND, gfx->cacheBlend != gfx->bsOpaque)) {
+        gfx->ctx->OMSetBlendState(gfx->bsOpaque, blendFactor, 0xFFFFFFFFu);
+        gfx->cacheBlend = gfx->bsOpaque;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_DEPTH, gfx->cacheDepth != gfx->dsDisabled)) {
+        gfx->ctx->OMSetDepthStencilState(gfx->dsDisabled, 0);
+        gfx->cacheDepth = gfx->dsDisabled;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_RASTERIZER, gfx->cacheRS != gfx->rsCullNone)) {
+        gfx->ctx->RSSetState(gfx->rsCullNone);
+        gfx->cacheRS = gfx->rsCullNone;
+    }
+    ID3D11ShaderResourceView* srv = texture->srv;
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TEXTURE, gfx->cacheSRV0 != srv)) {
+        gfx->ctx->PSSetShaderResources(0, 1, &srv);
+        gfx->cacheSRV0 = srv;
+    }
+    ID3D11SamplerState* samp = gfx->samplers[G4F_GFX_FILTER_LINEAR][G4F_GFX_ADDRESS_CLAMP];
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SAMPLER, gfx->cacheSamp0 != samp)) {
+        gfx->ctx->PSSetSamplers(0, 1, &samp);
+        gfx->cacheSamp0 = samp;
+    }
+
+    gfx->ctx->Draw(3, 0);
+    gfxCountDraw(gfx, 3);
+}
+
+// Sprite pipeline: pixel-space P2 UV2 C4 quads, compiled on the first sprite draw so apps that
+// never draw sprites do not pay for the shaders at startup.
+static constexpr UINT kSpritesPerDraw = 16384; // 4 vertices each: the largest quad count 16-bit indices reach
+
+static bool gfxEnsureSpritePipeline(g4f_gfx* gfx) {
+    if (gfx->psSprite) return true;
+    if (gfx->spriteInitFailed) return false;
+    gfx->spriteInitFailed = 1;
+    static const char* kShader = R"(
+cbuffer CbSprite : register(b0) { float4 uScaleOffset; };
+Texture2D uTex0 : register(t0);
+SamplerState uSamp0 : register(s0);
+struct VSIn { float2 pos : POSITION; float2 uv : TEXCOORD0; float4 color : COLOR0; };
+struct PSIn { float4 pos : SV_Position; float2 uv : TEXCOORD0; float4 color : COLOR0; };
+PSIn VSSprite(VSIn i) {
+  PSIn o;
+  o.pos = float4(i.pos * uScaleOffset.xy + uScaleOffset.zw, 0.0, 1.0);
+  o.uv = i.uv;
+  o.color = i.color.abgr; // 0xRRGGBBAA read as R8G8B8A8 on a little-endian CPU
+  return o;
+}
+float4 PSSprite(PSIn i) : SV_Target { return uTex0.Sample(uSamp0, i.uv) * i.color; }
+    )";
+
+    ID3DBlob* vsBlob = nullptr;
+    ID3DBlob* psBlob = nullptr;
+    HRESULT hr = compileHlsl(gfx, kShader, "VSSprite", "vs_5_0", "g4f_gfx_draw_sprite_batch: compile VSSprite", &vsBlob);
+    if (FAILED(hr) || !vsBlob) return false;
+    hr = compileHlsl(gfx, kShader, "PSSprite", "ps_5_0", "g4f_gfx_draw_sprite_batch: compile PSSprite", &psBlob);
+    if (FAILED(hr) || !psBlob) { vsBlob->Release(); return false; }
+
+    hr = gfx->device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &gfx->vsSprite);
+    if (SUCCEEDED(hr)) {
+        D3D11_INPUT_ELEMENT_DESC il[] = {
+            {"POSITION", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 0, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            {"TEXCOORD", 0, DXGI_FORMAT_R32G32_FLOAT, 0, 8, D3D11_INPUT_PER_VERTEX_DATA, 0},
+            {"COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 16, D3D11_INPUT_PER_VERTEX_DATA, 0},
+        };
+        hr = gfx->device->CreateInputLayout(il, 3, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), &gfx->ilSprite);
+    }
+    vsBlob->Release();
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_sprite_batch", "vertex shader/input layout creation failed", hr);
+        psBlob->Release();
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc{};
+    cbDesc.ByteWidth = 16;
+    cbDesc.Usage = D3D11_USAGE_DEFAULT;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    hr = gfx->device->CreateBuffer(&cbDesc, nullptr, &gfx->cbSprite);
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_sprite_batch", "device->CreateBuffer(cbSprite) failed", hr);
+        psBlob->Release();
+        return false;
+    }
+
+    // Quads share one index pattern; each draw offsets it with BaseVertexLocation.
+    std::vector<uint16_t> indices((size_t)kSpritesPerDraw * 6);
+    for (UINT q = 0; q < kSpritesPerDraw; q++) {
+        const uint16_t v = (uint16_t)(q * 4);
+        const uint16_t quad[6] = {v, (uint16_t)(v + 1), (uint16_t)(v + 2), (uint16_t)(v + 2), (uint16_t)(v + 1), (uint16_t)(v + 3)};
+        std::memcpy(&indices[(size_t)q * 6], quad, sizeof(quad));
+    }
+    D3D11_BUFFER_DESC ibDesc{};
+    ibDesc.ByteWidth = (UINT)(indices.size() * sizeof(uint16_t));
+    ibDesc.Usage = D3D11_USAGE_IMMUTABLE;
+    ibDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+    D3D11_SUBRESOURCE_DATA ibData{};
+    ibData.pSysMem = indices.data();
+    hr = gfx->device->CreateBuffer(&ibDesc, &ibData, &gfx->ibSprite);
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_sprite_batch", "device->CreateBuffer(ibSprite) failed", hr);
+        psBlob->Release();
+        return false;
+    }
+
+    gfx->spriteWhite = g4f_gfx_texture_create_solid_rgba8(gfx, 0xFFFFFFFFu);
+    if (!gfx->spriteWhite) {
+        psBlob->Release();
+        return false;
+    }
+
+    hr = gfx->device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &gfx->psSprite);
+    psBlob->Release();
+    if (FAILED(hr) || !gfx->psSprite) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_sprite_batch", "device->CreatePixelShader (sprite) failed", hr);
+        return false;
+    }
+    gfx->spriteInitFailed = 0;
+    gfxCountCreated(gfx, 5);
+    return true;
+}
+
+// Grows the dynamic vertex buffer (power of two sprites) and writes the whole stream with DISCARD.
+static bool gfxUploadSprites(g4f_gfx* gfx, const g4f_sprite_vertex* vertices, UINT spriteCount) {
+    if (!gfx->vbSprite || gfx->spriteCapacity < spriteCount) {
+        UINT cap = 1024;
+        while (cap < spriteCount) cap *= 2;
+        safeRelease((IUnknown**)&gfx->vbSprite);
+        gfx->spriteCapacity = 0;
+        D3D11_BUFFER_DESC desc{};
+        desc.ByteWidth = cap * 4u * (UINT)sizeof(g4f_sprite_vertex);
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        HRESULT hr = gfx->device->CreateBuffer(&desc, nullptr, &gfx->vbSprite);
+        if (FAILED(hr) || !gfx->vbSprite) {
+            g4f_set_last_hresult_error("g4f_gfx_draw_sprite_batch: CreateBuffer(vbSprite) failed", hr);
+            return false;
+        }
+        gfx->spriteCapacity = cap;
+        gfxCountCreated(gfx, 1);
+    }
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    HRESULT hr = gfx->ctx->Map(gfx->vbSprite, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr)) {
+        g4f_set_last_hresult_error("g4f_gfx_draw_sprite_batch: Map(vbSprite) failed", hr);
+        return false;
+    }
+    std::memcpy(mapped.pData, vertices, (size_t)spriteCount * 4 * sizeof(g4f_sprite_vertex));
+    gfx->ctx->Unmap(gfx->vbSprite, 0);
+    return true;
+}
+
+void g4f_gfx_draw_sprite_batch(g4f_gfx* gfx, g4f_sprite_batch* batch, int samplerFilter) {
+    if (!gfx || !gfx->ctx || !batch || g4f_sprite_batch_count(batch) == 0) return;
+    if (g4f_sprite_batch_range_count(batch) == 0) g4f_sprite_batch_build(batch);
+    int vertexCount = 0;
+    const g4f_sprite_vertex* vertices = g4f_sprite_batch_vertices(batch, &vertexCount);
+    if (!vertices || vertexCount == 0) return;
+    if (!gfxEnsureSpritePipeline(gfx)) return;
+    if (!gfx->pendingUploads.empty()) gfxFlushPendingUploads(gfx);
+    if (!gfxUploadSprites(gfx, vertices, (UINT)(vertexCount / 4))) return;
+
+    if (gfx->cachePipeline != 5) {
+        gfx->cachePipeline = 5;
+        gfx->cacheVB = nullptr;
+        gfx->cacheIB = nullptr;
+        gfx->cacheCB0VS = nullptr;
+        gfx->cacheCB0PS = nullptr;
+        gfx->cacheBundle = -1;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INPUT_LAYOUT, gfx->cacheIL != gfx->ilSprite)) {
+        gfx->ctx->IASetInputLayout(gfx->ilSprite);
+        gfx->cacheIL = gfx->ilSprite;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cacheVS != gfx->vsSprite)) {
+        gfx->ctx->VSSetShader(gfx->vsSprite, nullptr, 0);
+        gfx->cacheVS = gfx->vsSprite;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cachePS != gfx->psSprite)) {
+        gfx->ctx->PSSetShader(gfx->psSprite, nullptr, 0);
+        gfx->cachePS = gfx->psSprite;
+    }
+    UINT stride = (UINT)sizeof(g4f_sprite_vertex);
+    UINT offset = 0;
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_VERTEX_BUFFER, gfx->cacheVB != gfx->vbSprite || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset)) {
+        gfx->ctx->IASetVertexBuffers(0, 1, &gfx->vbSprite, &stride, &offset);
+        gfx->cacheVB = gfx->vbSprite;
+        gfx->cacheVBStride = stride;
+        gfx->cacheVBOffset = offset;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INDEX_BUFFER, gfx->cacheIB != gfx->ibSprite)) {
+        gfx->ctx->IASetIndexBuffer(gfx->ibSprite, DXGI_FORMAT_R16_UINT, 0);
+        gfx->cacheIB = gfx->ibSprite;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TOPOLOGY, gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST)) {
+        gfx->ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+        gfx->cacheTopo = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST;
+    }
+    float blendFactor[4] = {0, 0, 0, 0};
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_BLEND, gfx->cacheBlend != gfx->bsAlpha)) {
+        gfx->ctx->OMSetBlendState(gfx->bsAlpha, blendFactor, 0xFFFFFFFFu);
+        gfx->cacheBlend = gfx->bsAlpha;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_DEPTH, gfx->cacheDepth != gfx->dsDisabled)) {
+        gfx->ctx->OMSetDepthStencilState(gfx->dsDisabled, 0);
+        gfx->cacheDepth = gfx->dsDisabled;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_RASTERIZER, gfx->cacheRS != gfx->rsCullNone)) {
+        gfx->ctx->RSSetState(gfx->rsCullNone);
+        gfx->cacheRS = gfx->rsCullNone;
+    }
+    const int filter = (samplerFilter >= 0 && samplerFilter <= G4F_GFX_FILTER_ANISOTROPIC) ? samplerFilter : G4F_GFX_FILTER_LINEAR;
+    ID3D11SamplerState* samp = gfx->samplers[filter][G4F_GFX_ADDRESS_CLAMP];
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SAMPLER, gfx->cacheSamp0 != samp)) {
+        gfx->ctx->PSSetSamplers(0, 1, &samp);
+        gfx->cacheSamp0 = samp;
+    }
+
+    // Pixel coordinates of the current pass -> clip space (y down).
+    int w = 1, h = 1;
+    g4f_gfx_pass_get_size(gfx, &w, &h);
+    const float scaleOffset[4] = {2.0f / (float)(w > 0 ? w : 1), -2.0f / (float)(h > 0 ? h : 1), -1.0f, 1.0f};
+    gfx->ctx->UpdateSubresource(gfx->cbSprite, 0, nullptr, scaleOffset, 0, 0);
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_CONSTANT_BUFFER, gfx->cacheCB0VS != gfx->cbSprite)) {
+        gfx->ctx->VSSetConstantBuffers(0, 1, &gfx->cbSprite);
+        gfx->cacheCB0VS = gfx->cbSprite;
+    }
+
+    const auto* passTarget = (const g4f_gfx_target*)g4f_pass_stack_current(&gfx->passes).target;
+    const int ranges = g4f_sprite_batch_range_count(batch);
+    for (int i = 0; i < ranges; i++) {
+        g4f_sprite_range range{};
+        g4f_sprite_batch_get_range(batch, i, &range);
+        const g4f_gfx_texture* texture = range.texture ? range.texture : gfx->spriteWhite;
+        if (!texture->srv || (passTarget && passTarget->color == texture)) continue; // cannot read the bound target
+        ID3D11ShaderResourceView* srv = texture->srv;
+        if (gfxStateDiffers(gfx, G4F_GFX_STATE_TEXTURE, gfx->cacheSRV0 != srv)) {
+            gfx->ctx->PSSetShaderResources(0, 1, &srv);
+            gfx->cacheSRV0 = srv;
+        }
+        for (int first = range.firstSprite, left = range.spriteCount; left > 0;) {
+            const UINT n = (UINT)left < kSpritesPerDraw ? (UINT)left : kSpritesPerDraw;
+            gfx->ctx->DrawIndexed(n * 6, 0, first * 4);
+            gfxCountDraw(gfx, n * 6);
+            first += (int)n;
+            left -= (int)n;
+        }
+    }
+}
+
+// Particle pipeline: one R32G32B32A32 + R8G8B8A8 instance per particle, expanded to a
+// camera-facing quad from SV_VertexID (4-vertex strip, no vertex or index buffer). Compiled on
+// the first particle draw, like the sprite pipeline.
+static bool gfxEnsureParticlePipeline(g4f_gfx* gfx) {
+    if (gfx->psParticle) return true;
+    if (gfx->particleInitFailed) return false;
+    gfx->particleInitFailed = 1;
+    static const char* kShader = R"(
+cbuffer CbParticles : register(b0) { row_major float4x4 uViewProj; float4 uRight; float4 uUp; };
+Texture2D uTex0 : register(t0);
+SamplerState uSamp0 : register(s0);
+struct VSIn { float4 posSize : POSITION; float4 color : COLOR0; uint vid : SV_VertexID; };
+struct PSIn { float4 pos : SV_Position; float2 uv : TEXCOORD0; float4 color : COLOR0; };
+PSIn VSParticle(VSIn i) {
+  PSIn o;
+  float2 corner = float2((i.vid & 1) ? 0.5 : -0.5, (i.vid & 2) ? -0.5 : 0.5);
+  float3 wpos = i.posSize.xyz + (uRight.xyz * corner.x + uUp.xyz * corner.y) * i.posSize.w;
+  o.pos = mul(float4(wpos, 1.0), uViewProj);
+  o.uv = float2(corner.x + 0.5, 0.5 - corner.y);
+  o.color = i.color.abgr; // 0xRRGGBBAA read as R8G8B8A8 on a little-endian CPU
+  return o;
+}
+float4 PSParticle(PSIn i) : SV_Target { return uTex0.Sample(uSamp0, i.uv) * i.color; }
+    )";
+
+    ID3DBlob* vsBlob = nullptr;
+    ID3DBlob* psBlob = nullptr;
+    HRESULT hr = compileHlsl(gfx, kShader, "VSParticle", "vs_5_0", "g4f_gfx_draw_particles: compile VSParticle", &vsBlob);
+    if (FAILED(hr) || !vsBlob) return false;
+    hr = compileHlsl(gfx, kShader, "PSParticle", "ps_5_0", "g4f_gfx_draw_particles: compile PSParticle", &psBlob);
+    if (FAILED(hr) || !psBlob) { vsBlob->Release(); return false; }
+
+    hr = gfx->device->CreateVertexShader(vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), nullptr, &gfx->vsParticle);
+    if (SUCCEEDED(hr)) {
+        D3D11_INPUT_ELEMENT_DESC il[] = {
+            {"POSITION", 0, DXGI_FORMAT_R32G32B32A32_FLOAT, 0, 0, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+            {"COLOR", 0, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 16, D3D11_INPUT_PER_INSTANCE_DATA, 1},
+        };
+        hr = gfx->device->CreateInputLayout(il, 2, vsBlob->GetBufferPointer(), vsBlob->GetBufferSize(), &gfx->ilParticle);
+    }
+    vsBlob->Release();
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_particles", "vertex shader/input layout creation failed", hr);
+        psBlob->Release();
+        return false;
+    }
+
+    D3D11_BUFFER_DESC cbDesc{};
+    cbDesc.ByteWidth = 96;
+    cbDesc.Usage = D3D11_USAGE_DEFAULT;
+    cbDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+    hr = gfx->device->CreateBuffer(&cbDesc, nullptr, &gfx->cbParticle);
+    if (FAILED(hr)) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_particles", "device->CreateBuffer(cbParticle) failed", hr);
+        psBlob->Release();
+        return false;
+    }
+
+    D3D11_BLEND_DESC bsDesc{};
+    D3D11_RENDER_TARGET_BLEND_DESC rta{};
+    rta.BlendEnable = TRUE;
+    rta.SrcBlend = D3D11_BLEND_SRC_ALPHA;
+    rta.DestBlend = D3D11_BLEND_ONE;
+    rta.BlendOp = D3D11_BLEND_OP_ADD;
+    rta.SrcBlendAlpha = D3D11_BLEND_ZERO;
+    rta.DestBlendAlpha = D3D11_BLEND_ONE;
+    rta.BlendOpAlpha = D3D11_BLEND_OP_ADD;
+    rta.RenderTargetWriteMask = D3D11_COLOR_WRITE_ENABLE_ALL;
+    bsDesc.RenderTarget[0] = rta;
+    hr = gfx->device->CreateBlendState(&bsDesc, &gfx->bsAdditive);
+    if (FAILED(hr) || !gfx->bsAdditive) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_particles", "device->CreateBlendState(additive) failed", hr);
+        psBlob->Release();
+        return false;
+    }
+
+    gfx->particleWhite = g4f_gfx_texture_create_solid_rgba8(gfx, 0xFFFFFFFFu);
+    if (!gfx->particleWhite) {
+        psBlob->Release();
+        return false;
+    }
+
+    hr = gfx->device->CreatePixelShader(psBlob->GetBufferPointer(), psBlob->GetBufferSize(), nullptr, &gfx->psParticle);
+    psBlob->Release();
+    if (FAILED(hr) || !gfx->psParticle) {
+        setLastHresultErrorIfEmptyWithPrefix("g4f_gfx_draw_particles", "device->CreatePixelShader (particle) failed", hr);
+        return false;
+    }
+    gfx->particleInitFailed = 0;
+    gfxCountCreated(gfx, 5);
+    return true;
+}
+
+// Grows the instance buffer (power of two) and writes the instances straight into the mapped
+// memory with DISCARD. Returns the number of instances written.
+static UINT gfxUploadParticles(g4f_gfx* gfx, const g4f_particles* particles, g4f_jobs* jobs) {
+    const UINT count = (UINT)g4f_particles_count(particles);
+    if (!gfx->vbParticle || gfx->particleCapacity < count) {
+        UINT cap = 4096;
+        while (cap < count) cap *= 2;
+        safeRelease((IUnknown**)&gfx->vbParticle);
+        gfx->particleCapacity = 0;
+        D3D11_BUFFER_DESC desc{};
+        desc.ByteWidth = cap * (UINT)sizeof(g4f_particle_instance);
+        desc.Usage = D3D11_USAGE_DYNAMIC;
+        desc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+        desc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+        HRESULT hr = gfx->device->CreateBuffer(&desc, nullptr, &gfx->vbParticle);
+        if (FAILED(hr) || !gfx->vbParticle) {
+            g4f_set_last_hresult_error("g4f_gfx_draw_particles: CreateBuffer(vbParticle) failed", hr);
+            return 0;
+        }
+        gfx->particleCapacity = cap;
+        gfxCountCreated(gfx, 1);
+    }
+    D3D11_MAPPED_SUBRESOURCE mapped{};
+    HRESULT hr = gfx->ctx->Map(gfx->vbParticle, 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped);
+    if (FAILED(hr)) {
+        g4f_set_last_hresult_error("g4f_gfx_draw_particles: Map(vbParticle) failed", hr);
+        return 0;
+    }
+    const int written = g4f_particles_write_instances(particles, (g4f_particle_instance*)mapped.pData, (int)count, jobs);
+    gfx->ctx->Unmap(gfx->vbParticle, 0);
+    return (UINT)written;
+}
+
+void g4f_gfx_draw_particles(g4f_gfx* gfx, const g4f_particles* particles, const g4f_gfx_texture* texture,
+                            const g4f_mat4* view, const g4f_mat4* proj, int blendMode, g4f_jobs* jobs) {
+    if (!gfx || !gfx->ctx || !particles || !view || !proj || g4f_particles_count(particles) == 0) return;
+    if (!gfxEnsureParticlePipeline(gfx)) return;
+    if (!texture) texture = gfx->particleWhite;
+    const auto* passTarget = (const g4f_gfx_target*)g4f_pass_stack_current(&gfx->passes).target;
+    if (!texture->srv || (passTarget && passTarget->color == texture)) return; // cannot read the bound target
+    if (!gfx->pendingUploads.empty()) gfxFlushPendingUploads(gfx);
+    const UINT count = gfxUploadParticles(gfx, particles, jobs);
+    if (count == 0) return;
+
+    if (gfx->cachePipeline != 6) {
+        gfx->cachePipeline = 6;
+        gfx->cacheVB = nullptr;
+        gfx->cacheIB = nullptr;
+        gfx->cacheCB0VS = nullptr;
+        gfx->cacheCB0PS = nullptr;
+        gfx->cacheBundle = -1;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_INPUT_LAYOUT, gfx->cacheIL != gfx->ilParticle)) {
+        gfx->ctx->IASetInputLayout(gfx->ilParticle);
+        gfx->cacheIL = gfx->ilParticle;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cacheVS != gfx->vsParticle)) {
+        gfx->ctx->VSSetShader(gfx->vsParticle, nullptr, 0);
+        gfx->cacheVS = gfx->vsParticle;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SHADER, gfx->cachePS != gfx->psParticle)) {
+        gfx->ctx->PSSetShader(gfx->psParticle, nullptr, 0);
+        gfx->cachePS = gfx->psParticle;
+    }
+    UINT stride = (UINT)sizeof(g4f_particle_instance);
+    UINT offset = 0;
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_VERTEX_BUFFER, gfx->cacheVB != gfx->vbParticle || gfx->cacheVBStride != stride || gfx->cacheVBOffset != offset)) {
+        gfx->ctx->IASetVertexBuffers(0, 1, &gfx->vbParticle, &stride, &offset);
+        gfx->cacheVB = gfx->vbParticle;
+        gfx->cacheVBStride = stride;
+        gfx->cacheVBOffset = offset;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TOPOLOGY, gfx->cacheTopo != D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP)) {
+        gfx->ctx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP);
+        gfx->cacheTopo = D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP;
+    }
+    ID3D11BlendState* blend = blendMode == G4F_PARTICLE_BLEND_ADDITIVE ? gfx->bsAdditive : gfx->bsAlpha;
+    float blendFactor[4] = {0, 0, 0, 0};
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_BLEND, gfx->cacheBlend != blend)) {
+        gfx->ctx->OMSetBlendState(blend, blendFactor, 0xFFFFFFFFu);
+        gfx->cacheBlend = blend;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_DEPTH, gfx->cacheDepth != gfx->dsDepthLessNoWrite)) {
+        gfx->ctx->OMSetDepthStencilState(gfx->dsDepthLessNoWrite, 0);
+        gfx->cacheDepth = gfx->dsDepthLessNoWrite;
+    }
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_RASTERIZER, gfx->cacheRS != gfx->rsCullNone)) {
+        gfx->ctx->RSSetState(gfx->rsCullNone);
+        gfx->cacheRS = gfx->rsCullNone;
+    }
+    ID3D11SamplerState* samp = gfx->samplers[G4F_GFX_FILTER_LINEAR][G4F_GFX_ADDRESS_CLAMP];
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_SAMPLER, gfx->cacheSamp0 != samp)) {
+        gfx->ctx->PSSetSamplers(0, 1, &samp);
+        gfx->cacheSamp0 = samp;
+    }
+    ID3D11ShaderResourceView* srv = texture->srv;
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_TEXTURE, gfx->cacheSRV0 != srv)) {
+        gfx->ctx->PSSetShaderResources(0, 1, &srv);
+        gfx->cacheSRV0 = srv;
+    }
+
+    // Camera right/up in world space are the first two columns of the view matrix (row vectors).
+    struct CbParticles {
+        g4f_mat4 viewProj;
+        float right[4];
+        float up[4];
+    } cb{};
+    cb.viewProj = g4f_mat4_mul(*view, *proj);
+    const float* v = view->m;
+    const float right[4] = {v[0], v[4], v[8], 0.0f};
+    const float up[4] = {v[1], v[5], v[9], 0.0f};
+    std::memcpy(cb.right, right, sizeof(right));
+    std::memcpy(cb.up, up, sizeof(up));
+    gfx->ctx->UpdateSubresource(gfx->cbParticle, 0, nullptr, &cb, 0, 0);
+    gfx->frameStats.constantBytes += sizeof(cb);
+    if (gfxStateDiffers(gfx, G4F_GFX_STATE_CONSTANT_BUFFER, gfx->cacheCB0VS != gfx->cbParticle)) {
+        gfx->ctx->VSSetConstantBuffers(0, 1, &gfx->cbParticle);
+        gfx->cacheCB0VS = gfx->cbParticle;
+    }
+
+    gfx->ctx->DrawInstanced(4, count, 0, 0);
+    gfxCountDraw(gfx, count * 6); // two triangles per particle
 }
 
 void g4f_gfx_end(g4f_gfx* gfx) {
     if (!gfx || !gfx->swapChain) return;
+    g4f_gpu_timer_frame_end(gfx->gpuTimer);
+    gfx->frameStats.frameIndex = gfx->framesEnded++;
+    gfx->lastFrameStats = gfx->frameStats;
+    g4f_gfx_frame_stats_reset(&gfx->frameStats);
     gfx->swapChain->Present(gfx->vsync ? 1u : 0u, 0);
 }
+
+void g4f_gfx_get_frame_stats(const g4f_gfx* gfx, g4f_gfx_frame_stats* out) {
+    if (!out) return;
+    if (gfx) *out = gfx->lastFrameStats;
+    else g4f_gfx_frame_stats_reset(out);
+}
+
+const g4f_gpu_timings* g4f_gfx_gpu_timings(const g4f_gfx* gfx) {
+    return gfx ? g4f_gpu_timer_results(gfx->gpuTimer) : nullptr;
+}
+
+void g4f_gfx_gpu_scope_begin(g4f_gfx* gfx, const char* name) {
+    if (!gfx) return;
+    g4f_gpu_timer_scope_begin(gfx->gpuTimer, name);
+}
+
+void g4f_gfx_gpu_scope_end(g4f_gfx* gfx) {
+    if (!gfx) return;
+    g4f_gpu_timer_scope_end(gfx->gpuTimer);
+}
@@ -0,0 +1,98 @@
+#include "../include/g4f/g4f_dirty_rects.h"
+
+namespace {
+
+static int rectArea(const g4f_rect_i& r) {
+    return r.w * r.h;
+}
+
+static g4f_rect_i rectUnion(const g4f_rect_i& a, const g4f_rect_i& b) {
+    int x0 = a.x < b.x ? a.x : b.x;
+    int y0 = a.y < b.y ? a.y : b.y;
+    int x1 = (a.x + a.w) > (b.x + b.w) ? (a.x + a.w) : (b.x + b.w);
+    int y1 = (a.y + a.h) > (b.y + b.h) ? (a.y + a.h) : (b.y + b.h);
+    return g4f_rect_i{x0, y0, x1 - x0, y1 - y0};
+}
+
+static bool rectsOverlap(const g4f_rect_i& a, const g4f_rect_i& b) {
+    return a.x < b.x + b.w && b.x < a.x + a.w && a.y < b.y + b.h && b.y < a.y + a.h;
+}
+
+// Overlapping rects always merge; disjoint ones only when the union is exact (shared full edge).
+static bool shouldMerge(const g4f_rect_i& a, const g4f_rect_i& b) {
+    if (rectsOverlap(a, b)) return true;
+    return rectArea(rectUnion(a, b)) == rectArea(a) + rectArea(b);
+}
+
+static void removeAt(g4f_dirty_rects* dirty, int index) {
+    dirty->rects[index] = dirty->rects[dirty->count - 1];
+    dirty->count--;
+}
+
+} // namespace
+
+void g4f_dirty_rects_reset(g4f_dirty_rects* dirty, int boundsW, int boundsH) {
+    if (!dirty) return;
+    dirty->count = 0;
+    dirty->boundsW = boundsW > 0 ? boundsW : 0;
+    dirty->boundsH = boundsH > 0 ? boundsH : 0;
+}
+
+void g4f_dirty_rects_clear(g4f_dirty_rects* dirty) {
+    if (!dirty) return;
+    dirty->count = 0;
+}
+
+void g4f_dirty_rects_add(g4f_dirty_rects* dirty, int x, int y, int w, int h) {
+    if (!dirty) return;
+
+    int x0 = x < 0 ? 0 : x;
+    int y0 = y < 0 ? 0 : y;
+    int x1 = (x + w) > dirty->boundsW ? dirty->boundsW : (x + w);
+    int y1 = (y + h) > dirty->boundsH ? dirty->boundsH : (y + h);
+    if (x1 <= x0 || y1 <= y0) return;
+    g4f_rect_i r{x0, y0, x1 - x0, y1 - y0};
+
+    for (;;) {
+        bool merged = false;
+        for (int i = 0; i < dirty->count; i++) {
+            if (shouldMerge(dirty->rects[i], r)) {
+                r = rectUnion(dirty->rects[i], r);
+                removeAt(dirty, i);
+                merged = true;
+                break;
+            }
+        }
+        if (merged) continue;
+        if (dirty->count < G4F_DIRTY_RECTS_MAX) break;
+
+        // Full: fold r into the rect whose union wastes the least area, then re-check overlaps.
+        int best = 0;
+        int bestWaste = 0;
+        for (int i = 0; i < dirty->count; i++) {
+            const g4f_rect_i& e = dirty->rects[i];
+            int waste = rectArea(rectUnion(e, r)) - rectArea(e) - rectArea(r);
+            if (i == 0 || waste < bestWaste) {
+                best = i;
+                bestWaste = waste;
+            }
+        }
+        r = rectUnion(dirty->rects[best], r);
+        removeAt(dirty, best);
+    }
+
+    dirty->rects[dirty->count++] = r;
+}
+
+void g4f_dirty_rects_add_all(g4f_dirty_rects* dirty) {
+    if (!dirty) return;
+    dirty->count = 0;
+    g4f_dirty_rects_add(dirty, 0, 0, dirty->boundsW, dirty->boundsH);
+}
+
+int g4f_dirty_rects_area(const g4f_dirty_rects* dirty) {
+    if (!dirty) return 0;
+    int area = 0;
+    for (int i = 0; i < dirty->count; i++) area += rectArea(dirty->rects[i]);
+    return area;
+}
@@ -0,0 +1,96 @@
+#include "../include/g4f/g4f_dynres.h"
+
+#include <cmath>
+
+namespace {
+
+static float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static float quantizeDown(float scale, float step) {
+    if (step <= 0.0f) return scale;
+    // Small epsilon so exact multiples (0.7 / 0.05) do not fall one step short.
+    return std::floor(scale / step + 1e-4f) * step;
+}
+
+static void resetMeasurements(g4f_dynres* dynres) {
+    dynres->avgFrameMs = 0.0f;
+    dynres->overFrames = 0;
+    dynres->underFrames = 0;
+}
+
+} // namespace
+
+g4f_dynres_desc g4f_dynres_desc_default(void) {
+    g4f_dynres_desc d{};
+    d.targetFrameMs = 1000.0f / 60.0f;
+    d.minScale = 0.5f;
+    d.maxScale = 1.0f;
+    d.scaleStep = 0.05f;
+    d.upperBand = 1.05f;
+    d.lowerBand = 0.85f;
+    d.lowerFrames = 3;
+    d.raiseFrames = 30;
+    d.smoothing = 0.2f;
+    return d;
+}
+
+void g4f_dynres_init(g4f_dynres* dynres, const g4f_dynres_desc* desc) {
+    if (!dynres) return;
+    g4f_dynres_desc d = desc ? *desc : g4f_dynres_desc_default();
+    if (d.targetFrameMs <= 0.0f) d.targetFrameMs = 1000.0f / 60.0f;
+    if (d.maxScale <= 0.0f) d.maxScale = 1.0f;
+    if (d.minScale <= 0.0f || d.minScale > d.maxScale) d.minScale = d.maxScale;
+    if (d.scaleStep < 0.0f) d.scaleStep = 0.0f;
+    if (d.upperBand < 1.0f) d.upperBand = 1.0f;
+    if (d.lowerBand <= 0.0f || d.lowerBand > 1.0f) d.lowerBand = 1.0f;
+    if (d.lowerFrames < 1) d.lowerFrames = 1;
+    if (d.raiseFrames < 1) d.raiseFrames = 1;
+    if (d.smoothing <= 0.0f || d.smoothing > 1.0f) d.smoothing = 1.0f;
+
+    dynres->desc = d;
+    dynres->scale = d.maxScale;
+    dynres->changes = 0;
+    resetMeasurements(dynres);
+}
+
+float g4f_dynres_update(g4f_dynres* dynres, float cpuMs, float gpuMs) {
+    if (!dynres) return 1.0f;
+    const g4f_dynres_desc& d = dynres->desc;
+
+    float frameMs = cpuMs > 0.0f ? cpuMs : 0.0f;
+    if (gpuMs > frameMs) frameMs = gpuMs;
+    if (dynres->avgFrameMs <= 0.0f) dynres->avgFrameMs = frameMs;
+    else dynres->avgFrameMs += (frameMs - dynres->avgFrameMs) * d.smoothing;
+
+    const float avg = dynres->avgFrameMs;
+    float next = dynres->scale;
+    if (avg > d.targetFrameMs * d.upperBand) {
+        dynres->underFrames = 0;
+        if (++dynres->overFrames >= d.lowerFrames) {
+            float estimate = dynres->scale * std::sqrt(d.targetFrameMs / avg);
+            next = quantizeDown(estimate, d.scaleStep);
+            if (next >= dynres->scale) next = dynres->scale - d.scaleStep;
+        }
+    } else if (avg < d.targetFrameMs * d.lowerBand) {
+        dynres->overFrames = 0;
+        if (++dynres->underFrames >= d.raiseFrames) next = dynres->scale + d.scaleStep;
+    } else {
+        dynres->overFrames = 0;
+        dynres->underFrames = 0;
+    }
+
+    next = clampf(next, d.minScale, d.maxScale);
+    if (next != dynres->scale) {
+        dynres->scale = next;
+        dynres->changes++;
+        // Samples taken at the old scale say nothing about the new one.
+        resetMeasurements(dynres);
+    } else if (dynres->overFrames >= d.lowerFrames || dynres->underFrames >= d.raiseFrames) {
+        // Pinned at a limit: keep counting from scratch instead of overflowing.
+        dynres->overFrames = 0;
+        dynres->underFrames = 0;
+    }
+    return dynres->scale;
+}
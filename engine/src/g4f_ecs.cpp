@@ -0,0 +1,653 @@
+#include "../include/g4f/g4f_ecs.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <memory>
+#include <new>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+constexpr int kChunkBytes = 16 * 1024;
+constexpr size_t kChunkAlign = 64;
+
+// Handle = generation << kSlotBits | (slot + 1). A slot whose generation reaches kGenMask is
+// retired instead of wrapping, so old handles can never match a later entity.
+constexpr int kSlotBits = 22;
+constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1u;
+constexpr uint32_t kGenMask = (1u << (32 - kSlotBits)) - 1u;
+
+struct ComponentInfo {
+    std::string name;
+    int size = 0;
+    int align = 16;
+    std::vector<uint8_t> defaultValue; // empty = zero
+};
+
+struct Chunk {
+    uint8_t* data = nullptr; // entity column first, then one column per component
+    int count = 0;
+};
+
+struct Archetype {
+    uint64_t mask = 0;
+    std::vector<int> components; // ascending ids
+    int columnOffset[G4F_ECS_MAX_COMPONENTS];
+    int capacity = 0;   // entities per chunk
+    int chunkBytes = 0;
+    int count = 0;
+    std::vector<Chunk> chunks; // only the last chunk may be partly filled
+    int addEdge[G4F_ECS_MAX_COMPONENTS];
+    int removeEdge[G4F_ECS_MAX_COMPONENTS];
+};
+
+struct EntityRecord {
+    int archetype = -1;
+    int chunk = 0;
+    int row = 0;
+};
+
+struct WorkItem {
+    int system; // index into the batch's systems (0 for plain queries)
+    int archetype;
+    int chunk;
+};
+
+// Draw list sort key; (archetype, chunk, row) locates the source entity.
+struct DrawKey {
+    const g4f_gfx_material* material;
+    const g4f_gfx_mesh* mesh;
+    g4f_entity entity;
+    int archetype;
+    int chunk;
+    int row;
+};
+
+static int alignUp(int v, int a) {
+    return (v + a - 1) & ~(a - 1);
+}
+
+static uint64_t bitOf(int component) {
+    return 1ull << component;
+}
+
+} // namespace
+
+struct g4f_ecs_query {
+    g4f_ecs* ecs = nullptr;
+    uint64_t with = 0;
+    uint64_t without = 0;
+    int withIds[G4F_ECS_QUERY_MAX];
+    int withCount = 0;
+    std::vector<int> archetypes; // matching, cached
+    size_t scanned = 0;          // archetypes examined so far
+    std::vector<WorkItem> items;
+};
+
+struct g4f_ecs {
+    std::vector<ComponentInfo> components;
+    std::vector<std::unique_ptr<Archetype>> archetypes;
+    std::unordered_map<uint64_t, int> archetypeByMask;
+
+    std::vector<uint32_t> slotGen;
+    std::vector<EntityRecord> slotRecord;
+    std::vector<uint32_t> freeSlots;
+    int entityCount = 0;
+
+    std::vector<g4f_ecs_query*> queries;
+    g4f_ecs_query* transformQuery = nullptr;
+    g4f_ecs_query* drawQuery = nullptr;
+
+    // run_systems scratch.
+    std::vector<WorkItem> batchItems;
+    std::vector<const g4f_ecs_system*> batchSystems;
+
+    std::vector<DrawKey> drawKeys;
+    std::vector<g4f_ecs_draw> draws;
+    g4f_mat4 viewProj{};
+};
+
+namespace {
+
+static uint8_t* column(const Archetype& a, const Chunk& chunk, int component) {
+    return chunk.data + a.columnOffset[component];
+}
+
+static g4f_entity* entityColumn(const Chunk& chunk) {
+    return reinterpret_cast<g4f_entity*>(chunk.data);
+}
+
+static bool componentValid(const g4f_ecs* ecs, int component) {
+    return component >= 0 && component < (int)ecs->components.size();
+}
+
+static int archetypeFor(g4f_ecs* ecs, uint64_t mask) {
+    auto it = ecs->archetypeByMask.find(mask);
+    if (it != ecs->archetypeByMask.end()) return it->second;
+
+    auto a = std::make_unique<Archetype>();
+    a->mask = mask;
+    for (int c = 0; c < G4F_ECS_MAX_COMPONENTS; c++) {
+        a->columnOffset[c] = -1;
+        a->addEdge[c] = -1;
+        a->removeEdge[c] = -1;
+        if (mask & bitOf(c)) a->components.push_back(c);
+    }
+
+    // Largest capacity whose columns (each aligned) fit the chunk; oversized components get
+    // single-entity chunks of whatever size they need.
+    int perEntity = (int)sizeof(g4f_entity);
+    for (int c : a->components) perEntity += ecs->components[(size_t)c].size;
+    int capacity = std::max(1, kChunkBytes / perEntity);
+    for (;;) {
+        int offset = (int)sizeof(g4f_entity) * capacity;
+        for (int c : a->components) {
+            const ComponentInfo& info = ecs->components[(size_t)c];
+            offset = alignUp(offset, info.align);
+            a->columnOffset[c] = offset;
+            offset += info.size * capacity;
+        }
+        if (offset <= kChunkBytes || capacity == 1) {
+            a->capacity = capacity;
+            a->chunkBytes = alignUp(std::max(offset, 1), (int)kChunkAlign);
+            break;
+        }
+        capacity--;
+    }
+
+    const int index = (int)ecs->archetypes.size();
+    ecs->archetypes.push_back(std::move(a));
+    ecs->archetypeByMask.emplace(mask, index);
+    return index;
+}
+
+static void writeDefault(const g4f_ecs* ecs, uint8_t* dst, int component) {
+    const ComponentInfo& info = ecs->components[(size_t)component];
+    if (info.size == 0) return;
+    if (info.defaultValue.empty()) std::memset(dst, 0, (size_t)info.size);
+    else std::memcpy(dst, info.defaultValue.data(), (size_t)info.size);
+}
+
+// Appends a row to the archetype (last chunk, or a new one).
+static void allocRow(Archetype& a, int* chunkIndex, int* row) {
+    if (a.chunks.empty() || a.chunks.back().count == a.capacity) {
+        Chunk chunk;
+        chunk.data = static_cast<uint8_t*>(::operator new((size_t)a.chunkBytes, std::align_val_t{kChunkAlign}));
+        a.chunks.push_back(chunk);
+    }
+    *chunkIndex = (int)a.chunks.size() - 1;
+    *row = a.chunks.back().count++;
+    a.count++;
+}
+
+// Removes a row by moving the archetype's last entity into it.
+static void removeRow(g4f_ecs* ecs, Archetype& a, int chunkIndex, int row) {
+    Chunk& last = a.chunks.back();
+    const int lastChunk = (int)a.chunks.size() - 1;
+    const int lastRow = last.count - 1;
+    if (chunkIndex != lastChunk || row != lastRow) {
+        Chunk& dst = a.chunks[(size_t)chunkIndex];
+        const g4f_entity moved = entityColumn(last)[lastRow];
+        entityColumn(dst)[row] = moved;
+        for (int c : a.components) {
+            const int size = ecs->components[(size_t)c].size;
+            if (size == 0) continue;
+            std::memcpy(column(a, dst, c) + (size_t)row * size, column(a, last, c) + (size_t)lastRow * size, (size_t)size);
+        }
+        EntityRecord& rec = ecs->slotRecord[(moved & kSlotMask) - 1u];
+        rec.chunk = chunkIndex;
+        rec.row = row;
+    }
+    last.count--;
+    a.count--;
+    if (last.count == 0) {
+        ::operator delete(last.data, std::align_val_t{kChunkAlign});
+        a.chunks.pop_back();
+    }
+}
+
+static int slotOf(const g4f_ecs* ecs, g4f_entity entity) {
+    if (!ecs || entity == G4F_ENTITY_NULL) return -1;
+    const uint32_t slotPlusOne = entity & kSlotMask;
+    if (slotPlusOne == 0) return -1;
+    const uint32_t slot = slotPlusOne - 1u;
+    if (slot >= ecs->slotGen.size() || ecs->slotGen[slot] != (entity >> kSlotBits)) return -1;
+    if (ecs->slotRecord[slot].archetype < 0) return -1;
+    return (int)slot;
+}
+
+static g4f_entity allocEntity(g4f_ecs* ecs, uint32_t* outSlot) {
+    uint32_t slot = 0;
+    if (!ecs->freeSlots.empty()) {
+        slot = ecs->freeSlots.back();
+        ecs->freeSlots.pop_back();
+    } else {
+        if (ecs->slotGen.size() >= (size_t)kSlotMask) return G4F_ENTITY_NULL;
+        slot = (uint32_t)ecs->slotGen.size();
+        ecs->slotGen.push_back(0);
+        ecs->slotRecord.push_back(EntityRecord{});
+    }
+    *outSlot = slot;
+    return (ecs->slotGen[slot] << kSlotBits) | (slot + 1u);
+}
+
+// Moves an entity to archetype `dstIndex`, keeping shared components and defaulting new ones.
+static void moveEntity(g4f_ecs* ecs, uint32_t slot, int dstIndex) {
+    EntityRecord& rec = ecs->slotRecord[slot];
+    Archetype& src = *ecs->archetypes[(size_t)rec.archetype];
+    Archetype& dst = *ecs->archetypes[(size_t)dstIndex];
+    int chunkIndex = 0, row = 0;
+    allocRow(dst, &chunkIndex, &row);
+    Chunk& to = dst.chunks[(size_t)chunkIndex];
+    const Chunk& from = src.chunks[(size_t)rec.chunk];
+    entityColumn(to)[row] = entityColumn(from)[rec.row];
+    for (int c : dst.components) {
+        const int size = ecs->components[(size_t)c].size;
+        if (size == 0) continue;
+        uint8_t* out = column(dst, to, c) + (size_t)row * size;
+        if (src.mask & bitOf(c)) std::memcpy(out, column(src, from, c) + (size_t)rec.row * size, (size_t)size);
+        else writeDefault(ecs, out, c);
+    }
+    removeRow(ecs, src, rec.chunk, rec.row);
+    rec.archetype = dstIndex;
+    rec.chunk = chunkIndex;
+    rec.row = row;
+}
+
+static void refreshQuery(g4f_ecs_query* query) {
+    g4f_ecs* ecs = query->ecs;
+    for (; query->scanned < ecs->archetypes.size(); query->scanned++) {
+        const uint64_t mask = ecs->archetypes[query->scanned]->mask;
+        if ((mask & query->with) == query->with && (mask & query->without) == 0) query->archetypes.push_back((int)query->scanned);
+    }
+}
+
+static void appendItems(g4f_ecs_query* query, int system, std::vector<WorkItem>& items) {
+    refreshQuery(query);
+    for (int a : query->archetypes) {
+        const Archetype& arch = *query->ecs->archetypes[(size_t)a];
+        for (int c = 0; c < (int)arch.chunks.size(); c++) items.push_back(WorkItem{system, a, c});
+    }
+}
+
+static void fillChunkView(const g4f_ecs_query* query, const WorkItem& item, g4f_ecs_chunk* view) {
+    const g4f_ecs* ecs = query->ecs;
+    const Archetype& arch = *ecs->archetypes[(size_t)item.archetype];
+    const Chunk& chunk = arch.chunks[(size_t)item.chunk];
+    view->count = chunk.count;
+    view->entities = entityColumn(chunk);
+    for (int i = 0; i < G4F_ECS_QUERY_MAX; i++) view->columns[i] = nullptr;
+    for (int i = 0; i < query->withCount; i++) {
+        const int c = query->withIds[i];
+        if (ecs->components[(size_t)c].size > 0) view->columns[i] = column(arch, chunk, c);
+    }
+}
+
+struct QueryRun {
+    g4f_ecs_query* query;
+    g4f_ecs_chunk_fn fn;
+    void* user;
+};
+
+static void queryJob(void* user, int begin, int end, int workerIndex) {
+    auto* run = static_cast<QueryRun*>(user);
+    for (int i = begin; i < end; i++) {
+        g4f_ecs_chunk view;
+        fillChunkView(run->query, run->query->items[(size_t)i], &view);
+        run->fn(run->user, &view, workerIndex);
+    }
+}
+
+static void batchJob(void* user, int begin, int end, int workerIndex) {
+    auto* ecs = static_cast<g4f_ecs*>(user);
+    for (int i = begin; i < end; i++) {
+        const WorkItem& item = ecs->batchItems[(size_t)i];
+        const g4f_ecs_system* system = ecs->batchSystems[(size_t)item.system];
+        g4f_ecs_chunk view;
+        fillChunkView(system->query, item, &view);
+        system->fn(system->user, &view, workerIndex);
+    }
+}
+
+static bool systemsConflict(const g4f_ecs_system& a, const g4f_ecs_system& b) {
+    const uint64_t readsA = a.query->with;
+    const uint64_t readsB = b.query->with;
+    return (a.writes & (readsB | b.writes)) != 0 || (b.writes & readsA) != 0;
+}
+
+static void runBatch(g4f_ecs* ecs, g4f_jobs* jobs) {
+    ecs->batchItems.clear();
+    for (size_t s = 0; s < ecs->batchSystems.size(); s++) appendItems(ecs->batchSystems[s]->query, (int)s, ecs->batchItems);
+    if (!ecs->batchItems.empty()) g4f_jobs_parallel_for(jobs, (int)ecs->batchItems.size(), 1, batchJob, ecs);
+    ecs->batchSystems.clear();
+}
+
+static void transformChunk(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)user;
+    (void)workerIndex;
+    const auto* transforms = static_cast<const g4f_ecs_transform*>(chunk->columns[0]);
+    auto* world = static_cast<g4f_mat4*>(chunk->columns[1]);
+    for (int i = 0; i < chunk->count; i++) world[i] = g4f_mat4_trs(transforms[i].position, transforms[i].rotation, transforms[i].scale);
+}
+
+static void drawsJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    auto* ecs = static_cast<g4f_ecs*>(user);
+    for (int k = begin; k < end; k++) {
+        const DrawKey& key = ecs->drawKeys[(size_t)k];
+        const Archetype& arch = *ecs->archetypes[(size_t)key.archetype];
+        const auto* world = reinterpret_cast<const g4f_mat4*>(column(arch, arch.chunks[(size_t)key.chunk], G4F_ECS_WORLD));
+        g4f_ecs_draw& d = ecs->draws[(size_t)k];
+        d.mesh = key.mesh;
+        d.material = key.material;
+        d.model = world[key.row];
+        mat4Mul(d.model.m, ecs->viewProj.m, d.mvp.m);
+        d.entity = key.entity;
+    }
+}
+
+} // namespace
+
+g4f_ecs* g4f_ecs_create(void) {
+    auto* ecs = new g4f_ecs();
+    g4f_ecs_transform identity{};
+    identity.rotation = g4f_quat_identity();
+    identity.scale = g4f_vec3{1.0f, 1.0f, 1.0f};
+    const g4f_mat4 world = g4f_mat4_identity();
+    g4f_ecs_register_component(ecs, "transform", (int)sizeof(g4f_ecs_transform), 16, &identity);
+    g4f_ecs_register_component(ecs, "world", (int)sizeof(g4f_mat4), 16, &world);
+    g4f_ecs_register_component(ecs, "renderable", (int)sizeof(g4f_ecs_renderable), 16, nullptr);
+    archetypeFor(ecs, 0);
+
+    const int transformIds[] = {G4F_ECS_TRANSFORM, G4F_ECS_WORLD};
+    const int drawIds[] = {G4F_ECS_WORLD, G4F_ECS_RENDERABLE};
+    ecs->transformQuery = g4f_ecs_query_create(ecs, transformIds, 2, nullptr, 0);
+    ecs->drawQuery = g4f_ecs_query_create(ecs, drawIds, 2, nullptr, 0);
+    return ecs;
+}
+
+void g4f_ecs_destroy(g4f_ecs* ecs) {
+    if (!ecs) return;
+    for (g4f_ecs_query* q : ecs->queries) delete q;
+    for (auto& a : ecs->archetypes) {
+        for (Chunk& chunk : a->chunks) ::operator delete(chunk.data, std::align_val_t{kChunkAlign});
+    }
+    delete ecs;
+}
+
+int g4f_ecs_register_component(g4f_ecs* ecs, const char* name, int size, int align, const void* defaultValue) {
+    if (!ecs || size < 0 || size > (1 << 20) || align < 0 || align > (int)kChunkAlign || (align & (align - 1)) != 0) {
+        g4f_set_last_error("g4f_ecs_register_component: invalid args");
+        return -1;
+    }
+    if ((int)ecs->components.size() >= G4F_ECS_MAX_COMPONENTS) {
+        g4f_set_last_error("g4f_ecs_register_component: too many components");
+        return -1;
+    }
+    ComponentInfo info;
+    info.name = name ? name : "";
+    info.size = size;
+    info.align = std::max(align > 0 ? align : 16, (int)alignof(g4f_entity));
+    if (defaultValue && size > 0) {
+        const auto* bytes = static_cast<const uint8_t*>(defaultValue);
+        info.defaultValue.assign(bytes, bytes + size);
+    }
+    ecs->components.push_back(std::move(info));
+    return (int)ecs->components.size() - 1;
+}
+
+int g4f_ecs_component_size(const g4f_ecs* ecs, int component) {
+    if (!ecs || !componentValid(ecs, component)) return -1;
+    return ecs->components[(size_t)component].size;
+}
+
+int g4f_ecs_spawn(g4f_ecs* ecs, const int* components, int componentCount, int count, g4f_entity* outEntities) {
+    if (!ecs || count < 0 || componentCount < 0 || (componentCount > 0 && !components)) {
+        g4f_set_last_error("g4f_ecs_spawn: invalid args");
+        return 0;
+    }
+    uint64_t mask = 0;
+    for (int i = 0; i < componentCount; i++) {
+        if (!componentValid(ecs, components[i])) {
+            g4f_set_last_error("g4f_ecs_spawn: invalid component");
+            return 0;
+        }
+        mask |= bitOf(components[i]);
+    }
+    const int archIndex = archetypeFor(ecs, mask);
+    Archetype& arch = *ecs->archetypes[(size_t)archIndex];
+
+    for (int n = 0; n < count; n++) {
+        uint32_t slot = 0;
+        const g4f_entity e = allocEntity(ecs, &slot);
+        if (e == G4F_ENTITY_NULL) {
+            g4f_set_last_error("g4f_ecs_spawn: too many entities");
+            return n;
+        }
+        int chunkIndex = 0, row = 0;
+        allocRow(arch, &chunkIndex, &row);
+        Chunk& chunk = arch.chunks[(size_t)chunkIndex];
+        entityColumn(chunk)[row] = e;
+        for (int c : arch.components) {
+            const int size = ecs->components[(size_t)c].size;
+            if (size > 0) writeDefault(ecs, column(arch, chunk, c) + (size_t)row * size, c);
+        }
+        ecs->slotRecord[slot] = EntityRecord{archIndex, chunkIndex, row};
+        ecs->entityCount++;
+        if (outEntities) outEntities[n] = e;
+    }
+    return count;
+}
+
+g4f_entity g4f_ecs_create_entity(g4f_ecs* ecs) {
+    g4f_entity e = G4F_ENTITY_NULL;
+    g4f_ecs_spawn(ecs, nullptr, 0, 1, &e);
+    return e;
+}
+
+void g4f_ecs_destroy_entity(g4f_ecs* ecs, g4f_entity entity) {
+    const int slot = slotOf(ecs, entity);
+    if (slot < 0) return;
+    EntityRecord& rec = ecs->slotRecord[(size_t)slot];
+    removeRow(ecs, *ecs->archetypes[(size_t)rec.archetype], rec.chunk, rec.row);
+    rec = EntityRecord{};
+    if (++ecs->slotGen[(size_t)slot] < kGenMask) ecs->freeSlots.push_back((uint32_t)slot);
+    ecs->entityCount--;
+}
+
+int g4f_ecs_alive(const g4f_ecs* ecs, g4f_entity entity) {
+    return slotOf(ecs, entity) >= 0 ? 1 : 0;
+}
+
+int g4f_ecs_entity_count(const g4f_ecs* ecs) {
+    return ecs ? ecs->entityCount : 0;
+}
+
+int g4f_ecs_add(g4f_ecs* ecs, g4f_entity entity, int component, const void* value) {
+    const int slot = slotOf(ecs, entity);
+    if (slot < 0 || !componentValid(ecs, component)) return 0;
+    Archetype* src = ecs->archetypes[(size_t)ecs->slotRecord[(size_t)slot].archetype].get();
+    if (!(src->mask & bitOf(component))) {
+        int dst = src->addEdge[component];
+        if (dst < 0) {
+            dst = archetypeFor(ecs, src->mask | bitOf(component));
+            src->addEdge[component] = dst;
+        }
+        moveEntity(ecs, (uint32_t)slot, dst);
+    }
+    const int size = ecs->components[(size_t)component].size;
+    if (value && size > 0) {
+        const EntityRecord& rec = ecs->slotRecord[(size_t)slot];
+        const Archetype& arch = *ecs->archetypes[(size_t)rec.archetype];
+        std::memcpy(column(arch, arch.chunks[(size_t)rec.chunk], component) + (size_t)rec.row * size, value, (size_t)size);
+    }
+    return 1;
+}
+
+int g4f_ecs_remove(g4f_ecs* ecs, g4f_entity entity, int component) {
+    const int slot = slotOf(ecs, entity);
+    if (slot < 0 || !componentValid(ecs, component)) return 0;
+    Archetype* src = ecs->archetypes[(size_t)ecs->slotRecord[(size_t)slot].archetype].get();
+    if (!(src->mask & bitOf(component))) return 1;
+    int dst = src->removeEdge[component];
+    if (dst < 0) {
+        dst = archetypeFor(ecs, src->mask & ~bitOf(component));
+        src->removeEdge[component] = dst;
+    }
+    moveEntity(ecs, (uint32_t)slot, dst);
+    return 1;
+}
+
+int g4f_ecs_has(const g4f_ecs* ecs, g4f_entity entity, int component) {
+    const int slot = slotOf(ecs, entity);
+    if (slot < 0 || !componentValid(ecs, component)) return 0;
+    return (ecs->archetypes[(size_t)ecs->slotRecord[(size_t)slot].archetype]->mask & bitOf(component)) ? 1 : 0;
+}
+
+void* g4f_ecs_get(g4f_ecs* ecs, g4f_entity entity, int component) {
+    const int slot = slotOf(ecs, entity);
+    if (slot < 0 || !componentValid(ecs, component)) return nullptr;
+    const EntityRecord& rec = ecs->slotRecord[(size_t)slot];
+    const Archetype& arch = *ecs->archetypes[(size_t)rec.archetype];
+    const int size = ecs->components[(size_t)component].size;
+    if (!(arch.mask & bitOf(component)) || size == 0) return nullptr;
+    return column(arch, arch.chunks[(size_t)rec.chunk], component) + (size_t)rec.row * size;
+}
+
+g4f_ecs_query* g4f_ecs_query_create(g4f_ecs* ecs, const int* with, int withCount, const int* without, int withoutCount) {
+    if (!ecs || withCount < 0 || withCount > G4F_ECS_QUERY_MAX || (withCount > 0 && !with) || withoutCount < 0 ||
+        (withoutCount > 0 && !without)) {
+        g4f_set_last_error("g4f_ecs_query_create: invalid args");
+        return nullptr;
+    }
+    auto* query = new g4f_ecs_query();
+    query->ecs = ecs;
+    for (int i = 0; i < withCount; i++) {
+        if (!componentValid(ecs, with[i])) {
+            delete query;
+            g4f_set_last_error("g4f_ecs_query_create: invalid component");
+            return nullptr;
+        }
+        query->withIds[i] = with[i];
+        query->with |= bitOf(with[i]);
+    }
+    query->withCount = withCount;
+    for (int i = 0; i < withoutCount; i++) {
+        if (!componentValid(ecs, without[i])) {
+            delete query;
+            g4f_set_last_error("g4f_ecs_query_create: invalid component");
+            return nullptr;
+        }
+        query->without |= bitOf(without[i]);
+    }
+    ecs->queries.push_back(query);
+    return query;
+}
+
+void g4f_ecs_query_destroy(g4f_ecs_query* query) {
+    if (!query) return;
+    std::vector<g4f_ecs_query*>& list = query->ecs->queries;
+    list.erase(std::remove(list.begin(), list.end(), query), list.end());
+    delete query;
+}
+
+int g4f_ecs_query_entity_count(g4f_ecs_query* query) {
+    if (!query) return 0;
+    refreshQuery(query);
+    int total = 0;
+    for (int a : query->archetypes) total += query->ecs->archetypes[(size_t)a]->count;
+    return total;
+}
+
+void g4f_ecs_query_each(g4f_ecs_query* query, g4f_ecs_chunk_fn fn, void* user) {
+    g4f_ecs_query_run(query, nullptr, fn, user);
+}
+
+void g4f_ecs_query_run(g4f_ecs_query* query, g4f_jobs* jobs, g4f_ecs_chunk_fn fn, void* user) {
+    if (!query || !fn) return;
+    query->items.clear();
+    appendItems(query, 0, query->items);
+    if (query->items.empty()) return;
+    QueryRun run{query, fn, user};
+    g4f_jobs_parallel_for(jobs, (int)query->items.size(), 1, queryJob, &run);
+}
+
+int g4f_ecs_run_systems(g4f_ecs* ecs, const g4f_ecs_system* systems, int systemCount, g4f_jobs* jobs) {
+    if (!ecs || systemCount < 0 || (systemCount > 0 && !systems)) {
+        g4f_set_last_error("g4f_ecs_run_systems: invalid args");
+        return -1;
+    }
+    for (int i = 0; i < systemCount; i++) {
+        if (!systems[i].query || systems[i].query->ecs != ecs || !systems[i].fn) {
+            g4f_set_last_error("g4f_ecs_run_systems: invalid system");
+            return -1;
+        }
+    }
+
+    int batches = 0;
+    ecs->batchSystems.clear();
+    for (int i = 0; i < systemCount; i++) {
+        bool conflict = false;
+        for (const g4f_ecs_system* other : ecs->batchSystems) conflict = conflict || systemsConflict(systems[i], *other);
+        if (conflict) {
+            runBatch(ecs, jobs);
+            batches++;
+        }
+        ecs->batchSystems.push_back(&systems[i]);
+    }
+    if (!ecs->batchSystems.empty()) {
+        runBatch(ecs, jobs);
+        batches++;
+    }
+    return batches;
+}
+
+void g4f_ecs_update_transforms(g4f_ecs* ecs, g4f_jobs* jobs) {
+    if (!ecs) return;
+    g4f_ecs_query_run(ecs->transformQuery, jobs, transformChunk, nullptr);
+}
+
+int g4f_ecs_build_draws(g4f_ecs* ecs, const g4f_mat4* viewProj, g4f_jobs* jobs) {
+    if (!ecs || !viewProj) {
+        g4f_set_last_error("g4f_ecs_build_draws: invalid args");
+        return 0;
+    }
+    g4f_ecs_query* query = ecs->drawQuery;
+    refreshQuery(query);
+    ecs->drawKeys.clear();
+    for (int a : query->archetypes) {
+        const Archetype& arch = *ecs->archetypes[(size_t)a];
+        for (int c = 0; c < (int)arch.chunks.size(); c++) {
+            const Chunk& chunk = arch.chunks[(size_t)c];
+            const auto* renderables = reinterpret_cast<const g4f_ecs_renderable*>(column(arch, chunk, G4F_ECS_RENDERABLE));
+            for (int row = 0; row < chunk.count; row++) {
+                const g4f_ecs_renderable& r = renderables[row];
+                if (r.mesh && r.material) ecs->drawKeys.push_back(DrawKey{r.material, r.mesh, entityColumn(chunk)[row], a, c, row});
+            }
+        }
+    }
+    std::sort(ecs->drawKeys.begin(), ecs->drawKeys.end(), [](const DrawKey& x, const DrawKey& y) {
+        if (x.material != y.material) return std::less<const g4f_gfx_material*>()(x.material, y.material);
+        if (x.mesh != y.mesh) return std::less<const g4f_gfx_mesh*>()(x.mesh, y.mesh);
+        return x.entity < y.entity;
+    });
+
+    const int count = (int)ecs->drawKeys.size();
+    ecs->viewProj = *viewProj;
+    ecs->draws.resize((size_t)count);
+    if (count > 0) g4f_jobs_parallel_for(jobs, count, 0, drawsJob, ecs);
+    return count;
+}
+
+const g4f_ecs_draw* g4f_ecs_draws(const g4f_ecs* ecs, int* count) {
+    if (count) *count = ecs ? (int)ecs->draws.size() : 0;
+    return (ecs && !ecs->draws.empty()) ? ecs->draws.data() : nullptr;
+}
@@ -0,0 +1,104 @@
+#include "g4f_file_map_internal.h"
+
+#include "g4f_error_internal.h"
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <string>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+int g4f_file_map_open(g4f_file_map* map, const char* pathUtf8, const char* context) {
+    *map = g4f_file_map{};
+    if (!pathUtf8 || !pathUtf8[0]) {
+        g4f_set_last_errorf("%s: path is empty", context);
+        return 0;
+    }
+    const std::filesystem::path path(std::u8string((const char8_t*)pathUtf8));
+
+#ifdef _WIN32
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        g4f_set_last_win32_error(context, GetLastError());
+        return 0;
+    }
+    LARGE_INTEGER size{};
+    if (!GetFileSizeEx(file, &size)) {
+        g4f_set_last_win32_error(context, GetLastError());
+        CloseHandle(file);
+        return 0;
+    }
+    if (size.QuadPart == 0) {
+        CloseHandle(file);
+        return 1;
+    }
+    HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const DWORD mappingError = GetLastError();
+    CloseHandle(file); // the mapping keeps the file open
+    if (!mapping) {
+        g4f_set_last_win32_error(context, mappingError);
+        return 0;
+    }
+    const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!view) {
+        g4f_set_last_win32_error(context, GetLastError());
+        CloseHandle(mapping);
+        return 0;
+    }
+    map->data = view;
+    map->size = (size_t)size.QuadPart;
+    map->mapping = mapping;
+    return 1;
+#else
+    const int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        g4f_set_last_errorf("%s: cannot open file (%s)", context, std::strerror(errno));
+        return 0;
+    }
+    struct stat st{};
+    if (fstat(fd, &st) != 0) {
+        g4f_set_last_errorf("%s: cannot stat file (%s)", context, std::strerror(errno));
+        close(fd);
+        return 0;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return 1;
+    }
+    void* view = mmap(nullptr, (size_t)st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    const int mapError = errno;
+    close(fd); // the mapping keeps the file open
+    if (view == MAP_FAILED) {
+        g4f_set_last_errorf("%s: mmap failed (%s)", context, std::strerror(mapError));
+        return 0;
+    }
+    map->data = view;
+    map->size = (size_t)st.st_size;
+    return 1;
+#endif
+}
+
+void g4f_file_map_close(g4f_file_map* map) {
+    if (!map) return;
+#ifdef _WIN32
+    if (map->data) UnmapViewOfFile(map->data);
+    if (map->mapping) CloseHandle((HANDLE)map->mapping);
+#else
+    if (map->data) munmap((void*)map->data, map->size);
+#endif
+    *map = g4f_file_map{};
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstddef>
+
+// Internal read-only memory-mapped files (Win32 file mappings, POSIX mmap elsewhere).
+// Pages are faulted in on first access, so mapping a large file costs about the same as mapping
+// a small one. An empty file maps with data == nullptr and size == 0.
+
+struct g4f_file_map {
+    const void* data = nullptr;
+    size_t size = 0;
+    void* mapping = nullptr; // Win32 mapping handle (unused elsewhere)
+};
+
+// Returns 1 on success, 0 on failure (see g4f_last_error(), prefixed with `context`).
+int g4f_file_map_open(g4f_file_map* map, const char* pathUtf8, const char* context);
+void g4f_file_map_close(g4f_file_map* map);
@@ -0,0 +1,110 @@
+#include "../include/g4f/g4f_frame_stats.h"
+
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+struct MsgWriter {
+    char* msg;
+    int cap;
+    int len;
+};
+
+static void advance(MsgWriter* w, int written) {
+    w->len = (written < 0 || w->len + written >= w->cap) ? w->cap - 1 : w->len + written;
+}
+
+// Appends "; "-separated entries; output stops (truncated) once the buffer is full.
+static void appendf(MsgWriter* w, const char* fmt, ...) {
+    if (!w->msg || w->cap <= 0) return;
+    if (w->len > 0 && w->len < w->cap - 1) advance(w, std::snprintf(w->msg + w->len, (size_t)(w->cap - w->len), "; "));
+    if (w->len >= w->cap - 1) return;
+    va_list args;
+    va_start(args, fmt);
+    advance(w, std::vsnprintf(w->msg + w->len, (size_t)(w->cap - w->len), fmt, args));
+    va_end(args);
+}
+
+} // namespace
+
+void g4f_gfx_frame_stats_reset(g4f_gfx_frame_stats* stats) {
+    if (!stats) return;
+    std::memset(stats, 0, sizeof(*stats));
+}
+
+int g4f_gfx_frame_stats_state_changes(const g4f_gfx_frame_stats* stats) {
+    if (!stats) return 0;
+    int total = 0;
+    for (int i = 0; i < G4F_GFX_STATE_COUNT; i++) total += stats->stateChanges[i];
+    return total;
+}
+
+int g4f_gfx_frame_stats_redundant_avoided(const g4f_gfx_frame_stats* stats) {
+    if (!stats) return 0;
+    int total = 0;
+    for (int i = 0; i < G4F_GFX_STATE_COUNT; i++) total += stats->redundantAvoided[i];
+    return total;
+}
+
+uint64_t g4f_gfx_frame_stats_upload_bytes(const g4f_gfx_frame_stats* stats) {
+    if (!stats) return 0;
+    return stats->constantBytes + stats->bufferBytes + stats->textureBytes;
+}
+
+void g4f_gfx_frame_stats_add(g4f_gfx_frame_stats* sum, const g4f_gfx_frame_stats* frame) {
+    if (!sum || !frame) return;
+    sum->frameIndex = frame->frameIndex;
+    sum->drawCalls += frame->drawCalls;
+    sum->triangles += frame->triangles;
+    for (int i = 0; i < G4F_GFX_STATE_COUNT; i++) {
+        sum->stateChanges[i] += frame->stateChanges[i];
+        sum->redundantAvoided[i] += frame->redundantAvoided[i];
+    }
+    sum->constantBytes += frame->constantBytes;
+    sum->bufferBytes += frame->bufferBytes;
+    sum->textureBytes += frame->textureBytes;
+    sum->resourcesCreated += frame->resourcesCreated;
+}
+
+g4f_gfx_frame_budget g4f_gfx_frame_budget_default(void) {
+    g4f_gfx_frame_budget budget{};
+    budget.maxDrawCalls = -1;
+    budget.maxTriangles = -1;
+    budget.maxStateChanges = -1;
+    budget.maxUploadBytes = -1;
+    budget.maxResourcesCreated = -1;
+    return budget;
+}
+
+int g4f_gfx_frame_stats_check(const g4f_gfx_frame_stats* stats, const g4f_gfx_frame_budget* budget, char* msg, int msgCap) {
+    if (msg && msgCap > 0) msg[0] = '\0';
+    if (!stats || !budget) return 1;
+    MsgWriter w{msg, msgCap, 0};
+    int ok = 1;
+
+    if (budget->maxDrawCalls >= 0 && stats->drawCalls > budget->maxDrawCalls) {
+        appendf(&w, "drawCalls %d > %d", stats->drawCalls, budget->maxDrawCalls);
+        ok = 0;
+    }
+    if (budget->maxTriangles >= 0 && stats->triangles > (uint64_t)budget->maxTriangles) {
+        appendf(&w, "triangles %llu > %lld", (unsigned long long)stats->triangles, (long long)budget->maxTriangles);
+        ok = 0;
+    }
+    const int changes = g4f_gfx_frame_stats_state_changes(stats);
+    if (budget->maxStateChanges >= 0 && changes > budget->maxStateChanges) {
+        appendf(&w, "stateChanges %d > %d", changes, budget->maxStateChanges);
+        ok = 0;
+    }
+    const uint64_t uploads = g4f_gfx_frame_stats_upload_bytes(stats);
+    if (budget->maxUploadBytes >= 0 && uploads > (uint64_t)budget->maxUploadBytes) {
+        appendf(&w, "uploadBytes %llu > %lld", (unsigned long long)uploads, (long long)budget->maxUploadBytes);
+        ok = 0;
+    }
+    if (budget->maxResourcesCreated >= 0 && stats->resourcesCreated > budget->maxResourcesCreated) {
+        appendf(&w, "resourcesCreated %d > %d", stats->resourcesCreated, budget->maxResourcesCreated);
+        ok = 0;
+    }
+    return ok;
+}
@@ -0,0 +1,223 @@
+#include "../include/g4f/g4f_gpu_timings.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace {
+
+enum {
+    kSlotFree = 0,
+    kSlotRecording = 1,
+    kSlotPending = 2,
+};
+
+constexpr int kMaxStack = 64;
+
+struct ScopeRecord {
+    char name[G4F_GPU_TIMER_NAME_MAX];
+    int depth;
+    int parent;
+    int beginMark;
+    int endMark;
+};
+
+struct Slot {
+    int state = kSlotFree;
+    uint64_t frameIndex = 0;
+    int markCount = 0;
+    int scopeCount = 0;
+    int droppedScopes = 0;
+    ScopeRecord scopes[G4F_GPU_TIMER_MAX_SCOPES];
+};
+
+} // namespace
+
+struct g4f_gpu_timer {
+    g4f_gpu_timer_backend backend{};
+    int source = G4F_GPU_TIMINGS_CPU;
+    Slot slots[G4F_GPU_TIMER_RING];
+    uint64_t frameCounter = 0;
+    int recording = -1; // slot being recorded this frame, -1 when skipped
+    int stack[kMaxStack];
+    int stackDepth = 0;
+    int skippedFrames = 0;
+    int invalidFrames = 0;
+    g4f_gpu_timings results{};
+
+    // CPU clock backend storage.
+    uint64_t cpuTicks[G4F_GPU_TIMER_RING][G4F_GPU_TIMER_MAX_MARKS];
+};
+
+namespace {
+
+static uint64_t cpuNowNs() {
+    using clock = std::chrono::steady_clock;
+    return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now().time_since_epoch()).count();
+}
+
+static void cpuMark(void* user, int slot, int mark) {
+    static_cast<g4f_gpu_timer*>(user)->cpuTicks[slot][mark] = cpuNowNs();
+}
+
+static int cpuResolve(void* user, int slot, int markCount, uint64_t* ticks, uint64_t* ticksPerSecond) {
+    std::memcpy(ticks, static_cast<g4f_gpu_timer*>(user)->cpuTicks[slot], sizeof(uint64_t) * (size_t)markCount);
+    *ticksPerSecond = 1000000000ull;
+    return 1;
+}
+
+static int addMark(g4f_gpu_timer* timer) {
+    Slot& slot = timer->slots[timer->recording];
+    const int mark = slot.markCount++;
+    timer->backend.mark(timer->backend.user, timer->recording, mark);
+    return mark;
+}
+
+static float ticksToMs(uint64_t begin, uint64_t end, uint64_t ticksPerSecond) {
+    if (end <= begin || ticksPerSecond == 0) return 0.0f;
+    return (float)((double)(end - begin) * 1000.0 / (double)ticksPerSecond);
+}
+
+static void publish(g4f_gpu_timer* timer, const Slot& slot, const uint64_t* ticks, uint64_t ticksPerSecond) {
+    g4f_gpu_timings& out = timer->results;
+    out.source = timer->source;
+    out.frameIndex = slot.frameIndex;
+    out.frameMs = ticksToMs(ticks[0], ticks[slot.markCount - 1], ticksPerSecond);
+    out.scopeCount = slot.scopeCount;
+    out.droppedScopes = slot.droppedScopes;
+    out.skippedFrames = timer->skippedFrames;
+    out.invalidFrames = timer->invalidFrames;
+    for (int i = 0; i < slot.scopeCount; i++) {
+        const ScopeRecord& rec = slot.scopes[i];
+        g4f_gpu_timing_scope& scope = out.scopes[i];
+        std::memcpy(scope.name, rec.name, sizeof(scope.name));
+        scope.depth = rec.depth;
+        scope.parent = rec.parent;
+        scope.ms = ticksToMs(ticks[rec.beginMark], ticks[rec.endMark], ticksPerSecond);
+    }
+}
+
+// Resolves pending slots oldest first; GPUs finish frames in order, so stop at the first one in flight.
+static void pollPending(g4f_gpu_timer* timer) {
+    for (;;) {
+        int oldest = -1;
+        for (int i = 0; i < G4F_GPU_TIMER_RING; i++) {
+            const Slot& s = timer->slots[i];
+            if (s.state != kSlotPending) continue;
+            if (oldest < 0 || s.frameIndex < timer->slots[oldest].frameIndex) oldest = i;
+        }
+        if (oldest < 0) return;
+
+        Slot& slot = timer->slots[oldest];
+        uint64_t ticks[G4F_GPU_TIMER_MAX_MARKS];
+        uint64_t ticksPerSecond = 0;
+        const int r = timer->backend.resolve(timer->backend.user, oldest, slot.markCount, ticks, &ticksPerSecond);
+        if (r == 0) return;
+        if (r > 0) publish(timer, slot, ticks, ticksPerSecond);
+        else timer->results.invalidFrames = ++timer->invalidFrames;
+        slot.state = kSlotFree;
+    }
+}
+
+} // namespace
+
+g4f_gpu_timer* g4f_gpu_timer_create(const g4f_gpu_timer_backend* backend, int source) {
+    auto* timer = new g4f_gpu_timer();
+    if (backend && backend->mark && backend->resolve) {
+        timer->backend = *backend;
+        timer->source = source;
+    } else {
+        timer->backend.user = timer;
+        timer->backend.mark = cpuMark;
+        timer->backend.resolve = cpuResolve;
+        timer->source = G4F_GPU_TIMINGS_CPU;
+    }
+    return timer;
+}
+
+void g4f_gpu_timer_destroy(g4f_gpu_timer* timer) {
+    delete timer;
+}
+
+void g4f_gpu_timer_frame_begin(g4f_gpu_timer* timer) {
+    if (!timer) return;
+    if (timer->recording >= 0) g4f_gpu_timer_frame_end(timer); // unbalanced frame: close it
+
+    pollPending(timer);
+    const int index = (int)(timer->frameCounter % G4F_GPU_TIMER_RING);
+    Slot& slot = timer->slots[index];
+    timer->stackDepth = 0;
+    if (slot.state != kSlotFree) {
+        // Still in flight: skip measuring rather than wait for the GPU.
+        timer->recording = -1;
+        timer->skippedFrames++;
+        timer->results.skippedFrames = timer->skippedFrames;
+        timer->frameCounter++;
+        return;
+    }
+
+    slot.state = kSlotRecording;
+    slot.frameIndex = timer->frameCounter++;
+    slot.markCount = 0;
+    slot.scopeCount = 0;
+    slot.droppedScopes = 0;
+    timer->recording = index;
+    if (timer->backend.frame_begin) timer->backend.frame_begin(timer->backend.user, index);
+    addMark(timer);
+}
+
+void g4f_gpu_timer_scope_begin(g4f_gpu_timer* timer, const char* name) {
+    if (!timer || timer->recording < 0) return;
+    Slot& slot = timer->slots[timer->recording];
+    int scopeIndex = -1;
+    if (slot.scopeCount < G4F_GPU_TIMER_MAX_SCOPES && timer->stackDepth < kMaxStack) {
+        scopeIndex = slot.scopeCount++;
+        ScopeRecord& rec = slot.scopes[scopeIndex];
+        std::memset(rec.name, 0, sizeof(rec.name));
+        if (name) std::strncpy(rec.name, name, sizeof(rec.name) - 1);
+        // Parent: innermost recorded scope on the stack.
+        rec.parent = -1;
+        rec.depth = 0;
+        for (int i = timer->stackDepth - 1; i >= 0; i--) {
+            if (timer->stack[i] >= 0) {
+                rec.parent = timer->stack[i];
+                rec.depth = slot.scopes[rec.parent].depth + 1;
+                break;
+            }
+        }
+        rec.beginMark = addMark(timer);
+        rec.endMark = -1;
+    } else {
+        slot.droppedScopes++;
+    }
+    if (timer->stackDepth < kMaxStack) timer->stack[timer->stackDepth++] = scopeIndex;
+}
+
+void g4f_gpu_timer_scope_end(g4f_gpu_timer* timer) {
+    if (!timer || timer->recording < 0 || timer->stackDepth <= 0) return;
+    const int scopeIndex = timer->stack[--timer->stackDepth];
+    if (scopeIndex < 0) return;
+    timer->slots[timer->recording].scopes[scopeIndex].endMark = addMark(timer);
+}
+
+void g4f_gpu_timer_frame_end(g4f_gpu_timer* timer) {
+    if (!timer || timer->recording < 0) return;
+    while (timer->stackDepth > 0) g4f_gpu_timer_scope_end(timer);
+    const int index = timer->recording;
+    addMark(timer);
+    if (timer->backend.frame_end) timer->backend.frame_end(timer->backend.user, index);
+    timer->slots[index].state = kSlotPending;
+    timer->recording = -1;
+    pollPending(timer); // the CPU clock (and an idle GPU) resolve right away
+}
+
+const g4f_gpu_timings* g4f_gpu_timer_results(const g4f_gpu_timer* timer) {
+    return timer ? &timer->results : nullptr;
+}
+
+float g4f_gpu_timings_find_ms(const g4f_gpu_timings* timings, const char* name) {
+    if (!timings || !name) return -1.0f;
+    for (int i = 0; i < timings->scopeCount; i++) {
+        if (std::strncmp(timings->scopes[i].name, name, G4F_GPU_TIMER_NAME_MAX - 1) == 0) return timings->scopes[i].ms;
+    }
+    return -1.0f;
+}
@@ -0,0 +1,852 @@
+#include "../include/g4f/g4f_image.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_file_map_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxDimension = 32768;
+
+static uint32_t readBe32(const uint8_t* p) { return (uint32_t)p[0] << 24 | (uint32_t)p[1] << 16 | (uint32_t)p[2] << 8 | (uint32_t)p[3]; }
+static uint32_t readLe16(const uint8_t* p) { return (uint32_t)p[0] | (uint32_t)p[1] << 8; }
+
+// ---- inflate (RFC 1950/1951) ----
+
+// Huffman decoding in the style of most fast inflaters: a direct table for codes up to
+// kFastBits long, canonical-code ranges for the rare longer ones.
+constexpr int kFastBits = 10;
+constexpr int kMaxSymbols = 288;
+
+struct Huffman {
+    uint16_t fast[1 << kFastBits]; // (length << 9) | symbol; 0 = code longer than kFastBits
+    uint16_t firstCode[16];
+    uint16_t firstSymbol[16];
+    uint32_t maxCode[17];          // exclusive, left-aligned to 16 bits
+    uint8_t size[kMaxSymbols];
+    uint16_t value[kMaxSymbols];
+};
+
+static int bitReverse(int v, int bits) {
+    v = ((v & 0xAAAA) >> 1) | ((v & 0x5555) << 1);
+    v = ((v & 0xCCCC) >> 2) | ((v & 0x3333) << 2);
+    v = ((v & 0xF0F0) >> 4) | ((v & 0x0F0F) << 4);
+    v = ((v & 0xFF00) >> 8) | ((v & 0x00FF) << 8);
+    return v >> (16 - bits);
+}
+
+static bool buildHuffman(Huffman& h, const uint8_t* lengths, int count) {
+    int sizes[17] = {};
+    std::memset(h.fast, 0, sizeof(h.fast));
+    std::memset(h.size, 0, sizeof(h.size));
+    for (int i = 0; i < count; i++) sizes[lengths[i]]++;
+    sizes[0] = 0;
+    for (int i = 1; i < 16; i++) {
+        if (sizes[i] > (1 << i)) return false;
+    }
+    int nextCode[16] = {};
+    int code = 0, k = 0;
+    for (int i = 1; i < 16; i++) {
+        nextCode[i] = code;
+        h.firstCode[i] = (uint16_t)code;
+        h.firstSymbol[i] = (uint16_t)k;
+        code += sizes[i];
+        if (sizes[i] && code - 1 >= (1 << i)) return false; // over-subscribed
+        h.maxCode[i] = (uint32_t)code << (16 - i);
+        code <<= 1;
+        k += sizes[i];
+    }
+    h.maxCode[16] = 0x10000;
+    for (int i = 0; i < count; i++) {
+        const int s = lengths[i];
+        if (!s) continue;
+        const int c = nextCode[s] - h.firstCode[s] + h.firstSymbol[s];
+        h.size[c] = (uint8_t)s;
+        h.value[c] = (uint16_t)i;
+        if (s <= kFastBits) {
+            for (int j = bitReverse(nextCode[s], s); j < (1 << kFastBits); j += 1 << s) h.fast[j] = (uint16_t)(s << 9 | i);
+        }
+        nextCode[s]++;
+    }
+    return true;
+}
+
+struct Inflater {
+    const uint8_t* in;
+    const uint8_t* end;
+    uint64_t bits = 0;
+    int count = 0;
+    size_t overrun = 0; // zero bytes fed past the end of the input
+    uint8_t* out;
+    size_t pos = 0;
+    size_t cap;
+
+    void refill() {
+        if (end - in >= 8) {
+            // Little-endian load of the next 8 bytes; only whole bytes that fit are consumed.
+            uint64_t v;
+            std::memcpy(&v, in, 8);
+            bits |= v << count;
+            in += (63 - count) >> 3;
+            count |= 56;
+            return;
+        }
+        while (count <= 56) {
+            uint64_t byte = 0;
+            if (in < end) byte = *in++;
+            else overrun++;
+            bits |= byte << count;
+            count += 8;
+        }
+    }
+
+    uint32_t take(int n) {
+        if (count < n) refill();
+        const uint32_t v = (uint32_t)(bits & ((1ull << n) - 1));
+        bits >>= n;
+        count -= n;
+        return v;
+    }
+
+    int decode(const Huffman& h) {
+        if (count < 16) refill();
+        const uint16_t f = h.fast[bits & ((1u << kFastBits) - 1)];
+        if (f) {
+            const int s = f >> 9;
+            bits >>= s;
+            count -= s;
+            return f & 511;
+        }
+        const int k = bitReverse((int)(bits & 0xFFFF), 16);
+        int s = kFastBits + 1;
+        while (k >= (int)h.maxCode[s]) s++;
+        if (s >= 16) return -1;
+        const int b = (k >> (16 - s)) - h.firstCode[s] + h.firstSymbol[s];
+        if (b >= kMaxSymbols || h.size[b] != s) return -1;
+        bits >>= s;
+        count -= s;
+        return h.value[b];
+    }
+
+    // Every zero byte fed past the end must still be unconsumed in the bit buffer.
+    bool truncated() const { return overrun * 8 > (size_t)count; }
+};
+
+static const uint16_t kLengthBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+static const uint8_t kLengthExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+static const uint16_t kDistBase[30] = {1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769,
+                                       1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577};
+static const uint8_t kDistExtra[30] = {0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13};
+static const uint8_t kCodeLengthOrder[19] = {16, 17, 18, 0, 8, 7, 9, 6, 10, 5, 11, 4, 12, 3, 13, 2, 14, 1, 15};
+
+struct FixedTables {
+    Huffman lit, dist;
+    FixedTables() {
+        uint8_t lengths[kMaxSymbols];
+        for (int i = 0; i < kMaxSymbols; i++) lengths[i] = i < 144 ? 8 : (i < 256 ? 9 : (i < 280 ? 7 : 8));
+        buildHuffman(lit, lengths, kMaxSymbols);
+        std::memset(lengths, 5, 32);
+        buildHuffman(dist, lengths, 32);
+    }
+};
+
+static const FixedTables& fixedTables() {
+    static const FixedTables tables;
+    return tables;
+}
+
+static bool inflateBlock(Inflater& z, const Huffman& lit, const Huffman& dist) {
+    for (;;) {
+        int sym = z.decode(lit);
+        if (sym < 0) return false;
+        if (sym < 256) {
+            if (z.pos >= z.cap) return false;
+            z.out[z.pos++] = (uint8_t)sym;
+            continue;
+        }
+        if (sym == 256) return true;
+        sym -= 257;
+        if (sym >= 29) return false;
+        const size_t length = kLengthBase[sym] + z.take(kLengthExtra[sym]);
+        const int d = z.decode(dist);
+        if (d < 0 || d >= 30) return false;
+        const size_t distance = kDistBase[d] + z.take(kDistExtra[d]);
+        if (distance > z.pos || length > z.cap - z.pos) return false;
+
+        uint8_t* dst = z.out + z.pos;
+        const uint8_t* src = dst - distance;
+        if (distance >= 8 && z.cap - z.pos >= length + 8) {
+            // Non-overlapping 8-byte steps; may write up to 7 bytes past the match (inside cap).
+            for (size_t i = 0; i < length; i += 8) std::memcpy(dst + i, src + i, 8);
+        } else if (distance == 1) {
+            std::memset(dst, *src, length);
+        } else {
+            for (size_t i = 0; i < length; i++) dst[i] = src[i];
+        }
+        z.pos += length;
+        if (z.truncated()) return false;
+    }
+}
+
+static bool inflateDynamicTables(Inflater& z, Huffman& lit, Huffman& dist) {
+    const int litCount = (int)z.take(5) + 257;
+    const int distCount = (int)z.take(5) + 1;
+    const int codeLengthCount = (int)z.take(4) + 4;
+    if (litCount > 286 || distCount > 30) return false;
+    uint8_t codeLengths[19] = {};
+    for (int i = 0; i < codeLengthCount; i++) codeLengths[kCodeLengthOrder[i]] = (uint8_t)z.take(3);
+    Huffman lengthCodes;
+    if (!buildHuffman(lengthCodes, codeLengths, 19)) return false;
+
+    uint8_t lengths[286 + 32] = {};
+    const int total = litCount + distCount;
+    int n = 0;
+    while (n < total) {
+        const int sym = z.decode(lengthCodes);
+        if (sym < 0 || sym > 18) return false;
+        if (sym < 16) {
+            lengths[n++] = (uint8_t)sym;
+            continue;
+        }
+        int repeat = 0;
+        uint8_t fill = 0;
+        if (sym == 16) {
+            if (n == 0) return false;
+            repeat = 3 + (int)z.take(2);
+            fill = lengths[n - 1];
+        } else if (sym == 17) {
+            repeat = 3 + (int)z.take(3);
+        } else {
+            repeat = 11 + (int)z.take(7);
+        }
+        if (n + repeat > total) return false;
+        std::memset(lengths + n, fill, (size_t)repeat);
+        n += repeat;
+    }
+    if (lengths[256] == 0) return false;
+    return buildHuffman(lit, lengths, litCount) && buildHuffman(dist, lengths + litCount, distCount) && !z.truncated();
+}
+
+// zlib stream -> exactly `cap` bytes.
+static bool zlibInflate(const uint8_t* data, size_t size, uint8_t* out, size_t cap) {
+    if (size < 2) return false;
+    const int cmf = data[0], flg = data[1];
+    if ((cmf & 15) != 8 || (cmf >> 4) > 7 || (cmf * 256 + flg) % 31 != 0 || (flg & 0x20)) return false;
+
+    Inflater z{};
+    z.in = data + 2;
+    z.end = data + size;
+    z.out = out;
+    z.cap = cap;
+    Huffman lit, dist;
+    bool final = false;
+    while (!final) {
+        final = z.take(1) != 0;
+        const uint32_t type = z.take(2);
+        if (type == 0) {
+            z.take(z.count & 7); // to the byte boundary
+            const uint32_t len = z.take(16);
+            const uint32_t nlen = z.take(16);
+            if ((len ^ 0xFFFF) != nlen || len > z.cap - z.pos) return false;
+            uint32_t left = len;
+            while (left > 0 && z.count >= 8) {
+                z.out[z.pos++] = (uint8_t)z.take(8);
+                left--;
+            }
+            z.bits &= (1ull << z.count) - 1; // drop look-ahead bits; the copy moves the input pointer
+            if (z.truncated() || (size_t)(z.end - z.in) < left) return false;
+            std::memcpy(z.out + z.pos, z.in, left);
+            z.in += left;
+            z.pos += left;
+        } else if (type == 1) {
+            if (!inflateBlock(z, fixedTables().lit, fixedTables().dist)) return false;
+        } else if (type == 2) {
+            if (!inflateDynamicTables(z, lit, dist) || !inflateBlock(z, lit, dist)) return false;
+        } else {
+            return false;
+        }
+        if (z.truncated()) return false;
+    }
+    return z.pos == cap;
+}
+
+// ---- PNG ----
+
+struct PngHeader {
+    int width = 0, height = 0;
+    int depth = 0, colorType = 0, interlace = 0;
+    int channels = 0;
+};
+
+struct PngImage {
+    PngHeader h;
+    uint8_t palette[256][4] = {};
+    int paletteCount = 0;
+    bool hasKey = false;
+    uint16_t key[3] = {}; // tRNS color key (gray uses key[0])
+    std::vector<const uint8_t*> idat;
+    std::vector<uint32_t> idatSize;
+};
+
+static const uint8_t kPngSignature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+static bool pngParseHeader(const uint8_t* p, size_t size, PngHeader& h, const char** reason) {
+    if (size < 33 || readBe32(p + 8) != 13 || std::memcmp(p + 12, "IHDR", 4) != 0) { *reason = "png: missing IHDR"; return false; }
+    const uint32_t w = readBe32(p + 16), hgt = readBe32(p + 20);
+    h.depth = p[24];
+    h.colorType = p[25];
+    h.interlace = p[28];
+    if (w == 0 || hgt == 0 || w > (uint32_t)kMaxDimension || hgt > (uint32_t)kMaxDimension) { *reason = "png: unsupported size"; return false; }
+    h.width = (int)w;
+    h.height = (int)hgt;
+    const int d = h.depth;
+    switch (h.colorType) {
+    case 0: h.channels = 1; if (d != 1 && d != 2 && d != 4 && d != 8 && d != 16) h.channels = 0; break;
+    case 2: h.channels = 3; if (d != 8 && d != 16) h.channels = 0; break;
+    case 3: h.channels = 1; if (d != 1 && d != 2 && d != 4 && d != 8) h.channels = 0; break;
+    case 4: h.channels = 2; if (d != 8 && d != 16) h.channels = 0; break;
+    case 6: h.channels = 4; if (d != 8 && d != 16) h.channels = 0; break;
+    default: h.channels = 0; break;
+    }
+    if (!h.channels || p[26] != 0 || p[27] != 0 || h.interlace > 1) { *reason = "png: unsupported color type, depth or method"; return false; }
+    return true;
+}
+
+static bool pngParse(const uint8_t* p, size_t size, PngImage& img, const char** reason) {
+    if (!pngParseHeader(p, size, img.h, reason)) return false;
+    size_t at = 8;
+    while (true) {
+        if (size - at < 12) { *reason = "png: truncated chunk"; return false; }
+        const uint32_t len = readBe32(p + at);
+        const uint8_t* type = p + at + 4;
+        const uint8_t* body = p + at + 8;
+        if (len > size - at - 12) { *reason = "png: truncated chunk"; return false; }
+        if (std::memcmp(type, "IEND", 4) == 0) break;
+        if (std::memcmp(type, "IDAT", 4) == 0) {
+            img.idat.push_back(body);
+            img.idatSize.push_back(len);
+        } else if (std::memcmp(type, "PLTE", 4) == 0) {
+            if (len % 3 != 0 || len / 3 > 256) { *reason = "png: invalid PLTE"; return false; }
+            img.paletteCount = (int)(len / 3);
+            for (int i = 0; i < img.paletteCount; i++) {
+                img.palette[i][0] = body[i * 3];
+                img.palette[i][1] = body[i * 3 + 1];
+                img.palette[i][2] = body[i * 3 + 2];
+                img.palette[i][3] = 255;
+            }
+        } else if (std::memcmp(type, "tRNS", 4) == 0) {
+            if (img.h.colorType == 3) {
+                if ((int)len > img.paletteCount) { *reason = "png: invalid tRNS"; return false; }
+                for (uint32_t i = 0; i < len; i++) img.palette[i][3] = body[i];
+            } else if (img.h.colorType == 0 && len == 2) {
+                img.hasKey = true;
+                img.key[0] = (uint16_t)(body[0] << 8 | body[1]);
+            } else if (img.h.colorType == 2 && len == 6) {
+                img.hasKey = true;
+                for (int c = 0; c < 3; c++) img.key[c] = (uint16_t)(body[c * 2] << 8 | body[c * 2 + 1]);
+            }
+        } else if (!(type[0] & 0x20) && std::memcmp(type, "IHDR", 4) != 0) {
+            *reason = "png: unknown critical chunk";
+            return false;
+        }
+        at += 12 + (size_t)len;
+    }
+    if (img.idat.empty()) { *reason = "png: no IDAT"; return false; }
+    if (img.h.colorType == 3 && img.paletteCount == 0) { *reason = "png: missing PLTE"; return false; }
+    return true;
+}
+
+static size_t pngRowBytes(const PngHeader& h, int width) { return ((size_t)width * (size_t)(h.channels * h.depth) + 7) / 8; }
+
+static uint8_t paeth(int a, int b, int c) {
+    const int p = a + b - c;
+    const int pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+    return (uint8_t)(pa <= pb && pa <= pc ? a : (pb <= pc ? b : c));
+}
+
+#if G4F_SIMD_SSE2
+// Sub/Avg/Paeth carry a dependency from pixel to pixel, so 3- and 4-byte pixels are processed one
+// pixel per SSE2 register step (the libpng approach) instead of byte by byte.
+static __m128i loadPixel(const uint8_t* p, int bpp) {
+    uint32_t v = 0;
+    std::memcpy(&v, p, (size_t)bpp);
+    return _mm_cvtsi32_si128((int)v);
+}
+
+static void storePixel(uint8_t* p, __m128i v, int bpp) {
+    const uint32_t bits = (uint32_t)_mm_cvtsi128_si32(v);
+    std::memcpy(p, &bits, (size_t)bpp);
+}
+
+static void unfilterSubSse2(uint8_t* row, size_t n, int bpp) {
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i + (size_t)bpp <= n; i += (size_t)bpp) {
+        a = _mm_add_epi8(a, loadPixel(row + i, bpp));
+        storePixel(row + i, a, bpp);
+    }
+}
+
+static void unfilterAvgSse2(uint8_t* row, const uint8_t* prev, size_t n, int bpp) {
+    const __m128i one = _mm_set1_epi8(1);
+    __m128i a = _mm_setzero_si128();
+    for (size_t i = 0; i + (size_t)bpp <= n; i += (size_t)bpp) {
+        const __m128i b = loadPixel(prev + i, bpp);
+        // _mm_avg_epu8 rounds up; PNG wants floor((a + b) / 2).
+        const __m128i avg = _mm_sub_epi8(_mm_avg_epu8(a, b), _mm_and_si128(_mm_xor_si128(a, b), one));
+        a = _mm_add_epi8(loadPixel(row + i, bpp), avg);
+        storePixel(row + i, a, bpp);
+    }
+}
+
+static __m128i abs16(__m128i v) { return _mm_max_epi16(v, _mm_sub_epi16(_mm_setzero_si128(), v)); }
+
+static void unfilterPaethSse2(uint8_t* row, const uint8_t* prev, size_t n, int bpp) {
+    const __m128i zero = _mm_setzero_si128();
+    __m128i a = zero, c = zero;
+    for (size_t i = 0; i + (size_t)bpp <= n; i += (size_t)bpp) {
+        const __m128i b = _mm_unpacklo_epi8(loadPixel(prev + i, bpp), zero);
+        const __m128i pa = abs16(_mm_sub_epi16(b, c));                                     // |p - a|
+        const __m128i pb = abs16(_mm_sub_epi16(a, c));                                     // |p - b|
+        const __m128i pc = abs16(_mm_sub_epi16(_mm_add_epi16(a, b), _mm_add_epi16(c, c))); // |p - c|
+        const __m128i smallest = _mm_min_epi16(pc, _mm_min_epi16(pa, pb));
+        const __m128i useA = _mm_cmpeq_epi16(pa, smallest);
+        const __m128i useB = _mm_andnot_si128(useA, _mm_cmpeq_epi16(pb, smallest));
+        const __m128i useC = _mm_andnot_si128(_mm_or_si128(useA, useB), _mm_set1_epi16(-1));
+        const __m128i pred = _mm_or_si128(_mm_or_si128(_mm_and_si128(useA, a), _mm_and_si128(useB, b)), _mm_and_si128(useC, c));
+        const __m128i d = _mm_add_epi8(loadPixel(row + i, bpp), _mm_packus_epi16(pred, pred));
+        storePixel(row + i, d, bpp);
+        c = b;
+        a = _mm_unpacklo_epi8(d, zero);
+    }
+}
+#endif
+
+// Reverses one row's filter in place. prev is the previous unfiltered row (zeros for the first).
+static bool unfilterRow(int filter, uint8_t* row, const uint8_t* prev, size_t n, int bpp) {
+    const size_t b = (size_t)bpp;
+    switch (filter) {
+    case 0: return true;
+    case 1:
+#if G4F_SIMD_SSE2
+        if (bpp == 3 || bpp == 4) { unfilterSubSse2(row, n, bpp); return true; }
+#endif
+        for (size_t i = b; i < n; i++) row[i] = (uint8_t)(row[i] + row[i - b]);
+        return true;
+    case 2:
+        for (size_t i = 0; i < n; i++) row[i] = (uint8_t)(row[i] + prev[i]); // vectorized by the compiler
+        return true;
+    case 3:
+#if G4F_SIMD_SSE2
+        if (bpp == 3 || bpp == 4) { unfilterAvgSse2(row, prev, n, bpp); return true; }
+#endif
+        for (size_t i = 0; i < b && i < n; i++) row[i] = (uint8_t)(row[i] + (prev[i] >> 1));
+        for (size_t i = b; i < n; i++) row[i] = (uint8_t)(row[i] + ((row[i - b] + prev[i]) >> 1));
+        return true;
+    case 4:
+#if G4F_SIMD_SSE2
+        if (bpp == 3 || bpp == 4) { unfilterPaethSse2(row, prev, n, bpp); return true; }
+#endif
+        for (size_t i = 0; i < b && i < n; i++) row[i] = (uint8_t)(row[i] + prev[i]);
+        for (size_t i = b; i < n; i++) row[i] = (uint8_t)(row[i] + paeth(row[i - b], prev[i], prev[i - b]));
+        return true;
+    default: return false;
+    }
+}
+
+// One unfiltered row of `width` pixels -> RGBA8.
+static void pngConvertRow(const PngImage& img, const uint8_t* src, int width, uint8_t* dst) {
+    const PngHeader& h = img.h;
+    const bool wide = h.depth == 16;
+    const int step = wide ? 2 : 1; // bytes per sample; 16-bit samples keep the high byte
+    if (h.colorType == 6) {
+        if (!wide) {
+            std::memcpy(dst, src, (size_t)width * 4);
+        } else {
+            for (int i = 0; i < width * 4; i++) dst[i] = src[i * 2];
+        }
+    } else if (h.colorType == 2) {
+        for (int x = 0; x < width; x++, src += 3 * step, dst += 4) {
+            dst[0] = src[0];
+            dst[1] = src[step];
+            dst[2] = src[2 * step];
+            dst[3] = 255;
+            if (img.hasKey) {
+                const uint16_t r = wide ? (uint16_t)(src[0] << 8 | src[1]) : src[0];
+                const uint16_t g = wide ? (uint16_t)(src[2] << 8 | src[3]) : src[1];
+                const uint16_t b = wide ? (uint16_t)(src[4] << 8 | src[5]) : src[2];
+                if (r == img.key[0] && g == img.key[1] && b == img.key[2]) dst[3] = 0;
+            }
+        }
+    } else if (h.colorType == 4) {
+        for (int x = 0; x < width; x++, src += 2 * step, dst += 4) {
+            dst[0] = dst[1] = dst[2] = src[0];
+            dst[3] = src[step];
+        }
+    } else if (h.depth >= 8) { // gray 8/16 (palette is at most 8-bit)
+        for (int x = 0; x < width; x++, src += step, dst += 4) {
+            if (h.colorType == 3) {
+                std::memcpy(dst, img.palette[src[0]], 4);
+                continue;
+            }
+            dst[0] = dst[1] = dst[2] = src[0];
+            const uint16_t v = wide ? (uint16_t)(src[0] << 8 | src[1]) : src[0];
+            dst[3] = img.hasKey && v == img.key[0] ? 0 : 255;
+        }
+    } else { // 1/2/4-bit gray or palette
+        const int d = h.depth;
+        const int mask = (1 << d) - 1;
+        const int scale = 255 / mask;
+        for (int x = 0; x < width; x++, dst += 4) {
+            const int bit = x * d;
+            const int v = (src[bit >> 3] >> (8 - d - (bit & 7))) & mask;
+            if (h.colorType == 3) {
+                std::memcpy(dst, img.palette[v], 4);
+            } else {
+                dst[0] = dst[1] = dst[2] = (uint8_t)(v * scale);
+                dst[3] = img.hasKey && v == img.key[0] ? 0 : 255;
+            }
+        }
+    }
+}
+
+static bool pngDecode(const uint8_t* p, size_t size, uint8_t* dst, size_t pitch, const char** reason) {
+    PngImage img;
+    if (!pngParse(p, size, img, reason)) return false;
+    const PngHeader& h = img.h;
+    const int bpp = std::max(1, h.channels * h.depth / 8);
+
+    static const int kStartX[7] = {0, 4, 0, 2, 0, 1, 0}, kStartY[7] = {0, 0, 4, 0, 2, 0, 1};
+    static const int kStepX[7] = {8, 8, 4, 4, 2, 2, 1}, kStepY[7] = {8, 8, 8, 4, 4, 2, 2};
+    const int passes = h.interlace ? 7 : 1;
+    int passW[7] = {}, passH[7] = {};
+    size_t raw = 0;
+    for (int i = 0; i < passes; i++) {
+        passW[i] = h.interlace ? (h.width - kStartX[i] + kStepX[i] - 1) / kStepX[i] : h.width;
+        passH[i] = h.interlace ? (h.height - kStartY[i] + kStepY[i] - 1) / kStepY[i] : h.height;
+        if (passW[i] > 0 && passH[i] > 0) raw += (size_t)passH[i] * (pngRowBytes(h, passW[i]) + 1);
+    }
+
+    // Multiple IDAT chunks form one zlib stream; the common single-chunk case is inflated in place.
+    std::vector<uint8_t> joined;
+    const uint8_t* stream = img.idat[0];
+    size_t streamSize = img.idatSize[0];
+    if (img.idat.size() > 1) {
+        for (size_t i = 0; i < img.idat.size(); i++) joined.insert(joined.end(), img.idat[i], img.idat[i] + img.idatSize[i]);
+        stream = joined.data();
+        streamSize = joined.size();
+    }
+    std::vector<uint8_t> filtered(raw);
+    if (!zlibInflate(stream, streamSize, filtered.data(), raw)) { *reason = "png: corrupt or truncated image data"; return false; }
+
+    std::vector<uint8_t> zeros(pngRowBytes(h, h.width), 0);
+    std::vector<uint8_t> rowRgba(h.interlace ? (size_t)h.width * 4 : 0);
+    uint8_t* row = filtered.data();
+    for (int pass = 0; pass < passes; pass++) {
+        if (passW[pass] <= 0 || passH[pass] <= 0) continue;
+        const size_t n = pngRowBytes(h, passW[pass]);
+        const uint8_t* prev = zeros.data();
+        for (int y = 0; y < passH[pass]; y++, row += n + 1) {
+            if (!unfilterRow(row[0], row + 1, prev, n, bpp)) { *reason = "png: invalid filter type"; return false; }
+            prev = row + 1;
+            if (!h.interlace) {
+                pngConvertRow(img, row + 1, h.width, dst + (size_t)y * pitch);
+                continue;
+            }
+            pngConvertRow(img, row + 1, passW[pass], rowRgba.data());
+            uint8_t* out = dst + (size_t)(kStartY[pass] + y * kStepY[pass]) * pitch;
+            for (int x = 0; x < passW[pass]; x++) std::memcpy(out + (size_t)(kStartX[pass] + x * kStepX[pass]) * 4, &rowRgba[(size_t)x * 4], 4);
+        }
+    }
+    return true;
+}
+
+// ---- TGA ----
+
+struct TgaHeader {
+    int width = 0, height = 0;
+    int type = 0;       // 1/2/3 raw, 9/10/11 RLE (color-mapped / true-color / gray)
+    int depth = 0;      // bits per stored pixel
+    int mapFirst = 0, mapLength = 0, mapDepth = 0;
+    int alphaBits = 0;
+    bool topDown = false, rightToLeft = false;
+    size_t mapOffset = 0, dataOffset = 0;
+};
+
+static bool tgaParseHeader(const uint8_t* p, size_t size, TgaHeader& h) {
+    if (size < 18) return false;
+    const int mapType = p[1];
+    h.type = p[2];
+    h.mapFirst = (int)readLe16(p + 3);
+    h.mapLength = (int)readLe16(p + 5);
+    h.mapDepth = p[7];
+    h.width = (int)readLe16(p + 12);
+    h.height = (int)readLe16(p + 14);
+    h.depth = p[16];
+    h.alphaBits = p[17] & 15;
+    h.rightToLeft = (p[17] & 0x10) != 0;
+    h.topDown = (p[17] & 0x20) != 0;
+    if (mapType > 1 || (p[17] & 0xC0) || h.width == 0 || h.height == 0) return false;
+    const int base = h.type & 7;
+    if ((h.type & ~8) < 1 || (h.type & ~8) > 3) return false;
+    const bool colorDepth = h.depth == 15 || h.depth == 16 || h.depth == 24 || h.depth == 32;
+    if (base == 1) {
+        const bool mapColorDepth = h.mapDepth == 15 || h.mapDepth == 16 || h.mapDepth == 24 || h.mapDepth == 32;
+        if (mapType != 1 || h.depth != 8 || !mapColorDepth || h.mapLength == 0) return false;
+    } else if (base == 2) {
+        if (!colorDepth) return false;
+    } else if (h.depth != 8 && h.depth != 16) {
+        return false;
+    }
+    h.mapOffset = 18 + (size_t)p[0];
+    h.dataOffset = h.mapOffset + (mapType ? (size_t)h.mapLength * (size_t)((h.mapDepth + 7) / 8) : 0);
+    return h.dataOffset <= size;
+}
+
+// One stored color (BGR order, 15/16-bit packed as A1R5G5B5) -> RGBA8.
+static void tgaColor(const uint8_t* p, int bits, bool gray, bool alpha16, uint8_t out[4]) {
+    if (gray) {
+        out[0] = out[1] = out[2] = p[0];
+        out[3] = bits == 16 ? p[1] : 255;
+    } else if (bits <= 16) {
+        const uint32_t v = readLe16(p);
+        out[0] = (uint8_t)(((v >> 10) & 31) * 255 / 31);
+        out[1] = (uint8_t)(((v >> 5) & 31) * 255 / 31);
+        out[2] = (uint8_t)((v & 31) * 255 / 31);
+        out[3] = alpha16 && !(v & 0x8000) ? 0 : 255;
+    } else {
+        out[0] = p[2];
+        out[1] = p[1];
+        out[2] = p[0];
+        out[3] = bits == 32 ? p[3] : 255;
+    }
+}
+
+static bool tgaDecode(const uint8_t* p, size_t size, uint8_t* dst, size_t pitch, const char** reason) {
+    TgaHeader h;
+    if (!tgaParseHeader(p, size, h)) { *reason = "tga: invalid header"; return false; }
+    const int base = h.type & 7;
+    const bool rle = (h.type & 8) != 0;
+    const size_t bytes = (size_t)(h.depth + 7) / 8;
+    const bool alpha16 = h.alphaBits > 0;
+
+    // Color map indexed by the stored byte (entries start at mapFirst).
+    uint8_t palette[256][4] = {};
+    if (base == 1) {
+        const size_t mapBytes = (size_t)(h.mapDepth + 7) / 8;
+        for (int index = 0; index < 256; index++) {
+            const int entry = index - h.mapFirst;
+            if (entry >= 0 && entry < h.mapLength) tgaColor(p + h.mapOffset + (size_t)entry * mapBytes, h.mapDepth, false, alpha16, palette[index]);
+        }
+    }
+
+    const uint8_t* in = p + h.dataOffset;
+    const uint8_t* end = p + size;
+    const size_t total = (size_t)h.width * (size_t)h.height;
+    size_t done = 0;
+    int x = 0, y = 0;
+    uint8_t color[4] = {};
+    while (done < total) {
+        size_t count = total - done;
+        bool repeat = false;
+        if (rle) {
+            if (in >= end) break;
+            repeat = (*in & 0x80) != 0;
+            count = std::min<size_t>((size_t)(*in++ & 0x7F) + 1, total - done);
+        }
+        if ((size_t)(end - in) < (repeat ? 1 : count) * bytes) break;
+        for (size_t k = 0; k < count; k++) {
+            if (!repeat || k == 0) {
+                if (base == 1) std::memcpy(color, palette[in[0]], 4);
+                else tgaColor(in, h.depth, base == 3, alpha16, color);
+                in += bytes;
+            }
+            const int dx = h.rightToLeft ? h.width - 1 - x : x;
+            const int dy = h.topDown ? y : h.height - 1 - y;
+            std::memcpy(dst + (size_t)dy * pitch + (size_t)dx * 4, color, 4);
+            if (++x == h.width) {
+                x = 0;
+                y++;
+            }
+        }
+        done += count;
+    }
+    if (done < total) { *reason = "tga: truncated image data"; return false; }
+    return true;
+}
+
+// ---- QOI ----
+
+static bool qoiParseHeader(const uint8_t* p, size_t size, int* width, int* height) {
+    if (size < 14 || std::memcmp(p, "qoif", 4) != 0) return false;
+    const uint32_t w = readBe32(p + 4), h = readBe32(p + 8);
+    if (w == 0 || h == 0 || w > (uint32_t)kMaxDimension || h > (uint32_t)kMaxDimension || (p[12] != 3 && p[12] != 4) || p[13] > 1) return false;
+    *width = (int)w;
+    *height = (int)h;
+    return true;
+}
+
+static bool qoiDecode(const uint8_t* p, size_t size, uint8_t* dst, size_t pitch, const char** reason) {
+    int width = 0, height = 0;
+    if (!qoiParseHeader(p, size, &width, &height)) { *reason = "qoi: invalid header"; return false; }
+    uint8_t index[64][4] = {};
+    uint8_t px[4] = {0, 0, 0, 255};
+    const uint8_t* in = p + 14;
+    const uint8_t* end = p + size;
+    int run = 0;
+    for (int y = 0; y < height; y++) {
+        uint8_t* out = dst + (size_t)y * pitch;
+        for (int x = 0; x < width; x++, out += 4) {
+            if (run > 0) {
+                run--;
+            } else {
+                if (in >= end) { *reason = "qoi: truncated image data"; return false; }
+                const int op = *in++;
+                if (op == 0xFE || op == 0xFF) {
+                    const size_t n = op == 0xFE ? 3 : 4;
+                    if ((size_t)(end - in) < n) { *reason = "qoi: truncated image data"; return false; }
+                    std::memcpy(px, in, n);
+                    in += n;
+                } else if ((op & 0xC0) == 0x00) {
+                    std::memcpy(px, index[op], 4);
+                } else if ((op & 0xC0) == 0x40) {
+                    px[0] = (uint8_t)(px[0] + ((op >> 4) & 3) - 2);
+                    px[1] = (uint8_t)(px[1] + ((op >> 2) & 3) - 2);
+                    px[2] = (uint8_t)(px[2] + (op & 3) - 2);
+                } else if ((op & 0xC0) == 0x80) {
+                    if (in >= end) { *reason = "qoi: truncated image data"; return false; }
+                    const int dg = (op & 0x3F) - 32;
+                    const int b2 = *in++;
+                    px[0] = (uint8_t)(px[0] + dg - 8 + ((b2 >> 4) & 15));
+                    px[1] = (uint8_t)(px[1] + dg);
+                    px[2] = (uint8_t)(px[2] + dg - 8 + (b2 & 15));
+                } else {
+                    run = op & 0x3F; // run of (op & 63) + 1, this pixel included
+                }
+                std::memcpy(index[(px[0] * 3 + px[1] * 5 + px[2] * 7 + px[3] * 11) & 63], px, 4);
+            }
+            std::memcpy(out, px, 4);
+        }
+    }
+    return true;
+}
+
+static int detectFormat(const uint8_t* p, size_t size, int* width, int* height) {
+    if (size >= 8 && std::memcmp(p, kPngSignature, 8) == 0) {
+        PngHeader h;
+        const char* reason = nullptr;
+        if (!pngParseHeader(p, size, h, &reason)) return G4F_IMAGE_UNKNOWN;
+        *width = h.width;
+        *height = h.height;
+        return G4F_IMAGE_PNG;
+    }
+    if (size >= 4 && std::memcmp(p, "qoif", 4) == 0) return qoiParseHeader(p, size, width, height) ? G4F_IMAGE_QOI : G4F_IMAGE_UNKNOWN;
+    TgaHeader h;
+    if (!tgaParseHeader(p, size, h)) return G4F_IMAGE_UNKNOWN;
+    *width = h.width;
+    *height = h.height;
+    return G4F_IMAGE_TGA;
+}
+
+struct BatchItem {
+    std::vector<uint8_t> pixels;
+    int width = 0;
+    int height = 0;
+    std::string error;
+};
+
+struct BatchJob {
+    const char* const* paths;
+    BatchItem* items;
+};
+
+static void loadBatchItems(void* user, int begin, int end, int) {
+    const BatchJob& job = *(const BatchJob*)user;
+    for (int i = begin; i < end; i++) {
+        BatchItem& item = job.items[i];
+        g4f_clear_error();
+        g4f_file_map map;
+        bool ok = job.paths[i] && g4f_file_map_open(&map, job.paths[i], "g4f_image_batch_load");
+        int format = 0;
+        ok = ok && g4f_image_info(map.data, map.size, &format, &item.width, &item.height);
+        if (ok) {
+            item.pixels.resize((size_t)item.width * (size_t)item.height * 4);
+            ok = g4f_image_decode_rgba8(map.data, map.size, item.pixels.data(), 0) != 0;
+        }
+        if (job.paths[i]) g4f_file_map_close(&map);
+        if (!ok) {
+            // g4f_last_error() is per thread, so this is the failure of this file.
+            item.error = g4f_last_error()[0] ? g4f_last_error() : "g4f_image_batch_load: invalid path";
+            item.pixels = std::vector<uint8_t>();
+            item.width = item.height = 0;
+        }
+    }
+}
+
+} // namespace
+
+struct g4f_image_batch {
+    std::vector<BatchItem> items;
+};
+
+int g4f_image_info(const void* data, size_t size, int* outFormat, int* outWidth, int* outHeight) {
+    if (outFormat) *outFormat = G4F_IMAGE_UNKNOWN;
+    if (!data || size == 0) { g4f_set_last_error("g4f_image_info: invalid args"); return 0; }
+    int width = 0, height = 0;
+    const int format = detectFormat((const uint8_t*)data, size, &width, &height);
+    if (format == G4F_IMAGE_UNKNOWN) { g4f_set_last_error("g4f_image_info: unrecognized or unsupported image"); return 0; }
+    if (outFormat) *outFormat = format;
+    if (outWidth) *outWidth = width;
+    if (outHeight) *outHeight = height;
+    return 1;
+}
+
+int g4f_image_decode_rgba8(const void* data, size_t size, void* dst, int dstPitchBytes) {
+    if (!data || !dst || size == 0) { g4f_set_last_error("g4f_image_decode_rgba8: invalid args"); return 0; }
+    const uint8_t* p = (const uint8_t*)data;
+    int width = 0, height = 0;
+    const int format = detectFormat(p, size, &width, &height);
+    if (format == G4F_IMAGE_UNKNOWN) { g4f_set_last_error("g4f_image_decode_rgba8: unrecognized or unsupported image"); return 0; }
+    if (dstPitchBytes <= 0) dstPitchBytes = width * 4;
+    if (dstPitchBytes < width * 4) { g4f_set_last_error("g4f_image_decode_rgba8: pitch too small"); return 0; }
+
+    const char* reason = "";
+    bool ok = false;
+    if (format == G4F_IMAGE_PNG) ok = pngDecode(p, size, (uint8_t*)dst, (size_t)dstPitchBytes, &reason);
+    else if (format == G4F_IMAGE_TGA) ok = tgaDecode(p, size, (uint8_t*)dst, (size_t)dstPitchBytes, &reason);
+    else ok = qoiDecode(p, size, (uint8_t*)dst, (size_t)dstPitchBytes, &reason);
+    if (!ok) g4f_set_last_errorf("g4f_image_decode_rgba8: %s", reason);
+    return ok ? 1 : 0;
+}
+
+g4f_image_batch* g4f_image_batch_load(const char* const* pathsUtf8, int count, g4f_jobs* jobs) {
+    if ((!pathsUtf8 && count > 0) || count < 0) { g4f_set_last_error("g4f_image_batch_load: invalid args"); return nullptr; }
+    auto* batch = new g4f_image_batch();
+    batch->items.resize((size_t)count);
+    BatchJob job{pathsUtf8, batch->items.data()};
+    g4f_jobs_parallel_for(jobs, count, 1, loadBatchItems, &job);
+    return batch;
+}
+
+void g4f_image_batch_destroy(g4f_image_batch* batch) { delete batch; }
+
+int g4f_image_batch_count(const g4f_image_batch* batch) { return batch ? (int)batch->items.size() : 0; }
+
+const uint8_t* g4f_image_batch_pixels(const g4f_image_batch* batch, int index, int* outWidth, int* outHeight) {
+    if (outWidth) *outWidth = 0;
+    if (outHeight) *outHeight = 0;
+    if (!batch || index < 0 || index >= (int)batch->items.size() || batch->items[(size_t)index].pixels.empty()) return nullptr;
+    const BatchItem& item = batch->items[(size_t)index];
+    if (outWidth) *outWidth = item.width;
+    if (outHeight) *outHeight = item.height;
+    return item.pixels.data();
+}
+
+const char* g4f_image_batch_error(const g4f_image_batch* batch, int index) {
+    if (!batch || index < 0 || index >= (int)batch->items.size()) return "g4f_image_batch_error: invalid index";
+    return batch->items[(size_t)index].error.c_str();
+}
@@ -0,0 +1,136 @@
+#include "../include/g4f/g4f_jobs.h"
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+
+thread_local int t_workerIndex = -1; // >= 0 while running inside a job
+
+} // namespace
+
+struct g4f_jobs {
+    std::vector<std::thread> threads;
+    int threadCount = 1;
+
+    std::mutex submitMutex; // one parallel_for in flight at a time
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable done;
+    uint64_t generation = 0;
+    int busyWorkers = 0;
+    bool quit = false;
+
+    // Current batch (stable while busyWorkers > 0).
+    g4f_jobs_range_fn fn = nullptr;
+    void* user = nullptr;
+    int count = 0;
+    int grain = 1;
+    std::atomic<int> next{0};
+};
+
+static void jobsRunChunks(g4f_jobs* jobs, int workerIndex) {
+    int prevIndex = t_workerIndex;
+    t_workerIndex = workerIndex;
+    for (;;) {
+        int begin = jobs->next.fetch_add(jobs->grain, std::memory_order_relaxed);
+        if (begin >= jobs->count) break;
+        int end = begin + jobs->grain;
+        if (end > jobs->count) end = jobs->count;
+        jobs->fn(jobs->user, begin, end, workerIndex);
+    }
+    t_workerIndex = prevIndex;
+}
+
+static void jobsWorkerMain(g4f_jobs* jobs, int workerIndex) {
+    uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(jobs->mutex);
+            jobs->wake.wait(lock, [&] { return jobs->quit || jobs->generation != seen; });
+            if (jobs->quit) return;
+            seen = jobs->generation;
+        }
+        jobsRunChunks(jobs, workerIndex);
+        {
+            std::lock_guard<std::mutex> lock(jobs->mutex);
+            jobs->busyWorkers -= 1;
+            if (jobs->busyWorkers == 0) jobs->done.notify_one();
+        }
+    }
+}
+
+int g4f_jobs_hardware_threads(void) {
+    unsigned n = std::thread::hardware_concurrency();
+    return n > 0 ? (int)n : 1;
+}
+
+g4f_jobs* g4f_jobs_create(int threadCount) {
+    if (threadCount <= 0) threadCount = g4f_jobs_hardware_threads();
+    if (threadCount > 256) threadCount = 256;
+
+    auto* jobs = new g4f_jobs();
+    jobs->threadCount = threadCount;
+    jobs->threads.reserve((size_t)(threadCount - 1));
+    for (int i = 1; i < threadCount; i++) {
+        jobs->threads.emplace_back(jobsWorkerMain, jobs, i);
+    }
+    return jobs;
+}
+
+void g4f_jobs_destroy(g4f_jobs* jobs) {
+    if (!jobs) return;
+    {
+        std::lock_guard<std::mutex> lock(jobs->mutex);
+        jobs->quit = true;
+    }
+    jobs->wake.notify_all();
+    for (auto& t : jobs->threads) t.join();
+    delete jobs;
+}
+
+int g4f_jobs_thread_count(const g4f_jobs* jobs) {
+    return jobs ? jobs->threadCount : 1;
+}
+
+void g4f_jobs_parallel_for(g4f_jobs* jobs, int count, int grain, g4f_jobs_range_fn fn, void* user) {
+    if (!fn || count <= 0) return;
+
+    // Serial cases: no pool, single thread, or already inside a job.
+    if (!jobs || jobs->threadCount <= 1 || t_workerIndex >= 0) {
+        int worker = (t_workerIndex >= 0) ? t_workerIndex : 0;
+        fn(user, 0, count, worker);
+        return;
+    }
+
+    if (grain <= 0) {
+        // ~4 chunks per thread keeps workers balanced without much atomic traffic.
+        grain = count / (jobs->threadCount * 4);
+        if (grain < 1) grain = 1;
+    }
+    if (grain >= count) {
+        fn(user, 0, count, 0);
+        return;
+    }
+
+    std::lock_guard<std::mutex> submit(jobs->submitMutex);
+    {
+        std::lock_guard<std::mutex> lock(jobs->mutex);
+        jobs->fn = fn;
+        jobs->user = user;
+        jobs->count = count;
+        jobs->grain = grain;
+        jobs->next.store(0, std::memory_order_relaxed);
+        jobs->busyWorkers = (int)jobs->threads.size();
+        jobs->generation += 1;
+    }
+    jobs->wake.notify_all();
+
+    jobsRunChunks(jobs, 0);
+
+    std::unique_lock<std::mutex> lock(jobs->mutex);
+    jobs->done.wait(lock, [&] { return jobs->busyWorkers == 0; });
+}
@@ -0,0 +1,417 @@
+#include "../include/g4f/g4f_light_clusters.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+// A light's footprint inside one depth slice.
+struct FroxelRect {
+    uint32_t light;
+    uint8_t x0, x1, y0, y1;
+};
+
+// Tile boundary planes through the eye, as signed distance = a * offset + b * depth
+// (positive towards +x / +y). Padded to a multiple of 4 for the SIMD range search.
+struct BoundaryPlanes {
+    std::vector<float> a;
+    std::vector<float> b;
+    int count = 0; // tiles + 1
+};
+
+static void buildBoundaries(BoundaryPlanes& planes, int tiles, float tanHalf) {
+    planes.count = tiles + 1;
+    const size_t padded = (size_t)((planes.count + 3) & ~3);
+    planes.a.assign(padded, 0.0f);
+    planes.b.assign(padded, 0.0f);
+    for (int i = 0; i < planes.count; i++) {
+        const float k = (-1.0f + 2.0f * (float)i / (float)tiles) * tanHalf;
+        const float inv = 1.0f / std::sqrt(1.0f + k * k);
+        planes.a[(size_t)i] = inv;
+        planes.b[(size_t)i] = -k * inv;
+    }
+}
+
+static int laneMask(int base, int begin, int end) {
+    int mask = 0;
+    for (int j = 0; j < 4; j++) {
+        if (base + j >= begin && base + j < end) mask |= 1 << j;
+    }
+    return mask;
+}
+
+static int popcount4(int mask) {
+    static const int kBits[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+    return kBits[mask & 15];
+}
+
+static int lowestLane(int mask) {
+    return (mask & 1) ? 0 : (mask & 2) ? 1 : (mask & 4) ? 2 : 3;
+}
+
+// Tile range [*lo, *hi] touched by a slab section of a light: a cylinder of radius `rc` around
+// `offset` spanning depths [zn, zf]. Distances are linear in depth, so checking both slab faces
+// is conservative. Returns false when the section misses every tile.
+static bool tileRange(const BoundaryPlanes& planes, float offset, float rc, float zn, float zf, int* lo, int* hi) {
+    const F4 vOffset = f4Set1(offset);
+    const F4 vZn = f4Set1(zn);
+    const F4 vZf = f4Set1(zf);
+    const F4 vR = f4Set1(rc);
+    const F4 vNegR = f4Set1(-rc);
+    int passed = 0;  // boundaries 1..tiles with the whole section on their positive side
+    int reached = 0; // boundaries 0..tiles-1 the section reaches the positive side of
+    for (int i = 0; i < planes.count; i += 4) {
+        const F4 a = f4Load(&planes.a[(size_t)i]);
+        const F4 b = f4Load(&planes.b[(size_t)i]);
+        const F4 ao = a * vOffset;
+        const F4 dNear = ao + b * vZn;
+        const F4 dFar = ao + b * vZf;
+        passed += popcount4(f4MoveMask(f4Gt(f4Min(dNear, dFar), vR)) & laneMask(i, 1, planes.count));
+        reached += popcount4(f4MoveMask(f4Ge(f4Max(dNear, dFar), vNegR)) & laneMask(i, 0, planes.count - 1));
+    }
+    *lo = passed;
+    *hi = reached - 1;
+    return *lo <= *hi;
+}
+
+// Bounding sphere of a spot cone (apex, unit axis, length, half-angle cosine).
+static void spotBoundingSphere(const g4f_light& light, g4f_vec3* center, float* radius) {
+    const float cosA = std::clamp(light.spotOuterCos, -1.0f, 1.0f);
+    const float r = light.radius;
+    float dist = 0.0f;
+    if (cosA < 0.70710678f) {
+        // Wide cone: the sphere around the cap circle (or the whole point-light sphere for > 90 degrees).
+        if (cosA <= 0.0f) {
+            *center = light.position;
+            *radius = r;
+            return;
+        }
+        dist = r * cosA;
+        *radius = r * std::sqrt(1.0f - cosA * cosA);
+    } else {
+        dist = r / (2.0f * cosA);
+        *radius = dist;
+    }
+    *center = g4f_vec3{
+        light.position.x + light.direction.x * dist,
+        light.position.y + light.direction.y * dist,
+        light.position.z + light.direction.z * dist,
+    };
+}
+
+static bool descValid(const g4f_light_cluster_desc& d) {
+    return d.tilesX >= 1 && d.tilesX <= 256 && d.tilesY >= 1 && d.tilesY <= 256 && d.slices >= 1 && d.slices <= 1024 &&
+           d.nearZ > 0.0f && d.farZ > d.nearZ && d.maxLightsPerCluster >= 1;
+}
+
+} // namespace
+
+struct g4f_light_clusters {
+    g4f_light_cluster_desc desc{};
+    float tanHalfX = 1.0f;
+    float tanHalfY = 1.0f;
+    float depthSign = 1.0f;
+    float sliceScale = 1.0f;
+    int tilesPerSlice = 0;
+    int clusterCount = 0;
+    g4f_mat4 view{};
+
+    BoundaryPlanes planesX;
+    BoundaryPlanes planesY;
+    std::vector<float> sliceNear; // slices + 1 depths
+
+    // View-space bounding spheres (SoA, padded to a multiple of 4).
+    std::vector<float> lx, ly, ldepth, lradius;
+    const g4f_light* lights = nullptr;
+    int lightCount = 0;
+
+    std::vector<std::vector<FroxelRect>> sliceRects;
+    std::vector<uint32_t> counts;
+    std::vector<uint32_t> ranges;
+    std::vector<uint32_t> indices;
+    int droppedCount = 0;
+};
+
+namespace {
+
+static void applyDesc(g4f_light_clusters* c, const g4f_light_cluster_desc& d) {
+    c->desc = d;
+    c->sliceScale = (float)d.slices / std::log(d.farZ / d.nearZ);
+    c->tilesPerSlice = d.tilesX * d.tilesY;
+    c->clusterCount = c->tilesPerSlice * d.slices;
+    c->planesX.count = 0; // rebuilt by the next applyProjection
+    c->sliceNear.resize((size_t)d.slices + 1);
+    for (int s = 0; s <= d.slices; s++) {
+        c->sliceNear[(size_t)s] = d.nearZ * std::pow(d.farZ / d.nearZ, (float)s / (float)d.slices);
+    }
+    c->sliceRects.resize((size_t)d.slices);
+    c->counts.assign((size_t)c->clusterCount, 0u);
+    c->ranges.assign((size_t)c->clusterCount * 2, 0u);
+    c->indices.clear();
+    c->droppedCount = 0;
+}
+
+// Perspective projections (row vectors) have w = z_view * m[11] and ndc.x = x_view * m[0] / w.
+// Writing w = |m[11]| * depth with depth = sign(m[11]) * z_view gives ndc.x = x_view / (depth * tanHalfX).
+static bool applyProjection(g4f_light_clusters* c, const g4f_mat4& proj) {
+    const float* m = proj.m;
+    const bool perspective = m[3] == 0.0f && m[7] == 0.0f && m[11] != 0.0f && m[15] == 0.0f;
+    if (!perspective || !(m[0] > 0.0f) || !(m[5] > 0.0f)) return false;
+    const float w = std::fabs(m[11]);
+    const float tanHalfX = w / m[0];
+    const float tanHalfY = w / m[5];
+    c->depthSign = m[11] > 0.0f ? 1.0f : -1.0f;
+    if (c->planesX.count == 0 || tanHalfX != c->tanHalfX || tanHalfY != c->tanHalfY) {
+        c->tanHalfX = tanHalfX;
+        c->tanHalfY = tanHalfY;
+        buildBoundaries(c->planesX, c->desc.tilesX, tanHalfX);
+        buildBoundaries(c->planesY, c->desc.tilesY, tanHalfY);
+    }
+    return true;
+}
+
+// Phase 1: world -> view-space bounding spheres, 4 lights per iteration.
+static void transformLights(g4f_light_clusters* c, int groupBegin, int groupEnd) {
+    const float* m = c->view.m;
+    const F4 m0 = f4Set1(m[0]), m4 = f4Set1(m[4]), m8 = f4Set1(m[8]), m12 = f4Set1(m[12]);
+    const F4 m1 = f4Set1(m[1]), m5 = f4Set1(m[5]), m9 = f4Set1(m[9]), m13 = f4Set1(m[13]);
+    // Depth row pre-multiplied by the projection's sign.
+    const float s = c->depthSign;
+    const F4 m2 = f4Set1(s * m[2]), m6 = f4Set1(s * m[6]), m10 = f4Set1(s * m[10]), m14 = f4Set1(s * m[14]);
+    for (int g = groupBegin; g < groupEnd; g++) {
+        alignas(16) float wx[4] = {0, 0, 0, 0};
+        alignas(16) float wy[4] = {0, 0, 0, 0};
+        alignas(16) float wz[4] = {0, 0, 0, 0};
+        alignas(16) float wr[4] = {0, 0, 0, 0};
+        bool padded[4] = {false, false, false, false};
+        for (int j = 0; j < 4; j++) {
+            const int i = g * 4 + j;
+            if (i >= c->lightCount) {
+                padded[j] = true;
+                continue;
+            }
+            const g4f_light& light = c->lights[i];
+            g4f_vec3 center = light.position;
+            float radius = light.radius > 0.0f ? light.radius : 0.0f;
+            if (light.type == G4F_LIGHT_SPOT && radius > 0.0f) spotBoundingSphere(light, &center, &radius);
+            wx[j] = center.x;
+            wy[j] = center.y;
+            wz[j] = center.z;
+            wr[j] = radius;
+        }
+        const F4 x = f4Load(wx), y = f4Load(wy), z = f4Load(wz);
+        const size_t o = (size_t)g * 4;
+        f4Store(&c->lx[o], x * m0 + y * m4 + z * m8 + m12);
+        f4Store(&c->ly[o], x * m1 + y * m5 + z * m9 + m13);
+        f4Store(&c->ldepth[o], x * m2 + y * m6 + z * m10 + m14);
+        f4Store(&c->lradius[o], f4Load(wr));
+        for (int j = 0; j < 4; j++) {
+            if (padded[j] || c->lradius[o + (size_t)j] <= 0.0f) c->ldepth[o + (size_t)j] = -1e30f; // never overlaps
+        }
+    }
+}
+
+// Phase 2: footprints of every light in one slice + per-froxel counts.
+static void binSlice(g4f_light_clusters* c, int slice) {
+    std::vector<FroxelRect>& rects = c->sliceRects[(size_t)slice];
+    rects.clear();
+    uint32_t* counts = c->counts.data() + (size_t)slice * (size_t)c->tilesPerSlice;
+    std::fill(counts, counts + c->tilesPerSlice, 0u);
+
+    // Slightly widened so froxel lookups that round across a boundary still find the light.
+    const float zn = c->sliceNear[(size_t)slice] * 0.9999f;
+    const float zf = c->sliceNear[(size_t)slice + 1] * 1.0001f;
+    const F4 vZn = f4Set1(zn);
+    const F4 vZf = f4Set1(zf);
+    const int groups = (c->lightCount + 3) / 4;
+    for (int g = 0; g < groups; g++) {
+        const size_t o = (size_t)g * 4;
+        const F4 d = f4Load(&c->ldepth[o]);
+        const F4 r = f4Load(&c->lradius[o]);
+        int mask = f4MoveMask(f4And(f4Gt(d + r, vZn), f4Lt(d - r, vZf)));
+        while (mask) {
+            const int j = lowestLane(mask);
+            mask &= mask - 1;
+            const size_t i = o + (size_t)j;
+            const float depth = c->ldepth[i];
+            const float radius = c->lradius[i];
+            const float dz = depth - std::clamp(depth, zn, zf);
+            const float rc2 = radius * radius - dz * dz;
+            if (rc2 <= 0.0f) continue;
+            const float rc = std::sqrt(rc2) * 1.0001f + 1e-6f;
+
+            int x0, x1, y0, y1;
+            if (!tileRange(c->planesX, c->lx[i], rc, zn, zf, &x0, &x1)) continue;
+            if (!tileRange(c->planesY, c->ly[i], rc, zn, zf, &y0, &y1)) continue;
+            rects.push_back(FroxelRect{(uint32_t)i, (uint8_t)x0, (uint8_t)x1, (uint8_t)y0, (uint8_t)y1});
+            for (int ty = y0; ty <= y1; ty++) {
+                uint32_t* row = counts + (size_t)ty * (size_t)c->desc.tilesX;
+                for (int tx = x0; tx <= x1; tx++) row[tx]++;
+            }
+        }
+    }
+}
+
+// Phase 4: scatter light indices of one slice into the offsets computed in phase 3.
+static void fillSlice(g4f_light_clusters* c, int slice) {
+    const size_t firstCluster = (size_t)slice * (size_t)c->tilesPerSlice;
+    uint32_t* written = c->counts.data() + firstCluster; // reused as per-froxel cursor
+    std::fill(written, written + c->tilesPerSlice, 0u);
+    const uint32_t* ranges = c->ranges.data() + firstCluster * 2;
+    uint32_t* indices = c->indices.data();
+    for (const FroxelRect& rect : c->sliceRects[(size_t)slice]) {
+        for (int ty = rect.y0; ty <= rect.y1; ty++) {
+            for (int tx = rect.x0; tx <= rect.x1; tx++) {
+                const size_t local = (size_t)ty * (size_t)c->desc.tilesX + (size_t)tx;
+                const uint32_t n = written[local];
+                if (n >= ranges[local * 2 + 1]) continue; // over maxLightsPerCluster
+                indices[ranges[local * 2] + n] = rect.light;
+                written[local] = n + 1;
+            }
+        }
+    }
+}
+
+template <typename Fn>
+static void parallelItems(g4f_jobs* jobs, int count, int grain, Fn& fn) {
+    g4f_jobs_parallel_for(jobs, count, grain, [](void* user, int begin, int end, int) {
+        Fn& f = *(Fn*)user;
+        f(begin, end);
+    }, &fn);
+}
+
+} // namespace
+
+g4f_light_cluster_desc g4f_light_cluster_desc_default(void) {
+    g4f_light_cluster_desc d{};
+    d.tilesX = 16;
+    d.tilesY = 9;
+    d.slices = 24;
+    d.nearZ = 0.1f;
+    d.farZ = 100.0f;
+    d.maxLightsPerCluster = 128;
+    return d;
+}
+
+g4f_light_clusters* g4f_light_clusters_create(const g4f_light_cluster_desc* desc) {
+    g4f_light_cluster_desc d = desc ? *desc : g4f_light_cluster_desc_default();
+    if (!descValid(d)) {
+        g4f_set_last_error("g4f_light_clusters_create: invalid desc");
+        return nullptr;
+    }
+    auto* clusters = new g4f_light_clusters();
+    applyDesc(clusters, d);
+    return clusters;
+}
+
+void g4f_light_clusters_destroy(g4f_light_clusters* clusters) {
+    delete clusters;
+}
+
+int g4f_light_clusters_set_desc(g4f_light_clusters* clusters, const g4f_light_cluster_desc* desc) {
+    if (!clusters || !desc) {
+        g4f_set_last_error("g4f_light_clusters_set_desc: invalid args");
+        return 0;
+    }
+    if (!descValid(*desc)) {
+        g4f_set_last_error("g4f_light_clusters_set_desc: invalid desc");
+        return 0;
+    }
+    applyDesc(clusters, *desc);
+    return 1;
+}
+
+int g4f_light_clusters_build(g4f_light_clusters* clusters, const g4f_light* lights, int lightCount, const g4f_mat4* view,
+                             const g4f_mat4* proj, g4f_jobs* jobs) {
+    if (!clusters || !view || !proj || lightCount < 0 || (lightCount > 0 && !lights)) {
+        g4f_set_last_error("g4f_light_clusters_build: invalid args");
+        return 0;
+    }
+    g4f_light_clusters* c = clusters;
+    if (!applyProjection(c, *proj)) {
+        g4f_set_last_error("g4f_light_clusters_build: proj is not a perspective projection");
+        return 0;
+    }
+    c->view = *view;
+    c->lights = lights;
+    c->lightCount = lightCount;
+
+    const int groups = (lightCount + 3) / 4;
+    const size_t padded = (size_t)groups * 4;
+    c->lx.resize(padded);
+    c->ly.resize(padded);
+    c->ldepth.resize(padded);
+    c->lradius.resize(padded);
+
+    auto transform = [c](int begin, int end) { transformLights(c, begin, end); };
+    parallelItems(jobs, groups, 256, transform);
+
+    auto bin = [c](int begin, int end) {
+        for (int s = begin; s < end; s++) binSlice(c, s);
+    };
+    parallelItems(jobs, c->desc.slices, 1, bin);
+
+    // Offsets (serial: a few thousand froxels).
+    const uint32_t maxPerCluster = (uint32_t)c->desc.maxLightsPerCluster;
+    uint32_t total = 0;
+    int dropped = 0;
+    for (int i = 0; i < c->clusterCount; i++) {
+        const uint32_t n = c->counts[(size_t)i];
+        const uint32_t kept = n < maxPerCluster ? n : maxPerCluster;
+        dropped += (int)(n - kept);
+        c->ranges[(size_t)i * 2] = total;
+        c->ranges[(size_t)i * 2 + 1] = kept;
+        total += kept;
+    }
+    c->indices.resize(total);
+    c->droppedCount = dropped;
+
+    auto fill = [c](int begin, int end) {
+        for (int s = begin; s < end; s++) fillSlice(c, s);
+    };
+    parallelItems(jobs, c->desc.slices, 1, fill);
+
+    c->lights = nullptr;
+    return 1;
+}
+
+void g4f_light_clusters_get_result(const g4f_light_clusters* clusters, g4f_light_cluster_result* out) {
+    if (!out) return;
+    *out = g4f_light_cluster_result{};
+    if (!clusters) return;
+    out->ranges = clusters->ranges.data();
+    out->indices = clusters->indices.data();
+    out->clusterCount = clusters->clusterCount;
+    out->indexCount = (int)clusters->indices.size();
+    out->droppedCount = clusters->droppedCount;
+    out->tilesX = clusters->desc.tilesX;
+    out->tilesY = clusters->desc.tilesY;
+    out->slices = clusters->desc.slices;
+    out->tanHalfX = clusters->tanHalfX;
+    out->tanHalfY = clusters->tanHalfY;
+    out->depthSign = clusters->depthSign;
+    out->nearZ = clusters->desc.nearZ;
+    out->sliceScale = clusters->sliceScale;
+    out->view = clusters->view;
+}
+
+int g4f_light_clusters_froxel_index(const g4f_light_clusters* clusters, g4f_vec3 viewPos) {
+    if (!clusters) return -1;
+    const g4f_light_cluster_desc& d = clusters->desc;
+    const float depth = clusters->depthSign * viewPos.z;
+    if (!(depth >= d.nearZ && depth < d.farZ)) return -1;
+    const float u = viewPos.x / (depth * clusters->tanHalfX) * 0.5f + 0.5f;
+    const float v = viewPos.y / (depth * clusters->tanHalfY) * 0.5f + 0.5f;
+    const int tx = (int)std::floor(u * (float)d.tilesX);
+    const int ty = (int)std::floor(v * (float)d.tilesY);
+    if (tx < 0 || tx >= d.tilesX || ty < 0 || ty >= d.tilesY) return -1;
+    int slice = (int)std::floor(std::log(depth / d.nearZ) * clusters->sliceScale);
+    slice = std::clamp(slice, 0, d.slices - 1);
+    return (slice * d.tilesY + ty) * d.tilesX + tx;
+}
@@ -0,0 +1,530 @@
+#include "../include/g4f/g4f_lod.h"
+
+#include "g4f_error_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <queue>
+#include <vector>
+
+namespace {
+
+// A collapse may turn the normal of a surviving neighbour triangle by at most ~78 degrees.
+constexpr double kMinNormalCos = 0.2;
+// Open-border planes outweigh surface planes so outlines survive until little else is left.
+constexpr double kBorderWeight = 10.0;
+// A chain level must remove at least 10% of the previous level's triangles.
+constexpr double kMinLevelProgress = 0.9;
+
+static g4f_vec3 vec3Sub(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+static float vec3Dot(g4f_vec3 a, g4f_vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+struct Vec3d {
+    double x, y, z;
+};
+
+static Vec3d sub(Vec3d a, Vec3d b) { return Vec3d{a.x - b.x, a.y - b.y, a.z - b.z}; }
+static double dot(Vec3d a, Vec3d b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+static Vec3d cross(Vec3d a, Vec3d b) { return Vec3d{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+
+// Sum of w * (n.p + d)^2 over planes, as a symmetric 4x4 form, plus the total weight.
+struct Quadric {
+    double xx, xy, xz, xw, yy, yz, yw, zz, zw, ww;
+    double weight;
+};
+
+static Quadric planeQuadric(Vec3d n, double d, double w) {
+    return Quadric{w * n.x * n.x, w * n.x * n.y, w * n.x * n.z, w * n.x * d, w * n.y * n.y, w * n.y * n.z, w * n.y * d, w * n.z * n.z, w * n.z * d, w * d * d, w};
+}
+
+static void quadricAdd(Quadric& q, const Quadric& o) {
+    q.xx += o.xx; q.xy += o.xy; q.xz += o.xz; q.xw += o.xw;
+    q.yy += o.yy; q.yz += o.yz; q.yw += o.yw;
+    q.zz += o.zz; q.zw += o.zw; q.ww += o.ww;
+    q.weight += o.weight;
+}
+
+static double quadricEval(const Quadric& q, Vec3d p) {
+    const double r = q.xx * p.x * p.x + q.yy * p.y * p.y + q.zz * p.z * p.z + q.ww
+        + 2.0 * (q.xy * p.x * p.y + q.xz * p.x * p.z + q.yz * p.y * p.z + q.xw * p.x + q.yw * p.y + q.zw * p.z);
+    return r > 0.0 ? r : 0.0;
+}
+
+struct Candidate {
+    float error;
+    int from;
+    int to;
+    uint32_t fromStamp;
+    uint32_t toStamp;
+
+    bool operator>(const Candidate& o) const {
+        if (error != o.error) return error > o.error;
+        if (from != o.from) return from > o.from;
+        return to > o.to;
+    }
+};
+
+// Edge collapses over position-welded vertices ("reps"). Collapsing rep u into rep v moves every
+// corner at u to v's vertex, so no vertex data is created.
+struct Simplifier {
+    std::vector<Vec3d> pos;           // per source vertex
+    std::vector<int> rep;             // per source vertex: welded representative
+    std::vector<uint32_t> tris;       // 3 source vertex indices per triangle
+    std::vector<uint8_t> triAlive;
+    std::vector<std::vector<int>> repTris; // live (and some dead) triangles around each rep
+    std::vector<Quadric> quadric;     // per rep
+    std::vector<uint8_t> locked;      // per rep: never collapsed away
+    std::vector<uint8_t> border;      // per rep: on an open edge
+    std::vector<uint8_t> removed;     // per rep: collapsed into another rep
+    std::vector<uint32_t> stamp;      // per rep: bumped when its quadric changes
+    std::vector<uint32_t> mark;       // per rep scratch for neighbour sets
+    uint32_t markStamp = 0;
+    std::priority_queue<Candidate, std::vector<Candidate>, std::greater<Candidate>> heap;
+    int liveTris = 0;
+    long long collapses = 0;
+    long long collapsesAtRefill = -1;
+    double error = 0.0;
+
+    int cornerRep(int t, int c) const { return rep[tris[(size_t)t * 3 + (size_t)c]]; }
+
+    bool triHasRep(int t, int r) const {
+        return cornerRep(t, 0) == r || cornerRep(t, 1) == r || cornerRep(t, 2) == r;
+    }
+
+    Vec3d triNormal(int t, int moved, Vec3d movedTo) const {
+        Vec3d p[3];
+        for (int c = 0; c < 3; c++) {
+            const int r = cornerRep(t, c);
+            p[c] = r == moved ? movedTo : pos[(size_t)r];
+        }
+        return cross(sub(p[1], p[0]), sub(p[2], p[0]));
+    }
+
+    void init(const g4f_lod_mesh_desc* mesh, const std::vector<uint32_t>& indices) {
+        const int n = mesh->vertexCount;
+        const int stride = mesh->positionStride > 0 ? mesh->positionStride : 12;
+        const auto* bytes = static_cast<const unsigned char*>(mesh->positions);
+        pos.resize((size_t)n);
+        for (int i = 0; i < n; i++) {
+            float p[3];
+            std::memcpy(p, bytes + (size_t)i * (size_t)stride, sizeof(p));
+            pos[(size_t)i] = Vec3d{p[0], p[1], p[2]};
+        }
+
+        // Weld equal positions: sort, then the lowest index of each run represents it.
+        std::vector<int> order((size_t)n);
+        for (int i = 0; i < n; i++) order[(size_t)i] = i;
+        auto less = [this](int a, int b) {
+            const Vec3d& pa = pos[(size_t)a];
+            const Vec3d& pb = pos[(size_t)b];
+            if (pa.x != pb.x) return pa.x < pb.x;
+            if (pa.y != pb.y) return pa.y < pb.y;
+            if (pa.z != pb.z) return pa.z < pb.z;
+            return a < b;
+        };
+        std::sort(order.begin(), order.end(), less);
+        rep.resize((size_t)n);
+        for (int k = 0; k < n; k++) {
+            const int i = order[(size_t)k];
+            const bool same = k > 0 && pos[(size_t)order[(size_t)k - 1]].x == pos[(size_t)i].x && pos[(size_t)order[(size_t)k - 1]].y == pos[(size_t)i].y && pos[(size_t)order[(size_t)k - 1]].z == pos[(size_t)i].z;
+            rep[(size_t)i] = same ? rep[(size_t)order[(size_t)k - 1]] : i;
+        }
+
+        // Drop triangles that are degenerate after welding.
+        tris.clear();
+        for (size_t t = 0; t + 2 < indices.size(); t += 3) {
+            const uint32_t a = indices[t], b = indices[t + 1], c = indices[t + 2];
+            if (rep[a] == rep[b] || rep[b] == rep[c] || rep[a] == rep[c]) continue;
+            tris.insert(tris.end(), {a, b, c});
+        }
+        const int triCount = (int)(tris.size() / 3);
+        liveTris = triCount;
+        triAlive.assign((size_t)triCount, 1);
+
+        quadric.assign((size_t)n, Quadric{});
+        locked.assign((size_t)n, 0);
+        border.assign((size_t)n, 0);
+        removed.assign((size_t)n, 0);
+        stamp.assign((size_t)n, 0);
+        mark.assign((size_t)n, 0);
+        repTris.assign((size_t)n, std::vector<int>());
+
+        // Attribute seams: a rep referenced through more than one vertex index stays put.
+        std::vector<int> firstIndex((size_t)n, -1);
+        for (int t = 0; t < triCount; t++) {
+            for (int c = 0; c < 3; c++) {
+                const int v = (int)tris[(size_t)t * 3 + (size_t)c];
+                const int r = rep[(size_t)v];
+                if (firstIndex[(size_t)r] < 0) firstIndex[(size_t)r] = v;
+                else if (firstIndex[(size_t)r] != v) locked[(size_t)r] = 1;
+                repTris[(size_t)r].push_back(t);
+            }
+            const Vec3d nrm = triNormal(t, -1, Vec3d{});
+            const double len = std::sqrt(dot(nrm, nrm));
+            if (len <= 0.0) continue;
+            const Vec3d unit{nrm.x / len, nrm.y / len, nrm.z / len};
+            const Quadric q = planeQuadric(unit, -dot(unit, pos[(size_t)cornerRep(t, 0)]), 0.5 * len);
+            for (int c = 0; c < 3; c++) quadricAdd(quadric[(size_t)cornerRep(t, c)], q);
+        }
+
+        // Edges used by one triangle are open borders; more than two is non-manifold (locked).
+        struct Edge {
+            int a, b, tri;
+        };
+        std::vector<Edge> edges;
+        edges.reserve((size_t)triCount * 3);
+        for (int t = 0; t < triCount; t++) {
+            for (int c = 0; c < 3; c++) {
+                const int a = cornerRep(t, c), b = cornerRep(t, (c + 1) % 3);
+                edges.push_back(Edge{std::min(a, b), std::max(a, b), t});
+            }
+        }
+        std::sort(edges.begin(), edges.end(), [](const Edge& x, const Edge& y) { return x.a != y.a ? x.a < y.a : x.b < y.b; });
+        for (size_t i = 0; i < edges.size();) {
+            size_t j = i + 1;
+            while (j < edges.size() && edges[j].a == edges[i].a && edges[j].b == edges[i].b) j++;
+            const Edge& e = edges[i];
+            if (j - i > 2) {
+                locked[(size_t)e.a] = locked[(size_t)e.b] = 1;
+            } else if (j - i == 1) {
+                border[(size_t)e.a] = border[(size_t)e.b] = 1;
+                if (mesh->lockBorder) locked[(size_t)e.a] = locked[(size_t)e.b] = 1;
+                // Plane through the edge, perpendicular to its triangle.
+                const Vec3d dir = sub(pos[(size_t)e.b], pos[(size_t)e.a]);
+                const Vec3d nrm = triNormal(e.tri, -1, Vec3d{});
+                Vec3d side = cross(dir, nrm);
+                const double len = std::sqrt(dot(side, side));
+                if (len > 0.0) {
+                    side = Vec3d{side.x / len, side.y / len, side.z / len};
+                    const Quadric q = planeQuadric(side, -dot(side, pos[(size_t)e.a]), kBorderWeight * dot(dir, dir));
+                    quadricAdd(quadric[(size_t)e.a], q);
+                    quadricAdd(quadric[(size_t)e.b], q);
+                }
+            }
+            i = j;
+        }
+    }
+
+    uint32_t nextMark() {
+        if (++markStamp == 0) {
+            std::fill(mark.begin(), mark.end(), 0u);
+            markStamp = 1;
+        }
+        return markStamp;
+    }
+
+    // Queues the cheaper direction of edge a-b (one heap entry per edge keeps the heap small).
+    void pushEdge(int a, int b) {
+        Quadric q = quadric[(size_t)a];
+        quadricAdd(q, quadric[(size_t)b]);
+        const double scale = q.weight > 0.0 ? 1.0 / q.weight : 0.0;
+        const double ab = locked[(size_t)a] ? -1.0 : std::sqrt(quadricEval(q, pos[(size_t)b]) * scale);
+        const double ba = locked[(size_t)b] ? -1.0 : std::sqrt(quadricEval(q, pos[(size_t)a]) * scale);
+        if (ab < 0.0 && ba < 0.0) return;
+        const bool forward = ba < 0.0 || (ab >= 0.0 && ab <= ba);
+        const int from = forward ? a : b, to = forward ? b : a;
+        heap.push(Candidate{(float)(forward ? ab : ba), from, to, stamp[(size_t)from], stamp[(size_t)to]});
+    }
+
+    void pushAround(int r) {
+        const uint32_t m = nextMark();
+        for (int t : repTris[(size_t)r]) {
+            for (int c = 0; c < 3; c++) {
+                const int w = cornerRep(t, c);
+                if (w == r || mark[(size_t)w] == m) continue;
+                mark[(size_t)w] = m;
+                pushEdge(w, r);
+            }
+        }
+    }
+
+    void refill() {
+        heap = decltype(heap)();
+        for (int r = 0; r < (int)repTris.size(); r++) {
+            if (removed[(size_t)r] || repTris[(size_t)r].empty()) continue;
+            compactTris(r);
+            const uint32_t m = nextMark();
+            for (int t : repTris[(size_t)r]) {
+                for (int c = 0; c < 3; c++) {
+                    const int w = cornerRep(t, c);
+                    if (w <= r || mark[(size_t)w] == m) continue;
+                    mark[(size_t)w] = m;
+                    pushEdge(r, w);
+                }
+            }
+        }
+        collapsesAtRefill = collapses;
+    }
+
+    void compactTris(int r) {
+        std::vector<int>& list = repTris[(size_t)r];
+        list.erase(std::remove_if(list.begin(), list.end(), [this](int t) { return !triAlive[(size_t)t]; }), list.end());
+    }
+
+    // Topology and shape checks for collapsing u into v; on success returns v's vertex index as
+    // seen from u's side of any seam through v.
+    int validCollapse(int u, int v) {
+        compactTris(u);
+        compactTris(v);
+        const uint32_t m = nextMark();
+        int shared = 0;
+        int target = -1;
+        for (int t : repTris[(size_t)u]) {
+            for (int c = 0; c < 3; c++) {
+                const int w = cornerRep(t, c);
+                if (w == v && target < 0) target = (int)tris[(size_t)t * 3 + (size_t)c];
+                mark[(size_t)w] = m;
+            }
+            if (triHasRep(t, v)) shared++;
+        }
+        if (shared == 0) return -1;
+        // Open borders may only shorten along themselves.
+        if (border[(size_t)u] && shared != 1) return -1;
+        // Link condition: u and v may share no neighbours beyond the triangles on their edge.
+        int common = 0;
+        for (int t : repTris[(size_t)v]) {
+            for (int c = 0; c < 3; c++) {
+                const int w = cornerRep(t, c);
+                if (w != u && w != v && mark[(size_t)w] == m) {
+                    common++;
+                    mark[(size_t)w] = 0;
+                }
+            }
+        }
+        if (common != shared) return -1;
+        // No surviving triangle around u may flip or collapse to a sliver.
+        const Vec3d to = pos[(size_t)v];
+        for (int t : repTris[(size_t)u]) {
+            if (triHasRep(t, v)) continue;
+            const Vec3d before = triNormal(t, -1, Vec3d{});
+            const Vec3d after = triNormal(t, u, to);
+            const double d = dot(before, after);
+            if (d <= 0.0 || d * d < kMinNormalCos * kMinNormalCos * dot(before, before) * dot(after, after)) return -1;
+        }
+        return target;
+    }
+
+    void collapse(int u, int v, int vIndex) {
+        for (int t : repTris[(size_t)u]) {
+            if (!triAlive[(size_t)t]) continue;
+            if (triHasRep(t, v)) {
+                triAlive[(size_t)t] = 0;
+                liveTris--;
+                continue;
+            }
+            for (int c = 0; c < 3; c++) {
+                uint32_t& corner = tris[(size_t)t * 3 + (size_t)c];
+                if (rep[corner] == u) corner = (uint32_t)vIndex;
+            }
+            repTris[(size_t)v].push_back(t);
+        }
+        repTris[(size_t)u].clear();
+        repTris[(size_t)u].shrink_to_fit();
+        quadricAdd(quadric[(size_t)v], quadric[(size_t)u]);
+        removed[(size_t)u] = 1;
+        stamp[(size_t)v]++;
+        collapses++;
+        compactTris(v);
+        pushAround(v);
+    }
+
+    // Continues collapsing until liveTris * 3 <= targetIndices, the cheapest collapse exceeds
+    // maxError, or nothing valid is left.
+    void run(int targetIndices, double maxError) {
+        while ((long long)liveTris * 3 > targetIndices) {
+            if (heap.empty()) {
+                if (collapses == collapsesAtRefill) return;
+                refill();
+                if (heap.empty()) return;
+            }
+            const Candidate c = heap.top();
+            if (removed[(size_t)c.from] || removed[(size_t)c.to] || stamp[(size_t)c.from] != c.fromStamp || stamp[(size_t)c.to] != c.toStamp) {
+                heap.pop();
+                continue;
+            }
+            if (maxError > 0.0 && c.error > maxError) return; // cheapest valid candidate: keep it queued
+            heap.pop();
+            const int vIndex = validCollapse(c.from, c.to);
+            if (vIndex < 0) continue;
+            collapse(c.from, c.to, vIndex);
+            error = std::max(error, (double)c.error);
+        }
+    }
+
+    void output(std::vector<uint32_t>& out) const {
+        for (size_t t = 0; t < triAlive.size(); t++) {
+            if (triAlive[t]) out.insert(out.end(), tris.begin() + (ptrdiff_t)t * 3, tris.begin() + (ptrdiff_t)t * 3 + 3);
+        }
+    }
+};
+
+static bool readIndices(const g4f_lod_mesh_desc* mesh, std::vector<uint32_t>& out, const char* fn) {
+    if (!mesh || !mesh->positions || mesh->vertexCount <= 0 || mesh->indexCount < 3 || mesh->indexCount % 3 != 0 || (!mesh->indices32 && !mesh->indices16)) {
+        g4f_set_last_errorf("%s: invalid mesh", fn);
+        return false;
+    }
+    if (mesh->positionStride != 0 && mesh->positionStride < 12) {
+        g4f_set_last_errorf("%s: invalid position stride", fn);
+        return false;
+    }
+    out.resize((size_t)mesh->indexCount);
+    for (int i = 0; i < mesh->indexCount; i++) {
+        const uint32_t idx = mesh->indices32 ? mesh->indices32[i] : mesh->indices16[i];
+        if (idx >= (uint32_t)mesh->vertexCount) {
+            g4f_set_last_errorf("%s: index out of range", fn);
+            return false;
+        }
+        out[(size_t)i] = idx;
+    }
+    return true;
+}
+
+} // namespace
+
+struct g4f_lod_chain {
+    std::vector<uint32_t> indices;
+    std::vector<g4f_lod_level> levels;
+    g4f_vec3 center{};
+    float radius = 0.0f;
+};
+
+g4f_lod_mesh_desc g4f_lod_mesh_desc_default(void) {
+    g4f_lod_mesh_desc d{};
+    d.positionStride = 12;
+    return d;
+}
+
+int g4f_lod_simplify(const g4f_lod_mesh_desc* mesh, int targetIndexCount, float maxError, uint32_t* outIndices, float* outError) {
+    std::vector<uint32_t> indices;
+    if (!readIndices(mesh, indices, "g4f_lod_simplify")) return -1;
+    if (!outIndices) {
+        g4f_set_last_error("g4f_lod_simplify: invalid output");
+        return -1;
+    }
+    Simplifier s;
+    s.init(mesh, indices);
+    s.run(std::max(targetIndexCount, 0), maxError);
+    indices.clear();
+    s.output(indices);
+    if (!indices.empty()) std::memcpy(outIndices, indices.data(), indices.size() * sizeof(uint32_t));
+    if (outError) *outError = (float)s.error;
+    return (int)indices.size();
+}
+
+g4f_lod_chain_desc g4f_lod_chain_desc_default(void) {
+    g4f_lod_chain_desc d{};
+    d.maxLevels = 6;
+    d.reduction = 0.5f;
+    d.minTriangles = 8;
+    return d;
+}
+
+g4f_lod_chain* g4f_lod_chain_create(const g4f_lod_mesh_desc* mesh, const g4f_lod_chain_desc* desc) {
+    std::vector<uint32_t> source;
+    if (!readIndices(mesh, source, "g4f_lod_chain_create")) return nullptr;
+    const g4f_lod_chain_desc d = desc ? *desc : g4f_lod_chain_desc_default();
+    const int maxLevels = std::clamp(d.maxLevels > 0 ? d.maxLevels : 6, 1, G4F_LOD_MAX_LEVELS);
+    const double reduction = (d.reduction > 0.0f && d.reduction < 1.0f) ? d.reduction : 0.5;
+    const int minTriangles = d.minTriangles > 0 ? d.minTriangles : 8;
+
+    auto* chain = new g4f_lod_chain();
+    Simplifier s;
+    s.init(mesh, source);
+
+    // Bounding sphere: box center, farthest vertex.
+    Vec3d lo = s.pos[0], hi = s.pos[0];
+    for (const Vec3d& p : s.pos) {
+        lo = Vec3d{std::min(lo.x, p.x), std::min(lo.y, p.y), std::min(lo.z, p.z)};
+        hi = Vec3d{std::max(hi.x, p.x), std::max(hi.y, p.y), std::max(hi.z, p.z)};
+    }
+    const Vec3d center{(lo.x + hi.x) * 0.5, (lo.y + hi.y) * 0.5, (lo.z + hi.z) * 0.5};
+    double radius2 = 0.0;
+    for (const Vec3d& p : s.pos) radius2 = std::max(radius2, dot(sub(p, center), sub(p, center)));
+    chain->center = g4f_vec3{(float)center.x, (float)center.y, (float)center.z};
+    chain->radius = (float)std::sqrt(radius2);
+    const double maxError = d.maxError > 0.0f ? d.maxError : 0.05 * chain->radius;
+
+    chain->indices = source;
+    chain->levels.push_back(g4f_lod_level{0, (int)source.size(), 0.0f});
+    while ((int)chain->levels.size() < maxLevels) {
+        const g4f_lod_level& prev = chain->levels.back();
+        const int target = (int)((double)(prev.indexCount / 3) * reduction) * 3;
+        if (target < minTriangles * 3) break;
+        s.run(target, maxError);
+        if ((double)s.liveTris * 3.0 > kMinLevelProgress * (double)prev.indexCount) break;
+        const int first = (int)chain->indices.size();
+        s.output(chain->indices);
+        chain->levels.push_back(g4f_lod_level{first, (int)chain->indices.size() - first, (float)s.error});
+    }
+    return chain;
+}
+
+void g4f_lod_chain_destroy(g4f_lod_chain* chain) {
+    delete chain;
+}
+
+int g4f_lod_chain_level_count(const g4f_lod_chain* chain) {
+    return chain ? (int)chain->levels.size() : 0;
+}
+
+g4f_lod_level g4f_lod_chain_level(const g4f_lod_chain* chain, int level) {
+    if (!chain || level < 0 || level >= (int)chain->levels.size()) return g4f_lod_level{0, 0, 0.0f};
+    return chain->levels[(size_t)level];
+}
+
+const uint32_t* g4f_lod_chain_indices(const g4f_lod_chain* chain, int* count) {
+    if (count) *count = chain ? (int)chain->indices.size() : 0;
+    return chain ? chain->indices.data() : nullptr;
+}
+
+void g4f_lod_chain_bounds(const g4f_lod_chain* chain, g4f_vec3* outCenter, float* outRadius) {
+    if (outCenter) *outCenter = chain ? chain->center : g4f_vec3{0.0f, 0.0f, 0.0f};
+    if (outRadius) *outRadius = chain ? chain->radius : 0.0f;
+}
+
+g4f_lod_view g4f_lod_view_from_camera(const g4f_camera_fps* cam, int viewportHeight, float thresholdPixels) {
+    g4f_lod_view view{};
+    if (!cam) return view;
+    const float fovY = cam->fovYRadians > 0.0f ? cam->fovYRadians : 70.0f * 3.14159265f / 180.0f;
+    view.eye = cam->position;
+    view.pixelScale = (float)std::max(viewportHeight, 1) / (2.0f * std::tan(fovY * 0.5f));
+    view.thresholdPixels = thresholdPixels;
+    return view;
+}
+
+int g4f_lod_select(const g4f_lod_chain* chain, const g4f_lod_view* view, const g4f_mat4* model, int currentLevel) {
+    if (!chain || !view) return 0;
+    const int count = (int)chain->levels.size();
+    if (count <= 1) return 0;
+
+    g4f_vec3 center = chain->center;
+    float scale = 1.0f;
+    if (model) {
+        const float* m = model->m;
+        center = g4f_vec3{
+            center.x * m[0] + center.y * m[4] + center.z * m[8] + m[12],
+            center.x * m[1] + center.y * m[5] + center.z * m[9] + m[13],
+            center.x * m[2] + center.y * m[6] + center.z * m[10] + m[14],
+        };
+        float maxRow2 = 0.0f;
+        for (int r = 0; r < 3; r++) maxRow2 = std::max(maxRow2, m[r * 4] * m[r * 4] + m[r * 4 + 1] * m[r * 4 + 1] + m[r * 4 + 2] * m[r * 4 + 2]);
+        if (maxRow2 > 0.0f) scale = std::sqrt(maxRow2);
+    }
+    const g4f_vec3 toEye = vec3Sub(view->eye, center);
+    const float distance = std::max(std::sqrt(vec3Dot(toEye, toEye)) - chain->radius * scale, 1e-4f);
+    const float pixelsPerUnit = view->pixelScale * scale / distance;
+    const float threshold = view->thresholdPixels > 0.0f ? view->thresholdPixels : 1.0f;
+    const float band = view->hysteresis > 0.0f ? std::min(view->hysteresis, 0.9f) : 0.25f;
+
+    auto coarsestUnder = [&](float limit) {
+        int level = 0;
+        while (level + 1 < count && chain->levels[(size_t)level + 1].error * pixelsPerUnit <= limit) level++;
+        return level;
+    };
+    const int ideal = coarsestUnder(threshold);
+    if (currentLevel < 0 || currentLevel >= count) return ideal;
+    if (ideal > currentLevel) return std::max(coarsestUnder(threshold * (1.0f - band)), currentLevel);
+    if (ideal < currentLevel && chain->levels[(size_t)currentLevel].error * pixelsPerUnit > threshold * (1.0f + band)) return ideal;
+    return currentLevel;
+}
@@ -0,0 +1,94 @@
+#include "../include/g4f/g4f_material_key.h"
+
+namespace {
+
+// Bit layout; the low bits are the pixel shader permutation.
+enum : uint32_t {
+    kBitLit = 0,
+    kBitTextured = 1,
+    kBitAlphaTest = 2,
+    kBitClustered = 3,
+    kBitAlphaBlend = 4,
+    kBitDepthTest = 5,
+    kBitDepthWrite = 6,
+    kShiftCull = 7,       // 2 bits
+    kShiftFilter = 9,     // 2 bits
+    kShiftAddress = 11,   // 1 bit
+};
+
+static uint32_t flag(int v, uint32_t bit) {
+    return v ? (1u << bit) : 0u;
+}
+
+static int clampi(int v, int lo, int hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+} // namespace
+
+uint32_t g4f_material_key_make(const g4f_material_state* state) {
+    if (!state) return 0;
+    const int textured = state->textured ? 1 : 0;
+    const int lit = state->lit ? 1 : 0;
+    const int depthTest = state->depthTest ? 1 : 0;
+    // Writes are ignored while the depth test is off, so both variants share a bundle.
+    const int depthWrite = depthTest && state->depthWrite ? 1 : 0;
+    // Untextured shaders never sample; do not split bundles by sampler.
+    const int filter = textured ? clampi(state->samplerFilter, G4F_GFX_FILTER_LINEAR, G4F_GFX_FILTER_ANISOTROPIC) : 0;
+    const int address = textured && state->samplerAddress == G4F_GFX_ADDRESS_WRAP ? 1 : 0;
+
+    uint32_t key = 0;
+    key |= flag(lit, kBitLit);
+    key |= flag(textured, kBitTextured);
+    key |= flag(state->alphaTest, kBitAlphaTest);
+    key |= flag(lit && state->clustered, kBitClustered);
+    key |= flag(state->alphaBlend, kBitAlphaBlend);
+    key |= flag(depthTest, kBitDepthTest);
+    key |= flag(depthWrite, kBitDepthWrite);
+    key |= (uint32_t)clampi(state->cullMode, 0, 2) << kShiftCull;
+    key |= (uint32_t)filter << kShiftFilter;
+    key |= (uint32_t)address << kShiftAddress;
+    return key;
+}
+
+void g4f_material_key_unpack(uint32_t key, g4f_material_state* out) {
+    if (!out) return;
+    out->lit = (int)((key >> kBitLit) & 1u);
+    out->textured = (int)((key >> kBitTextured) & 1u);
+    out->alphaTest = (int)((key >> kBitAlphaTest) & 1u);
+    out->clustered = (int)((key >> kBitClustered) & 1u);
+    out->alphaBlend = (int)((key >> kBitAlphaBlend) & 1u);
+    out->depthTest = (int)((key >> kBitDepthTest) & 1u);
+    out->depthWrite = (int)((key >> kBitDepthWrite) & 1u);
+    out->cullMode = (int)((key >> kShiftCull) & 3u);
+    out->samplerFilter = (int)((key >> kShiftFilter) & 3u);
+    out->samplerAddress = (int)((key >> kShiftAddress) & 1u);
+}
+
+int g4f_material_key_shader(uint32_t key) {
+    return (int)(key & (G4F_MATERIAL_SHADER_COUNT - 1));
+}
+
+void g4f_material_bundle_table_reset(g4f_material_bundle_table* table) {
+    if (!table) return;
+    table->count = 0;
+}
+
+int g4f_material_bundle_table_find(const g4f_material_bundle_table* table, uint32_t key) {
+    if (!table) return -1;
+    for (int i = 0; i < table->count; i++) {
+        if (table->keys[i] == key) return i;
+    }
+    return -1;
+}
+
+int g4f_material_bundle_table_intern(g4f_material_bundle_table* table, uint32_t key, int* outAdded) {
+    if (outAdded) *outAdded = 0;
+    if (!table) return -1;
+    int id = g4f_material_bundle_table_find(table, key);
+    if (id >= 0) return id;
+    if (table->count >= G4F_MATERIAL_BUNDLE_MAX) return -1;
+    table->keys[table->count] = key;
+    if (outAdded) *outAdded = 1;
+    return table->count++;
+}
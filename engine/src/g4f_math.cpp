@@ -1,4 +1,5 @@
 #include "../include/g4f/g4f.h"
+#include "g4f_error_internal.h"
 
 #include <cmath>
 
@@ -134,3 +135,226 @@ g4f_mat4 g4f_mat4_look_at(g4f_vec3 eye, g4f_vec3 at, g4f_vec3 up) {
     out.m[14] = vec3Dot(forward, eye);
     return out;
 }
+
+g4f_mat4 g4f_mat4_inverse(g4f_mat4 m) {
+    // Cofactor expansion (row-major, same result for either vector convention).
+    const float* a = m.m;
+    float inv[16];
+    inv[0] = a[5] * a[10] * a[15] - a[5] * a[11] * a[14] - a[9] * a[6] * a[15] + a[9] * a[7] * a[14] + a[13] * a[6] * a[11] - a[13] * a[7] * a[10];
+    inv[4] = -a[4] * a[10] * a[15] + a[4] * a[11] * a[14] + a[8] * a[6] * a[15] - a[8] * a[7] * a[14] - a[12] * a[6] * a[11] + a[12] * a[7] * a[10];
+    inv[8] = a[4] * a[9] * a[15] - a[4] * a[11] * a[13] - a[8] * a[5] * a[15] + a[8] * a[7] * a[13] + a[12] * a[5] * a[11] - a[12] * a[7] * a[9];
+    inv[12] = -a[4] * a[9] * a[14] + a[4] * a[10] * a[13] + a[8] * a[5] * a[14] - a[8] * a[6] * a[13] - a[12] * a[5] * a[10] + a[12] * a[6] * a[9];
+    inv[1] = -a[1] * a[10] * a[15] + a[1] * a[11] * a[14] + a[9] * a[2] * a[15] - a[9] * a[3] * a[14] - a[13] * a[2] * a[11] + a[13] * a[3] * a[10];
+    inv[5] = a[0] * a[10] * a[15] - a[0] * a[11] * a[14] - a[8] * a[2] * a[15] + a[8] * a[3] * a[14] + a[12] * a[2] * a[11] - a[12] * a[3] * a[10];
+    inv[9] = -a[0] * a[9] * a[15] + a[0] * a[11] * a[13] + a[8] * a[1] * a[15] - a[8] * a[3] * a[13] - a[12] * a[1] * a[11] + a[12] * a[3] * a[9];
+    inv[13] = a[0] * a[9] * a[14] - a[0] * a[10] * a[13] - a[8] * a[1] * a[14] + a[8] * a[2] * a[13] + a[12] * a[1] * a[10] - a[12] * a[2] * a[9];
+    inv[2] = a[1] * a[6] * a[15] - a[1] * a[7] * a[14] - a[5] * a[2] * a[15] + a[5] * a[3] * a[14] + a[13] * a[2] * a[7] - a[13] * a[3] * a[6];
+    inv[6] = -a[0] * a[6] * a[15] + a[0] * a[7] * a[14] + a[4] * a[2] * a[15] - a[4] * a[3] * a[14] - a[12] * a[2] * a[7] + a[12] * a[3] * a[6];
+    inv[10] = a[0] * a[5] * a[15] - a[0] * a[7] * a[13] - a[4] * a[1] * a[15] + a[4] * a[3] * a[13] + a[12] * a[1] * a[7] - a[12] * a[3] * a[5];
+    inv[14] = -a[0] * a[5] * a[14] + a[0] * a[6] * a[13] + a[4] * a[1] * a[14] - a[4] * a[2] * a[13] - a[12] * a[1] * a[6] + a[12] * a[2] * a[5];
+    inv[3] = -a[1] * a[6] * a[11] + a[1] * a[7] * a[10] + a[5] * a[2] * a[11] - a[5] * a[3] * a[10] - a[9] * a[2] * a[7] + a[9] * a[3] * a[6];
+    inv[7] = a[0] * a[6] * a[11] - a[0] * a[7] * a[10] - a[4] * a[2] * a[11] + a[4] * a[3] * a[10] + a[8] * a[2] * a[7] - a[8] * a[3] * a[6];
+    inv[11] = -a[0] * a[5] * a[11] + a[0] * a[7] * a[9] + a[4] * a[1] * a[11] - a[4] * a[3] * a[9] - a[8] * a[1] * a[7] + a[8] * a[3] * a[5];
+    inv[15] = a[0] * a[5] * a[10] - a[0] * a[6] * a[9] - a[4] * a[1] * a[10] + a[4] * a[2] * a[9] + a[8] * a[1] * a[6] - a[8] * a[2] * a[5];
+
+    float det = a[0] * inv[0] + a[1] * inv[4] + a[2] * inv[8] + a[3] * inv[12];
+    if (det == 0.0f || !std::isfinite(det)) return g4f_mat4_identity();
+    float invDet = 1.0f / det;
+    g4f_mat4 out{};
+    for (int i = 0; i < 16; i++) out.m[i] = inv[i] * invDet;
+    return out;
+}
+
+g4f_quat g4f_quat_identity(void) {
+    return g4f_quat{0.0f, 0.0f, 0.0f, 1.0f};
+}
+
+g4f_quat g4f_quat_from_axis_angle(g4f_vec3 axis, float radians) {
+    g4f_vec3 n = vec3Normalize(axis);
+    if (n.x == 0.0f && n.y == 0.0f && n.z == 0.0f) return g4f_quat_identity();
+    float s = std::sin(radians * 0.5f);
+    return g4f_quat{n.x * s, n.y * s, n.z * s, std::cos(radians * 0.5f)};
+}
+
+g4f_quat g4f_quat_mul(g4f_quat a, g4f_quat b) {
+    return g4f_quat{
+        a.w * b.x + a.x * b.w + a.y * b.z - a.z * b.y,
+        a.w * b.y - a.x * b.z + a.y * b.w + a.z * b.x,
+        a.w * b.z + a.x * b.y - a.y * b.x + a.z * b.w,
+        a.w * b.w - a.x * b.x - a.y * b.y - a.z * b.z,
+    };
+}
+
+g4f_quat g4f_quat_normalize(g4f_quat q) {
+    float len2 = q.x * q.x + q.y * q.y + q.z * q.z + q.w * q.w;
+    if (len2 <= 0.0f || !std::isfinite(len2)) return g4f_quat_identity();
+    float invLen = 1.0f / std::sqrt(len2);
+    return g4f_quat{q.x * invLen, q.y * invLen, q.z * invLen, q.w * invLen};
+}
+
+g4f_mat4 g4f_quat_to_mat4(g4f_quat q) {
+    // Transpose of the usual column-vector rotation matrix (row vectors: p' = p * M).
+    const float xx = q.x * q.x, yy = q.y * q.y, zz = q.z * q.z;
+    const float xy = q.x * q.y, xz = q.x * q.z, yz = q.y * q.z;
+    const float wx = q.w * q.x, wy = q.w * q.y, wz = q.w * q.z;
+    g4f_mat4 out = g4f_mat4_identity();
+    out.m[0] = 1.0f - 2.0f * (yy + zz);
+    out.m[1] = 2.0f * (xy + wz);
+    out.m[2] = 2.0f * (xz - wy);
+    out.m[4] = 2.0f * (xy - wz);
+    out.m[5] = 1.0f - 2.0f * (xx + zz);
+    out.m[6] = 2.0f * (yz + wx);
+    out.m[8] = 2.0f * (xz + wy);
+    out.m[9] = 2.0f * (yz - wx);
+    out.m[10] = 1.0f - 2.0f * (xx + yy);
+    return out;
+}
+
+g4f_mat4 g4f_mat4_trs(g4f_vec3 translation, g4f_quat rotation, g4f_vec3 scale) {
+    g4f_mat4 out = g4f_quat_to_mat4(rotation);
+    const float s[3] = {scale.x, scale.y, scale.z};
+    for (int r = 0; r < 3; r++) {
+        for (int c = 0; c < 3; c++) out.m[r * 4 + c] *= s[r];
+    }
+    out.m[12] = translation.x;
+    out.m[13] = translation.y;
+    out.m[14] = translation.z;
+    return out;
+}
+
+static g4f_vec3 transformPoint(const g4f_mat4& m, float x, float y, float z) {
+    float w = x * m.m[3] + y * m.m[7] + z * m.m[11] + m.m[15];
+    float invW = (w != 0.0f) ? 1.0f / w : 0.0f;
+    return g4f_vec3{
+        (x * m.m[0] + y * m.m[4] + z * m.m[8] + m.m[12]) * invW,
+        (x * m.m[1] + y * m.m[5] + z * m.m[9] + m.m[13]) * invW,
+        (x * m.m[2] + y * m.m[6] + z * m.m[10] + m.m[14]) * invW,
+    };
+}
+
+// NDC depth of a point `distance` in front of the camera; handles both +Z (w = z) and -Z (w = -z)
+// projections by following the sign of proj.m[11].
+static float ndcDepthAt(const g4f_mat4& proj, float distance) {
+    float z = proj.m[11] >= 0.0f ? distance : -distance;
+    float clipZ = z * proj.m[10] + proj.m[14];
+    float clipW = z * proj.m[11] + proj.m[15];
+    return clipW != 0.0f ? clipZ / clipW : 0.0f;
+}
+
+void g4f_shadow_cascade_splits(float nearZ, float farZ, int cascadeCount, float lambda, float* outSplits) {
+    if (!outSplits || cascadeCount <= 0) return;
+    if (lambda < 0.0f) lambda = 0.0f;
+    if (lambda > 1.0f) lambda = 1.0f;
+    for (int i = 0; i <= cascadeCount; i++) {
+        float t = (float)i / (float)cascadeCount;
+        float logSplit = nearZ * std::pow(farZ / nearZ, t);
+        float uniSplit = nearZ + (farZ - nearZ) * t;
+        outSplits[i] = lambda * logSplit + (1.0f - lambda) * uniSplit;
+    }
+    // Exact end points regardless of pow() rounding.
+    outSplits[0] = nearZ;
+    outSplits[cascadeCount] = farZ;
+}
+
+int g4f_shadow_cascades_fit(const g4f_mat4* view, const g4f_mat4* proj, g4f_vec3 lightDir, const float* splits,
+                            int cascadeCount, int shadowMapSize, float casterDistance, g4f_shadow_cascade* outCascades) {
+    if (!view || !proj || !splits || !outCascades) { g4f_set_last_error("g4f_shadow_cascades_fit: invalid args"); return 0; }
+    if (cascadeCount <= 0 || cascadeCount > G4F_SHADOW_MAX_CASCADES) {
+        g4f_set_last_error("g4f_shadow_cascades_fit: cascadeCount must be 1..G4F_SHADOW_MAX_CASCADES");
+        return 0;
+    }
+    if (shadowMapSize <= 0) { g4f_set_last_error("g4f_shadow_cascades_fit: invalid shadowMapSize"); return 0; }
+    g4f_vec3 dir = vec3Normalize(lightDir);
+    if (vec3Dot(dir, dir) == 0.0f) { g4f_set_last_error("g4f_shadow_cascades_fit: lightDir is zero"); return 0; }
+    if (casterDistance < 0.0f) casterDistance = 0.0f;
+
+    // Light basis depends on the light direction only (stable while the camera moves).
+    g4f_vec3 upHint = std::fabs(dir.y) > 0.99f ? g4f_vec3{1.0f, 0.0f, 0.0f} : g4f_vec3{0.0f, 1.0f, 0.0f};
+    g4f_vec3 right = vec3Normalize(vec3Cross(upHint, dir));
+    g4f_vec3 up = vec3Cross(dir, right);
+
+    const g4f_mat4 invViewProj = g4f_mat4_inverse(g4f_mat4_mul(*view, *proj));
+    for (int c = 0; c < cascadeCount; c++) {
+        const float depths[2] = {ndcDepthAt(*proj, splits[c]), ndcDepthAt(*proj, splits[c + 1])};
+        g4f_vec3 corners[8];
+        g4f_vec3 center{0.0f, 0.0f, 0.0f};
+        for (int i = 0; i < 8; i++) {
+            corners[i] = transformPoint(invViewProj, (i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, depths[i >> 2]);
+            center.x += corners[i].x * 0.125f;
+            center.y += corners[i].y * 0.125f;
+            center.z += corners[i].z * 0.125f;
+        }
+        float radius = 0.0f;
+        for (const g4f_vec3& corner : corners) {
+            g4f_vec3 d = vec3Sub(corner, center);
+            radius = std::fmax(radius, std::sqrt(vec3Dot(d, d)));
+        }
+        // Quantize so the texel size (and the snapping grid) is identical from frame to frame.
+        radius = std::ceil(radius * 16.0f) / 16.0f;
+        if (radius <= 0.0f) radius = 1.0f / 16.0f;
+
+        const float texel = 2.0f * radius / (float)shadowMapSize;
+        const float cx = std::floor(vec3Dot(center, right) / texel) * texel;
+        const float cy = std::floor(vec3Dot(center, up) / texel) * texel;
+        const float cz = vec3Dot(center, dir);
+        const float zNear = cz - radius - casterDistance;
+        const float zFar = cz + radius;
+        const float depthRange = zFar - zNear;
+
+        g4f_shadow_cascade& out = outCascades[c];
+        out = g4f_shadow_cascade{};
+        g4f_mat4& m = out.viewProj;
+        const float invR = 1.0f / radius;
+        const float invD = 1.0f / depthRange;
+        m.m[0] = right.x * invR;
+        m.m[4] = right.y * invR;
+        m.m[8] = right.z * invR;
+        m.m[12] = -cx * invR;
+        m.m[1] = up.x * invR;
+        m.m[5] = up.y * invR;
+        m.m[9] = up.z * invR;
+        m.m[13] = -cy * invR;
+        m.m[2] = dir.x * invD;
+        m.m[6] = dir.y * invD;
+        m.m[10] = dir.z * invD;
+        m.m[14] = -zNear * invD;
+        m.m[15] = 1.0f;
+
+        out.splitNear = splits[c];
+        out.splitFar = splits[c + 1];
+        out.center = g4f_vec3{
+            right.x * cx + up.x * cy + dir.x * cz,
+            right.y * cx + up.y * cy + dir.y * cz,
+            right.z * cx + up.z * cy + dir.z * cz,
+        };
+        out.radius = radius;
+        out.depthRange = depthRange;
+        out.texelWorldSize = texel;
+    }
+    return 1;
+}
+
+int g4f_shadow_cascades_cull(const g4f_shadow_cascade* cascades, int cascadeCount, const float* spheres, int sphereCount,
+                             uint8_t* outMasks) {
+    if (!cascades || !spheres || !outMasks || sphereCount <= 0) return 0;
+    if (cascadeCount > G4F_SHADOW_MAX_CASCADES) cascadeCount = G4F_SHADOW_MAX_CASCADES;
+    int kept = 0;
+    for (int i = 0; i < sphereCount; i++) {
+        const float* s = spheres + (size_t)i * 4;
+        uint8_t mask = 0;
+        for (int c = 0; c < cascadeCount; c++) {
+            const g4f_mat4& m = cascades[c].viewProj;
+            const float x = s[0] * m.m[0] + s[1] * m.m[4] + s[2] * m.m[8] + m.m[12];
+            const float y = s[0] * m.m[1] + s[1] * m.m[5] + s[2] * m.m[9] + m.m[13];
+            const float z = s[0] * m.m[2] + s[1] * m.m[6] + s[2] * m.m[10] + m.m[14];
+            const float rxy = s[3] / cascades[c].radius;
+            const float rz = s[3] / cascades[c].depthRange;
+            // No near test: casters between the light and the cascade still shadow it (depth is clamped).
+            if (std::fabs(x) > 1.0f + rxy || std::fabs(y) > 1.0f + rxy || z - rz > 1.0f) continue;
+            mask |= (uint8_t)(1u << c);
+            kept++;
+        }
+        outMasks[i] = mask;
+    }
+    return kept;
+}
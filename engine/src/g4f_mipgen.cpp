@@ -0,0 +1,328 @@
+#include "../include/g4f/g4f_mipgen.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+constexpr float kKaiserSupport = 1.5f; // kernel radius in destination pixels
+constexpr float kKaiserAlpha = 4.0f;
+
+struct SrgbTables {
+    float toLinear[256];
+    uint8_t toSrgb[4096];
+
+    SrgbTables() {
+        for (int i = 0; i < 256; i++) {
+            float c = (float)i / 255.0f;
+            toLinear[i] = (c <= 0.04045f) ? c / 12.92f : std::pow((c + 0.055f) / 1.055f, 2.4f);
+        }
+        for (int i = 0; i < 4096; i++) {
+            float l = (float)i / 4095.0f;
+            float c = (l <= 0.0031308f) ? l * 12.92f : 1.055f * std::pow(l, 1.0f / 2.4f) - 0.055f;
+            toSrgb[i] = (uint8_t)(c * 255.0f + 0.5f);
+        }
+    }
+};
+
+static const SrgbTables& srgbTables() {
+    static const SrgbTables tables;
+    return tables;
+}
+
+struct Tap {
+    int index;
+    float weight;
+};
+
+// Per-destination-index filter taps for one axis.
+struct TapTable {
+    std::vector<int> first;
+    std::vector<int> count;
+    std::vector<Tap> taps;
+};
+
+static float besselI0(float x) {
+    float sum = 1.0f;
+    float term = 1.0f;
+    float halfX = x * 0.5f;
+    for (int k = 1; k < 32; k++) {
+        term *= (halfX / (float)k) * (halfX / (float)k);
+        sum += term;
+        if (term < sum * 1e-7f) break;
+    }
+    return sum;
+}
+
+static float kaiserSinc(float x) {
+    float t = x / kKaiserSupport;
+    if (t <= -1.0f || t >= 1.0f) return 0.0f;
+    float window = besselI0(kKaiserAlpha * std::sqrt(1.0f - t * t)) / besselI0(kKaiserAlpha);
+    if (std::fabs(x) < 1e-6f) return window;
+    float px = 3.14159265f * x;
+    return window * std::sin(px) / px;
+}
+
+static int wrapOrClamp(int i, int size, bool wrap) {
+    if (wrap) {
+        i %= size;
+        return i < 0 ? i + size : i;
+    }
+    return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+
+static void buildTaps(int srcSize, int dstSize, int filter, bool wrap, TapTable& out) {
+    out.first.assign((size_t)dstSize, 0);
+    out.count.assign((size_t)dstSize, 0);
+    out.taps.clear();
+
+    const float scale = (float)srcSize / (float)dstSize;
+    for (int i = 0; i < dstSize; i++) {
+        const float center = ((float)i + 0.5f) * scale; // in source pixel-edge coordinates
+        out.first[(size_t)i] = (int)out.taps.size();
+        float sum = 0.0f;
+
+        if (filter == G4F_MIPGEN_FILTER_KAISER && scale > 1.0f) {
+            const float radius = kKaiserSupport * scale;
+            int j0 = (int)std::floor(center - radius);
+            int j1 = (int)std::ceil(center + radius);
+            for (int j = j0; j <= j1; j++) {
+                float w = kaiserSinc(((float)j + 0.5f - center) / scale);
+                if (w == 0.0f) continue;
+                out.taps.push_back(Tap{wrapOrClamp(j, srcSize, wrap), w});
+                sum += w;
+            }
+        } else {
+            const float lo = center - scale * 0.5f;
+            const float hi = center + scale * 0.5f;
+            for (int j = (int)std::floor(lo); j < (int)std::ceil(hi); j++) {
+                float overlap = std::fmin(hi, (float)j + 1.0f) - std::fmax(lo, (float)j);
+                if (overlap <= 1e-6f) continue;
+                out.taps.push_back(Tap{wrapOrClamp(j, srcSize, wrap), overlap});
+                sum += overlap;
+            }
+        }
+
+        out.count[(size_t)i] = (int)out.taps.size() - out.first[(size_t)i];
+        float inv = sum != 0.0f ? 1.0f / sum : 0.0f;
+        for (int k = out.first[(size_t)i]; k < (int)out.taps.size(); k++) out.taps[(size_t)k].weight *= inv;
+    }
+}
+
+template <typename Fn>
+static void parallelRows(g4f_jobs* jobs, int rows, Fn& fn) {
+    g4f_jobs_parallel_for(jobs, rows, 0, [](void* user, int begin, int end, int) {
+        Fn& f = *(Fn*)user;
+        for (int r = begin; r < end; r++) f(r);
+    }, &fn);
+}
+
+// Linear float RGBA image (4 floats per pixel).
+struct FloatImage {
+    int width = 0;
+    int height = 0;
+    std::vector<float> px;
+    float* row(int y) { return px.data() + (size_t)y * (size_t)width * 4; }
+};
+
+static void decodeRgba8(const uint8_t* src, int pitch, bool linear, g4f_jobs* jobs, FloatImage& out) {
+    const float* toLinear = srgbTables().toLinear;
+    auto decodeRow = [&](int y) {
+        const uint8_t* s = src + (size_t)y * (size_t)pitch;
+        float* d = out.row(y);
+        for (int x = 0; x < out.width; x++) {
+            if (linear) {
+                d[0] = (float)s[0] * (1.0f / 255.0f);
+                d[1] = (float)s[1] * (1.0f / 255.0f);
+                d[2] = (float)s[2] * (1.0f / 255.0f);
+            } else {
+                d[0] = toLinear[s[0]];
+                d[1] = toLinear[s[1]];
+                d[2] = toLinear[s[2]];
+            }
+            d[3] = (float)s[3] * (1.0f / 255.0f);
+            s += 4;
+            d += 4;
+        }
+    };
+    parallelRows(jobs, out.height, decodeRow);
+}
+
+static void encodeRgba8(FloatImage& img, bool linear, g4f_jobs* jobs, uint8_t* dst, int pitch) {
+    const uint8_t* toSrgb = srgbTables().toSrgb;
+    auto encodeRow = [&](int y) {
+        const float* s = img.row(y);
+        uint8_t* d = dst + (size_t)y * (size_t)pitch;
+        alignas(16) int32_t q[4];
+        const F4 zero = f4Set1(0.0f);
+        const F4 one = f4Set1(1.0f);
+        const F4 colorScale = linear ? f4Set1(255.0f) : f4Set(4095.0f, 4095.0f, 4095.0f, 255.0f);
+        for (int x = 0; x < img.width; x++) {
+            i4Store(q, i4FromF4(f4Clamp(f4Load(s), zero, one) * colorScale + f4Set1(0.5f)));
+            if (linear) {
+                d[0] = (uint8_t)q[0];
+                d[1] = (uint8_t)q[1];
+                d[2] = (uint8_t)q[2];
+            } else {
+                d[0] = toSrgb[q[0]];
+                d[1] = toSrgb[q[1]];
+                d[2] = toSrgb[q[2]];
+            }
+            d[3] = (uint8_t)q[3];
+            s += 4;
+            d += 4;
+        }
+    };
+    parallelRows(jobs, img.height, encodeRow);
+}
+
+// Separable resample: horizontal into tmp (src rows x dst cols), then vertical into dst.
+static void resample(FloatImage& src, FloatImage& dst, int filter, bool wrap, g4f_jobs* jobs) {
+    TapTable tx, ty;
+    buildTaps(src.width, dst.width, filter, wrap, tx);
+    buildTaps(src.height, dst.height, filter, wrap, ty);
+
+    FloatImage tmp;
+    tmp.width = dst.width;
+    tmp.height = src.height;
+    tmp.px.resize((size_t)tmp.width * (size_t)tmp.height * 4);
+
+    auto horizontal = [&](int y) {
+        const float* s = src.row(y);
+        float* d = tmp.row(y);
+        for (int x = 0; x < dst.width; x++) {
+            F4 acc = f4Set1(0.0f);
+            const Tap* taps = tx.taps.data() + tx.first[(size_t)x];
+            for (int k = 0; k < tx.count[(size_t)x]; k++) {
+                acc = f4MulAdd(f4Load(s + (size_t)taps[k].index * 4), f4Set1(taps[k].weight), acc);
+            }
+            f4Store(d + (size_t)x * 4, acc);
+        }
+    };
+    parallelRows(jobs, src.height, horizontal);
+
+    auto vertical = [&](int y) {
+        float* d = dst.row(y);
+        const Tap* taps = ty.taps.data() + ty.first[(size_t)y];
+        const int n = ty.count[(size_t)y];
+        for (int x = 0; x < dst.width; x++) {
+            F4 acc = f4Set1(0.0f);
+            for (int k = 0; k < n; k++) {
+                acc = f4MulAdd(f4Load(tmp.row(taps[k].index) + (size_t)x * 4), f4Set1(taps[k].weight), acc);
+            }
+            f4Store(d + (size_t)x * 4, acc);
+        }
+    };
+    parallelRows(jobs, dst.height, vertical);
+}
+
+static void allocImage(FloatImage& img, int w, int h) {
+    img.width = w;
+    img.height = h;
+    img.px.resize((size_t)w * (size_t)h * 4);
+}
+
+} // namespace
+
+int g4f_mipgen_level_count(int width, int height) {
+    if (width <= 0 || height <= 0) return 0;
+    int levels = 1;
+    while (width > 1 || height > 1) {
+        width = width > 1 ? width >> 1 : 1;
+        height = height > 1 ? height >> 1 : 1;
+        levels++;
+    }
+    return levels;
+}
+
+void g4f_mipgen_level_size(int width, int height, int level, int* outWidth, int* outHeight) {
+    int w = width > 0 ? width : 0;
+    int h = height > 0 ? height : 0;
+    for (int i = 0; i < level && (w > 1 || h > 1); i++) {
+        w = w > 1 ? w >> 1 : 1;
+        h = h > 1 ? h >> 1 : 1;
+    }
+    if (outWidth) *outWidth = w;
+    if (outHeight) *outHeight = h;
+}
+
+size_t g4f_mipgen_chain_bytes(int width, int height, int levels) {
+    size_t total = 0;
+    for (int i = 0; i < levels; i++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, i, &w, &h);
+        total += (size_t)w * (size_t)h * 4;
+    }
+    return total;
+}
+
+int g4f_mipgen_downsample_rgba8(
+    const void* src, int srcWidth, int srcHeight, int srcPitchBytes,
+    void* dst, int dstWidth, int dstHeight, int dstPitchBytes,
+    int filter, int flags, g4f_jobs* jobs
+) {
+    if (!src || !dst) { g4f_set_last_error("g4f_mipgen_downsample_rgba8: invalid args"); return 0; }
+    if (srcWidth <= 0 || srcHeight <= 0 || dstWidth <= 0 || dstHeight <= 0) {
+        g4f_set_last_error("g4f_mipgen_downsample_rgba8: invalid size");
+        return 0;
+    }
+    if (srcPitchBytes <= 0) srcPitchBytes = srcWidth * 4;
+    if (dstPitchBytes <= 0) dstPitchBytes = dstWidth * 4;
+    if (srcPitchBytes < srcWidth * 4 || dstPitchBytes < dstWidth * 4) {
+        g4f_set_last_error("g4f_mipgen_downsample_rgba8: pitch too small");
+        return 0;
+    }
+
+    const bool linear = (flags & G4F_MIPGEN_FLAG_LINEAR) != 0;
+    FloatImage a, b;
+    allocImage(a, srcWidth, srcHeight);
+    allocImage(b, dstWidth, dstHeight);
+    decodeRgba8((const uint8_t*)src, srcPitchBytes, linear, jobs, a);
+    resample(a, b, filter, (flags & G4F_MIPGEN_FLAG_WRAP) != 0, jobs);
+    encodeRgba8(b, linear, jobs, (uint8_t*)dst, dstPitchBytes);
+    return 1;
+}
+
+int g4f_mipgen_build_chain_rgba8(
+    const void* src, int width, int height, int srcPitchBytes,
+    int levels, int filter, int flags, g4f_jobs* jobs, void* outChain
+) {
+    if (!src || !outChain) { g4f_set_last_error("g4f_mipgen_build_chain_rgba8: invalid args"); return 0; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_mipgen_build_chain_rgba8: invalid size"); return 0; }
+    if (srcPitchBytes <= 0) srcPitchBytes = width * 4;
+    if (srcPitchBytes < width * 4) { g4f_set_last_error("g4f_mipgen_build_chain_rgba8: pitch too small"); return 0; }
+
+    const int maxLevels = g4f_mipgen_level_count(width, height);
+    if (levels <= 0 || levels > maxLevels) levels = maxLevels;
+
+    uint8_t* out = (uint8_t*)outChain;
+    const uint8_t* s = (const uint8_t*)src;
+    for (int y = 0; y < height; y++) {
+        std::memcpy(out + (size_t)y * (size_t)width * 4, s + (size_t)y * (size_t)srcPitchBytes, (size_t)width * 4);
+    }
+    if (levels == 1) return 1;
+
+    const bool linear = (flags & G4F_MIPGEN_FLAG_LINEAR) != 0;
+    const bool wrap = (flags & G4F_MIPGEN_FLAG_WRAP) != 0;
+    FloatImage prev, next;
+    allocImage(prev, width, height);
+    decodeRgba8(s, srcPitchBytes, linear, jobs, prev);
+
+    size_t offset = (size_t)width * (size_t)height * 4;
+    for (int level = 1; level < levels; level++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, level, &w, &h);
+        allocImage(next, w, h);
+        resample(prev, next, filter, wrap, jobs);
+        encodeRgba8(next, linear, jobs, out + offset, w * 4);
+        offset += (size_t)w * (size_t)h * 4;
+        std::swap(prev, next);
+    }
+    return levels;
+}
@@ -0,0 +1,592 @@
+#include "../include/g4f/g4f_occlusion.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+constexpr int kTileSize = 32;         // pixels; a multiple of 4 so SIMD blocks never straddle tiles
+constexpr int kVertexChunk = 1024;    // vertices per transform work item
+constexpr int kTriangleChunk = 512;   // triangles per setup work item
+constexpr int kTestGrain = 256;       // boxes per test work item
+constexpr int kMaxFootprint = 4;      // texels per axis a box test reads at its pyramid level
+constexpr float kMinW = 1e-5f;
+constexpr float kGuardBand = 4.0f;    // clip to 4x the screen (in NDC) to keep edge math in range
+
+// Vertex outcodes: outside one clip plane each.
+enum : uint8_t {
+    kOutNear = 1,   // z < 0
+    kOutW = 2,      // w < kMinW
+    kOutRight = 4,  // x > w
+    kOutLeft = 8,   // x < -w
+    kOutTop = 16,   // y > w
+    kOutBottom = 32,
+    kOutGuardX = 64, // |x| > kGuardBand * w
+    kOutGuardY = 128,
+    kOutScreen = kOutNear | kOutW | kOutRight | kOutLeft | kOutTop | kOutBottom,
+    kOutClip = kOutNear | kOutW | kOutGuardX | kOutGuardY,
+};
+
+struct ClipVertex {
+    float x, y, z, w;
+};
+
+// Screen-space triangle: three edge functions a * (px - ox) + b * (py - oy) and the 1/w plane
+// za * px + zb * py + zc at pixel centers, plus the pixel bounding box (inclusive). Each edge is
+// measured from the same endpoint in both triangles sharing it, so their edge values are exact
+// negatives of each other and no pixel center along the edge falls between the two.
+struct Triangle {
+    float ea[3], eb[3], ox[3], oy[3];
+    float za, zb, zc;
+    int minX, minY, maxX, maxY;
+};
+
+struct Occluder {
+    g4f_occluder src;
+    g4f_mat4 mvp;
+    int vertexBase; // into the transformed vertex arrays
+};
+
+struct WorkItem {
+    int occluder;
+    int first;
+    int count;
+};
+
+// Per-worker triangle setups, binned by tile.
+struct WorkerBins {
+    std::vector<Triangle> triangles;
+    std::vector<std::vector<uint32_t>> tiles;
+    int rasterized = 0;
+    int binned = 0;
+};
+
+static const float* vertexAt(const g4f_occluder& o, int i) {
+    const int stride = o.positionStride > 0 ? o.positionStride : 12;
+    return reinterpret_cast<const float*>(static_cast<const uint8_t*>(o.positions) + (size_t)i * (size_t)stride);
+}
+
+} // namespace
+
+struct g4f_occlusion {
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    int tilesY = 0;
+    g4f_mat4 viewProj{};        // of the current depth pyramid
+    g4f_mat4 pendingViewProj{}; // of the occluders being queued
+
+    std::vector<Occluder> occluders;
+    int vertexTotal = 0;
+    int triangleTotal = 0;
+    std::vector<WorkItem> vertexItems;
+    std::vector<WorkItem> triangleItems;
+
+    // Transformed vertices (clip space) and their outcodes.
+    std::vector<ClipVertex> clip;
+    std::vector<uint8_t> outcode;
+
+    std::vector<WorkerBins> workers;
+
+    // Depth pyramid: level 0 is the depth buffer; each level keeps the minimum (farthest) 1/w of
+    // the 2x2 texels below it.
+    std::vector<std::vector<float>> levels;
+    std::vector<int> levelW;
+    std::vector<int> levelH;
+
+    g4f_occlusion_stats stats{};
+};
+
+namespace {
+
+static void transformJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    g4f_occlusion* occ = static_cast<g4f_occlusion*>(user);
+    for (int it = begin; it < end; it++) {
+        const WorkItem& item = occ->vertexItems[(size_t)it];
+        const Occluder& o = occ->occluders[(size_t)item.occluder];
+        const float* m = o.mvp.m;
+        const F4 m0 = f4Set1(m[0]), m1 = f4Set1(m[1]), m2 = f4Set1(m[2]), m3 = f4Set1(m[3]);
+        const F4 m4 = f4Set1(m[4]), m5 = f4Set1(m[5]), m6 = f4Set1(m[6]), m7 = f4Set1(m[7]);
+        const F4 m8 = f4Set1(m[8]), m9 = f4Set1(m[9]), m10 = f4Set1(m[10]), m11 = f4Set1(m[11]);
+        const F4 m12 = f4Set1(m[12]), m13 = f4Set1(m[13]), m14 = f4Set1(m[14]), m15 = f4Set1(m[15]);
+        const F4 zero = f4Set1(0.0f);
+        const F4 minW = f4Set1(kMinW);
+        const F4 guard = f4Set1(kGuardBand);
+        for (int v = 0; v < item.count; v += 4) {
+            const int lanes = std::min(4, item.count - v);
+            alignas(16) float px[4] = {}, py[4] = {}, pz[4] = {};
+            for (int l = 0; l < lanes; l++) {
+                const float* p = vertexAt(o.src, item.first + v + l);
+                px[l] = p[0];
+                py[l] = p[1];
+                pz[l] = p[2];
+            }
+            const F4 x = f4Load(px), y = f4Load(py), z = f4Load(pz);
+            const F4 cx = x * m0 + y * m4 + z * m8 + m12;
+            const F4 cy = x * m1 + y * m5 + z * m9 + m13;
+            const F4 cz = x * m2 + y * m6 + z * m10 + m14;
+            const F4 cw = x * m3 + y * m7 + z * m11 + m15;
+            const F4 gw = cw * guard;
+            const int near = f4MoveMask(f4Lt(cz, zero));
+            const int wlow = f4MoveMask(f4Lt(cw, minW));
+            const int right = f4MoveMask(f4Gt(cx, cw));
+            const int left = f4MoveMask(f4Lt(cx, zero - cw));
+            const int top = f4MoveMask(f4Gt(cy, cw));
+            const int bottom = f4MoveMask(f4Lt(cy, zero - cw));
+            const int gx = f4MoveMask(f4Or(f4Gt(cx, gw), f4Lt(cx, zero - gw)));
+            const int gy = f4MoveMask(f4Or(f4Gt(cy, gw), f4Lt(cy, zero - gw)));
+            alignas(16) float ox[4], oy[4], oz[4], ow[4];
+            f4Store(ox, cx);
+            f4Store(oy, cy);
+            f4Store(oz, cz);
+            f4Store(ow, cw);
+            const size_t base = (size_t)(o.vertexBase + item.first + v);
+            for (int l = 0; l < lanes; l++) {
+                occ->clip[base + (size_t)l] = ClipVertex{ox[l], oy[l], oz[l], ow[l]};
+                uint8_t code = 0;
+                if (near & (1 << l)) code |= kOutNear;
+                if (wlow & (1 << l)) code |= kOutW;
+                if (right & (1 << l)) code |= kOutRight;
+                if (left & (1 << l)) code |= kOutLeft;
+                if (top & (1 << l)) code |= kOutTop;
+                if (bottom & (1 << l)) code |= kOutBottom;
+                if (gx & (1 << l)) code |= kOutGuardX;
+                if (gy & (1 << l)) code |= kOutGuardY;
+                occ->outcode[base + (size_t)l] = code;
+            }
+        }
+    }
+}
+
+// Signed distance to clip plane `plane` (>= 0 inside).
+static float planeDistance(const ClipVertex& v, int plane) {
+    switch (plane) {
+    case 0: return v.z;
+    case 1: return v.w - kMinW;
+    case 2: return kGuardBand * v.w - v.x;
+    case 3: return kGuardBand * v.w + v.x;
+    case 4: return kGuardBand * v.w - v.y;
+    default: return kGuardBand * v.w + v.y;
+    }
+}
+
+// Sutherland-Hodgman against the planes selected by `codes`; returns the vertex count.
+static int clipPolygon(ClipVertex* poly, int count, uint8_t codes) {
+    ClipVertex tmp[9];
+    for (int plane = 0; plane < 6 && count > 0; plane++) {
+        const bool active = plane == 0 ? (codes & kOutNear) != 0 : plane == 1 ? (codes & kOutW) != 0 : plane < 4 ? (codes & kOutGuardX) != 0 : (codes & kOutGuardY) != 0;
+        if (!active) continue;
+        int out = 0;
+        for (int i = 0; i < count; i++) {
+            const ClipVertex& a = poly[i];
+            const ClipVertex& b = poly[(i + 1) % count];
+            const float da = planeDistance(a, plane);
+            const float db = planeDistance(b, plane);
+            if (da >= 0.0f) tmp[out++] = a;
+            if ((da >= 0.0f) != (db >= 0.0f)) {
+                const float t = da / (da - db);
+                tmp[out++] = ClipVertex{a.x + (b.x - a.x) * t, a.y + (b.y - a.y) * t, a.z + (b.z - a.z) * t, a.w + (b.w - a.w) * t};
+            }
+        }
+        count = out;
+        std::memcpy(poly, tmp, sizeof(ClipVertex) * (size_t)count);
+    }
+    return count;
+}
+
+// Projects, culls and bins one triangle whose vertices are all in front of the near plane and
+// inside the guard band.
+static void setupTriangle(g4f_occlusion* occ, WorkerBins& bins, const ClipVertex& v0, const ClipVertex& v1, const ClipVertex& v2, bool twoSided) {
+    const float hw = 0.5f * (float)occ->width;
+    const float hh = 0.5f * (float)occ->height;
+    float sx[3], sy[3], iz[3];
+    const ClipVertex* v[3] = {&v0, &v1, &v2};
+    for (int i = 0; i < 3; i++) {
+        iz[i] = 1.0f / v[i]->w;
+        sx[i] = (v[i]->x * iz[i] + 1.0f) * hw;
+        sy[i] = (1.0f - v[i]->y * iz[i]) * hh;
+    }
+    // Screen y points down, so clockwise (front-facing) triangles have positive area.
+    float area = (sx[1] - sx[0]) * (sy[2] - sy[0]) - (sx[2] - sx[0]) * (sy[1] - sy[0]);
+    if (!(area > 0.0f)) {
+        if (!twoSided || !(area < 0.0f)) return;
+        std::swap(sx[1], sx[2]);
+        std::swap(sy[1], sy[2]);
+        std::swap(iz[1], iz[2]);
+        area = -area;
+    }
+
+    // Pixels whose centers (px + 0.5) fall inside the bounds.
+    const float minSx = std::min(sx[0], std::min(sx[1], sx[2]));
+    const float maxSx = std::max(sx[0], std::max(sx[1], sx[2]));
+    const float minSy = std::min(sy[0], std::min(sy[1], sy[2]));
+    const float maxSy = std::max(sy[0], std::max(sy[1], sy[2]));
+    Triangle t;
+    t.minX = std::max(0, (int)std::ceil(minSx - 0.5f));
+    t.maxX = std::min(occ->width - 1, (int)std::floor(maxSx - 0.5f));
+    t.minY = std::max(0, (int)std::ceil(minSy - 0.5f));
+    t.maxY = std::min(occ->height - 1, (int)std::floor(maxSy - 0.5f));
+    if (t.minX > t.maxX || t.minY > t.maxY) return;
+
+    for (int i = 0; i < 3; i++) {
+        const int j = (i + 1) % 3;
+        t.ea[i] = sy[i] - sy[j];
+        t.eb[i] = sx[j] - sx[i];
+        const int o = (sx[i] < sx[j] || (sx[i] == sx[j] && sy[i] < sy[j])) ? i : j;
+        t.ox[i] = sx[o];
+        t.oy[i] = sy[o];
+    }
+    const float inv = 1.0f / area;
+    t.za = ((iz[1] - iz[0]) * (sy[2] - sy[0]) - (iz[2] - iz[0]) * (sy[1] - sy[0])) * inv;
+    t.zb = ((sx[1] - sx[0]) * (iz[2] - iz[0]) - (sx[2] - sx[0]) * (iz[1] - iz[0])) * inv;
+    t.zc = iz[0] - t.za * sx[0] - t.zb * sy[0];
+
+    const uint32_t index = (uint32_t)bins.triangles.size();
+    bins.triangles.push_back(t);
+    bins.rasterized++;
+    for (int ty = t.minY / kTileSize; ty <= t.maxY / kTileSize; ty++) {
+        for (int tx = t.minX / kTileSize; tx <= t.maxX / kTileSize; tx++) {
+            bins.tiles[(size_t)(ty * occ->tilesX + tx)].push_back(index);
+            bins.binned++;
+        }
+    }
+}
+
+static void setupJob(void* user, int begin, int end, int workerIndex) {
+    g4f_occlusion* occ = static_cast<g4f_occlusion*>(user);
+    WorkerBins& bins = occ->workers[(size_t)workerIndex];
+    for (int it = begin; it < end; it++) {
+        const WorkItem& item = occ->triangleItems[(size_t)it];
+        const Occluder& o = occ->occluders[(size_t)item.occluder];
+        const bool twoSided = o.src.twoSided != 0;
+        for (int tri = item.first; tri < item.first + item.count; tri++) {
+            uint32_t idx[3];
+            for (int k = 0; k < 3; k++) {
+                const size_t i = (size_t)tri * 3u + (size_t)k;
+                idx[k] = o.src.indices32 ? o.src.indices32[i] : (uint32_t)o.src.indices16[i];
+            }
+            if (idx[0] >= (uint32_t)o.src.vertexCount || idx[1] >= (uint32_t)o.src.vertexCount || idx[2] >= (uint32_t)o.src.vertexCount) continue;
+            const size_t base = (size_t)o.vertexBase;
+            const uint8_t c0 = occ->outcode[base + idx[0]];
+            const uint8_t c1 = occ->outcode[base + idx[1]];
+            const uint8_t c2 = occ->outcode[base + idx[2]];
+            if (c0 & c1 & c2 & kOutScreen) continue; // entirely outside one screen edge or the near plane
+            const ClipVertex& v0 = occ->clip[base + idx[0]];
+            const ClipVertex& v1 = occ->clip[base + idx[1]];
+            const ClipVertex& v2 = occ->clip[base + idx[2]];
+            const uint8_t any = (uint8_t)((c0 | c1 | c2) & kOutClip);
+            if (!any) {
+                setupTriangle(occ, bins, v0, v1, v2, twoSided);
+                continue;
+            }
+            ClipVertex poly[9] = {v0, v1, v2};
+            const int n = clipPolygon(poly, 3, any);
+            for (int k = 1; k + 1 < n; k++) setupTriangle(occ, bins, poly[0], poly[k], poly[k + 1], twoSided);
+        }
+    }
+}
+
+static void rasterizeTile(g4f_occlusion* occ, int tile) {
+    const int x0 = (tile % occ->tilesX) * kTileSize;
+    const int y0 = (tile / occ->tilesX) * kTileSize;
+    const int x1 = std::min(x0 + kTileSize, occ->width);
+    const int y1 = std::min(y0 + kTileSize, occ->height);
+    float* depth = occ->levels[0].data();
+    const int width = occ->width;
+    for (int y = y0; y < y1; y++) std::fill(depth + (size_t)y * (size_t)width + (size_t)x0, depth + (size_t)y * (size_t)width + (size_t)x1, 0.0f);
+
+    const F4 laneOffset = f4Set(0.5f, 1.5f, 2.5f, 3.5f);
+    const F4 zero = f4Set1(0.0f);
+    for (const WorkerBins& bins : occ->workers) {
+        for (uint32_t index : bins.tiles[(size_t)tile]) {
+            const Triangle& t = bins.triangles[index];
+            const int bx0 = std::max(t.minX, x0) & ~3; // tiles and the buffer width are multiples of 4
+            const int bx1 = std::min(t.maxX, x1 - 1);
+            const int by0 = std::max(t.minY, y0);
+            const int by1 = std::min(t.maxY, y1 - 1);
+            const F4 a0 = f4Set1(t.ea[0]), a1 = f4Set1(t.ea[1]), a2 = f4Set1(t.ea[2]);
+            const F4 ox0 = f4Set1(t.ox[0]), ox1 = f4Set1(t.ox[1]), ox2 = f4Set1(t.ox[2]);
+            const F4 za = f4Set1(t.za);
+            const F4 stepZ = f4Set1(4.0f * t.za);
+            for (int y = by0; y <= by1; y++) {
+                const float py = (float)y + 0.5f;
+                const F4 b0 = f4Set1(t.eb[0] * (py - t.oy[0]));
+                const F4 b1 = f4Set1(t.eb[1] * (py - t.oy[1]));
+                const F4 b2 = f4Set1(t.eb[2] * (py - t.oy[2]));
+                F4 z = za * (f4Set1((float)bx0) + laneOffset) + f4Set1(t.zb * py + t.zc);
+                float* row = depth + (size_t)y * (size_t)width;
+                for (int x = bx0; x <= bx1; x += 4) {
+                    // Evaluated from scratch (not stepped) so shared edges stay exact negatives.
+                    const F4 px = f4Set1((float)x) + laneOffset;
+                    const F4 e0 = a0 * (px - ox0) + b0;
+                    const F4 e1 = a1 * (px - ox1) + b1;
+                    const F4 e2 = a2 * (px - ox2) + b2;
+                    const F4 inside = f4And(f4Ge(e0, zero), f4And(f4Ge(e1, zero), f4Ge(e2, zero)));
+                    if (f4MoveMask(inside)) {
+                        const F4 old = f4Load(row + x);
+                        f4Store(row + x, f4Select(inside, f4Max(old, z), old));
+                    }
+                    z = z + stepZ;
+                }
+            }
+        }
+    }
+}
+
+static void rasterizeJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    g4f_occlusion* occ = static_cast<g4f_occlusion*>(user);
+    for (int tile = begin; tile < end; tile++) rasterizeTile(occ, tile);
+}
+
+static void buildPyramid(g4f_occlusion* occ) {
+    for (size_t l = 1; l < occ->levels.size(); l++) {
+        const std::vector<float>& src = occ->levels[l - 1];
+        std::vector<float>& dst = occ->levels[l];
+        const int sw = occ->levelW[l - 1], sh = occ->levelH[l - 1];
+        const int dw = occ->levelW[l], dh = occ->levelH[l];
+        for (int y = 0; y < dh; y++) {
+            const float* r0 = src.data() + (size_t)std::min(2 * y, sh - 1) * (size_t)sw;
+            const float* r1 = src.data() + (size_t)std::min(2 * y + 1, sh - 1) * (size_t)sw;
+            float* out = dst.data() + (size_t)y * (size_t)dw;
+            for (int x = 0; x < dw; x++) {
+                const int xa = std::min(2 * x, sw - 1);
+                const int xb = std::min(2 * x + 1, sw - 1);
+                out[x] = std::min(std::min(r0[xa], r0[xb]), std::min(r1[xa], r1[xb]));
+            }
+        }
+    }
+}
+
+static int testBox(const g4f_occlusion* occ, const g4f_aabb& box, const g4f_mat4* model) {
+    g4f_mat4 mvp;
+    if (model) {
+        mat4Mul(model->m, occ->viewProj.m, mvp.m);
+    } else {
+        mvp = occ->viewProj;
+    }
+    const float* m = mvp.m;
+    const F4 zero = f4Set1(0.0f);
+    const F4 bx = f4Set(box.min.x, box.max.x, box.min.x, box.max.x);
+    const F4 by = f4Set(box.min.y, box.min.y, box.max.y, box.max.y);
+    const F4 hw = f4Set1(0.5f * (float)occ->width);
+    const F4 hh = f4Set1(0.5f * (float)occ->height);
+    const F4 one = f4Set1(1.0f);
+    F4 minX = f4Set1(1e30f), maxX = f4Set1(-1e30f), minY = f4Set1(1e30f), maxY = f4Set1(-1e30f);
+    F4 nearest = zero;
+    int behind = 0;
+    for (int half = 0; half < 2; half++) {
+        const F4 bz = f4Set1(half ? box.max.z : box.min.z);
+        const F4 cx = bx * f4Set1(m[0]) + by * f4Set1(m[4]) + bz * f4Set1(m[8]) + f4Set1(m[12]);
+        const F4 cy = bx * f4Set1(m[1]) + by * f4Set1(m[5]) + bz * f4Set1(m[9]) + f4Set1(m[13]);
+        const F4 cz = bx * f4Set1(m[2]) + by * f4Set1(m[6]) + bz * f4Set1(m[10]) + f4Set1(m[14]);
+        const F4 cw = bx * f4Set1(m[3]) + by * f4Set1(m[7]) + bz * f4Set1(m[11]) + f4Set1(m[15]);
+        behind |= f4MoveMask(f4Or(f4Lt(cz, zero), f4Lt(cw, f4Set1(kMinW)))) << (half * 4);
+        const F4 iw = one / f4Max(cw, f4Set1(kMinW));
+        const F4 sx = (cx * iw + one) * hw;
+        const F4 sy = (one - cy * iw) * hh;
+        minX = f4Min(minX, sx);
+        maxX = f4Max(maxX, sx);
+        minY = f4Min(minY, sy);
+        maxY = f4Max(maxY, sy);
+        nearest = f4Max(nearest, iw);
+    }
+    if (behind == 0xFF) return 0; // entirely in front of the near plane
+    if (behind) return 1;         // crosses it: no reliable footprint
+
+    float lo[2] = {1e30f, 1e30f}, hi[2] = {-1e30f, -1e30f}, zNear = 0.0f;
+    for (int i = 0; i < 4; i++) {
+        lo[0] = std::min(lo[0], f4Lane(minX, i));
+        hi[0] = std::max(hi[0], f4Lane(maxX, i));
+        lo[1] = std::min(lo[1], f4Lane(minY, i));
+        hi[1] = std::max(hi[1], f4Lane(maxY, i));
+        zNear = std::max(zNear, f4Lane(nearest, i));
+    }
+    if (hi[0] < 0.0f || hi[1] < 0.0f || lo[0] > (float)occ->width || lo[1] > (float)occ->height) return 0;
+
+    // Every pixel the footprint touches.
+    const int px0 = std::max(0, (int)std::floor(lo[0]));
+    const int py0 = std::max(0, (int)std::floor(lo[1]));
+    const int px1 = std::min(occ->width - 1, (int)std::ceil(hi[0]) - 1);
+    const int py1 = std::min(occ->height - 1, (int)std::ceil(hi[1]) - 1);
+    if (px1 < px0 || py1 < py0) return 0;
+
+    int level = 0;
+    const int last = (int)occ->levels.size() - 1;
+    while (level < last && ((px1 >> level) - (px0 >> level) >= kMaxFootprint || (py1 >> level) - (py0 >> level) >= kMaxFootprint)) level++;
+    const float* texels = occ->levels[(size_t)level].data();
+    const int lw = occ->levelW[(size_t)level];
+    for (int y = py0 >> level; y <= (py1 >> level); y++) {
+        const float* row = texels + (size_t)y * (size_t)lw;
+        for (int x = px0 >> level; x <= (px1 >> level); x++) {
+            if (row[x] <= zNear) return 1; // the farthest occluder here is not in front of the box
+        }
+    }
+    return 0;
+}
+
+struct TestJob {
+    const g4f_occlusion* occ;
+    const g4f_aabb* boxes;
+    const g4f_mat4* models;
+    uint8_t* out;
+};
+
+static void testJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    const TestJob* job = static_cast<const TestJob*>(user);
+    for (int i = begin; i < end; i++) job->out[i] = (uint8_t)testBox(job->occ, job->boxes[i], job->models ? &job->models[i] : nullptr);
+}
+
+} // namespace
+
+g4f_occlusion_desc g4f_occlusion_desc_default(void) {
+    g4f_occlusion_desc d{};
+    d.width = 320;
+    d.height = 192;
+    return d;
+}
+
+g4f_occlusion* g4f_occlusion_create(const g4f_occlusion_desc* desc) {
+    g4f_occlusion_desc d = desc ? *desc : g4f_occlusion_desc_default();
+    if (d.width <= 0) d.width = 320;
+    if (d.height <= 0) d.height = 192;
+    if (d.width > 8192 || d.height > 8192) {
+        g4f_set_last_error("g4f_occlusion_create: depth buffer too large");
+        return nullptr;
+    }
+    auto* occ = new g4f_occlusion();
+    occ->width = (d.width + 7) & ~7;
+    occ->height = (d.height + 7) & ~7;
+    occ->tilesX = (occ->width + kTileSize - 1) / kTileSize;
+    occ->tilesY = (occ->height + kTileSize - 1) / kTileSize;
+    int w = occ->width, h = occ->height;
+    for (;;) {
+        occ->levels.emplace_back((size_t)w * (size_t)h, 0.0f);
+        occ->levelW.push_back(w);
+        occ->levelH.push_back(h);
+        if (w == 1 && h == 1) break;
+        w = (w + 1) / 2;
+        h = (h + 1) / 2;
+    }
+    occ->viewProj = g4f_mat4_identity();
+    occ->pendingViewProj = occ->viewProj;
+    return occ;
+}
+
+void g4f_occlusion_destroy(g4f_occlusion* occ) {
+    delete occ;
+}
+
+void g4f_occlusion_begin(g4f_occlusion* occ, const g4f_mat4* viewProj) {
+    if (!occ) return;
+    occ->occluders.clear();
+    occ->vertexTotal = 0;
+    occ->triangleTotal = 0;
+    occ->pendingViewProj = viewProj ? *viewProj : g4f_mat4_identity();
+}
+
+int g4f_occlusion_add(g4f_occlusion* occ, const g4f_occluder* occluder) {
+    if (!occ || !occluder || !occluder->positions || occluder->vertexCount <= 0 || occluder->indexCount < 0 || occluder->indexCount % 3 != 0) {
+        g4f_set_last_error("g4f_occlusion_add: invalid args");
+        return 0;
+    }
+    if (occluder->indexCount > 0 && !occluder->indices32 && !occluder->indices16) {
+        g4f_set_last_error("g4f_occlusion_add: missing indices");
+        return 0;
+    }
+    if (occluder->positionStride != 0 && occluder->positionStride < 12) {
+        g4f_set_last_error("g4f_occlusion_add: positionStride must be 0 or >= 12");
+        return 0;
+    }
+    if ((long long)occ->vertexTotal + occluder->vertexCount > 0x7FFFFFFF) {
+        g4f_set_last_error("g4f_occlusion_add: too many occluder vertices");
+        return 0;
+    }
+    Occluder o;
+    o.src = *occluder;
+    o.src.model = nullptr;
+    if (occluder->model) {
+        mat4Mul(occluder->model->m, occ->pendingViewProj.m, o.mvp.m);
+    } else {
+        o.mvp = occ->pendingViewProj;
+    }
+    o.vertexBase = occ->vertexTotal;
+    occ->vertexTotal += occluder->vertexCount;
+    occ->triangleTotal += occluder->indexCount / 3;
+    occ->occluders.push_back(o);
+    return 1;
+}
+
+void g4f_occlusion_end(g4f_occlusion* occ, g4f_jobs* jobs) {
+    if (!occ) return;
+    occ->viewProj = occ->pendingViewProj;
+
+    occ->vertexItems.clear();
+    occ->triangleItems.clear();
+    for (int i = 0; i < (int)occ->occluders.size(); i++) {
+        const Occluder& o = occ->occluders[(size_t)i];
+        for (int v = 0; v < o.src.vertexCount; v += kVertexChunk) occ->vertexItems.push_back(WorkItem{i, v, std::min(kVertexChunk, o.src.vertexCount - v)});
+        const int triangles = o.src.indexCount / 3;
+        for (int t = 0; t < triangles; t += kTriangleChunk) occ->triangleItems.push_back(WorkItem{i, t, std::min(kTriangleChunk, triangles - t)});
+    }
+    occ->clip.resize((size_t)occ->vertexTotal);
+    occ->outcode.resize((size_t)occ->vertexTotal);
+
+    const int tileCount = occ->tilesX * occ->tilesY;
+    occ->workers.resize((size_t)g4f_jobs_thread_count(jobs));
+    for (WorkerBins& bins : occ->workers) {
+        bins.triangles.clear();
+        bins.tiles.resize((size_t)tileCount);
+        for (std::vector<uint32_t>& tile : bins.tiles) tile.clear();
+        bins.rasterized = 0;
+        bins.binned = 0;
+    }
+
+    if (!occ->vertexItems.empty()) g4f_jobs_parallel_for(jobs, (int)occ->vertexItems.size(), 1, transformJob, occ);
+    if (!occ->triangleItems.empty()) g4f_jobs_parallel_for(jobs, (int)occ->triangleItems.size(), 1, setupJob, occ);
+    g4f_jobs_parallel_for(jobs, tileCount, 1, rasterizeJob, occ);
+    buildPyramid(occ);
+
+    occ->stats = g4f_occlusion_stats{};
+    occ->stats.occluders = (int)occ->occluders.size();
+    occ->stats.triangles = occ->triangleTotal;
+    occ->stats.tiles = tileCount;
+    for (const WorkerBins& bins : occ->workers) {
+        occ->stats.rasterized += bins.rasterized;
+        occ->stats.binned += bins.binned;
+    }
+}
+
+int g4f_occlusion_test_box(const g4f_occlusion* occ, const g4f_aabb* box, const g4f_mat4* model) {
+    if (!occ || !box) return 1;
+    return testBox(occ, *box, model);
+}
+
+int g4f_occlusion_test_boxes(const g4f_occlusion* occ, const g4f_aabb* boxes, const g4f_mat4* models, int count, uint8_t* outVisible, g4f_jobs* jobs) {
+    if (!occ || !boxes || !outVisible || count <= 0) return 0;
+    TestJob job{occ, boxes, models, outVisible};
+    g4f_jobs_parallel_for(jobs, count, kTestGrain, testJob, &job);
+    int visible = 0;
+    for (int i = 0; i < count; i++) visible += outVisible[i];
+    return visible;
+}
+
+const float* g4f_occlusion_depth(const g4f_occlusion* occ, int* width, int* height) {
+    if (width) *width = occ ? occ->width : 0;
+    if (height) *height = occ ? occ->height : 0;
+    return occ ? occ->levels[0].data() : nullptr;
+}
+
+void g4f_occlusion_get_stats(const g4f_occlusion* occ, g4f_occlusion_stats* out) {
+    if (!out) return;
+    *out = occ ? occ->stats : g4f_occlusion_stats{};
+}
@@ -0,0 +1,483 @@
+#include "../include/g4f/g4f_pack.h"
+#include "../include/g4f/g4f_mipgen.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_file_map_internal.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <system_error>
+#include <unordered_set>
+#include <vector>
+
+static_assert(std::endian::native == std::endian::little, "g4f packs are stored little-endian");
+
+namespace {
+
+constexpr char kMagic[8] = {'G', '4', 'F', 'P', 'A', 'C', 'K', '\0'};
+constexpr uint32_t kFormatVersion = 1;
+constexpr uint64_t kBlobAlign = 64;
+constexpr int kMaxNameLength = 4095;
+constexpr int kMaxTextureSize = 16384;
+
+struct PackHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t entryCount;
+    uint64_t tocOffset;
+    uint64_t namesOffset;
+    uint64_t namesSize;
+    uint64_t fileSize;
+    uint64_t checksum; // FNV-1a over the table of contents and the name table
+    uint64_t reserved;
+};
+
+struct PackTocEntry {
+    uint64_t nameHash;
+    uint32_t nameOffset;
+    uint32_t nameLength;
+    uint32_t type;
+    uint32_t format;
+    uint64_t dataOffset;
+    uint64_t dataSize;
+    uint32_t params[4]; // mesh: vertexCount, indexCount, indexOffset; texture: width, height, mipLevels
+    uint64_t reserved;
+};
+
+static_assert(sizeof(PackHeader) == 64, "pack header layout");
+static_assert(sizeof(PackTocEntry) == 64, "pack toc entry layout");
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+static uint64_t alignUp(uint64_t v, uint64_t a) { return (v + a - 1) / a * a; }
+
+static bool tocLess(uint64_t hashA, const char* nameA, uint64_t hashB, const char* nameB) {
+    if (hashA != hashB) return hashA < hashB;
+    return std::strcmp(nameA, nameB) < 0;
+}
+
+static int blockBytes(int format) {
+    switch (format) {
+    case G4F_PACK_FORMAT_BC1: return 8;
+    case G4F_PACK_FORMAT_BC3:
+    case G4F_PACK_FORMAT_BC7: return 16;
+    default: return 0;
+    }
+}
+
+static bool validFormat(int format) { return format >= G4F_PACK_FORMAT_RGBA8 && format <= G4F_PACK_FORMAT_BC7; }
+
+static size_t levelBytes(int format, int w, int h, int* outRowPitch) {
+    if (format == G4F_PACK_FORMAT_RGBA8) {
+        if (outRowPitch) *outRowPitch = w * 4;
+        return (size_t)w * (size_t)h * 4;
+    }
+    const int bw = (w + 3) / 4, bh = (h + 3) / 4;
+    if (outRowPitch) *outRowPitch = bw * blockBytes(format);
+    return (size_t)bw * (size_t)bh * (size_t)blockBytes(format);
+}
+
+// Shared by the writer and the reader so both accept exactly the same textures.
+static bool validTexture(int format, int width, int height, int mipLevels) {
+    if (!validFormat(format) || width <= 0 || height <= 0 || width > kMaxTextureSize || height > kMaxTextureSize) return false;
+    if (blockBytes(format) && ((width & 3) || (height & 3))) return false;
+    return mipLevels >= 1 && mipLevels <= g4f_mipgen_level_count(width, height);
+}
+
+static bool validName(const char* name) {
+    return name && name[0] && std::strlen(name) <= (size_t)kMaxNameLength;
+}
+
+struct WriterEntry {
+    std::string name;
+    uint64_t hash = 0;
+    uint32_t type = 0;
+    uint32_t format = 0;
+    uint32_t params[4] = {};
+    std::vector<uint8_t> data;
+};
+
+} // namespace
+
+struct g4f_pack {
+    g4f_file_map map; // empty for g4f_pack_open_memory
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+    std::vector<PackTocEntry> toc; // copied: the mapping may not be 8-byte aligned in memory
+    const char* names = nullptr;
+};
+
+struct g4f_pack_writer {
+    std::vector<WriterEntry> entries;
+    std::unordered_set<std::string> names;
+};
+
+size_t g4f_pack_texture_bytes(int format, int width, int height, int mipLevels) {
+    if (!validTexture(format, width, height, mipLevels)) return 0;
+    size_t total = 0;
+    for (int i = 0; i < mipLevels; i++) {
+        int w = 0, h = 0;
+        g4f_mipgen_level_size(width, height, i, &w, &h);
+        total += levelBytes(format, w, h, nullptr);
+    }
+    return total;
+}
+
+// Every index must name a vertex; the layout check has already bounded the index array.
+static bool indicesInRange(const uint8_t* indices, uint32_t indexCount, uint32_t vertexCount) {
+    uint16_t maxIndex = 0;
+    for (uint32_t i = 0; i < indexCount; i++) {
+        uint16_t index;
+        std::memcpy(&index, indices + (size_t)i * sizeof(uint16_t), sizeof(index));
+        maxIndex = index > maxIndex ? index : maxIndex;
+    }
+    return maxIndex < vertexCount;
+}
+
+static bool packValidate(g4f_pack* pack, const char* fn) {
+    PackHeader header{};
+    if (pack->size < sizeof(header)) {
+        g4f_set_last_errorf("%s: file too small", fn);
+        return false;
+    }
+    std::memcpy(&header, pack->base, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0) {
+        g4f_set_last_errorf("%s: not a pack file", fn);
+        return false;
+    }
+    if (header.version != kFormatVersion) {
+        g4f_set_last_errorf("%s: unsupported version %u", fn, header.version);
+        return false;
+    }
+    const uint64_t size = pack->size;
+    const uint64_t tocBytes = (uint64_t)header.entryCount * sizeof(PackTocEntry);
+    if (header.fileSize != size || header.tocOffset > size || tocBytes > size - header.tocOffset || header.namesOffset > size ||
+        header.namesSize > size - header.namesOffset) {
+        g4f_set_last_errorf("%s: truncated or corrupt header", fn);
+        return false;
+    }
+    uint64_t checksum = fnv1a(kFnvOffset, pack->base + header.tocOffset, (size_t)tocBytes);
+    checksum = fnv1a(checksum, pack->base + header.namesOffset, (size_t)header.namesSize);
+    if (checksum != header.checksum) {
+        g4f_set_last_errorf("%s: table of contents checksum mismatch", fn);
+        return false;
+    }
+
+    pack->toc.resize(header.entryCount);
+    if (tocBytes) std::memcpy(pack->toc.data(), pack->base + header.tocOffset, (size_t)tocBytes);
+    pack->names = (const char*)pack->base + header.namesOffset;
+    for (size_t i = 0; i < pack->toc.size(); i++) {
+        const PackTocEntry& e = pack->toc[i];
+        const char* name = pack->names + e.nameOffset;
+        if ((uint64_t)e.nameOffset + e.nameLength >= header.namesSize || e.nameLength == 0 || e.nameLength > (uint32_t)kMaxNameLength ||
+            name[e.nameLength] != '\0' || std::memchr(name, 0, e.nameLength) || fnv1a(kFnvOffset, name, e.nameLength) != e.nameHash) {
+            g4f_set_last_errorf("%s: entry %zu has an invalid name", fn, i);
+            return false;
+        }
+        if (i > 0 && !tocLess(pack->toc[i - 1].nameHash, pack->names + pack->toc[i - 1].nameOffset, e.nameHash, name)) {
+            g4f_set_last_errorf("%s: entries are not sorted or not unique ('%s')", fn, name);
+            return false;
+        }
+        if (e.dataOffset % kBlobAlign != 0 || e.dataOffset > size || e.dataSize > size - e.dataOffset) {
+            g4f_set_last_errorf("%s: '%s' lies outside the file", fn, name);
+            return false;
+        }
+        bool ok = false;
+        if (e.type == G4F_PACK_ENTRY_BLOB) {
+            ok = e.format == 0;
+        } else if (e.type == G4F_PACK_ENTRY_MESH) {
+            const uint64_t vertexBytes = (uint64_t)e.params[0] * sizeof(g4f_gfx_vertex_p3n3uv2);
+            ok = e.format == 0 && e.params[0] >= 1 && e.params[0] <= 65536 && e.params[1] >= 3 && e.params[1] % 3 == 0 &&
+                 e.params[2] % 16 == 0 && e.params[2] >= vertexBytes && e.params[2] <= e.dataSize &&
+                 (uint64_t)e.params[1] * sizeof(uint16_t) <= e.dataSize - e.params[2];
+        } else if (e.type == G4F_PACK_ENTRY_TEXTURE) {
+            ok = e.params[0] <= (uint32_t)kMaxTextureSize && e.params[1] <= (uint32_t)kMaxTextureSize && e.params[2] <= 32 &&
+                 validTexture((int)e.format, (int)e.params[0], (int)e.params[1], (int)e.params[2]) &&
+                 e.dataSize == g4f_pack_texture_bytes((int)e.format, (int)e.params[0], (int)e.params[1], (int)e.params[2]);
+        }
+        if (!ok) {
+            g4f_set_last_errorf("%s: '%s' has an invalid layout", fn, name);
+            return false;
+        }
+        if (e.type == G4F_PACK_ENTRY_MESH && !indicesInRange(pack->base + e.dataOffset + e.params[2], e.params[1], e.params[0])) {
+            g4f_set_last_errorf("%s: '%s' has an index out of range", fn, name);
+            return false;
+        }
+    }
+    return true;
+}
+
+g4f_pack* g4f_pack_open(const char* pathUtf8) {
+    auto* pack = new g4f_pack();
+    if (!g4f_file_map_open(&pack->map, pathUtf8, "g4f_pack_open")) {
+        delete pack;
+        return nullptr;
+    }
+    pack->base = (const uint8_t*)pack->map.data;
+    pack->size = pack->map.size;
+    if (!packValidate(pack, "g4f_pack_open")) {
+        g4f_pack_close(pack);
+        return nullptr;
+    }
+    return pack;
+}
+
+g4f_pack* g4f_pack_open_memory(const void* data, size_t size) {
+    if (!data && size) {
+        g4f_set_last_error("g4f_pack_open_memory: data is null");
+        return nullptr;
+    }
+    auto* pack = new g4f_pack();
+    pack->base = (const uint8_t*)data;
+    pack->size = size;
+    if (!packValidate(pack, "g4f_pack_open_memory")) {
+        delete pack;
+        return nullptr;
+    }
+    return pack;
+}
+
+void g4f_pack_close(g4f_pack* pack) {
+    if (!pack) return;
+    g4f_file_map_close(&pack->map);
+    delete pack;
+}
+
+int g4f_pack_entry_count(const g4f_pack* pack) { return pack ? (int)pack->toc.size() : 0; }
+
+int g4f_pack_find(const g4f_pack* pack, const char* name) {
+    if (!pack || !name) return -1;
+    const uint64_t hash = fnv1a(kFnvOffset, name, std::strlen(name));
+    auto it = std::lower_bound(pack->toc.begin(), pack->toc.end(), hash, [](const PackTocEntry& e, uint64_t h) { return e.nameHash < h; });
+    for (; it != pack->toc.end() && it->nameHash == hash; ++it) {
+        if (std::strcmp(pack->names + it->nameOffset, name) == 0) return (int)(it - pack->toc.begin());
+    }
+    return -1;
+}
+
+int g4f_pack_get(const g4f_pack* pack, int index, g4f_pack_entry* out) {
+    if (!pack || !out || index < 0 || index >= (int)pack->toc.size()) return 0;
+    const PackTocEntry& e = pack->toc[(size_t)index];
+    *out = g4f_pack_entry{};
+    out->name = pack->names + e.nameOffset;
+    out->type = (int)e.type;
+    out->data = pack->base + e.dataOffset;
+    out->size = (size_t)e.dataSize;
+    if (e.type == G4F_PACK_ENTRY_MESH) {
+        out->vertices = (const g4f_gfx_vertex_p3n3uv2*)out->data;
+        out->vertexCount = (int)e.params[0];
+        out->indices = (const uint16_t*)(pack->base + e.dataOffset + e.params[2]);
+        out->indexCount = (int)e.params[1];
+    } else if (e.type == G4F_PACK_ENTRY_TEXTURE) {
+        out->format = (int)e.format;
+        out->width = (int)e.params[0];
+        out->height = (int)e.params[1];
+        out->mipLevels = (int)e.params[2];
+    }
+    return 1;
+}
+
+const void* g4f_pack_texture_level(const g4f_pack_entry* entry, int level, int* outWidth, int* outHeight, int* outRowPitchBytes, size_t* outBytes) {
+    if (!entry || entry->type != G4F_PACK_ENTRY_TEXTURE || !entry->data || level < 0 || level >= entry->mipLevels) return nullptr;
+    size_t offset = 0;
+    for (int i = 0;; i++) {
+        int w = 0, h = 0, pitch = 0;
+        g4f_mipgen_level_size(entry->width, entry->height, i, &w, &h);
+        const size_t bytes = levelBytes(entry->format, w, h, &pitch);
+        if (i == level) {
+            if (outWidth) *outWidth = w;
+            if (outHeight) *outHeight = h;
+            if (outRowPitchBytes) *outRowPitchBytes = pitch;
+            if (outBytes) *outBytes = bytes;
+            return (const uint8_t*)entry->data + offset;
+        }
+        offset += bytes;
+    }
+}
+
+g4f_pack_writer* g4f_pack_writer_create(void) { return new g4f_pack_writer(); }
+
+void g4f_pack_writer_destroy(g4f_pack_writer* writer) { delete writer; }
+
+static WriterEntry* writerAdd(g4f_pack_writer* writer, const char* name, const char* fn) {
+    if (!writer || !validName(name)) {
+        g4f_set_last_errorf("%s: invalid writer or name", fn);
+        return nullptr;
+    }
+    if (!writer->names.insert(name).second) {
+        g4f_set_last_errorf("%s: duplicate name '%s'", fn, name);
+        return nullptr;
+    }
+    writer->entries.emplace_back();
+    WriterEntry& e = writer->entries.back();
+    e.name = name;
+    e.hash = fnv1a(kFnvOffset, name, e.name.size());
+    return &e;
+}
+
+int g4f_pack_writer_add_blob(g4f_pack_writer* writer, const char* name, const void* data, size_t size) {
+    if (!data && size) {
+        g4f_set_last_error("g4f_pack_writer_add_blob: data is null");
+        return 0;
+    }
+    WriterEntry* e = writerAdd(writer, name, "g4f_pack_writer_add_blob");
+    if (!e) return 0;
+    e->type = G4F_PACK_ENTRY_BLOB;
+    e->data.assign((const uint8_t*)data, (const uint8_t*)data + size);
+    return 1;
+}
+
+int g4f_pack_writer_add_mesh(g4f_pack_writer* writer, const char* name, const g4f_gfx_vertex_p3n3uv2* vertices, int vertexCount, const uint16_t* indices, int indexCount) {
+    if (!vertices || !indices || vertexCount <= 0 || vertexCount > 65536 || indexCount <= 0 || indexCount % 3 != 0) {
+        g4f_set_last_error("g4f_pack_writer_add_mesh: invalid mesh");
+        return 0;
+    }
+    for (int i = 0; i < indexCount; i++) {
+        if (indices[i] >= vertexCount) {
+            g4f_set_last_error("g4f_pack_writer_add_mesh: index out of range");
+            return 0;
+        }
+    }
+    WriterEntry* e = writerAdd(writer, name, "g4f_pack_writer_add_mesh");
+    if (!e) return 0;
+    const size_t vertexBytes = sizeof(g4f_gfx_vertex_p3n3uv2) * (size_t)vertexCount;
+    const size_t indexOffset = (size_t)alignUp(vertexBytes, 16);
+    e->type = G4F_PACK_ENTRY_MESH;
+    e->params[0] = (uint32_t)vertexCount;
+    e->params[1] = (uint32_t)indexCount;
+    e->params[2] = (uint32_t)indexOffset;
+    e->data.assign(indexOffset + sizeof(uint16_t) * (size_t)indexCount, 0);
+    std::memcpy(e->data.data(), vertices, vertexBytes);
+    std::memcpy(e->data.data() + indexOffset, indices, sizeof(uint16_t) * (size_t)indexCount);
+    return 1;
+}
+
+int g4f_pack_writer_add_texture(g4f_pack_writer* writer, const char* name, int format, int width, int height, int mipLevels, const void* data, size_t size) {
+    const size_t expected = g4f_pack_texture_bytes(format, width, height, mipLevels);
+    if (!data || expected == 0 || size != expected) {
+        g4f_set_last_error("g4f_pack_writer_add_texture: invalid format, size or level data");
+        return 0;
+    }
+    WriterEntry* e = writerAdd(writer, name, "g4f_pack_writer_add_texture");
+    if (!e) return 0;
+    e->type = G4F_PACK_ENTRY_TEXTURE;
+    e->format = (uint32_t)format;
+    e->params[0] = (uint32_t)width;
+    e->params[1] = (uint32_t)height;
+    e->params[2] = (uint32_t)mipLevels;
+    e->data.assign((const uint8_t*)data, (const uint8_t*)data + size);
+    return 1;
+}
+
+int g4f_pack_writer_add_texture_rgba8(g4f_pack_writer* writer, const char* name, int width, int height, const void* rgbaPixels, int rowPitchBytes,
+                                      int mipLevels, int mipFilter, int mipFlags, g4f_jobs* jobs) {
+    if (!rgbaPixels || !validTexture(G4F_PACK_FORMAT_RGBA8, width, height, 1) || mipLevels < 0) {
+        g4f_set_last_error("g4f_pack_writer_add_texture_rgba8: invalid texture");
+        return 0;
+    }
+    const int full = g4f_mipgen_level_count(width, height);
+    const int levels = mipLevels == 0 || mipLevels > full ? full : mipLevels;
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(width, height, levels));
+    if (g4f_mipgen_build_chain_rgba8(rgbaPixels, width, height, rowPitchBytes, levels, mipFilter, mipFlags, jobs, chain.data()) != levels) return 0;
+    WriterEntry* e = writerAdd(writer, name, "g4f_pack_writer_add_texture_rgba8");
+    if (!e) return 0;
+    e->type = G4F_PACK_ENTRY_TEXTURE;
+    e->format = G4F_PACK_FORMAT_RGBA8;
+    e->params[0] = (uint32_t)width;
+    e->params[1] = (uint32_t)height;
+    e->params[2] = (uint32_t)levels;
+    e->data = std::move(chain);
+    return 1;
+}
+
+int g4f_pack_writer_save(const g4f_pack_writer* writer, const char* pathUtf8) {
+    if (!writer || !pathUtf8 || !pathUtf8[0]) {
+        g4f_set_last_error("g4f_pack_writer_save: invalid args");
+        return 0;
+    }
+    std::vector<const WriterEntry*> order;
+    order.reserve(writer->entries.size());
+    for (const WriterEntry& e : writer->entries) order.push_back(&e);
+    std::sort(order.begin(), order.end(), [](const WriterEntry* a, const WriterEntry* b) { return tocLess(a->hash, a->name.c_str(), b->hash, b->name.c_str()); });
+
+    std::vector<PackTocEntry> toc(order.size());
+    std::string names;
+    for (size_t i = 0; i < order.size(); i++) {
+        toc[i].nameHash = order[i]->hash;
+        toc[i].nameOffset = (uint32_t)names.size();
+        toc[i].nameLength = (uint32_t)order[i]->name.size();
+        names += order[i]->name;
+        names += '\0';
+    }
+    PackHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.entryCount = (uint32_t)order.size();
+    header.tocOffset = sizeof(PackHeader);
+    header.namesOffset = header.tocOffset + sizeof(PackTocEntry) * toc.size();
+    header.namesSize = names.size();
+    uint64_t offset = alignUp(header.namesOffset + header.namesSize, kBlobAlign);
+    for (size_t i = 0; i < order.size(); i++) {
+        const WriterEntry& e = *order[i];
+        toc[i].type = e.type;
+        toc[i].format = e.format;
+        std::memcpy(toc[i].params, e.params, sizeof(e.params));
+        toc[i].dataOffset = offset;
+        toc[i].dataSize = e.data.size();
+        offset = alignUp(offset + e.data.size(), kBlobAlign);
+    }
+    header.fileSize = order.empty() ? header.namesOffset + header.namesSize : toc.back().dataOffset + toc.back().dataSize;
+    header.checksum = fnv1a(fnv1a(kFnvOffset, toc.data(), sizeof(PackTocEntry) * toc.size()), names.data(), names.size());
+
+    const std::filesystem::path finalPath(std::u8string((const char8_t*)pathUtf8));
+    std::filesystem::path tmpPath = finalPath;
+    tmpPath += ".tmp";
+    std::error_code ec;
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            g4f_set_last_error("g4f_pack_writer_save: cannot open temporary file");
+            return 0;
+        }
+        static const char zeros[kBlobAlign] = {};
+        uint64_t written = 0;
+        auto write = [&](const void* p, uint64_t n) {
+            out.write((const char*)p, (std::streamsize)n);
+            written += n;
+        };
+        write(&header, sizeof(header));
+        write(toc.data(), sizeof(PackTocEntry) * toc.size());
+        write(names.data(), names.size());
+        for (size_t i = 0; i < order.size(); i++) {
+            write(zeros, toc[i].dataOffset - written);
+            write(order[i]->data.data(), order[i]->data.size());
+        }
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            g4f_set_last_error("g4f_pack_writer_save: write failed");
+            return 0;
+        }
+    }
+    std::filesystem::rename(tmpPath, finalPath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        g4f_set_last_error("g4f_pack_writer_save: rename failed");
+        return 0;
+    }
+    return 1;
+}
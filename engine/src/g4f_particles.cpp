@@ -0,0 +1,420 @@
+#include "../include/g4f/g4f_particles.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+constexpr int kMaxCapacity = 1 << 26;
+constexpr int kUpdateChunk = 4096; // particles per update job (multiple of 4; ~160 KB of streams)
+constexpr int kSpawnChunk = 2048;  // particles per spawn job
+
+struct Emitter {
+    g4f_particle_emitter_desc desc{};
+    float carry = 0.0f;  // fractional particles owed by rate * dt
+    uint32_t serial = 0; // particles spawned so far (random stream position)
+    bool active = false;
+};
+
+struct Burst {
+    g4f_particle_emitter_desc desc;
+    int count;
+    uint32_t serial;
+};
+
+struct SpawnItem {
+    const g4f_particle_emitter_desc* desc;
+    int slot;
+    int count;
+    uint32_t serial;
+};
+
+enum Stream { kX, kY, kZ, kVX, kVY, kVZ, kAge, kLife, kSize, kFloatStreams };
+
+} // namespace
+
+struct g4f_particles {
+    g4f_particles_desc desc{};
+    int count = 0;
+    std::vector<float> streams[kFloatStreams]; // capacity rounded up to 4 lanes
+    std::vector<uint32_t> rgba;
+
+    std::vector<Emitter> emitters;
+    std::vector<int> freeEmitters;
+    std::vector<Burst> bursts;
+    uint32_t burstSerial = 0;
+
+    // Per-update scratch.
+    std::vector<int> chunkAlive;
+    std::vector<SpawnItem> spawnItems;
+    g4f_particles_stats stats{};
+};
+
+namespace {
+
+static bool validateDesc(const g4f_particles_desc* in, g4f_particles_desc* out) {
+    *out = in ? *in : g4f_particles_desc_default();
+    if (out->capacity <= 0 || out->capacity > kMaxCapacity) {
+        g4f_set_last_errorf("g4f_particles_create: capacity %d out of range (1..%d)", out->capacity, kMaxCapacity);
+        return false;
+    }
+    out->drag = std::max(out->drag, 0.0f);
+    return true;
+}
+
+// Counter-based random numbers: a particle's values depend only on (seed, serial), not on which
+// job spawned it.
+static uint32_t hash32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return x;
+}
+
+static float unitRandom(uint32_t h) { // [0, 1)
+    return (float)(h >> 8) * (1.0f / 16777216.0f);
+}
+
+static float signedRandom(uint32_t h) { // [-1, 1)
+    return unitRandom(h) * 2.0f - 1.0f;
+}
+
+static void spawnRange(g4f_particles* p, const SpawnItem& item) {
+    const g4f_particle_emitter_desc& d = *item.desc;
+    const float lifeMin = std::max(d.lifeMin, 1e-4f);
+    const float lifeSpan = std::max(d.lifeMax, lifeMin) - lifeMin;
+    const float sizeSpan = std::max(d.sizeMax, d.sizeMin) - d.sizeMin;
+    float* dst[kFloatStreams];
+    for (int k = 0; k < kFloatStreams; k++) dst[k] = p->streams[k].data() + item.slot;
+    uint32_t* rgba = p->rgba.data() + item.slot;
+    const uint32_t seed = hash32(d.seed ^ 0x9e3779b9u);
+    for (int i = 0; i < item.count; i++) {
+        const uint32_t base = hash32(seed ^ hash32(item.serial + (uint32_t)i));
+        uint32_t h[8];
+        for (uint32_t k = 0; k < 8; k++) h[k] = hash32(base + k * 0x9e3779b9u);
+        dst[kX][i] = d.position.x + signedRandom(h[0]) * d.positionJitter.x;
+        dst[kY][i] = d.position.y + signedRandom(h[1]) * d.positionJitter.y;
+        dst[kZ][i] = d.position.z + signedRandom(h[2]) * d.positionJitter.z;
+        dst[kVX][i] = d.velocity.x + signedRandom(h[3]) * d.velocityJitter.x;
+        dst[kVY][i] = d.velocity.y + signedRandom(h[4]) * d.velocityJitter.y;
+        dst[kVZ][i] = d.velocity.z + signedRandom(h[5]) * d.velocityJitter.z;
+        dst[kAge][i] = 0.0f;
+        dst[kLife][i] = lifeMin + unitRandom(h[6]) * lifeSpan;
+        dst[kSize][i] = d.sizeMin + unitRandom(h[7]) * sizeSpan;
+        rgba[i] = d.rgba;
+    }
+}
+
+static void spawnJob(void* user, int begin, int end, int) {
+    auto* p = static_cast<g4f_particles*>(user);
+    for (int i = begin; i < end; i++) spawnRange(p, p->spawnItems[(size_t)i]);
+}
+
+// Splits n spawns from one source into job items, clamped to the free capacity.
+static void reserveSpawns(g4f_particles* p, const g4f_particle_emitter_desc* desc, int n, uint32_t serial, int* next) {
+    const int take = std::min(n, p->desc.capacity - *next);
+    p->stats.dropped += n - take;
+    for (int done = 0; done < take; done += kSpawnChunk) {
+        const int count = std::min(kSpawnChunk, take - done);
+        p->spawnItems.push_back(SpawnItem{desc, *next + done, count, serial + (uint32_t)done});
+    }
+    *next += take;
+}
+
+struct UpdateArgs {
+    g4f_particles* p;
+    float dt;
+    float damp;
+};
+
+static void moveParticle(g4f_particles* p, int dst, int src) {
+    for (std::vector<float>& s : p->streams) s[(size_t)dst] = s[(size_t)src];
+    p->rgba[(size_t)dst] = p->rgba[(size_t)src];
+}
+
+// Integrates, ages and kills one chunk four lanes at a time, packing survivors to the front of
+// the chunk. Blocks without deaths (the common case) are stored in place as whole vectors.
+static void updateJob(void* user, int begin, int end, int) {
+    const auto* args = static_cast<const UpdateArgs*>(user);
+    g4f_particles* p = args->p;
+    float* x = p->streams[kX].data();
+    float* y = p->streams[kY].data();
+    float* z = p->streams[kZ].data();
+    float* vx = p->streams[kVX].data();
+    float* vy = p->streams[kVY].data();
+    float* vz = p->streams[kVZ].data();
+    float* age = p->streams[kAge].data();
+    const float* life = p->streams[kLife].data();
+    const F4 dt = f4Set1(args->dt);
+    const F4 damp = f4Set1(args->damp);
+    const F4 gx = f4Set1(p->desc.gravity.x * args->dt);
+    const F4 gy = f4Set1(p->desc.gravity.y * args->dt);
+    const F4 gz = f4Set1(p->desc.gravity.z * args->dt);
+    const F4 lane = f4Set(0.0f, 1.0f, 2.0f, 3.0f);
+
+    for (int c = begin; c < end; c++) {
+        const int first = c * kUpdateChunk;
+        const int last = std::min(first + kUpdateChunk, p->count);
+        int write = first;
+        for (int i = first; i < last; i += 4) {
+            const F4 nvx = (f4Load(vx + i) + gx) * damp;
+            const F4 nvy = (f4Load(vy + i) + gy) * damp;
+            const F4 nvz = (f4Load(vz + i) + gz) * damp;
+            const F4 nage = f4Load(age + i) + dt;
+            F4 alive = f4Lt(nage, f4Load(life + i));
+            if (last - i < 4) alive = f4And(alive, f4Lt(lane, f4Set1((float)(last - i))));
+            f4Store(vx + i, nvx);
+            f4Store(vy + i, nvy);
+            f4Store(vz + i, nvz);
+            f4Store(x + i, f4MulAdd(nvx, dt, f4Load(x + i)));
+            f4Store(y + i, f4MulAdd(nvy, dt, f4Load(y + i)));
+            f4Store(z + i, f4MulAdd(nvz, dt, f4Load(z + i)));
+            f4Store(age + i, nage);
+            const int mask = f4MoveMask(alive);
+            if (mask == 15 && write == i) {
+                write += 4;
+                continue;
+            }
+            for (int l = 0; l < 4; l++) {
+                if (!(mask & (1 << l))) continue;
+                if (write != i + l) moveParticle(p, write, i + l);
+                write++;
+            }
+        }
+        p->chunkAlive[(size_t)c] = write - first;
+    }
+}
+
+// Closes the gaps left by updateJob: every hole below the new count takes a survivor from the
+// highest chunk above it, so only about as many particles move as died.
+static int fillHoles(g4f_particles* p, int chunks, int oldCount) {
+    int alive = 0;
+    for (int c = 0; c < chunks; c++) alive += p->chunkAlive[(size_t)c];
+    int src = chunks - 1;
+    int srcEnd = src * kUpdateChunk + p->chunkAlive[(size_t)src];
+    for (int c = 0; c < chunks && c * kUpdateChunk < alive; c++) {
+        int hole = c * kUpdateChunk + p->chunkAlive[(size_t)c];
+        const int holeEnd = std::min(std::min((c + 1) * kUpdateChunk, oldCount), alive);
+        while (hole < holeEnd) {
+            while (srcEnd <= std::max(src * kUpdateChunk, alive)) {
+                src--;
+                srcEnd = src * kUpdateChunk + p->chunkAlive[(size_t)src];
+            }
+            const int n = std::min(holeEnd - hole, srcEnd - std::max(src * kUpdateChunk, alive));
+            for (std::vector<float>& s : p->streams) std::memcpy(&s[(size_t)hole], &s[(size_t)(srcEnd - n)], (size_t)n * sizeof(float));
+            std::memcpy(&p->rgba[(size_t)hole], &p->rgba[(size_t)(srcEnd - n)], (size_t)n * sizeof(uint32_t));
+            hole += n;
+            srcEnd -= n;
+        }
+    }
+    return alive;
+}
+
+struct InstanceArgs {
+    const g4f_particles* p;
+    g4f_particle_instance* out;
+    int count;
+};
+
+static void instanceJob(void* user, int begin, int end, int) {
+    const auto* args = static_cast<const InstanceArgs*>(user);
+    const g4f_particles* p = args->p;
+    const float* x = p->streams[kX].data();
+    const float* y = p->streams[kY].data();
+    const float* z = p->streams[kZ].data();
+    const float* age = p->streams[kAge].data();
+    const float* life = p->streams[kLife].data();
+    const float* size = p->streams[kSize].data();
+    const uint32_t* rgba = p->rgba.data();
+    g4f_particle_instance* out = args->out;
+    const F4 grow = f4Set1(p->desc.endSizeScale - 1.0f);
+    const F4 one = f4Set1(1.0f);
+    const F4 fade = f4Set1(p->desc.fadeOut ? 1.0f : 0.0f);
+    const I4 alphaMask = i4Set1(0xFF);
+    const int last = std::min(end * kUpdateChunk, args->count);
+    // Size and alpha over life four at a time; the transposed writes are scalar.
+    alignas(16) float sizes[4];
+    alignas(16) int32_t colors[4];
+    for (int i = begin * kUpdateChunk; i < last; i += 4) {
+        const F4 t = f4Min(f4Load(age + i) / f4Load(life + i), one);
+        f4Store(sizes, f4Load(size + i) * f4MulAdd(grow, t, one));
+        const I4 color = i4Load(reinterpret_cast<const int32_t*>(rgba + i));
+        const F4 alpha = f4FromI4(color & alphaMask) * (one - fade * t) + f4Set1(0.5f);
+        i4Store(colors, (color - (color & alphaMask)) | i4FromF4(alpha));
+        const int n = std::min(4, last - i);
+        for (int l = 0; l < n; l++) out[i + l] = g4f_particle_instance{x[i + l], y[i + l], z[i + l], sizes[l], (uint32_t)colors[l]};
+    }
+}
+
+} // namespace
+
+extern "C" {
+
+g4f_particles_desc g4f_particles_desc_default(void) {
+    g4f_particles_desc d{};
+    d.capacity = 65536;
+    d.gravity = g4f_vec3{0.0f, -9.81f, 0.0f};
+    d.drag = 0.0f;
+    d.endSizeScale = 1.0f;
+    d.fadeOut = 1;
+    return d;
+}
+
+g4f_particle_emitter_desc g4f_particle_emitter_desc_default(void) {
+    g4f_particle_emitter_desc d{};
+    d.velocity = g4f_vec3{0.0f, 2.0f, 0.0f};
+    d.velocityJitter = g4f_vec3{0.5f, 0.5f, 0.5f};
+    d.lifeMin = 1.0f;
+    d.lifeMax = 2.0f;
+    d.sizeMin = 0.1f;
+    d.sizeMax = 0.1f;
+    d.rgba = 0xFFFFFFFFu;
+    d.rate = 100.0f;
+    d.seed = 1u;
+    return d;
+}
+
+g4f_particles* g4f_particles_create(const g4f_particles_desc* desc) {
+    g4f_particles_desc d{};
+    if (!validateDesc(desc, &d)) return nullptr;
+    auto* p = new g4f_particles();
+    p->desc = d;
+    const size_t padded = ((size_t)d.capacity + 3) & ~(size_t)3;
+    for (std::vector<float>& s : p->streams) s.assign(padded, 0.0f);
+    p->rgba.assign(padded, 0u);
+    return p;
+}
+
+void g4f_particles_destroy(g4f_particles* particles) {
+    delete particles;
+}
+
+void g4f_particles_clear(g4f_particles* particles) {
+    if (!particles) return;
+    particles->count = 0;
+    particles->bursts.clear();
+    particles->stats = g4f_particles_stats{};
+}
+
+int g4f_particles_capacity(const g4f_particles* particles) {
+    return particles ? particles->desc.capacity : 0;
+}
+
+int g4f_particles_count(const g4f_particles* particles) {
+    return particles ? particles->count : 0;
+}
+
+int g4f_particles_add_emitter(g4f_particles* particles, const g4f_particle_emitter_desc* desc) {
+    if (!particles || !desc) {
+        g4f_set_last_error("g4f_particles_add_emitter: invalid arguments");
+        return -1;
+    }
+    int id = 0;
+    if (!particles->freeEmitters.empty()) {
+        id = particles->freeEmitters.back();
+        particles->freeEmitters.pop_back();
+    } else {
+        id = (int)particles->emitters.size();
+        particles->emitters.emplace_back();
+    }
+    Emitter& e = particles->emitters[(size_t)id];
+    e = Emitter{};
+    e.desc = *desc;
+    e.active = true;
+    return id;
+}
+
+int g4f_particles_set_emitter(g4f_particles* particles, int emitter, const g4f_particle_emitter_desc* desc) {
+    if (!particles || !desc || emitter < 0 || emitter >= (int)particles->emitters.size() || !particles->emitters[(size_t)emitter].active) {
+        g4f_set_last_error("g4f_particles_set_emitter: invalid emitter");
+        return 0;
+    }
+    particles->emitters[(size_t)emitter].desc = *desc;
+    return 1;
+}
+
+void g4f_particles_remove_emitter(g4f_particles* particles, int emitter) {
+    if (!particles || emitter < 0 || emitter >= (int)particles->emitters.size() || !particles->emitters[(size_t)emitter].active) return;
+    particles->emitters[(size_t)emitter].active = false;
+    particles->freeEmitters.push_back(emitter);
+}
+
+void g4f_particles_burst(g4f_particles* particles, const g4f_particle_emitter_desc* desc, int count) {
+    if (!particles || !desc || count <= 0) return;
+    particles->bursts.push_back(Burst{*desc, count, particles->burstSerial});
+    particles->burstSerial += (uint32_t)count;
+}
+
+void g4f_particles_update(g4f_particles* particles, float dt, g4f_jobs* jobs) {
+    if (!particles) return;
+    g4f_particles* p = particles;
+    dt = std::max(dt, 0.0f);
+    p->stats = g4f_particles_stats{};
+
+    const int oldCount = p->count;
+    if (oldCount > 0) {
+        const int chunks = (oldCount + kUpdateChunk - 1) / kUpdateChunk;
+        p->chunkAlive.resize((size_t)chunks);
+        UpdateArgs args{p, dt, 1.0f / (1.0f + p->desc.drag * dt)};
+        g4f_jobs_parallel_for(jobs, chunks, 1, updateJob, &args);
+        p->count = fillHoles(p, chunks, oldCount);
+        p->stats.killed = oldCount - p->count;
+    }
+
+    // Reserve slots in emitter order (deterministic), then fill them in parallel.
+    p->spawnItems.clear();
+    int next = p->count;
+    for (Emitter& e : p->emitters) {
+        if (!e.active) continue;
+        e.carry += std::max(e.desc.rate, 0.0f) * dt;
+        const int n = (int)std::min(e.carry, (float)kMaxCapacity);
+        e.carry -= (float)n;
+        reserveSpawns(p, &e.desc, n, e.serial, &next);
+        e.serial += (uint32_t)n;
+    }
+    for (const Burst& b : p->bursts) reserveSpawns(p, &b.desc, b.count, b.serial, &next);
+    if (!p->spawnItems.empty()) g4f_jobs_parallel_for(jobs, (int)p->spawnItems.size(), 1, spawnJob, p);
+    p->bursts.clear();
+    p->stats.spawned = next - p->count;
+    p->count = next;
+    p->stats.alive = next;
+}
+
+void g4f_particles_get_stats(const g4f_particles* particles, g4f_particles_stats* out) {
+    if (!out) return;
+    *out = particles ? particles->stats : g4f_particles_stats{};
+}
+
+void g4f_particles_get_streams(const g4f_particles* particles, g4f_particle_streams* out) {
+    if (!out) return;
+    *out = g4f_particle_streams{};
+    if (!particles) return;
+    out->count = particles->count;
+    out->x = particles->streams[kX].data();
+    out->y = particles->streams[kY].data();
+    out->z = particles->streams[kZ].data();
+    out->vx = particles->streams[kVX].data();
+    out->vy = particles->streams[kVY].data();
+    out->vz = particles->streams[kVZ].data();
+    out->age = particles->streams[kAge].data();
+    out->life = particles->streams[kLife].data();
+    out->size = particles->streams[kSize].data();
+    out->rgba = particles->rgba.data();
+}
+
+int g4f_particles_write_instances(const g4f_particles* particles, g4f_particle_instance* out, int maxCount, g4f_jobs* jobs) {
+    if (!particles || !out || maxCount <= 0) return 0;
+    InstanceArgs args{particles, out, std::min(particles->count, maxCount)};
+    if (args.count > 0) g4f_jobs_parallel_for(jobs, (args.count + kUpdateChunk - 1) / kUpdateChunk, 1, instanceJob, &args);
+    return args.count;
+}
+
+} // extern "C"
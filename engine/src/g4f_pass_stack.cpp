@@ -0,0 +1,49 @@
+#include "../include/g4f/g4f_pass_stack.h"
+
+#include "g4f_error_internal.h"
+
+void g4f_pass_stack_reset(g4f_pass_stack* stack, int backbufferW, int backbufferH) {
+    if (!stack) return;
+    stack->depth = 0;
+    stack->backbufferW = backbufferW > 0 ? backbufferW : 0;
+    stack->backbufferH = backbufferH > 0 ? backbufferH : 0;
+}
+
+void g4f_pass_stack_set_backbuffer_size(g4f_pass_stack* stack, int backbufferW, int backbufferH) {
+    if (!stack) return;
+    stack->backbufferW = backbufferW > 0 ? backbufferW : 0;
+    stack->backbufferH = backbufferH > 0 ? backbufferH : 0;
+}
+
+int g4f_pass_stack_push(g4f_pass_stack* stack, const void* target, int width, int height) {
+    if (!stack || !target) { g4f_set_last_error("g4f_pass_stack_push: invalid args"); return 0; }
+    if (width <= 0 || height <= 0) { g4f_set_last_error("g4f_pass_stack_push: invalid size"); return 0; }
+    if (stack->depth >= G4F_PASS_STACK_MAX) { g4f_set_last_error("g4f_pass_stack_push: passes nested too deeply"); return 0; }
+    if (g4f_pass_stack_is_open(stack, target)) {
+        g4f_set_last_error("g4f_pass_stack_push: target already has an open pass");
+        return 0;
+    }
+    stack->entries[stack->depth++] = g4f_pass_state{target, width, height};
+    return 1;
+}
+
+int g4f_pass_stack_pop(g4f_pass_stack* stack) {
+    if (!stack) { g4f_set_last_error("g4f_pass_stack_pop: stack is null"); return 0; }
+    if (stack->depth <= 0) { g4f_set_last_error("g4f_pass_stack_pop: no open pass"); return 0; }
+    stack->depth--;
+    return 1;
+}
+
+g4f_pass_state g4f_pass_stack_current(const g4f_pass_stack* stack) {
+    if (!stack) return g4f_pass_state{nullptr, 0, 0};
+    if (stack->depth > 0) return stack->entries[stack->depth - 1];
+    return g4f_pass_state{nullptr, stack->backbufferW, stack->backbufferH};
+}
+
+int g4f_pass_stack_is_open(const g4f_pass_stack* stack, const void* target) {
+    if (!stack || !target) return 0;
+    for (int i = 0; i < stack->depth; i++) {
+        if (stack->entries[i].target == target) return 1;
+    }
+    return 0;
+}
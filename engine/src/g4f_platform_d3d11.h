@@ -1,10 +1,24 @@
 #pragma once
 
 #include "g4f_platform_win32.h"
+#include "../include/g4f/g4f_frame_stats.h"
+#include "../include/g4f/g4f_gpu_timings.h"
+#include "../include/g4f/g4f_material_key.h"
+#include "../include/g4f/g4f_pass_stack.h"
 
 #include <d3d11.h>
 #include <dxgi.h>
 #include <cstdint>
+#include <vector>
+
+// Immutable pipeline state baked from one material key; objects are owned by g4f_gfx.
+struct g4f_gfx_state_bundle {
+    ID3D11PixelShader* ps = nullptr;
+    ID3D11BlendState* blend = nullptr;
+    ID3D11DepthStencilState* depth = nullptr;
+    ID3D11RasterizerState* rs = nullptr;
+    ID3D11SamplerState* samp = nullptr;
+};
 
 struct g4f_gfx {
     g4f_window* window = nullptr;
@@ -43,16 +57,93 @@ struct g4f_gfx {
 
     // Unlit material pipeline (P3N3UV2, optional texture).
     ID3D11VertexShader* vsUnlit = nullptr;
-    ID3D11PixelShader* psUnlit = nullptr;
-    ID3D11PixelShader* psLit = nullptr;
+    ID3D11PixelShader* psMesh[G4F_MATERIAL_SHADER_COUNT]{}; // [G4F_MATERIAL_SHADER_* mask]
     ID3D11InputLayout* ilUnlit = nullptr;
     ID3D11Buffer* cbUnlit = nullptr;
-    ID3D11SamplerState* sampLinearClamp = nullptr;
+    ID3D11SamplerState* samplers[3][2]{}; // [G4F_GFX_FILTER_*][G4F_GFX_ADDRESS_*]
+
+    // Material state bundles, indexed by bundle ID (keys deduplicated in bundleKeys).
+    g4f_material_bundle_table bundleKeys{};
+    g4f_gfx_state_bundle bundles[G4F_MATERIAL_BUNDLE_MAX];
+
+    // Clustered point/spot lights (g4f_gfx_set_light_clusters): CB1 + t1..t3 of clustered shaders.
+    ID3D11Buffer* cbClusters = nullptr;
+    ID3D11Buffer* lightBuf = nullptr;
+    ID3D11ShaderResourceView* lightSrv = nullptr;
+    UINT lightCapacity = 0;
+    ID3D11Buffer* clusterRangeBuf = nullptr;
+    ID3D11ShaderResourceView* clusterRangeSrv = nullptr;
+    UINT clusterRangeCapacity = 0;
+    ID3D11Buffer* lightIndexBuf = nullptr;
+    ID3D11ShaderResourceView* lightIndexSrv = nullptr;
+    UINT lightIndexCapacity = 0;
+
+    // Cascaded shadow map (g4f_gfx_shadow_*): depth array with one DSV per cascade; CB2/t4/s1 of lit shaders.
+    ID3D11Texture2D* shadowTex = nullptr;
+    ID3D11ShaderResourceView* shadowSrv = nullptr;
+    ID3D11DepthStencilView* shadowDsv[G4F_SHADOW_MAX_CASCADES]{};
+    ID3D11RasterizerState* rsShadow = nullptr;
+    ID3D11SamplerState* sampShadow = nullptr;
+    ID3D11Buffer* cbShadow = nullptr;
+    int shadowSize = 0;
+    int shadowCascades = 0;
+    float shadowCompareBias = 0.0f;
+    int shadowPassActive = 0;
+    g4f_mat4 shadowPassViewProj{};
+
+    // GPU frame/scope timings: one disjoint query and a timestamp per mark for each ring slot.
+    // gpuTimer falls back to the CPU clock when the queries cannot be created.
+    ID3D11Query* tsDisjoint[G4F_GPU_TIMER_RING]{};
+    ID3D11Query* tsMarks[G4F_GPU_TIMER_RING][G4F_GPU_TIMER_MAX_MARKS]{};
+    g4f_gpu_timer* gpuTimer = nullptr;
+
+    // Fullscreen blit (upscaling offscreen passes).
+    ID3D11VertexShader* vsBlit = nullptr;
+    ID3D11PixelShader* psBlit = nullptr;
+
+    // Sprite batches (g4f_gfx_draw_sprite_batch), created on first use: dynamic vertex buffer,
+    // shared quad index buffer and a white texture for untextured ranges.
+    ID3D11VertexShader* vsSprite = nullptr;
+    ID3D11PixelShader* psSprite = nullptr;
+    ID3D11InputLayout* ilSprite = nullptr;
+    ID3D11Buffer* cbSprite = nullptr;
+    ID3D11Buffer* vbSprite = nullptr;
+    ID3D11Buffer* ibSprite = nullptr;
+    UINT spriteCapacity = 0; // sprites that fit in vbSprite
+    g4f_gfx_texture* spriteWhite = nullptr;
+    int spriteInitFailed = 0;
+
+    // Particle billboards (g4f_gfx_draw_particles), created on first use: one instance per
+    // particle, corners from SV_VertexID; additive blending has its own blend state.
+    ID3D11VertexShader* vsParticle = nullptr;
+    ID3D11PixelShader* psParticle = nullptr;
+    ID3D11InputLayout* ilParticle = nullptr;
+    ID3D11Buffer* cbParticle = nullptr;
+    ID3D11Buffer* vbParticle = nullptr;
+    UINT particleCapacity = 0; // instances that fit in vbParticle
+    ID3D11BlendState* bsAdditive = nullptr;
+    g4f_gfx_texture* particleWhite = nullptr;
+    int particleInitFailed = 0;
 
     UINT indexCount = 0;
 
+    // Shader cache hits/misses and timings gathered during g4f_gfx_create.
+    g4f_gfx_startup_stats startup{};
+
+    // Offscreen passes (g4f_gfx_pass_begin/end); entries hold g4f_gfx_target pointers.
+    g4f_pass_stack passes{};
+
+    // Counters since the last g4f_gfx_end, and the snapshot taken there (g4f_gfx_get_frame_stats).
+    g4f_gfx_frame_stats frameStats{};
+    g4f_gfx_frame_stats lastFrameStats{};
+    uint64_t framesEnded = 0;
+
+    // Streaming textures with dirty rects waiting to be copied from their staging ring.
+    std::vector<g4f_gfx_texture*> pendingUploads;
+
     // Lightweight state cache (avoid redundant Set* calls in hot draw paths).
-    int cachePipeline = 0; // 0 none, 1 debug, 2 mesh
+    int cachePipeline = 0; // 0 none, 1 debug, 2 mesh, 3 blit, 4 shadow depth, 5 sprites, 6 particles
+    int cacheBundle = -1;
     ID3D11InputLayout* cacheIL = nullptr;
     ID3D11VertexShader* cacheVS = nullptr;
     ID3D11PixelShader* cachePS = nullptr;
@@ -68,4 +159,6 @@ struct g4f_gfx {
     ID3D11SamplerState* cacheSamp0 = nullptr;
     ID3D11Buffer* cacheCB0VS = nullptr;
     ID3D11Buffer* cacheCB0PS = nullptr;
+    int clustersBound = 0; // CB1 + t1..t3 bound for the mesh pipeline
+    int shadowBound = 0;   // CB2 + t4 + s1 bound for the mesh pipeline
 };
@@ -0,0 +1,531 @@
+#include "../include/g4f/g4f_scene.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <algorithm>
+#include <functional>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+// Handle = generation << kSlotBits | (slot + 1). A slot whose generation reaches kGenMask is
+// retired instead of wrapping, so old handles can never match a later node.
+constexpr int kSlotBits = 22;
+constexpr uint32_t kSlotMask = (1u << kSlotBits) - 1u;
+constexpr uint32_t kGenMask = (1u << (32 - kSlotBits)) - 1u;
+constexpr uint32_t kNoDense = 0xFFFFFFFFu;
+
+// Below this many nodes to recompute, fork/join costs more than it saves.
+constexpr int kParallelMinNodes = 4096;
+
+} // namespace
+
+struct g4f_scene {
+    // Per node, in depth-first order when the layout is clean (parents first, subtrees contiguous).
+    std::vector<g4f_vec3> translation;
+    std::vector<g4f_quat> rotation;
+    std::vector<g4f_vec3> scale;
+    std::vector<g4f_mat4> world;
+    std::vector<int32_t> parent;      // dense index, -1 for roots
+    std::vector<int32_t> subtreeSize; // includes the node; valid while the layout is clean
+    std::vector<uint32_t> handle;     // 0 for destroyed nodes awaiting compaction
+    std::vector<uint8_t> dirty;
+    std::vector<const g4f_gfx_mesh*> mesh;
+    std::vector<const g4f_gfx_material*> material;
+    std::vector<const g4f_lod_chain*> lodChain;
+    std::vector<int32_t> lodLevel; // last selected level, -1 before the first selection
+    std::vector<g4f_aabb> bounds;
+    std::vector<uint8_t> hasBounds;
+
+    // Handle slots.
+    std::vector<uint32_t> slotDense;
+    std::vector<uint32_t> slotGen;
+    std::vector<uint32_t> freeSlots;
+
+    std::vector<uint32_t> dirtyNodes; // handles flagged since the last update
+    bool layoutDirty = false;
+    bool drawOrderDirty = false;
+    int aliveCount = 0;
+    int rootCount = 0;
+    int layoutRebuilds = 0;
+    int updatedNodes = 0;
+    int updatedRanges = 0;
+
+    // Scratch.
+    std::vector<int32_t> ranges;
+    std::vector<int32_t> order;
+    std::vector<int32_t> remap;
+    std::vector<int32_t> childStart;
+    std::vector<int32_t> children;
+    std::vector<int32_t> stack;
+
+    std::vector<int32_t> drawOrder;
+    std::vector<g4f_scene_draw> draws;
+    g4f_mat4 viewProj{};
+    g4f_lod_view lodView{};
+    bool hasLodView = false;
+    const g4f_occlusion* occlusion = nullptr;
+    std::vector<uint8_t> drawVisible;
+    int occludedDraws = 0;
+};
+
+namespace {
+
+static uint32_t makeHandle(uint32_t slot, uint32_t gen) {
+    return (gen << kSlotBits) | (slot + 1u);
+}
+
+static int denseOf(const g4f_scene* scene, g4f_scene_node node) {
+    if (!scene || node == G4F_SCENE_NODE_NULL) return -1;
+    const uint32_t slotPlusOne = node & kSlotMask;
+    if (slotPlusOne == 0) return -1;
+    const uint32_t slot = slotPlusOne - 1u;
+    if (slot >= scene->slotGen.size() || scene->slotGen[slot] != (node >> kSlotBits)) return -1;
+    const uint32_t dense = scene->slotDense[slot];
+    return dense == kNoDense ? -1 : (int)dense;
+}
+
+static void markDirty(g4f_scene* scene, int dense) {
+    if (scene->dirty[(size_t)dense]) return;
+    scene->dirty[(size_t)dense] = 1;
+    scene->dirtyNodes.push_back(scene->handle[(size_t)dense]);
+}
+
+template <typename T>
+static void permute(std::vector<T>& v, const std::vector<int32_t>& order) {
+    std::vector<T> out(order.size());
+    for (size_t i = 0; i < order.size(); i++) out[i] = v[(size_t)order[i]];
+    v.swap(out);
+}
+
+// Re-sorts live nodes depth-first (siblings keep their relative order) and drops destroyed ones.
+static void rebuildLayout(g4f_scene* scene) {
+    const int n = (int)scene->handle.size();
+    scene->childStart.assign((size_t)n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        if (scene->handle[(size_t)i] && scene->parent[(size_t)i] >= 0) scene->childStart[(size_t)scene->parent[(size_t)i] + 1]++;
+    }
+    for (int i = 0; i < n; i++) scene->childStart[(size_t)i + 1] += scene->childStart[(size_t)i];
+    scene->children.resize((size_t)scene->childStart[(size_t)n]);
+    scene->remap.assign(scene->childStart.begin(), scene->childStart.end() - 1); // fill cursors
+    for (int i = 0; i < n; i++) {
+        if (scene->handle[(size_t)i] && scene->parent[(size_t)i] >= 0) {
+            scene->children[(size_t)scene->remap[(size_t)scene->parent[(size_t)i]]++] = i;
+        }
+    }
+
+    scene->order.clear();
+    for (int root = 0; root < n; root++) {
+        if (!scene->handle[(size_t)root] || scene->parent[(size_t)root] >= 0) continue;
+        scene->stack.clear();
+        scene->stack.push_back(root);
+        while (!scene->stack.empty()) {
+            const int node = scene->stack.back();
+            scene->stack.pop_back();
+            scene->order.push_back(node);
+            // Push in reverse so the first child is visited first.
+            for (int c = scene->childStart[(size_t)node + 1] - 1; c >= scene->childStart[(size_t)node]; c--) {
+                scene->stack.push_back(scene->children[(size_t)c]);
+            }
+        }
+    }
+
+    scene->remap.assign((size_t)n, -1);
+    for (size_t i = 0; i < scene->order.size(); i++) scene->remap[(size_t)scene->order[i]] = (int32_t)i;
+
+    permute(scene->translation, scene->order);
+    permute(scene->rotation, scene->order);
+    permute(scene->scale, scene->order);
+    permute(scene->world, scene->order);
+    permute(scene->parent, scene->order);
+    permute(scene->handle, scene->order);
+    permute(scene->dirty, scene->order);
+    permute(scene->mesh, scene->order);
+    permute(scene->material, scene->order);
+    permute(scene->lodChain, scene->order);
+    permute(scene->lodLevel, scene->order);
+    permute(scene->bounds, scene->order);
+    permute(scene->hasBounds, scene->order);
+
+    const int m = (int)scene->order.size();
+    scene->subtreeSize.assign((size_t)m, 1);
+    for (int i = 0; i < m; i++) {
+        int32_t& p = scene->parent[(size_t)i];
+        if (p >= 0) p = scene->remap[(size_t)p];
+        scene->slotDense[(scene->handle[(size_t)i] & kSlotMask) - 1u] = (uint32_t)i;
+    }
+    for (int i = m - 1; i >= 0; i--) {
+        const int32_t p = scene->parent[(size_t)i];
+        if (p >= 0) scene->subtreeSize[(size_t)p] += scene->subtreeSize[(size_t)i];
+    }
+
+    scene->layoutDirty = false;
+    scene->drawOrderDirty = true;
+    scene->layoutRebuilds++;
+}
+
+static void ensureLayout(g4f_scene* scene) {
+    if (scene->layoutDirty) rebuildLayout(scene);
+}
+
+// Recomputes world matrices of the contiguous subtree [begin, end); the parent of `begin` is
+// outside the range and already up to date.
+static void updateRange(g4f_scene* scene, int begin, int end) {
+    for (int i = begin; i < end; i++) {
+        const g4f_mat4 local = g4f_mat4_trs(scene->translation[(size_t)i], scene->rotation[(size_t)i], scene->scale[(size_t)i]);
+        const int32_t p = scene->parent[(size_t)i];
+        if (p < 0) scene->world[(size_t)i] = local;
+        else mat4Mul(local.m, scene->world[(size_t)p].m, scene->world[(size_t)i].m);
+        scene->dirty[(size_t)i] = 0;
+    }
+}
+
+static void updateRangesJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    auto* scene = static_cast<g4f_scene*>(user);
+    for (int r = begin; r < end; r++) {
+        const int start = scene->ranges[(size_t)r];
+        updateRange(scene, start, start + scene->subtreeSize[(size_t)start]);
+    }
+}
+
+static void drawsJob(void* user, int begin, int end, int workerIndex) {
+    (void)workerIndex;
+    auto* scene = static_cast<g4f_scene*>(user);
+    for (int k = begin; k < end; k++) {
+        const int i = scene->drawOrder[(size_t)k];
+        g4f_scene_draw& d = scene->draws[(size_t)k];
+        d.mesh = scene->mesh[(size_t)i];
+        d.material = scene->material[(size_t)i];
+        d.model = scene->world[(size_t)i];
+        mat4Mul(d.model.m, scene->viewProj.m, d.mvp.m);
+        d.node = scene->handle[(size_t)i];
+        d.lod = 0;
+        if (scene->occlusion && scene->hasBounds[(size_t)i]) {
+            scene->drawVisible[(size_t)k] = (uint8_t)g4f_occlusion_test_box(scene->occlusion, &scene->bounds[(size_t)i], &d.model);
+            if (!scene->drawVisible[(size_t)k]) continue; // keeps the previous LOD level for hysteresis
+        }
+        if (scene->hasLodView && scene->lodChain[(size_t)i]) {
+            d.lod = g4f_lod_select(scene->lodChain[(size_t)i], &scene->lodView, &d.model, scene->lodLevel[(size_t)i]);
+            scene->lodLevel[(size_t)i] = d.lod;
+        }
+    }
+}
+
+static void rebuildDrawOrder(g4f_scene* scene) {
+    scene->drawOrder.clear();
+    const int n = (int)scene->handle.size();
+    for (int i = 0; i < n; i++) {
+        if (scene->handle[(size_t)i] && scene->mesh[(size_t)i] && scene->material[(size_t)i]) scene->drawOrder.push_back(i);
+    }
+    std::sort(scene->drawOrder.begin(), scene->drawOrder.end(), [scene](int32_t a, int32_t b) {
+        const g4f_gfx_material* ma = scene->material[(size_t)a];
+        const g4f_gfx_material* mb = scene->material[(size_t)b];
+        if (ma != mb) return std::less<const g4f_gfx_material*>()(ma, mb);
+        const g4f_gfx_mesh* ea = scene->mesh[(size_t)a];
+        const g4f_gfx_mesh* eb = scene->mesh[(size_t)b];
+        if (ea != eb) return std::less<const g4f_gfx_mesh*>()(ea, eb);
+        return a < b;
+    });
+    scene->drawOrderDirty = false;
+}
+
+} // namespace
+
+g4f_scene* g4f_scene_create(int nodeCapacity) {
+    auto* scene = new g4f_scene();
+    if (nodeCapacity > 0) {
+        const size_t cap = (size_t)nodeCapacity;
+        scene->translation.reserve(cap);
+        scene->rotation.reserve(cap);
+        scene->scale.reserve(cap);
+        scene->world.reserve(cap);
+        scene->parent.reserve(cap);
+        scene->subtreeSize.reserve(cap);
+        scene->handle.reserve(cap);
+        scene->dirty.reserve(cap);
+        scene->mesh.reserve(cap);
+        scene->material.reserve(cap);
+        scene->lodChain.reserve(cap);
+        scene->lodLevel.reserve(cap);
+        scene->bounds.reserve(cap);
+        scene->hasBounds.reserve(cap);
+        scene->slotDense.reserve(cap);
+        scene->slotGen.reserve(cap);
+    }
+    return scene;
+}
+
+void g4f_scene_destroy(g4f_scene* scene) {
+    delete scene;
+}
+
+g4f_scene_node g4f_scene_node_create(g4f_scene* scene, g4f_scene_node parent) {
+    if (!scene) {
+        g4f_set_last_error("g4f_scene_node_create: invalid scene");
+        return G4F_SCENE_NODE_NULL;
+    }
+    const int parentDense = denseOf(scene, parent);
+    if (parent != G4F_SCENE_NODE_NULL && parentDense < 0) {
+        g4f_set_last_error("g4f_scene_node_create: invalid parent");
+        return G4F_SCENE_NODE_NULL;
+    }
+
+    uint32_t slot = 0;
+    if (!scene->freeSlots.empty()) {
+        slot = scene->freeSlots.back();
+        scene->freeSlots.pop_back();
+    } else {
+        if (scene->slotGen.size() >= (size_t)kSlotMask) {
+            g4f_set_last_error("g4f_scene_node_create: too many nodes");
+            return G4F_SCENE_NODE_NULL;
+        }
+        slot = (uint32_t)scene->slotGen.size();
+        scene->slotGen.push_back(0);
+        scene->slotDense.push_back(kNoDense);
+    }
+
+    const int dense = (int)scene->handle.size();
+    const uint32_t handle = makeHandle(slot, scene->slotGen[slot]);
+    scene->slotDense[slot] = (uint32_t)dense;
+    scene->translation.push_back(g4f_vec3{0.0f, 0.0f, 0.0f});
+    scene->rotation.push_back(g4f_quat_identity());
+    scene->scale.push_back(g4f_vec3{1.0f, 1.0f, 1.0f});
+    scene->world.push_back(g4f_mat4_identity());
+    scene->parent.push_back(parentDense);
+    scene->subtreeSize.push_back(1);
+    scene->handle.push_back(handle);
+    scene->dirty.push_back(0);
+    scene->mesh.push_back(nullptr);
+    scene->material.push_back(nullptr);
+    scene->lodChain.push_back(nullptr);
+    scene->lodLevel.push_back(-1);
+    scene->bounds.push_back(g4f_aabb{});
+    scene->hasBounds.push_back(0);
+    markDirty(scene, dense);
+    scene->aliveCount++;
+
+    if (parentDense < 0) {
+        scene->rootCount++; // appending a root keeps the layout depth-first
+    } else if (!scene->layoutDirty && parentDense + scene->subtreeSize[(size_t)parentDense] == dense) {
+        // The parent's subtree ends at the array end (depth-first construction): extend it and
+        // its ancestors in place instead of re-sorting.
+        for (int32_t p = parentDense; p >= 0; p = scene->parent[(size_t)p]) scene->subtreeSize[(size_t)p]++;
+    } else {
+        scene->layoutDirty = true;
+    }
+    return handle;
+}
+
+void g4f_scene_node_destroy(g4f_scene* scene, g4f_scene_node node) {
+    if (denseOf(scene, node) < 0) return;
+    ensureLayout(scene);
+    const int dense = denseOf(scene, node);
+    if (scene->parent[(size_t)dense] < 0) scene->rootCount--;
+    const int end = dense + scene->subtreeSize[(size_t)dense];
+    for (int i = dense; i < end; i++) {
+        const uint32_t slot = (scene->handle[(size_t)i] & kSlotMask) - 1u;
+        scene->slotDense[slot] = kNoDense;
+        if (++scene->slotGen[slot] < kGenMask) scene->freeSlots.push_back(slot);
+        scene->handle[(size_t)i] = 0;
+        scene->mesh[(size_t)i] = nullptr;
+        scene->material[(size_t)i] = nullptr;
+        scene->lodChain[(size_t)i] = nullptr;
+        scene->hasBounds[(size_t)i] = 0;
+    }
+    scene->aliveCount -= end - dense;
+    scene->layoutDirty = true;
+}
+
+int g4f_scene_node_alive(const g4f_scene* scene, g4f_scene_node node) {
+    return denseOf(scene, node) >= 0 ? 1 : 0;
+}
+
+int g4f_scene_node_count(const g4f_scene* scene) {
+    return scene ? scene->aliveCount : 0;
+}
+
+int g4f_scene_set_parent(g4f_scene* scene, g4f_scene_node node, g4f_scene_node parent) {
+    const int dense = denseOf(scene, node);
+    const int parentDense = denseOf(scene, parent);
+    if (dense < 0 || (parent != G4F_SCENE_NODE_NULL && parentDense < 0)) {
+        g4f_set_last_error("g4f_scene_set_parent: invalid node");
+        return 0;
+    }
+    for (int32_t p = parentDense; p >= 0; p = scene->parent[(size_t)p]) {
+        if (p == dense) {
+            g4f_set_last_error("g4f_scene_set_parent: parent is inside the node's subtree");
+            return 0;
+        }
+    }
+    const int32_t oldParent = scene->parent[(size_t)dense];
+    if (oldParent == parentDense) return 1;
+    if (oldParent < 0) scene->rootCount--;
+    if (parentDense < 0) scene->rootCount++;
+    scene->parent[(size_t)dense] = parentDense;
+    scene->layoutDirty = true;
+    markDirty(scene, dense);
+    return 1;
+}
+
+g4f_scene_node g4f_scene_parent(const g4f_scene* scene, g4f_scene_node node) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0 || scene->parent[(size_t)dense] < 0) return G4F_SCENE_NODE_NULL;
+    return scene->handle[(size_t)scene->parent[(size_t)dense]];
+}
+
+void g4f_scene_set_local(g4f_scene* scene, g4f_scene_node node, g4f_vec3 translation, g4f_quat rotation, g4f_vec3 scale) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    scene->translation[(size_t)dense] = translation;
+    scene->rotation[(size_t)dense] = rotation;
+    scene->scale[(size_t)dense] = scale;
+    markDirty(scene, dense);
+}
+
+void g4f_scene_set_translation(g4f_scene* scene, g4f_scene_node node, g4f_vec3 translation) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    scene->translation[(size_t)dense] = translation;
+    markDirty(scene, dense);
+}
+
+void g4f_scene_set_rotation(g4f_scene* scene, g4f_scene_node node, g4f_quat rotation) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    scene->rotation[(size_t)dense] = rotation;
+    markDirty(scene, dense);
+}
+
+void g4f_scene_set_scale(g4f_scene* scene, g4f_scene_node node, g4f_vec3 scale) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    scene->scale[(size_t)dense] = scale;
+    markDirty(scene, dense);
+}
+
+int g4f_scene_get_local(const g4f_scene* scene, g4f_scene_node node, g4f_vec3* translation, g4f_quat* rotation, g4f_vec3* scale) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return 0;
+    if (translation) *translation = scene->translation[(size_t)dense];
+    if (rotation) *rotation = scene->rotation[(size_t)dense];
+    if (scale) *scale = scene->scale[(size_t)dense];
+    return 1;
+}
+
+void g4f_scene_update(g4f_scene* scene, g4f_jobs* jobs) {
+    if (!scene) return;
+    ensureLayout(scene);
+
+    // Flagged nodes in depth-first order; a flagged node inside an already selected subtree is
+    // covered by it, so the selected ranges are disjoint.
+    scene->order.clear();
+    for (uint32_t h : scene->dirtyNodes) {
+        const int dense = denseOf(scene, h);
+        if (dense >= 0 && scene->dirty[(size_t)dense]) scene->order.push_back(dense);
+    }
+    scene->dirtyNodes.clear();
+    std::sort(scene->order.begin(), scene->order.end());
+
+    scene->ranges.clear();
+    int coverEnd = 0;
+    int total = 0;
+    for (int32_t dense : scene->order) {
+        if (dense < coverEnd) continue;
+        scene->ranges.push_back(dense);
+        coverEnd = dense + scene->subtreeSize[(size_t)dense];
+        total += scene->subtreeSize[(size_t)dense];
+    }
+
+    const int rangeCount = (int)scene->ranges.size();
+    if (rangeCount > 0) {
+        g4f_jobs_parallel_for(total >= kParallelMinNodes ? jobs : nullptr, rangeCount, 0, updateRangesJob, scene);
+    }
+    scene->updatedNodes = total;
+    scene->updatedRanges = rangeCount;
+}
+
+const g4f_mat4* g4f_scene_world(const g4f_scene* scene, g4f_scene_node node) {
+    const int dense = denseOf(scene, node);
+    return dense >= 0 ? &scene->world[(size_t)dense] : nullptr;
+}
+
+void g4f_scene_get_stats(const g4f_scene* scene, g4f_scene_stats* out) {
+    if (!out) return;
+    *out = g4f_scene_stats{};
+    if (!scene) return;
+    out->nodeCount = scene->aliveCount;
+    out->rootCount = scene->rootCount;
+    out->updatedNodes = scene->updatedNodes;
+    out->updatedRanges = scene->updatedRanges;
+    out->layoutRebuilds = scene->layoutRebuilds;
+    out->occludedDraws = scene->occludedDraws;
+}
+
+void g4f_scene_set_renderable(g4f_scene* scene, g4f_scene_node node, const g4f_gfx_mesh* mesh, const g4f_gfx_material* material) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    if (scene->mesh[(size_t)dense] == mesh && scene->material[(size_t)dense] == material) return;
+    scene->mesh[(size_t)dense] = mesh;
+    scene->material[(size_t)dense] = material;
+    scene->drawOrderDirty = true;
+}
+
+void g4f_scene_set_lod(g4f_scene* scene, g4f_scene_node node, const g4f_lod_chain* chain) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    if (scene->lodChain[(size_t)dense] != chain) scene->lodLevel[(size_t)dense] = -1;
+    scene->lodChain[(size_t)dense] = chain;
+}
+
+void g4f_scene_set_lod_view(g4f_scene* scene, const g4f_lod_view* view) {
+    if (!scene) return;
+    scene->hasLodView = view != nullptr;
+    if (view) scene->lodView = *view;
+}
+
+void g4f_scene_set_bounds(g4f_scene* scene, g4f_scene_node node, const g4f_aabb* localBounds) {
+    const int dense = denseOf(scene, node);
+    if (dense < 0) return;
+    scene->hasBounds[(size_t)dense] = localBounds != nullptr;
+    if (localBounds) scene->bounds[(size_t)dense] = *localBounds;
+}
+
+void g4f_scene_set_occlusion(g4f_scene* scene, const g4f_occlusion* occlusion) {
+    if (scene) scene->occlusion = occlusion;
+}
+
+int g4f_scene_build_draws(g4f_scene* scene, const g4f_mat4* viewProj, g4f_jobs* jobs) {
+    if (!scene || !viewProj) {
+        g4f_set_last_error("g4f_scene_build_draws: invalid args");
+        return 0;
+    }
+    g4f_scene_update(scene, jobs);
+    if (scene->drawOrderDirty) rebuildDrawOrder(scene);
+
+    const int count = (int)scene->drawOrder.size();
+    scene->viewProj = *viewProj;
+    scene->draws.resize((size_t)count);
+    scene->drawVisible.assign(scene->occlusion ? (size_t)count : 0u, 1);
+    if (count > 0) g4f_jobs_parallel_for(count >= kParallelMinNodes ? jobs : nullptr, count, 0, drawsJob, scene);
+
+    // Drop occluded draws, keeping the material/mesh grouping.
+    int kept = count;
+    if (scene->occlusion) {
+        kept = 0;
+        for (int k = 0; k < count; k++) {
+            if (scene->drawVisible[(size_t)k]) scene->draws[(size_t)kept++] = scene->draws[(size_t)k];
+        }
+        scene->draws.resize((size_t)kept);
+    }
+    scene->occludedDraws = count - kept;
+    return kept;
+}
+
+const g4f_scene_draw* g4f_scene_draws(const g4f_scene* scene, int* count) {
+    if (count) *count = scene ? (int)scene->draws.size() : 0;
+    return (scene && !scene->draws.empty()) ? scene->draws.data() : nullptr;
+}
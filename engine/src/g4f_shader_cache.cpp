@@ -0,0 +1,165 @@
+#include "../include/g4f/g4f_shader_cache.h"
+
+#include "g4f_error_internal.h"
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <thread>
+
+#ifdef _WIN32
+#include <process.h>
+#else
+#include <unistd.h>
+#endif
+
+namespace {
+
+constexpr char kMagic[4] = {'G', '4', 'F', 'S'};
+constexpr uint32_t kFormatVersion = 1;
+
+struct CacheFileHeader {
+    char magic[4];
+    uint32_t version;
+    uint64_t key;
+    uint64_t size;
+    uint64_t checksum;
+};
+
+constexpr uint64_t kFnvOffset = 1469598103934665603ull;
+constexpr uint64_t kFnvPrime = 1099511628211ull;
+
+static uint64_t fnv1a(uint64_t h, const void* data, size_t size) {
+    const uint8_t* p = (const uint8_t*)data;
+    for (size_t i = 0; i < size; i++) {
+        h ^= p[i];
+        h *= kFnvPrime;
+    }
+    return h;
+}
+
+// Hashes the string including its terminator so ("ab", "c") and ("a", "bc") differ.
+static uint64_t fnv1aString(uint64_t h, const char* s) {
+    if (!s) s = "";
+    return fnv1a(h, s, std::strlen(s) + 1);
+}
+
+static std::filesystem::path pathFromUtf8(const char* utf8) {
+    return std::filesystem::path(std::u8string((const char8_t*)utf8));
+}
+
+static std::filesystem::path entryPath(const char* dirUtf8, uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.cso", (unsigned long long)key);
+    return pathFromUtf8(dirUtf8) / name;
+}
+
+// Temporary file name unique to this writer (process, thread, call), so concurrent stores of
+// one key never write into the same file before their renames.
+static std::string tempSuffix() {
+    static std::atomic<uint32_t> counter{0};
+#ifdef _WIN32
+    const unsigned long pid = (unsigned long)_getpid();
+#else
+    const unsigned long pid = (unsigned long)getpid();
+#endif
+    const size_t thread = std::hash<std::thread::id>{}(std::this_thread::get_id());
+    char suffix[64];
+    std::snprintf(suffix, sizeof(suffix), ".%lu.%zx.%u.tmp", pid, thread, counter.fetch_add(1));
+    return suffix;
+}
+
+} // namespace
+
+uint64_t g4f_shader_cache_key(const char* source, const char* entryPoint, const char* profile, uint32_t compilerVersion, uint32_t flags) {
+    uint64_t h = kFnvOffset;
+    h = fnv1aString(h, source);
+    h = fnv1aString(h, entryPoint);
+    h = fnv1aString(h, profile);
+    h = fnv1a(h, &compilerVersion, sizeof(compilerVersion));
+    h = fnv1a(h, &flags, sizeof(flags));
+    return h;
+}
+
+int g4f_shader_cache_load(const char* dirUtf8, uint64_t key, void** outBytes, size_t* outSize) {
+    if (outBytes) *outBytes = nullptr;
+    if (outSize) *outSize = 0;
+    if (!dirUtf8 || !dirUtf8[0] || !outBytes || !outSize) return 0;
+
+    std::ifstream in(entryPath(dirUtf8, key), std::ios::binary);
+    if (!in) return 0;
+
+    CacheFileHeader header{};
+    if (!in.read((char*)&header, sizeof(header))) return 0;
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 || header.version != kFormatVersion) return 0;
+    if (header.key != key || header.size == 0 || header.size > (64ull << 20)) return 0;
+
+    void* bytes = std::malloc((size_t)header.size);
+    if (!bytes) return 0;
+    if (!in.read((char*)bytes, (std::streamsize)header.size) || fnv1a(kFnvOffset, bytes, (size_t)header.size) != header.checksum) {
+        std::free(bytes);
+        return 0;
+    }
+
+    *outBytes = bytes;
+    *outSize = (size_t)header.size;
+    return 1;
+}
+
+int g4f_shader_cache_store(const char* dirUtf8, uint64_t key, const void* bytes, size_t size) {
+    if (!dirUtf8 || !dirUtf8[0] || !bytes || size == 0) {
+        g4f_set_last_error("g4f_shader_cache_store: invalid args");
+        return 0;
+    }
+
+    std::error_code ec;
+    std::filesystem::create_directories(pathFromUtf8(dirUtf8), ec);
+    if (ec) {
+        g4f_set_last_errorf("g4f_shader_cache_store: cannot create directory (%s)", ec.message().c_str());
+        return 0;
+    }
+
+    CacheFileHeader header{};
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kFormatVersion;
+    header.key = key;
+    header.size = (uint64_t)size;
+    header.checksum = fnv1a(kFnvOffset, bytes, size);
+
+    const std::filesystem::path finalPath = entryPath(dirUtf8, key);
+    std::filesystem::path tmpPath = finalPath;
+    tmpPath += tempSuffix();
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        if (!out) {
+            g4f_set_last_error("g4f_shader_cache_store: cannot open temporary file");
+            return 0;
+        }
+        out.write((const char*)&header, sizeof(header));
+        out.write((const char*)bytes, (std::streamsize)size);
+        if (!out) {
+            out.close();
+            std::filesystem::remove(tmpPath, ec);
+            g4f_set_last_error("g4f_shader_cache_store: write failed");
+            return 0;
+        }
+    }
+
+    std::filesystem::rename(tmpPath, finalPath, ec);
+    if (ec) {
+        std::filesystem::remove(tmpPath, ec);
+        g4f_set_last_error("g4f_shader_cache_store: rename failed");
+        return 0;
+    }
+    return 1;
+}
+
+void g4f_shader_cache_free(void* bytes) {
+    std::free(bytes);
+}
@@ -0,0 +1,196 @@
+#pragma once
+
+// Internal 4-wide SIMD helpers shared by CPU-side engine modules.
+// - SSE2 is the baseline on Win64 (x86_64), so no runtime dispatch is needed.
+// - A scalar fallback keeps the same semantics when SSE2 is unavailable or when
+//   G4F_SIMD_DISABLE is defined (useful to cross-check results in tests).
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#if !defined(G4F_SIMD_DISABLE) && (defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64))
+#define G4F_SIMD_SSE2 1
+#include <emmintrin.h>
+#else
+#define G4F_SIMD_SSE2 0
+#endif
+
+namespace g4f::simd {
+
+#if G4F_SIMD_SSE2
+
+struct F4 { __m128 v; };
+struct I4 { __m128i v; };
+
+static inline F4 f4Set1(float a) { return F4{_mm_set1_ps(a)}; }
+static inline F4 f4Set(float a, float b, float c, float d) { return F4{_mm_setr_ps(a, b, c, d)}; }
+static inline F4 f4Load(const float* p) { return F4{_mm_loadu_ps(p)}; }
+static inline void f4Store(float* p, F4 a) { _mm_storeu_ps(p, a.v); }
+
+static inline F4 operator+(F4 a, F4 b) { return F4{_mm_add_ps(a.v, b.v)}; }
+static inline F4 operator-(F4 a, F4 b) { return F4{_mm_sub_ps(a.v, b.v)}; }
+static inline F4 operator*(F4 a, F4 b) { return F4{_mm_mul_ps(a.v, b.v)}; }
+static inline F4 operator/(F4 a, F4 b) { return F4{_mm_div_ps(a.v, b.v)}; }
+static inline F4 f4Min(F4 a, F4 b) { return F4{_mm_min_ps(a.v, b.v)}; }
+static inline F4 f4Max(F4 a, F4 b) { return F4{_mm_max_ps(a.v, b.v)}; }
+static inline F4 f4Sqrt(F4 a) { return F4{_mm_sqrt_ps(a.v)}; }
+
+// Comparisons return all-ones/all-zeros lane masks.
+static inline F4 f4Lt(F4 a, F4 b) { return F4{_mm_cmplt_ps(a.v, b.v)}; }
+static inline F4 f4Le(F4 a, F4 b) { return F4{_mm_cmple_ps(a.v, b.v)}; }
+static inline F4 f4Gt(F4 a, F4 b) { return F4{_mm_cmpgt_ps(a.v, b.v)}; }
+static inline F4 f4Ge(F4 a, F4 b) { return F4{_mm_cmpge_ps(a.v, b.v)}; }
+static inline F4 f4And(F4 a, F4 b) { return F4{_mm_and_ps(a.v, b.v)}; }
+static inline F4 f4Or(F4 a, F4 b) { return F4{_mm_or_ps(a.v, b.v)}; }
+static inline F4 f4Xor(F4 a, F4 b) { return F4{_mm_xor_ps(a.v, b.v)}; }
+// mask ? a : b
+static inline F4 f4Select(F4 mask, F4 a, F4 b) { return F4{_mm_or_ps(_mm_and_ps(mask.v, a.v), _mm_andnot_ps(mask.v, b.v))}; }
+static inline int f4MoveMask(F4 mask) { return _mm_movemask_ps(mask.v); }
+
+static inline F4 f4Floor(F4 a) {
+    // SSE2 has no round-down; truncate and fix up negatives. Valid for |a| < 2^31.
+    __m128 t = _mm_cvtepi32_ps(_mm_cvttps_epi32(a.v));
+    __m128 fix = _mm_and_ps(_mm_cmpgt_ps(t, a.v), _mm_set1_ps(1.0f));
+    return F4{_mm_sub_ps(t, fix)};
+}
+
+static inline I4 i4Set1(int32_t a) { return I4{_mm_set1_epi32(a)}; }
+static inline I4 i4FromF4(F4 a) { return I4{_mm_cvttps_epi32(a.v)}; } // truncates
+static inline F4 f4FromI4(I4 a) { return F4{_mm_cvtepi32_ps(a.v)}; }
+static inline F4 f4FromBits(I4 a) { return F4{_mm_castsi128_ps(a.v)}; }
+static inline I4 i4FromBits(F4 a) { return I4{_mm_castps_si128(a.v)}; }
+static inline I4 i4Load(const int32_t* p) { return I4{_mm_loadu_si128((const __m128i*)p)}; }
+static inline void i4Store(int32_t* p, I4 a) { _mm_storeu_si128((__m128i*)p, a.v); }
+
+static inline I4 operator+(I4 a, I4 b) { return I4{_mm_add_epi32(a.v, b.v)}; }
+static inline I4 operator-(I4 a, I4 b) { return I4{_mm_sub_epi32(a.v, b.v)}; }
+static inline I4 operator^(I4 a, I4 b) { return I4{_mm_xor_si128(a.v, b.v)}; }
+static inline I4 operator&(I4 a, I4 b) { return I4{_mm_and_si128(a.v, b.v)}; }
+static inline I4 operator|(I4 a, I4 b) { return I4{_mm_or_si128(a.v, b.v)}; }
+static inline I4 i4Srl(I4 a, int n) { return I4{_mm_srl_epi32(a.v, _mm_cvtsi32_si128(n))}; }
+static inline I4 i4Sll(I4 a, int n) { return I4{_mm_sll_epi32(a.v, _mm_cvtsi32_si128(n))}; }
+static inline I4 i4Eq(I4 a, I4 b) { return I4{_mm_cmpeq_epi32(a.v, b.v)}; }
+
+static inline I4 i4MulLo(I4 a, I4 b) {
+    // SSE2 lacks pmulld; combine two 32x32->64 multiplies on even/odd lanes.
+    __m128i even = _mm_mul_epu32(a.v, b.v);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a.v, 32), _mm_srli_epi64(b.v, 32));
+    __m128i lo = _mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0));
+    __m128i hi = _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0));
+    return I4{_mm_unpacklo_epi32(lo, hi)};
+}
+
+static inline float f4Lane(F4 a, int i) {
+    alignas(16) float tmp[4];
+    _mm_store_ps(tmp, a.v);
+    return tmp[i];
+}
+
+static inline int32_t i4Lane(I4 a, int i) {
+    alignas(16) int32_t tmp[4];
+    _mm_store_si128((__m128i*)tmp, a.v);
+    return tmp[i];
+}
+
+#else
+
+struct F4 { float v[4]; };
+struct I4 { int32_t v[4]; };
+
+#define G4F_SIMD_LANES(expr) for (int i = 0; i < 4; i++) { expr; }
+
+static inline F4 f4Set1(float a) { return F4{{a, a, a, a}}; }
+static inline F4 f4Set(float a, float b, float c, float d) { return F4{{a, b, c, d}}; }
+static inline F4 f4Load(const float* p) { return F4{{p[0], p[1], p[2], p[3]}}; }
+static inline void f4Store(float* p, F4 a) { G4F_SIMD_LANES(p[i] = a.v[i]) }
+
+static inline F4 operator+(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] + b.v[i]) return r; }
+static inline F4 operator-(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] - b.v[i]) return r; }
+static inline F4 operator*(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] * b.v[i]) return r; }
+static inline F4 operator/(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] / b.v[i]) return r; }
+static inline F4 f4Min(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = (b.v[i] < a.v[i]) ? b.v[i] : a.v[i]) return r; }
+static inline F4 f4Max(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = (b.v[i] > a.v[i]) ? b.v[i] : a.v[i]) return r; }
+static inline F4 f4Sqrt(F4 a) { F4 r; G4F_SIMD_LANES(r.v[i] = std::sqrt(a.v[i])) return r; }
+
+static inline float maskLane(bool on) {
+    uint32_t bits = on ? 0xFFFFFFFFu : 0u;
+    float out;
+    std::memcpy(&out, &bits, sizeof(out));
+    return out;
+}
+static inline uint32_t laneBits(float f) {
+    uint32_t bits;
+    std::memcpy(&bits, &f, sizeof(bits));
+    return bits;
+}
+
+static inline F4 f4Lt(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = maskLane(a.v[i] < b.v[i])) return r; }
+static inline F4 f4Le(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = maskLane(a.v[i] <= b.v[i])) return r; }
+static inline F4 f4Gt(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = maskLane(a.v[i] > b.v[i])) return r; }
+static inline F4 f4Ge(F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = maskLane(a.v[i] >= b.v[i])) return r; }
+static inline F4 f4And(F4 a, F4 b) {
+    F4 r;
+    G4F_SIMD_LANES(uint32_t bits = laneBits(a.v[i]) & laneBits(b.v[i]); std::memcpy(&r.v[i], &bits, 4))
+    return r;
+}
+static inline F4 f4Or(F4 a, F4 b) {
+    F4 r;
+    G4F_SIMD_LANES(uint32_t bits = laneBits(a.v[i]) | laneBits(b.v[i]); std::memcpy(&r.v[i], &bits, 4))
+    return r;
+}
+static inline F4 f4Xor(F4 a, F4 b) {
+    F4 r;
+    G4F_SIMD_LANES(uint32_t bits = laneBits(a.v[i]) ^ laneBits(b.v[i]); std::memcpy(&r.v[i], &bits, 4))
+    return r;
+}
+static inline F4 f4Select(F4 mask, F4 a, F4 b) { F4 r; G4F_SIMD_LANES(r.v[i] = laneBits(mask.v[i]) ? a.v[i] : b.v[i]) return r; }
+static inline int f4MoveMask(F4 mask) {
+    int bits = 0;
+    G4F_SIMD_LANES(if (laneBits(mask.v[i]) & 0x80000000u) bits |= (1 << i))
+    return bits;
+}
+static inline F4 f4Floor(F4 a) { F4 r; G4F_SIMD_LANES(r.v[i] = std::floor(a.v[i])) return r; }
+
+static inline I4 i4Set1(int32_t a) { return I4{{a, a, a, a}}; }
+static inline I4 i4FromF4(F4 a) { I4 r; G4F_SIMD_LANES(r.v[i] = (int32_t)a.v[i]) return r; }
+static inline F4 f4FromI4(I4 a) { F4 r; G4F_SIMD_LANES(r.v[i] = (float)a.v[i]) return r; }
+static inline F4 f4FromBits(I4 a) { F4 r; G4F_SIMD_LANES(std::memcpy(&r.v[i], &a.v[i], 4)) return r; }
+static inline I4 i4FromBits(F4 a) { I4 r; G4F_SIMD_LANES(std::memcpy(&r.v[i], &a.v[i], 4)) return r; }
+static inline I4 i4Load(const int32_t* p) { return I4{{p[0], p[1], p[2], p[3]}}; }
+static inline void i4Store(int32_t* p, I4 a) { G4F_SIMD_LANES(p[i] = a.v[i]) }
+
+static inline I4 operator+(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = (int32_t)((uint32_t)a.v[i] + (uint32_t)b.v[i])) return r; }
+static inline I4 operator-(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = (int32_t)((uint32_t)a.v[i] - (uint32_t)b.v[i])) return r; }
+static inline I4 operator^(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] ^ b.v[i]) return r; }
+static inline I4 operator&(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] & b.v[i]) return r; }
+static inline I4 operator|(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = a.v[i] | b.v[i]) return r; }
+static inline I4 i4Srl(I4 a, int n) { I4 r; G4F_SIMD_LANES(r.v[i] = (int32_t)((uint32_t)a.v[i] >> n)) return r; }
+static inline I4 i4Sll(I4 a, int n) { I4 r; G4F_SIMD_LANES(r.v[i] = (int32_t)((uint32_t)a.v[i] << n)) return r; }
+static inline I4 i4Eq(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = (a.v[i] == b.v[i]) ? -1 : 0) return r; }
+static inline I4 i4MulLo(I4 a, I4 b) { I4 r; G4F_SIMD_LANES(r.v[i] = (int32_t)((uint32_t)a.v[i] * (uint32_t)b.v[i])) return r; }
+
+static inline float f4Lane(F4 a, int i) { return a.v[i]; }
+static inline int32_t i4Lane(I4 a, int i) { return a.v[i]; }
+
+#undef G4F_SIMD_LANES
+
+#endif
+
+static inline F4 f4Clamp(F4 a, F4 lo, F4 hi) { return f4Min(f4Max(a, lo), hi); }
+static inline F4 f4Lerp(F4 a, F4 b, F4 t) { return a + (b - a) * t; }
+static inline F4 f4MulAdd(F4 a, F4 b, F4 c) { return a * b + c; }
+
+// out = a * b for row-major 4x4 matrices (g4f_mat4 layout); out must not alias b.
+static inline void mat4Mul(const float* a, const float* b, float* out) {
+    const F4 b0 = f4Load(b + 0);
+    const F4 b1 = f4Load(b + 4);
+    const F4 b2 = f4Load(b + 8);
+    const F4 b3 = f4Load(b + 12);
+    for (int r = 0; r < 4; r++) {
+        const float* row = a + r * 4;
+        f4Store(out + r * 4, f4Set1(row[0]) * b0 + f4Set1(row[1]) * b1 + f4Set1(row[2]) * b2 + f4Set1(row[3]) * b3);
+    }
+}
+
+} // namespace g4f::simd
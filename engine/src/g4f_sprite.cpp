@@ -0,0 +1,226 @@
+#include "../include/g4f/g4f_sprite.h"
+
+#include "g4f_error_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr uint32_t kMaxTextures = 1u << 16; // texture IDs share the 32-bit sort key with the layer
+
+} // namespace
+
+struct g4f_sprite_batch {
+    int sortMode = G4F_SPRITE_SORT_TEXTURE;
+    std::vector<g4f_sprite> sprites;
+    std::vector<uint32_t> textureIds; // per sprite
+    std::vector<const g4f_gfx_texture*> textures; // by ID, first-use order
+    std::unordered_map<const g4f_gfx_texture*, uint32_t> textureLookup;
+    const g4f_gfx_texture* lastTexture = nullptr;
+    uint32_t lastTextureId = 0;
+
+    std::vector<uint32_t> keys;
+    std::vector<uint32_t> order;
+    std::vector<uint32_t> scratchKeys;
+    std::vector<uint32_t> scratchOrder;
+    std::vector<g4f_sprite_vertex> vertices;
+    std::vector<g4f_sprite_range> ranges;
+    bool built = false;
+};
+
+namespace {
+
+static uint32_t textureId(g4f_sprite_batch* b, const g4f_gfx_texture* texture) {
+    if (!b->textures.empty() && texture == b->lastTexture) return b->lastTextureId;
+    auto it = b->textureLookup.find(texture);
+    uint32_t id = 0;
+    if (it != b->textureLookup.end()) {
+        id = it->second;
+    } else {
+        id = (uint32_t)b->textures.size();
+        b->textures.push_back(texture);
+        b->textureLookup.emplace(texture, id);
+    }
+    b->lastTexture = texture;
+    b->lastTextureId = id;
+    return id;
+}
+
+static uint32_t sortKey(const g4f_sprite& s, uint32_t texture) {
+    const int layer = std::clamp(s.layer, -32768, 32767);
+    return (uint32_t)(layer + 32768) << 16 | texture;
+}
+
+// Stable LSD radix sort of (key, index) pairs, 8 bits per pass; passes where every key has the
+// same digit are skipped (typically all but one or two: few layers, few textures).
+static void radixSort(g4f_sprite_batch* b) {
+    const size_t n = b->keys.size();
+    b->scratchKeys.resize(n);
+    b->scratchOrder.resize(n);
+    uint32_t* keys = b->keys.data();
+    uint32_t* order = b->order.data();
+    uint32_t* tmpKeys = b->scratchKeys.data();
+    uint32_t* tmpOrder = b->scratchOrder.data();
+    for (int shift = 0; shift < 32; shift += 8) {
+        size_t counts[256] = {};
+        for (size_t i = 0; i < n; i++) counts[(keys[i] >> shift) & 255u]++;
+        if (counts[(keys[0] >> shift) & 255u] == n) continue;
+        size_t offset = 0;
+        for (size_t& c : counts) {
+            const size_t count = c;
+            c = offset;
+            offset += count;
+        }
+        for (size_t i = 0; i < n; i++) {
+            const size_t dst = counts[(keys[i] >> shift) & 255u]++;
+            tmpKeys[dst] = keys[i];
+            tmpOrder[dst] = order[i];
+        }
+        std::swap(keys, tmpKeys);
+        std::swap(order, tmpOrder);
+    }
+    if (keys != b->keys.data()) {
+        std::memcpy(b->keys.data(), keys, n * sizeof(uint32_t));
+        std::memcpy(b->order.data(), order, n * sizeof(uint32_t));
+    }
+}
+
+static void expandSprite(const g4f_sprite& s, g4f_sprite_vertex* v) {
+    const float x0 = -s.pivotX * s.width, x1 = x0 + s.width;
+    const float y0 = -s.pivotY * s.height, y1 = y0 + s.height;
+    if (s.rotation == 0.0f) {
+        v[0] = {s.x + x0, s.y + y0, s.u0, s.v0, s.rgba};
+        v[1] = {s.x + x1, s.y + y0, s.u1, s.v0, s.rgba};
+        v[2] = {s.x + x0, s.y + y1, s.u0, s.v1, s.rgba};
+        v[3] = {s.x + x1, s.y + y1, s.u1, s.v1, s.rgba};
+        return;
+    }
+    // y points down, so rotating (1, 0) towards +y turns clockwise on screen.
+    const float c = std::cos(s.rotation), sn = std::sin(s.rotation);
+    v[0] = {s.x + x0 * c - y0 * sn, s.y + x0 * sn + y0 * c, s.u0, s.v0, s.rgba};
+    v[1] = {s.x + x1 * c - y0 * sn, s.y + x1 * sn + y0 * c, s.u1, s.v0, s.rgba};
+    v[2] = {s.x + x0 * c - y1 * sn, s.y + x0 * sn + y1 * c, s.u0, s.v1, s.rgba};
+    v[3] = {s.x + x1 * c - y1 * sn, s.y + x1 * sn + y1 * c, s.u1, s.v1, s.rgba};
+}
+
+} // namespace
+
+extern "C" {
+
+g4f_sprite g4f_sprite_make(float x, float y, float width, float height) {
+    g4f_sprite s{};
+    s.x = x;
+    s.y = y;
+    s.width = width;
+    s.height = height;
+    s.u1 = 1.0f;
+    s.v1 = 1.0f;
+    s.rgba = 0xFFFFFFFFu;
+    return s;
+}
+
+g4f_sprite_batch* g4f_sprite_batch_create(int sortMode) {
+    auto* batch = new g4f_sprite_batch();
+    g4f_sprite_batch_set_sort_mode(batch, sortMode);
+    return batch;
+}
+
+void g4f_sprite_batch_destroy(g4f_sprite_batch* batch) {
+    delete batch;
+}
+
+void g4f_sprite_batch_set_sort_mode(g4f_sprite_batch* batch, int sortMode) {
+    if (!batch) return;
+    batch->sortMode = sortMode == G4F_SPRITE_SORT_SUBMISSION ? G4F_SPRITE_SORT_SUBMISSION : G4F_SPRITE_SORT_TEXTURE;
+    batch->built = false;
+}
+
+void g4f_sprite_batch_clear(g4f_sprite_batch* batch) {
+    if (!batch) return;
+    batch->sprites.clear();
+    batch->textureIds.clear();
+    batch->textures.clear();
+    batch->textureLookup.clear();
+    batch->lastTexture = nullptr;
+    batch->vertices.clear();
+    batch->ranges.clear();
+    batch->built = false;
+}
+
+void g4f_sprite_batch_add_many(g4f_sprite_batch* batch, const g4f_gfx_texture* texture, const g4f_sprite* sprites, int count) {
+    if (!batch || !sprites || count <= 0) return;
+    if (batch->textures.size() >= kMaxTextures && !batch->textureLookup.count(texture)) {
+        g4f_set_last_error("g4f_sprite_batch_add: more than 65536 textures in one batch");
+        return;
+    }
+    const uint32_t id = textureId(batch, texture);
+    if (count == 1) {
+        batch->sprites.push_back(*sprites);
+        batch->textureIds.push_back(id);
+    } else {
+        batch->sprites.insert(batch->sprites.end(), sprites, sprites + count);
+        batch->textureIds.insert(batch->textureIds.end(), (size_t)count, id);
+    }
+    batch->built = false;
+}
+
+void g4f_sprite_batch_add(g4f_sprite_batch* batch, const g4f_gfx_texture* texture, const g4f_sprite* sprite) {
+    g4f_sprite_batch_add_many(batch, texture, sprite, 1);
+}
+
+int g4f_sprite_batch_count(const g4f_sprite_batch* batch) {
+    return batch ? (int)batch->sprites.size() : 0;
+}
+
+int g4f_sprite_batch_build(g4f_sprite_batch* batch) {
+    if (!batch) return 0;
+    const size_t n = batch->sprites.size();
+    batch->order.resize(n);
+    for (size_t i = 0; i < n; i++) batch->order[i] = (uint32_t)i;
+    if (batch->sortMode == G4F_SPRITE_SORT_TEXTURE && n > 1) {
+        batch->keys.resize(n);
+        bool sorted = true;
+        for (size_t i = 0; i < n; i++) {
+            batch->keys[i] = sortKey(batch->sprites[i], batch->textureIds[i]);
+            sorted = sorted && (i == 0 || batch->keys[i - 1] <= batch->keys[i]);
+        }
+        if (!sorted) radixSort(batch);
+    }
+
+    batch->vertices.resize(n * 4);
+    batch->ranges.clear();
+    g4f_sprite_vertex* v = batch->vertices.data();
+    for (size_t i = 0; i < n; i++) {
+        const uint32_t src = batch->order[i];
+        expandSprite(batch->sprites[src], v + i * 4);
+        const g4f_gfx_texture* texture = batch->textures[batch->textureIds[src]];
+        if (batch->ranges.empty() || batch->ranges.back().texture != texture) {
+            batch->ranges.push_back(g4f_sprite_range{texture, (int)i, 0});
+        }
+        batch->ranges.back().spriteCount++;
+    }
+    batch->built = true;
+    return (int)batch->ranges.size();
+}
+
+const g4f_sprite_vertex* g4f_sprite_batch_vertices(const g4f_sprite_batch* batch, int* outVertexCount) {
+    const bool ok = batch && batch->built;
+    if (outVertexCount) *outVertexCount = ok ? (int)batch->vertices.size() : 0;
+    return ok ? batch->vertices.data() : nullptr;
+}
+
+int g4f_sprite_batch_range_count(const g4f_sprite_batch* batch) {
+    return batch && batch->built ? (int)batch->ranges.size() : 0;
+}
+
+int g4f_sprite_batch_get_range(const g4f_sprite_batch* batch, int index, g4f_sprite_range* outRange) {
+    if (!outRange || index < 0 || index >= g4f_sprite_batch_range_count(batch)) return 0;
+    *outRange = batch->ranges[(size_t)index];
+    return 1;
+}
+
+} // extern "C"
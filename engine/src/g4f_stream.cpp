@@ -0,0 +1,394 @@
+#include "../include/g4f/g4f_stream.h"
+#include "../include/g4f/g4f_jobs.h"
+
+#include "g4f_error_internal.h"
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+constexpr int kMaxLoadRadius = 256;
+constexpr int kMaxGeneratorThreads = 64;
+
+enum CellState : uint8_t {
+    CellRequested = 0, // queued, generating, or generated and waiting for upload
+    CellResident = 1,
+};
+
+struct StreamCell {
+    void* handle = nullptr;
+    size_t bytes = 0;
+    uint64_t lastUsed = 0;
+    CellState state = CellRequested;
+};
+
+struct StreamRequest {
+    int x, z;
+    float dist2;
+};
+
+struct StreamPayload {
+    int x, z;
+    void* payload;
+    size_t uploadBytes;
+    float dist2;
+};
+
+static uint64_t cellKey(int x, int z) { return ((uint64_t)(uint32_t)x << 32) | (uint64_t)(uint32_t)z; }
+static int cellKeyX(uint64_t key) { return (int)(uint32_t)(key >> 32); }
+static int cellKeyZ(uint64_t key) { return (int)(uint32_t)key; }
+
+} // namespace
+
+struct g4f_stream {
+    g4f_stream_desc desc{};
+    g4f_stream_backend backend{};
+    std::vector<std::thread> threads;
+
+    // Shared with the generator threads.
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle;
+    std::vector<StreamRequest> queue;     // sorted farthest first; generators pop the back
+    std::vector<StreamPayload> generated; // finished by generators, not yet seen by update
+    int generating = 0;
+    bool quit = false;
+
+    // Owned by the updating thread.
+    std::unordered_map<uint64_t, StreamCell> cells;
+    std::vector<StreamPayload> ready; // generated cells waiting for upload budget
+    int requested = 0;                // cells in CellRequested
+    uint64_t frame = 0;
+    int focusX = 0, focusZ = 0;
+    float focusPx = 0.0f, focusPz = 0.0f;
+    g4f_stream_stats stats{};
+};
+
+static float streamDist2(const g4f_stream* stream, int x, int z) {
+    const float dx = ((float)x + 0.5f) * stream->desc.cellSize - stream->focusPx;
+    const float dz = ((float)z + 0.5f) * stream->desc.cellSize - stream->focusPz;
+    return dx * dx + dz * dz;
+}
+
+static bool streamInRange(const g4f_stream* stream, int x, int z) {
+    const long long dx = (long long)x - stream->focusX, dz = (long long)z - stream->focusZ;
+    const long long r = stream->desc.loadRadius;
+    return dx * dx + dz * dz <= r * r;
+}
+
+static void streamForget(g4f_stream* stream, int x, int z) {
+    stream->cells.erase(cellKey(x, z));
+    stream->requested -= 1;
+}
+
+static void streamWorkerMain(g4f_stream* stream) {
+    for (;;) {
+        StreamRequest request{};
+        {
+            std::unique_lock<std::mutex> lock(stream->mutex);
+            stream->wake.wait(lock, [&] { return stream->quit || !stream->queue.empty(); });
+            if (stream->quit) return;
+            request = stream->queue.back();
+            stream->queue.pop_back();
+            stream->generating += 1;
+        }
+        size_t bytes = 0;
+        void* payload = stream->backend.generate(stream->backend.generateUser, request.x, request.z, &bytes);
+        {
+            std::lock_guard<std::mutex> lock(stream->mutex);
+            stream->generated.push_back(StreamPayload{request.x, request.z, payload, payload ? bytes : 0, 0.0f});
+            stream->generating -= 1;
+            if (stream->generating == 0 && stream->queue.empty()) stream->idle.notify_all();
+        }
+    }
+}
+
+g4f_stream_desc g4f_stream_desc_default(void) {
+    g4f_stream_desc d{};
+    d.cellSize = 16.0f;
+    d.loadRadius = 4;
+    d.memoryBudgetBytes = (size_t)256 << 20;
+    d.uploadBudgetBytes = (size_t)4 << 20;
+    d.maxUploadsPerUpdate = 0;
+    d.generatorThreads = std::max(1, g4f_jobs_hardware_threads() - 1);
+    d.maxInFlight = 4 * d.generatorThreads;
+    return d;
+}
+
+g4f_stream* g4f_stream_create(const g4f_stream_desc* desc, const g4f_stream_backend* backend) {
+    if (!backend || !backend->generate || !backend->upload || !backend->evict || !backend->discard) {
+        g4f_set_last_error("g4f_stream_create: backend needs generate, upload, evict and discard");
+        return nullptr;
+    }
+    g4f_stream_desc d = g4f_stream_desc_default();
+    if (desc) {
+        if (!(desc->cellSize >= 0.0f) || !std::isfinite(desc->cellSize) || desc->loadRadius < 0 || desc->loadRadius > kMaxLoadRadius ||
+            desc->maxUploadsPerUpdate < 0 || desc->generatorThreads < 0 || desc->maxInFlight < 0) {
+            g4f_set_last_error("g4f_stream_create: invalid desc");
+            return nullptr;
+        }
+        if (desc->cellSize > 0.0f) d.cellSize = desc->cellSize;
+        if (desc->loadRadius > 0) d.loadRadius = desc->loadRadius;
+        if (desc->memoryBudgetBytes > 0) d.memoryBudgetBytes = desc->memoryBudgetBytes;
+        if (desc->uploadBudgetBytes > 0) d.uploadBudgetBytes = desc->uploadBudgetBytes;
+        d.maxUploadsPerUpdate = desc->maxUploadsPerUpdate;
+        if (desc->generatorThreads > 0) d.generatorThreads = std::min(desc->generatorThreads, kMaxGeneratorThreads);
+        d.maxInFlight = desc->maxInFlight > 0 ? desc->maxInFlight : 4 * d.generatorThreads;
+    }
+
+    auto* stream = new g4f_stream();
+    stream->desc = d;
+    stream->backend = *backend;
+    stream->threads.reserve((size_t)d.generatorThreads);
+    for (int i = 0; i < d.generatorThreads; i++) stream->threads.emplace_back(streamWorkerMain, stream);
+    return stream;
+}
+
+void g4f_stream_destroy(g4f_stream* stream) {
+    if (!stream) return;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        stream->quit = true;
+        stream->queue.clear();
+    }
+    stream->wake.notify_all();
+    for (std::thread& t : stream->threads) t.join();
+
+    const g4f_stream_backend& b = stream->backend;
+    for (const StreamPayload& p : stream->generated) {
+        if (p.payload) b.discard(b.residencyUser, p.x, p.z, p.payload);
+    }
+    for (const StreamPayload& p : stream->ready) b.discard(b.residencyUser, p.x, p.z, p.payload);
+    for (const auto& kv : stream->cells) {
+        if (kv.second.state == CellResident) b.evict(b.residencyUser, cellKeyX(kv.first), cellKeyZ(kv.first), kv.second.handle);
+    }
+    delete stream;
+}
+
+void g4f_stream_cell_of(const g4f_stream* stream, g4f_vec3 position, int* cellX, int* cellZ) {
+    if (!stream) return;
+    const float s = stream->desc.cellSize;
+    if (cellX) *cellX = (int)std::floor(position.x / s);
+    if (cellZ) *cellZ = (int)std::floor(position.z / s);
+}
+
+void g4f_stream_update(g4f_stream* stream, const g4f_camera_fps* cam) {
+    if (!stream || !cam) return;
+    const g4f_stream_backend& b = stream->backend;
+    stream->frame += 1;
+    stream->focusPx = cam->position.x;
+    stream->focusPz = cam->position.z;
+    g4f_stream_cell_of(stream, cam->position, &stream->focusX, &stream->focusZ);
+
+    g4f_stream_stats& stats = stream->stats;
+    stats.uploadsLastUpdate = 0;
+    stats.uploadBytesLastUpdate = 0;
+    stats.evictionsLastUpdate = 0;
+
+    // Drop queued requests that left the radius, re-prioritize the rest, and collect finished work.
+    std::vector<StreamPayload> incoming;
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        size_t kept = 0;
+        for (const StreamRequest& r : stream->queue) {
+            if (!streamInRange(stream, r.x, r.z)) {
+                streamForget(stream, r.x, r.z);
+                continue;
+            }
+            stream->queue[kept++] = StreamRequest{r.x, r.z, streamDist2(stream, r.x, r.z)};
+        }
+        stream->queue.resize(kept);
+        incoming.swap(stream->generated);
+    }
+    for (StreamPayload& p : incoming) {
+        if (!p.payload) {
+            stats.failed += 1;
+            streamForget(stream, p.x, p.z);
+            continue;
+        }
+        stats.generated += 1;
+        stream->ready.push_back(p);
+    }
+
+    // Uploads, nearest first, within the per-update budget; stale payloads are discarded.
+    for (StreamPayload& p : stream->ready) p.dist2 = streamDist2(stream, p.x, p.z);
+    std::sort(stream->ready.begin(), stream->ready.end(), [](const StreamPayload& a, const StreamPayload& c) { return a.dist2 < c.dist2; });
+    size_t kept = 0;
+    bool budgetLeft = true;
+    for (const StreamPayload& p : stream->ready) {
+        if (!streamInRange(stream, p.x, p.z)) {
+            b.discard(b.residencyUser, p.x, p.z, p.payload);
+            stats.discarded += 1;
+            streamForget(stream, p.x, p.z);
+            continue;
+        }
+        if (budgetLeft && stats.uploadsLastUpdate > 0) {
+            const bool countOk = stream->desc.maxUploadsPerUpdate == 0 || stats.uploadsLastUpdate < stream->desc.maxUploadsPerUpdate;
+            budgetLeft = countOk && stats.uploadBytesLastUpdate + p.uploadBytes <= stream->desc.uploadBudgetBytes;
+        }
+        if (!budgetLeft) {
+            stream->ready[kept++] = p;
+            continue;
+        }
+        size_t residentBytes = 0;
+        void* handle = b.upload(b.residencyUser, p.x, p.z, p.payload, &residentBytes);
+        stats.uploadsLastUpdate += 1;
+        stats.uploadBytesLastUpdate += p.uploadBytes;
+        if (!handle) {
+            stats.failed += 1;
+            streamForget(stream, p.x, p.z);
+            continue;
+        }
+        StreamCell& cell = stream->cells[cellKey(p.x, p.z)];
+        cell.handle = handle;
+        cell.bytes = residentBytes;
+        cell.state = CellResident;
+        stream->requested -= 1;
+        stats.uploaded += 1;
+        stats.resident += 1;
+        stats.residentBytes += residentBytes;
+    }
+    stream->ready.resize(kept);
+
+    // Touch resident cells in range and request missing ones, nearest first.
+    std::vector<StreamRequest> missing;
+    const int r = stream->desc.loadRadius;
+    for (int dz = -r; dz <= r; dz++) {
+        for (int dx = -r; dx <= r; dx++) {
+            const int x = stream->focusX + dx, z = stream->focusZ + dz;
+            if (!streamInRange(stream, x, z)) continue;
+            auto it = stream->cells.find(cellKey(x, z));
+            if (it == stream->cells.end()) {
+                missing.push_back(StreamRequest{x, z, streamDist2(stream, x, z)});
+            } else if (it->second.state == CellResident) {
+                it->second.lastUsed = stream->frame;
+            }
+        }
+    }
+    const int slots = std::min((int)missing.size(), stream->desc.maxInFlight - stream->requested);
+    if (slots > 0) {
+        std::partial_sort(missing.begin(), missing.begin() + slots, missing.end(), [](const StreamRequest& a, const StreamRequest& c) { return a.dist2 < c.dist2; });
+        missing.resize((size_t)slots);
+        for (const StreamRequest& m : missing) stream->cells[cellKey(m.x, m.z)] = StreamCell{};
+        stream->requested += slots;
+    }
+    {
+        std::lock_guard<std::mutex> lock(stream->mutex);
+        if (slots > 0) stream->queue.insert(stream->queue.end(), missing.begin(), missing.end());
+        std::sort(stream->queue.begin(), stream->queue.end(), [](const StreamRequest& a, const StreamRequest& c) { return a.dist2 > c.dist2; });
+    }
+    if (slots > 0) stream->wake.notify_all();
+
+    // Over the memory cap: evict out-of-range cells, least recently used (then farthest) first.
+    if (stats.residentBytes > stream->desc.memoryBudgetBytes) {
+        struct Candidate {
+            uint64_t key;
+            uint64_t lastUsed;
+            float dist2;
+        };
+        std::vector<Candidate> candidates;
+        for (const auto& kv : stream->cells) {
+            if (kv.second.state == CellResident && kv.second.lastUsed < stream->frame) {
+                candidates.push_back(Candidate{kv.first, kv.second.lastUsed, streamDist2(stream, cellKeyX(kv.first), cellKeyZ(kv.first))});
+            }
+        }
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& c) {
+            if (a.lastUsed != c.lastUsed) return a.lastUsed < c.lastUsed;
+            return a.dist2 > c.dist2;
+        });
+        for (const Candidate& c : candidates) {
+            if (stats.residentBytes <= stream->desc.memoryBudgetBytes) break;
+            auto it = stream->cells.find(c.key);
+            b.evict(b.residencyUser, cellKeyX(c.key), cellKeyZ(c.key), it->second.handle);
+            stats.residentBytes -= it->second.bytes;
+            stats.resident -= 1;
+            stats.evicted += 1;
+            stats.evictionsLastUpdate += 1;
+            stream->cells.erase(it);
+        }
+    }
+    stats.overBudget = stats.residentBytes > stream->desc.memoryBudgetBytes ? 1 : 0;
+    stats.inFlight = stream->requested;
+}
+
+void g4f_stream_wait_idle(g4f_stream* stream) {
+    if (!stream) return;
+    std::unique_lock<std::mutex> lock(stream->mutex);
+    stream->idle.wait(lock, [&] { return stream->queue.empty() && stream->generating == 0; });
+}
+
+void* g4f_stream_get(const g4f_stream* stream, int cellX, int cellZ) {
+    if (!stream) return nullptr;
+    auto it = stream->cells.find(cellKey(cellX, cellZ));
+    return it != stream->cells.end() && it->second.state == CellResident ? it->second.handle : nullptr;
+}
+
+int g4f_stream_resident_cells(const g4f_stream* stream, g4f_stream_cell* out, int maxCells) {
+    if (!stream || !out || maxCells <= 0) return 0;
+    std::vector<std::pair<float, g4f_stream_cell>> cells;
+    cells.reserve((size_t)stream->stats.resident);
+    for (const auto& kv : stream->cells) {
+        if (kv.second.state != CellResident) continue;
+        const int x = cellKeyX(kv.first), z = cellKeyZ(kv.first);
+        cells.push_back({streamDist2(stream, x, z), g4f_stream_cell{x, z, kv.second.handle}});
+    }
+    std::sort(cells.begin(), cells.end(), [](const std::pair<float, g4f_stream_cell>& a, const std::pair<float, g4f_stream_cell>& c) {
+        if (a.first != c.first) return a.first < c.first;
+        return a.second.z != c.second.z ? a.second.z < c.second.z : a.second.x < c.second.x;
+    });
+    const int n = std::min(maxCells, (int)cells.size());
+    for (int i = 0; i < n; i++) out[i] = cells[(size_t)i].second;
+    return n;
+}
+
+void g4f_stream_get_stats(const g4f_stream* stream, g4f_stream_stats* out) {
+    if (!out) return;
+    *out = stream ? stream->stats : g4f_stream_stats{};
+}
+
+g4f_stream_chunk* g4f_stream_chunk_create(int vertexCount, int indexCount, int textureWidth, int textureHeight) {
+    if (vertexCount < 0 || vertexCount > 65536 || indexCount < 0 || indexCount % 3 != 0 || textureWidth < 0 || textureHeight < 0 ||
+        (textureWidth == 0) != (textureHeight == 0) || textureWidth > 16384 || textureHeight > 16384) {
+        g4f_set_last_error("g4f_stream_chunk_create: invalid size");
+        return nullptr;
+    }
+    const size_t header = (sizeof(g4f_stream_chunk) + 15) & ~(size_t)15;
+    const size_t vertexBytes = sizeof(g4f_gfx_vertex_p3n3uv2) * (size_t)vertexCount;
+    const size_t indexBytes = ((sizeof(uint16_t) * (size_t)indexCount) + 15) & ~(size_t)15;
+    const size_t pixelBytes = (size_t)textureWidth * (size_t)textureHeight * 4;
+    auto* block = (uint8_t*)std::calloc(1, header + vertexBytes + indexBytes + pixelBytes);
+    if (!block) {
+        g4f_set_last_error("g4f_stream_chunk_create: out of memory");
+        return nullptr;
+    }
+    auto* chunk = (g4f_stream_chunk*)block;
+    chunk->vertices = vertexCount ? (g4f_gfx_vertex_p3n3uv2*)(block + header) : nullptr;
+    chunk->vertexCount = vertexCount;
+    chunk->indices = indexCount ? (uint16_t*)(block + header + vertexBytes) : nullptr;
+    chunk->indexCount = indexCount;
+    chunk->rgba = pixelBytes ? block + header + vertexBytes + indexBytes : nullptr;
+    chunk->textureWidth = textureWidth;
+    chunk->textureHeight = textureHeight;
+    chunk->model = g4f_mat4_identity();
+    chunk->material.tintRgba = g4f_rgba_u32(255, 255, 255, 255);
+    chunk->material.depthTest = 1;
+    chunk->material.depthWrite = 1;
+    chunk->lit = 1;
+    return chunk;
+}
+
+void g4f_stream_chunk_destroy(g4f_stream_chunk* chunk) { std::free(chunk); }
+
+size_t g4f_stream_chunk_bytes(const g4f_stream_chunk* chunk) {
+    if (!chunk) return 0;
+    return sizeof(g4f_gfx_vertex_p3n3uv2) * (size_t)chunk->vertexCount + sizeof(uint16_t) * (size_t)chunk->indexCount +
+           (size_t)chunk->textureWidth * (size_t)chunk->textureHeight * 4;
+}
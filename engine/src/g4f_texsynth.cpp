@@ -0,0 +1,400 @@
+#include "../include/g4f/g4f_texsynth.h"
+
+#include "g4f_error_internal.h"
+#include "g4f_simd_internal.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace g4f::simd;
+
+namespace {
+
+constexpr int kTileSize = 64;
+
+struct SynthParams {
+    int generator = G4F_TEXSYNTH_VALUE_NOISE;
+    uint32_t seed = 0;
+    int octaves = 1;
+    float lacunarity = 2.0f;
+    float gain = 0.5f;
+    float domainScale = 1.0f; // pixels -> lattice units
+    float offsetX = 0.0f;
+    float offsetY = 0.0f;
+    float invW = 1.0f;
+    float invH = 1.0f;
+    float gx0 = 0.0f, gy0 = 0.0f;
+    float gdx = 1.0f, gdy = 0.0f;
+    float gInvLen2 = 1.0f;
+    float gInvRadius = 1.0f;
+};
+
+static I4 hash2(I4 x, I4 y, uint32_t seed) {
+    I4 h = i4MulLo(x, i4Set1((int32_t)0x27d4eb2du)) ^ i4MulLo(y, i4Set1((int32_t)0x165667b1u)) ^ i4Set1((int32_t)seed);
+    h = h ^ i4Srl(h, 15);
+    h = i4MulLo(h, i4Set1((int32_t)0x2c1b3c6du));
+    h = h ^ i4Srl(h, 12);
+    h = i4MulLo(h, i4Set1((int32_t)0x297a2d39u));
+    h = h ^ i4Srl(h, 15);
+    return h;
+}
+
+// Top 24 bits of the hash as a float in [0,1).
+static F4 hashToUnit(I4 h) {
+    return f4FromI4(i4Srl(h, 8)) * f4Set1(1.0f / 16777216.0f);
+}
+
+static F4 fade(F4 t) {
+    // 6t^5 - 15t^4 + 10t^3
+    return t * t * t * (t * (t * f4Set1(6.0f) - f4Set1(15.0f)) + f4Set1(10.0f));
+}
+
+// Perlin's 8-direction 2D gradient: picks (x,y) or (y,x), flips signs, doubles v.
+static F4 grad2(I4 h, F4 x, F4 y) {
+    I4 zero = i4Set1(0);
+    F4 useX = f4FromBits(i4Eq(h & i4Set1(4), zero));
+    F4 u = f4Select(useX, x, y);
+    F4 v = f4Select(useX, y, x);
+    F4 signU = f4FromBits(i4Sll(h & i4Set1(1), 31));
+    F4 signV = f4FromBits(i4Sll(h & i4Set1(2), 30));
+    return f4Xor(u, signU) + f4Xor(v + v, signV);
+}
+
+static F4 valueNoise(F4 px, F4 py, uint32_t seed) {
+    F4 fx0 = f4Floor(px);
+    F4 fy0 = f4Floor(py);
+    I4 ix = i4FromF4(fx0);
+    I4 iy = i4FromF4(fy0);
+    I4 one = i4Set1(1);
+    F4 tx = fade(px - fx0);
+    F4 ty = fade(py - fy0);
+    F4 v00 = hashToUnit(hash2(ix, iy, seed));
+    F4 v10 = hashToUnit(hash2(ix + one, iy, seed));
+    F4 v01 = hashToUnit(hash2(ix, iy + one, seed));
+    F4 v11 = hashToUnit(hash2(ix + one, iy + one, seed));
+    return f4Lerp(f4Lerp(v00, v10, tx), f4Lerp(v01, v11, tx), ty);
+}
+
+static F4 gradientNoise(F4 px, F4 py, uint32_t seed) {
+    F4 fx0 = f4Floor(px);
+    F4 fy0 = f4Floor(py);
+    I4 ix = i4FromF4(fx0);
+    I4 iy = i4FromF4(fy0);
+    I4 one = i4Set1(1);
+    F4 rx = px - fx0;
+    F4 ry = py - fy0;
+    F4 rx1 = rx - f4Set1(1.0f);
+    F4 ry1 = ry - f4Set1(1.0f);
+    F4 n00 = grad2(hash2(ix, iy, seed), rx, ry);
+    F4 n10 = grad2(hash2(ix + one, iy, seed), rx1, ry);
+    F4 n01 = grad2(hash2(ix, iy + one, seed), rx, ry1);
+    F4 n11 = grad2(hash2(ix + one, iy + one, seed), rx1, ry1);
+    F4 tx = fade(rx);
+    F4 ty = fade(ry);
+    F4 n = f4Lerp(f4Lerp(n00, n10, tx), f4Lerp(n01, n11, tx), ty);
+    // |n| peaks around 1.5 with these gradients; remap to [0,1].
+    return f4Clamp(n * f4Set1(0.33f) + f4Set1(0.5f), f4Set1(0.0f), f4Set1(1.0f));
+}
+
+static F4 simplexCorner(F4 x, F4 y, I4 h) {
+    F4 t = f4Set1(0.5f) - x * x - y * y;
+    F4 inside = f4Gt(t, f4Set1(0.0f));
+    t = t * t;
+    return f4And(inside, t * t * grad2(h, x, y));
+}
+
+static F4 simplexNoise(F4 px, F4 py, uint32_t seed) {
+    const float F2 = 0.36602540378f; // (sqrt(3) - 1) / 2
+    const float G2 = 0.21132486540f; // (3 - sqrt(3)) / 6
+    F4 s = (px + py) * f4Set1(F2);
+    F4 fi = f4Floor(px + s);
+    F4 fj = f4Floor(py + s);
+    F4 t = (fi + fj) * f4Set1(G2);
+    F4 x0 = px - (fi - t);
+    F4 y0 = py - (fj - t);
+
+    F4 lower = f4Gt(x0, y0);
+    F4 i1 = f4And(lower, f4Set1(1.0f));
+    F4 j1 = f4Set1(1.0f) - i1;
+    F4 x1 = x0 - i1 + f4Set1(G2);
+    F4 y1 = y0 - j1 + f4Set1(G2);
+    F4 x2 = x0 - f4Set1(1.0f - 2.0f * G2);
+    F4 y2 = y0 - f4Set1(1.0f - 2.0f * G2);
+
+    I4 ii = i4FromF4(fi);
+    I4 jj = i4FromF4(fj);
+    I4 one = i4Set1(1);
+    F4 n = simplexCorner(x0, y0, hash2(ii, jj, seed));
+    n = n + simplexCorner(x1, y1, hash2(ii + i4FromF4(i1), jj + i4FromF4(j1), seed));
+    n = n + simplexCorner(x2, y2, hash2(ii + one, jj + one, seed));
+    // Peak magnitude with these gradients is ~0.022; scale to roughly [-1,1].
+    return f4Clamp(n * f4Set1(22.0f) + f4Set1(0.5f), f4Set1(0.0f), f4Set1(1.0f));
+}
+
+static F4 worleyF1(F4 px, F4 py, uint32_t seed) {
+    F4 fx0 = f4Floor(px);
+    F4 fy0 = f4Floor(py);
+    I4 ix = i4FromF4(fx0);
+    I4 iy = i4FromF4(fy0);
+    F4 rx = px - fx0;
+    F4 ry = py - fy0;
+    F4 best = f4Set1(8.0f);
+    for (int dy = -1; dy <= 1; dy++) {
+        for (int dx = -1; dx <= 1; dx++) {
+            I4 h = hash2(ix + i4Set1(dx), iy + i4Set1(dy), seed);
+            F4 fx = hashToUnit(h) + f4Set1((float)dx);
+            F4 fy = hashToUnit(hash2(h, i4Set1(dy), seed ^ 0x9e3779b9u)) + f4Set1((float)dy);
+            F4 ddx = fx - rx;
+            F4 ddy = fy - ry;
+            best = f4Min(best, ddx * ddx + ddy * ddy);
+        }
+    }
+    return f4Min(f4Sqrt(best), f4Set1(1.0f));
+}
+
+static F4 evalNoise(int generator, F4 px, F4 py, uint32_t seed) {
+    switch (generator) {
+        case G4F_TEXSYNTH_GRADIENT_NOISE: return gradientNoise(px, py, seed);
+        case G4F_TEXSYNTH_SIMPLEX_NOISE: return simplexNoise(px, py, seed);
+        case G4F_TEXSYNTH_WORLEY: return worleyF1(px, py, seed);
+        default: return valueNoise(px, py, seed);
+    }
+}
+
+// Field value in [0,1] for 4 pixel centers (x + 0.5, y + 0.5).
+static F4 evalField(const SynthParams& p, F4 x, F4 y) {
+    F4 sx = x + f4Set1(0.5f + p.offsetX);
+    F4 sy = y + f4Set1(0.5f + p.offsetY);
+
+    switch (p.generator) {
+        case G4F_TEXSYNTH_LINEAR_GRADIENT: {
+            F4 u = sx * f4Set1(p.invW) - f4Set1(p.gx0);
+            F4 v = sy * f4Set1(p.invH) - f4Set1(p.gy0);
+            F4 t = (u * f4Set1(p.gdx) + v * f4Set1(p.gdy)) * f4Set1(p.gInvLen2);
+            return f4Clamp(t, f4Set1(0.0f), f4Set1(1.0f));
+        }
+        case G4F_TEXSYNTH_RADIAL_GRADIENT: {
+            F4 u = sx * f4Set1(p.invW) - f4Set1(p.gx0);
+            F4 v = sy * f4Set1(p.invH) - f4Set1(p.gy0);
+            F4 t = f4Sqrt(u * u + v * v) * f4Set1(p.gInvRadius);
+            return f4Min(t, f4Set1(1.0f));
+        }
+        case G4F_TEXSYNTH_CHECKER: {
+            I4 cx = i4FromF4(f4Floor(sx * f4Set1(p.domainScale)));
+            I4 cy = i4FromF4(f4Floor(sy * f4Set1(p.domainScale)));
+            return f4FromI4((cx ^ cy) & i4Set1(1));
+        }
+        default: break;
+    }
+
+    F4 px = sx * f4Set1(p.domainScale);
+    F4 py = sy * f4Set1(p.domainScale);
+    if (p.octaves <= 1) return evalNoise(p.generator, px, py, p.seed);
+
+    F4 sum = f4Set1(0.0f);
+    float amp = 1.0f;
+    float ampSum = 0.0f;
+    float freq = 1.0f;
+    for (int o = 0; o < p.octaves; o++) {
+        F4 f = f4Set1(freq);
+        sum = sum + evalNoise(p.generator, px * f, py * f, p.seed + (uint32_t)o * 0x632be5abu) * f4Set1(amp);
+        ampSum += amp;
+        amp *= p.gain;
+        freq *= p.lacunarity;
+    }
+    return sum * f4Set1(1.0f / ampSum);
+}
+
+static SynthParams makeParams(const g4f_texsynth_desc* desc, int width, int height) {
+    SynthParams p{};
+    p.generator = desc->generator;
+    p.seed = desc->seed;
+    p.octaves = desc->octaves < 1 ? 1 : (desc->octaves > 16 ? 16 : desc->octaves);
+    p.lacunarity = desc->lacunarity > 0.0f ? desc->lacunarity : 2.0f;
+    p.gain = desc->gain > 0.0f ? desc->gain : 0.5f;
+    float frequency = desc->frequency > 0.0f ? desc->frequency : 8.0f;
+    // Lattice spacing follows the texture width so cells stay square on non-square textures.
+    p.domainScale = frequency / (float)width;
+    p.offsetX = desc->offsetX;
+    p.offsetY = desc->offsetY;
+    p.invW = 1.0f / (float)width;
+    p.invH = 1.0f / (float)height;
+    p.gx0 = desc->x0;
+    p.gy0 = desc->y0;
+    p.gdx = desc->x1 - desc->x0;
+    p.gdy = desc->y1 - desc->y0;
+    float len2 = p.gdx * p.gdx + p.gdy * p.gdy;
+    p.gInvLen2 = len2 > 1e-12f ? 1.0f / len2 : 0.0f;
+    p.gInvRadius = len2 > 1e-12f ? 1.0f / std::sqrt(len2) : 0.0f;
+    return p;
+}
+
+static bool validateArgs(const char* context, const g4f_texsynth_desc* desc, int width, int height, const void* out) {
+    if (!desc || !out) { g4f_set_last_errorf("%s: invalid args", context); return false; }
+    if (width <= 0 || height <= 0) { g4f_set_last_errorf("%s: invalid size", context); return false; }
+    if (desc->generator < 0 || desc->generator >= G4F_TEXSYNTH_GENERATOR_COUNT) { g4f_set_last_errorf("%s: unknown generator", context); return false; }
+    if (desc->rampCount < 0 || (desc->rampCount > 0 && !desc->ramp)) { g4f_set_last_errorf("%s: invalid ramp", context); return false; }
+    return true;
+}
+
+static void unpackRgba(uint32_t rgba, float out[4]) {
+    out[0] = (float)((rgba >> 24) & 0xFF);
+    out[1] = (float)((rgba >> 16) & 0xFF);
+    out[2] = (float)((rgba >> 8) & 0xFF);
+    out[3] = (float)(rgba & 0xFF);
+}
+
+// 256-entry ramp lookup table holding RGBA8 in memory byte order.
+static void buildRampLut(const g4f_texsynth_desc* desc, uint32_t lut[256]) {
+    for (int i = 0; i < 256; i++) {
+        float t = (float)i / 255.0f;
+        float c[4];
+        if (!desc->ramp || desc->rampCount <= 0) {
+            c[0] = c[1] = c[2] = t * 255.0f;
+            c[3] = 255.0f;
+        } else if (desc->rampCount == 1 || t <= desc->ramp[0].t) {
+            unpackRgba(desc->ramp[0].rgba, c);
+        } else if (t >= desc->ramp[desc->rampCount - 1].t) {
+            unpackRgba(desc->ramp[desc->rampCount - 1].rgba, c);
+        } else {
+            int k = 0;
+            while (k + 1 < desc->rampCount && desc->ramp[k + 1].t < t) k++;
+            const g4f_texsynth_ramp_stop& a = desc->ramp[k];
+            const g4f_texsynth_ramp_stop& b = desc->ramp[k + 1];
+            float span = b.t - a.t;
+            float f = span > 1e-6f ? (t - a.t) / span : 1.0f;
+            float ca[4], cb[4];
+            unpackRgba(a.rgba, ca);
+            unpackRgba(b.rgba, cb);
+            for (int ch = 0; ch < 4; ch++) c[ch] = ca[ch] + (cb[ch] - ca[ch]) * f;
+        }
+        uint8_t bytes[4];
+        for (int ch = 0; ch < 4; ch++) bytes[ch] = (uint8_t)(c[ch] + 0.5f);
+        std::memcpy(&lut[i], bytes, 4);
+    }
+}
+
+struct TileJob {
+    SynthParams params;
+    int width = 0;
+    int height = 0;
+    int tilesX = 0;
+    // Exactly one of these outputs is set.
+    uint8_t* rgba = nullptr;
+    int rgbaPitch = 0;
+    const uint32_t* lut = nullptr;
+    float* field = nullptr;
+    int fieldPitch = 0;
+};
+
+static void runTiles(void* user, int begin, int end, int /*workerIndex*/) {
+    const TileJob& job = *(const TileJob*)user;
+    const F4 laneOffsets = f4Set(0.0f, 1.0f, 2.0f, 3.0f);
+    alignas(16) float values[kTileSize];
+    alignas(16) int32_t idx[4];
+
+    for (int tile = begin; tile < end; tile++) {
+        int tx0 = (tile % job.tilesX) * kTileSize;
+        int ty0 = (tile / job.tilesX) * kTileSize;
+        int tw = job.width - tx0 < kTileSize ? job.width - tx0 : kTileSize;
+        int th = job.height - ty0 < kTileSize ? job.height - ty0 : kTileSize;
+
+        for (int y = ty0; y < ty0 + th; y++) {
+            F4 fy = f4Set1((float)y);
+            for (int x = 0; x < tw; x += 4) {
+                F4 fx = f4Set1((float)(tx0 + x)) + laneOffsets;
+                f4Store(values + x, evalField(job.params, fx, fy));
+            }
+
+            if (job.field) {
+                std::memcpy(job.field + (size_t)y * (size_t)job.fieldPitch + tx0, values, sizeof(float) * (size_t)tw);
+                continue;
+            }
+
+            uint32_t* dst = (uint32_t*)(job.rgba + (size_t)y * (size_t)job.rgbaPitch) + tx0;
+            int x = 0;
+            for (; x + 4 <= tw; x += 4) {
+                i4Store(idx, i4FromF4(f4Load(values + x) * f4Set1(255.0f) + f4Set1(0.5f)));
+                dst[x + 0] = job.lut[idx[0]];
+                dst[x + 1] = job.lut[idx[1]];
+                dst[x + 2] = job.lut[idx[2]];
+                dst[x + 3] = job.lut[idx[3]];
+            }
+            for (; x < tw; x++) dst[x] = job.lut[(int)(values[x] * 255.0f + 0.5f)];
+        }
+    }
+}
+
+static void dispatchTiles(TileJob& job, g4f_jobs* jobs) {
+    job.tilesX = (job.width + kTileSize - 1) / kTileSize;
+    int tilesY = (job.height + kTileSize - 1) / kTileSize;
+    g4f_jobs_parallel_for(jobs, job.tilesX * tilesY, 1, runTiles, &job);
+}
+
+} // namespace
+
+g4f_texsynth_desc g4f_texsynth_desc_default(int generator) {
+    g4f_texsynth_desc d{};
+    d.generator = generator;
+    d.seed = 1337u;
+    d.frequency = 8.0f;
+    d.octaves = 1;
+    d.lacunarity = 2.0f;
+    d.gain = 0.5f;
+    d.x0 = 0.0f;
+    d.y0 = 0.5f;
+    d.x1 = 1.0f;
+    d.y1 = 0.5f;
+    if (generator == G4F_TEXSYNTH_RADIAL_GRADIENT) {
+        d.x0 = 0.5f;
+        d.y0 = 0.5f;
+        d.x1 = 1.0f;
+        d.y1 = 0.5f;
+    }
+    return d;
+}
+
+float g4f_texsynth_sample(const g4f_texsynth_desc* desc, int width, int height, int x, int y) {
+    if (!desc || width <= 0 || height <= 0) return 0.0f;
+    if (desc->generator < 0 || desc->generator >= G4F_TEXSYNTH_GENERATOR_COUNT) return 0.0f;
+    SynthParams p = makeParams(desc, width, height);
+    return f4Lane(evalField(p, f4Set1((float)x), f4Set1((float)y)), 0);
+}
+
+int g4f_texsynth_generate_r32f(const g4f_texsynth_desc* desc, g4f_jobs* jobs, int width, int height, float* out, int rowPitchFloats) {
+    if (!validateArgs("g4f_texsynth_generate_r32f", desc, width, height, out)) return 0;
+    if (rowPitchFloats <= 0) rowPitchFloats = width;
+    if (rowPitchFloats < width) { g4f_set_last_error("g4f_texsynth_generate_r32f: rowPitchFloats too small"); return 0; }
+
+    TileJob job{};
+    job.params = makeParams(desc, width, height);
+    job.width = width;
+    job.height = height;
+    job.field = out;
+    job.fieldPitch = rowPitchFloats;
+    dispatchTiles(job, jobs);
+    return 1;
+}
+
+int g4f_texsynth_generate_rgba8(const g4f_texsynth_desc* desc, g4f_jobs* jobs, int width, int height, void* outRgba, int rowPitchBytes) {
+    if (!validateArgs("g4f_texsynth_generate_rgba8", desc, width, height, outRgba)) return 0;
+    if (rowPitchBytes <= 0) rowPitchBytes = width * 4;
+    if (rowPitchBytes < width * 4 || (rowPitchBytes & 3) != 0) {
+        g4f_set_last_error("g4f_texsynth_generate_rgba8: invalid rowPitchBytes");
+        return 0;
+    }
+
+    uint32_t lut[256];
+    buildRampLut(desc, lut);
+
+    TileJob job{};
+    job.params = makeParams(desc, width, height);
+    job.width = width;
+    job.height = height;
+    job.rgba = (uint8_t*)outRgba;
+    job.rgbaPitch = rowPitchBytes;
+    job.lut = lut;
+    dispatchTiles(job, jobs);
+    return 1;
+}
@@ -1,8 +1,15 @@
+#include <cmath>
 #include <cstdio>
 #include <vector>
 #include "g4f/g4f.h"
 #include "g4f/g4f_camera.h"
 #include "g4f/g4f_ctx3d_ui.h"
+#include "g4f/g4f_dynres.h"
+#include "g4f/g4f_frame_stats.h"
+#include "g4f/g4f_gpu_timings.h"
+#include "g4f/g4f_light_clusters.h"
+#include "g4f/g4f_mipgen.h"
+#include "g4f/g4f_texsynth.h"
 #include "g4f/g4f_ui.h"
 
 int main() {
@@ -26,14 +33,21 @@ int main() {
     const int checkerCellPx = 16;
     std::vector<uint32_t> checkerPixels((size_t)checkerW * (size_t)checkerH);
 
-    g4f_gfx_texture* checker = g4f_gfx_texture_create_rgba8_dynamic(gfx, checkerW, checkerH);
+    // Checker animation is synthesized in parallel tiles (see g4f_texsynth.h).
+    g4f_jobs* jobs = g4f_jobs_create(0);
+    const g4f_texsynth_ramp_stop checkerRamp[] = {
+        {0.0f, g4f_rgba_u32(40, 40, 55, 255)},
+        {1.0f, g4f_rgba_u32(240, 240, 255, 255)},
+    };
+    g4f_texsynth_desc checkerDesc = g4f_texsynth_desc_default(G4F_TEXSYNTH_CHECKER);
+    checkerDesc.frequency = (float)(checkerW / checkerCellPx);
+    checkerDesc.ramp = checkerRamp;
+    checkerDesc.rampCount = 2;
+
+    g4f_gfx_texture* checker = g4f_gfx_texture_create_rgba8_streaming(gfx, checkerW, checkerH);
+    int checkerPhase = 0;
     if (checker) {
-        for (int y = 0; y < checkerH; y++) {
-            for (int x = 0; x < checkerW; x++) {
-                int cell = ((x / checkerCellPx) ^ (y / checkerCellPx)) & 1;
-                checkerPixels[(size_t)y * (size_t)checkerW + (size_t)x] = cell ? g4f_rgba_u32(240, 240, 255, 255) : g4f_rgba_u32(40, 40, 55, 255);
-            }
-        }
+        g4f_texsynth_generate_rgba8(&checkerDesc, jobs, checkerW, checkerH, checkerPixels.data(), checkerW * 4);
         g4f_gfx_texture_update_rgba8(checker, checkerPixels.data(), checkerW * 4);
     }
 
@@ -46,20 +60,60 @@ int main() {
     mdesc.cullMode = 0;
     g4f_gfx_material* mtlUnlit = g4f_gfx_material_create_unlit(gfx, &mdesc);
     g4f_gfx_material* mtlLit = g4f_gfx_material_create_lit(gfx, &mdesc);
-    if (!cube || !floorMesh || !checker || !mtlUnlit || !mtlLit) {
+
+    // The floor tiles a static checker at grazing angles: full mip chain + wrap + anisotropic filtering.
+    const int floorTexSize = 256;
+    std::vector<uint32_t> floorPixels((size_t)floorTexSize * (size_t)floorTexSize);
+    g4f_texsynth_desc floorDesc = checkerDesc;
+    floorDesc.frequency = 8.0f;
+    g4f_texsynth_generate_rgba8(&floorDesc, jobs, floorTexSize, floorTexSize, floorPixels.data(), floorTexSize * 4);
+    g4f_gfx_texture* floorTex = g4f_gfx_texture_create_rgba8_mipmapped(
+        gfx, floorTexSize, floorTexSize, floorPixels.data(), floorTexSize * 4, G4F_MIPGEN_FILTER_KAISER, G4F_MIPGEN_FLAG_WRAP);
+    g4f_gfx_material_unlit_desc floorMdesc = mdesc;
+    floorMdesc.texture = floorTex;
+    floorMdesc.samplerFilter = G4F_GFX_FILTER_ANISOTROPIC;
+    floorMdesc.samplerAddress = G4F_GFX_ADDRESS_WRAP;
+    floorMdesc.clusteredLights = 1;
+    g4f_gfx_material* mtlFloor = g4f_gfx_material_create_lit(gfx, &floorMdesc);
+
+    // Overhead "security camera" rendered offscreen and shown on a monitor cube.
+    g4f_gfx_target* monitorTarget = g4f_gfx_target_create(gfx, 256, 256, G4F_GFX_FORMAT_RGBA8, 1);
+    g4f_gfx_material_unlit_desc monitorMdesc{};
+    monitorMdesc.tintRgba = g4f_rgba_u32(255, 255, 255, 255);
+    monitorMdesc.texture = g4f_gfx_target_texture(monitorTarget);
+    monitorMdesc.depthTest = 1;
+    monitorMdesc.depthWrite = 1;
+    g4f_gfx_material* mtlMonitor = g4f_gfx_material_create_unlit(gfx, &monitorMdesc);
+
+    if (!cube || !floorMesh || !checker || !mtlUnlit || !mtlLit || !floorTex || !mtlFloor || !monitorTarget || !mtlMonitor) {
         std::fprintf(stderr, "Failed to create 3D resources\n");
+        g4f_gfx_material_destroy(mtlMonitor);
+        g4f_gfx_target_destroy(monitorTarget);
+        g4f_gfx_material_destroy(mtlFloor);
         g4f_gfx_material_destroy(mtlUnlit);
         g4f_gfx_material_destroy(mtlLit);
+        g4f_gfx_texture_destroy(floorTex);
         g4f_gfx_texture_destroy(checker);
         g4f_gfx_mesh_destroy(floorMesh);
         g4f_gfx_mesh_destroy(cube);
+        g4f_jobs_destroy(jobs);
         g4f_ctx3d_ui_destroy(ctx);
         return 1;
     }
 
+    // Small colored point lights circling over the floor, culled per froxel (see g4f_light_clusters.h).
+    std::vector<g4f_light> pointLights(64);
+    g4f_light_clusters* lightClusters = g4f_light_clusters_create(nullptr);
+
+    // Two shadow cascades for the directional light.
+    g4f_gfx_shadow_desc shadowDesc = g4f_gfx_shadow_desc_default();
+    shadowDesc.cascadeCount = 2;
+    const int shadowsOk = g4f_gfx_shadow_configure(gfx, &shadowDesc);
+
     g4f_ui* uiState = g4f_ctx3d_ui_ui(ctx);
 
     g4f_camera_fps cam = g4f_camera_fps_default();
+    int dynresActive = 0;
 
     while (g4f_ctx3d_ui_poll(ctx)) {
         g4f_window* window = g4f_ctx3d_ui_window(ctx);
@@ -79,10 +133,17 @@ int main() {
         int cullNone = g4f_ui_store_get_i(uiState, "cullNone", 0);
         int lit = g4f_ui_store_get_i(uiState, "lit", 1);
         int vsync = g4f_ui_store_get_i(uiState, "vsync", 1);
+        int dynres = g4f_ui_store_get_i(uiState, "dynres", 0);
         float sx = g4f_ui_store_get_f(uiState, "sx", 1.0f);
         float sy = g4f_ui_store_get_f(uiState, "sy", 1.0f);
         float sz = g4f_ui_store_get_f(uiState, "sz", 1.0f);
         g4f_gfx_set_vsync(gfx, vsync);
+        g4f_ctx3d* ctx3d = g4f_ctx3d_ui_ctx3d(ctx);
+        if (dynres != dynresActive) {
+            g4f_dynres_desc dynresDesc = g4f_dynres_desc_default();
+            g4f_ctx3d_set_dynamic_resolution(ctx3d, dynres ? &dynresDesc : nullptr);
+            dynresActive = dynres;
+        }
 
         uint32_t tint = g4f_rgba_u32((uint8_t)(80 + 175 * slider), (uint8_t)(140 + 115 * slider), 255, 255);
         g4f_gfx_material_set_tint_rgba(mtlUnlit, tint);
@@ -102,14 +163,15 @@ int main() {
 
         float t = (float)g4f_ctx3d_ui_time(ctx);
         if (checker) {
+            // The pattern only moves 10 times per second; skip regeneration and upload in between.
             int phase = (int)(t * 10.0f);
-            for (int y = 0; y < checkerH; y++) {
-                for (int x = 0; x < checkerW; x++) {
-                    int cell = (((x + phase) / checkerCellPx) ^ ((y + phase) / checkerCellPx)) & 1;
-                    checkerPixels[(size_t)y * (size_t)checkerW + (size_t)x] = cell ? g4f_rgba_u32(240, 240, 255, 255) : g4f_rgba_u32(40, 40, 55, 255);
-                }
+            if (phase != checkerPhase) {
+                checkerPhase = phase;
+                checkerDesc.offsetX = (float)phase;
+                checkerDesc.offsetY = (float)phase;
+                g4f_texsynth_generate_rgba8(&checkerDesc, jobs, checkerW, checkerH, checkerPixels.data(), checkerW * 4);
+                g4f_gfx_texture_update_rgba8(checker, checkerPixels.data(), checkerW * 4);
             }
-            g4f_gfx_texture_update_rgba8(checker, checkerPixels.data(), checkerW * 4);
         }
         float aspect = g4f_gfx_aspect(gfx);
         g4f_mat4 proj = g4f_camera_fps_proj(&cam, aspect);
@@ -122,14 +184,66 @@ int main() {
         g4f_gfx_set_light_dir(gfx, -0.4f, -1.0f, -0.2f);
         g4f_gfx_set_light_colors(gfx, g4f_rgba_u32(255, 250, 240, 255), g4f_rgba_u32(40, 50, 70, 255));
 
+        if (lightClusters) {
+            for (size_t i = 0; i < pointLights.size(); i++) {
+                float a = t * 0.6f + (float)i * 0.098f;
+                float r = 1.5f + 4.0f * (float)(i % 8) / 8.0f;
+                g4f_light& l = pointLights[i];
+                l = g4f_light{};
+                l.type = G4F_LIGHT_POINT;
+                l.position = g4f_vec3{std::cos(a) * r, -1.0f, std::sin(a) * r};
+                l.radius = 1.2f;
+                l.colorRgba = g4f_rgba_u32((uint8_t)(64 + (i * 53) % 192), (uint8_t)(64 + (i * 97) % 192), (uint8_t)(64 + (i * 31) % 192), 255);
+                l.intensity = 1.5f;
+            }
+            if (g4f_light_clusters_build(lightClusters, pointLights.data(), (int)pointLights.size(), &view, &proj, jobs)) {
+                g4f_gfx_set_light_clusters(gfx, pointLights.data(), (int)pointLights.size(), lightClusters);
+            }
+        }
+
         g4f_mat4 floorModel = g4f_mat4_translation(0.0f, -1.3f, 0.0f);
+        g4f_mat4 monitorModel = g4f_mat4_mul(g4f_mat4_scale(1.2f, 1.2f, 0.1f), g4f_mat4_translation(3.5f, 0.5f, 2.0f));
+
+        if (shadowsOk) {
+            float splits[3];
+            g4f_shadow_cascade cascades[2];
+            g4f_shadow_cascade_splits(0.1f, 40.0f, 2, 0.75f, splits);
+            if (g4f_shadow_cascades_fit(&view, &proj, g4f_vec3{-0.4f, -1.0f, -0.2f}, splits, 2, shadowDesc.size, 10.0f, cascades)) {
+                // Caster bounds: spinning cube (scaled) and the monitor.
+                float sMax = sx > sy ? (sx > sz ? sx : sz) : (sy > sz ? sy : sz);
+                const float casters[8] = {0.0f, 0.0f, 0.0f, 1.74f * sMax, 3.5f, 0.5f, 2.0f, 1.75f};
+                uint8_t masks[2];
+                g4f_shadow_cascades_cull(cascades, 2, casters, 2, masks);
+                for (int c = 0; c < 2; c++) {
+                    if (!g4f_gfx_shadow_pass_begin(gfx, c, &cascades[c])) continue;
+                    if (masks[0] & (1u << c)) g4f_gfx_draw_shadow_caster(gfx, cube, &model);
+                    if (masks[1] & (1u << c)) g4f_gfx_draw_shadow_caster(gfx, cube, &monitorModel);
+                    g4f_gfx_shadow_pass_end(gfx);
+                }
+                g4f_gfx_set_shadow_cascades(gfx, cascades, 2);
+            }
+        }
+
         g4f_mat4 floorMvp = g4f_mat4_mul(g4f_mat4_mul(floorModel, view), proj);
-        g4f_gfx_material_set_cull(mtlLit, 0);
-        g4f_gfx_material_set_depth(mtlLit, 1, 1);
-        g4f_gfx_draw_mesh_xform(gfx, floorMesh, mtlLit, &floorModel, &floorMvp);
 
+        if (g4f_gfx_pass_begin(gfx, monitorTarget, G4F_GFX_PASS_CLEAR_COLOR | G4F_GFX_PASS_CLEAR_DEPTH, g4f_rgba_u32(20, 24, 32, 255))) {
+            g4f_mat4 topView = g4f_mat4_look_at(g4f_vec3{0.0f, 9.0f, -0.01f}, g4f_vec3{0.0f, 0.0f, 0.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+            g4f_mat4 topProj = g4f_mat4_perspective(50.0f * 3.14159265f / 180.0f, 1.0f, 0.1f, 50.0f);
+            g4f_mat4 topFloorMvp = g4f_mat4_mul(g4f_mat4_mul(floorModel, topView), topProj);
+            g4f_mat4 topCubeMvp = g4f_mat4_mul(g4f_mat4_mul(model, topView), topProj);
+            g4f_gfx_draw_mesh_xform(gfx, floorMesh, mtlFloor, &floorModel, &topFloorMvp);
+            g4f_gfx_draw_mesh_xform(gfx, cube, lit ? mtlLit : mtlUnlit, &model, &topCubeMvp);
+            g4f_gfx_pass_end(gfx);
+        }
+
+        g4f_gfx_gpu_scope_begin(gfx, "scene");
+        g4f_gfx_draw_mesh_xform(gfx, floorMesh, mtlFloor, &floorModel, &floorMvp);
         g4f_gfx_draw_mesh_xform(gfx, cube, lit ? mtlLit : mtlUnlit, &model, &mvp);
 
+        g4f_mat4 monitorMvp = g4f_mat4_mul(g4f_mat4_mul(monitorModel, view), proj);
+        g4f_gfx_draw_mesh_xform(gfx, cube, mtlMonitor, &monitorModel, &monitorMvp);
+        g4f_gfx_gpu_scope_end(gfx);
+
         g4f_ctx3d_ui_overlay_begin(ctx);
         g4f_ui_panel_begin_scroll(uiState, "G4F SPIN CUBE", g4f_rect_f{24, 24, 420, 240});
         g4f_ui_text_wrapped(uiState, "D3D11 render + Direct2D UI overlay.\nHold RMB: capture mouse + FPS camera (WASD, Space/Ctrl). Alt-Tab releases capture.\nWheel: scroll. UP/DOWN or W/S: focus. TAB: cycle focus. ENTER/SPACE: activate. LEFT/RIGHT or A/D: slider.", 16.0f);
@@ -152,9 +266,41 @@ int main() {
         g4f_ui_checkbox_k(uiState, "cull none (stored)", "cullNone", 0, &cullNoneUi);
         int litUi = 0;
         g4f_ui_checkbox_k(uiState, "lit shading (stored)", "lit", 1, &litUi);
+        int anisoUi = 0;
+        g4f_ui_checkbox_k(uiState, "anisotropic floor (stored)", "aniso", 1, &anisoUi);
+        g4f_gfx_material_set_sampler(mtlFloor, anisoUi ? G4F_GFX_FILTER_ANISOTROPIC : G4F_GFX_FILTER_LINEAR, G4F_GFX_ADDRESS_WRAP);
         int vsyncUi = 0;
         g4f_ui_checkbox_k(uiState, "vsync (stored)", "vsync", 1, &vsyncUi);
         g4f_ui_tooltip(uiState, "VSync syncs Present() to the display (less tearing, more latency).", 14.0f);
+        int dynresUi = 0;
+        g4f_ui_checkbox_k(uiState, "dynamic resolution (stored)", "dynres", 0, &dynresUi);
+        float cpuMs = 0.0f, presentMs = 0.0f;
+        g4f_ctx3d_frame_timings(ctx3d, &cpuMs, &presentMs);
+        char timingBuf[96];
+        std::snprintf(timingBuf, sizeof(timingBuf), "scale %.2f  cpu %.1f ms  present %.1f ms", g4f_ctx3d_render_scale(ctx3d), cpuMs, presentMs);
+        g4f_ui_text_wrapped(uiState, timingBuf, 14.0f);
+        const g4f_gpu_timings* gpuTimings = g4f_gfx_gpu_timings(gfx);
+        if (gpuTimings && gpuTimings->source != G4F_GPU_TIMINGS_NONE) {
+            char gpuBuf[128];
+            std::snprintf(gpuBuf, sizeof(gpuBuf), "%s %.2f ms  shadows %.2f+%.2f  monitor %.2f  scene %.2f",
+                          gpuTimings->source == G4F_GPU_TIMINGS_GPU ? "gpu" : "cpu clock", gpuTimings->frameMs,
+                          g4f_gpu_timings_find_ms(gpuTimings, "shadow cascade 0"), g4f_gpu_timings_find_ms(gpuTimings, "shadow cascade 1"),
+                          g4f_gpu_timings_find_ms(gpuTimings, "offscreen pass"), g4f_gpu_timings_find_ms(gpuTimings, "scene"));
+            g4f_ui_text_wrapped(uiState, gpuBuf, 14.0f);
+        }
+        g4f_gfx_frame_stats frameStats{};
+        g4f_gfx_get_frame_stats(gfx, &frameStats);
+        char statsBuf[128];
+        std::snprintf(statsBuf, sizeof(statsBuf), "draws %d  tris %llu  binds %d (%d skipped)  upload %.1f KB",
+                      frameStats.drawCalls, (unsigned long long)frameStats.triangles, g4f_gfx_frame_stats_state_changes(&frameStats),
+                      g4f_gfx_frame_stats_redundant_avoided(&frameStats), (double)g4f_gfx_frame_stats_upload_bytes(&frameStats) / 1024.0);
+        g4f_ui_text_wrapped(uiState, statsBuf, 14.0f);
+        g4f_gfx_startup_stats startup{};
+        g4f_gfx_get_startup_stats(gfx, &startup);
+        char startupBuf[128];
+        std::snprintf(startupBuf, sizeof(startupBuf), "startup %.0f ms  shaders %d/%d cached  compile %.1f ms",
+                      startup.createMs, startup.shaderCacheHits, startup.shaderCount, startup.shaderCompileMs);
+        g4f_ui_text_wrapped(uiState, startupBuf, 14.0f);
         g4f_ui_slider_float_k(uiState, "scale X", "sx", 1.0f, 0.25f, 3.0f, &sx);
         g4f_ui_slider_float_k(uiState, "scale Y", "sy", 1.0f, 0.25f, 3.0f, &sy);
         g4f_ui_slider_float_k(uiState, "scale Z", "sz", 1.0f, 0.25f, 3.0f, &sz);
@@ -176,11 +322,17 @@ int main() {
         g4f_ctx3d_ui_frame3d_end(ctx);
     }
 
+    g4f_light_clusters_destroy(lightClusters);
+    g4f_gfx_material_destroy(mtlMonitor);
+    g4f_gfx_target_destroy(monitorTarget);
+    g4f_gfx_material_destroy(mtlFloor);
     g4f_gfx_material_destroy(mtlUnlit);
     g4f_gfx_material_destroy(mtlLit);
+    g4f_gfx_texture_destroy(floorTex);
     g4f_gfx_texture_destroy(checker);
     g4f_gfx_mesh_destroy(floorMesh);
     g4f_gfx_mesh_destroy(cube);
+    g4f_jobs_destroy(jobs);
     g4f_ctx3d_ui_destroy(ctx);
     return 0;
 }
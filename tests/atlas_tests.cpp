@@ -0,0 +1,251 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_atlas.h"
+
+static uint32_t nextRandom(uint32_t* state) {
+    *state = *state * 1664525u + 1013904223u;
+    return *state >> 8;
+}
+
+static std::vector<int> randomSizes(int count, int minSide, int maxSide, uint32_t seed) {
+    std::vector<int> sizes((size_t)count * 2);
+    for (int& s : sizes) s = minSide + (int)(nextRandom(&seed) % (uint32_t)(maxSide - minSide + 1));
+    return sizes;
+}
+
+static g4f_atlas_desc makeDesc(int algorithm, int page, int padding, int gutter, int mipLevels) {
+    g4f_atlas_desc d = g4f_atlas_desc_default();
+    d.algorithm = algorithm;
+    d.pageWidth = page;
+    d.pageHeight = page;
+    d.padding = padding;
+    d.gutter = gutter;
+    d.mipLevels = mipLevels;
+    return d;
+}
+
+// Every slot (image + gutter on all sides + padding right/bottom) is inside its page, aligned,
+// and disjoint from every other slot on the page.
+static void checkLayout(const g4f_atlas_desc& d, const std::vector<int>& sizes, const std::vector<g4f_atlas_rect>& rects, int pages) {
+    const int align = d.mipLevels > 1 ? 1 << (d.mipLevels - 1) : 1;
+    for (size_t i = 0; i < rects.size(); i++) {
+        const g4f_atlas_rect& r = rects[i];
+        assert(r.width == sizes[i * 2] && r.height == sizes[i * 2 + 1]);
+        assert(r.page >= 0 && r.page < pages);
+        assert(r.x - d.gutter >= 0 && r.y - d.gutter >= 0);
+        assert(r.x + r.width + d.gutter <= d.pageWidth && r.y + r.height + d.gutter <= d.pageHeight);
+        assert((r.x - d.gutter) % align == 0 && (r.y - d.gutter) % align == 0);
+    }
+    for (size_t i = 0; i < rects.size(); i++) {
+        for (size_t j = i + 1; j < rects.size(); j++) {
+            const g4f_atlas_rect& a = rects[i];
+            const g4f_atlas_rect& b = rects[j];
+            if (a.page != b.page) continue;
+            const int ax0 = a.x - d.gutter, ax1 = a.x + a.width + d.gutter + d.padding;
+            const int ay0 = a.y - d.gutter, ay1 = a.y + a.height + d.gutter + d.padding;
+            const int bx0 = b.x - d.gutter, bx1 = b.x + b.width + d.gutter + d.padding;
+            const int by0 = b.y - d.gutter, by1 = b.y + b.height + d.gutter + d.padding;
+            assert(ax1 <= bx0 || bx1 <= ax0 || ay1 <= by0 || by1 <= ay0);
+        }
+    }
+}
+
+static void testPackRectsLayout() {
+    const std::vector<int> sizes = randomSizes(300, 4, 60, 12345u);
+    const int count = (int)sizes.size() / 2;
+    for (int algorithm = 0; algorithm < 2; algorithm++) {
+        for (int variant = 0; variant < 3; variant++) {
+            const g4f_atlas_desc d = variant == 0 ? makeDesc(algorithm, 256, 0, 0, 0)
+                                   : variant == 1 ? makeDesc(algorithm, 256, 1, 2, 0)
+                                                  : makeDesc(algorithm, 256, 2, 1, 4);
+            std::vector<g4f_atlas_rect> rects((size_t)count), again((size_t)count);
+            const int pages = g4f_atlas_pack_rects(&d, sizes.data(), count, rects.data());
+            assert(pages >= 1);
+            checkLayout(d, sizes, rects, pages);
+            // Deterministic: same input, same layout.
+            assert(g4f_atlas_pack_rects(&d, sizes.data(), count, again.data()) == pages);
+            assert(std::memcmp(rects.data(), again.data(), rects.size() * sizeof(g4f_atlas_rect)) == 0);
+        }
+    }
+}
+
+static void testExactFit() {
+    // 64 16x16 tiles fill a 128x128 page exactly when there is no padding.
+    std::vector<int> sizes(128, 16);
+    std::vector<g4f_atlas_rect> rects(64);
+    for (int algorithm = 0; algorithm < 2; algorithm++) {
+        const g4f_atlas_desc d = makeDesc(algorithm, 128, 0, 0, 0);
+        assert(g4f_atlas_pack_rects(&d, sizes.data(), 64, rects.data()) == 1);
+        checkLayout(d, sizes, rects, 1);
+    }
+    // Padding only between slots: 8 tiles of 15 + 7 gaps of 1 still fit in 127.
+    std::vector<int> padded(128, 15);
+    g4f_atlas_desc d = makeDesc(G4F_ATLAS_SKYLINE, 127, 1, 0, 0);
+    assert(g4f_atlas_pack_rects(&d, padded.data(), 64, rects.data()) == 1);
+    checkLayout(d, padded, rects, 1);
+    // One more tile needs a second page.
+    padded.push_back(15);
+    padded.push_back(15);
+    rects.resize(65);
+    assert(g4f_atlas_pack_rects(&d, padded.data(), 65, rects.data()) == 2);
+}
+
+static void testOversized() {
+    const int sizes[] = {8, 8, 300, 10, 16, 16};
+    g4f_atlas_rect rects[3];
+    const g4f_atlas_desc d = makeDesc(G4F_ATLAS_MAXRECTS, 256, 1, 0, 0);
+    assert(g4f_atlas_pack_rects(&d, sizes, 3, rects) == -1);
+    assert(std::strstr(g4f_last_error(), "g4f_atlas_pack_rects"));
+    assert(rects[1].page == -1);
+    assert(rects[0].page == 0 && rects[2].page == 0);
+    // Fits on its own, but not with the gutter.
+    const int edge[] = {256, 16};
+    const g4f_atlas_desc guttered = makeDesc(G4F_ATLAS_SKYLINE, 256, 0, 1, 0);
+    assert(g4f_atlas_pack_rects(&guttered, edge, 1, rects) == -1);
+}
+
+static std::vector<uint8_t> makeImage(int w, int h, int seed) {
+    std::vector<uint8_t> px((size_t)w * h * 4);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t* p = &px[((size_t)y * w + x) * 4];
+            p[0] = (uint8_t)(x * 7 + seed);
+            p[1] = (uint8_t)(y * 5 + seed * 3);
+            p[2] = (uint8_t)seed;
+            p[3] = 255;
+        }
+    }
+    return px;
+}
+
+static const uint8_t* texel(const uint8_t* page, int pageW, int x, int y) {
+    return page + ((size_t)y * pageW + x) * 4;
+}
+
+static void testBuildComposesPages() {
+    const int gutter = 2, padding = 1;
+    g4f_atlas_desc d = makeDesc(G4F_ATLAS_MAXRECTS, 64, padding, gutter, 0);
+    g4f_atlas* atlas = g4f_atlas_create(&d);
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    assert(atlas && jobs);
+    std::vector<std::vector<uint8_t>> images;
+    for (int i = 0; i < 40; i++) {
+        const int w = 3 + i % 9, h = 2 + (i * 5) % 11;
+        images.push_back(makeImage(w, h, i));
+        // Odd images go in with a larger pitch.
+        if (i & 1) {
+            std::vector<uint8_t> pitched((size_t)(w + 3) * h * 4, 0xEE);
+            for (int y = 0; y < h; y++) std::memcpy(&pitched[(size_t)y * (w + 3) * 4], &images.back()[(size_t)y * w * 4], (size_t)w * 4);
+            assert(g4f_atlas_add_rgba8(atlas, w, h, pitched.data(), (w + 3) * 4) == i);
+        } else {
+            assert(g4f_atlas_add_rgba8(atlas, w, h, images.back().data(), 0) == i);
+        }
+    }
+    assert(g4f_atlas_image_count(atlas) == 40);
+    assert(g4f_atlas_page_count(atlas) == 0);
+    const int pages = g4f_atlas_build(atlas, jobs);
+    assert(pages >= 2 && g4f_atlas_page_count(atlas) == pages);
+
+    std::vector<uint8_t> covered((size_t)pages * 64 * 64, 0);
+    for (int i = 0; i < 40; i++) {
+        g4f_atlas_region r{};
+        assert(g4f_atlas_get_region(atlas, i, &r) == 1);
+        int pw = 0, ph = 0;
+        const uint8_t* page = g4f_atlas_page_pixels(atlas, r.page, &pw, &ph);
+        assert(page && pw == 64 && ph == 64);
+        const int w = r.width, h = r.height;
+        assert(r.u0 == (float)r.x / 64.0f && r.v1 == (float)(r.y + h) / 64.0f);
+        const std::vector<uint8_t>& src = images[(size_t)i];
+        for (int y = -gutter; y < h + gutter; y++) {
+            for (int x = -gutter; x < w + gutter; x++) {
+                // Gutter texels repeat the nearest edge texel.
+                const int sx = x < 0 ? 0 : (x >= w ? w - 1 : x);
+                const int sy = y < 0 ? 0 : (y >= h ? h - 1 : y);
+                assert(std::memcmp(texel(page, 64, r.x + x, r.y + y), &src[((size_t)sy * w + sx) * 4], 4) == 0);
+                covered[(size_t)r.page * 64 * 64 + (size_t)(r.y + y) * 64 + (size_t)(r.x + x)] = 1;
+            }
+        }
+    }
+    // Everything else (padding, unused space) is transparent black.
+    for (int p = 0; p < pages; p++) {
+        const uint8_t* page = g4f_atlas_page_pixels(atlas, p, nullptr, nullptr);
+        for (int i = 0; i < 64 * 64; i++) {
+            if (!covered[(size_t)p * 64 * 64 + (size_t)i]) assert(std::memcmp(page + (size_t)i * 4, "\0\0\0\0", 4) == 0);
+        }
+    }
+
+    // Serial build is identical.
+    g4f_atlas* serial = g4f_atlas_create(&d);
+    for (int i = 0; i < 40; i++) {
+        g4f_atlas_region r{};
+        g4f_atlas_get_region(atlas, i, &r);
+        g4f_atlas_add_rgba8(serial, r.width, r.height, images[(size_t)i].data(), 0);
+    }
+    assert(g4f_atlas_build(serial, nullptr) == pages);
+    for (int p = 0; p < pages; p++) {
+        assert(std::memcmp(g4f_atlas_page_pixels(atlas, p, nullptr, nullptr), g4f_atlas_page_pixels(serial, p, nullptr, nullptr), 64 * 64 * 4) == 0);
+    }
+
+    g4f_atlas_stats stats{};
+    g4f_atlas_get_stats(atlas, &stats);
+    long long texels = 0;
+    for (const auto& img : images) texels += (long long)img.size() / 4;
+    assert(stats.pages == pages && stats.imageTexels == texels);
+    assert(stats.pageTexels == (long long)pages * 64 * 64);
+    assert(stats.usedTexels <= stats.pageTexels && stats.usedEfficiency >= stats.efficiency);
+    assert(stats.efficiency > 0.0f && stats.usedEfficiency <= 1.0f);
+
+    // Adding invalidates the pages until the next build.
+    const std::vector<uint8_t> extra = makeImage(4, 4, 99);
+    assert(g4f_atlas_add_rgba8(atlas, 4, 4, extra.data(), 0) == 40);
+    assert(g4f_atlas_page_count(atlas) == 0);
+    g4f_atlas_region r{};
+    assert(g4f_atlas_get_region(atlas, 0, &r) == 0);
+    assert(g4f_atlas_build(atlas, jobs) >= pages);
+    assert(g4f_atlas_get_region(atlas, 40, &r) == 1 && r.width == 4);
+
+    g4f_atlas_destroy(serial);
+    g4f_atlas_destroy(atlas);
+    g4f_jobs_destroy(jobs);
+}
+
+static void testInvalidArgs() {
+    g4f_atlas_desc d = g4f_atlas_desc_default();
+    d.algorithm = 7;
+    assert(g4f_atlas_create(&d) == nullptr);
+    assert(std::strstr(g4f_last_error(), "g4f_atlas_create"));
+    d = makeDesc(G4F_ATLAS_SKYLINE, 32, -1, 0, 0);
+    assert(g4f_atlas_create(&d) == nullptr);
+
+    d = makeDesc(G4F_ATLAS_SKYLINE, 32, 0, 0, 0);
+    g4f_atlas* atlas = g4f_atlas_create(&d);
+    uint8_t px[64 * 4] = {};
+    assert(g4f_atlas_add_rgba8(atlas, 33, 1, px, 0) == -1);
+    assert(g4f_atlas_add_rgba8(atlas, 4, 4, px, 8) == -1);
+    assert(g4f_atlas_add_rgba8(atlas, 0, 4, px, 0) == -1);
+    assert(g4f_atlas_build(atlas, nullptr) == 0); // nothing to pack
+    assert(g4f_atlas_page_pixels(atlas, 0, nullptr, nullptr) == nullptr);
+    g4f_atlas_destroy(atlas);
+
+    // A gutter can push an image that passed add_rgba8 off the page.
+    d.gutter = 1;
+    atlas = g4f_atlas_create(&d);
+    std::vector<uint8_t> wide(32 * 4, 0);
+    assert(g4f_atlas_add_rgba8(atlas, 32, 1, wide.data(), 0) == 0);
+    assert(g4f_atlas_build(atlas, nullptr) == 0);
+    assert(std::strstr(g4f_last_error(), "g4f_atlas_build"));
+    g4f_atlas_destroy(atlas);
+}
+
+int main() {
+    testPackRectsLayout();
+    testExactFit();
+    testOversized();
+    testBuildComposesPages();
+    testInvalidArgs();
+    std::printf("atlas_tests: OK\n");
+    return 0;
+}
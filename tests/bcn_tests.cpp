@@ -0,0 +1,235 @@
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_bcn.h"
+#include "g4f/g4f_mipgen.h"
+#include "g4f/g4f_pack.h"
+
+static std::vector<uint8_t> noiseImage(int w, int h, uint32_t seed, bool smooth) {
+    std::vector<uint8_t> px((size_t)w * h * 4);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t* p = &px[((size_t)y * w + x) * 4];
+            for (int c = 0; c < 4; c++) {
+                seed = seed * 1664525u + 1013904223u;
+                const int grain = (int)(seed >> 29) - 4;
+                const int base = smooth ? x * 2 + y + c * 20 : (int)(seed >> 24);
+                p[c] = (uint8_t)std::min(255, std::max(0, base + (smooth ? grain : 0)));
+            }
+        }
+    }
+    return px;
+}
+
+static double psnr(const std::vector<uint8_t>& a, const std::vector<uint8_t>& b, int c0, int c1) {
+    double sum = 0.0;
+    size_t n = 0;
+    for (size_t i = 0; i < a.size(); i += 4) {
+        for (int c = c0; c < c1; c++, n++) sum += ((double)a[i + (size_t)c] - b[i + (size_t)c]) * ((double)a[i + (size_t)c] - b[i + (size_t)c]);
+    }
+    const double mse = sum / (double)n;
+    return mse > 0.0 ? 10.0 * std::log10(255.0 * 255.0 / mse) : 99.0;
+}
+
+static std::vector<uint8_t> roundTrip(const std::vector<uint8_t>& src, int w, int h, int format, int quality) {
+    std::vector<uint8_t> blocks(g4f_bcn_chain_bytes(format, w, h, 1)), out((size_t)w * h * 4);
+    assert(g4f_bcn_encode_rgba8(src.data(), w, h, 0, format, quality, nullptr, blocks.data()) == 1);
+    assert(g4f_bcn_decode_rgba8(blocks.data(), format, w, h, out.data(), 0) == 1);
+    return out;
+}
+
+static void testChainBytes() {
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC1, 4, 4, 1) == 8);
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC3, 4, 4, 1) == 16);
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC7, 5, 3, 1) == 32); // 2x1 blocks
+    // 16x8 -> 8x4 -> 4x2 -> 2x1 -> 1x1: 8 + 2 + 1 + 1 + 1 blocks
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC1, 16, 8, 5) == 13 * 8);
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC7, 64, 32, 7) == g4f_pack_texture_bytes(G4F_PACK_FORMAT_BC7, 64, 32, 7));
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC1, 16, 8, 6) == 0);
+    assert(g4f_bcn_chain_bytes(0, 16, 16, 1) == 0);
+    assert(g4f_bcn_chain_bytes(G4F_BCN_BC1, 0, 16, 1) == 0);
+}
+
+static void testDecodeHandBuiltBlocks() {
+    uint8_t px[16 * 4];
+    // BC1, c0 = red > c1 = blue: four-color mode; row 0 uses indices 0, 1, 2, 3.
+    const uint8_t bc1[8] = {0x00, 0xF8, 0x1F, 0x00, 0xE4, 0, 0, 0};
+    assert(g4f_bcn_decode_rgba8(bc1, G4F_BCN_BC1, 4, 4, px, 0) == 1);
+    const uint8_t row0[16] = {255, 0, 0, 255, 0, 0, 255, 255, 170, 0, 85, 255, 85, 0, 170, 255};
+    assert(std::memcmp(px, row0, 16) == 0);
+    assert(px[4 * 4 + 0] == 255 && px[4 * 4 + 2] == 0); // remaining rows index 0
+
+    // BC1, c0 <= c1: three-color mode, index 3 is transparent black.
+    const uint8_t bc1Punch[8] = {0x1F, 0x00, 0x00, 0xF8, 0xFF, 0, 0, 0};
+    assert(g4f_bcn_decode_rgba8(bc1Punch, G4F_BCN_BC1, 4, 4, px, 0) == 1);
+    for (int i = 0; i < 4; i++) assert(px[i * 4 + 0] == 0 && px[i * 4 + 1] == 0 && px[i * 4 + 2] == 0 && px[i * 4 + 3] == 0);
+    assert(px[4 * 4 + 2] == 255 && px[4 * 4 + 3] == 255);
+
+    // BC3 alpha, a0 = 255 > a1 = 0: eight-value mode, index 1 everywhere -> 0; color block all white.
+    const uint8_t bc3[16] = {255, 0, 0x49, 0x92, 0x24, 0x49, 0x92, 0x24, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0};
+    assert(g4f_bcn_decode_rgba8(bc3, G4F_BCN_BC3, 4, 4, px, 0) == 1);
+    for (int i = 0; i < 16; i++) assert(px[i * 4 + 0] == 255 && px[i * 4 + 3] == 0);
+
+    // BC7 mode 6 with every endpoint and p-bit set: opaque white.
+    uint8_t bc7[16] = {0xC0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x01};
+    assert(g4f_bcn_decode_rgba8(bc7, G4F_BCN_BC7, 4, 4, px, 0) == 1);
+    for (int i = 0; i < 64; i++) assert(px[i] == 255);
+    // A zero byte has no mode bit: reserved encoding decodes to transparent black.
+    std::memset(bc7, 0, sizeof(bc7));
+    assert(g4f_bcn_decode_rgba8(bc7, G4F_BCN_BC7, 4, 4, px, 0) == 1);
+    for (int i = 0; i < 64; i++) assert(px[i] == 0);
+}
+
+static void testSolidColorsAreExact() {
+    const uint8_t colors[4][4] = {{0, 0, 0, 255}, {255, 255, 255, 255}, {37, 200, 91, 255}, {129, 3, 250, 77}};
+    for (const auto& c : colors) {
+        std::vector<uint8_t> src(8 * 8 * 4);
+        for (size_t i = 0; i < src.size(); i++) src[i] = c[i % 4];
+        for (int quality = G4F_BCN_QUALITY_FAST; quality <= G4F_BCN_QUALITY_HIGH; quality++) {
+            // BC1/BC3 solid colors use the optimal 565 endpoint tables: within one step of the source.
+            const std::vector<uint8_t> bc3 = roundTrip(src, 8, 8, G4F_BCN_BC3, quality);
+            const std::vector<uint8_t> bc7 = roundTrip(src, 8, 8, G4F_BCN_BC7, quality);
+            for (size_t i = 0; i < src.size(); i++) {
+                assert(std::abs((int)bc3[i] - (int)src[i]) <= 1);
+                assert(std::abs((int)bc7[i] - (int)src[i]) <= 1);
+            }
+        }
+    }
+}
+
+static void testRoundTripQuality() {
+    const int w = 64, h = 48;
+    const std::vector<uint8_t> smooth = noiseImage(w, h, 7u, true);
+    const std::vector<uint8_t> noise = noiseImage(w, h, 9u, false);
+    std::vector<uint8_t> opaque = smooth; // BC1 would punch out the low-alpha pixels
+    for (size_t i = 3; i < opaque.size(); i += 4) opaque[i] = 255;
+    double prevBc7 = 0.0;
+    for (int quality = G4F_BCN_QUALITY_FAST; quality <= G4F_BCN_QUALITY_HIGH; quality++) {
+        assert(psnr(opaque, roundTrip(opaque, w, h, G4F_BCN_BC1, quality), 0, 3) > 38.0);
+        const std::vector<uint8_t> bc3 = roundTrip(smooth, w, h, G4F_BCN_BC3, quality);
+        assert(psnr(smooth, bc3, 0, 3) > 38.0 && psnr(smooth, bc3, 3, 4) > 48.0);
+        const std::vector<uint8_t> bc7 = roundTrip(smooth, w, h, G4F_BCN_BC7, quality);
+        assert(psnr(smooth, bc7, 0, 4) > 41.0);
+        // Higher quality never loses on uncorrelated noise (the search only adds candidates).
+        const double noisePsnr = psnr(noise, roundTrip(noise, w, h, G4F_BCN_BC7, quality), 0, 4);
+        assert(noisePsnr + 1e-9 >= prevBc7);
+        prevBc7 = noisePsnr;
+    }
+}
+
+static void testOpaqueAlphaStaysOpaque() {
+    std::vector<uint8_t> src = noiseImage(32, 32, 3u, false);
+    for (size_t i = 3; i < src.size(); i += 4) src[i] = 255;
+    for (int format = G4F_BCN_BC1; format <= G4F_BCN_BC7; format++) {
+        for (int quality = G4F_BCN_QUALITY_FAST; quality <= G4F_BCN_QUALITY_HIGH; quality++) {
+            const std::vector<uint8_t> out = roundTrip(src, 32, 32, format, quality);
+            for (size_t i = 3; i < out.size(); i += 4) assert(out[i] == 255);
+        }
+    }
+}
+
+static void testBc1PunchThrough() {
+    std::vector<uint8_t> src(8 * 8 * 4);
+    for (int i = 0; i < 64; i++) {
+        const bool hole = ((i % 8) + (i / 8)) % 3 == 0;
+        src[(size_t)i * 4 + 0] = (uint8_t)(i * 4);
+        src[(size_t)i * 4 + 1] = 128;
+        src[(size_t)i * 4 + 2] = 40;
+        src[(size_t)i * 4 + 3] = hole ? 20 : 230;
+    }
+    const std::vector<uint8_t> out = roundTrip(src, 8, 8, G4F_BCN_BC1, G4F_BCN_QUALITY_NORMAL);
+    for (int i = 0; i < 64; i++) {
+        const bool hole = src[(size_t)i * 4 + 3] < 128;
+        assert(out[(size_t)i * 4 + 3] == (hole ? 0 : 255));
+        if (hole) assert(out[(size_t)i * 4 + 0] == 0 && out[(size_t)i * 4 + 1] == 0 && out[(size_t)i * 4 + 2] == 0);
+    }
+}
+
+static void testPartialBlocksAndPitch() {
+    const int sizes[3][2] = {{1, 1}, {2, 2}, {5, 3}};
+    for (const auto& s : sizes) {
+        const int w = s[0], h = s[1];
+        const std::vector<uint8_t> src = noiseImage(w, h, 11u, true);
+        for (int format = G4F_BCN_BC1; format <= G4F_BCN_BC7; format++) {
+            std::vector<uint8_t> blocks(g4f_bcn_chain_bytes(format, w, h, 1));
+            assert(g4f_bcn_encode_rgba8(src.data(), w, h, 0, format, G4F_BCN_QUALITY_NORMAL, nullptr, blocks.data()) == 1);
+            // Decode into a wider destination: pixels past the image width stay untouched.
+            const int pitch = w * 4 + 8;
+            std::vector<uint8_t> dst((size_t)pitch * h, 0xCD);
+            assert(g4f_bcn_decode_rgba8(blocks.data(), format, w, h, dst.data(), pitch) == 1);
+            for (int y = 0; y < h; y++) {
+                for (int i = 0; i < 8; i++) assert(dst[(size_t)y * pitch + (size_t)w * 4 + (size_t)i] == 0xCD);
+            }
+        }
+    }
+}
+
+static void testChainMatchesPackLayout() {
+    const int w = 32, h = 16;
+    const int levels = g4f_mipgen_level_count(w, h);
+    const std::vector<uint8_t> src = noiseImage(w, h, 5u, true);
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(w, h, levels));
+    assert(g4f_mipgen_build_chain_rgba8(src.data(), w, h, 0, levels, G4F_MIPGEN_FILTER_BOX, 0, nullptr, chain.data()) == levels);
+    std::vector<uint8_t> blocks(g4f_bcn_chain_bytes(G4F_BCN_BC7, w, h, levels));
+    assert(blocks.size() == g4f_pack_texture_bytes(G4F_PACK_FORMAT_BC7, w, h, levels));
+    assert(g4f_bcn_encode_chain_rgba8(chain.data(), w, h, levels, G4F_BCN_BC7, G4F_BCN_QUALITY_FAST, nullptr, blocks.data()) == 1);
+
+    // Each level equals a standalone encode of that mip level.
+    size_t srcOffset = 0, dstOffset = 0;
+    for (int i = 0; i < levels; i++) {
+        int lw = 0, lh = 0;
+        g4f_mipgen_level_size(w, h, i, &lw, &lh);
+        const size_t bytes = g4f_bcn_chain_bytes(G4F_BCN_BC7, lw, lh, 1);
+        std::vector<uint8_t> level(bytes);
+        assert(g4f_bcn_encode_rgba8(chain.data() + srcOffset, lw, lh, 0, G4F_BCN_BC7, G4F_BCN_QUALITY_FAST, nullptr, level.data()) == 1);
+        assert(std::memcmp(level.data(), blocks.data() + dstOffset, bytes) == 0);
+        srcOffset += (size_t)lw * lh * 4;
+        dstOffset += bytes;
+    }
+    assert(dstOffset == blocks.size());
+}
+
+static void testParallelMatchesSerial() {
+    const int w = 76, h = 52;
+    const std::vector<uint8_t> src = noiseImage(w, h, 21u, false);
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    for (int format = G4F_BCN_BC1; format <= G4F_BCN_BC7; format++) {
+        const size_t bytes = g4f_bcn_chain_bytes(format, w, h, 1);
+        std::vector<uint8_t> serial(bytes), parallel(bytes);
+        assert(g4f_bcn_encode_rgba8(src.data(), w, h, 0, format, G4F_BCN_QUALITY_NORMAL, nullptr, serial.data()) == 1);
+        assert(g4f_bcn_encode_rgba8(src.data(), w, h, 0, format, G4F_BCN_QUALITY_NORMAL, jobs, parallel.data()) == 1);
+        assert(serial == parallel);
+    }
+    g4f_jobs_destroy(jobs);
+}
+
+static void testInvalidArgs() {
+    uint8_t px[64] = {};
+    uint8_t blocks[16] = {};
+    assert(g4f_bcn_encode_rgba8(nullptr, 4, 4, 0, G4F_BCN_BC1, 0, nullptr, blocks) == 0);
+    assert(g4f_bcn_encode_rgba8(px, 4, 4, 0, 7, 0, nullptr, blocks) == 0);
+    assert(g4f_bcn_encode_rgba8(px, 4, 4, 8, G4F_BCN_BC1, 0, nullptr, blocks) == 0);
+    assert(g4f_last_error() && std::strstr(g4f_last_error(), "g4f_bcn_encode_rgba8"));
+    assert(g4f_bcn_encode_chain_rgba8(px, 4, 4, 4, G4F_BCN_BC1, 0, nullptr, blocks) == 0);
+    assert(g4f_bcn_decode_rgba8(blocks, G4F_BCN_BC3, 0, 4, px, 0) == 0);
+    assert(g4f_last_error() && std::strstr(g4f_last_error(), "g4f_bcn_decode_rgba8"));
+}
+
+int main() {
+    testChainBytes();
+    testDecodeHandBuiltBlocks();
+    testSolidColorsAreExact();
+    testRoundTripQuality();
+    testOpaqueAlphaStaysOpaque();
+    testBc1PunchThrough();
+    testPartialBlocksAndPitch();
+    testChainMatchesPackLayout();
+    testParallelMatchesSerial();
+    testInvalidArgs();
+    std::printf("bcn_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,400 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_bvh.h"
+
+static uint32_t g_rng = 7u;
+static float randf(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static bool feq(float a, float b, float eps = 1e-3f) {
+    return std::fabs(a - b) <= eps * (1.0f + std::fabs(a) + std::fabs(b));
+}
+
+struct Mesh {
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+};
+
+// Bumpy grid in the XZ plane, n x n quads over [-1, 1].
+static Mesh makeTerrain(int n) {
+    Mesh m;
+    for (int z = 0; z <= n; z++) {
+        for (int x = 0; x <= n; x++) {
+            const float fx = -1.0f + 2.0f * (float)x / (float)n;
+            const float fz = -1.0f + 2.0f * (float)z / (float)n;
+            m.positions.push_back(g4f_vec3{fx, 0.2f * std::sin(fx * 5.0f) * std::cos(fz * 4.0f), fz});
+        }
+    }
+    for (int z = 0; z < n; z++) {
+        for (int x = 0; x < n; x++) {
+            const uint32_t i = (uint32_t)(z * (n + 1) + x);
+            const uint32_t quad[6] = {i, i + (uint32_t)n + 1u, i + 1u, i + 1u, i + (uint32_t)n + 1u, i + (uint32_t)n + 2u};
+            m.indices.insert(m.indices.end(), quad, quad + 6);
+        }
+    }
+    return m;
+}
+
+// Random triangle soup inside [-1, 1]^3.
+static Mesh makeSoup(int count) {
+    Mesh m;
+    for (int t = 0; t < count; t++) {
+        const g4f_vec3 c{randf(-1.0f, 1.0f), randf(-1.0f, 1.0f), randf(-1.0f, 1.0f)};
+        for (int j = 0; j < 3; j++) {
+            m.positions.push_back(g4f_vec3{c.x + randf(-0.1f, 0.1f), c.y + randf(-0.1f, 0.1f), c.z + randf(-0.1f, 0.1f)});
+            m.indices.push_back((uint32_t)m.positions.size() - 1u);
+        }
+    }
+    return m;
+}
+
+static g4f_bvh_mesh* buildMesh(const Mesh& m, int maxLeaf) {
+    g4f_bvh_mesh_desc d = g4f_bvh_mesh_desc_default();
+    d.positions = m.positions.data();
+    d.positionStride = (int)sizeof(g4f_vec3);
+    d.vertexCount = (int)m.positions.size();
+    d.indices32 = m.indices.data();
+    d.indexCount = (int)m.indices.size();
+    d.maxLeafTriangles = maxLeaf;
+    return g4f_bvh_mesh_create(&d);
+}
+
+static g4f_vec3 xform(const g4f_mat4& m, g4f_vec3 p) {
+    return g4f_vec3{p.x * m.m[0] + p.y * m.m[4] + p.z * m.m[8] + m.m[12], p.x * m.m[1] + p.y * m.m[5] + p.z * m.m[9] + m.m[13],
+                    p.x * m.m[2] + p.y * m.m[6] + p.z * m.m[10] + m.m[14]};
+}
+
+static g4f_vec3 sub(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+static g4f_vec3 cross(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+static float dot(g4f_vec3 a, g4f_vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+// Reference closest hit over every triangle (optionally transformed). Returns t or -1.
+static float bruteRay(const Mesh& m, const g4f_mat4& xf, g4f_vec3 o, g4f_vec3 d, float tMax) {
+    float best = -1.0f;
+    for (size_t i = 0; i < m.indices.size(); i += 3) {
+        const g4f_vec3 v0 = xform(xf, m.positions[m.indices[i]]);
+        const g4f_vec3 e1 = sub(xform(xf, m.positions[m.indices[i + 1]]), v0);
+        const g4f_vec3 e2 = sub(xform(xf, m.positions[m.indices[i + 2]]), v0);
+        const g4f_vec3 p = cross(d, e2);
+        const float det = dot(e1, p);
+        if (std::fabs(det) < 1e-20f) continue;
+        const g4f_vec3 s = sub(o, v0);
+        const float u = dot(s, p) / det;
+        const g4f_vec3 q = cross(s, e1);
+        const float v = dot(d, q) / det;
+        const float t = dot(e2, q) / det;
+        if (u < 0.0f || v < 0.0f || u + v > 1.0f || t < 0.0f || t >= tMax) continue;
+        if (best < 0.0f || t < best) best = t;
+    }
+    return best;
+}
+
+static g4f_vec3 randomDir() {
+    return g4f_vec3{randf(-1.0f, 1.0f), randf(-1.0f, 1.0f), randf(-1.0f, 1.0f)};
+}
+
+static void testMeshRaysMatchBruteForce() {
+    const Mesh meshes[2] = {makeTerrain(24), makeSoup(600)};
+    const g4f_mat4 identity = g4f_mat4_identity();
+    for (const Mesh& m : meshes) {
+        for (int maxLeaf : {1, 4, 16}) {
+            g4f_bvh_mesh* bvh = buildMesh(m, maxLeaf);
+            assert(bvh);
+            g4f_bvh_stats stats{};
+            g4f_bvh_mesh_get_stats(bvh, &stats);
+            assert(stats.primitives == (int)m.indices.size() / 3);
+            assert(stats.nodes > 0 && stats.leaves > 0 && stats.depth > 0 && stats.sahCost > 0.0f);
+
+            int hits = 0;
+            for (int r = 0; r < 400; r++) {
+                const g4f_vec3 o{randf(-2.0f, 2.0f), randf(-2.0f, 2.0f), randf(-2.0f, 2.0f)};
+                // Aim most rays at the mesh and keep some axis-parallel ones.
+                g4f_vec3 d = (r % 8 == 0) ? g4f_vec3{0.0f, -1.0f, 0.0f} : sub(g4f_vec3{randf(-1.0f, 1.0f), 0.0f, randf(-1.0f, 1.0f)}, o);
+                if (r % 5 == 0) d = randomDir();
+                const float expected = bruteRay(m, identity, o, d, 100.0f);
+                g4f_bvh_hit hit{};
+                const int got = g4f_bvh_mesh_raycast(bvh, o, d, 100.0f, &hit);
+                assert(got == (expected >= 0.0f ? 1 : 0));
+                if (got) {
+                    hits++;
+                    assert(feq(hit.t, expected) && hit.instance == -1);
+                    assert(hit.triangle >= 0 && hit.triangle < stats.primitives);
+                    assert(hit.u >= 0.0f && hit.v >= 0.0f && hit.u + hit.v <= 1.0001f);
+                }
+                // Line of sight agrees with a closest-hit test limited to the segment.
+                const g4f_vec3 b{o.x + d.x * 0.5f, o.y + d.y * 0.5f, o.z + d.z * 0.5f};
+                const float segExpected = bruteRay(m, identity, o, d, 0.5f);
+                assert(g4f_bvh_mesh_segment_blocked(bvh, o, b) == (segExpected >= 0.0f ? 1 : 0));
+            }
+            assert(hits > 50);
+            g4f_bvh_mesh_destroy(bvh);
+        }
+    }
+}
+
+static void testSphereOverlap() {
+    const Mesh m = makeTerrain(16);
+    g4f_bvh_mesh* bvh = buildMesh(m, 4);
+    const g4f_vec3 center{0.1f, 0.0f, -0.2f};
+    const float radius = 0.3f;
+    // Reference: sample each triangle densely; a touching triangle has some sample inside
+    // (slightly enlarged radius) and a non-touching one has none (slightly shrunk radius).
+    int surely = 0, maybe = 0;
+    for (size_t i = 0; i < m.indices.size(); i += 3) {
+        const g4f_vec3 a = m.positions[m.indices[i]], b = m.positions[m.indices[i + 1]], c = m.positions[m.indices[i + 2]];
+        float best = 1e30f;
+        for (int s = 0; s <= 40; s++) {
+            for (int t = 0; s + t <= 40; t++) {
+                const float u = (float)s / 40.0f, v = (float)t / 40.0f;
+                const g4f_vec3 p{a.x + (b.x - a.x) * u + (c.x - a.x) * v, a.y + (b.y - a.y) * u + (c.y - a.y) * v, a.z + (b.z - a.z) * u + (c.z - a.z) * v};
+                const g4f_vec3 dd = sub(p, center);
+                best = std::fmin(best, std::sqrt(dot(dd, dd)));
+            }
+        }
+        if (best <= radius) surely++;
+        if (best <= radius + 0.01f) maybe++;
+    }
+    g4f_bvh_hit hits[512];
+    const int count = g4f_bvh_mesh_overlap_sphere(bvh, center, radius, hits, 512);
+    assert(count >= surely && count <= maybe && surely > 10);
+    for (int i = 0; i < count; i++) assert(hits[i].instance == -1 && hits[i].triangle >= 0);
+    // Truncated output still reports the full count.
+    assert(g4f_bvh_mesh_overlap_sphere(bvh, center, radius, hits, 3) == count);
+    assert(g4f_bvh_mesh_overlap_sphere(bvh, g4f_vec3{5.0f, 5.0f, 5.0f}, 0.5f, hits, 512) == 0);
+    g4f_bvh_mesh_destroy(bvh);
+}
+
+static void testInputLayoutsAndDegenerates() {
+    // Interleaved vertices with 16-bit indices: a unit quad at y = 0.
+    g4f_gfx_vertex_p3n3uv2 verts[4] = {
+        {-1, 0, -1, 0, 1, 0, 0, 0}, {1, 0, -1, 0, 1, 0, 1, 0}, {-1, 0, 1, 0, 1, 0, 0, 1}, {1, 0, 1, 0, 1, 0, 1, 1}};
+    const uint16_t idx[6] = {0, 2, 1, 1, 2, 3};
+    g4f_bvh_mesh_desc d = g4f_bvh_mesh_desc_default();
+    d.positions = &verts[0].px;
+    d.positionStride = (int)sizeof(g4f_gfx_vertex_p3n3uv2);
+    d.vertexCount = 4;
+    d.indices16 = idx;
+    d.indexCount = 6;
+    g4f_bvh_mesh* quad = g4f_bvh_mesh_create(&d);
+    assert(quad);
+    g4f_bvh_hit hit{};
+    assert(g4f_bvh_mesh_raycast(quad, g4f_vec3{0.5f, 2.0f, 0.5f}, g4f_vec3{0.0f, -1.0f, 0.0f}, 10.0f, &hit) == 1);
+    assert(feq(hit.t, 2.0f) && hit.triangle == 1);
+    assert(g4f_bvh_mesh_raycast(quad, g4f_vec3{0.5f, 2.0f, 0.5f}, g4f_vec3{0.0f, -1.0f, 0.0f}, 1.5f, &hit) == 0);
+    g4f_vec3 mn, mx;
+    g4f_bvh_mesh_bounds(quad, &mn, &mx);
+    assert(mn.x == -1.0f && mx.z == 1.0f && mn.y == 0.0f && mx.y == 0.0f);
+    g4f_bvh_mesh_destroy(quad);
+
+    // 5000 copies of one triangle: no usable split anywhere, depth must stay bounded.
+    std::vector<g4f_vec3> same;
+    for (int i = 0; i < 5000; i++) {
+        same.push_back(g4f_vec3{0, 0, 0});
+        same.push_back(g4f_vec3{1, 0, 0});
+        same.push_back(g4f_vec3{0, 1, 0});
+    }
+    d = g4f_bvh_mesh_desc_default();
+    d.positions = same.data();
+    d.vertexCount = (int)same.size();
+    g4f_bvh_mesh* stack = g4f_bvh_mesh_create(&d);
+    assert(stack);
+    g4f_bvh_stats stats{};
+    g4f_bvh_mesh_get_stats(stack, &stats);
+    assert(stats.primitives == 5000 && stats.depth < 20);
+    assert(g4f_bvh_mesh_raycast(stack, g4f_vec3{0.2f, 0.2f, -1.0f}, g4f_vec3{0, 0, 1}, 10.0f, &hit) == 1 && feq(hit.t, 1.0f));
+    g4f_bvh_mesh_destroy(stack);
+
+    d.indexCount = 0;
+    d.vertexCount = 4;
+    assert(g4f_bvh_mesh_create(&d) == nullptr);
+    d.indices16 = idx;
+    d.indexCount = 6;
+    d.vertexCount = 3; // index 3 out of range
+    assert(g4f_bvh_mesh_create(&d) == nullptr);
+    assert(g4f_bvh_mesh_create(nullptr) == nullptr);
+}
+
+struct SceneRef {
+    const Mesh* mesh;
+    g4f_mat4 xf;
+    bool alive;
+};
+
+static float bruteScene(const std::vector<SceneRef>& refs, g4f_vec3 o, g4f_vec3 d, float tMax, int* instance) {
+    float best = -1.0f;
+    for (size_t i = 0; i < refs.size(); i++) {
+        if (!refs[i].alive) continue;
+        const float t = bruteRay(*refs[i].mesh, refs[i].xf, o, d, tMax);
+        if (t >= 0.0f && (best < 0.0f || t < best)) {
+            best = t;
+            *instance = (int)i;
+        }
+    }
+    return best;
+}
+
+static void checkSceneRays(const g4f_bvh_scene* scene, const std::vector<SceneRef>& refs, int rays) {
+    for (int r = 0; r < rays; r++) {
+        const g4f_vec3 o{randf(-12.0f, 12.0f), randf(3.0f, 6.0f), randf(-12.0f, 12.0f)};
+        const g4f_vec3 target{randf(-10.0f, 10.0f), 0.0f, randf(-10.0f, 10.0f)};
+        const g4f_vec3 d = sub(target, o);
+        int expectedInstance = -1;
+        const float expected = bruteScene(refs, o, d, 2.0f, &expectedInstance);
+        g4f_bvh_hit hit{};
+        const int got = g4f_bvh_scene_raycast(scene, o, d, 2.0f, &hit);
+        assert(got == (expected >= 0.0f ? 1 : 0));
+        if (got) assert(feq(hit.t, expected) && hit.instance == expectedInstance);
+    }
+}
+
+static void testSceneInstancesRefitAndRebuild() {
+    const Mesh terrain = makeTerrain(8);
+    const Mesh soup = makeSoup(80);
+    g4f_bvh_mesh* terrainBvh = buildMesh(terrain, 4);
+    g4f_bvh_mesh* soupBvh = buildMesh(soup, 4);
+
+    g4f_bvh_scene* scene = g4f_bvh_scene_create();
+    std::vector<SceneRef> refs;
+    for (int i = 0; i < 40; i++) {
+        const bool isTerrain = (i % 3) == 0;
+        const float s = randf(0.5f, 1.5f);
+        const g4f_mat4 xf = g4f_mat4_trs(g4f_vec3{randf(-10.0f, 10.0f), randf(-0.5f, 0.5f), randf(-10.0f, 10.0f)},
+                                         g4f_quat_from_axis_angle(randomDir(), randf(0.0f, 6.0f)), g4f_vec3{s, s * 0.7f, s});
+        const int id = g4f_bvh_scene_add(scene, isTerrain ? terrainBvh : soupBvh, &xf);
+        assert(id == i);
+        refs.push_back(SceneRef{isTerrain ? &terrain : &soup, xf, true});
+    }
+    g4f_bvh_scene_build(scene);
+    g4f_bvh_stats stats{};
+    g4f_bvh_scene_get_stats(scene, &stats);
+    assert(stats.primitives == 40 && stats.nodes >= 3);
+    checkSceneRays(scene, refs, 300);
+
+    // Move a third of the instances and refit: same tree, correct answers.
+    for (int i = 0; i < 40; i += 3) {
+        const g4f_mat4 xf = g4f_mat4_mul(refs[(size_t)i].xf, g4f_mat4_translation(randf(-3.0f, 3.0f), 0.0f, randf(-3.0f, 3.0f)));
+        g4f_bvh_scene_set_transform(scene, i, &xf);
+        refs[(size_t)i].xf = xf;
+    }
+    g4f_bvh_scene_refit(scene);
+    g4f_bvh_stats refitStats{};
+    g4f_bvh_scene_get_stats(scene, &refitStats);
+    assert(refitStats.nodes == stats.nodes);
+    checkSceneRays(scene, refs, 300);
+
+    // Removed instances disappear immediately; additions wait for the next build.
+    g4f_bvh_scene_remove(scene, 5);
+    refs[5].alive = false;
+    checkSceneRays(scene, refs, 100);
+    const g4f_mat4 far = g4f_mat4_translation(100.0f, 0.0f, 0.0f);
+    const int added = g4f_bvh_scene_add(scene, terrainBvh, &far);
+    const int extra = g4f_bvh_scene_add(scene, terrainBvh, &far);
+    assert(added == 5 && extra == 40);
+    refs[5] = SceneRef{&terrain, far, true};
+    refs.push_back(SceneRef{&terrain, far, true});
+    const g4f_vec3 down{0.0f, -1.0f, 0.0f};
+    g4f_bvh_scene_build(scene);
+    g4f_bvh_hit hit{};
+    assert(g4f_bvh_scene_raycast(scene, g4f_vec3{100.0f, 5.0f, 0.0f}, down, 10.0f, &hit) == 1);
+    assert(hit.instance == 5 || hit.instance == 40);
+    checkSceneRays(scene, refs, 200);
+
+    // Line of sight and sphere queries at the scene level.
+    assert(g4f_bvh_scene_segment_blocked(scene, g4f_vec3{100.0f, 5.0f, 0.0f}, g4f_vec3{100.0f, -5.0f, 0.0f}) == 1);
+    assert(g4f_bvh_scene_segment_blocked(scene, g4f_vec3{100.0f, 5.0f, 0.0f}, g4f_vec3{100.0f, 1.0f, 0.0f}) == 0);
+    g4f_bvh_hit sphereHits[64];
+    const int touching = g4f_bvh_scene_overlap_sphere(scene, g4f_vec3{100.0f, 0.0f, 0.0f}, 0.2f, sphereHits, 64);
+    assert(touching > 0);
+    for (int i = 0; i < std::min(touching, 64); i++) assert(sphereHits[i].instance == 5 || sphereHits[i].instance == 40);
+
+    // Batched rays over a job pool agree with single queries.
+    std::vector<g4f_bvh_ray> rays(1000);
+    for (g4f_bvh_ray& r : rays) {
+        r.origin = g4f_vec3{randf(-12.0f, 12.0f), 5.0f, randf(-12.0f, 12.0f)};
+        r.dir = g4f_vec3{randf(-0.5f, 0.5f), -1.0f, randf(-0.5f, 0.5f)};
+        r.tMax = 10.0f;
+    }
+    std::vector<g4f_bvh_hit> hits(rays.size());
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    const int hitCount = g4f_bvh_scene_raycast_batch(scene, rays.data(), (int)rays.size(), hits.data(), jobs);
+    g4f_jobs_destroy(jobs);
+    int expectedHits = 0;
+    for (size_t i = 0; i < rays.size(); i++) {
+        g4f_bvh_hit single{};
+        const int got = g4f_bvh_scene_raycast(scene, rays[i].origin, rays[i].dir, rays[i].tMax, &single);
+        expectedHits += got;
+        assert(got ? (hits[i].t == single.t && hits[i].instance == single.instance) : hits[i].t < 0.0f);
+    }
+    assert(hitCount == expectedHits && hitCount > 0);
+
+    g4f_bvh_scene_destroy(scene);
+    g4f_bvh_mesh_destroy(terrainBvh);
+    g4f_bvh_mesh_destroy(soupBvh);
+}
+
+static void testPickingRay() {
+    const Mesh terrain = makeTerrain(4);
+    g4f_bvh_mesh* bvh = buildMesh(terrain, 4);
+    g4f_bvh_scene* scene = g4f_bvh_scene_create();
+    g4f_bvh_scene_add(scene, bvh, nullptr);
+    g4f_bvh_scene_build(scene);
+
+    // Camera 5 units above the origin looking straight down (its +Z turned onto -Y).
+    const g4f_mat4 camera = g4f_mat4_trs(g4f_vec3{0.0f, 5.0f, 0.0f}, g4f_quat_from_axis_angle(g4f_vec3{1.0f, 0.0f, 0.0f}, 1.5707963f), g4f_vec3{1.0f, 1.0f, 1.0f});
+    const g4f_mat4 viewProj = g4f_mat4_mul(g4f_mat4_inverse(camera), g4f_mat4_perspective(1.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+    const g4f_bvh_ray center = g4f_bvh_ray_from_screen(&viewProj, 640.0f, 360.0f, 1280.0f, 720.0f);
+    assert(feq(center.origin.y, 4.9f, 1e-2f) && center.dir.y < 0.0f);
+    g4f_bvh_hit hit{};
+    assert(g4f_bvh_scene_raycast(scene, center.origin, center.dir, center.tMax, &hit) == 1);
+    const g4f_vec3 p{center.origin.x + center.dir.x * hit.t, center.origin.y + center.dir.y * hit.t, center.origin.z + center.dir.z * hit.t};
+    assert(std::fabs(p.y) < 0.25f && std::fabs(p.x) < 1e-3f && std::fabs(p.z) < 1e-3f);
+
+    // Points along any picking ray project back onto its pixel.
+    const g4f_bvh_ray r = g4f_bvh_ray_from_screen(&viewProj, 900.0f, 200.0f, 1280.0f, 720.0f);
+    for (float s : {0.0f, 0.3f, 1.0f}) {
+        const g4f_vec3 q{r.origin.x + r.dir.x * s, r.origin.y + r.dir.y * s, r.origin.z + r.dir.z * s};
+        const float* m = viewProj.m;
+        const float cx = q.x * m[0] + q.y * m[4] + q.z * m[8] + m[12];
+        const float cy = q.x * m[1] + q.y * m[5] + q.z * m[9] + m[13];
+        const float cw = q.x * m[3] + q.y * m[7] + q.z * m[11] + m[15];
+        assert(feq((cx / cw + 1.0f) * 640.0f, 900.0f, 1e-3f) && feq((1.0f - cy / cw) * 360.0f, 200.0f, 1e-3f));
+    }
+    // A corner pixel looks past the 2x2 terrain.
+    const g4f_bvh_ray corner = g4f_bvh_ray_from_screen(&viewProj, 0.0f, 0.0f, 1280.0f, 720.0f);
+    assert(g4f_bvh_scene_raycast(scene, corner.origin, corner.dir, corner.tMax, &hit) == 0);
+
+    g4f_bvh_scene_destroy(scene);
+    g4f_bvh_mesh_destroy(bvh);
+}
+
+static void testNullHandles() {
+    g4f_bvh_hit hit{};
+    assert(g4f_bvh_mesh_raycast(nullptr, g4f_vec3{}, g4f_vec3{0, 0, 1}, 1.0f, &hit) == 0);
+    assert(g4f_bvh_scene_raycast(nullptr, g4f_vec3{}, g4f_vec3{0, 0, 1}, 1.0f, &hit) == 0);
+    assert(g4f_bvh_scene_add(nullptr, nullptr, nullptr) == -1);
+    g4f_bvh_scene* empty = g4f_bvh_scene_create();
+    g4f_bvh_scene_build(empty);
+    g4f_bvh_scene_refit(empty);
+    assert(g4f_bvh_scene_raycast(empty, g4f_vec3{}, g4f_vec3{0, 0, 1}, 1.0f, &hit) == 0);
+    assert(g4f_bvh_scene_overlap_sphere(empty, g4f_vec3{}, 1.0f, &hit, 1) == 0);
+    g4f_bvh_scene_remove(empty, 3);
+    g4f_bvh_scene_destroy(empty);
+    g4f_bvh_mesh_destroy(nullptr);
+    g4f_bvh_scene_destroy(nullptr);
+}
+
+int main() {
+    testMeshRaysMatchBruteForce();
+    testSphereOverlap();
+    testInputLayoutsAndDegenerates();
+    testSceneInstancesRefitAndRebuild();
+    testPickingRay();
+    testNullHandles();
+    std::printf("bvh_tests: OK\n");
+    return 0;
+}
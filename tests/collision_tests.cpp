@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <utility>
+#include <vector>
+
+#include "g4f/g4f_collision.h"
+
+static uint32_t g_rng = 3u;
+static float randf(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static bool feq(float a, float b, float eps = 1e-3f) {
+    return std::fabs(a - b) <= eps;
+}
+
+static bool overlap(const g4f_aabb& a, const g4f_aabb& b) {
+    return a.min.x <= b.max.x && b.min.x <= a.max.x && a.min.y <= b.max.y && b.min.y <= a.max.y && a.min.z <= b.max.z && b.min.z <= a.max.z;
+}
+
+static g4f_aabb boxAt(float x, float y, float z, float h) {
+    return g4f_aabb{g4f_vec3{x - h, y - h, z - h}, g4f_vec3{x + h, y + h, z + h}};
+}
+
+static std::vector<std::pair<int, int>> brutePairs(const std::vector<g4f_aabb>& boxes, const std::vector<bool>& alive) {
+    std::vector<std::pair<int, int>> out;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        for (size_t j = i + 1; j < boxes.size(); j++) {
+            if (alive[i] && alive[j] && overlap(boxes[i], boxes[j])) out.emplace_back((int)i, (int)j);
+        }
+    }
+    return out;
+}
+
+static void checkPairs(g4f_broadphase* bp, const std::vector<std::pair<int, int>>& expected) {
+    const int count = g4f_broadphase_update(bp);
+    int n = 0;
+    const g4f_broadphase_pair* pairs = g4f_broadphase_pairs(bp, &n);
+    assert(count == n && n == (int)expected.size());
+    for (int i = 0; i < n; i++) assert(pairs[i].a == expected[(size_t)i].first && pairs[i].b == expected[(size_t)i].second);
+}
+
+// Every mode reports exactly the brute-force pairs while bodies move, appear and disappear.
+static void testBroadphaseModesMatchBruteForce() {
+    for (int mode : {G4F_BROADPHASE_AUTO, G4F_BROADPHASE_SAP, G4F_BROADPHASE_GRID}) {
+        g4f_broadphase_desc desc = g4f_broadphase_desc_default();
+        desc.mode = mode;
+        g4f_broadphase* bp = g4f_broadphase_create(&desc);
+        std::vector<g4f_aabb> boxes;
+        std::vector<bool> alive;
+        for (int i = 0; i < 400; i++) {
+            g4f_aabb b = boxAt(randf(-20.0f, 20.0f), randf(-5.0f, 5.0f), randf(-20.0f, 20.0f), randf(0.2f, 1.5f));
+            if (i % 97 == 0) b = g4f_aabb{g4f_vec3{-30.0f, -1.0f, -30.0f}, g4f_vec3{30.0f, 0.0f, 30.0f}}; // spans many cells
+            if (i == 5) b = boxAt(1e9f, 0.0f, 0.0f, 1.0f);                                                   // beyond the hash range
+            if (i == 6) b = boxAt(1e9f, 0.5f, 0.0f, 1.0f);
+            assert(g4f_broadphase_add(bp, &b) == i);
+            boxes.push_back(b);
+            alive.push_back(true);
+        }
+        // Exactly touching boxes count as overlapping.
+        boxes[10] = g4f_aabb{g4f_vec3{100.0f, 0.0f, 0.0f}, g4f_vec3{101.0f, 1.0f, 1.0f}};
+        boxes[11] = g4f_aabb{g4f_vec3{101.0f, 1.0f, 1.0f}, g4f_vec3{102.0f, 2.0f, 2.0f}};
+        g4f_broadphase_move(bp, 10, &boxes[10]);
+        g4f_broadphase_move(bp, 11, &boxes[11]);
+
+        for (int frame = 0; frame < 12; frame++) {
+            checkPairs(bp, brutePairs(boxes, alive));
+            for (size_t i = 12; i < boxes.size(); i++) {
+                if (!alive[i] || i % 97 == 0) continue;
+                const float dx = randf(-0.4f, 0.4f), dz = randf(-0.4f, 0.4f);
+                boxes[i].min.x += dx;
+                boxes[i].max.x += dx;
+                boxes[i].min.z += dz;
+                boxes[i].max.z += dz;
+                g4f_broadphase_move(bp, (int)i, &boxes[i]);
+            }
+            if (frame == 4) {
+                for (int id : {20, 21, 150}) {
+                    g4f_broadphase_remove(bp, id);
+                    alive[(size_t)id] = false;
+                }
+            }
+            if (frame == 7) {
+                // Freed ids come back.
+                const g4f_aabb b = boxAt(0.0f, 0.0f, 0.0f, 2.0f);
+                const int id = g4f_broadphase_add(bp, &b);
+                assert(id == 20 || id == 21 || id == 150);
+                boxes[(size_t)id] = b;
+                alive[(size_t)id] = true;
+            }
+        }
+        g4f_broadphase_stats stats{};
+        g4f_broadphase_get_stats(bp, &stats);
+        assert(stats.bodies == 398 && stats.pairs > 0 && stats.tests >= stats.pairs);
+        assert(stats.usedGrid == (mode == G4F_BROADPHASE_GRID ? 1 : stats.usedGrid));
+        g4f_broadphase_destroy(bp);
+    }
+}
+
+static void testBroadphaseAutoPicksHashWhenDense() {
+    g4f_broadphase* bp = g4f_broadphase_create(nullptr);
+    std::vector<g4f_aabb> boxes;
+    // Spread along Z only: every body overlaps every other on X, but few truly overlap.
+    for (int i = 0; i < 500; i++) {
+        boxes.push_back(boxAt(randf(-0.1f, 0.1f), 0.0f, (float)i * 1.5f, 0.5f));
+        g4f_broadphase_add(bp, &boxes.back());
+    }
+    checkPairs(bp, brutePairs(boxes, std::vector<bool>(boxes.size(), true)));
+    g4f_broadphase_stats stats{};
+    g4f_broadphase_get_stats(bp, &stats);
+    assert(stats.usedGrid == 1 && stats.xOverlaps == 500LL * 499 / 2 && stats.tests < stats.xOverlaps / 20);
+
+    // Spread along X: sort-and-sweep.
+    for (int i = 0; i < 500; i++) {
+        boxes[(size_t)i] = boxAt((float)i * 1.5f, 0.0f, randf(-0.1f, 0.1f), 0.5f);
+        g4f_broadphase_move(bp, i, &boxes[(size_t)i]);
+    }
+    checkPairs(bp, brutePairs(boxes, std::vector<bool>(boxes.size(), true)));
+    g4f_broadphase_get_stats(bp, &stats);
+    assert(stats.usedGrid == 0 && stats.swaps > 0);
+    // Nothing moved: the insertion sort does no work.
+    g4f_broadphase_update(bp);
+    g4f_broadphase_get_stats(bp, &stats);
+    assert(stats.swaps == 0);
+    g4f_broadphase_destroy(bp);
+}
+
+// ---- Narrowphase ----
+
+struct Level {
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+
+    void quad(g4f_vec3 a, g4f_vec3 b, g4f_vec3 c, g4f_vec3 d) {
+        const uint32_t base = (uint32_t)positions.size();
+        positions.insert(positions.end(), {a, b, c, d});
+        const uint32_t idx[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        indices.insert(indices.end(), idx, idx + 6);
+    }
+
+    g4f_bvh_mesh* build() const {
+        g4f_bvh_mesh_desc d = g4f_bvh_mesh_desc_default();
+        d.positions = positions.data();
+        d.vertexCount = (int)positions.size();
+        d.indices32 = indices.data();
+        d.indexCount = (int)indices.size();
+        return g4f_bvh_mesh_create(&d);
+    }
+};
+
+static void testNarrowphaseShapes() {
+    Level floor;
+    floor.quad(g4f_vec3{-1, 0, -1}, g4f_vec3{-1, 0, 1}, g4f_vec3{1, 0, 1}, g4f_vec3{1, 0, -1});
+    g4f_bvh_mesh* mesh = floor.build();
+    g4f_contact c[4];
+
+    // Sphere above and below (two-sided), and a miss.
+    int n = g4f_collide_sphere_mesh(mesh, g4f_vec3{0.2f, 0.5f, 0.3f}, 1.0f, c, 4);
+    assert(n >= 1 && feq(c[0].normal.y, 1.0f) && feq(c[0].depth, 0.5f) && feq(c[0].point.y, 0.0f));
+    n = g4f_collide_sphere_mesh(mesh, g4f_vec3{0.2f, -0.5f, 0.3f}, 1.0f, c, 4);
+    assert(n >= 1 && feq(c[0].normal.y, -1.0f) && feq(c[0].depth, 0.5f));
+    assert(g4f_collide_sphere_mesh(mesh, g4f_vec3{0.0f, 1.5f, 0.0f}, 1.0f, c, 4) == 0);
+    // Past the edge the normal points from the edge to the center.
+    n = g4f_collide_sphere_mesh(mesh, g4f_vec3{1.3f, 0.3f, 0.0f}, 0.5f, c, 4);
+    assert(n >= 1 && feq(c[0].point.x, 1.0f) && feq(c[0].normal.x, 0.70710678f) && feq(c[0].normal.y, 0.70710678f));
+    assert(feq(c[0].depth, 0.5f - std::sqrt(0.18f)));
+
+    // Lying capsule, and a capsule piercing the floor (pushed out towards its midpoint).
+    n = g4f_collide_capsule_mesh(mesh, g4f_vec3{-0.5f, 0.2f, 0.0f}, g4f_vec3{0.5f, 0.2f, 0.0f}, 0.3f, c, 4);
+    assert(n >= 1 && feq(c[0].normal.y, 1.0f) && feq(c[0].depth, 0.1f));
+    n = g4f_collide_capsule_mesh(mesh, g4f_vec3{0.1f, -0.5f, 0.1f}, g4f_vec3{0.1f, 1.0f, 0.1f}, 0.3f, c, 4);
+    assert(n >= 1 && feq(c[0].normal.y, 1.0f) && feq(c[0].depth, 0.8f));
+    assert(g4f_collide_capsule_mesh(mesh, g4f_vec3{-0.5f, 0.5f, 0.0f}, g4f_vec3{0.5f, 0.5f, 0.0f}, 0.3f, c, 4) == 0);
+    // A capsule crossing the edge diagonally: closest features are segment vs edge.
+    n = g4f_collide_capsule_mesh(mesh, g4f_vec3{1.2f, 0.1f, -0.5f}, g4f_vec3{1.2f, 0.1f, 0.5f}, 0.3f, c, 4);
+    assert(n >= 1 && feq(c[0].point.x, 1.0f) && feq(c[0].depth, 0.3f - std::sqrt(0.05f)));
+
+    // Boxes: resting on the floor, hovering above it, and straddling it from below.
+    g4f_aabb box{g4f_vec3{-0.5f, -0.2f, -0.5f}, g4f_vec3{0.5f, 0.3f, 0.5f}};
+    n = g4f_collide_aabb_mesh(mesh, &box, c, 4);
+    assert(n >= 1 && feq(c[0].normal.y, 1.0f) && feq(c[0].depth, 0.2f));
+    box = g4f_aabb{g4f_vec3{-0.5f, 0.1f, -0.5f}, g4f_vec3{0.5f, 0.3f, 0.5f}};
+    assert(g4f_collide_aabb_mesh(mesh, &box, c, 4) == 0);
+    box = g4f_aabb{g4f_vec3{-0.5f, -0.4f, -0.5f}, g4f_vec3{0.5f, 0.1f, 0.5f}};
+    n = g4f_collide_aabb_mesh(mesh, &box, c, 4);
+    assert(n >= 1 && feq(c[0].normal.y, -1.0f) && feq(c[0].depth, 0.1f));
+    g4f_bvh_mesh_destroy(mesh);
+
+    // A tilted triangle whose bounds overlap the box but which the SAT separates.
+    Level slant;
+    slant.quad(g4f_vec3{0, 0, 0}, g4f_vec3{0, 0, 1}, g4f_vec3{1, 1, 1}, g4f_vec3{1, 1, 0});
+    mesh = slant.build();
+    box = g4f_aabb{g4f_vec3{0.6f, 0.0f, 0.2f}, g4f_vec3{0.9f, 0.3f, 0.4f}};
+    assert(g4f_collide_aabb_mesh(mesh, &box, c, 4) == 0);
+    box = g4f_aabb{g4f_vec3{0.4f, 0.3f, 0.2f}, g4f_vec3{0.6f, 0.5f, 0.4f}};
+    n = g4f_collide_aabb_mesh(mesh, &box, c, 4);
+    assert(n >= 1);
+    const g4f_contact& deepest = *std::max_element(c, c + n, [](const g4f_contact& x, const g4f_contact& y) { return x.depth < y.depth; });
+    assert(feq(deepest.normal.x, 0.70710678f) && feq(deepest.normal.y, -0.70710678f) && feq(deepest.depth, 0.1f * 0.70710678f));
+    g4f_bvh_mesh_destroy(mesh);
+
+    assert(g4f_collide_sphere_mesh(nullptr, g4f_vec3{}, 1.0f, c, 4) == 0);
+    assert(g4f_collide_aabb_mesh(nullptr, &box, c, 4) == 0);
+}
+
+// ---- Character controller ----
+
+// Floor at y = 0, a wall at x = 2, and a 20 degree ramp rising along +z from z = 5.
+static Level makeLevel() {
+    Level l;
+    l.quad(g4f_vec3{-20, 0, -20}, g4f_vec3{-20, 0, 5}, g4f_vec3{20, 0, 5}, g4f_vec3{20, 0, -20});
+    l.quad(g4f_vec3{2, 0, -20}, g4f_vec3{2, 3, -20}, g4f_vec3{2, 3, 5}, g4f_vec3{2, 0, 5});
+    const float rise = std::tan(20.0f * 3.14159265f / 180.0f) * 10.0f;
+    l.quad(g4f_vec3{-20, 0, 5}, g4f_vec3{-20, rise, 15}, g4f_vec3{20, rise, 15}, g4f_vec3{20, 0, 5});
+    return l;
+}
+
+static void simulate(g4f_character* ch, const g4f_bvh_mesh* world, g4f_vec3 wish, float seconds) {
+    const float dt = 1.0f / 60.0f;
+    for (float t = 0.0f; t < seconds; t += dt) g4f_character_step(ch, world, wish, 0, dt);
+}
+
+static void testCharacterController() {
+    const Level level = makeLevel();
+    g4f_bvh_mesh* world = level.build();
+    g4f_character ch;
+    g4f_character_init(&ch, nullptr, g4f_vec3{0.0f, 1.0f, 0.0f});
+    assert(feq(ch.desc.radius, 0.3f) && feq(ch.desc.height, 1.8f));
+
+    // Falls and lands on the floor.
+    simulate(&ch, world, g4f_vec3{0, 0, 0}, 1.0f);
+    assert(ch.grounded && std::fabs(ch.position.y) < 0.01f && feq(ch.velocity.y, 0.0f, 0.5f));
+
+    // Walks into the wall and stops a radius short of it.
+    simulate(&ch, world, g4f_vec3{4.0f, 0.0f, 0.0f}, 1.0f);
+    assert(ch.position.x <= 2.0f - 0.3f + 1e-3f && ch.position.x > 2.0f - 0.3f - 0.02f);
+
+    // Diagonal into the wall slides along it.
+    const float z0 = ch.position.z;
+    simulate(&ch, world, g4f_vec3{3.0f, 0.0f, -3.0f}, 1.0f);
+    assert(ch.position.z < z0 - 2.5f && ch.position.x <= 1.7f + 1e-3f);
+
+    // One huge move cannot tunnel through the wall.
+    g4f_character_init(&ch, nullptr, g4f_vec3{0.0f, 0.0f, 0.0f});
+    g4f_character_move(&ch, world, g4f_vec3{10.0f, 0.0f, 0.0f});
+    assert(ch.position.x < 2.0f);
+
+    // Walks up the ramp, then stands on it without creeping down.
+    g4f_character_init(&ch, nullptr, g4f_vec3{-5.0f, 0.0f, 3.0f});
+    simulate(&ch, world, g4f_vec3{0.0f, 0.0f, 4.0f}, 1.5f);
+    assert(ch.position.z > 7.0f && ch.position.y > 0.5f && ch.grounded);
+    const g4f_vec3 standing = ch.position;
+    simulate(&ch, world, g4f_vec3{0, 0, 0}, 1.0f);
+    assert(std::fabs(ch.position.z - standing.z) < 0.01f && std::fabs(ch.position.y - standing.y) < 0.01f);
+
+    // Jumps and lands again.
+    g4f_character_init(&ch, nullptr, g4f_vec3{-5.0f, 0.0f, 0.0f});
+    simulate(&ch, world, g4f_vec3{0, 0, 0}, 0.2f);
+    assert(ch.grounded);
+    g4f_character_step(&ch, world, g4f_vec3{0, 0, 0}, 1, 1.0f / 60.0f);
+    float peak = 0.0f;
+    for (int i = 0; i < 120; i++) {
+        g4f_character_step(&ch, world, g4f_vec3{0, 0, 0}, 0, 1.0f / 60.0f);
+        peak = std::max(peak, ch.position.y);
+    }
+    assert(peak > 0.7f && ch.grounded && std::fabs(ch.position.y) < 0.01f);
+
+    // Flying ignores gravity and still collides.
+    g4f_character_desc fly = g4f_character_desc_default();
+    fly.flying = 1;
+    g4f_character_init(&ch, &fly, g4f_vec3{0.0f, 2.0f, 0.0f});
+    simulate(&ch, world, g4f_vec3{0, 0, 0}, 1.0f);
+    assert(feq(ch.position.y, 2.0f));
+    simulate(&ch, world, g4f_vec3{0.0f, -3.0f, 0.0f}, 2.0f);
+    assert(std::fabs(ch.position.y) < 0.01f);
+
+    // Without a world the move is applied as is.
+    g4f_character_move(&ch, nullptr, g4f_vec3{0.0f, -5.0f, 0.0f});
+    assert(feq(ch.position.y, -5.0f, 0.02f));
+    g4f_bvh_mesh_destroy(world);
+}
+
+int main() {
+    testBroadphaseModesMatchBruteForce();
+    testBroadphaseAutoPicksHashWhenDense();
+    testNarrowphaseShapes();
+    testCharacterController();
+    std::printf("collision_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,325 @@
+#include <cassert>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "g4f/g4f_content_cache.h"
+
+static std::vector<uint8_t> readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+}
+
+static std::filesystem::path entryPath(const std::filesystem::path& dir, uint64_t key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.g4fc", (unsigned long long)key);
+    return dir / name;
+}
+
+static std::vector<uint8_t> payload(uint64_t key, size_t size) {
+    std::vector<uint8_t> bytes(size);
+    for (size_t i = 0; i < size; i++) bytes[i] = (uint8_t)(key * 31 + i * 7);
+    return bytes;
+}
+
+static g4f_content_cache* openCache(const std::filesystem::path& dir, uint64_t maxBytes, int verify = 0) {
+    const std::u8string path = dir.u8string();
+    g4f_content_cache_desc desc{};
+    desc.dirUtf8 = (const char*)path.c_str();
+    desc.maxBytes = maxBytes;
+    desc.verifyChecksums = verify;
+    g4f_content_cache* cache = g4f_content_cache_open(&desc);
+    assert(cache);
+    return cache;
+}
+
+static g4f_content_cache_stats statsOf(const g4f_content_cache* cache) {
+    g4f_content_cache_stats s{};
+    g4f_content_cache_get_stats(cache, &s);
+    return s;
+}
+
+static bool hitMatches(g4f_content_cache* cache, uint64_t key, size_t size) {
+    size_t got = 0;
+    const void* data = g4f_content_cache_get(cache, key, &got);
+    const std::vector<uint8_t> expected = payload(key, size);
+    return data && got == size && std::memcmp(data, expected.data(), size) == 0;
+}
+
+static void testKeys() {
+    const float a[2] = {1.0f, 2.0f};
+    const float b[2] = {1.0f, 2.5f};
+    const uint64_t k = g4f_content_cache_key("terrain", 1, a, sizeof(a));
+    assert(k == g4f_content_cache_key("terrain", 1, a, sizeof(a)));
+    assert(k != g4f_content_cache_key("terrain", 1, b, sizeof(b)));
+    assert(k != g4f_content_cache_key("terrain", 2, a, sizeof(a)));
+    assert(k != g4f_content_cache_key("terrainx", 1, a, sizeof(a)));
+    assert(k != g4f_content_cache_key("terrain", 1, a, sizeof(float)));
+    // Appending is length-prefixed: splitting the same bytes differently is a different key.
+    const uint64_t base = g4f_content_cache_key("g", 1, nullptr, 0);
+    const uint8_t bytes[3] = {1, 2, 3};
+    assert(g4f_content_cache_key_append(g4f_content_cache_key_append(base, bytes, 1), bytes + 1, 2) !=
+           g4f_content_cache_key_append(g4f_content_cache_key_append(base, bytes, 2), bytes + 2, 1));
+    assert(g4f_content_cache_key(nullptr, 0, nullptr, 0) == g4f_content_cache_key("", 0, nullptr, 0));
+}
+
+static void testRoundTripAndPersistence(const std::filesystem::path& dir) {
+    std::filesystem::remove_all(dir);
+    g4f_content_cache* cache = openCache(dir, 0);
+    size_t size = 123;
+    g4f_clear_error();
+    assert(!g4f_content_cache_get(cache, 1, &size) && size == 0);
+    assert(g4f_last_error()[0] == 0);
+    assert(g4f_content_cache_put(cache, 1, payload(1, 1000).data(), 1000));
+    assert(g4f_content_cache_put(cache, 2, nullptr, 0));
+    assert(hitMatches(cache, 1, 1000));
+    assert(g4f_content_cache_get(cache, 2, &size) && size == 0);
+    // The mapping is 64-byte aligned so entries can hold SIMD-friendly arrays.
+    assert(((uintptr_t)g4f_content_cache_get(cache, 1, nullptr) & 63) == 0);
+    // Re-putting a mapped entry keeps the mapping valid.
+    const void* mapped = g4f_content_cache_get(cache, 1, nullptr);
+    assert(g4f_content_cache_put(cache, 1, payload(1, 1000).data(), 1000));
+    assert(g4f_content_cache_get(cache, 1, nullptr) == mapped && hitMatches(cache, 1, 1000));
+
+    g4f_content_cache_stats s = statsOf(cache);
+    assert(s.entries == 2 && s.bytes == 64 + 1000 + 64 && s.puts == 3 && s.misses == 1 && s.hits == 6 && s.hitBytes == 5000);
+    g4f_content_cache_close(cache);
+
+    // A new instance finds both entries; a stale temporary file from a crashed put is cleaned up.
+    writeFile(dir / "00000000000000ff.g4fc.7.tmp", {1, 2, 3});
+    writeFile(dir / "notes.txt", {1});
+    cache = openCache(dir, 0);
+    s = statsOf(cache);
+    assert(s.entries == 2 && s.bytes == 64 + 1000 + 64 && s.hits == 0 && s.misses == 0);
+    assert(!std::filesystem::exists(dir / "00000000000000ff.g4fc.7.tmp") && std::filesystem::exists(dir / "notes.txt"));
+    assert(hitMatches(cache, 1, 1000));
+    assert(!g4f_content_cache_get(cache, 3, nullptr));
+    g4f_content_cache_close(cache);
+}
+
+// Entry paths reach g4f_file_map_open as UTF-8, so a non-ASCII directory still gets hits.
+static void testNonAsciiDirectory(const std::filesystem::path& dir) {
+    const std::filesystem::path unicodeDir = dir / std::filesystem::path(u8"caché_кэш_キャッシュ");
+    std::filesystem::remove_all(dir);
+    g4f_content_cache* cache = openCache(unicodeDir, 0);
+    assert(g4f_content_cache_put(cache, 5, payload(5, 300).data(), 300));
+    g4f_content_cache_close(cache);
+
+    cache = openCache(unicodeDir, 0); // a fresh instance has to map the file from disk
+    assert(hitMatches(cache, 5, 300));
+    const g4f_content_cache_stats s = statsOf(cache);
+    assert(s.hits == 1 && s.misses == 0 && s.rejected == 0);
+    g4f_content_cache_close(cache);
+    assert(std::filesystem::exists(entryPath(unicodeDir, 5)));
+}
+
+static void testEviction(const std::filesystem::path& dir) {
+    std::filesystem::remove_all(dir);
+    const uint64_t entryBytes = 64 + 1000;
+    g4f_content_cache* cache = openCache(dir, 3 * entryBytes);
+    for (uint64_t k = 1; k <= 4; k++) assert(g4f_content_cache_put(cache, k, payload(k, 1000).data(), 1000));
+    g4f_content_cache_stats s = statsOf(cache);
+    assert(s.entries == 3 && s.bytes == 3 * entryBytes && s.evictions == 1);
+    assert(!std::filesystem::exists(entryPath(dir, 1)) && std::filesystem::exists(entryPath(dir, 2)));
+
+    // Re-putting 2 makes it the most recently used: 3 goes next.
+    assert(g4f_content_cache_put(cache, 2, payload(2, 1000).data(), 1000));
+    assert(g4f_content_cache_put(cache, 5, payload(5, 1000).data(), 1000));
+    assert(!std::filesystem::exists(entryPath(dir, 3)) && std::filesystem::exists(entryPath(dir, 2)));
+
+    // Mapped entries are pinned: with 4 and 5 mapped only 2 can go, even though 4 is older.
+    assert(hitMatches(cache, 4, 1000) && hitMatches(cache, 5, 1000));
+    assert(g4f_content_cache_put(cache, 6, payload(6, 1000).data(), 1000));
+    assert(!std::filesystem::exists(entryPath(dir, 2)) && hitMatches(cache, 4, 1000) && hitMatches(cache, 5, 1000));
+    // Everything else pinned: the new entry is evicted right away but the put still succeeds.
+    assert(hitMatches(cache, 6, 1000));
+    assert(g4f_content_cache_put(cache, 7, payload(7, 1000).data(), 1000));
+    s = statsOf(cache);
+    assert(s.entries == 3 && s.evictions == 4 && !std::filesystem::exists(entryPath(dir, 7)));
+    g4f_content_cache_close(cache);
+
+    // Use order carries over between runs through modification times: 5 is the oldest, then 6.
+    const auto now = std::filesystem::file_time_type::clock::now();
+    std::filesystem::last_write_time(entryPath(dir, 5), now - std::chrono::hours(3));
+    std::filesystem::last_write_time(entryPath(dir, 6), now - std::chrono::hours(2));
+    std::filesystem::last_write_time(entryPath(dir, 4), now - std::chrono::hours(1));
+    cache = openCache(dir, 2 * entryBytes);
+    s = statsOf(cache);
+    assert(s.entries == 2 && s.evictions == 1 && !std::filesystem::exists(entryPath(dir, 5)));
+    // A hit refreshes the time, so 6 outlives 4 in the next session.
+    assert(hitMatches(cache, 6, 1000));
+    g4f_content_cache_close(cache);
+    cache = openCache(dir, entryBytes);
+    assert(statsOf(cache).entries == 1 && std::filesystem::exists(entryPath(dir, 6)) && !std::filesystem::exists(entryPath(dir, 4)));
+    g4f_content_cache_close(cache);
+}
+
+static void testRejectsCorruptEntries(const std::filesystem::path& dir) {
+    std::filesystem::remove_all(dir);
+    g4f_content_cache* cache = openCache(dir, 0);
+    for (uint64_t k = 1; k <= 4; k++) assert(g4f_content_cache_put(cache, k, payload(k, 256).data(), 256));
+    g4f_content_cache_close(cache);
+
+    std::vector<uint8_t> bytes = readFile(entryPath(dir, 1));
+    bytes.erase(bytes.end() - 10, bytes.end()); // truncated
+    writeFile(entryPath(dir, 1), bytes);
+    writeFile(entryPath(dir, 2), {'n', 'o', 'p', 'e'}); // smaller than a header
+    bytes = readFile(entryPath(dir, 3));
+    bytes[64 + 100] ^= 0xFF; // data damage: only the checksum notices
+    writeFile(entryPath(dir, 3), bytes);
+    std::filesystem::copy_file(entryPath(dir, 4), entryPath(dir, 5)); // header key does not match the name
+
+    cache = openCache(dir, 0);
+    assert(!g4f_content_cache_get(cache, 1, nullptr) && !g4f_content_cache_get(cache, 2, nullptr));
+    assert(!g4f_content_cache_get(cache, 5, nullptr));
+    size_t size = 0;
+    const uint8_t* damaged = (const uint8_t*)g4f_content_cache_get(cache, 3, &size);
+    assert(damaged && size == 256 && damaged[100] != payload(3, 256)[100]);
+    g4f_content_cache_stats s = statsOf(cache);
+    assert(s.rejected == 3 && s.misses == 3 && s.hits == 1 && s.entries == 2);
+    assert(!std::filesystem::exists(entryPath(dir, 1)) && !std::filesystem::exists(entryPath(dir, 2)) && !std::filesystem::exists(entryPath(dir, 5)));
+    g4f_content_cache_close(cache);
+
+    cache = openCache(dir, 0, 1);
+    assert(!g4f_content_cache_get(cache, 3, nullptr) && hitMatches(cache, 4, 256));
+    s = statsOf(cache);
+    assert(s.rejected == 1 && s.entries == 1 && !std::filesystem::exists(entryPath(dir, 3)));
+    // Regenerating after a rejection works as a normal put.
+    assert(g4f_content_cache_put(cache, 3, payload(3, 256).data(), 256) && hitMatches(cache, 3, 256));
+    g4f_content_cache_close(cache);
+}
+
+static void testTexsynth(const std::filesystem::path& dir) {
+    std::filesystem::remove_all(dir);
+    g4f_jobs* jobs = g4f_jobs_create(2);
+    const g4f_texsynth_ramp_stop ramp[2] = {{0.0f, 0x102030FFu}, {1.0f, 0xF0E0D0FFu}};
+    g4f_texsynth_desc desc = g4f_texsynth_desc_default(G4F_TEXSYNTH_GRADIENT_NOISE);
+    desc.octaves = 4;
+    desc.ramp = ramp;
+    desc.rampCount = 2;
+
+    std::vector<uint8_t> expected(48 * 32 * 4);
+    assert(g4f_texsynth_generate_rgba8(&desc, nullptr, 48, 32, expected.data(), 0));
+    g4f_content_cache* cache = openCache(dir, 0);
+    const uint8_t* a = g4f_content_cache_texsynth_rgba8(cache, &desc, 48, 32, jobs);
+    assert(a && std::memcmp(a, expected.data(), expected.size()) == 0);
+    assert(g4f_content_cache_texsynth_rgba8(cache, &desc, 48, 32, jobs) == a);
+    g4f_content_cache_stats s = statsOf(cache);
+    assert(s.misses == 1 && s.puts == 1 && s.hits == 1 && s.entries == 1);
+
+    // Any parameter change is a different entry.
+    g4f_texsynth_desc other = desc;
+    other.seed += 1;
+    assert(g4f_content_cache_texsynth_rgba8(cache, &other, 48, 32, jobs) != a);
+    const g4f_texsynth_ramp_stop ramp2[2] = {{0.0f, 0x102030FFu}, {1.0f, 0xF0E0D1FFu}};
+    other = desc;
+    other.ramp = ramp2;
+    assert(g4f_content_cache_texsynth_rgba8(cache, &other, 48, 32, jobs));
+    assert(g4f_content_cache_texsynth_rgba8(cache, &desc, 32, 48, jobs));
+    assert(statsOf(cache).entries == 4);
+    g4f_content_cache_close(cache);
+
+    // The next run maps the stored pixels instead of generating them.
+    cache = openCache(dir, 0);
+    a = g4f_content_cache_texsynth_rgba8(cache, &desc, 48, 32, jobs);
+    assert(a && std::memcmp(a, expected.data(), expected.size()) == 0);
+    s = statsOf(cache);
+    assert(s.hits == 1 && s.misses == 0 && s.puts == 0);
+
+    // Larger than the cap: still returned, owned by the cache instead of the directory.
+    g4f_content_cache_close(cache);
+    cache = openCache(dir, 1024);
+    other.seed = 99;
+    const uint8_t* big = g4f_content_cache_texsynth_rgba8(cache, &other, 64, 64, jobs);
+    assert(big && big[3] == 0xFF && statsOf(cache).entries == 0);
+
+    assert(!g4f_content_cache_texsynth_rgba8(cache, nullptr, 4, 4, jobs));
+    assert(!g4f_content_cache_texsynth_rgba8(cache, &desc, 0, 4, jobs));
+    assert(!g4f_content_cache_texsynth_rgba8(nullptr, &desc, 4, 4, jobs));
+    other = desc;
+    other.ramp = nullptr;
+    assert(!g4f_content_cache_texsynth_rgba8(cache, &other, 4, 4, jobs));
+    g4f_content_cache_close(cache);
+    g4f_jobs_destroy(jobs);
+}
+
+static void testConcurrentUse(const std::filesystem::path& dir) {
+    std::filesystem::remove_all(dir);
+    g4f_content_cache* cache = openCache(dir, 24 * (64 + 512));
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 8; t++) {
+        threads.emplace_back([cache, t] {
+            for (int i = 0; i < 200; i++) {
+                const uint64_t key = (uint64_t)((i * 7 + t * 3) % 40) + 1;
+                size_t size = 0;
+                const uint8_t* hit = (const uint8_t*)g4f_content_cache_get(cache, key, &size);
+                if (hit) {
+                    assert(size == 512 && std::memcmp(hit, payload(key, 512).data(), 512) == 0);
+                } else {
+                    assert(g4f_content_cache_put(cache, key, payload(key, 512).data(), 512));
+                }
+            }
+        });
+    }
+    for (auto& th : threads) th.join();
+    g4f_content_cache_stats s = statsOf(cache);
+    assert(s.hits + s.misses == 1600 && s.puts == s.misses);
+    assert(s.rejected == 0);
+    g4f_content_cache_close(cache);
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) assert(entry.path().extension() == ".g4fc");
+}
+
+static void testInvalidArgs(const std::filesystem::path& dir) {
+    g4f_content_cache_desc desc{};
+    assert(!g4f_content_cache_open(nullptr) && g4f_last_error()[0]);
+    assert(!g4f_content_cache_open(&desc));
+    desc.dirUtf8 = "";
+    assert(!g4f_content_cache_open(&desc));
+    // A regular file where the directory should be.
+    std::filesystem::remove_all(dir);
+    writeFile(dir, {1});
+    const std::string path = dir.string();
+    desc.dirUtf8 = path.c_str();
+    assert(!g4f_content_cache_open(&desc));
+    std::filesystem::remove(dir);
+
+    assert(!g4f_content_cache_put(nullptr, 1, "a", 1));
+    g4f_content_cache* cache = openCache(dir, 0);
+    assert(!g4f_content_cache_put(cache, 1, nullptr, 4));
+    size_t size = 9;
+    assert(!g4f_content_cache_get(nullptr, 1, &size) && size == 0);
+    g4f_content_cache_stats s{};
+    s.hits = 5;
+    g4f_content_cache_get_stats(nullptr, &s);
+    assert(s.hits == 0);
+    g4f_content_cache_get_stats(cache, nullptr);
+    g4f_content_cache_close(cache);
+    g4f_content_cache_close(nullptr);
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "g4f_content_cache_tests";
+    testKeys();
+    testRoundTripAndPersistence(dir);
+    testNonAsciiDirectory(dir);
+    testEviction(dir);
+    testRejectsCorruptEntries(dir);
+    testTexsynth(dir);
+    testConcurrentUse(dir);
+    testInvalidArgs(dir);
+    std::filesystem::remove_all(dir);
+    std::printf("content_cache_tests: OK\n");
+    return 0;
+}
@@ -4,6 +4,7 @@
 #include <vector>
 
 #include "g4f/g4f.h"
+#include "g4f/g4f_frame_stats.h"
 
 static bool isFiniteMat4(g4f_mat4 m) {
     for (float v : m.m) {
@@ -43,6 +44,13 @@ int main() {
     g4f_bitmap_get_size(bmp, &gotW, &gotH);
     assert(gotW == bmpW && gotH == bmpH);
 
+    // Regions share the source's pixels and outlive it.
+    g4f_bitmap* region = g4f_bitmap_create_region(bmp, 1, 0, 1, 2);
+    assert(region != nullptr);
+    g4f_bitmap_get_size(region, &gotW, &gotH);
+    assert(gotW == 1 && gotH == 2);
+    assert(g4f_bitmap_create_region(bmp, 1, 1, 2, 1) == nullptr);
+
     g4f_window_set_title(window, "g4f_ctx2d_smoke_tests (running)");
 
     double start = g4f_ctx_time(ctx);
@@ -106,7 +114,17 @@ int main() {
         g4f_frame_end(ctx);
     }
 
+    // Last frame: 8 draws, one brush color per colored primitive, one clip push/pop.
+    g4f_gfx_frame_stats stats{};
+    g4f_renderer_get_frame_stats(renderer, &stats);
+    assert(stats.drawCalls == 8);
+    assert(stats.stateChanges[G4F_GFX_STATE_BRUSH] + stats.redundantAvoided[G4F_GFX_STATE_BRUSH] == 7);
+    assert(stats.stateChanges[G4F_GFX_STATE_CLIP] == 2);
+    assert(stats.resourcesCreated >= 2); // text layouts are per call
+    assert(stats.triangles == 0);
+
     g4f_bitmap_destroy(bmp);
+    g4f_bitmap_destroy(region);
     g4f_ctx_destroy(ctx);
     std::printf("ctx2d_smoke_tests: OK\n");
     return 0;
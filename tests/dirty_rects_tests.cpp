@@ -0,0 +1,102 @@
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_dirty_rects.h"
+
+static bool covers(const g4f_dirty_rects& d, int x, int y) {
+    for (int i = 0; i < d.count; i++) {
+        const g4f_rect_i& r = d.rects[i];
+        if (x >= r.x && x < r.x + r.w && y >= r.y && y < r.y + r.h) return true;
+    }
+    return false;
+}
+
+static void testClipAndEmpty() {
+    g4f_dirty_rects d;
+    g4f_dirty_rects_reset(&d, 64, 32);
+    g4f_dirty_rects_add(&d, 10, 10, 0, 5);
+    g4f_dirty_rects_add(&d, 100, 0, 8, 8);
+    g4f_dirty_rects_add(&d, -4, -4, 4, 4);
+    assert(d.count == 0);
+
+    g4f_dirty_rects_add(&d, -4, 28, 10, 10);
+    assert(d.count == 1);
+    assert(d.rects[0].x == 0 && d.rects[0].y == 28 && d.rects[0].w == 6 && d.rects[0].h == 4);
+}
+
+static void testContainedAndOverlapping() {
+    g4f_dirty_rects d;
+    g4f_dirty_rects_reset(&d, 128, 128);
+    g4f_dirty_rects_add(&d, 0, 0, 32, 32);
+    g4f_dirty_rects_add(&d, 4, 4, 8, 8); // contained
+    assert(d.count == 1 && g4f_dirty_rects_area(&d) == 32 * 32);
+
+    g4f_dirty_rects_add(&d, 16, 16, 32, 32); // overlapping -> union
+    assert(d.count == 1);
+    assert(d.rects[0].x == 0 && d.rects[0].y == 0 && d.rects[0].w == 48 && d.rects[0].h == 48);
+
+    g4f_dirty_rects_add(&d, 0, 48, 48, 8); // shares the full bottom edge -> exact union
+    assert(d.count == 1 && d.rects[0].h == 56);
+
+    g4f_dirty_rects_add(&d, 100, 100, 4, 4); // disjoint
+    assert(d.count == 2);
+    g4f_dirty_rects_add(&d, 104, 90, 4, 4);  // touches a corner only: wasteful union, kept separate
+    assert(d.count == 3);
+}
+
+static void testCapacityAndCoverage() {
+    // Scattered updates past capacity must still cover every touched pixel without overlap.
+    const int w = 256, h = 256;
+    g4f_dirty_rects d;
+    g4f_dirty_rects_reset(&d, w, h);
+    std::vector<unsigned char> touched((size_t)w * h, 0);
+    uint32_t s = 7u;
+    for (int i = 0; i < 200; i++) {
+        s = s * 1664525u + 1013904223u;
+        int x = (int)(s >> 8) % w;
+        int y = (int)(s >> 20) % h;
+        int rw = 1 + (int)(s & 15u);
+        int rh = 1 + (int)((s >> 4) & 15u);
+        g4f_dirty_rects_add(&d, x, y, rw, rh);
+        for (int yy = y; yy < y + rh && yy < h; yy++)
+            for (int xx = x; xx < x + rw && xx < w; xx++) touched[(size_t)yy * w + xx] = 1;
+
+        assert(d.count >= 1 && d.count <= G4F_DIRTY_RECTS_MAX);
+        for (int a = 0; a < d.count; a++) {
+            const g4f_rect_i& ra = d.rects[a];
+            assert(ra.x >= 0 && ra.y >= 0 && ra.x + ra.w <= w && ra.y + ra.h <= h);
+            for (int b = a + 1; b < d.count; b++) {
+                const g4f_rect_i& rb = d.rects[b];
+                bool overlap = ra.x < rb.x + rb.w && rb.x < ra.x + ra.w && ra.y < rb.y + rb.h && rb.y < ra.y + ra.h;
+                assert(!overlap);
+            }
+        }
+    }
+    for (int y = 0; y < h; y++)
+        for (int x = 0; x < w; x++)
+            if (touched[(size_t)y * w + x]) assert(covers(d, x, y));
+    assert(g4f_dirty_rects_area(&d) <= w * h);
+}
+
+static void testAddAllAndClear() {
+    g4f_dirty_rects d;
+    g4f_dirty_rects_reset(&d, 40, 30);
+    g4f_dirty_rects_add(&d, 1, 1, 2, 2);
+    g4f_dirty_rects_add(&d, 20, 20, 2, 2);
+    g4f_dirty_rects_add_all(&d);
+    assert(d.count == 1 && g4f_dirty_rects_area(&d) == 40 * 30);
+    g4f_dirty_rects_add(&d, 5, 5, 5, 5);
+    assert(d.count == 1);
+    g4f_dirty_rects_clear(&d);
+    assert(d.count == 0 && d.boundsW == 40 && d.boundsH == 30);
+}
+
+int main() {
+    testClipAndEmpty();
+    testContainedAndOverlapping();
+    testCapacityAndCoverage();
+    testAddAllAndClear();
+    std::printf("dirty_rects_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,110 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+
+#include "g4f/g4f_dynres.h"
+
+// Synthetic GPU-bound scene: fixed CPU cost plus a GPU cost proportional to pixel count.
+static float gpuCostMs(float fullResMs, float scale) {
+    return fullResMs * scale * scale;
+}
+
+static void testConvergesUnderLoadAndStaysStable() {
+    g4f_dynres d;
+    g4f_dynres_init(&d, nullptr);
+    assert(d.scale == 1.0f);
+
+    float scale = d.scale;
+    int changesAfterSettle = -1;
+    for (int frame = 0; frame < 600; frame++) {
+        scale = g4f_dynres_update(&d, 2.0f, gpuCostMs(30.0f, scale));
+        if (frame == 300) changesAfterSettle = d.changes;
+    }
+    // max(2, 30 * s^2) <= 16.67 * 1.05  ->  s <= ~0.76
+    float frameMs = gpuCostMs(30.0f, scale);
+    assert(frameMs <= d.desc.targetFrameMs * d.desc.upperBand);
+    assert(frameMs >= d.desc.targetFrameMs * d.desc.lowerBand);
+    assert(scale >= d.desc.minScale && scale < 0.75f);
+    assert(d.changes == changesAfterSettle); // no oscillation once settled
+}
+
+static void testRaisesSlowlyWhenLoadDrops() {
+    g4f_dynres d;
+    g4f_dynres_init(&d, nullptr);
+    float scale = 1.0f;
+    for (int frame = 0; frame < 200; frame++) scale = g4f_dynres_update(&d, 2.0f, gpuCostMs(60.0f, scale));
+    assert(scale == d.desc.minScale);
+
+    // Load disappears: one step per `raiseFrames` good frames, never a jump.
+    int changesBefore = d.changes;
+    float prev = scale;
+    int frames = 0;
+    while (scale < 1.0f && frames < 10000) {
+        scale = g4f_dynres_update(&d, 2.0f, gpuCostMs(8.0f, scale));
+        assert(scale - prev <= d.desc.scaleStep + 1e-5f);
+        prev = scale;
+        frames++;
+    }
+    assert(std::fabs(scale - 1.0f) < 1e-5f);
+    assert(frames >= (d.changes - changesBefore) * d.desc.raiseFrames);
+}
+
+static void testSpikesAndDeadbandAreIgnored() {
+    g4f_dynres_desc desc = g4f_dynres_desc_default();
+    desc.smoothing = 1.0f; // no smoothing: hysteresis alone must absorb the spikes
+    g4f_dynres d;
+    g4f_dynres_init(&d, &desc);
+
+    for (int frame = 0; frame < 500; frame++) {
+        // GPU trace right at the budget, with a 2-frame hitch every 50 frames.
+        bool hitch = (frame % 50) < 2;
+        g4f_dynres_update(&d, 3.0f, hitch ? 40.0f : 16.5f);
+    }
+    assert(d.scale == 1.0f && d.changes == 0);
+}
+
+// Vsync on: every frame is pinned at the refresh interval (CPU work, then the wait in Present),
+// so CPU + present time never drops below the budget. After a load spike the controller must
+// still see the headroom in the overlapping CPU/GPU times and climb back to full resolution.
+static void testRecoversWhenPinnedAtRefreshInterval() {
+    g4f_dynres d;
+    g4f_dynres_init(&d, nullptr);
+    float scale = 1.0f;
+    for (int frame = 0; frame < 60; frame++) scale = g4f_dynres_update(&d, 3.0f, gpuCostMs(40.0f, scale)); // spike
+    assert(scale < 0.7f);
+
+    // 3 + 13.5 ms: at full resolution the frame still fits one refresh interval.
+    for (int frame = 0; frame < 5000 && scale < 1.0f; frame++) scale = g4f_dynres_update(&d, 3.0f, gpuCostMs(13.5f, scale));
+    assert(std::fabs(scale - 1.0f) < 1e-5f);
+
+    // CPU time alone drives the controller when no GPU time is known.
+    g4f_dynres_init(&d, nullptr);
+    for (int frame = 0; frame < 10; frame++) g4f_dynres_update(&d, 30.0f, 0.0f);
+    assert(d.scale < 1.0f);
+}
+
+static void testDescSanitizedAndScaleQuantized() {
+    g4f_dynres_desc desc = g4f_dynres_desc_default();
+    desc.minScale = 2.0f; // > max -> clamped to max
+    desc.lowerFrames = 0;
+    g4f_dynres d;
+    g4f_dynres_init(&d, &desc);
+    assert(d.desc.minScale == d.desc.maxScale && d.desc.lowerFrames == 1);
+    for (int i = 0; i < 20; i++) assert(g4f_dynres_update(&d, 50.0f, 50.0f) == 1.0f);
+
+    g4f_dynres_init(&d, nullptr);
+    for (int i = 0; i < 3; i++) g4f_dynres_update(&d, 0.0f, 25.0f);
+    float steps = d.scale / d.desc.scaleStep;
+    assert(std::fabs(steps - std::round(steps)) < 1e-3f);
+    assert(d.scale < 1.0f);
+}
+
+int main() {
+    testConvergesUnderLoadAndStaysStable();
+    testRaisesSlowlyWhenLoadDrops();
+    testSpikesAndDeadbandAreIgnored();
+    testRecoversWhenPinnedAtRefreshInterval();
+    testDescSanitizedAndScaleQuantized();
+    std::printf("dynres_tests: OK\n");
+    return 0;
+}
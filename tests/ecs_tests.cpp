@@ -0,0 +1,305 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+#include "g4f/g4f_ecs.h"
+
+struct Velocity {
+    float x, y, z;
+};
+
+static bool feq(float a, float b, float eps = 1e-4f) {
+    return std::fabs(a - b) <= eps;
+}
+
+static void testEntityLifecycleAndComponents() {
+    g4f_ecs* ecs = g4f_ecs_create();
+    const Velocity still{0.0f, 0.0f, 0.0f};
+    const int velocity = g4f_ecs_register_component(ecs, "velocity", (int)sizeof(Velocity), 4, &still);
+    const int frozen = g4f_ecs_register_component(ecs, "frozen", 0, 0, nullptr); // tag
+    assert(velocity == G4F_ECS_BUILTIN_COUNT && frozen == velocity + 1);
+    assert(g4f_ecs_component_size(ecs, velocity) == (int)sizeof(Velocity));
+    assert(g4f_ecs_component_size(ecs, 63) == -1);
+
+    g4f_entity e = g4f_ecs_create_entity(ecs);
+    assert(g4f_ecs_alive(ecs, e) && g4f_ecs_entity_count(ecs) == 1);
+    assert(!g4f_ecs_has(ecs, e, G4F_ECS_TRANSFORM));
+    assert(g4f_ecs_get(ecs, e, G4F_ECS_TRANSFORM) == nullptr);
+
+    // Built-in defaults are identity, not zero.
+    assert(g4f_ecs_add(ecs, e, G4F_ECS_TRANSFORM, nullptr) == 1);
+    auto* t = static_cast<g4f_ecs_transform*>(g4f_ecs_get(ecs, e, G4F_ECS_TRANSFORM));
+    assert(t && feq(t->rotation.w, 1.0f) && feq(t->scale.y, 1.0f));
+    t->position = g4f_vec3{1.0f, 2.0f, 3.0f};
+
+    // Moving between archetypes keeps existing data.
+    const Velocity v{4.0f, 5.0f, 6.0f};
+    assert(g4f_ecs_add(ecs, e, velocity, &v) == 1);
+    assert(g4f_ecs_add(ecs, e, frozen, nullptr) == 1);
+    assert(g4f_ecs_get(ecs, e, frozen) == nullptr && g4f_ecs_has(ecs, e, frozen));
+    t = static_cast<g4f_ecs_transform*>(g4f_ecs_get(ecs, e, G4F_ECS_TRANSFORM));
+    assert(feq(t->position.z, 3.0f));
+    auto* gotV = static_cast<Velocity*>(g4f_ecs_get(ecs, e, velocity));
+    assert(feq(gotV->y, 5.0f));
+
+    // Adding an existing component overwrites it in place.
+    const Velocity v2{7.0f, 0.0f, 0.0f};
+    assert(g4f_ecs_add(ecs, e, velocity, &v2) == 1);
+    assert(feq(static_cast<Velocity*>(g4f_ecs_get(ecs, e, velocity))->x, 7.0f));
+
+    assert(g4f_ecs_remove(ecs, e, G4F_ECS_TRANSFORM) == 1);
+    assert(!g4f_ecs_has(ecs, e, G4F_ECS_TRANSFORM) && g4f_ecs_has(ecs, e, velocity));
+    assert(feq(static_cast<Velocity*>(g4f_ecs_get(ecs, e, velocity))->x, 7.0f));
+    assert(g4f_ecs_remove(ecs, e, G4F_ECS_TRANSFORM) == 1); // absent: no-op
+    assert(g4f_ecs_add(ecs, e, 40, nullptr) == 0);          // unregistered
+
+    g4f_ecs_destroy_entity(ecs, e);
+    assert(!g4f_ecs_alive(ecs, e) && g4f_ecs_entity_count(ecs) == 0);
+    assert(g4f_ecs_add(ecs, e, velocity, &v) == 0);
+    g4f_entity reused = g4f_ecs_create_entity(ecs);
+    assert(reused != e && !g4f_ecs_alive(ecs, e));
+    g4f_ecs_destroy(ecs);
+}
+
+// Swap-removal keeps every surviving entity's data attached to the right handle across chunks.
+static void testDenseRemovalAcrossChunks() {
+    g4f_ecs* ecs = g4f_ecs_create();
+    const int velocity = g4f_ecs_register_component(ecs, "velocity", (int)sizeof(Velocity), 4, nullptr);
+    const int comps[] = {G4F_ECS_TRANSFORM, velocity};
+    std::vector<g4f_entity> entities(5000);
+    assert(g4f_ecs_spawn(ecs, comps, 2, 5000, entities.data()) == 5000);
+    for (size_t i = 0; i < entities.size(); i++) {
+        auto* v = static_cast<Velocity*>(g4f_ecs_get(ecs, entities[i], velocity));
+        v->x = (float)i;
+    }
+    for (size_t i = 0; i < entities.size(); i += 3) g4f_ecs_destroy_entity(ecs, entities[i]);
+    for (size_t i = 1; i < entities.size(); i += 3) g4f_ecs_remove(ecs, entities[i], G4F_ECS_TRANSFORM);
+
+    int alive = 0;
+    for (size_t i = 0; i < entities.size(); i++) {
+        if (i % 3 == 0) {
+            assert(!g4f_ecs_alive(ecs, entities[i]));
+            continue;
+        }
+        alive++;
+        auto* v = static_cast<Velocity*>(g4f_ecs_get(ecs, entities[i], velocity));
+        assert(v && v->x == (float)i);
+        assert(g4f_ecs_has(ecs, entities[i], G4F_ECS_TRANSFORM) == (i % 3 == 2 ? 1 : 0));
+    }
+    assert(g4f_ecs_entity_count(ecs) == alive);
+
+    const int withVelocity[] = {velocity};
+    const int withoutTransform[] = {G4F_ECS_TRANSFORM};
+    g4f_ecs_query* all = g4f_ecs_query_create(ecs, withVelocity, 1, nullptr, 0);
+    g4f_ecs_query* moved = g4f_ecs_query_create(ecs, withVelocity, 1, withoutTransform, 1);
+    assert(g4f_ecs_query_entity_count(all) == alive);
+    assert(g4f_ecs_query_entity_count(moved) == 1667);
+    g4f_ecs_query_destroy(moved);
+    g4f_ecs_destroy(ecs); // destroys `all` too
+}
+
+struct SumState {
+    std::atomic<long long> sum{0};
+    std::atomic<int> entities{0};
+};
+
+static void sumVelocityX(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)workerIndex;
+    auto* state = static_cast<SumState*>(user);
+    const auto* v = static_cast<const Velocity*>(chunk->columns[0]);
+    long long local = 0;
+    for (int i = 0; i < chunk->count; i++) local += (long long)v[i].x;
+    state->sum += local;
+    state->entities += chunk->count;
+}
+
+static void testCachedQueriesSeeNewArchetypes() {
+    g4f_ecs* ecs = g4f_ecs_create();
+    const int velocity = g4f_ecs_register_component(ecs, "velocity", (int)sizeof(Velocity), 4, nullptr);
+    const int tag = g4f_ecs_register_component(ecs, "tag", 0, 0, nullptr);
+    const int withVelocity[] = {velocity};
+    g4f_ecs_query* q = g4f_ecs_query_create(ecs, withVelocity, 1, nullptr, 0);
+    assert(g4f_ecs_query_entity_count(q) == 0);
+
+    std::vector<g4f_entity> entities(300);
+    const int a[] = {velocity};
+    const int b[] = {velocity, tag};
+    g4f_ecs_spawn(ecs, a, 1, 200, entities.data());
+    g4f_ecs_spawn(ecs, b, 2, 100, entities.data() + 200); // new archetype after the query exists
+    for (size_t i = 0; i < entities.size(); i++) static_cast<Velocity*>(g4f_ecs_get(ecs, entities[i], velocity))->x = 1.0f;
+
+    SumState state;
+    g4f_ecs_query_each(q, sumVelocityX, &state);
+    assert(state.sum == 300 && state.entities == 300);
+
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    SumState threaded;
+    g4f_ecs_query_run(q, jobs, sumVelocityX, &threaded);
+    assert(threaded.sum == 300);
+    g4f_jobs_destroy(jobs);
+
+    const int bad[] = {55};
+    assert(g4f_ecs_query_create(ecs, bad, 1, nullptr, 0) == nullptr);
+    g4f_ecs_destroy(ecs);
+}
+
+struct Integrate {
+    float dt;
+};
+
+static void integrateSystem(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)workerIndex;
+    const float dt = static_cast<Integrate*>(user)->dt;
+    auto* t = static_cast<g4f_ecs_transform*>(chunk->columns[0]);
+    const auto* v = static_cast<const Velocity*>(chunk->columns[1]);
+    for (int i = 0; i < chunk->count; i++) {
+        t[i].position.x += v[i].x * dt;
+        t[i].position.y += v[i].y * dt;
+        t[i].position.z += v[i].z * dt;
+    }
+}
+
+static void dampSystem(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)user;
+    (void)workerIndex;
+    auto* v = static_cast<Velocity*>(chunk->columns[0]);
+    for (int i = 0; i < chunk->count; i++) v[i].x *= 0.5f;
+}
+
+static void countSystem(void* user, const g4f_ecs_chunk* chunk, int workerIndex) {
+    (void)workerIndex;
+    *static_cast<std::atomic<int>*>(user) += chunk->count;
+}
+
+static void testSystemBatchingAndTransforms() {
+    g4f_ecs* ecs = g4f_ecs_create();
+    const int velocity = g4f_ecs_register_component(ecs, "velocity", (int)sizeof(Velocity), 4, nullptr);
+    const int comps[] = {G4F_ECS_TRANSFORM, G4F_ECS_WORLD, velocity};
+    std::vector<g4f_entity> entities(2000);
+    g4f_ecs_spawn(ecs, comps, 3, 2000, entities.data());
+    for (g4f_entity e : entities) *static_cast<Velocity*>(g4f_ecs_get(ecs, e, velocity)) = Velocity{2.0f, 0.0f, -1.0f};
+
+    const int moveIds[] = {G4F_ECS_TRANSFORM, velocity};
+    const int dampIds[] = {velocity};
+    const int countIds[] = {G4F_ECS_WORLD};
+    g4f_ecs_query* moveQuery = g4f_ecs_query_create(ecs, moveIds, 2, nullptr, 0);
+    g4f_ecs_query* dampQuery = g4f_ecs_query_create(ecs, dampIds, 1, nullptr, 0);
+    g4f_ecs_query* countQuery = g4f_ecs_query_create(ecs, countIds, 1, nullptr, 0);
+
+    Integrate integrate{0.5f};
+    std::atomic<int> counted{0};
+    g4f_ecs_system systems[3] = {
+        {"integrate", moveQuery, G4F_ECS_BIT(G4F_ECS_TRANSFORM), integrateSystem, &integrate},
+        {"count", countQuery, 0, countSystem, &counted},  // no conflict: joins the first batch
+        {"damp", dampQuery, G4F_ECS_BIT(velocity), dampSystem, nullptr}, // integrate reads velocity
+    };
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    assert(g4f_ecs_run_systems(ecs, systems, 3, jobs) == 2);
+    assert(counted == 2000);
+    assert(g4f_ecs_run_systems(ecs, systems, 3, nullptr) == 2);
+
+    // Damping ran after integrating each time: x = 2 * 0.5 + 1 * 0.5.
+    const auto* t = static_cast<const g4f_ecs_transform*>(g4f_ecs_get(ecs, entities[1234], G4F_ECS_TRANSFORM));
+    assert(feq(t->position.x, 1.5f) && feq(t->position.z, -1.0f));
+
+    g4f_ecs_update_transforms(ecs, jobs);
+    const auto* world = static_cast<const g4f_mat4*>(g4f_ecs_get(ecs, entities[1234], G4F_ECS_WORLD));
+    assert(feq(world->m[12], 1.5f) && feq(world->m[14], -1.0f) && feq(world->m[0], 1.0f));
+
+    g4f_ecs_system invalid = {"bad", nullptr, 0, countSystem, nullptr};
+    assert(g4f_ecs_run_systems(ecs, &invalid, 1, nullptr) == -1);
+    assert(g4f_ecs_run_systems(ecs, nullptr, 0, nullptr) == 0);
+    g4f_jobs_destroy(jobs);
+    g4f_ecs_destroy(ecs);
+}
+
+static void testDrawListFromRenderables() {
+    static int meshStorage[2], materialStorage[2];
+    const auto* meshA = reinterpret_cast<const g4f_gfx_mesh*>(&meshStorage[0]);
+    const auto* meshB = reinterpret_cast<const g4f_gfx_mesh*>(&meshStorage[1]);
+    const auto* matA = reinterpret_cast<const g4f_gfx_material*>(&materialStorage[0]);
+    const auto* matB = reinterpret_cast<const g4f_gfx_material*>(&materialStorage[1]);
+
+    g4f_ecs* ecs = g4f_ecs_create();
+    const int comps[] = {G4F_ECS_TRANSFORM, G4F_ECS_WORLD, G4F_ECS_RENDERABLE};
+    std::vector<g4f_entity> entities(10);
+    g4f_ecs_spawn(ecs, comps, 3, 10, entities.data());
+    for (int i = 0; i < 10; i++) {
+        auto* t = static_cast<g4f_ecs_transform*>(g4f_ecs_get(ecs, entities[(size_t)i], G4F_ECS_TRANSFORM));
+        t->position = g4f_vec3{(float)i, 0.0f, 0.0f};
+        auto* r = static_cast<g4f_ecs_renderable*>(g4f_ecs_get(ecs, entities[(size_t)i], G4F_ECS_RENDERABLE));
+        if (i == 9) continue; // no mesh: not drawn
+        r->mesh = (i % 2) ? meshA : meshB;
+        r->material = (i % 3) ? matA : matB;
+    }
+    g4f_ecs_update_transforms(ecs, nullptr);
+
+    const g4f_mat4 viewProj = g4f_mat4_perspective(1.0f, 1.0f, 0.1f, 100.0f);
+    assert(g4f_ecs_build_draws(ecs, &viewProj, nullptr) == 9);
+    int count = 0;
+    const g4f_ecs_draw* draws = g4f_ecs_draws(ecs, &count);
+    assert(count == 9);
+    int switches = 0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && draws[i].material != draws[i - 1].material) switches++;
+        const auto* t = static_cast<const g4f_ecs_transform*>(g4f_ecs_get(ecs, draws[i].entity, G4F_ECS_TRANSFORM));
+        assert(feq(draws[i].model.m[12], t->position.x));
+        g4f_mat4 expected = g4f_mat4_mul(draws[i].model, viewProj);
+        for (int k = 0; k < 16; k++) assert(feq(draws[i].mvp.m[k], expected.m[k]));
+    }
+    assert(switches == 1);
+    assert(g4f_ecs_build_draws(ecs, nullptr, nullptr) == 0);
+    g4f_ecs_destroy(ecs);
+}
+
+// Recycling one slot must never hand out an old handle again: with a single entity alive at a
+// time every create reuses the same slot until its generations run out.
+static void testStaleHandlesStayInvalid() {
+    g4f_ecs* ecs = g4f_ecs_create();
+    const g4f_entity first = g4f_ecs_create_entity(ecs);
+    g4f_entity e = first;
+    bool slotRetired = false;
+    for (int i = 0; i < 3000; i++) {
+        g4f_ecs_destroy_entity(ecs, e);
+        e = g4f_ecs_create_entity(ecs);
+        assert(e != G4F_ENTITY_NULL && e != first && g4f_ecs_alive(ecs, e));
+        assert(!g4f_ecs_alive(ecs, first));
+        slotRetired = slotRetired || (e & 0x3FFFFFu) != (first & 0x3FFFFFu);
+    }
+    assert(slotRetired && g4f_ecs_entity_count(ecs) == 1);
+    g4f_ecs_destroy(ecs);
+}
+
+static void testNullHandles() {
+    g4f_ecs_destroy(nullptr);
+    assert(g4f_ecs_register_component(nullptr, "x", 4, 4, nullptr) == -1);
+    assert(g4f_ecs_spawn(nullptr, nullptr, 0, 1, nullptr) == 0);
+    assert(g4f_ecs_create_entity(nullptr) == G4F_ENTITY_NULL);
+    assert(g4f_ecs_alive(nullptr, 1) == 0);
+    assert(g4f_ecs_entity_count(nullptr) == 0);
+    assert(g4f_ecs_query_create(nullptr, nullptr, 0, nullptr, 0) == nullptr);
+    assert(g4f_ecs_query_entity_count(nullptr) == 0);
+    g4f_ecs_query_each(nullptr, sumVelocityX, nullptr);
+    g4f_ecs_update_transforms(nullptr, nullptr);
+    g4f_ecs* ecs = g4f_ecs_create();
+    assert(g4f_ecs_register_component(ecs, "bad align", 4, 3, nullptr) == -1);
+    assert(g4f_ecs_get(ecs, 12345u, G4F_ECS_TRANSFORM) == nullptr);
+    g4f_ecs_destroy_entity(ecs, 12345u);
+    g4f_ecs_destroy(ecs);
+}
+
+int main() {
+    testEntityLifecycleAndComponents();
+    testDenseRemovalAcrossChunks();
+    testCachedQueriesSeeNewArchetypes();
+    testSystemBatchingAndTransforms();
+    testDrawListFromRenderables();
+    testStaleHandlesStayInvalid();
+    testNullHandles();
+    std::printf("ecs_tests: OK\n");
+    return 0;
+}
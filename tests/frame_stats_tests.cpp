@@ -0,0 +1,107 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "g4f/g4f_frame_stats.h"
+
+static g4f_gfx_frame_stats sampleFrame() {
+    g4f_gfx_frame_stats s;
+    g4f_gfx_frame_stats_reset(&s);
+    s.frameIndex = 7;
+    s.drawCalls = 120;
+    s.triangles = 50000;
+    s.stateChanges[G4F_GFX_STATE_SHADER] = 4;
+    s.stateChanges[G4F_GFX_STATE_TEXTURE] = 30;
+    s.stateChanges[G4F_GFX_STATE_CONSTANT_BUFFER] = 6;
+    s.redundantAvoided[G4F_GFX_STATE_SHADER] = 116;
+    s.redundantAvoided[G4F_GFX_STATE_TEXTURE] = 90;
+    s.constantBytes = 120 * 256;
+    s.bufferBytes = 4096;
+    s.textureBytes = 65536;
+    s.resourcesCreated = 3;
+    return s;
+}
+
+static void testTotals() {
+    g4f_gfx_frame_stats s = sampleFrame();
+    assert(g4f_gfx_frame_stats_state_changes(&s) == 40);
+    assert(g4f_gfx_frame_stats_redundant_avoided(&s) == 206);
+    assert(g4f_gfx_frame_stats_upload_bytes(&s) == 120 * 256 + 4096 + 65536);
+
+    g4f_gfx_frame_stats_reset(&s);
+    assert(s.drawCalls == 0 && s.triangles == 0 && s.frameIndex == 0);
+    assert(g4f_gfx_frame_stats_state_changes(&s) == 0);
+    assert(g4f_gfx_frame_stats_upload_bytes(&s) == 0);
+}
+
+static void testAccumulate() {
+    g4f_gfx_frame_stats sum;
+    g4f_gfx_frame_stats_reset(&sum);
+    g4f_gfx_frame_stats frame = sampleFrame();
+    for (int i = 0; i < 3; i++) {
+        frame.frameIndex = (uint64_t)(10 + i);
+        g4f_gfx_frame_stats_add(&sum, &frame);
+    }
+    assert(sum.frameIndex == 12);
+    assert(sum.drawCalls == 360 && sum.triangles == 150000);
+    assert(sum.stateChanges[G4F_GFX_STATE_TEXTURE] == 90);
+    assert(sum.redundantAvoided[G4F_GFX_STATE_SHADER] == 348);
+    assert(g4f_gfx_frame_stats_upload_bytes(&sum) == 3 * g4f_gfx_frame_stats_upload_bytes(&frame));
+    assert(sum.resourcesCreated == 9);
+}
+
+static void testBudgets() {
+    const g4f_gfx_frame_stats s = sampleFrame();
+    char msg[256];
+
+    g4f_gfx_frame_budget budget = g4f_gfx_frame_budget_default();
+    assert(budget.maxDrawCalls < 0 && budget.maxTriangles < 0 && budget.maxStateChanges < 0);
+    assert(budget.maxUploadBytes < 0 && budget.maxResourcesCreated < 0);
+    std::strcpy(msg, "stale");
+    assert(g4f_gfx_frame_stats_check(&s, &budget, msg, (int)sizeof(msg)) == 1);
+    assert(msg[0] == '\0');
+
+    // Limits are inclusive.
+    budget.maxDrawCalls = 120;
+    budget.maxTriangles = 50000;
+    budget.maxStateChanges = 40;
+    budget.maxResourcesCreated = 3;
+    assert(g4f_gfx_frame_stats_check(&s, &budget, msg, (int)sizeof(msg)) == 1);
+
+    budget.maxDrawCalls = 100;
+    assert(g4f_gfx_frame_stats_check(&s, &budget, msg, (int)sizeof(msg)) == 0);
+    assert(std::strcmp(msg, "drawCalls 120 > 100") == 0);
+
+    budget.maxUploadBytes = 1024;
+    budget.maxResourcesCreated = 0;
+    assert(g4f_gfx_frame_stats_check(&s, &budget, msg, (int)sizeof(msg)) == 0);
+    assert(std::strcmp(msg, "drawCalls 120 > 100; uploadBytes 100352 > 1024; resourcesCreated 3 > 0") == 0);
+
+    // Truncated message stays terminated; no message buffer is fine too.
+    char small[12];
+    assert(g4f_gfx_frame_stats_check(&s, &budget, small, (int)sizeof(small)) == 0);
+    assert(std::strlen(small) == sizeof(small) - 1);
+    assert(std::strncmp(small, "drawCalls 1", sizeof(small) - 1) == 0);
+    assert(g4f_gfx_frame_stats_check(&s, &budget, nullptr, 0) == 0);
+}
+
+static void testNullHandles() {
+    g4f_gfx_frame_stats s = sampleFrame();
+    g4f_gfx_frame_stats_reset(nullptr);
+    g4f_gfx_frame_stats_add(nullptr, &s);
+    g4f_gfx_frame_stats_add(&s, nullptr);
+    assert(s.drawCalls == 120);
+    assert(g4f_gfx_frame_stats_state_changes(nullptr) == 0);
+    assert(g4f_gfx_frame_stats_redundant_avoided(nullptr) == 0);
+    assert(g4f_gfx_frame_stats_upload_bytes(nullptr) == 0);
+    assert(g4f_gfx_frame_stats_check(nullptr, nullptr, nullptr, 0) == 1);
+}
+
+int main() {
+    testTotals();
+    testAccumulate();
+    testBudgets();
+    testNullHandles();
+    std::printf("frame_stats_tests: OK\n");
+    return 0;
+}
@@ -4,6 +4,10 @@
 
 #include "g4f/g4f.h"
 #include "g4f/g4f_camera.h"
+#include "g4f/g4f_frame_stats.h"
+#include "g4f/g4f_gpu_timings.h"
+#include "g4f/g4f_light_clusters.h"
+#include "g4f/g4f_scene.h"
 
 static void fillChecker(std::vector<uint32_t>& out, int w, int h, int cell) {
     out.resize((size_t)w * (size_t)h);
@@ -44,6 +48,20 @@ int main() {
     fillChecker(checker, texW, texH, 4);
     int ok = g4f_gfx_texture_update_rgba8(dyn, checker.data(), texW * 4);
     assert(ok == 1);
+    assert(g4f_gfx_texture_update_region_rgba8(dyn, 0, 0, 4, 4, checker.data(), texW * 4) == 0);
+
+    g4f_gfx_texture* streaming = g4f_gfx_texture_create_rgba8_streaming(gfx, texW, texH);
+    assert(streaming != nullptr);
+    assert(g4f_gfx_texture_update_region_rgba8(streaming, 4, 4, 8, 8, checker.data(), texW * 4) == 1);
+    assert(g4f_gfx_texture_update_region_rgba8(streaming, 28, 28, 8, 8, checker.data(), texW * 4) == 0);
+    assert(g4f_gfx_texture_flush(streaming) == 1);
+
+    g4f_gfx_target* target = g4f_gfx_target_create(gfx, 64, 48, G4F_GFX_FORMAT_RGBA8, 1);
+    assert(target != nullptr);
+    g4f_gfx_texture* targetTex = g4f_gfx_target_texture(target);
+    int targetW = 0, targetH = 0;
+    g4f_gfx_texture_get_size(targetTex, &targetW, &targetH);
+    assert(targetW == 64 && targetH == 48);
 
     g4f_gfx_material_unlit_desc mdesc{};
     mdesc.tintRgba = g4f_rgba_u32(255, 255, 255, 255);
@@ -56,10 +74,62 @@ int main() {
     g4f_gfx_material* lit = g4f_gfx_material_create_lit(gfx, &mdesc);
     assert(unlit && lit);
 
+    // Equal state shares a bundle; any state change moves to another one and back.
+    g4f_gfx_material* unlit2 = g4f_gfx_material_create_unlit(gfx, &mdesc);
+    assert(g4f_gfx_material_bundle_id(unlit2) == g4f_gfx_material_bundle_id(unlit));
+    assert(g4f_gfx_material_bundle_id(lit) != g4f_gfx_material_bundle_id(unlit));
+    g4f_gfx_material_set_alpha_test(unlit2, 1);
+    assert(g4f_gfx_material_bundle_id(unlit2) != g4f_gfx_material_bundle_id(unlit));
+    g4f_gfx_material_set_alpha_test(unlit2, 0);
+    assert(g4f_gfx_material_bundle_id(unlit2) == g4f_gfx_material_bundle_id(unlit));
+    g4f_gfx_material_destroy(unlit2);
+
+    // Clustered lights only apply to lit materials; unlit ones keep their bundle.
+    g4f_gfx_material_unlit_desc clusteredDesc = mdesc;
+    clusteredDesc.clusteredLights = 1;
+    g4f_gfx_material* clustered = g4f_gfx_material_create_lit(gfx, &clusteredDesc);
+    g4f_gfx_material* clusteredUnlit = g4f_gfx_material_create_unlit(gfx, &clusteredDesc);
+    assert(clustered && clusteredUnlit);
+    assert(g4f_gfx_material_bundle_id(clustered) != g4f_gfx_material_bundle_id(lit));
+    assert(g4f_gfx_material_bundle_id(clusteredUnlit) == g4f_gfx_material_bundle_id(unlit));
+    g4f_gfx_material_destroy(clusteredUnlit);
+
+    g4f_light lights[2]{};
+    lights[0].position = g4f_vec3{0.0f, 0.5f, -1.0f};
+    lights[0].radius = 3.0f;
+    lights[0].colorRgba = g4f_rgba_u32(255, 80, 40, 255);
+    lights[0].intensity = 1.0f;
+    lights[1] = lights[0];
+    lights[1].type = G4F_LIGHT_SPOT;
+    lights[1].position = g4f_vec3{0.0f, 2.0f, 0.0f};
+    lights[1].direction = g4f_vec3{0.0f, -1.0f, 0.0f};
+    lights[1].spotOuterCos = 0.8f;
+    lights[1].spotInnerCos = 0.9f;
+    g4f_light_clusters* lightClusters = g4f_light_clusters_create(nullptr);
+    assert(lightClusters);
+    assert(g4f_gfx_set_light_clusters(gfx, lights, 2, nullptr) == 0);
+    assert(g4f_gfx_set_light_clusters(gfx, nullptr, 0, nullptr) == 1); // clearing is always fine
+
+    g4f_shadow_cascade cascades[2]{};
+    assert(g4f_gfx_set_shadow_cascades(gfx, cascades, 2) == 0); // no shadow map yet
+    g4f_gfx_shadow_desc shadowDesc = g4f_gfx_shadow_desc_default();
+    shadowDesc.size = 512;
+    shadowDesc.cascadeCount = 2;
+    assert(g4f_gfx_shadow_configure(gfx, &shadowDesc) == 1);
+
     g4f_gfx_mesh* cube = g4f_gfx_mesh_create_cube_p3n3uv2(gfx, 1.0f);
     g4f_gfx_mesh* plane = g4f_gfx_mesh_create_plane_xz_p3n3uv2(gfx, 3.0f, 2.0f);
     assert(cube && plane);
 
+    // Two small cubes orbiting a pivot, drawn through the scene's bulk path.
+    g4f_scene* scene = g4f_scene_create(0);
+    g4f_scene_node pivot = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+    for (int i = 0; i < 2; i++) {
+        g4f_scene_node orbiter = g4f_scene_node_create(scene, pivot);
+        g4f_scene_set_local(scene, orbiter, g4f_vec3{i ? 2.0f : -2.0f, 1.0f, 0.0f}, g4f_quat_identity(), g4f_vec3{0.3f, 0.3f, 0.3f});
+        g4f_scene_set_renderable(scene, orbiter, cube, lit);
+    }
+
     g4f_camera_fps cam = g4f_camera_fps_default();
     cam.position = g4f_vec3{0.0f, 1.2f, -4.5f};
 
@@ -85,17 +155,81 @@ int main() {
         g4f_mat4 model = g4f_mat4_mul(g4f_mat4_rotation_y(t), g4f_mat4_rotation_x(t * 0.7f));
         g4f_mat4 mvp = g4f_mat4_mul(g4f_mat4_mul(model, view), proj);
 
+        assert(g4f_gfx_pass_begin(gfx, target, G4F_GFX_PASS_CLEAR_COLOR | G4F_GFX_PASS_CLEAR_DEPTH, g4f_rgba_u32(0, 0, 0, 255)) == 1);
+        assert(g4f_gfx_pass_begin(gfx, target, 0, 0) == 0); // already open
+        int passW = 0, passH = 0;
+        g4f_gfx_pass_get_size(gfx, &passW, &passH);
+        assert(passW == 64 && passH == 48);
+        g4f_gfx_draw_mesh_xform(gfx, cube, lit, &model, &mvp);
+        g4f_gfx_pass_end(gfx);
+        g4f_gfx_pass_get_size(gfx, &passW, &passH);
+        assert(passW == w && passH == h);
+
+        g4f_gfx_material_set_texture(unlit, targetTex);
         g4f_gfx_draw_mesh_xform(gfx, cube, lit, &model, &mvp);
+        g4f_gfx_texture_update_region_rgba8(streaming, frames % texW, 0, 1, texH, checker.data(), texW * 4);
         g4f_gfx_draw_mesh(gfx, plane, unlit, &mvp);
+        assert(g4f_light_clusters_build(lightClusters, lights, 2, &view, &proj, nullptr) == 1);
+        assert(g4f_gfx_set_light_clusters(gfx, lights, 2, lightClusters) == 1);
+        g4f_gfx_draw_mesh(gfx, plane, clustered, &mvp);
+
+        float splits[3];
+        g4f_shadow_cascade_splits(0.1f, 30.0f, 2, 0.7f, splits);
+        assert(g4f_shadow_cascades_fit(&view, &proj, g4f_vec3{-0.3f, -1.0f, -0.2f}, splits, 2, shadowDesc.size, 10.0f, cascades) == 1);
+        for (int c = 0; c < 2; c++) {
+            assert(g4f_gfx_shadow_pass_begin(gfx, c, &cascades[c]) == 1);
+            g4f_gfx_draw_shadow_caster(gfx, cube, &model);
+            g4f_gfx_shadow_pass_end(gfx);
+        }
+        assert(g4f_gfx_shadow_pass_begin(gfx, 2, &cascades[0]) == 0);
+        assert(g4f_gfx_set_shadow_cascades(gfx, cascades, 2) == 1);
+        g4f_gfx_gpu_scope_begin(gfx, "main");
+        g4f_gfx_draw_mesh(gfx, plane, lit, &mvp);
+        g4f_scene_set_rotation(scene, pivot, g4f_quat_from_axis_angle(g4f_vec3{0.0f, 1.0f, 0.0f}, t));
+        const g4f_mat4 viewProj = g4f_mat4_mul(view, proj);
+        assert(g4f_gfx_draw_scene(gfx, scene, &viewProj, nullptr) == 2);
         g4f_gfx_draw_debug_cube(gfx, t);
+        g4f_gfx_gpu_scope_end(gfx);
 
         g4f_frame3d_end(ctx);
     }
 
+    // Timings lag a few frames; once resolved they carry the pass scopes.
+    const g4f_gpu_timings* timings = g4f_gfx_gpu_timings(gfx);
+    assert(timings != nullptr);
+    if (timings->source != G4F_GPU_TIMINGS_NONE) {
+        assert(timings->frameMs >= 0.0f);
+        assert(g4f_gpu_timings_find_ms(timings, "offscreen pass") >= 0.0f);
+        assert(g4f_gpu_timings_find_ms(timings, "shadow cascade 1") >= 0.0f);
+        assert(g4f_gpu_timings_find_ms(timings, "main") >= 0.0f);
+    }
+
+    // Last frame: 10 mesh draws (offscreen, 3 main, 2 shadow casters, lit plane, 2 scene cubes, debug cube).
+    g4f_gfx_frame_stats stats{};
+    g4f_gfx_get_frame_stats(gfx, &stats);
+    assert(stats.drawCalls >= 10 && stats.triangles > 0);
+    assert(g4f_gfx_frame_stats_state_changes(&stats) > 0);
+    assert(g4f_gfx_frame_stats_redundant_avoided(&stats) > 0); // repeated mesh/material binds
+    assert(stats.constantBytes > 0 && stats.textureBytes > 0); // per-draw constants + streaming column
+    g4f_gfx_frame_budget budget = g4f_gfx_frame_budget_default();
+    budget.maxDrawCalls = 64;
+    budget.maxResourcesCreated = 0; // nothing created mid-run
+    char budgetMsg[128];
+    if (!g4f_gfx_frame_stats_check(&stats, &budget, budgetMsg, (int)sizeof(budgetMsg))) {
+        std::fprintf(stderr, "gfx_api_smoke_tests: frame budget: %s\n", budgetMsg);
+        return 1;
+    }
+
     g4f_gfx_mesh_destroy(plane);
     g4f_gfx_mesh_destroy(cube);
+    assert(g4f_gfx_shadow_configure(gfx, nullptr) == 1);
+    g4f_scene_destroy(scene);
+    g4f_light_clusters_destroy(lightClusters);
+    g4f_gfx_material_destroy(clustered);
     g4f_gfx_material_destroy(lit);
     g4f_gfx_material_destroy(unlit);
+    g4f_gfx_target_destroy(target);
+    g4f_gfx_texture_destroy(streaming);
     g4f_gfx_texture_destroy(dyn);
     g4f_ctx3d_destroy(ctx);
 
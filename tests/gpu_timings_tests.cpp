@@ -0,0 +1,192 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+
+#include "g4f/g4f_gpu_timings.h"
+
+// Fake GPU: every mark advances a tick clock by 1000 ticks (1 ms at 1 MHz); a slot's data
+// becomes available `latency` frames after it was submitted.
+struct FakeGpu {
+    int latency = 2;
+    int frame = 0;
+    int submittedAt[G4F_GPU_TIMER_RING] = {};
+    uint64_t ticks[G4F_GPU_TIMER_RING][G4F_GPU_TIMER_MAX_MARKS] = {};
+    uint64_t clock = 0;
+    int disjointSlot = -1;
+};
+
+static void fakeMark(void* user, int slot, int mark) {
+    auto* gpu = static_cast<FakeGpu*>(user);
+    gpu->clock += 1000;
+    gpu->ticks[slot][mark] = gpu->clock;
+}
+
+static void fakeFrameEnd(void* user, int slot) {
+    auto* gpu = static_cast<FakeGpu*>(user);
+    gpu->submittedAt[slot] = gpu->frame;
+}
+
+static int fakeResolve(void* user, int slot, int markCount, uint64_t* ticks, uint64_t* ticksPerSecond) {
+    auto* gpu = static_cast<FakeGpu*>(user);
+    if (gpu->frame - gpu->submittedAt[slot] < gpu->latency) return 0;
+    if (slot == gpu->disjointSlot) return -1;
+    std::memcpy(ticks, gpu->ticks[slot], sizeof(uint64_t) * (size_t)markCount);
+    *ticksPerSecond = 1000000;
+    return 1;
+}
+
+static g4f_gpu_timer_backend fakeBackend(FakeGpu* gpu) {
+    g4f_gpu_timer_backend b{};
+    b.user = gpu;
+    b.mark = fakeMark;
+    b.frame_end = fakeFrameEnd;
+    b.resolve = fakeResolve;
+    return b;
+}
+
+static void runFrame(g4f_gpu_timer* timer, FakeGpu* gpu) {
+    g4f_gpu_timer_frame_begin(timer);
+    g4f_gpu_timer_scope_begin(timer, "shadows");
+    g4f_gpu_timer_scope_begin(timer, "cascade 0");
+    g4f_gpu_timer_scope_end(timer);
+    g4f_gpu_timer_scope_end(timer);
+    g4f_gpu_timer_scope_begin(timer, "main");
+    g4f_gpu_timer_scope_end(timer);
+    g4f_gpu_timer_frame_end(timer);
+    gpu->frame++;
+}
+
+static void testResultsLagAndNestedScopes() {
+    FakeGpu gpu;
+    g4f_gpu_timer_backend backend = fakeBackend(&gpu);
+    g4f_gpu_timer* timer = g4f_gpu_timer_create(&backend, G4F_GPU_TIMINGS_GPU);
+    const g4f_gpu_timings* t = g4f_gpu_timer_results(timer);
+    assert(t->source == G4F_GPU_TIMINGS_NONE);
+
+    runFrame(timer, &gpu);
+    runFrame(timer, &gpu);
+    assert(t->source == G4F_GPU_TIMINGS_NONE); // still in flight, nothing waited for
+
+    runFrame(timer, &gpu); // frame 0 becomes readable at the start of frame 2
+    assert(t->source == G4F_GPU_TIMINGS_GPU);
+    assert(t->frameIndex == 0);
+    assert(t->scopeCount == 3);
+    assert(std::strcmp(t->scopes[0].name, "shadows") == 0 && t->scopes[0].depth == 0 && t->scopes[0].parent == -1);
+    assert(std::strcmp(t->scopes[1].name, "cascade 0") == 0 && t->scopes[1].depth == 1 && t->scopes[1].parent == 0);
+    assert(std::strcmp(t->scopes[2].name, "main") == 0 && t->scopes[2].depth == 0 && t->scopes[2].parent == -1);
+
+    // Marks: frame 0, shadows 1, cascade 2/3, shadows 4, main 5/6, frame 7 (1 ms apart).
+    assert(std::fabs(t->frameMs - 7.0f) < 1e-4f);
+    assert(std::fabs(g4f_gpu_timings_find_ms(t, "shadows") - 3.0f) < 1e-4f);
+    assert(std::fabs(g4f_gpu_timings_find_ms(t, "cascade 0") - 1.0f) < 1e-4f);
+    assert(std::fabs(g4f_gpu_timings_find_ms(t, "main") - 1.0f) < 1e-4f);
+    assert(g4f_gpu_timings_find_ms(t, "missing") == -1.0f);
+
+    for (int i = 0; i < 20; i++) runFrame(timer, &gpu);
+    assert(t->frameIndex == 20); // steady state: results lag by the GPU latency
+    assert(t->skippedFrames == 0 && t->invalidFrames == 0);
+    g4f_gpu_timer_destroy(timer);
+}
+
+static void testFullRingSkipsInsteadOfStalling() {
+    FakeGpu gpu;
+    gpu.latency = G4F_GPU_TIMER_RING + 2; // slower than the ring is deep
+    g4f_gpu_timer_backend backend = fakeBackend(&gpu);
+    g4f_gpu_timer* timer = g4f_gpu_timer_create(&backend, G4F_GPU_TIMINGS_GPU);
+    const g4f_gpu_timings* t = g4f_gpu_timer_results(timer);
+
+    for (int i = 0; i < G4F_GPU_TIMER_RING; i++) runFrame(timer, &gpu);
+    assert(t->source == G4F_GPU_TIMINGS_NONE);
+    runFrame(timer, &gpu); // slot 0 still in flight
+    assert(t->skippedFrames == 1);
+
+    for (int i = 0; i < 40; i++) runFrame(timer, &gpu);
+    assert(t->source == G4F_GPU_TIMINGS_GPU);
+    assert(t->skippedFrames > 0);
+    assert(std::fabs(t->frameMs - 7.0f) < 1e-4f); // skipped frames never corrupt measured ones
+    g4f_gpu_timer_destroy(timer);
+}
+
+static void testDisjointFramesAreDiscarded() {
+    FakeGpu gpu;
+    gpu.latency = 1;
+    gpu.disjointSlot = 1;
+    g4f_gpu_timer_backend backend = fakeBackend(&gpu);
+    g4f_gpu_timer* timer = g4f_gpu_timer_create(&backend, G4F_GPU_TIMINGS_GPU);
+    const g4f_gpu_timings* t = g4f_gpu_timer_results(timer);
+
+    for (int i = 0; i < 3; i++) runFrame(timer, &gpu);
+    assert(t->frameIndex == 0 && t->invalidFrames == 1); // frame 1 dropped, frame 0 kept
+    runFrame(timer, &gpu);
+    assert(t->frameIndex == 2);
+    g4f_gpu_timer_destroy(timer);
+}
+
+static void testScopeOverflowAndUnbalancedScopes() {
+    FakeGpu gpu;
+    gpu.latency = 0;
+    g4f_gpu_timer_backend backend = fakeBackend(&gpu);
+    g4f_gpu_timer* timer = g4f_gpu_timer_create(&backend, G4F_GPU_TIMINGS_GPU);
+    const g4f_gpu_timings* t = g4f_gpu_timer_results(timer);
+
+    g4f_gpu_timer_frame_begin(timer);
+    g4f_gpu_timer_scope_begin(timer, "outer");
+    for (int i = 0; i < G4F_GPU_TIMER_MAX_SCOPES + 8; i++) {
+        g4f_gpu_timer_scope_begin(timer, "a scope name well over the thirty-one character limit");
+        g4f_gpu_timer_scope_end(timer);
+    }
+    g4f_gpu_timer_scope_begin(timer, "left open"); // dropped: over the limit
+    g4f_gpu_timer_frame_end(timer);                // closes "outer"
+    gpu.frame++;
+
+    assert(t->scopeCount == G4F_GPU_TIMER_MAX_SCOPES);
+    assert(t->droppedScopes == 10);
+    assert(std::strlen(t->scopes[1].name) == G4F_GPU_TIMER_NAME_MAX - 1);
+    assert(t->scopes[1].parent == 0 && t->scopes[1].depth == 1);
+    assert(std::fabs(t->scopes[0].ms - (float)(2 * (G4F_GPU_TIMER_MAX_SCOPES - 1) + 1)) < 1e-3f);
+
+    // Extra scope_end calls and scopes outside a frame are ignored.
+    g4f_gpu_timer_scope_end(timer);
+    g4f_gpu_timer_scope_begin(timer, "outside");
+    g4f_gpu_timer_frame_begin(timer);
+    g4f_gpu_timer_scope_end(timer);
+    g4f_gpu_timer_frame_end(timer);
+    assert(t->scopeCount == 0 && t->droppedScopes == 0);
+    g4f_gpu_timer_destroy(timer);
+}
+
+static void testCpuClockBackend() {
+    g4f_gpu_timer* timer = g4f_gpu_timer_create(nullptr, G4F_GPU_TIMINGS_GPU);
+    const g4f_gpu_timings* t = g4f_gpu_timer_results(timer);
+    g4f_gpu_timer_frame_begin(timer);
+    g4f_gpu_timer_scope_begin(timer, "work");
+    volatile double sink = 0.0;
+    for (int i = 0; i < 200000; i++) sink = sink + std::sqrt((double)i);
+    g4f_gpu_timer_scope_end(timer);
+    g4f_gpu_timer_frame_end(timer);
+
+    assert(t->source == G4F_GPU_TIMINGS_CPU); // resolved immediately, tagged as CPU
+    assert(t->frameIndex == 0);
+    const float workMs = g4f_gpu_timings_find_ms(t, "work");
+    assert(workMs >= 0.0f && workMs <= t->frameMs);
+    g4f_gpu_timer_destroy(timer);
+
+    // Null handles are harmless.
+    g4f_gpu_timer_frame_begin(nullptr);
+    g4f_gpu_timer_scope_begin(nullptr, "x");
+    g4f_gpu_timer_scope_end(nullptr);
+    g4f_gpu_timer_frame_end(nullptr);
+    assert(g4f_gpu_timer_results(nullptr) == nullptr);
+    assert(g4f_gpu_timings_find_ms(nullptr, "x") == -1.0f);
+}
+
+int main() {
+    testResultsLagAndNestedScopes();
+    testFullRingSkipsInsteadOfStalling();
+    testDisjointFramesAreDiscarded();
+    testScopeOverflowAndUnbalancedScopes();
+    testCpuClockBackend();
+    std::printf("gpu_timings_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,462 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "g4f/g4f_image.h"
+
+// 16x16 RGB, r = x * 16, g = y * 16, b = (x + y) * 8, compressed by zlib level 9 (dynamic Huffman).
+static const uint8_t kPngDynamic[] = {
+    0x89, 0x50, 0x4E, 0x47, 0x0D, 0x0A, 0x1A, 0x0A, 0x00, 0x00, 0x00, 0x0D, 0x49, 0x48, 0x44, 0x52, 0x00, 0x00, 0x00, 0x10,
+    0x00, 0x00, 0x00, 0x10, 0x08, 0x02, 0x00, 0x00, 0x00, 0x90, 0x91, 0x68, 0x36, 0x00, 0x00, 0x01, 0xF5, 0x49, 0x44, 0x41,
+    0x54, 0x78, 0xDA, 0x0D, 0xCA, 0x91, 0xA2, 0xEC, 0x40, 0x0C, 0x00, 0xD0, 0xE0, 0xC5, 0xC1, 0xC5, 0xC1, 0xC5, 0x60, 0x31,
+    0x58, 0x0C, 0x16, 0x83, 0xC5, 0x60, 0x31, 0x58, 0x0C, 0x16, 0x83, 0xC5, 0xE0, 0xE2, 0xE0, 0xE2, 0xE0, 0xE2, 0xE0, 0xC3,
+    0xF9, 0x84, 0xD7, 0xC3, 0x07, 0x00, 0xA0, 0xC0, 0x5F, 0x85, 0x82, 0xF0, 0x22, 0xA8, 0x0C, 0x6F, 0x01, 0x54, 0x58, 0x0C,
+    0xC8, 0x61, 0x0D, 0xE0, 0x84, 0xAD, 0x81, 0x74, 0xD8, 0x07, 0xE8, 0x84, 0xE3, 0xE9, 0x7F, 0xA5, 0x94, 0x5A, 0x5E, 0x58,
+    0x2A, 0x95, 0x37, 0x17, 0x94, 0xB2, 0x68, 0x21, 0x2B, 0xAB, 0x17, 0x8E, 0xB2, 0x65, 0x91, 0x56, 0xF6, 0x5E, 0x74, 0x94,
+    0x63, 0x16, 0x03, 0xA8, 0x4F, 0x7F, 0xD5, 0x5A, 0xB1, 0xBE, 0xA9, 0x22, 0xD7, 0x45, 0x2A, 0x69, 0x5D, 0xAD, 0xB2, 0xD7,
+    0x2D, 0xAA, 0x64, 0xDD, 0x5B, 0xD5, 0x5E, 0x8F, 0x51, 0x6D, 0xD6, 0x13, 0x00, 0x5F, 0x05, 0x9F, 0xFE, 0x46, 0x44, 0xC2,
+    0x85, 0x91, 0x04, 0x57, 0x45, 0x36, 0xDC, 0x1C, 0x25, 0x70, 0x4F, 0xD4, 0x86, 0x47, 0x47, 0x1B, 0x78, 0x4E, 0x74, 0x00,
+    0xAA, 0x85, 0xDE, 0x95, 0x9E, 0xBE, 0x10, 0x11, 0xD3, 0x2A, 0xC4, 0x4A, 0x9B, 0x91, 0x38, 0xED, 0x41, 0x9A, 0x74, 0x34,
+    0xB2, 0x4E, 0xE7, 0x20, 0x9F, 0x74, 0x01, 0xF0, 0xBB, 0x30, 0x56, 0x5E, 0x90, 0x9F, 0xBE, 0x32, 0xB3, 0xF0, 0xA6, 0x2C,
+    0xC6, 0xBB, 0xB3, 0x06, 0x1F, 0xC9, 0xD6, 0xF8, 0xEC, 0xEC, 0x83, 0xAF, 0xC9, 0x01, 0x20, 0x58, 0x64, 0xA9, 0x42, 0x28,
+    0x2B, 0xC9, 0xD3, 0x37, 0x11, 0x51, 0xD9, 0x4D, 0xD4, 0xE5, 0x08, 0xB1, 0x94, 0xB3, 0x89, 0x77, 0xB9, 0x86, 0xC4, 0x94,
+    0x1B, 0x40, 0x97, 0xA2, 0x54, 0x75, 0x45, 0x65, 0xD2, 0x8D, 0xF5, 0xE9, 0xBB, 0xAA, 0x9A, 0x1E, 0xAE, 0x16, 0x7A, 0xA6,
+    0x7A, 0xD3, 0xAB, 0x6B, 0x0C, 0xBD, 0xA7, 0x26, 0x80, 0x51, 0xB1, 0xB5, 0x1A, 0xA3, 0x6D, 0x64, 0xC2, 0xB6, 0x8B, 0x3D,
+    0xFD, 0x30, 0x33, 0xB7, 0x33, 0xCC, 0xD3, 0xAE, 0x66, 0xD1, 0xED, 0x1E, 0x96, 0xD3, 0x3E, 0x00, 0xBE, 0x16, 0xE7, 0xEA,
+    0x1B, 0xBA, 0x90, 0xEF, 0xEC, 0x2A, 0x7E, 0xA8, 0x3F, 0xFD, 0x74, 0xF7, 0xF0, 0x2B, 0x3D, 0x9A, 0xDF, 0xDD, 0x73, 0xF8,
+    0x67, 0x7A, 0x03, 0x08, 0x2E, 0xB1, 0xD5, 0x10, 0x8C, 0x9D, 0x42, 0x39, 0x0E, 0x09, 0xD3, 0x38, 0x2D, 0x9E, 0x7E, 0x45,
+    0x44, 0xC6, 0xDD, 0x22, 0x7B, 0x7C, 0x46, 0xB4, 0x19, 0x5F, 0x80, 0xDC, 0x4A, 0x4A, 0xCD, 0x1D, 0x53, 0x29, 0x0F, 0x4E,
+    0x93, 0x3C, 0x35, 0xDD, 0xF2, 0xF2, 0x7C, 0xFA, 0x9D, 0x99, 0x2D, 0x3F, 0x3D, 0xDB, 0xC8, 0xEF, 0xCC, 0x0E, 0xD0, 0xA4,
+    0xB4, 0xBD, 0x36, 0xC5, 0x76, 0x50, 0x33, 0x6E, 0xA7, 0x34, 0xD7, 0x76, 0x59, 0x0B, 0x6F, 0x77, 0xB4, 0xA7, 0x7F, 0x5A,
+    0x6B, 0xBD, 0x7D, 0x47, 0xEB, 0xB3, 0xFD, 0x00, 0xFA, 0x5E, 0xBA, 0xD6, 0x7E, 0x60, 0x37, 0xEA, 0x27, 0x77, 0x97, 0x7E,
+    0x69, 0x0F, 0xEB, 0xB7, 0xF7, 0x8C, 0xFE, 0xC9, 0xFE, 0xF4, 0x6F, 0xEF, 0x7D, 0xF4, 0xDF, 0xEC, 0x03, 0x60, 0x68, 0x19,
+    0x47, 0x1D, 0x86, 0xE3, 0xA4, 0xE1, 0x3C, 0x2E, 0x19, 0xA1, 0xE3, 0xB6, 0x91, 0x3E, 0x3E, 0x31, 0x5A, 0x8E, 0x6F, 0x1B,
+    0x4F, 0xFF, 0x8D, 0x31, 0xE6, 0xF8, 0x07, 0x30, 0x8F, 0x32, 0xAD, 0xCE, 0x13, 0xA7, 0xD3, 0xBC, 0x78, 0x86, 0xCC, 0x5B,
+    0x67, 0xDA, 0xFC, 0xF8, 0x6C, 0x31, 0xBF, 0x39, 0x7B, 0x9B, 0xBF, 0x3E, 0x9F, 0xFE, 0x6F, 0xCE, 0xF9, 0x1F, 0xC5, 0x41,
+    0x68, 0x10, 0x11, 0x7F, 0xD2, 0x89, 0x00, 0x00, 0x00, 0x00, 0x49, 0x45, 0x4E, 0x44, 0xAE, 0x42, 0x60, 0x82,
+};
+
+using Bytes = std::vector<uint8_t>;
+
+static void putBe32(Bytes& b, uint32_t v) {
+    for (int s = 24; s >= 0; s -= 8) b.push_back((uint8_t)(v >> s));
+}
+
+static uint32_t crc32(const uint8_t* p, size_t n) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < n; i++) {
+        c ^= p[i];
+        for (int k = 0; k < 8; k++) c = (c >> 1) ^ (0xEDB88320u & (0u - (c & 1u)));
+    }
+    return ~c;
+}
+
+static void putChunk(Bytes& png, const char* type, const Bytes& body) {
+    putBe32(png, (uint32_t)body.size());
+    const size_t start = png.size();
+    png.insert(png.end(), type, type + 4);
+    png.insert(png.end(), body.begin(), body.end());
+    putBe32(png, crc32(png.data() + start, png.size() - start));
+}
+
+// LSB-first deflate bit writer.
+struct Bits {
+    Bytes out;
+    uint32_t acc = 0;
+    int count = 0;
+    void put(uint32_t v, int n) {
+        acc |= v << count;
+        count += n;
+        while (count >= 8) {
+            out.push_back((uint8_t)acc);
+            acc >>= 8;
+            count -= 8;
+        }
+    }
+    void putCode(uint32_t code, int n) { // Huffman codes go most significant bit first
+        for (int i = n - 1; i >= 0; i--) put((code >> i) & 1u, 1);
+    }
+    void flush() {
+        if (count > 0) put(0, 8 - count);
+    }
+};
+
+static void fixedLiteral(Bits& b, int v) {
+    if (v < 144) b.putCode(0x30u + (uint32_t)v, 8);
+    else if (v < 256) b.putCode(0x190u + (uint32_t)(v - 144), 9);
+    else if (v < 280) b.putCode((uint32_t)(v - 256), 7);
+    else b.putCode(0xC0u + (uint32_t)(v - 280), 8);
+}
+
+// zlib stream: stored blocks, or fixed Huffman with distance-1 runs (exercises length codes).
+static Bytes zlibCompress(const Bytes& raw, bool fixed) {
+    Bits b;
+    b.put(0x78, 8);
+    b.put(0x01, 8);
+    if (!fixed) {
+        size_t at = 0;
+        do {
+            const size_t n = std::min<size_t>(raw.size() - at, 65535);
+            b.put(at + n == raw.size() ? 1 : 0, 1);
+            b.put(0, 2);
+            b.flush();
+            b.put((uint32_t)n, 16);
+            b.put((uint32_t)n ^ 0xFFFFu, 16);
+            for (size_t i = 0; i < n; i++) b.put(raw[at + i], 8);
+            at += n;
+        } while (at < raw.size());
+    } else {
+        static const int kBase[29] = {3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258};
+        static const int kExtra[29] = {0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0};
+        b.put(1, 1);
+        b.put(1, 2);
+        for (size_t i = 0; i < raw.size();) {
+            size_t run = 0;
+            while (i > 0 && i + run < raw.size() && raw[i + run] == raw[i - 1] && run < 258) run++;
+            if (run >= 3) {
+                int code = 28;
+                while (kBase[code] > (int)run) code--;
+                fixedLiteral(b, 257 + code);
+                b.put((uint32_t)((int)run - kBase[code]), kExtra[code]);
+                b.putCode(0, 5); // distance code 0 = distance 1
+                i += run;
+            } else {
+                fixedLiteral(b, raw[i++]);
+            }
+        }
+        fixedLiteral(b, 256);
+    }
+    b.flush();
+    uint32_t s1 = 1, s2 = 0;
+    for (uint8_t v : raw) {
+        s1 = (s1 + v) % 65521;
+        s2 = (s2 + s1) % 65521;
+    }
+    Bytes out = b.out;
+    putBe32(out, s2 << 16 | s1);
+    return out;
+}
+
+struct PngSpec {
+    int width, height, colorType, depth;
+    bool interlace = false;
+    bool fixed = false;
+    Bytes palette = {};
+    Bytes trns = {};
+};
+
+static int channelsOf(int colorType) { return colorType == 2 ? 3 : (colorType == 4 ? 2 : (colorType == 6 ? 4 : 1)); }
+
+// Samples are one value per channel per pixel (row-major); every row uses filter (y % 5).
+static Bytes makePng(const PngSpec& s, const std::vector<int>& samples) {
+    const int ch = channelsOf(s.colorType);
+    const int bpp = std::max(1, ch * s.depth / 8);
+    static const int kStartX[7] = {0, 4, 0, 2, 0, 1, 0}, kStartY[7] = {0, 0, 4, 0, 2, 0, 1};
+    static const int kStepX[7] = {8, 8, 4, 4, 2, 2, 1}, kStepY[7] = {8, 8, 8, 4, 4, 2, 2};
+    Bytes raw;
+    for (int pass = 0; pass < (s.interlace ? 7 : 1); pass++) {
+        const int x0 = s.interlace ? kStartX[pass] : 0, dx = s.interlace ? kStepX[pass] : 1;
+        const int y0 = s.interlace ? kStartY[pass] : 0, dy = s.interlace ? kStepY[pass] : 1;
+        if (x0 >= s.width) continue;
+        Bytes prev;
+        for (int y = y0; y < s.height; y += dy) {
+            Bytes row;
+            int bitPos = 0;
+            for (int x = x0; x < s.width; x += dx) {
+                for (int c = 0; c < ch; c++) {
+                    const int v = samples[((size_t)y * s.width + x) * ch + c];
+                    if (s.depth == 16) {
+                        row.push_back((uint8_t)(v >> 8));
+                        row.push_back((uint8_t)v);
+                    } else if (s.depth == 8) {
+                        row.push_back((uint8_t)v);
+                    } else {
+                        if (bitPos % 8 == 0) row.push_back(0);
+                        row.back() |= (uint8_t)(v << (8 - s.depth - bitPos % 8));
+                        bitPos += s.depth;
+                    }
+                }
+            }
+            if (prev.empty()) prev.assign(row.size(), 0);
+            const int filter = y % 5;
+            raw.push_back((uint8_t)filter);
+            for (size_t i = 0; i < row.size(); i++) {
+                const int a = i >= (size_t)bpp ? row[i - bpp] : 0, b = prev[i], c = i >= (size_t)bpp ? prev[i - bpp] : 0;
+                int pred = 0;
+                if (filter == 1) pred = a;
+                if (filter == 2) pred = b;
+                if (filter == 3) pred = (a + b) / 2;
+                if (filter == 4) {
+                    const int p = a + b - c, pa = std::abs(p - a), pb = std::abs(p - b), pc = std::abs(p - c);
+                    pred = pa <= pb && pa <= pc ? a : (pb <= pc ? b : c);
+                }
+                raw.push_back((uint8_t)(row[i] - pred));
+            }
+            prev = row;
+        }
+    }
+    Bytes png = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+    Bytes ihdr;
+    putBe32(ihdr, (uint32_t)s.width);
+    putBe32(ihdr, (uint32_t)s.height);
+    ihdr.insert(ihdr.end(), {(uint8_t)s.depth, (uint8_t)s.colorType, 0, 0, (uint8_t)(s.interlace ? 1 : 0)});
+    putChunk(png, "IHDR", ihdr);
+    if (!s.palette.empty()) putChunk(png, "PLTE", s.palette);
+    if (!s.trns.empty()) putChunk(png, "tRNS", s.trns);
+    // Split the stream over two IDAT chunks.
+    const Bytes z = zlibCompress(raw, s.fixed);
+    putChunk(png, "IDAT", Bytes(z.begin(), z.begin() + (std::ptrdiff_t)(z.size() / 2)));
+    putChunk(png, "IDAT", Bytes(z.begin() + (std::ptrdiff_t)(z.size() / 2), z.end()));
+    putChunk(png, "IEND", {});
+    return png;
+}
+
+static Bytes decode(const Bytes& data, int* w = nullptr, int* h = nullptr, int* format = nullptr) {
+    int fmt = 0, width = 0, height = 0;
+    if (!g4f_image_info(data.data(), data.size(), &fmt, &width, &height)) return {};
+    Bytes px((size_t)width * height * 4);
+    if (!g4f_image_decode_rgba8(data.data(), data.size(), px.data(), 0)) return {};
+    if (w) *w = width;
+    if (h) *h = height;
+    if (format) *format = fmt;
+    return px;
+}
+
+static void testPngColorTypesAndDepths() {
+    struct Case {
+        int colorType, depth;
+    };
+    const Case cases[] = {{0, 1}, {0, 2}, {0, 4}, {0, 8}, {0, 16}, {2, 8}, {2, 16}, {3, 1}, {3, 2}, {3, 4}, {3, 8}, {4, 8}, {4, 16}, {6, 8}, {6, 16}};
+    for (const Case& k : cases) {
+        for (int variant = 0; variant < 3; variant++) {
+            PngSpec s{13, 11, k.colorType, k.depth};
+            s.interlace = variant == 1;
+            s.fixed = variant == 2;
+            const int ch = channelsOf(k.colorType);
+            const int maxValue = (1 << k.depth) - 1;
+            std::vector<int> samples((size_t)s.width * s.height * ch);
+            for (size_t i = 0; i < samples.size(); i++) samples[i] = (int)((((uint32_t)i * 2654435761u) >> 7) % (uint32_t)(maxValue + 1));
+            for (size_t i = 0; i < samples.size() / 3; i++) samples[i] = samples[0]; // runs for the fixed-Huffman matches
+            int paletteSize = 0;
+            if (k.colorType == 3) {
+                paletteSize = maxValue + 1;
+                for (int i = 0; i < paletteSize; i++) s.palette.insert(s.palette.end(), {(uint8_t)(i * 3), (uint8_t)(255 - i), (uint8_t)(i * 7)});
+                for (int i = 0; i < paletteSize / 2; i++) s.trns.push_back((uint8_t)(i * 5));
+            }
+            const Bytes px = decode(makePng(s, samples));
+            assert(px.size() == (size_t)s.width * s.height * 4);
+            for (int i = 0; i < s.width * s.height; i++) {
+                const int* v = &samples[(size_t)i * ch];
+                auto to8 = [&](int x) { return k.depth == 16 ? x >> 8 : x * 255 / maxValue; };
+                uint8_t expected[4] = {0, 0, 0, 255};
+                if (k.colorType == 3) {
+                    expected[0] = s.palette[(size_t)v[0] * 3];
+                    expected[1] = s.palette[(size_t)v[0] * 3 + 1];
+                    expected[2] = s.palette[(size_t)v[0] * 3 + 2];
+                    expected[3] = v[0] < (int)s.trns.size() ? s.trns[(size_t)v[0]] : 255;
+                } else if (ch <= 2) {
+                    expected[0] = expected[1] = expected[2] = (uint8_t)to8(v[0]);
+                    if (ch == 2) expected[3] = (uint8_t)to8(v[1]);
+                } else {
+                    for (int c = 0; c < ch; c++) expected[c] = (uint8_t)to8(v[c]);
+                }
+                assert(std::memcmp(&px[(size_t)i * 4], expected, 4) == 0);
+            }
+        }
+    }
+}
+
+static void testPngColorKey() {
+    PngSpec s{4, 1, 2, 16};
+    const std::vector<int> samples = {1000, 2000, 3000, 1000, 2000, 3001, 0, 0, 0, 1000, 2000, 3000};
+    s.trns = {0x03, 0xE8, 0x07, 0xD0, 0x0B, 0xB8}; // key (1000, 2000, 3000), compared at 16 bits
+    const Bytes px = decode(makePng(s, samples));
+    assert(px[3] == 0 && px[7] == 255 && px[11] == 255 && px[15] == 0);
+}
+
+static void testPngDynamicHuffman() {
+    int w = 0, h = 0, format = 0;
+    const Bytes px = decode(Bytes(kPngDynamic, kPngDynamic + sizeof(kPngDynamic)), &w, &h, &format);
+    assert(format == G4F_IMAGE_PNG && w == 16 && h == 16);
+    for (int y = 0; y < 16; y++) {
+        for (int x = 0; x < 16; x++) {
+            const uint8_t* p = &px[((size_t)y * 16 + x) * 4];
+            assert(p[0] == (uint8_t)(x * 16) && p[1] == (uint8_t)(y * 16) && p[2] == (uint8_t)((x + y) * 8) && p[3] == 255);
+        }
+    }
+}
+
+// TGA with the given type/depth; pixels are written in file order from `stored` (already encoded).
+static Bytes makeTga(int type, int width, int height, int depth, uint8_t descriptor, const Bytes& colorMap, int mapDepth, const Bytes& data) {
+    Bytes t(18, 0);
+    t[1] = colorMap.empty() ? 0 : 1;
+    t[2] = (uint8_t)type;
+    const int mapBytes = (mapDepth + 7) / 8;
+    const int mapLength = colorMap.empty() ? 0 : (int)colorMap.size() / mapBytes;
+    t[5] = (uint8_t)mapLength;
+    t[6] = (uint8_t)(mapLength >> 8);
+    t[7] = (uint8_t)(colorMap.empty() ? 0 : mapDepth);
+    t[12] = (uint8_t)width;
+    t[13] = (uint8_t)(width >> 8);
+    t[14] = (uint8_t)height;
+    t[15] = (uint8_t)(height >> 8);
+    t[16] = (uint8_t)depth;
+    t[17] = descriptor;
+    t.insert(t.end(), colorMap.begin(), colorMap.end());
+    t.insert(t.end(), data.begin(), data.end());
+    return t;
+}
+
+static void testTga() {
+    // 3x2 BGRA, bottom-up (the default): the first stored row is the bottom one.
+    Bytes raw;
+    for (int i = 0; i < 6; i++) raw.insert(raw.end(), {(uint8_t)(i * 10), (uint8_t)(i * 20), (uint8_t)(i * 30), (uint8_t)(200 + i)});
+    int w = 0, h = 0, format = 0;
+    Bytes px = decode(makeTga(2, 3, 2, 32, 8, {}, 0, raw), &w, &h, &format);
+    assert(format == G4F_IMAGE_TGA && w == 3 && h == 2);
+    const uint8_t bottomLeft[4] = {0, 0, 0, 200}, topLeft[4] = {90, 60, 30, 203};
+    assert(std::memcmp(&px[3 * 4], bottomLeft, 4) == 0 && std::memcmp(&px[0], topLeft, 4) == 0);
+
+    // Same pixels top-down and right-to-left.
+    px = decode(makeTga(2, 3, 2, 32, 8 | 0x20 | 0x10, {}, 0, raw));
+    assert(std::memcmp(&px[2 * 4], bottomLeft, 4) == 0);
+
+    // RLE: a repeat packet of 4 and a raw packet of 2, 24-bit, top-down.
+    const Bytes rle = {0x83, 1, 2, 3, 0x01, 4, 5, 6, 7, 8, 9};
+    px = decode(makeTga(10, 3, 2, 24, 0x20, {}, 0, rle));
+    const uint8_t expected[6][4] = {{3, 2, 1, 255}, {3, 2, 1, 255}, {3, 2, 1, 255}, {3, 2, 1, 255}, {6, 5, 4, 255}, {9, 8, 7, 255}};
+    assert(px.size() == 24 && std::memcmp(px.data(), expected, 24) == 0);
+
+    // Color-mapped with 16-bit (A1R5G5B5) entries and grayscale.
+    const Bytes map = {0x00, 0x7C, 0xE0, 0x83}; // entry 0: red, alpha bit clear; entry 1: green, alpha bit set
+    px = decode(makeTga(1, 2, 1, 8, 1, map, 16, {1, 0}));
+    const uint8_t mapped[8] = {0, 255, 0, 255, 255, 0, 0, 0};
+    assert(px.size() == 8 && std::memcmp(px.data(), mapped, 8) == 0);
+    px = decode(makeTga(11, 2, 1, 8, 0, {}, 0, {0x81, 77}));
+    assert(px.size() == 8 && px[0] == 77 && px[5] == 77 && px[7] == 255);
+
+    // Truncated pixel data fails cleanly.
+    Bytes cut = makeTga(2, 3, 2, 32, 8, {}, 0, raw);
+    cut.erase(cut.end() - 3, cut.end());
+    assert(decode(cut).empty());
+}
+
+static void testQoi() {
+    Bytes q = {'q', 'o', 'i', 'f', 0, 0, 0, 4, 0, 0, 0, 2, 4, 0};
+    q.insert(q.end(), {
+        0xFF, 10, 20, 30, 40,  // RGBA
+        0xC1,                  // run of 2
+        0xFE, 100, 110, 120,   // RGB (alpha stays 40)
+        0x40 | 3 << 4 | 1 << 2 | 2, // DIFF +1, -1, 0
+        0x80 | (32 + 5), 8 << 4 | 9, // LUMA dg = +5, dr - dg = 0, db - dg = +1
+        (uint8_t)((10 * 3 + 20 * 5 + 30 * 7 + 40 * 11) & 63), // INDEX of the first pixel
+        0xC0,                  // run of 1
+    });
+    q.insert(q.end(), {0, 0, 0, 0, 0, 0, 0, 1});
+    int w = 0, h = 0, format = 0;
+    const Bytes px = decode(q, &w, &h, &format);
+    assert(format == G4F_IMAGE_QOI && w == 4 && h == 2);
+    const uint8_t expected[8][4] = {{10, 20, 30, 40}, {10, 20, 30, 40}, {10, 20, 30, 40}, {100, 110, 120, 40},
+                                    {101, 109, 120, 40}, {106, 114, 126, 40}, {10, 20, 30, 40}, {10, 20, 30, 40}};
+    assert(std::memcmp(px.data(), expected, sizeof(expected)) == 0);
+
+    Bytes cut(q.begin(), q.begin() + 20);
+    assert(decode(cut).empty());
+    assert(std::strstr(g4f_last_error(), "qoi"));
+}
+
+static void testRejectsBadInput() {
+    int format = -1, w = 0, h = 0;
+    const uint8_t junk[32] = {1, 2, 3};
+    assert(!g4f_image_info(junk, sizeof(junk), &format, &w, &h) && format == G4F_IMAGE_UNKNOWN);
+    assert(!g4f_image_info(nullptr, 10, &format, &w, &h));
+
+    // Every truncation and single-byte corruption of a PNG either decodes or fails cleanly.
+    const Bytes png(kPngDynamic, kPngDynamic + sizeof(kPngDynamic));
+    Bytes px(16 * 16 * 4);
+    for (size_t n = 0; n < png.size(); n++) {
+        if (g4f_image_decode_rgba8(png.data(), n, px.data(), 0)) assert(false);
+    }
+    for (size_t i = 8; i < png.size(); i += 3) {
+        Bytes bad = png;
+        bad[i] ^= 0x5A;
+        int bw = 0, bh = 0;
+        if (g4f_image_info(bad.data(), bad.size(), nullptr, &bw, &bh) && bw * bh <= 16 * 16) g4f_image_decode_rgba8(bad.data(), bad.size(), px.data(), 0);
+    }
+
+    // Pitch and size limits.
+    assert(!g4f_image_decode_rgba8(png.data(), png.size(), px.data(), 16));
+    assert(std::strstr(g4f_last_error(), "g4f_image_decode_rgba8"));
+    Bytes tooWide = makePng(PngSpec{1, 1, 0, 8}, {0});
+    tooWide[16] = 0x01; // width 2^24
+    assert(!g4f_image_info(tooWide.data(), tooWide.size(), nullptr, nullptr, nullptr));
+}
+
+static void testDecodeWithPitch() {
+    const Bytes png(kPngDynamic, kPngDynamic + sizeof(kPngDynamic));
+    const int pitch = 16 * 4 + 12;
+    Bytes px((size_t)pitch * 16, 0xAB);
+    assert(g4f_image_decode_rgba8(png.data(), png.size(), px.data(), pitch));
+    for (int y = 0; y < 16; y++) {
+        assert(px[(size_t)y * pitch + 4] == 16 && px[(size_t)y * pitch + 1] == (uint8_t)(y * 16));
+        for (int i = 64; i < pitch; i++) assert(px[(size_t)y * pitch + (size_t)i] == 0xAB);
+    }
+}
+
+static void testBatch(const std::filesystem::path& dir) {
+    std::vector<std::string> paths;
+    for (int i = 0; i < 12; i++) {
+        PngSpec s{8 + i, 5, 6, 8};
+        s.interlace = i % 2 == 1;
+        std::vector<int> samples((size_t)s.width * s.height * 4);
+        for (size_t k = 0; k < samples.size(); k++) samples[k] = (int)(k * 7 + (size_t)i) & 255;
+        const Bytes png = makePng(s, samples);
+        paths.push_back((dir / ("img" + std::to_string(i) + ".png")).string());
+        std::ofstream(paths.back(), std::ios::binary).write((const char*)png.data(), (std::streamsize)png.size());
+    }
+    paths.push_back((dir / "missing.png").string());
+    paths.push_back((dir / "junk.png").string());
+    std::ofstream(paths.back(), std::ios::binary) << "not an image at all";
+
+    std::vector<const char*> cpaths;
+    for (const std::string& p : paths) cpaths.push_back(p.c_str());
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    g4f_image_batch* batch = g4f_image_batch_load(cpaths.data(), (int)cpaths.size(), jobs);
+    assert(batch && g4f_image_batch_count(batch) == 14);
+    for (int i = 0; i < 12; i++) {
+        int w = 0, h = 0;
+        const uint8_t* px = g4f_image_batch_pixels(batch, i, &w, &h);
+        assert(px && w == 8 + i && h == 5 && g4f_image_batch_error(batch, i)[0] == 0);
+        assert(px[0] == (uint8_t)i && px[5] == (uint8_t)(35 + i));
+    }
+    int w = -1, h = -1;
+    assert(!g4f_image_batch_pixels(batch, 12, &w, &h) && w == 0 && h == 0);
+    assert(std::strlen(g4f_image_batch_error(batch, 12)) > 0);
+    assert(std::strstr(g4f_image_batch_error(batch, 13), "unrecognized"));
+    assert(!g4f_image_batch_pixels(batch, 99, nullptr, nullptr));
+    g4f_image_batch_destroy(batch);
+    g4f_image_batch_destroy(nullptr);
+    g4f_jobs_destroy(jobs);
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "g4f_image_tests";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    testPngColorTypesAndDepths();
+    testPngColorKey();
+    testPngDynamicHuffman();
+    testTga();
+    testQoi();
+    testRejectsBadInput();
+    testDecodeWithPitch();
+    testBatch(dir);
+    std::filesystem::remove_all(dir);
+    std::printf("image_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,69 @@
+#include <atomic>
+#include <cassert>
+#include <cstdio>
+#include <vector>
+
+#include "g4f/g4f_jobs.h"
+
+struct CoverState {
+    std::vector<std::atomic<int>>* hits;
+    int threadCount;
+    std::atomic<int> badWorker{0};
+};
+
+static void coverRange(void* user, int begin, int end, int workerIndex) {
+    auto* s = (CoverState*)user;
+    if (workerIndex < 0 || workerIndex >= s->threadCount) s->badWorker.fetch_add(1);
+    for (int i = begin; i < end; i++) (*s->hits)[(size_t)i].fetch_add(1);
+}
+
+static void testCoversEveryIndexOnce(g4f_jobs* jobs, int count, int grain) {
+    std::vector<std::atomic<int>> hits((size_t)count);
+    for (auto& h : hits) h.store(0);
+    CoverState s{&hits, g4f_jobs_thread_count(jobs)};
+    g4f_jobs_parallel_for(jobs, count, grain, coverRange, &s);
+    for (auto& h : hits) assert(h.load() == 1);
+    assert(s.badWorker.load() == 0);
+}
+
+struct NestedState {
+    g4f_jobs* jobs;
+    std::atomic<int> total{0};
+};
+
+static void nestedInner(void* user, int begin, int end, int) {
+    auto* s = (NestedState*)user;
+    s->total.fetch_add(end - begin);
+}
+
+static void nestedOuter(void* user, int begin, int end, int) {
+    auto* s = (NestedState*)user;
+    for (int i = begin; i < end; i++) g4f_jobs_parallel_for(s->jobs, 10, 0, nestedInner, s);
+}
+
+int main() {
+    assert(g4f_jobs_hardware_threads() >= 1);
+    assert(g4f_jobs_thread_count(nullptr) == 1);
+
+    testCoversEveryIndexOnce(nullptr, 1000, 0);
+
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    assert(jobs != nullptr);
+    assert(g4f_jobs_thread_count(jobs) == 4);
+    testCoversEveryIndexOnce(jobs, 1, 0);
+    testCoversEveryIndexOnce(jobs, 1000, 0);
+    testCoversEveryIndexOnce(jobs, 1000, 7);
+    testCoversEveryIndexOnce(jobs, 1000, 5000);
+    for (int i = 0; i < 200; i++) testCoversEveryIndexOnce(jobs, 64, 1); // repeated short batches
+
+    // Nested parallel_for runs inline inside workers.
+    NestedState nested{jobs};
+    g4f_jobs_parallel_for(jobs, 32, 1, nestedOuter, &nested);
+    assert(nested.total.load() == 32 * 10);
+
+    g4f_jobs_destroy(jobs);
+    g4f_jobs_destroy(nullptr);
+
+    std::printf("jobs_tests: OK\n");
+    return 0;
+}
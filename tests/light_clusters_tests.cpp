@@ -0,0 +1,261 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_camera.h"
+#include "g4f/g4f_light_clusters.h"
+
+static uint32_t g_rng = 12345u;
+static float randf(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static g4f_vec3 toView(const g4f_mat4& v, g4f_vec3 p) {
+    return g4f_vec3{
+        p.x * v.m[0] + p.y * v.m[4] + p.z * v.m[8] + v.m[12],
+        p.x * v.m[1] + p.y * v.m[5] + p.z * v.m[9] + v.m[13],
+        p.x * v.m[2] + p.y * v.m[6] + p.z * v.m[10] + v.m[14],
+    };
+}
+
+static bool lightReaches(const g4f_light& l, g4f_vec3 p) {
+    const float dx = p.x - l.position.x, dy = p.y - l.position.y, dz = p.z - l.position.z;
+    const float d2 = dx * dx + dy * dy + dz * dz;
+    if (d2 >= l.radius * l.radius) return false;
+    if (l.type != G4F_LIGHT_SPOT || d2 <= 0.0f) return true;
+    const float inv = 1.0f / std::sqrt(d2);
+    const float cosAngle = (dx * l.direction.x + dy * l.direction.y + dz * l.direction.z) * inv;
+    return cosAngle > l.spotOuterCos;
+}
+
+static std::vector<g4f_light> randomLights(int count) {
+    std::vector<g4f_light> lights((size_t)count);
+    for (g4f_light& l : lights) {
+        l = g4f_light{};
+        l.type = (randf(0.0f, 1.0f) < 0.3f) ? G4F_LIGHT_SPOT : G4F_LIGHT_POINT;
+        l.position = g4f_vec3{randf(-30.0f, 30.0f), randf(-5.0f, 10.0f), randf(-30.0f, 30.0f)};
+        l.radius = randf(0.5f, 6.0f);
+        float dx = randf(-1.0f, 1.0f), dy = randf(-1.0f, 1.0f), dz = randf(-1.0f, 1.0f);
+        float len = std::sqrt(dx * dx + dy * dy + dz * dz) + 1e-6f;
+        l.direction = g4f_vec3{dx / len, dy / len, dz / len};
+        l.spotOuterCos = randf(0.2f, 0.95f);
+        l.spotInnerCos = l.spotOuterCos + 0.02f;
+        l.colorRgba = g4f_rgba_u32(255, 255, 255, 255);
+        l.intensity = 1.0f;
+    }
+    return lights;
+}
+
+// The tests below place lights in front of g4f_mat4_look_at cameras, which look down -Z; this is
+// the matching projection (w = -z_view).
+static g4f_mat4 projLookingDownNegZ() {
+    const g4f_mat4 flipZ = g4f_mat4_scale(1.0f, 1.0f, -1.0f);
+    return g4f_mat4_mul(flipZ, g4f_mat4_perspective(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f));
+}
+
+static bool froxelHasLight(const g4f_light_cluster_result& r, int froxel, uint32_t light) {
+    const uint32_t offset = r.ranges[froxel * 2];
+    const uint32_t count = r.ranges[froxel * 2 + 1];
+    for (uint32_t k = 0; k < count; k++) {
+        if (r.indices[offset + k] == light) return true;
+    }
+    return false;
+}
+
+static void testConservativeAgainstBruteForce() {
+    std::vector<g4f_light> lights = randomLights(600);
+    g4f_light_cluster_desc desc = g4f_light_cluster_desc_default();
+    desc.farZ = 60.0f;
+    desc.maxLightsPerCluster = 1024; // nothing dropped: every reaching light must be listed
+    g4f_light_clusters* clusters = g4f_light_clusters_create(&desc);
+    assert(clusters);
+
+    g4f_mat4 view = g4f_mat4_look_at(g4f_vec3{2.0f, 3.0f, -20.0f}, g4f_vec3{-3.0f, 1.0f, 10.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 proj = projLookingDownNegZ();
+    assert(g4f_light_clusters_build(clusters, lights.data(), (int)lights.size(), &view, &proj, nullptr) == 1);
+    g4f_light_cluster_result r{};
+    g4f_light_clusters_get_result(clusters, &r);
+    assert(r.droppedCount == 0);
+    assert(r.clusterCount == desc.tilesX * desc.tilesY * desc.slices);
+
+    int checked = 0;
+    long long listed = 0;
+    for (int s = 0; s < 20000; s++) {
+        g4f_vec3 p{randf(-40.0f, 40.0f), randf(-6.0f, 12.0f), randf(-25.0f, 40.0f)};
+        int froxel = g4f_light_clusters_froxel_index(clusters, toView(view, p));
+        if (froxel < 0) continue;
+        checked++;
+        listed += r.ranges[froxel * 2 + 1];
+        for (uint32_t i = 0; i < lights.size(); i++) {
+            if (lightReaches(lights[i], p)) assert(froxelHasLight(r, froxel, i));
+        }
+    }
+    assert(checked > 5000);
+    // Binning is conservative, not "everything": lists stay short relative to the light count.
+    assert(listed / checked < 60);
+
+    // Lists are sorted by light index (deterministic order for the GPU).
+    for (int f = 0; f < r.clusterCount; f++) {
+        for (uint32_t k = 1; k < r.ranges[f * 2 + 1]; k++) {
+            assert(r.indices[r.ranges[f * 2] + k - 1] < r.indices[r.ranges[f * 2] + k]);
+        }
+    }
+    g4f_light_clusters_destroy(clusters);
+}
+
+static void testCulledLightsAndFroxelMapping() {
+    g4f_light_cluster_desc desc = g4f_light_cluster_desc_default();
+    g4f_light_clusters* clusters = g4f_light_clusters_create(&desc);
+    g4f_mat4 view = g4f_mat4_identity(); // camera at origin looking down -Z
+    g4f_mat4 proj = projLookingDownNegZ();
+
+    g4f_light lights[3]{};
+    lights[0].position = g4f_vec3{0.0f, 0.0f, 5.0f}; // behind the camera
+    lights[0].radius = 2.0f;
+    lights[1].position = g4f_vec3{500.0f, 0.0f, -10.0f}; // far outside on the right
+    lights[1].radius = 2.0f;
+    lights[2].position = g4f_vec3{0.0f, 0.0f, -10.0f}; // straight ahead
+    lights[2].radius = 0.5f;
+    assert(g4f_light_clusters_build(clusters, lights, 3, &view, &proj, nullptr) == 1);
+
+    g4f_light_cluster_result r{};
+    g4f_light_clusters_get_result(clusters, &r);
+    assert(r.depthSign == -1.0f);
+    for (int i = 0; i < r.indexCount; i++) assert(r.indices[i] == 2);
+    assert(r.indexCount > 0 && r.indexCount < 16); // a handful of central froxels
+
+    int centre = g4f_light_clusters_froxel_index(clusters, g4f_vec3{0.0f, 0.0f, -10.0f});
+    assert(centre >= 0 && froxelHasLight(r, centre, 2));
+    assert(g4f_light_clusters_froxel_index(clusters, g4f_vec3{0.0f, 0.0f, 1.0f}) == -1);      // behind
+    assert(g4f_light_clusters_froxel_index(clusters, g4f_vec3{0.0f, 0.0f, -0.05f}) == -1);    // before near
+    assert(g4f_light_clusters_froxel_index(clusters, g4f_vec3{0.0f, 0.0f, -200.0f}) == -1);   // past far
+    assert(g4f_light_clusters_froxel_index(clusters, g4f_vec3{100.0f, 0.0f, -10.0f}) == -1);  // off screen
+
+    // +x is the right-most tile column, +y the top row, deeper is a later slice.
+    int right = g4f_light_clusters_froxel_index(clusters, g4f_vec3{r.tanHalfX * 9.99f, 0.0f, -10.0f});
+    assert(right % r.tilesX == r.tilesX - 1);
+    int top = g4f_light_clusters_froxel_index(clusters, g4f_vec3{0.0f, r.tanHalfY * 9.99f, -10.0f});
+    assert((top / r.tilesX) % r.tilesY == r.tilesY - 1);
+    int deep = g4f_light_clusters_froxel_index(clusters, g4f_vec3{0.0f, 0.0f, -90.0f});
+    assert(deep / (r.tilesX * r.tilesY) > centre / (r.tilesX * r.tilesY));
+    g4f_light_clusters_destroy(clusters);
+}
+
+// The engine camera: g4f_camera_fps_view + g4f_camera_fps_proj render the z_view > 0 side (w = +z_view).
+// Every visible point a light reaches must land in a froxel that lists the light.
+static void testFpsCameraMatrices() {
+    g4f_camera_fps cam = g4f_camera_fps_default();
+    cam.position = g4f_vec3{1.0f, 2.0f, -3.0f};
+    cam.yawRadians = 0.4f;
+    cam.pitchRadians = -0.2f;
+    const g4f_mat4 view = g4f_camera_fps_view(&cam);
+    const g4f_mat4 proj = g4f_camera_fps_proj(&cam, 16.0f / 9.0f);
+    const g4f_mat4 viewProj = g4f_mat4_mul(view, proj);
+
+    g4f_light_cluster_desc desc = g4f_light_cluster_desc_default();
+    desc.maxLightsPerCluster = 1024;
+    g4f_light_clusters* clusters = g4f_light_clusters_create(&desc);
+    std::vector<g4f_light> lights = randomLights(400);
+    assert(g4f_light_clusters_build(clusters, lights.data(), (int)lights.size(), &view, &proj, nullptr) == 1);
+    g4f_light_cluster_result r{};
+    g4f_light_clusters_get_result(clusters, &r);
+    assert(r.depthSign == 1.0f && r.droppedCount == 0);
+
+    int reached = 0;
+    for (int s = 0; s < 20000; s++) {
+        const g4f_light& l = lights[(size_t)s % lights.size()];
+        // Points inside the light's sphere.
+        const float dx = randf(-1.0f, 1.0f), dy = randf(-1.0f, 1.0f), dz = randf(-1.0f, 1.0f);
+        const float k = l.radius * 0.99f / (std::sqrt(dx * dx + dy * dy + dz * dz) + 1e-6f) * randf(0.0f, 1.0f);
+        const g4f_vec3 p{l.position.x + dx * k, l.position.y + dy * k, l.position.z + dz * k};
+        if (!lightReaches(l, p)) continue;
+
+        // Visible on screen per the projection: 0 < w, |x|, |y| < w, depth inside the clustered range.
+        const float* m = viewProj.m;
+        const float cx = p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12];
+        const float cy = p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13];
+        const float cw = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
+        if (!(cw > desc.nearZ && cw < desc.farZ && std::fabs(cx) < cw * 0.999f && std::fabs(cy) < cw * 0.999f)) continue;
+        const int froxel = g4f_light_clusters_froxel_index(clusters, toView(view, p));
+        assert(froxel >= 0);
+        assert(froxelHasLight(r, froxel, (uint32_t)(s % lights.size())));
+        reached++;
+    }
+    assert(reached > 1000);
+    g4f_light_clusters_destroy(clusters);
+}
+
+static void testThreadCountDoesNotChangeResult() {
+    std::vector<g4f_light> lights = randomLights(3000);
+    g4f_mat4 view = g4f_mat4_look_at(g4f_vec3{0.0f, 2.0f, -25.0f}, g4f_vec3{0.0f, 0.0f, 0.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 proj = projLookingDownNegZ();
+    g4f_light_clusters* serial = g4f_light_clusters_create(nullptr);
+    g4f_light_clusters* parallel = g4f_light_clusters_create(nullptr);
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    assert(g4f_light_clusters_build(serial, lights.data(), (int)lights.size(), &view, &proj, nullptr) == 1);
+    for (int pass = 0; pass < 2; pass++) { // second pass reuses buffers
+        assert(g4f_light_clusters_build(parallel, lights.data(), (int)lights.size(), &view, &proj, jobs) == 1);
+    }
+
+    g4f_light_cluster_result a{}, b{};
+    g4f_light_clusters_get_result(serial, &a);
+    g4f_light_clusters_get_result(parallel, &b);
+    assert(a.indexCount == b.indexCount && a.droppedCount == b.droppedCount);
+    assert(std::memcmp(a.ranges, b.ranges, sizeof(uint32_t) * 2 * (size_t)a.clusterCount) == 0);
+    assert(std::memcmp(a.indices, b.indices, sizeof(uint32_t) * (size_t)a.indexCount) == 0);
+
+    g4f_jobs_destroy(jobs);
+    g4f_light_clusters_destroy(parallel);
+    g4f_light_clusters_destroy(serial);
+}
+
+static void testOverflowAndValidation() {
+    g4f_light_cluster_desc desc = g4f_light_cluster_desc_default();
+    desc.maxLightsPerCluster = 4;
+    g4f_light_clusters* clusters = g4f_light_clusters_create(&desc);
+    std::vector<g4f_light> lights(10);
+    for (g4f_light& l : lights) {
+        l = g4f_light{};
+        l.position = g4f_vec3{0.0f, 0.0f, -10.0f};
+        l.radius = 0.3f;
+    }
+    g4f_mat4 view = g4f_mat4_identity();
+    g4f_mat4 proj = projLookingDownNegZ();
+    assert(g4f_light_clusters_build(clusters, lights.data(), 10, &view, &proj, nullptr) == 1);
+    g4f_light_cluster_result r{};
+    g4f_light_clusters_get_result(clusters, &r);
+    assert(r.droppedCount > 0);
+    for (int f = 0; f < r.clusterCount; f++) {
+        assert(r.ranges[f * 2 + 1] <= 4);
+        // The lowest light indices win.
+        for (uint32_t k = 0; k < r.ranges[f * 2 + 1]; k++) assert(r.indices[r.ranges[f * 2] + k] == k);
+    }
+
+    assert(g4f_light_clusters_build(clusters, nullptr, 0, &view, &proj, nullptr) == 1); // empty list is fine
+    g4f_light_clusters_get_result(clusters, &r);
+    assert(r.indexCount == 0 && r.droppedCount == 0);
+
+    assert(g4f_light_clusters_build(clusters, nullptr, 3, &view, &proj, nullptr) == 0);
+    assert(std::strstr(g4f_last_error(), "g4f_light_clusters_build"));
+    assert(g4f_light_clusters_build(clusters, lights.data(), 10, &view, nullptr, nullptr) == 0);
+    g4f_mat4 ortho = g4f_mat4_identity();
+    assert(g4f_light_clusters_build(clusters, lights.data(), 10, &view, &ortho, nullptr) == 0);
+    assert(std::strstr(g4f_last_error(), "perspective"));
+    desc.farZ = desc.nearZ;
+    assert(g4f_light_clusters_set_desc(clusters, &desc) == 0);
+    assert(g4f_light_clusters_create(&desc) == nullptr);
+    g4f_light_clusters_destroy(clusters);
+}
+
+int main() {
+    testConservativeAgainstBruteForce();
+    testCulledLightsAndFroxelMapping();
+    testFpsCameraMatrices();
+    testThreadCountDoesNotChangeResult();
+    testOverflowAndValidation();
+    std::printf("light_clusters_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,364 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <set>
+#include <vector>
+
+#include "g4f/g4f_lod.h"
+#include "g4f/g4f_scene.h"
+
+struct Mesh {
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+
+    g4f_lod_mesh_desc desc() const {
+        g4f_lod_mesh_desc d = g4f_lod_mesh_desc_default();
+        d.positions = positions.data();
+        d.vertexCount = (int)positions.size();
+        d.indices32 = indices.data();
+        d.indexCount = (int)indices.size();
+        return d;
+    }
+};
+
+static void gridIndices(Mesh& m, int nx, int nz) {
+    for (int z = 0; z < nz; z++) {
+        for (int x = 0; x < nx; x++) {
+            const uint32_t i = (uint32_t)(z * (nx + 1) + x);
+            const uint32_t row = (uint32_t)nx + 1u;
+            const uint32_t quad[6] = {i, i + row, i + 1u, i + 1u, i + row, i + row + 1u};
+            m.indices.insert(m.indices.end(), quad, quad + 6);
+        }
+    }
+}
+
+// UV sphere of radius 1 with a duplicated seam column and pole rows (degenerate pole triangles).
+static Mesh makeSphere(int rings, int segments) {
+    Mesh m;
+    for (int r = 0; r <= rings; r++) {
+        const float phi = 3.14159265f * (float)r / (float)rings;
+        const float ringRadius = (r == 0 || r == rings) ? 0.0f : std::sin(phi);
+        for (int s = 0; s <= segments; s++) {
+            const float theta = 6.2831853f * (float)(s % segments) / (float)segments;
+            m.positions.push_back(g4f_vec3{ringRadius * std::cos(theta), std::cos(phi), ringRadius * std::sin(theta)});
+        }
+    }
+    gridIndices(m, segments, rings);
+    return m;
+}
+
+// Flat n x n grid on XZ covering [0, 10]^2.
+static Mesh makePlane(int n) {
+    Mesh m;
+    for (int z = 0; z <= n; z++) {
+        for (int x = 0; x <= n; x++) m.positions.push_back(g4f_vec3{10.0f * (float)x / (float)n, 0.0f, 10.0f * (float)z / (float)n});
+    }
+    gridIndices(m, n, n);
+    return m;
+}
+
+static g4f_vec3 cross(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+static g4f_vec3 sub(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+static float length(g4f_vec3 v) { return std::sqrt(v.x * v.x + v.y * v.y + v.z * v.z); }
+
+// Largest distance from the unit sphere over triangle corners, edge midpoints and centroids.
+static float sphereDeviation(const Mesh& m, const uint32_t* indices, int count) {
+    float worst = 0.0f;
+    for (int t = 0; t < count; t += 3) {
+        const g4f_vec3 a = m.positions[indices[t]], b = m.positions[indices[t + 1]], c = m.positions[indices[t + 2]];
+        const g4f_vec3 samples[4] = {
+            g4f_vec3{(a.x + b.x) * 0.5f, (a.y + b.y) * 0.5f, (a.z + b.z) * 0.5f},
+            g4f_vec3{(b.x + c.x) * 0.5f, (b.y + c.y) * 0.5f, (b.z + c.z) * 0.5f},
+            g4f_vec3{(a.x + c.x) * 0.5f, (a.y + c.y) * 0.5f, (a.z + c.z) * 0.5f},
+            g4f_vec3{(a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f},
+        };
+        for (const g4f_vec3& p : samples) worst = std::max(worst, std::fabs(1.0f - length(p)));
+    }
+    return worst;
+}
+
+static void testSimplifyHitsTargets() {
+    const Mesh sphere = makeSphere(64, 64);
+    const g4f_lod_mesh_desc desc = sphere.desc();
+    std::vector<uint32_t> out(sphere.indices.size());
+    float previousError = 0.0f;
+    for (float ratio : {0.5f, 0.25f, 0.1f, 0.03f}) {
+        const int target = (int)((float)sphere.indices.size() * ratio) / 3 * 3;
+        float error = -1.0f;
+        const int count = g4f_lod_simplify(&desc, target, 0.0f, out.data(), &error);
+        assert(count > 0 && count % 3 == 0 && count <= target && count >= target - 6);
+        assert(error > previousError);
+        previousError = error;
+        for (int i = 0; i < count; i++) assert(out[(size_t)i] < sphere.positions.size());
+        // The quadric error tracks the real deviation from the sphere.
+        const float deviation = sphereDeviation(sphere, out.data(), count);
+        assert(deviation <= 3.0f * error + 1e-4f && deviation >= 0.2f * error);
+        // No inside-out triangles.
+        for (int t = 0; t < count; t += 3) {
+            const g4f_vec3 a = sphere.positions[out[(size_t)t]], b = sphere.positions[out[(size_t)t + 1]], c = sphere.positions[out[(size_t)t + 2]];
+            const g4f_vec3 n = cross(sub(b, a), sub(c, a));
+            const g4f_vec3 mid{(a.x + b.x + c.x) / 3.0f, (a.y + b.y + c.y) / 3.0f, (a.z + b.z + c.z) / 3.0f};
+            assert(n.x * mid.x + n.y * mid.y + n.z * mid.z <= 1e-6f); // grid winding faces inwards
+        }
+    }
+}
+
+static void testSimplifyRespectsMaxError() {
+    const Mesh sphere = makeSphere(64, 64);
+    const g4f_lod_mesh_desc desc = sphere.desc();
+    std::vector<uint32_t> out(sphere.indices.size());
+    for (float maxError : {0.001f, 0.01f}) {
+        float error = -1.0f;
+        const int count = g4f_lod_simplify(&desc, 0, maxError, out.data(), &error);
+        assert(count > 0 && count < (int)sphere.indices.size() && error <= maxError);
+        assert(sphereDeviation(sphere, out.data(), count) <= 3.0f * maxError + 1e-4f);
+    }
+}
+
+static void testPlaneCollapsesLosslessly() {
+    const Mesh plane = makePlane(32);
+    g4f_lod_mesh_desc desc = plane.desc();
+    std::vector<uint32_t> out(plane.indices.size());
+    float error = -1.0f;
+    int count = g4f_lod_simplify(&desc, 0, 1e-5f, out.data(), &error);
+    assert(count > 0 && count <= 4 * 3 && error <= 1e-5f);
+    // Same area, all facing up, corners kept.
+    float area = 0.0f;
+    std::set<uint32_t> used;
+    for (int t = 0; t < count; t += 3) {
+        const g4f_vec3 a = plane.positions[out[(size_t)t]], b = plane.positions[out[(size_t)t + 1]], c = plane.positions[out[(size_t)t + 2]];
+        const g4f_vec3 n = cross(sub(b, a), sub(c, a));
+        assert(n.y > 0.0f);
+        area += 0.5f * n.y;
+        used.insert(out[(size_t)t]);
+        used.insert(out[(size_t)t + 1]);
+        used.insert(out[(size_t)t + 2]);
+    }
+    assert(std::fabs(area - 100.0f) < 1e-3f);
+    for (uint32_t corner : {0u, 32u, 33u * 32u, 33u * 33u - 1u}) assert(used.count(corner) == 1);
+
+    // Locked borders keep every border vertex; the interior still collapses.
+    desc.lockBorder = 1;
+    count = g4f_lod_simplify(&desc, 0, 1e-5f, out.data(), nullptr);
+    used.clear();
+    used.insert(out.begin(), out.begin() + count);
+    int borderKept = 0;
+    for (uint32_t v : used) {
+        const g4f_vec3 p = plane.positions[v];
+        if (p.x == 0.0f || p.z == 0.0f || p.x == 10.0f || p.z == 10.0f) borderKept++;
+        else assert(false && "interior vertex survived a lossless simplification");
+    }
+    assert(borderKept == 4 * 32 && count < (int)plane.indices.size() / 4);
+}
+
+static void testSeamsStayPut() {
+    // Hard-edged cube: every corner is three vertices, so nothing may collapse.
+    Mesh cube;
+    const float e = 1.0f;
+    const g4f_vec3 faces[6][4] = {
+        {{-e, -e, -e}, {e, -e, -e}, {e, e, -e}, {-e, e, -e}}, {{-e, -e, e}, {-e, e, e}, {e, e, e}, {e, -e, e}},
+        {{-e, -e, -e}, {-e, -e, e}, {e, -e, e}, {e, -e, -e}}, {{-e, e, -e}, {e, e, -e}, {e, e, e}, {-e, e, e}},
+        {{e, -e, -e}, {e, -e, e}, {e, e, e}, {e, e, -e}},     {{-e, -e, -e}, {-e, e, -e}, {-e, e, e}, {-e, -e, e}},
+    };
+    for (int f = 0; f < 6; f++) {
+        const uint32_t base = (uint32_t)cube.positions.size();
+        cube.positions.insert(cube.positions.end(), faces[f], faces[f] + 4);
+        const uint32_t idx[6] = {base, base + 1, base + 2, base, base + 2, base + 3};
+        cube.indices.insert(cube.indices.end(), idx, idx + 6);
+    }
+    const g4f_lod_mesh_desc desc = cube.desc();
+    std::vector<uint32_t> out(cube.indices.size());
+    assert(g4f_lod_simplify(&desc, 0, 0.0f, out.data(), nullptr) == 36);
+    assert(std::equal(out.begin(), out.end(), cube.indices.begin()));
+
+    // The sphere's seam column survives any reduction.
+    const Mesh sphere = makeSphere(32, 32);
+    const g4f_lod_mesh_desc sdesc = sphere.desc();
+    out.resize(sphere.indices.size());
+    const int count = g4f_lod_simplify(&sdesc, 0, 0.0f, out.data(), nullptr);
+    std::set<uint32_t> used(out.begin(), out.begin() + count);
+    for (int r = 1; r < 32; r++) assert(used.count((uint32_t)(r * 33)) == 1 && used.count((uint32_t)(r * 33 + 32)) == 1);
+}
+
+static void testChain() {
+    const Mesh sphere = makeSphere(128, 128);
+    const g4f_lod_mesh_desc desc = sphere.desc();
+    g4f_lod_chain* chain = g4f_lod_chain_create(&desc, nullptr);
+    assert(chain);
+    const int levels = g4f_lod_chain_level_count(chain);
+    assert(levels >= 4 && levels <= 6);
+    int indexCount = 0;
+    const uint32_t* indices = g4f_lod_chain_indices(chain, &indexCount);
+    const g4f_lod_level level0 = g4f_lod_chain_level(chain, 0);
+    assert(level0.firstIndex == 0 && level0.indexCount == (int)sphere.indices.size() && level0.error == 0.0f);
+    assert(std::equal(indices, indices + level0.indexCount, sphere.indices.begin()));
+    for (int i = 1; i < levels; i++) {
+        const g4f_lod_level prev = g4f_lod_chain_level(chain, i - 1);
+        const g4f_lod_level cur = g4f_lod_chain_level(chain, i);
+        assert(cur.firstIndex == prev.firstIndex + prev.indexCount);
+        assert(cur.indexCount <= prev.indexCount / 2 + 3 && cur.indexCount < prev.indexCount * 9 / 10);
+        assert(cur.error >= prev.error && cur.error <= 0.05f + 1e-6f);
+        assert(sphereDeviation(sphere, indices + cur.firstIndex, cur.indexCount) <= 3.0f * cur.error + 1e-4f);
+    }
+    const g4f_lod_level last = g4f_lod_chain_level(chain, levels - 1);
+    assert(last.firstIndex + last.indexCount == indexCount);
+    g4f_vec3 center{};
+    float radius = 0.0f;
+    g4f_lod_chain_bounds(chain, &center, &radius);
+    assert(std::fabs(center.x) < 1e-4f && std::fabs(center.y) < 1e-4f && std::fabs(radius - 1.0f) < 1e-3f);
+
+    // A tighter error budget gives fewer levels.
+    g4f_lod_chain_desc tight = g4f_lod_chain_desc_default();
+    tight.maxError = 0.002f;
+    tight.maxLevels = 8;
+    g4f_lod_chain* tightChain = g4f_lod_chain_create(&desc, &tight);
+    const int tightLevels = g4f_lod_chain_level_count(tightChain);
+    assert(tightLevels >= 2 && g4f_lod_chain_level(tightChain, tightLevels - 1).error <= 0.002f);
+    g4f_lod_chain_destroy(tightChain);
+    g4f_lod_chain_destroy(chain);
+}
+
+static void testSelectionWithHysteresis() {
+    const Mesh sphere = makeSphere(64, 64);
+    const g4f_lod_mesh_desc desc = sphere.desc();
+    g4f_lod_chain* chain = g4f_lod_chain_create(&desc, nullptr);
+    const int levels = g4f_lod_chain_level_count(chain);
+    assert(levels >= 3);
+
+    g4f_camera_fps cam = g4f_camera_fps_default();
+    cam.fovYRadians = 1.2f;
+    g4f_lod_view view = g4f_lod_view_from_camera(&cam, 1080, 1.0f);
+    assert(std::fabs(view.pixelScale - 1080.0f / (2.0f * std::tan(0.6f))) < 1e-2f);
+
+    // Level grows with distance and reaches the coarsest level far away; full detail up close.
+    int previous = 0;
+    for (float d = 1.01f; d < 10000.0f; d *= 1.1f) {
+        view.eye = g4f_vec3{0.0f, 0.0f, -d};
+        const int level = g4f_lod_select(chain, &view, nullptr, -1);
+        assert(level >= previous);
+        previous = level;
+    }
+    assert(previous == levels - 1);
+    view.eye = g4f_vec3{0.0f, 0.0f, -1.01f};
+    assert(g4f_lod_select(chain, &view, nullptr, -1) == 0);
+
+    // Distance from the surface where level 1 projects to exactly 1 pixel; at f times that
+    // distance it projects to 1 / f pixels.
+    const float switchDistance = g4f_lod_chain_level(chain, 1).error * view.pixelScale;
+    auto eyeAt = [&](float f) { return g4f_vec3{0.0f, 0.0f, -1.0f - switchDistance * f}; };
+    int flipsWithout = 0, flipsWith = 0;
+    int stateless = -1, state = 0;
+    for (int frame = 0; frame < 100; frame++) {
+        view.eye = eyeAt(frame % 2 ? 1.05f : 0.95f);
+        const int a = g4f_lod_select(chain, &view, nullptr, -1);
+        const int b = g4f_lod_select(chain, &view, nullptr, state);
+        flipsWithout += frame > 0 && a != stateless;
+        flipsWith += b != state;
+        stateless = a;
+        state = b;
+    }
+    assert(flipsWithout == 99 && flipsWith == 0 && state == 0);
+    // Well past the band the level does change, and coming back needs the finer side of the band.
+    view.eye = eyeAt(1.4f);
+    assert(g4f_lod_select(chain, &view, nullptr, 0) >= 1);
+    view.eye = eyeAt(0.9f);
+    assert(g4f_lod_select(chain, &view, nullptr, 1) == 1);
+    view.eye = eyeAt(0.7f);
+    assert(g4f_lod_select(chain, &view, nullptr, 1) == 0);
+
+    // A model scaled 4x looks like the unscaled one from 4x the distance.
+    const g4f_mat4 big = g4f_mat4_trs(g4f_vec3{0.0f, 0.0f, 0.0f}, g4f_quat_identity(), g4f_vec3{4.0f, 4.0f, 4.0f});
+    for (float d : {3.0f, 30.0f, 300.0f}) {
+        view.eye = g4f_vec3{0.0f, 0.0f, -d};
+        const int small = g4f_lod_select(chain, &view, nullptr, -1);
+        view.eye = g4f_vec3{0.0f, 0.0f, -4.0f * d};
+        assert(g4f_lod_select(chain, &view, &big, -1) == small);
+    }
+    g4f_lod_chain_destroy(chain);
+}
+
+static void testSceneDrawsPickLevels() {
+    const Mesh sphere = makeSphere(64, 64);
+    const g4f_lod_mesh_desc desc = sphere.desc();
+    g4f_lod_chain* chain = g4f_lod_chain_create(&desc, nullptr);
+    const int levels = g4f_lod_chain_level_count(chain);
+
+    g4f_scene* scene = g4f_scene_create(0);
+    const auto* mesh = reinterpret_cast<const g4f_gfx_mesh*>(chain); // any non-null pointer
+    const auto* material = reinterpret_cast<const g4f_gfx_material*>(&desc);
+    g4f_scene_node nodes[3];
+    for (int i = 0; i < 3; i++) {
+        nodes[i] = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+        g4f_scene_set_translation(scene, nodes[i], g4f_vec3{0.0f, 0.0f, (float)i * 2000.0f});
+        g4f_scene_set_renderable(scene, nodes[i], mesh, material);
+        if (i < 2) g4f_scene_set_lod(scene, nodes[i], chain);
+    }
+    const g4f_mat4 viewProj = g4f_mat4_identity();
+    // Without a view every draw is level 0.
+    int count = g4f_scene_build_draws(scene, &viewProj, nullptr);
+    const g4f_scene_draw* draws = g4f_scene_draws(scene, nullptr);
+    for (int i = 0; i < count; i++) assert(draws[i].lod == 0);
+
+    g4f_camera_fps cam = g4f_camera_fps_default();
+    cam.position = g4f_vec3{0.0f, 0.0f, -1.1f};
+    const g4f_lod_view view = g4f_lod_view_from_camera(&cam, 1080, 1.0f);
+    g4f_scene_set_lod_view(scene, &view);
+    count = g4f_scene_build_draws(scene, &viewProj, nullptr);
+    draws = g4f_scene_draws(scene, nullptr);
+    assert(count == 3);
+    for (int i = 0; i < count; i++) {
+        if (draws[i].node == nodes[0]) assert(draws[i].lod == 0);
+        if (draws[i].node == nodes[1]) assert(draws[i].lod == levels - 1);
+        if (draws[i].node == nodes[2]) assert(draws[i].lod == 0); // no chain
+    }
+    // The per-node state survives a layout rebuild.
+    g4f_scene_node extra = g4f_scene_node_create(scene, nodes[0]);
+    g4f_scene_set_parent(scene, nodes[1], extra);
+    count = g4f_scene_build_draws(scene, &viewProj, nullptr);
+    draws = g4f_scene_draws(scene, nullptr);
+    for (int i = 0; i < count; i++) {
+        if (draws[i].node == nodes[1]) assert(draws[i].lod == levels - 1);
+    }
+    g4f_scene_set_lod_view(scene, nullptr);
+    g4f_scene_build_draws(scene, &viewProj, nullptr);
+    for (int i = 0; i < count; i++) assert(g4f_scene_draws(scene, nullptr)[i].lod == 0);
+    g4f_scene_destroy(scene);
+    g4f_lod_chain_destroy(chain);
+}
+
+static void testInvalidInput() {
+    uint32_t out[3];
+    assert(g4f_lod_simplify(nullptr, 0, 0.0f, out, nullptr) == -1);
+    const g4f_vec3 p[3] = {{0, 0, 0}, {1, 0, 0}, {0, 1, 0}};
+    const uint32_t bad[3] = {0, 1, 3};
+    g4f_lod_mesh_desc d = g4f_lod_mesh_desc_default();
+    d.positions = p;
+    d.vertexCount = 3;
+    d.indices32 = bad;
+    d.indexCount = 3;
+    assert(g4f_lod_simplify(&d, 0, 0.0f, out, nullptr) == -1);
+    assert(g4f_lod_chain_create(&d, nullptr) == nullptr);
+    const uint16_t good[3] = {0, 1, 2};
+    d.indices32 = nullptr;
+    d.indices16 = good;
+    assert(g4f_lod_simplify(&d, 3, 0.0f, out, nullptr) == 3);
+    g4f_lod_chain* single = g4f_lod_chain_create(&d, nullptr);
+    assert(g4f_lod_chain_level_count(single) == 1 && g4f_lod_select(single, nullptr, nullptr, 0) == 0);
+    g4f_lod_chain_destroy(single);
+    assert(g4f_lod_chain_level_count(nullptr) == 0 && g4f_lod_select(nullptr, nullptr, nullptr, -1) == 0);
+    g4f_lod_chain_destroy(nullptr);
+}
+
+int main() {
+    testSimplifyHitsTargets();
+    testSimplifyRespectsMaxError();
+    testPlaneCollapsesLosslessly();
+    testSeamsStayPut();
+    testChain();
+    testSelectionWithHysteresis();
+    testSceneDrawsPickLevels();
+    testInvalidInput();
+    std::printf("lod_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,148 @@
+#include <cassert>
+#include <cstdio>
+#include <set>
+
+#include "g4f/g4f_material_key.h"
+
+static g4f_material_state opaqueDefaults() {
+    g4f_material_state s{};
+    s.depthTest = 1;
+    s.depthWrite = 1;
+    return s;
+}
+
+static void testRoundTripAndShaderBits() {
+    g4f_material_state s = opaqueDefaults();
+    s.lit = 1;
+    s.textured = 1;
+    s.alphaTest = 1;
+    s.clustered = 1;
+    s.cullMode = 2;
+    s.samplerFilter = G4F_GFX_FILTER_ANISOTROPIC;
+    s.samplerAddress = G4F_GFX_ADDRESS_WRAP;
+    uint32_t key = g4f_material_key_make(&s);
+
+    g4f_material_state u{};
+    g4f_material_key_unpack(key, &u);
+    assert(u.lit == 1 && u.textured == 1 && u.alphaTest == 1 && u.clustered == 1 && u.alphaBlend == 0);
+    assert(u.depthTest == 1 && u.depthWrite == 1 && u.cullMode == 2);
+    assert(u.samplerFilter == G4F_GFX_FILTER_ANISOTROPIC && u.samplerAddress == G4F_GFX_ADDRESS_WRAP);
+    assert(g4f_material_key_make(&u) == key);
+
+    assert(g4f_material_key_shader(key) ==
+           (G4F_MATERIAL_SHADER_LIT | G4F_MATERIAL_SHADER_TEXTURED | G4F_MATERIAL_SHADER_ALPHA_TEST | G4F_MATERIAL_SHADER_CLUSTERED));
+    s.lit = 0;
+    s.alphaTest = 0;
+    assert(g4f_material_key_shader(g4f_material_key_make(&s)) == G4F_MATERIAL_SHADER_TEXTURED); // clustered needs lit
+}
+
+static void testNormalization() {
+    // Depth write without depth test renders like depth off.
+    g4f_material_state a = opaqueDefaults();
+    a.depthTest = 0;
+    g4f_material_state b = a;
+    b.depthWrite = 0;
+    assert(g4f_material_key_make(&a) == g4f_material_key_make(&b));
+
+    // Untextured materials ignore the sampler; textured ones do not.
+    g4f_material_state c = opaqueDefaults();
+    g4f_material_state d = c;
+    d.samplerFilter = G4F_GFX_FILTER_POINT;
+    d.samplerAddress = G4F_GFX_ADDRESS_WRAP;
+    assert(g4f_material_key_make(&c) == g4f_material_key_make(&d));
+    c.textured = d.textured = 1;
+    assert(g4f_material_key_make(&c) != g4f_material_key_make(&d));
+
+    // Out-of-range inputs clamp instead of bleeding into other fields; non-zero bools are 1.
+    g4f_material_state e = opaqueDefaults();
+    e.cullMode = 7;
+    e.lit = 42;
+    g4f_material_state f = opaqueDefaults();
+    f.cullMode = 2;
+    f.lit = 1;
+    assert(g4f_material_key_make(&e) == g4f_material_key_make(&f));
+    e.cullMode = -3;
+    f.cullMode = 0;
+    assert(g4f_material_key_make(&e) == g4f_material_key_make(&f));
+}
+
+static void testAllNormalizedKeysFitTable() {
+    std::set<uint32_t> keys;
+    for (int bits = 0; bits < 128; bits++) {
+        for (int cull = 0; cull < 3; cull++) {
+            for (int filter = 0; filter < 3; filter++) {
+                for (int address = 0; address < 2; address++) {
+                    g4f_material_state s{};
+                    s.lit = bits & 1;
+                    s.textured = (bits >> 1) & 1;
+                    s.alphaTest = (bits >> 2) & 1;
+                    s.alphaBlend = (bits >> 3) & 1;
+                    s.depthTest = (bits >> 4) & 1;
+                    s.depthWrite = (bits >> 5) & 1;
+                    s.clustered = (bits >> 6) & 1;
+                    s.cullMode = cull;
+                    s.samplerFilter = filter;
+                    s.samplerAddress = address;
+                    keys.insert(g4f_material_key_make(&s));
+                }
+            }
+        }
+    }
+    // (unlit, lit, lit + clustered) 3 * alphaTest 2 * blend 2 * depth 3 * cull 3 * (1 untextured + 6 textured samplers)
+    assert(keys.size() == 756);
+    assert((int)keys.size() <= G4F_MATERIAL_BUNDLE_MAX);
+
+    g4f_material_bundle_table table;
+    g4f_material_bundle_table_reset(&table);
+    int expectedId = 0;
+    for (uint32_t key : keys) {
+        int added = 0;
+        assert(g4f_material_bundle_table_intern(&table, key, &added) == expectedId++);
+        assert(added == 1);
+    }
+    assert(table.count == 756);
+}
+
+static void testDedupAssignsStableIds() {
+    g4f_material_bundle_table table;
+    g4f_material_bundle_table_reset(&table);
+
+    g4f_material_state opaque = opaqueDefaults();
+    g4f_material_state blended = opaque;
+    blended.alphaBlend = 1;
+    blended.depthWrite = 0;
+
+    int added = 0;
+    int idOpaque = g4f_material_bundle_table_intern(&table, g4f_material_key_make(&opaque), &added);
+    assert(idOpaque == 0 && added == 1);
+    int idBlend = g4f_material_bundle_table_intern(&table, g4f_material_key_make(&blended), &added);
+    assert(idBlend == 1 && added == 1);
+
+    // 1000 materials over the same two states only ever produce two bundles.
+    for (int i = 0; i < 1000; i++) {
+        const g4f_material_state& s = (i % 3) ? opaque : blended;
+        int id = g4f_material_bundle_table_intern(&table, g4f_material_key_make(&s), &added);
+        assert(added == 0);
+        assert(id == ((i % 3) ? idOpaque : idBlend));
+    }
+    assert(table.count == 2);
+    assert(g4f_material_bundle_table_find(&table, g4f_material_key_make(&blended)) == idBlend);
+    g4f_material_state lit = opaque;
+    lit.lit = 1;
+    assert(g4f_material_bundle_table_find(&table, g4f_material_key_make(&lit)) == -1);
+
+    // Full table rejects new keys but still resolves known ones.
+    for (int i = table.count; i < G4F_MATERIAL_BUNDLE_MAX; i++) table.keys[i] = 0x100000u + (uint32_t)i;
+    table.count = G4F_MATERIAL_BUNDLE_MAX;
+    assert(g4f_material_bundle_table_intern(&table, 0xFFFFFu, &added) == -1 && added == 0);
+    assert(g4f_material_bundle_table_intern(&table, g4f_material_key_make(&opaque), &added) == idOpaque);
+}
+
+int main() {
+    testRoundTripAndShaderBits();
+    testNormalization();
+    testAllNormalizedKeysFitTable();
+    testDedupAssignsStableIds();
+    std::printf("material_key_tests: OK\n");
+    return 0;
+}
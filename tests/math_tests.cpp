@@ -1,6 +1,8 @@
 #include <cassert>
 #include <cmath>
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #include "g4f/g4f.h"
 
@@ -83,6 +85,167 @@ static void testLookAtOrthonormal() {
     assert(std::fabs(dot(upVec, forward)) < 1e-3f);
 }
 
+static float applyX(const g4f_mat4& m, g4f_vec3 p, int col) {
+    return p.x * m.m[col] + p.y * m.m[4 + col] + p.z * m.m[8 + col] + m.m[12 + col];
+}
+
+static void testInverse() {
+    g4f_mat4 v = g4f_mat4_look_at(g4f_vec3{3.0f, 2.0f, -5.0f}, g4f_vec3{0.0f, 0.5f, 1.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 p = g4f_mat4_perspective(1.2f, 1.5f, 0.1f, 100.0f);
+    g4f_mat4 m = g4f_mat4_mul(g4f_mat4_mul(g4f_mat4_scale(2.0f, 1.0f, 0.5f), v), p);
+    g4f_mat4 r = g4f_mat4_mul(m, g4f_mat4_inverse(m));
+    for (int i = 0; i < 16; i++) assert(feq(r.m[i], (i % 5 == 0) ? 1.0f : 0.0f, 1e-4f));
+
+    g4f_mat4 singular{};
+    g4f_mat4 si = g4f_mat4_inverse(singular);
+    for (int i = 0; i < 16; i++) assert(feq(si.m[i], (i % 5 == 0) ? 1.0f : 0.0f));
+}
+
+static void testCascadeSplits() {
+    float uni[5], lg[5], mid[5];
+    g4f_shadow_cascade_splits(0.1f, 100.0f, 4, 0.0f, uni);
+    g4f_shadow_cascade_splits(0.1f, 100.0f, 4, 1.0f, lg);
+    g4f_shadow_cascade_splits(0.1f, 100.0f, 4, 0.75f, mid);
+    assert(uni[0] == 0.1f && uni[4] == 100.0f && lg[0] == 0.1f && lg[4] == 100.0f);
+    assert(feq(uni[2], 50.05f, 1e-3f));
+    assert(feq(lg[2], std::sqrt(0.1f * 100.0f), 1e-3f));
+    for (int i = 1; i <= 4; i++) {
+        assert(mid[i] > mid[i - 1]);
+        assert(mid[i] >= lg[i] - 1e-4f && mid[i] <= uni[i] + 1e-4f);
+    }
+}
+
+// World-space point at NDC (x, y) and view distance d, built from the projection coefficients
+// (independent of the unprojection used by the fit).
+static g4f_vec3 frustumPoint(const g4f_mat4& invView, const g4f_mat4& proj, float x, float y, float d) {
+    float w = d; // |view z| == clip w for either projection handedness
+    g4f_vec3 pv{x * w / proj.m[0], y * w / proj.m[5], proj.m[11] >= 0.0f ? d : -d};
+    return g4f_vec3{applyX(invView, pv, 0), applyX(invView, pv, 1), applyX(invView, pv, 2)};
+}
+
+static void testCascadeFitCoversFrustum() {
+    g4f_mat4 view = g4f_mat4_look_at(g4f_vec3{4.0f, 3.0f, -6.0f}, g4f_vec3{0.0f, 0.0f, 2.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 proj = g4f_mat4_perspective(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    g4f_mat4 invView = g4f_mat4_inverse(view);
+    float splits[5];
+    g4f_shadow_cascade_splits(0.1f, 60.0f, 4, 0.8f, splits);
+    g4f_shadow_cascade cascades[4];
+    assert(g4f_shadow_cascades_fit(&view, &proj, g4f_vec3{-0.4f, -1.0f, -0.2f}, splits, 4, 1024, 20.0f, cascades) == 1);
+
+    for (int c = 0; c < 4; c++) {
+        const g4f_shadow_cascade& sc = cascades[c];
+        assert(sc.splitNear == splits[c] && sc.splitFar == splits[c + 1]);
+        assert(feq(sc.texelWorldSize, 2.0f * sc.radius / 1024.0f));
+        if (c > 0) assert(sc.radius > cascades[c - 1].radius);
+        for (int i = 0; i < 125; i++) {
+            float fx = (float)(i % 5) / 2.0f - 1.0f;
+            float fy = (float)((i / 5) % 5) / 2.0f - 1.0f;
+            float d = sc.splitNear + (sc.splitFar - sc.splitNear) * (float)(i / 25) / 4.0f;
+            g4f_vec3 p = frustumPoint(invView, proj, fx, fy, d);
+            float x = applyX(sc.viewProj, p, 0), y = applyX(sc.viewProj, p, 1), z = applyX(sc.viewProj, p, 2);
+            assert(std::fabs(x) <= 1.0001f && std::fabs(y) <= 1.0001f);
+            assert(z >= 0.0f && z <= 1.0001f);
+        }
+    }
+
+    float zero[2] = {1.0f, 2.0f};
+    assert(g4f_shadow_cascades_fit(&view, &proj, g4f_vec3{0.0f, 0.0f, 0.0f}, zero, 1, 1024, 0.0f, cascades) == 0);
+    assert(g4f_shadow_cascades_fit(&view, &proj, g4f_vec3{0.0f, -1.0f, 0.0f}, zero, 5, 1024, 0.0f, cascades) == 0);
+}
+
+static void testCascadeFitIsStable() {
+    g4f_mat4 proj = g4f_mat4_perspective(1.2f, 1.6f, 0.1f, 100.0f);
+    const g4f_vec3 lightDir{-0.3f, -1.0f, 0.4f};
+    const float splits[2] = {2.0f, 12.0f};
+    g4f_shadow_cascade a{}, b{}, c{};
+    g4f_mat4 va = g4f_mat4_look_at(g4f_vec3{0.0f, 2.0f, 0.0f}, g4f_vec3{0.0f, 2.0f, 1.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 vb = g4f_mat4_look_at(g4f_vec3{0.37f, 2.11f, 0.05f}, g4f_vec3{0.37f, 2.11f, 1.05f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 vc = g4f_mat4_look_at(g4f_vec3{0.0f, 2.0f, 0.0f}, g4f_vec3{1.0f, 2.3f, 0.4f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    assert(g4f_shadow_cascades_fit(&va, &proj, lightDir, splits, 1, 2048, 10.0f, &a) == 1);
+    assert(g4f_shadow_cascades_fit(&vb, &proj, lightDir, splits, 1, 2048, 10.0f, &b) == 1);
+    assert(g4f_shadow_cascades_fit(&vc, &proj, lightDir, splits, 1, 2048, 10.0f, &c) == 1);
+
+    // Turning or moving the camera keeps the projection size, and translations move it by whole texels.
+    assert(a.radius == b.radius && a.radius == c.radius);
+    for (int col = 0; col < 2; col++) {
+        float shiftTexels = (a.viewProj.m[12 + col] - b.viewProj.m[12 + col]) * a.radius / a.texelWorldSize;
+        assert(std::fabs(shiftTexels - std::round(shiftTexels)) < 1e-2f);
+    }
+
+    // Same inputs, same bits.
+    g4f_shadow_cascade again{};
+    assert(g4f_shadow_cascades_fit(&va, &proj, lightDir, splits, 1, 2048, 10.0f, &again) == 1);
+    for (int i = 0; i < 16; i++) assert(again.viewProj.m[i] == a.viewProj.m[i]);
+}
+
+static void testCasterCulling() {
+    g4f_mat4 view = g4f_mat4_look_at(g4f_vec3{0.0f, 2.0f, 0.0f}, g4f_vec3{0.0f, 1.5f, 1.0f}, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_mat4 proj = g4f_mat4_perspective(70.0f * 3.14159265f / 180.0f, 16.0f / 9.0f, 0.1f, 100.0f);
+    float splits[5];
+    g4f_shadow_cascade_splits(0.1f, 60.0f, 4, 0.8f, splits);
+    g4f_shadow_cascade cascades[4];
+    const g4f_vec3 lightDir{0.2f, -1.0f, 0.1f};
+    assert(g4f_shadow_cascades_fit(&view, &proj, lightDir, splits, 4, 1024, 30.0f, cascades) == 1);
+
+    // 100x100 crates over a 600 m square level: most are nowhere near the cascades.
+    const int side = 100;
+    std::vector<float> spheres((size_t)side * side * 4);
+    for (int i = 0; i < side * side; i++) {
+        spheres[(size_t)i * 4 + 0] = -300.0f + 6.0f * (float)(i % side);
+        spheres[(size_t)i * 4 + 1] = 0.5f;
+        spheres[(size_t)i * 4 + 2] = -300.0f + 6.0f * (float)(i / side);
+        spheres[(size_t)i * 4 + 3] = 0.9f;
+    }
+    std::vector<uint8_t> masks((size_t)side * side);
+    int draws = g4f_shadow_cascades_cull(cascades, 4, spheres.data(), side * side, masks.data());
+    assert(draws > 0 && draws < side * side * 4 / 20);
+    int counted = 0;
+    for (uint8_t m : masks) {
+        for (int c = 0; c < 4; c++) counted += (m >> c) & 1;
+    }
+    assert(counted == draws);
+
+    // A tall caster above the first cascade (towards the light) still shadows it; one deep below does not.
+    const g4f_vec3 mid = cascades[0].center;
+    float above[4] = {mid.x - lightDir.x * 40.0f, mid.y - lightDir.y * 40.0f, mid.z - lightDir.z * 40.0f, 1.0f};
+    float below[4] = {mid.x + lightDir.x * 80.0f, mid.y + lightDir.y * 80.0f, mid.z + lightDir.z * 80.0f, 1.0f};
+    uint8_t mask = 0;
+    g4f_shadow_cascades_cull(cascades, 1, above, 1, &mask);
+    assert(mask == 1);
+    g4f_shadow_cascades_cull(cascades, 1, below, 1, &mask);
+    assert(mask == 0);
+}
+
+static void testQuatRotations() {
+    const float a = 0.7f;
+    g4f_mat4 qz = g4f_quat_to_mat4(g4f_quat_from_axis_angle(g4f_vec3{0.0f, 0.0f, 2.0f}, a));
+    g4f_mat4 rz = g4f_mat4_rotation_z(a);
+    for (int k = 0; k < 16; k++) assert(feq(qz.m[k], rz.m[k]));
+
+    // Composition matches the matrix product: rotate by b first (row vectors: Mb * Ma).
+    g4f_quat qa = g4f_quat_from_axis_angle(g4f_vec3{1.0f, 0.0f, 0.0f}, 0.4f);
+    g4f_quat qb = g4f_quat_from_axis_angle(g4f_vec3{0.0f, 1.0f, 1.0f}, -1.1f);
+    g4f_mat4 composed = g4f_quat_to_mat4(g4f_quat_mul(qa, qb));
+    g4f_mat4 product = g4f_mat4_mul(g4f_quat_to_mat4(qb), g4f_quat_to_mat4(qa));
+    for (int k = 0; k < 16; k++) assert(feq(composed.m[k], product.m[k]));
+
+    g4f_quat n = g4f_quat_normalize(g4f_quat{0.0f, 0.0f, 0.0f, 4.0f});
+    assert(feq(n.w, 1.0f));
+    n = g4f_quat_normalize(g4f_quat{0.0f, 0.0f, 0.0f, 0.0f});
+    assert(feq(n.w, 1.0f));
+    g4f_quat degenerate = g4f_quat_from_axis_angle(g4f_vec3{0.0f, 0.0f, 0.0f}, 1.0f);
+    assert(feq(degenerate.w, 1.0f));
+}
+
+static void testTrsMatchesProduct() {
+    g4f_vec3 t{1.0f, -2.0f, 3.5f};
+    g4f_vec3 sc{2.0f, 0.5f, 3.0f};
+    g4f_quat q = g4f_quat_from_axis_angle(g4f_vec3{0.3f, 1.0f, -0.2f}, 0.9f);
+    g4f_mat4 trs = g4f_mat4_trs(t, q, sc);
+    g4f_mat4 ref = g4f_mat4_mul(g4f_mat4_mul(g4f_mat4_scale(sc.x, sc.y, sc.z), g4f_quat_to_mat4(q)), g4f_mat4_translation(t.x, t.y, t.z));
+    for (int k = 0; k < 16; k++) assert(feq(trs.m[k], ref.m[k]));
+}
+
 int main() {
     testIdentity();
     testMulIdentity();
@@ -91,6 +254,13 @@ int main() {
     testRotationZShape();
     testPerspectiveShape();
     testLookAtOrthonormal();
+    testInverse();
+    testCascadeSplits();
+    testCascadeFitCoversFrustum();
+    testCascadeFitIsStable();
+    testCasterCulling();
+    testQuatRotations();
+    testTrsMatchesProduct();
     std::cout << "math_tests: OK\n";
     return 0;
 }
@@ -0,0 +1,141 @@
+#include <cassert>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_mipgen.h"
+
+static void testLevelSizes() {
+    assert(g4f_mipgen_level_count(1, 1) == 1);
+    assert(g4f_mipgen_level_count(256, 256) == 9);
+    assert(g4f_mipgen_level_count(256, 16) == 9);
+    assert(g4f_mipgen_level_count(5, 3) == 3);
+    assert(g4f_mipgen_level_count(0, 4) == 0);
+
+    int w = 0, h = 0;
+    g4f_mipgen_level_size(256, 16, 4, &w, &h);
+    assert(w == 16 && h == 1);
+    g4f_mipgen_level_size(256, 16, 8, &w, &h);
+    assert(w == 1 && h == 1);
+    g4f_mipgen_level_size(5, 3, 1, &w, &h);
+    assert(w == 2 && h == 1);
+
+    assert(g4f_mipgen_chain_bytes(4, 4, 3) == (16 + 4 + 1) * 4);
+}
+
+static void testBoxAveragesQuads() {
+    // Linear data: each output texel must be the exact 2x2 mean.
+    const int w = 8, h = 6;
+    std::vector<uint8_t> src((size_t)w * h * 4);
+    for (size_t i = 0; i < src.size(); i++) src[i] = (uint8_t)((i * 37u + 11u) & 0xFCu); // multiples of 4
+    std::vector<uint8_t> dst((size_t)(w / 2) * (h / 2) * 4);
+    assert(g4f_mipgen_downsample_rgba8(src.data(), w, h, 0, dst.data(), w / 2, h / 2, 0,
+                                       G4F_MIPGEN_FILTER_BOX, G4F_MIPGEN_FLAG_LINEAR, nullptr) == 1);
+    for (int y = 0; y < h / 2; y++) {
+        for (int x = 0; x < w / 2; x++) {
+            for (int c = 0; c < 4; c++) {
+                int sum = 0;
+                for (int dy = 0; dy < 2; dy++)
+                    for (int dx = 0; dx < 2; dx++) sum += src[((size_t)(y * 2 + dy) * w + (x * 2 + dx)) * 4 + c];
+                assert(dst[((size_t)y * (w / 2) + x) * 4 + c] == sum / 4);
+            }
+        }
+    }
+}
+
+static void testConstantImagePreserved() {
+    // Every sRGB code must survive decode -> filter -> encode, for both filters and edge modes.
+    const int w = 16, h = 16;
+    std::vector<uint8_t> src((size_t)w * h * 4);
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(w, h, 5));
+    for (int v = 0; v < 256; v++) {
+        for (size_t i = 0; i < src.size(); i += 4) {
+            src[i + 0] = (uint8_t)v;
+            src[i + 1] = (uint8_t)(255 - v);
+            src[i + 2] = (uint8_t)(v / 2);
+            src[i + 3] = (uint8_t)v;
+        }
+        for (int filter = G4F_MIPGEN_FILTER_BOX; filter <= G4F_MIPGEN_FILTER_KAISER; filter++) {
+            assert(g4f_mipgen_build_chain_rgba8(src.data(), w, h, 0, 0, filter, v & 1 ? G4F_MIPGEN_FLAG_WRAP : 0,
+                                                nullptr, chain.data()) == 5);
+            for (size_t i = 0; i < chain.size(); i += 4) assert(std::memcmp(&chain[i], &src[0], 4) == 0);
+        }
+    }
+}
+
+static void testGammaCorrectAverage() {
+    // A black/white checker must average to linear 0.5 (sRGB ~188), not to 128.
+    const int w = 4, h = 4;
+    std::vector<uint8_t> src((size_t)w * h * 4);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            uint8_t v = ((x + y) & 1) ? 255 : 0;
+            uint8_t* p = &src[((size_t)y * w + x) * 4];
+            p[0] = p[1] = p[2] = v;
+            p[3] = v;
+        }
+    }
+    uint8_t dst[4 * 4];
+    assert(g4f_mipgen_downsample_rgba8(src.data(), w, h, 0, dst, 2, 2, 0, G4F_MIPGEN_FILTER_BOX, 0, nullptr) == 1);
+    for (int i = 0; i < 4; i++) {
+        assert(std::abs((int)dst[i * 4 + 0] - 188) <= 1);
+        assert(std::abs((int)dst[i * 4 + 3] - 128) <= 1); // alpha is always linear
+    }
+    assert(g4f_mipgen_downsample_rgba8(src.data(), w, h, 0, dst, 2, 2, 0,
+                                       G4F_MIPGEN_FILTER_BOX, G4F_MIPGEN_FLAG_LINEAR, nullptr) == 1);
+    for (int i = 0; i < 4; i++) assert(std::abs((int)dst[i * 4 + 0] - 128) <= 1);
+}
+
+static void testWrapVersusClamp() {
+    // A single bright column at x = 0 bleeds into the last texel only when wrapping.
+    const int w = 8, h = 1;
+    std::vector<uint8_t> src((size_t)w * 4, 0);
+    src[0] = src[1] = src[2] = src[3] = 255;
+    uint8_t clampDst[4 * 4], wrapDst[4 * 4];
+    assert(g4f_mipgen_downsample_rgba8(src.data(), w, h, 0, clampDst, 4, 1, 0,
+                                       G4F_MIPGEN_FILTER_KAISER, G4F_MIPGEN_FLAG_LINEAR, nullptr) == 1);
+    assert(g4f_mipgen_downsample_rgba8(src.data(), w, h, 0, wrapDst, 4, 1, 0,
+                                       G4F_MIPGEN_FILTER_KAISER, G4F_MIPGEN_FLAG_LINEAR | G4F_MIPGEN_FLAG_WRAP, nullptr) == 1);
+    assert(clampDst[3 * 4] == 0);
+    assert(wrapDst[3 * 4] > 0);
+    assert(clampDst[0] > 0 && wrapDst[0] > 0);
+}
+
+static void testParallelMatchesSerial() {
+    const int w = 203, h = 97; // odd sizes exercise the 3-tap box footprint
+    std::vector<uint8_t> src((size_t)w * h * 4);
+    uint32_t s = 12345u;
+    for (auto& b : src) { s = s * 1664525u + 1013904223u; b = (uint8_t)(s >> 24); }
+    const size_t bytes = g4f_mipgen_chain_bytes(w, h, g4f_mipgen_level_count(w, h));
+    std::vector<uint8_t> serial(bytes), parallel(bytes);
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    for (int filter = G4F_MIPGEN_FILTER_BOX; filter <= G4F_MIPGEN_FILTER_KAISER; filter++) {
+        int n = g4f_mipgen_build_chain_rgba8(src.data(), w, h, 0, 0, filter, 0, nullptr, serial.data());
+        assert(n == g4f_mipgen_level_count(w, h));
+        assert(g4f_mipgen_build_chain_rgba8(src.data(), w, h, 0, 0, filter, 0, jobs, parallel.data()) == n);
+        assert(serial == parallel);
+        assert(std::memcmp(serial.data(), src.data(), src.size()) == 0);
+    }
+    g4f_jobs_destroy(jobs);
+}
+
+static void testInvalidArgs() {
+    uint8_t px[16] = {};
+    assert(g4f_mipgen_downsample_rgba8(nullptr, 2, 2, 0, px, 1, 1, 0, 0, 0, nullptr) == 0);
+    assert(g4f_mipgen_downsample_rgba8(px, 2, 2, 4, px, 1, 1, 0, 0, 0, nullptr) == 0);
+    assert(g4f_mipgen_build_chain_rgba8(px, 0, 2, 0, 0, 0, 0, nullptr, px) == 0);
+    assert(g4f_last_error() && std::strstr(g4f_last_error(), "g4f_mipgen_build_chain_rgba8"));
+}
+
+int main() {
+    testLevelSizes();
+    testBoxAveragesQuads();
+    testConstantImagePreserved();
+    testGammaCorrectAverage();
+    testWrapVersusClamp();
+    testParallelMatchesSerial();
+    testInvalidArgs();
+    std::printf("mipgen_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,358 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_jobs.h"
+#include "g4f/g4f_occlusion.h"
+#include "g4f/g4f_scene.h"
+
+// Camera at the origin looking down +Z, y up; 320x192 buffer.
+static g4f_mat4 makeViewProj() {
+    return g4f_mat4_perspective(1.0f, 320.0f / 192.0f, 0.1f, 100.0f);
+}
+
+struct Mesh {
+    std::vector<g4f_vec3> positions;
+    std::vector<uint32_t> indices;
+
+    g4f_occluder occluder(int twoSided = 0, const g4f_mat4* model = nullptr) const {
+        g4f_occluder o{};
+        o.positions = positions.data();
+        o.vertexCount = (int)positions.size();
+        o.indices32 = indices.data();
+        o.indexCount = (int)indices.size();
+        o.model = model;
+        o.twoSided = twoSided;
+        return o;
+    }
+};
+
+static g4f_vec3 sub(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.x - b.x, a.y - b.y, a.z - b.z}; }
+static g4f_vec3 cross(g4f_vec3 a, g4f_vec3 b) { return g4f_vec3{a.y * b.z - a.z * b.y, a.z * b.x - a.x * b.z, a.x * b.y - a.y * b.x}; }
+static float dot(g4f_vec3 a, g4f_vec3 b) { return a.x * b.x + a.y * b.y + a.z * b.z; }
+
+// Quad p0..p3 (in order around its edge) facing `normal`: front-facing triangles wind so that
+// (b - a) x (c - a) points at the viewer.
+static void addQuad(Mesh& m, g4f_vec3 p0, g4f_vec3 p1, g4f_vec3 p2, g4f_vec3 p3, g4f_vec3 normal) {
+    const uint32_t base = (uint32_t)m.positions.size();
+    m.positions.insert(m.positions.end(), {p0, p1, p2, p3});
+    const bool flip = dot(cross(sub(p1, p0), sub(p2, p0)), normal) < 0.0f;
+    const uint32_t quad[6] = {0, 1, 2, 0, 2, 3};
+    for (int i = 0; i < 6; i++) {
+        uint32_t k = quad[i];
+        if (flip && (i % 3) != 0) k = quad[i - (i % 3) + 3 - (i % 3)];
+        m.indices.push_back(base + k);
+    }
+}
+
+static void addBox(Mesh& m, g4f_vec3 lo, g4f_vec3 hi) {
+    addQuad(m, {lo.x, lo.y, lo.z}, {lo.x, hi.y, lo.z}, {hi.x, hi.y, lo.z}, {hi.x, lo.y, lo.z}, {0, 0, -1});
+    addQuad(m, {lo.x, lo.y, hi.z}, {lo.x, hi.y, hi.z}, {hi.x, hi.y, hi.z}, {hi.x, lo.y, hi.z}, {0, 0, 1});
+    addQuad(m, {lo.x, lo.y, lo.z}, {lo.x, hi.y, lo.z}, {lo.x, hi.y, hi.z}, {lo.x, lo.y, hi.z}, {-1, 0, 0});
+    addQuad(m, {hi.x, lo.y, lo.z}, {hi.x, hi.y, lo.z}, {hi.x, hi.y, hi.z}, {hi.x, lo.y, hi.z}, {1, 0, 0});
+    addQuad(m, {lo.x, lo.y, lo.z}, {hi.x, lo.y, lo.z}, {hi.x, lo.y, hi.z}, {lo.x, lo.y, hi.z}, {0, -1, 0});
+    addQuad(m, {lo.x, hi.y, lo.z}, {hi.x, hi.y, lo.z}, {hi.x, hi.y, hi.z}, {lo.x, hi.y, hi.z}, {0, 1, 0});
+}
+
+// 4x4 wall at z = 5 facing the camera.
+static Mesh makeWall(bool facingAway) {
+    Mesh m;
+    addQuad(m, {-2, -2, 5}, {-2, 2, 5}, {2, 2, 5}, {2, -2, 5}, {0, 0, facingAway ? 1.0f : -1.0f});
+    return m;
+}
+
+static g4f_aabb box(float x0, float y0, float z0, float x1, float y1, float z1) {
+    return g4f_aabb{g4f_vec3{x0, y0, z0}, g4f_vec3{x1, y1, z1}};
+}
+
+static void rasterize(g4f_occlusion* occ, const std::vector<g4f_occluder>& occluders, g4f_jobs* jobs) {
+    const g4f_mat4 viewProj = makeViewProj();
+    g4f_occlusion_begin(occ, &viewProj);
+    for (const g4f_occluder& o : occluders) assert(g4f_occlusion_add(occ, &o) == 1);
+    g4f_occlusion_end(occ, jobs);
+}
+
+static void testWallHidesBoxesBehind() {
+    g4f_occlusion* occ = g4f_occlusion_create(nullptr);
+    const Mesh wall = makeWall(false);
+    rasterize(occ, {wall.occluder()}, nullptr);
+
+    int w = 0, h = 0;
+    const float* depth = g4f_occlusion_depth(occ, &w, &h);
+    assert(w == 320 && h == 192);
+    assert(std::fabs(depth[(h / 2) * w + w / 2] - 0.2f) < 1e-5f); // 1 / w at the wall
+    assert(depth[0] == 0.0f && depth[w * h - 1] == 0.0f);
+
+    const g4f_aabb behind = box(-0.5f, -0.5f, 8, 0.5f, 0.5f, 9);
+    assert(g4f_occlusion_test_box(occ, &behind, nullptr) == 0);
+    const g4f_aabb inFront = box(-0.5f, -0.5f, 3, 0.5f, 0.5f, 4);
+    assert(g4f_occlusion_test_box(occ, &inFront, nullptr) == 1);
+    const g4f_aabb straddling = box(-0.5f, -0.5f, 4, 0.5f, 0.5f, 9); // pokes through the wall
+    assert(g4f_occlusion_test_box(occ, &straddling, nullptr) == 1);
+    const g4f_aabb pastEdge = box(3.0f, -0.5f, 8, 4.0f, 0.5f, 9); // partly outside the wall's silhouette
+    assert(g4f_occlusion_test_box(occ, &pastEdge, nullptr) == 1);
+    const g4f_aabb beside = box(4.0f, -0.5f, 8, 5.0f, 0.5f, 9);
+    assert(g4f_occlusion_test_box(occ, &beside, nullptr) == 1);
+    const g4f_aabb bigBehind = box(-40.0f, -40.0f, 60, 40.0f, 40.0f, 61); // covers more than the wall
+    assert(g4f_occlusion_test_box(occ, &bigBehind, nullptr) == 1);
+    const g4f_aabb farBehind = box(-1.0f, -1.0f, 60, 1.0f, 1.0f, 61); // coarse pyramid levels
+    assert(g4f_occlusion_test_box(occ, &farBehind, nullptr) == 0);
+
+    // Near plane and view bounds.
+    const g4f_aabb crossingNear = box(-0.5f, -0.5f, -1, 0.5f, 0.5f, 1);
+    assert(g4f_occlusion_test_box(occ, &crossingNear, nullptr) == 1);
+    const g4f_aabb behindCamera = box(-0.5f, -0.5f, -5, 0.5f, 0.5f, -4);
+    assert(g4f_occlusion_test_box(occ, &behindCamera, nullptr) == 0);
+    const g4f_aabb offScreen = box(-101.0f, -0.5f, 8, -100.0f, 0.5f, 9);
+    assert(g4f_occlusion_test_box(occ, &offScreen, nullptr) == 0);
+
+    // Model matrices move the box: the unit box at the origin translated behind the wall.
+    const g4f_aabb unit = box(-0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f);
+    const g4f_mat4 hidden = g4f_mat4_trs(g4f_vec3{0, 0, 10}, g4f_quat_identity(), g4f_vec3{1, 1, 1});
+    const g4f_mat4 shown = g4f_mat4_trs(g4f_vec3{6, 0, 10}, g4f_quat_identity(), g4f_vec3{1, 1, 1});
+    assert(g4f_occlusion_test_box(occ, &unit, &hidden) == 0);
+    assert(g4f_occlusion_test_box(occ, &unit, &shown) == 1);
+
+    g4f_occlusion_stats stats{};
+    g4f_occlusion_get_stats(occ, &stats);
+    assert(stats.occluders == 1 && stats.triangles == 2 && stats.rasterized == 2);
+    assert(stats.tiles == 10 * 6 && stats.binned >= 2);
+    g4f_occlusion_destroy(occ);
+}
+
+static void testBackFaces() {
+    g4f_occlusion* occ = g4f_occlusion_create(nullptr);
+    const Mesh away = makeWall(true);
+    const g4f_aabb behind = box(-0.5f, -0.5f, 8, 0.5f, 0.5f, 9);
+
+    rasterize(occ, {away.occluder(0)}, nullptr);
+    g4f_occlusion_stats stats{};
+    g4f_occlusion_get_stats(occ, &stats);
+    assert(stats.triangles == 2 && stats.rasterized == 0);
+    assert(g4f_occlusion_test_box(occ, &behind, nullptr) == 1);
+
+    rasterize(occ, {away.occluder(1)}, nullptr);
+    g4f_occlusion_get_stats(occ, &stats);
+    assert(stats.rasterized == 2);
+    assert(g4f_occlusion_test_box(occ, &behind, nullptr) == 0);
+
+    // A closed box occludes through its front faces only.
+    Mesh crate;
+    addBox(crate, g4f_vec3{-2, -2, 5}, g4f_vec3{2, 2, 6});
+    rasterize(occ, {crate.occluder(0)}, nullptr);
+    g4f_occlusion_get_stats(occ, &stats);
+    assert(stats.triangles == 12 && stats.rasterized <= 6);
+    assert(g4f_occlusion_test_box(occ, &behind, nullptr) == 0);
+    g4f_occlusion_destroy(occ);
+}
+
+static void testNearPlaneClipping() {
+    // A floor at y = -1 running from behind the camera to far ahead must be clipped, not dropped.
+    Mesh floor;
+    addQuad(floor, {-50, -1, -50}, {-50, -1, 50}, {50, -1, 50}, {50, -1, -50}, {0, 1, 0});
+    g4f_occlusion* occ = g4f_occlusion_create(nullptr);
+    rasterize(occ, {floor.occluder()}, nullptr);
+
+    int w = 0, h = 0;
+    const float* depth = g4f_occlusion_depth(occ, &w, &h);
+    assert(depth[(h - 1) * w + w / 2] > 0.0f); // bottom rows see the floor
+    assert(depth[0] == 0.0f);                  // top rows see the sky
+
+    const g4f_aabb under = box(-0.5f, -3, 5, 0.5f, -2, 6);
+    assert(g4f_occlusion_test_box(occ, &under, nullptr) == 0);
+    const g4f_aabb above = box(-0.5f, -1, 5, 0.5f, 0, 6); // resting on the floor
+    assert(g4f_occlusion_test_box(occ, &above, nullptr) == 1);
+    g4f_occlusion_destroy(occ);
+}
+
+static uint32_t g_rng = 7u;
+static float randf(float lo, float hi) {
+    g_rng = g_rng * 1664525u + 1013904223u;
+    return lo + (hi - lo) * (float)(g_rng >> 8) * (1.0f / 16777216.0f);
+}
+
+static Mesh makeRandomWalls(int count) {
+    Mesh m;
+    for (int i = 0; i < count; i++) {
+        const float x = randf(-30.0f, 30.0f), z = randf(2.0f, 60.0f);
+        const float sx = randf(0.2f, 6.0f), sz = randf(0.2f, 6.0f);
+        addBox(m, g4f_vec3{x, randf(-4.0f, 0.0f), z}, g4f_vec3{x + sx, randf(1.0f, 5.0f), z + sz});
+    }
+    return m;
+}
+
+static std::vector<g4f_aabb> makeRandomBoxes(int count) {
+    std::vector<g4f_aabb> boxes;
+    for (int i = 0; i < count; i++) {
+        const g4f_vec3 c{randf(-40.0f, 40.0f), randf(-4.0f, 4.0f), randf(-5.0f, 80.0f)};
+        const float e = randf(0.05f, 2.0f);
+        boxes.push_back(box(c.x - e, c.y - e, c.z - e, c.x + e, c.y + e, c.z + e));
+    }
+    return boxes;
+}
+
+static void testThreadCountDoesNotMatter() {
+    const Mesh walls = makeRandomWalls(60);
+    const std::vector<g4f_aabb> boxes = makeRandomBoxes(3000);
+    g4f_occlusion* a = g4f_occlusion_create(nullptr);
+    g4f_occlusion* b = g4f_occlusion_create(nullptr);
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    rasterize(a, {walls.occluder()}, nullptr);
+    rasterize(b, {walls.occluder()}, jobs);
+
+    int w = 0, h = 0;
+    const float* da = g4f_occlusion_depth(a, &w, &h);
+    const float* db = g4f_occlusion_depth(b, nullptr, nullptr);
+    assert(std::memcmp(da, db, sizeof(float) * (size_t)w * (size_t)h) == 0);
+    g4f_occlusion_stats sa{}, sb{};
+    g4f_occlusion_get_stats(a, &sa);
+    g4f_occlusion_get_stats(b, &sb);
+    assert(sa.rasterized == sb.rasterized && sa.binned == sb.binned && sa.triangles == 60 * 12);
+
+    std::vector<uint8_t> va(boxes.size()), vb(boxes.size());
+    const int visibleA = g4f_occlusion_test_boxes(a, boxes.data(), nullptr, (int)boxes.size(), va.data(), nullptr);
+    const int visibleB = g4f_occlusion_test_boxes(b, boxes.data(), nullptr, (int)boxes.size(), vb.data(), jobs);
+    assert(visibleA == visibleB && va == vb);
+    int hidden = 0;
+    for (size_t i = 0; i < boxes.size(); i++) {
+        assert(va[i] == g4f_occlusion_test_box(a, &boxes[i], nullptr));
+        hidden += !va[i];
+    }
+    assert(hidden > 300 && visibleA > 300); // both outcomes well represented
+
+    g4f_jobs_destroy(jobs);
+    g4f_occlusion_destroy(a);
+    g4f_occlusion_destroy(b);
+}
+
+static void testHiddenBoxesAreCovered() {
+    // Every point of a hidden box that lands on screen lies behind the depth buffer there.
+    const Mesh walls = makeRandomWalls(120);
+    const std::vector<g4f_aabb> boxes = makeRandomBoxes(2000);
+    g4f_occlusion* occ = g4f_occlusion_create(nullptr);
+    rasterize(occ, {walls.occluder()}, nullptr);
+    int w = 0, h = 0;
+    const float* depth = g4f_occlusion_depth(occ, &w, &h);
+    const g4f_mat4 viewProj = makeViewProj();
+    const float* m = viewProj.m;
+    int checked = 0;
+    for (const g4f_aabb& b : boxes) {
+        if (g4f_occlusion_test_box(occ, &b, nullptr)) continue;
+        for (int i = 0; i < 125; i++) {
+            const float fx = (float)(i % 5) / 4.0f, fy = (float)((i / 5) % 5) / 4.0f, fz = (float)(i / 25) / 4.0f;
+            const g4f_vec3 p{b.min.x + (b.max.x - b.min.x) * fx, b.min.y + (b.max.y - b.min.y) * fy, b.min.z + (b.max.z - b.min.z) * fz};
+            const float cx = p.x * m[0] + p.y * m[4] + p.z * m[8] + m[12];
+            const float cy = p.x * m[1] + p.y * m[5] + p.z * m[9] + m[13];
+            const float cw = p.x * m[3] + p.y * m[7] + p.z * m[11] + m[15];
+            if (cw <= 0.1f) continue;
+            const int px = (int)std::floor((cx / cw + 1.0f) * 0.5f * (float)w);
+            const int py = (int)std::floor((1.0f - cy / cw) * 0.5f * (float)h);
+            if (px < 0 || py < 0 || px >= w || py >= h) continue;
+            assert(depth[py * w + px] > 1.0f / cw * 0.9999f);
+            checked++;
+        }
+    }
+    assert(checked > 1000);
+    g4f_occlusion_destroy(occ);
+}
+
+static void testSceneDropsOccludedDraws() {
+    g4f_occlusion* occ = g4f_occlusion_create(nullptr);
+    const Mesh wall = makeWall(false);
+    rasterize(occ, {wall.occluder()}, nullptr);
+
+    g4f_scene* scene = g4f_scene_create(0);
+    int storage[2] = {};
+    const auto* mesh = reinterpret_cast<const g4f_gfx_mesh*>(&storage[0]); // any non-null pointer
+    const auto* material = reinterpret_cast<const g4f_gfx_material*>(&storage[1]);
+    const g4f_aabb unit = box(-0.5f, -0.5f, -0.5f, 0.5f, 0.5f, 0.5f);
+    const g4f_vec3 positions[4] = {{0, 0, 10}, {6, 0, 10}, {0, 0, 3}, {0.5f, 0, 12}};
+    g4f_scene_node nodes[4];
+    for (int i = 0; i < 4; i++) {
+        nodes[i] = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+        g4f_scene_set_translation(scene, nodes[i], positions[i]);
+        g4f_scene_set_renderable(scene, nodes[i], mesh, material);
+        if (i < 3) g4f_scene_set_bounds(scene, nodes[i], &unit); // the last node has no bounds
+    }
+    const g4f_mat4 viewProj = makeViewProj();
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 4);
+
+    g4f_scene_set_occlusion(scene, occ);
+    int count = g4f_scene_build_draws(scene, &viewProj, nullptr);
+    assert(count == 3);
+    const g4f_scene_draw* draws = g4f_scene_draws(scene, nullptr);
+    for (int i = 0; i < count; i++) assert(draws[i].node != nodes[0]);
+    g4f_scene_stats stats{};
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.occludedDraws == 1);
+
+    // Moving the node out from behind the wall brings it back; clearing bounds never culls.
+    g4f_scene_set_translation(scene, nodes[0], g4f_vec3{-7, 0, 10});
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 4);
+    g4f_scene_set_translation(scene, nodes[0], g4f_vec3{0, 0, 10});
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 3);
+    g4f_scene_set_bounds(scene, nodes[0], nullptr);
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 4);
+    g4f_scene_set_bounds(scene, nodes[0], &unit);
+    g4f_scene_set_occlusion(scene, nullptr);
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 4);
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.occludedDraws == 0);
+
+    g4f_scene_destroy(scene);
+    g4f_occlusion_destroy(occ);
+}
+
+static void testInvalidInput() {
+    g4f_occlusion_desc desc = g4f_occlusion_desc_default();
+    desc.width = 100000;
+    assert(g4f_occlusion_create(&desc) == nullptr);
+    desc.width = 100;
+    desc.height = 50;
+    g4f_occlusion* occ = g4f_occlusion_create(&desc);
+    int w = 0, h = 0;
+    g4f_occlusion_depth(occ, &w, &h);
+    assert(w == 104 && h == 56);
+
+    const Mesh wall = makeWall(false);
+    g4f_occluder bad = wall.occluder();
+    assert(g4f_occlusion_add(occ, nullptr) == 0);
+    bad.indexCount = 5;
+    assert(g4f_occlusion_add(occ, &bad) == 0);
+    bad = wall.occluder();
+    bad.indices32 = nullptr;
+    assert(g4f_occlusion_add(occ, &bad) == 0);
+    bad = wall.occluder();
+    bad.positionStride = 8;
+    assert(g4f_occlusion_add(occ, &bad) == 0);
+
+    // Out-of-range indices are skipped, the rest still rasterizes.
+    Mesh broken = wall;
+    broken.indices[0] = 99;
+    rasterize(occ, {broken.occluder()}, nullptr);
+    g4f_occlusion_stats stats{};
+    g4f_occlusion_get_stats(occ, &stats);
+    assert(stats.triangles == 2 && stats.rasterized == 1);
+
+    // An empty frame clears the buffer.
+    rasterize(occ, {}, nullptr);
+    const g4f_aabb behind = box(-0.5f, -0.5f, 8, 0.5f, 0.5f, 9);
+    assert(g4f_occlusion_test_box(occ, &behind, nullptr) == 1);
+    assert(g4f_occlusion_test_box(nullptr, &behind, nullptr) == 1);
+    assert(g4f_occlusion_test_boxes(occ, nullptr, nullptr, 3, nullptr, nullptr) == 0);
+    g4f_occlusion_destroy(occ);
+}
+
+int main() {
+    testWallHidesBoxesBehind();
+    testBackFaces();
+    testNearPlaneClipping();
+    testThreadCountDoesNotMatter();
+    testHiddenBoxesAreCovered();
+    testSceneDropsOccludedDraws();
+    testInvalidInput();
+    std::printf("occlusion_tests: OK\n");
+    return 0;
+}
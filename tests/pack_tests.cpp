@@ -0,0 +1,268 @@
+#include <cassert>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "g4f/g4f_mipgen.h"
+#include "g4f/g4f_pack.h"
+
+static std::vector<uint8_t> readFile(const std::filesystem::path& path) {
+    std::ifstream in(path, std::ios::binary);
+    return std::vector<uint8_t>(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+}
+
+static void writeFile(const std::filesystem::path& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream out(path, std::ios::binary | std::ios::trunc);
+    out.write((const char*)bytes.data(), (std::streamsize)bytes.size());
+}
+
+struct Content {
+    std::vector<g4f_gfx_vertex_p3n3uv2> vertices;
+    std::vector<uint16_t> indices;
+    std::vector<uint8_t> pixels; // 20x12 RGBA8
+    std::vector<uint8_t> bc1;    // 16x8 BC1, full chain
+    std::string text = "hello pack";
+};
+
+static Content makeContent() {
+    Content c;
+    for (int i = 0; i < 7; i++) {
+        const float f = (float)i;
+        c.vertices.push_back(g4f_gfx_vertex_p3n3uv2{f, f * 2.0f, -f, 0.0f, 1.0f, 0.0f, f * 0.1f, 1.0f - f * 0.1f});
+    }
+    c.indices = {0, 1, 2, 2, 3, 4, 4, 5, 6};
+    for (int i = 0; i < 20 * 12 * 4; i++) c.pixels.push_back((uint8_t)(i * 7));
+    c.bc1.resize(g4f_pack_texture_bytes(G4F_PACK_FORMAT_BC1, 16, 8, 5));
+    for (size_t i = 0; i < c.bc1.size(); i++) c.bc1[i] = (uint8_t)(i * 13 + 1);
+    return c;
+}
+
+static g4f_pack_writer* makeWriter(const Content& c, bool reversed) {
+    g4f_pack_writer* w = g4f_pack_writer_create();
+    auto addAll = [&](int which) {
+        if (which == 0) assert(g4f_pack_writer_add_blob(w, "config/text", c.text.data(), c.text.size()));
+        if (which == 1) assert(g4f_pack_writer_add_mesh(w, "meshes/strip", c.vertices.data(), (int)c.vertices.size(), c.indices.data(), (int)c.indices.size()));
+        if (which == 2) assert(g4f_pack_writer_add_texture_rgba8(w, "textures/wall", 20, 12, c.pixels.data(), 0, 0, G4F_MIPGEN_FILTER_BOX, 0, nullptr));
+        if (which == 3) assert(g4f_pack_writer_add_texture(w, "textures/floor_bc1", G4F_PACK_FORMAT_BC1, 16, 8, 5, c.bc1.data(), c.bc1.size()));
+        if (which == 4) assert(g4f_pack_writer_add_blob(w, "empty", nullptr, 0));
+    };
+    for (int i = 0; i < 5; i++) addAll(reversed ? 4 - i : i);
+    return w;
+}
+
+static void checkPack(const g4f_pack* pack, const Content& c) {
+    assert(g4f_pack_entry_count(pack) == 5);
+    assert(g4f_pack_find(pack, "missing") == -1 && g4f_pack_find(pack, "") == -1 && g4f_pack_find(pack, "config/tex") == -1);
+
+    // Every blob is 64-byte aligned relative to the start of the pack.
+    const uint8_t* base = nullptr;
+    for (int i = 0; i < 5; i++) {
+        g4f_pack_entry e{};
+        assert(g4f_pack_get(pack, i, &e));
+        assert(g4f_pack_find(pack, e.name) == i);
+        if (!base || (const uint8_t*)e.data < base) base = (const uint8_t*)e.data;
+    }
+    for (int i = 0; i < 5; i++) {
+        g4f_pack_entry e{};
+        g4f_pack_get(pack, i, &e);
+        assert(((const uint8_t*)e.data - base) % 64 == 0);
+    }
+
+    g4f_pack_entry e{};
+    assert(g4f_pack_get(pack, g4f_pack_find(pack, "config/text"), &e));
+    assert(e.type == G4F_PACK_ENTRY_BLOB && e.size == c.text.size() && std::memcmp(e.data, c.text.data(), e.size) == 0);
+    assert(std::strcmp(e.name, "config/text") == 0);
+
+    assert(g4f_pack_get(pack, g4f_pack_find(pack, "empty"), &e));
+    assert(e.type == G4F_PACK_ENTRY_BLOB && e.size == 0);
+
+    assert(g4f_pack_get(pack, g4f_pack_find(pack, "meshes/strip"), &e));
+    assert(e.type == G4F_PACK_ENTRY_MESH && e.vertexCount == 7 && e.indexCount == 9);
+    assert((const void*)e.vertices == e.data && ((uintptr_t)e.indices - (uintptr_t)e.data) % 16 == 0);
+    assert(std::memcmp(e.vertices, c.vertices.data(), sizeof(g4f_gfx_vertex_p3n3uv2) * 7) == 0);
+    assert(std::memcmp(e.indices, c.indices.data(), sizeof(uint16_t) * 9) == 0);
+
+    // RGBA8 texture: the writer built the same chain g4f_mipgen does.
+    assert(g4f_pack_get(pack, g4f_pack_find(pack, "textures/wall"), &e));
+    assert(e.type == G4F_PACK_ENTRY_TEXTURE && e.format == G4F_PACK_FORMAT_RGBA8 && e.width == 20 && e.height == 12);
+    assert(e.mipLevels == g4f_mipgen_level_count(20, 12) && e.mipLevels == 5);
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(20, 12, 5));
+    assert(g4f_mipgen_build_chain_rgba8(c.pixels.data(), 20, 12, 0, 5, G4F_MIPGEN_FILTER_BOX, 0, nullptr, chain.data()) == 5);
+    assert(e.size == chain.size() && std::memcmp(e.data, chain.data(), chain.size()) == 0);
+    int w = 0, h = 0, pitch = 0;
+    size_t bytes = 0;
+    const uint8_t* level0 = (const uint8_t*)g4f_pack_texture_level(&e, 0, &w, &h, &pitch, &bytes);
+    assert(level0 == e.data && w == 20 && h == 12 && pitch == 80 && bytes == 20 * 12 * 4);
+    const uint8_t* level2 = (const uint8_t*)g4f_pack_texture_level(&e, 2, &w, &h, &pitch, &bytes);
+    assert(level2 == level0 + (20 * 12 + 10 * 6) * 4 && w == 5 && h == 3 && pitch == 20 && bytes == 60);
+    assert(g4f_pack_texture_level(&e, 4, &w, &h, nullptr, nullptr) && w == 1 && h == 1);
+    assert(!g4f_pack_texture_level(&e, 5, nullptr, nullptr, nullptr, nullptr));
+
+    // BC1: pitches and sizes count 4x4 blocks, small levels round up to one block.
+    assert(g4f_pack_get(pack, g4f_pack_find(pack, "textures/floor_bc1"), &e));
+    assert(e.format == G4F_PACK_FORMAT_BC1 && e.mipLevels == 5 && e.size == c.bc1.size());
+    assert(e.size == (size_t)(4 * 2 + 2 * 1 + 1 + 1 + 1) * 8);
+    assert(std::memcmp(e.data, c.bc1.data(), e.size) == 0);
+    g4f_pack_texture_level(&e, 0, &w, &h, &pitch, &bytes);
+    assert(w == 16 && h == 8 && pitch == 32 && bytes == 64);
+    const uint8_t* bcLevel3 = (const uint8_t*)g4f_pack_texture_level(&e, 3, &w, &h, &pitch, &bytes);
+    assert(bcLevel3 == (const uint8_t*)e.data + 64 + 16 + 8 && w == 2 && h == 1 && pitch == 8 && bytes == 8);
+
+    assert(!g4f_pack_get(pack, 5, &e) && !g4f_pack_get(pack, -1, &e));
+}
+
+static void testRoundTrip(const std::filesystem::path& dir) {
+    const Content c = makeContent();
+    const std::filesystem::path path = dir / "a.pack";
+    g4f_pack_writer* w = makeWriter(c, false);
+    assert(g4f_pack_writer_save(w, path.string().c_str()));
+    g4f_pack_writer_destroy(w);
+    assert(!std::filesystem::exists(dir / "a.pack.tmp"));
+
+    g4f_pack* pack = g4f_pack_open(path.string().c_str());
+    assert(pack);
+    checkPack(pack, c);
+    // The mapping is page aligned, so blobs are 64-byte aligned in memory too.
+    g4f_pack_entry e{};
+    g4f_pack_get(pack, 0, &e);
+    assert(((uintptr_t)e.data & 63) == 0);
+    g4f_pack_close(pack);
+
+    // Same bytes from memory.
+    const std::vector<uint8_t> bytes = readFile(path);
+    pack = g4f_pack_open_memory(bytes.data(), bytes.size());
+    assert(pack);
+    checkPack(pack, c);
+    g4f_pack_close(pack);
+
+    // The file does not depend on the order entries were added in.
+    w = makeWriter(c, true);
+    assert(g4f_pack_writer_save(w, (dir / "b.pack").string().c_str()));
+    g4f_pack_writer_destroy(w);
+    assert(readFile(dir / "b.pack") == bytes);
+
+    // An empty pack is valid.
+    w = g4f_pack_writer_create();
+    assert(g4f_pack_writer_save(w, (dir / "empty.pack").string().c_str()));
+    g4f_pack_writer_destroy(w);
+    pack = g4f_pack_open((dir / "empty.pack").string().c_str());
+    assert(pack && g4f_pack_entry_count(pack) == 0 && g4f_pack_find(pack, "x") == -1);
+    g4f_pack_close(pack);
+}
+
+static void testRejectsCorruptPacks(const std::filesystem::path& dir) {
+    const Content c = makeContent();
+    const std::filesystem::path path = dir / "good.pack";
+    g4f_pack_writer* w = makeWriter(c, false);
+    assert(g4f_pack_writer_save(w, path.string().c_str()));
+    g4f_pack_writer_destroy(w);
+    const std::vector<uint8_t> good = readFile(path);
+
+    auto rejects = [&](std::vector<uint8_t> bytes, const char* expectedError) {
+        const std::filesystem::path bad = dir / "bad.pack";
+        writeFile(bad, bytes);
+        assert(!g4f_pack_open(bad.string().c_str()));
+        assert(std::strstr(g4f_last_error(), "g4f_pack_open"));
+        assert(std::strstr(g4f_last_error(), expectedError));
+        assert(!g4f_pack_open_memory(bytes.data(), bytes.size()));
+    };
+
+    std::vector<uint8_t> bytes = good;
+    bytes.resize(bytes.size() - 1);
+    rejects(bytes, "truncated");
+    rejects(std::vector<uint8_t>(good.begin(), good.begin() + 40), "too small");
+    bytes = good;
+    bytes[0] = 'X';
+    rejects(bytes, "not a pack");
+    bytes = good;
+    bytes[8] = 2;
+    rejects(bytes, "version");
+    bytes = good;
+    bytes[64 + 40] ^= 1; // first entry's data offset
+    rejects(bytes, "checksum");
+
+    // Mesh indices feed GPU index buffers directly: a garbage index fails the open.
+    g4f_pack* goodPack = g4f_pack_open_memory(good.data(), good.size());
+    g4f_pack_entry mesh{};
+    assert(goodPack && g4f_pack_get(goodPack, g4f_pack_find(goodPack, "meshes/strip"), &mesh));
+    const size_t indexOffset = (size_t)((const uint8_t*)mesh.indices - good.data());
+    g4f_pack_close(goodPack);
+    bytes = good;
+    const uint16_t garbage = (uint16_t)c.vertices.size(); // one past the last vertex
+    std::memcpy(&bytes[indexOffset + 4 * sizeof(uint16_t)], &garbage, sizeof(garbage));
+    rejects(bytes, "index out of range");
+    bytes = good;
+    bytes[indexOffset + 8 * sizeof(uint16_t) + 1] = 0xFF; // last index, high byte
+    rejects(bytes, "index out of range");
+    // Truncating the file through the index array is caught before any index is read.
+    rejects(std::vector<uint8_t>(good.begin(), good.begin() + (std::ptrdiff_t)(indexOffset + 2)), "truncated");
+
+    bytes = good;
+    bytes[bytes.size() - 10] ^= 0xFF; // other blob contents are not checked (opening does not touch them)
+    writeFile(dir / "blob.pack", bytes);
+    g4f_pack* pack = g4f_pack_open((dir / "blob.pack").string().c_str());
+    assert(pack);
+    g4f_pack_close(pack);
+
+    assert(!g4f_pack_open((dir / "does_not_exist.pack").string().c_str()));
+    assert(!g4f_pack_open(nullptr));
+    assert(!g4f_pack_open_memory(nullptr, 16));
+}
+
+static void testWriterValidation() {
+    const Content c = makeContent();
+    g4f_pack_writer* w = g4f_pack_writer_create();
+    assert(g4f_pack_writer_add_blob(w, "a", "x", 1));
+    assert(!g4f_pack_writer_add_blob(w, "a", "y", 1));
+    assert(std::strstr(g4f_last_error(), "duplicate"));
+    assert(!g4f_pack_writer_add_blob(w, "", "y", 1));
+    assert(!g4f_pack_writer_add_blob(w, nullptr, "y", 1));
+    assert(!g4f_pack_writer_add_blob(w, "b", nullptr, 1));
+    assert(!g4f_pack_writer_add_blob(nullptr, "b", "y", 1));
+
+    const uint16_t badIndices[3] = {0, 1, 7};
+    assert(!g4f_pack_writer_add_mesh(w, "m", c.vertices.data(), 7, badIndices, 3));
+    assert(!g4f_pack_writer_add_mesh(w, "m", c.vertices.data(), 7, c.indices.data(), 8));
+    assert(!g4f_pack_writer_add_mesh(w, "m", c.vertices.data(), 0, c.indices.data(), 9));
+    assert(g4f_pack_writer_add_mesh(w, "m", c.vertices.data(), 7, c.indices.data(), 9));
+
+    assert(!g4f_pack_writer_add_texture(w, "t", G4F_PACK_FORMAT_BC1, 16, 8, 5, c.bc1.data(), c.bc1.size() - 1));
+    assert(!g4f_pack_writer_add_texture(w, "t", G4F_PACK_FORMAT_BC1, 18, 8, 1, c.bc1.data(), g4f_pack_texture_bytes(G4F_PACK_FORMAT_BC1, 20, 8, 1)));
+    assert(!g4f_pack_writer_add_texture(w, "t", 9, 16, 8, 1, c.bc1.data(), 64));
+    assert(!g4f_pack_writer_add_texture(w, "t", G4F_PACK_FORMAT_BC1, 16, 8, 6, c.bc1.data(), c.bc1.size()));
+    assert(!g4f_pack_writer_add_texture_rgba8(w, "t", 0, 12, c.pixels.data(), 0, 0, 0, 0, nullptr));
+    assert(!g4f_pack_writer_add_texture_rgba8(w, "t", 20, 12, nullptr, 0, 0, 0, 0, nullptr));
+    assert(g4f_pack_writer_add_texture_rgba8(w, "t", 20, 12, c.pixels.data(), 0, 1, 0, 0, nullptr));
+    assert(g4f_pack_writer_add_texture_rgba8(w, "t2", 20, 12, c.pixels.data(), 0, 99, 0, 0, nullptr));
+    assert(!g4f_pack_writer_save(w, ""));
+    g4f_pack_writer_destroy(w);
+    g4f_pack_writer_destroy(nullptr);
+
+    assert(g4f_pack_texture_bytes(G4F_PACK_FORMAT_RGBA8, 4, 4, 3) == (16 + 4 + 1) * 4);
+    assert(g4f_pack_texture_bytes(G4F_PACK_FORMAT_BC7, 8, 4, 4) == (2 + 1 + 1 + 1) * 16);
+    assert(g4f_pack_texture_bytes(G4F_PACK_FORMAT_BC3, 6, 4, 1) == 0);
+    assert(g4f_pack_texture_bytes(G4F_PACK_FORMAT_RGBA8, 4, 4, 0) == 0);
+
+    assert(g4f_pack_entry_count(nullptr) == 0 && g4f_pack_find(nullptr, "a") == -1);
+    g4f_pack_entry e{};
+    assert(!g4f_pack_get(nullptr, 0, &e));
+    assert(!g4f_pack_texture_level(nullptr, 0, nullptr, nullptr, nullptr, nullptr));
+    g4f_pack_close(nullptr);
+}
+
+int main() {
+    const std::filesystem::path dir = std::filesystem::temp_directory_path() / "g4f_pack_tests";
+    std::filesystem::remove_all(dir);
+    std::filesystem::create_directories(dir);
+    testRoundTrip(dir);
+    testRejectsCorruptPacks(dir);
+    testWriterValidation();
+    std::filesystem::remove_all(dir);
+    std::printf("pack_tests: OK\n");
+    return 0;
+}
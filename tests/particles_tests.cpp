@@ -0,0 +1,221 @@
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_particles.h"
+
+static bool near(float a, float b, float eps = 1e-4f) {
+    return std::fabs(a - b) < eps;
+}
+
+// Emitter without randomness except where a test asks for it.
+static g4f_particle_emitter_desc fixedEmitter() {
+    g4f_particle_emitter_desc d = g4f_particle_emitter_desc_default();
+    d.velocity = g4f_vec3{1.0f, 0.0f, 0.0f};
+    d.velocityJitter = g4f_vec3{0.0f, 0.0f, 0.0f};
+    d.lifeMin = d.lifeMax = 10.0f;
+    d.sizeMin = d.sizeMax = 2.0f;
+    d.rgba = 0x10203080u;
+    return d;
+}
+
+static void testCreate() {
+    g4f_particles_desc d = g4f_particles_desc_default();
+    d.capacity = 0;
+    assert(g4f_particles_create(&d) == nullptr);
+    assert(std::strstr(g4f_last_error(), "g4f_particles_create"));
+
+    g4f_particles* p = g4f_particles_create(nullptr);
+    assert(p && g4f_particles_capacity(p) == 65536 && g4f_particles_count(p) == 0);
+    g4f_particles_update(p, 0.016f, nullptr);
+    g4f_particle_streams s{};
+    g4f_particles_get_streams(p, &s);
+    assert(s.count == 0 && s.x);
+    g4f_particles_destroy(p);
+}
+
+static void testIntegrate() {
+    g4f_particles_desc d = g4f_particles_desc_default();
+    d.gravity = g4f_vec3{0.0f, -10.0f, 0.0f};
+    d.capacity = 7; // not a multiple of 4
+    g4f_particles* p = g4f_particles_create(&d);
+    const g4f_particle_emitter_desc e = fixedEmitter();
+    g4f_particles_burst(p, &e, 5);
+    assert(g4f_particles_count(p) == 0); // bursts spawn on the next update
+    g4f_particles_update(p, 0.0f, nullptr);
+    assert(g4f_particles_count(p) == 5);
+
+    // Semi-implicit Euler: velocity first, then position with the new velocity.
+    g4f_particles_update(p, 0.5f, nullptr);
+    g4f_particle_streams s{};
+    g4f_particles_get_streams(p, &s);
+    assert(s.count == 5);
+    for (int i = 0; i < 5; i++) {
+        assert(near(s.vx[i], 1.0f) && near(s.vy[i], -5.0f) && near(s.vz[i], 0.0f));
+        assert(near(s.x[i], 0.5f) && near(s.y[i], -2.5f) && near(s.z[i], 0.0f));
+        assert(near(s.age[i], 0.5f) && s.life[i] == 10.0f && s.size[i] == 2.0f && s.rgba[i] == 0x10203080u);
+    }
+    g4f_particles_destroy(p);
+
+    // Drag divides the velocity by (1 + drag * dt) each update.
+    d.gravity = g4f_vec3{0.0f, 0.0f, 0.0f};
+    d.drag = 1.0f;
+    p = g4f_particles_create(&d);
+    g4f_particles_burst(p, &e, 1);
+    g4f_particles_update(p, 0.0f, nullptr);
+    g4f_particles_update(p, 1.0f, nullptr);
+    g4f_particles_get_streams(p, &s);
+    assert(near(s.vx[0], 0.5f) && near(s.x[0], 0.5f));
+    g4f_particles_destroy(p);
+}
+
+// Lifetimes spread over [0.5, 1.5]: after t seconds exactly the particles with life > t remain.
+static void testKillAndCompact(g4f_jobs* jobs) {
+    g4f_particles_desc d = g4f_particles_desc_default();
+    d.capacity = 50000;
+    g4f_particles* p = g4f_particles_create(&d);
+    g4f_particle_emitter_desc e = fixedEmitter();
+    e.lifeMin = 0.5f;
+    e.lifeMax = 1.5f;
+    g4f_particles_burst(p, &e, 50000);
+    g4f_particles_update(p, 0.0f, jobs);
+    g4f_particle_streams s{};
+    g4f_particles_get_streams(p, &s);
+    assert(s.count == 50000);
+    std::vector<float> lives(s.life, s.life + s.count);
+
+    float t = 0.0f;
+    for (int step = 0; step < 12; step++) {
+        g4f_particles_update(p, 0.1f, jobs);
+        t += 0.1f;
+        g4f_particles_get_streams(p, &s);
+        std::vector<float> expected;
+        for (float life : lives) {
+            if (life > s.age[0]) expected.push_back(life);
+        }
+        std::vector<float> got(s.life, s.life + s.count);
+        std::sort(expected.begin(), expected.end());
+        std::sort(got.begin(), got.end());
+        assert(got == expected);
+        for (int i = 0; i < s.count; i++) assert(s.age[i] == s.age[0] && near(s.x[i], t, 1e-3f));
+        g4f_particles_stats stats{};
+        g4f_particles_get_stats(p, &stats);
+        assert(stats.alive == s.count && stats.spawned == 0 && stats.dropped == 0);
+    }
+    assert(s.count > 0 && s.count < 50000);
+    g4f_particles_update(p, 1.0f, jobs);
+    assert(g4f_particles_count(p) == 0);
+    g4f_particles_destroy(p);
+}
+
+static void testEmitters() {
+    g4f_particles_desc d = g4f_particles_desc_default();
+    d.capacity = 100;
+    g4f_particles* p = g4f_particles_create(&d);
+    g4f_particle_emitter_desc e = fixedEmitter();
+    e.rate = 10.0f;
+    const int id = g4f_particles_add_emitter(p, &e);
+    assert(id == 0);
+    // Fractional spawns carry over: 2.5 + 2.5 + 2.5 + 2.5 particles -> 2, 3, 2, 3.
+    const int expected[4] = {2, 3, 2, 3};
+    for (int i = 0; i < 4; i++) {
+        g4f_particles_update(p, 0.25f, nullptr);
+        g4f_particles_stats stats{};
+        g4f_particles_get_stats(p, &stats);
+        assert(stats.spawned == expected[i]);
+    }
+    assert(g4f_particles_count(p) == 10);
+
+    // Capacity overflow drops the excess.
+    g4f_particles_burst(p, &e, 150);
+    g4f_particles_update(p, 0.0f, nullptr);
+    g4f_particles_stats stats{};
+    g4f_particles_get_stats(p, &stats);
+    assert(g4f_particles_count(p) == 100 && stats.spawned == 90 && stats.dropped == 60);
+
+    e.rate = 0.0f;
+    assert(g4f_particles_set_emitter(p, id, &e) == 1);
+    g4f_particles_remove_emitter(p, id);
+    assert(g4f_particles_set_emitter(p, id, &e) == 0);
+    assert(g4f_particles_add_emitter(p, &e) == id); // ids are reused
+    g4f_particles_clear(p);
+    assert(g4f_particles_count(p) == 0);
+    g4f_particles_destroy(p);
+}
+
+// Spawning and compaction give bit-identical streams with or without worker threads.
+static void testDeterminism(g4f_jobs* jobs) {
+    g4f_particles* runs[2] = {};
+    for (int run = 0; run < 2; run++) {
+        g4f_particles_desc d = g4f_particles_desc_default();
+        d.capacity = 200000;
+        d.drag = 0.3f;
+        g4f_particles* p = g4f_particles_create(&d);
+        g4f_particle_emitter_desc e = g4f_particle_emitter_desc_default();
+        e.positionJitter = g4f_vec3{1.0f, 2.0f, 3.0f};
+        e.lifeMin = 0.1f;
+        e.lifeMax = 1.0f;
+        e.rate = 200000.0f;
+        g4f_particles_add_emitter(p, &e);
+        e.seed = 7u;
+        e.rate = 50000.0f;
+        g4f_particles_add_emitter(p, &e);
+        for (int frame = 0; frame < 30; frame++) g4f_particles_update(p, 1.0f / 60.0f, run ? jobs : nullptr);
+        runs[run] = p;
+    }
+    g4f_particle_streams a{}, b{};
+    g4f_particles_get_streams(runs[0], &a);
+    g4f_particles_get_streams(runs[1], &b);
+    assert(a.count == b.count && a.count > 10000);
+    const float* fa[] = {a.x, a.y, a.z, a.vx, a.vy, a.vz, a.age, a.life, a.size};
+    const float* fb[] = {b.x, b.y, b.z, b.vx, b.vy, b.vz, b.age, b.life, b.size};
+    for (int k = 0; k < 9; k++) assert(std::memcmp(fa[k], fb[k], (size_t)a.count * sizeof(float)) == 0);
+    for (int i = 0; i < a.count; i++) {
+        assert(a.age[i] < a.life[i]);
+        assert(std::fabs(a.z[i]) <= 3.0f + 1.0f); // jitter box plus drift from the +-0.5 velocity jitter
+    }
+    g4f_particles_destroy(runs[0]);
+    g4f_particles_destroy(runs[1]);
+}
+
+static void testInstances(g4f_jobs* jobs) {
+    g4f_particles_desc d = g4f_particles_desc_default();
+    d.gravity = g4f_vec3{0.0f, 0.0f, 0.0f};
+    d.endSizeScale = 3.0f;
+    g4f_particles* p = g4f_particles_create(&d);
+    g4f_particle_emitter_desc e = fixedEmitter();
+    e.lifeMin = e.lifeMax = 2.0f;
+    e.rgba = 0x11223380u;
+    g4f_particles_burst(p, &e, 10000);
+    g4f_particles_update(p, 0.0f, jobs);
+    g4f_particles_update(p, 1.0f, jobs); // halfway: size x2, alpha halved
+
+    std::vector<g4f_particle_instance> out(20000);
+    assert(g4f_particles_write_instances(p, out.data(), 20000, jobs) == 10000);
+    for (int i = 0; i < 10000; i++) {
+        const g4f_particle_instance& in = out[(size_t)i];
+        assert(near(in.x, 1.0f) && in.y == 0.0f && in.z == 0.0f && near(in.size, 4.0f));
+        assert(in.rgba == 0x11223340u);
+    }
+    assert(g4f_particles_write_instances(p, out.data(), 3, jobs) == 3);
+    assert(g4f_particles_write_instances(p, out.data(), 0, jobs) == 0);
+    g4f_particles_destroy(p);
+}
+
+int main() {
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    testCreate();
+    testIntegrate();
+    testKillAndCompact(nullptr);
+    testKillAndCompact(jobs);
+    testEmitters();
+    testDeterminism(jobs);
+    testInstances(nullptr);
+    testInstances(jobs);
+    g4f_jobs_destroy(jobs);
+    std::printf("particles_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,75 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+
+#include "g4f/g4f_pass_stack.h"
+
+// Headless stand-in for backend targets: only the identity and size matter to the bookkeeping.
+struct FakeTarget {
+    int width;
+    int height;
+};
+
+static void testBackbufferDefault() {
+    g4f_pass_stack s;
+    g4f_pass_stack_reset(&s, 1280, 720);
+    g4f_pass_state cur = g4f_pass_stack_current(&s);
+    assert(cur.target == nullptr && cur.width == 1280 && cur.height == 720);
+
+    g4f_pass_stack_set_backbuffer_size(&s, 800, 600);
+    cur = g4f_pass_stack_current(&s);
+    assert(cur.width == 800 && cur.height == 600);
+}
+
+static void testNestingRestoresOuterTarget() {
+    FakeTarget minimap{256, 256};
+    FakeTarget lowRes{640, 360};
+    g4f_pass_stack s;
+    g4f_pass_stack_reset(&s, 1280, 720);
+
+    assert(g4f_pass_stack_push(&s, &lowRes, lowRes.width, lowRes.height) == 1);
+    assert(g4f_pass_stack_push(&s, &minimap, minimap.width, minimap.height) == 1);
+    g4f_pass_state cur = g4f_pass_stack_current(&s);
+    assert(cur.target == &minimap && cur.width == 256);
+    assert(g4f_pass_stack_is_open(&s, &lowRes) == 1);
+
+    // Resizing the window mid-pass does not disturb open passes.
+    g4f_pass_stack_set_backbuffer_size(&s, 1920, 1080);
+    assert(g4f_pass_stack_current(&s).target == &minimap);
+
+    assert(g4f_pass_stack_pop(&s) == 1);
+    cur = g4f_pass_stack_current(&s);
+    assert(cur.target == &lowRes && cur.width == 640 && cur.height == 360);
+    assert(g4f_pass_stack_pop(&s) == 1);
+    cur = g4f_pass_stack_current(&s);
+    assert(cur.target == nullptr && cur.width == 1920 && cur.height == 1080);
+}
+
+static void testMisuseIsRejected() {
+    FakeTarget a{64, 64};
+    FakeTarget many[G4F_PASS_STACK_MAX + 1] = {};
+    g4f_pass_stack s;
+    g4f_pass_stack_reset(&s, 100, 100);
+
+    assert(g4f_pass_stack_pop(&s) == 0);
+    assert(std::strstr(g4f_last_error(), "no open pass"));
+    assert(g4f_pass_stack_push(&s, nullptr, 64, 64) == 0);
+    assert(g4f_pass_stack_push(&s, &a, 0, 64) == 0);
+
+    assert(g4f_pass_stack_push(&s, &a, 64, 64) == 1);
+    assert(g4f_pass_stack_push(&s, &a, 64, 64) == 0); // feedback loop: rendering into an open target
+    assert(std::strstr(g4f_last_error(), "already has an open pass"));
+    assert(g4f_pass_stack_pop(&s) == 1);
+
+    for (int i = 0; i < G4F_PASS_STACK_MAX; i++) assert(g4f_pass_stack_push(&s, &many[i], 8, 8) == 1);
+    assert(g4f_pass_stack_push(&s, &many[G4F_PASS_STACK_MAX], 8, 8) == 0);
+    assert(s.depth == G4F_PASS_STACK_MAX);
+}
+
+int main() {
+    testBackbufferDefault();
+    testNestingRestoresOuterTarget();
+    testMisuseIsRejected();
+    std::printf("pass_stack_tests: OK\n");
+    return 0;
+}
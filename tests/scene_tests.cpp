@@ -0,0 +1,285 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <vector>
+
+#include "g4f/g4f_scene.h"
+
+static bool feq(float a, float b, float eps = 1e-4f) {
+    return std::fabs(a - b) <= eps;
+}
+
+static bool matEq(const g4f_mat4& a, const g4f_mat4& b, float eps = 1e-4f) {
+    for (int i = 0; i < 16; i++) {
+        if (!feq(a.m[i], b.m[i], eps)) return false;
+    }
+    return true;
+}
+
+static g4f_mat4 localOf(const g4f_scene* scene, g4f_scene_node node) {
+    g4f_vec3 t{}, s{};
+    g4f_quat r{};
+    assert(g4f_scene_get_local(scene, node, &t, &r, &s) == 1);
+    return g4f_mat4_trs(t, r, s);
+}
+
+// Reference world matrix: walk the parent chain with g4f_mat4_mul.
+static g4f_mat4 referenceWorld(const g4f_scene* scene, g4f_scene_node node) {
+    g4f_mat4 world = localOf(scene, node);
+    for (g4f_scene_node p = g4f_scene_parent(scene, node); p != G4F_SCENE_NODE_NULL; p = g4f_scene_parent(scene, p)) {
+        world = g4f_mat4_mul(world, localOf(scene, p));
+    }
+    return world;
+}
+
+static void testHierarchyMatchesMatrixChain() {
+    g4f_scene* scene = g4f_scene_create(0);
+    g4f_scene_node root = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+    g4f_scene_node arm = g4f_scene_node_create(scene, root);
+    g4f_scene_node hand = g4f_scene_node_create(scene, arm);
+    g4f_scene_set_local(scene, root, g4f_vec3{1.0f, 2.0f, 3.0f}, g4f_quat_from_axis_angle(g4f_vec3{0.0f, 1.0f, 0.0f}, 0.5f), g4f_vec3{2.0f, 2.0f, 2.0f});
+    g4f_scene_set_local(scene, arm, g4f_vec3{0.0f, 1.0f, 0.0f}, g4f_quat_from_axis_angle(g4f_vec3{1.0f, 0.0f, 0.0f}, -0.3f), g4f_vec3{1.0f, 0.5f, 1.0f});
+    g4f_scene_set_translation(scene, hand, g4f_vec3{0.0f, 0.0f, 1.5f});
+
+    assert(matEq(*g4f_scene_world(scene, hand), g4f_mat4_identity())); // not updated yet
+    g4f_scene_update(scene, nullptr);
+    assert(matEq(*g4f_scene_world(scene, root), referenceWorld(scene, root)));
+    assert(matEq(*g4f_scene_world(scene, arm), referenceWorld(scene, arm)));
+    assert(matEq(*g4f_scene_world(scene, hand), referenceWorld(scene, hand)));
+
+    // Depth-first creation never re-sorts.
+    g4f_scene_stats stats{};
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.nodeCount == 3 && stats.rootCount == 1 && stats.layoutRebuilds == 0);
+    g4f_scene_destroy(scene);
+}
+
+static void testOnlyChangedSubtreesUpdate() {
+    g4f_scene* scene = g4f_scene_create(64);
+    // Two roots with 3 children each, every child with 2 leaves.
+    g4f_scene_node roots[2];
+    g4f_scene_node kids[2][3];
+    for (int r = 0; r < 2; r++) {
+        roots[r] = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+        for (int c = 0; c < 3; c++) {
+            kids[r][c] = g4f_scene_node_create(scene, roots[r]);
+            g4f_scene_set_translation(scene, kids[r][c], g4f_vec3{(float)c, 0.0f, 0.0f});
+            for (int l = 0; l < 2; l++) g4f_scene_node_create(scene, kids[r][c]);
+        }
+    }
+    g4f_scene_update(scene, nullptr);
+    g4f_scene_stats stats{};
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.nodeCount == 20 && stats.updatedNodes == 20 && stats.updatedRanges == 2);
+
+    g4f_scene_update(scene, nullptr);
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.updatedNodes == 0 && stats.updatedRanges == 0);
+
+    // A leaf's parent and a node under another root: two ranges, 3 + 3 nodes.
+    g4f_scene_set_translation(scene, kids[0][1], g4f_vec3{5.0f, 0.0f, 0.0f});
+    g4f_scene_set_scale(scene, kids[1][2], g4f_vec3{2.0f, 2.0f, 2.0f});
+    g4f_scene_set_scale(scene, kids[1][2], g4f_vec3{3.0f, 3.0f, 3.0f}); // flagged once
+    g4f_scene_update(scene, nullptr);
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.updatedNodes == 6 && stats.updatedRanges == 2);
+
+    // A flagged root covers flagged descendants.
+    g4f_scene_set_rotation(scene, kids[0][0], g4f_quat_from_axis_angle(g4f_vec3{0.0f, 0.0f, 1.0f}, 1.0f));
+    g4f_scene_set_translation(scene, roots[0], g4f_vec3{0.0f, 4.0f, 0.0f});
+    g4f_scene_update(scene, nullptr);
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.updatedNodes == 10 && stats.updatedRanges == 1);
+    const g4f_mat4* w = g4f_scene_world(scene, kids[0][1]);
+    assert(feq(w->m[12], 5.0f) && feq(w->m[13], 4.0f));
+    g4f_scene_destroy(scene);
+}
+
+static void testReparentAndDestroy() {
+    g4f_scene* scene = g4f_scene_create(0);
+    g4f_scene_node a = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+    g4f_scene_node b = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+    g4f_scene_node a1 = g4f_scene_node_create(scene, a);
+    g4f_scene_node a2 = g4f_scene_node_create(scene, a1);
+    g4f_scene_set_translation(scene, a, g4f_vec3{10.0f, 0.0f, 0.0f});
+    g4f_scene_set_translation(scene, b, g4f_vec3{0.0f, 0.0f, -7.0f});
+    g4f_scene_set_translation(scene, a2, g4f_vec3{0.0f, 1.0f, 0.0f});
+    g4f_scene_update(scene, nullptr);
+
+    assert(g4f_scene_set_parent(scene, a, a2) == 0); // cycle
+    assert(g4f_scene_set_parent(scene, a, a) == 0);
+    assert(g4f_scene_set_parent(scene, a1, b) == 1);
+    assert(g4f_scene_parent(scene, a1) == b);
+    g4f_scene_update(scene, nullptr);
+    const g4f_mat4* w = g4f_scene_world(scene, a2);
+    assert(feq(w->m[12], 0.0f) && feq(w->m[13], 1.0f) && feq(w->m[14], -7.0f));
+
+    g4f_scene_stats stats{};
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.layoutRebuilds == 2 && stats.rootCount == 2); // a1 created after root b, then the reparent
+
+    g4f_scene_node_destroy(scene, a1); // takes a2 along
+    assert(!g4f_scene_node_alive(scene, a1) && !g4f_scene_node_alive(scene, a2));
+    assert(g4f_scene_node_alive(scene, a) && g4f_scene_node_alive(scene, b));
+    assert(g4f_scene_node_count(scene) == 2);
+    assert(g4f_scene_world(scene, a2) == nullptr);
+
+    // Recycled slots never revive stale handles.
+    g4f_scene_node c = g4f_scene_node_create(scene, b);
+    assert(c != a1 && c != a2 && !g4f_scene_node_alive(scene, a1));
+    g4f_scene_set_translation(scene, a2, g4f_vec3{1.0f, 1.0f, 1.0f}); // ignored
+    g4f_scene_update(scene, nullptr);
+    w = g4f_scene_world(scene, c);
+    assert(feq(w->m[14], -7.0f));
+    assert(matEq(*g4f_scene_world(scene, a), referenceWorld(scene, a)));
+
+    g4f_scene_node_destroy(scene, b);
+    g4f_scene_get_stats(scene, &stats);
+    assert(stats.nodeCount == 1 && stats.rootCount == 1);
+    assert(g4f_scene_node_create(scene, c) == G4F_SCENE_NODE_NULL); // dead parent
+    g4f_scene_destroy(scene);
+}
+
+// Random forest built breadth-first-ish (forces re-sorts), checked against the reference chain for
+// inline and threaded updates.
+static void testParallelMatchesSerial() {
+    uint32_t rng = 7u;
+    auto next = [&rng]() {
+        rng = rng * 1664525u + 1013904223u;
+        return rng >> 8;
+    };
+
+    g4f_scene* scenes[2] = {g4f_scene_create(0), g4f_scene_create(0)};
+    std::vector<g4f_scene_node> nodes[2];
+    for (int i = 0; i < 6000; i++) {
+        const uint32_t pick = next();
+        const bool root = i < 8 || pick % 50 == 0;
+        for (int s = 0; s < 2; s++) {
+            g4f_scene_node parent = root ? G4F_SCENE_NODE_NULL : nodes[s][pick % nodes[s].size()];
+            g4f_scene_node n = g4f_scene_node_create(scenes[s], parent);
+            g4f_vec3 t{(float)(pick % 7) - 3.0f, (float)(pick % 5) * 0.5f, 1.0f};
+            g4f_quat q = g4f_quat_from_axis_angle(g4f_vec3{0.2f, 1.0f, 0.1f}, (float)(pick % 13) * 0.1f);
+            g4f_scene_set_local(scenes[s], n, t, q, g4f_vec3{1.0f, 1.0f, 1.0f});
+            nodes[s].push_back(n);
+        }
+    }
+
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    for (int frame = 0; frame < 3; frame++) {
+        for (int k = 0; k < 500; k++) {
+            const uint32_t pick = next() % (uint32_t)nodes[0].size();
+            for (int s = 0; s < 2; s++) g4f_scene_set_translation(scenes[s], nodes[s][pick], g4f_vec3{(float)frame, (float)k * 0.01f, 0.0f});
+        }
+        g4f_scene_update(scenes[0], nullptr);
+        g4f_scene_update(scenes[1], jobs);
+        for (size_t i = 0; i < nodes[0].size(); i += 37) {
+            const g4f_mat4* serial = g4f_scene_world(scenes[0], nodes[0][i]);
+            const g4f_mat4* threaded = g4f_scene_world(scenes[1], nodes[1][i]);
+            assert(matEq(*serial, *threaded, 0.0f));
+            assert(matEq(*serial, referenceWorld(scenes[0], nodes[0][i]), 1e-2f));
+        }
+    }
+    g4f_jobs_destroy(jobs);
+    g4f_scene_destroy(scenes[0]);
+    g4f_scene_destroy(scenes[1]);
+}
+
+static void testDrawListGroupsByMaterial() {
+    // Opaque gfx handles are only compared and passed through here.
+    static int meshStorage[2], materialStorage[2];
+    const auto* meshA = reinterpret_cast<const g4f_gfx_mesh*>(&meshStorage[0]);
+    const auto* meshB = reinterpret_cast<const g4f_gfx_mesh*>(&meshStorage[1]);
+    const auto* matA = reinterpret_cast<const g4f_gfx_material*>(&materialStorage[0]);
+    const auto* matB = reinterpret_cast<const g4f_gfx_material*>(&materialStorage[1]);
+
+    g4f_scene* scene = g4f_scene_create(0);
+    g4f_scene_node root = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+    g4f_scene_set_translation(scene, root, g4f_vec3{0.0f, 0.0f, 5.0f});
+    std::vector<g4f_scene_node> nodes;
+    for (int i = 0; i < 12; i++) {
+        g4f_scene_node n = g4f_scene_node_create(scene, root);
+        g4f_scene_set_translation(scene, n, g4f_vec3{(float)i, 0.0f, 0.0f});
+        if (i % 4 != 3) g4f_scene_set_renderable(scene, n, (i % 2) ? meshA : meshB, (i % 3) ? matA : matB);
+        nodes.push_back(n);
+    }
+
+    const g4f_mat4 viewProj = g4f_mat4_perspective(1.0f, 1.0f, 0.1f, 100.0f);
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 9);
+    int count = 0;
+    const g4f_scene_draw* draws = g4f_scene_draws(scene, &count);
+    assert(count == 9 && draws);
+    int materialSwitches = 0;
+    for (int i = 0; i < count; i++) {
+        if (i > 0 && draws[i].material != draws[i - 1].material) materialSwitches++;
+        if (i > 0 && draws[i].material == draws[i - 1].material) {
+            assert(std::less<const g4f_gfx_mesh*>()(draws[i - 1].mesh, draws[i].mesh) || draws[i - 1].mesh == draws[i].mesh);
+        }
+        assert(matEq(draws[i].model, *g4f_scene_world(scene, draws[i].node)));
+        assert(matEq(draws[i].mvp, g4f_mat4_mul(draws[i].model, viewProj)));
+    }
+    assert(materialSwitches == 1);
+
+    // Renderables follow node edits and removals.
+    g4f_scene_set_renderable(scene, nodes[0], nullptr, nullptr);
+    g4f_scene_node_destroy(scene, nodes[1]);
+    g4f_scene_set_translation(scene, root, g4f_vec3{0.0f, 3.0f, 5.0f});
+    assert(g4f_scene_build_draws(scene, &viewProj, nullptr) == 7);
+    draws = g4f_scene_draws(scene, &count);
+    for (int i = 0; i < count; i++) assert(feq(draws[i].model.m[13], 3.0f));
+
+    assert(g4f_scene_build_draws(scene, nullptr, nullptr) == 0);
+    assert(g4f_scene_build_draws(nullptr, &viewProj, nullptr) == 0);
+    g4f_scene_destroy(scene);
+}
+
+// Recycling slots must never hand out an old handle again, including for nodes destroyed with
+// their parent's subtree.
+static void testStaleHandlesStayInvalid() {
+    g4f_scene* scene = g4f_scene_create(0);
+    const g4f_scene_node firstRoot = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+    const g4f_scene_node firstChild = g4f_scene_node_create(scene, firstRoot);
+    g4f_scene_node root = firstRoot;
+    bool slotRetired = false;
+    for (int i = 0; i < 3000; i++) {
+        g4f_scene_node_destroy(scene, root);
+        root = g4f_scene_node_create(scene, G4F_SCENE_NODE_NULL);
+        const g4f_scene_node child = g4f_scene_node_create(scene, root);
+        assert(root != firstRoot && root != firstChild && child != firstRoot && child != firstChild);
+        assert(g4f_scene_node_alive(scene, root) && g4f_scene_node_alive(scene, child));
+        assert(!g4f_scene_node_alive(scene, firstRoot) && !g4f_scene_node_alive(scene, firstChild));
+        slotRetired = slotRetired || (root & 0x3FFFFFu) > 2u;
+    }
+    assert(slotRetired && g4f_scene_node_count(scene) == 2);
+    g4f_scene_destroy(scene);
+}
+
+static void testNullHandles() {
+    g4f_scene_update(nullptr, nullptr);
+    g4f_scene_destroy(nullptr);
+    assert(g4f_scene_node_create(nullptr, G4F_SCENE_NODE_NULL) == G4F_SCENE_NODE_NULL);
+    assert(g4f_scene_node_alive(nullptr, 1) == 0);
+    assert(g4f_scene_node_count(nullptr) == 0);
+    assert(g4f_scene_world(nullptr, 1) == nullptr);
+    g4f_scene* scene = g4f_scene_create(0);
+    assert(g4f_scene_world(scene, G4F_SCENE_NODE_NULL) == nullptr);
+    assert(g4f_scene_world(scene, 12345u) == nullptr);
+    assert(g4f_scene_set_parent(scene, 12345u, G4F_SCENE_NODE_NULL) == 0);
+    assert(g4f_scene_get_local(scene, 12345u, nullptr, nullptr, nullptr) == 0);
+    g4f_scene_stats stats{};
+    g4f_scene_get_stats(nullptr, &stats);
+    assert(stats.nodeCount == 0);
+    g4f_scene_destroy(scene);
+}
+
+int main() {
+    testHierarchyMatchesMatrixChain();
+    testOnlyChangedSubtreesUpdate();
+    testReparentAndDestroy();
+    testParallelMatchesSerial();
+    testDrawListGroupsByMaterial();
+    testStaleHandlesStayInvalid();
+    testNullHandles();
+    std::printf("scene_tests: OK\n");
+    return 0;
+}
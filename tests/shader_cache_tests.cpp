@@ -0,0 +1,128 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "g4f/g4f_shader_cache.h"
+
+static const char* kSource = "float4 PSMain() : SV_Target { return 1; }";
+
+static void testKeyCoversAllInputs() {
+    uint64_t base = g4f_shader_cache_key(kSource, "PSMain", "ps_5_0", 47, 0x800);
+    assert(base == g4f_shader_cache_key(kSource, "PSMain", "ps_5_0", 47, 0x800));
+    assert(base != g4f_shader_cache_key("float4 PSMain() : SV_Target { return 0; }", "PSMain", "ps_5_0", 47, 0x800));
+    assert(base != g4f_shader_cache_key(kSource, "PSOther", "ps_5_0", 47, 0x800));
+    assert(base != g4f_shader_cache_key(kSource, "PSMain", "ps_4_0", 47, 0x800));
+    assert(base != g4f_shader_cache_key(kSource, "PSMain", "ps_5_0", 46, 0x800));
+    assert(base != g4f_shader_cache_key(kSource, "PSMain", "ps_5_0", 47, 0x801));
+    // Field boundaries matter.
+    assert(g4f_shader_cache_key("ab", "c", "p", 1, 0) != g4f_shader_cache_key("a", "bc", "p", 1, 0));
+}
+
+static void testStoreLoadRoundTrip(const std::string& dir) {
+    std::vector<unsigned char> bytecode(1000);
+    for (size_t i = 0; i < bytecode.size(); i++) bytecode[i] = (unsigned char)(i * 7 + 3);
+    uint64_t key = g4f_shader_cache_key(kSource, "PSMain", "ps_5_0", 47, 0);
+
+    void* loaded = nullptr;
+    size_t size = 0;
+    assert(g4f_shader_cache_load(dir.c_str(), key, &loaded, &size) == 0); // cold: miss
+    assert(loaded == nullptr && size == 0);
+
+    assert(g4f_shader_cache_store(dir.c_str(), key, bytecode.data(), bytecode.size()) == 1);
+    assert(g4f_shader_cache_load(dir.c_str(), key, &loaded, &size) == 1);
+    assert(size == bytecode.size() && std::memcmp(loaded, bytecode.data(), size) == 0);
+    g4f_shader_cache_free(loaded);
+
+    // Overwriting an entry replaces it atomically.
+    bytecode[10] ^= 0xFF;
+    assert(g4f_shader_cache_store(dir.c_str(), key, bytecode.data(), bytecode.size()) == 1);
+    assert(g4f_shader_cache_load(dir.c_str(), key, &loaded, &size) == 1);
+    assert(std::memcmp(loaded, bytecode.data(), size) == 0);
+    g4f_shader_cache_free(loaded);
+
+    assert(g4f_shader_cache_load(dir.c_str(), key + 1, &loaded, &size) == 0);
+}
+
+static void testCorruptEntriesAreMisses(const std::string& dir) {
+    std::vector<unsigned char> bytecode(256, 0x5A);
+    uint64_t key = g4f_shader_cache_key(kSource, "PSCorrupt", "ps_5_0", 47, 0);
+    assert(g4f_shader_cache_store(dir.c_str(), key, bytecode.data(), bytecode.size()) == 1);
+
+    std::filesystem::path file;
+    for (const auto& e : std::filesystem::directory_iterator(dir)) {
+        char name[32];
+        std::snprintf(name, sizeof(name), "%016llx.cso", (unsigned long long)key);
+        if (e.path().filename() == name) file = e.path();
+    }
+    assert(!file.empty());
+
+    // Flip one payload byte: checksum mismatch.
+    {
+        std::fstream f(file, std::ios::binary | std::ios::in | std::ios::out);
+        f.seekp(-1, std::ios::end);
+        f.put((char)0x00);
+    }
+    void* loaded = nullptr;
+    size_t size = 0;
+    assert(g4f_shader_cache_load(dir.c_str(), key, &loaded, &size) == 0);
+
+    // Truncated file.
+    std::filesystem::resize_file(file, 10);
+    assert(g4f_shader_cache_load(dir.c_str(), key, &loaded, &size) == 0);
+}
+
+// Writers racing on one key each use their own temporary file: every store succeeds, the entry
+// is one complete payload, and no temporary files are left behind.
+static void testConcurrentStores(const std::string& dir) {
+    const uint64_t key = g4f_shader_cache_key(kSource, "PSRace", "ps_5_0", 47, 0);
+    std::vector<std::vector<unsigned char>> payloads(8);
+    for (size_t t = 0; t < payloads.size(); t++) payloads[t].assign(64 * 1024, (unsigned char)(t + 1));
+    std::vector<int> results(payloads.size(), 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < payloads.size(); t++) {
+        threads.emplace_back([&, t] {
+            int ok = 1;
+            for (int i = 0; i < 20; i++) ok &= g4f_shader_cache_store(dir.c_str(), key, payloads[t].data(), payloads[t].size());
+            results[t] = ok;
+        });
+    }
+    for (std::thread& t : threads) t.join();
+    for (int ok : results) assert(ok == 1);
+
+    void* loaded = nullptr;
+    size_t size = 0;
+    assert(g4f_shader_cache_load(dir.c_str(), key, &loaded, &size) == 1 && size == 64 * 1024);
+    const unsigned char* bytes = (const unsigned char*)loaded;
+    for (size_t i = 0; i < size; i++) assert(bytes[i] == bytes[0]);
+    g4f_shader_cache_free(loaded);
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) assert(entry.path().extension() != ".tmp");
+}
+
+static void testInvalidArgs() {
+    void* loaded = nullptr;
+    size_t size = 0;
+    assert(g4f_shader_cache_load("", 1, &loaded, &size) == 0);
+    assert(g4f_shader_cache_store(nullptr, 1, "x", 1) == 0);
+    assert(std::strstr(g4f_last_error(), "g4f_shader_cache_store"));
+}
+
+int main() {
+    std::filesystem::path dir = std::filesystem::temp_directory_path() / "g4f_shader_cache_tests";
+    std::filesystem::remove_all(dir);
+    const std::string dirUtf8 = dir.string();
+
+    testKeyCoversAllInputs();
+    testStoreLoadRoundTrip(dirUtf8);
+    testCorruptEntriesAreMisses(dirUtf8);
+    testConcurrentStores(dirUtf8);
+    testInvalidArgs();
+
+    std::filesystem::remove_all(dir);
+    std::printf("shader_cache_tests: OK\n");
+    return 0;
+}
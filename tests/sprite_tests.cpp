@@ -0,0 +1,188 @@
+#include <cassert>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_sprite.h"
+
+// The CPU side only compares texture pointers, so fake handles are enough.
+static const g4f_gfx_texture* fakeTexture(uintptr_t id) {
+    return reinterpret_cast<const g4f_gfx_texture*>(id * 64);
+}
+
+static bool near(float a, float b) {
+    return std::fabs(a - b) < 1e-4f;
+}
+
+static void testExpand() {
+    g4f_sprite_batch* batch = g4f_sprite_batch_create(G4F_SPRITE_SORT_TEXTURE);
+    int count = -1;
+    assert(g4f_sprite_batch_vertices(batch, &count) == nullptr && count == 0);
+
+    g4f_sprite s = g4f_sprite_make(10.0f, 20.0f, 4.0f, 2.0f);
+    s.rgba = 0x11223344u;
+    g4f_sprite_batch_add(batch, fakeTexture(1), &s);
+    // Centered pivot, 90 degrees clockwise: the top-left corner swings to the top-right.
+    g4f_sprite r = g4f_sprite_make(100.0f, 100.0f, 4.0f, 2.0f);
+    r.pivotX = r.pivotY = 0.5f;
+    r.rotation = 3.14159265f * 0.5f;
+    r.u0 = 1.0f;
+    r.u1 = 0.0f;
+    g4f_sprite_batch_add(batch, fakeTexture(1), &r);
+    assert(g4f_sprite_batch_build(batch) == 1);
+
+    const g4f_sprite_vertex* v = g4f_sprite_batch_vertices(batch, &count);
+    assert(v && count == 8);
+    const float expect[4][4] = {{10, 20, 0, 0}, {14, 20, 1, 0}, {10, 22, 0, 1}, {14, 22, 1, 1}};
+    for (int i = 0; i < 4; i++) {
+        assert(v[i].x == expect[i][0] && v[i].y == expect[i][1] && v[i].u == expect[i][2] && v[i].v == expect[i][3]);
+        assert(v[i].rgba == 0x11223344u);
+    }
+    // Local corners (-2,-1), (2,-1), (-2,1), (2,1) rotated by 90 degrees: (x, y) -> (-y, x).
+    const float rotated[4][2] = {{101, 98}, {101, 102}, {99, 98}, {99, 102}};
+    for (int i = 0; i < 4; i++) assert(near(v[4 + i].x, rotated[i][0]) && near(v[4 + i].y, rotated[i][1]));
+    assert(v[4].u == 1.0f && v[5].u == 0.0f); // flipped UVs pass through
+    g4f_sprite_batch_destroy(batch);
+}
+
+// Sprite identity travels in x so the built order can be checked.
+static g4f_sprite tagged(int id, int layer) {
+    g4f_sprite s = g4f_sprite_make((float)id, 0.0f, 1.0f, 1.0f);
+    s.layer = layer;
+    return s;
+}
+
+static int spriteAt(const g4f_sprite_vertex* v, int index) {
+    return (int)v[index * 4].x;
+}
+
+static void testTextureSort() {
+    g4f_sprite_batch* batch = g4f_sprite_batch_create(G4F_SPRITE_SORT_TEXTURE);
+    // Texture B is used first, so it sorts first even though its pointer is larger.
+    const g4f_gfx_texture* a = fakeTexture(1);
+    const g4f_gfx_texture* b = fakeTexture(2);
+    for (int i = 0; i < 8; i++) {
+        const g4f_sprite s = tagged(i, 0);
+        g4f_sprite_batch_add(batch, (i & 1) ? a : b, &s);
+    }
+    const g4f_sprite back = tagged(100, -5), front = tagged(101, 9);
+    g4f_sprite_batch_add(batch, a, &front);
+    g4f_sprite_batch_add(batch, a, &back);
+    assert(g4f_sprite_batch_count(batch) == 10);
+    // Consecutive runs of one texture merge across layers (the last two).
+    assert(g4f_sprite_batch_build(batch) == 3);
+
+    int count = 0;
+    const g4f_sprite_vertex* v = g4f_sprite_batch_vertices(batch, &count);
+    const int expected[10] = {100, 0, 2, 4, 6, 1, 3, 5, 7, 101};
+    for (int i = 0; i < 10; i++) assert(spriteAt(v, i) == expected[i]);
+    g4f_sprite_range r{};
+    const g4f_gfx_texture* textures[3] = {a, b, a};
+    const int firsts[3] = {0, 1, 5}, counts[3] = {1, 4, 5};
+    for (int i = 0; i < 3; i++) {
+        assert(g4f_sprite_batch_get_range(batch, i, &r) == 1);
+        assert(r.texture == textures[i] && r.firstSprite == firsts[i] && r.spriteCount == counts[i]);
+    }
+    assert(g4f_sprite_batch_get_range(batch, 3, &r) == 0);
+
+    // Layers beyond 16 bits clamp instead of wrapping.
+    g4f_sprite_batch_clear(batch);
+    const g4f_sprite deep = tagged(1, -1000000), high = tagged(2, 1000000), mid = tagged(3, 0);
+    g4f_sprite_batch_add(batch, a, &high);
+    g4f_sprite_batch_add(batch, a, &mid);
+    g4f_sprite_batch_add(batch, a, &deep);
+    assert(g4f_sprite_batch_build(batch) == 1);
+    v = g4f_sprite_batch_vertices(batch, &count);
+    assert(count == 12 && spriteAt(v, 0) == 1 && spriteAt(v, 1) == 3 && spriteAt(v, 2) == 2);
+    g4f_sprite_batch_destroy(batch);
+}
+
+static void testSubmissionOrder() {
+    g4f_sprite_batch* batch = g4f_sprite_batch_create(G4F_SPRITE_SORT_SUBMISSION);
+    const g4f_gfx_texture* a = fakeTexture(1);
+    const g4f_gfx_texture* b = fakeTexture(2);
+    const g4f_gfx_texture* order[6] = {a, a, b, a, nullptr, nullptr};
+    for (int i = 0; i < 6; i++) {
+        const g4f_sprite s = tagged(i, i == 5 ? -1 : 0); // layers are ignored in submission order
+        g4f_sprite_batch_add(batch, order[i], &s);
+    }
+    assert(g4f_sprite_batch_build(batch) == 4);
+    int count = 0;
+    const g4f_sprite_vertex* v = g4f_sprite_batch_vertices(batch, &count);
+    for (int i = 0; i < 6; i++) assert(spriteAt(v, i) == i);
+    g4f_sprite_range r{};
+    assert(g4f_sprite_batch_get_range(batch, 3, &r) == 1 && r.texture == nullptr && r.firstSprite == 4 && r.spriteCount == 2);
+
+    // Switching the mode needs a rebuild; sprite 5 then moves to the front on its own layer and
+    // the layer-0 sprites merge per texture.
+    g4f_sprite_batch_set_sort_mode(batch, G4F_SPRITE_SORT_TEXTURE);
+    assert(g4f_sprite_batch_range_count(batch) == 0);
+    assert(g4f_sprite_batch_build(batch) == 4);
+    v = g4f_sprite_batch_vertices(batch, &count);
+    const int expected[6] = {5, 0, 1, 3, 2, 4};
+    for (int i = 0; i < 6; i++) assert(spriteAt(v, i) == expected[i]);
+    g4f_sprite_batch_destroy(batch);
+}
+
+static void testManySprites() {
+    // 100k sprites over 7 textures in 3 layers: 21 ranges at most, submission order within each.
+    g4f_sprite_batch* batch = g4f_sprite_batch_create(G4F_SPRITE_SORT_TEXTURE);
+    std::vector<g4f_sprite> chunk;
+    const int total = 100000;
+    for (int i = 0; i < total; i += 100) {
+        chunk.clear();
+        for (int k = 0; k < 100; k++) chunk.push_back(tagged(i + k, (i / 100) % 3));
+        g4f_sprite_batch_add_many(batch, fakeTexture(1 + (uintptr_t)((i / 100) * 5 % 7)), chunk.data(), (int)chunk.size());
+    }
+    const int ranges = g4f_sprite_batch_build(batch);
+    assert(ranges == 21);
+    int count = 0;
+    const g4f_sprite_vertex* v = g4f_sprite_batch_vertices(batch, &count);
+    assert(count == total * 4);
+    std::vector<char> seen(total, 0);
+    for (int i = 0; i < ranges; i++) {
+        g4f_sprite_range r{};
+        g4f_sprite_batch_get_range(batch, i, &r);
+        for (int k = r.firstSprite; k < r.firstSprite + r.spriteCount; k++) {
+            const int id = spriteAt(v, k);
+            assert(!seen[(size_t)id]);
+            seen[(size_t)id] = 1;
+            if (k > r.firstSprite) assert(spriteAt(v, k - 1) < id);
+        }
+    }
+    // Rebuilding an unchanged batch gives the same stream.
+    std::vector<g4f_sprite_vertex> first(v, v + count);
+    assert(g4f_sprite_batch_build(batch) == ranges);
+    v = g4f_sprite_batch_vertices(batch, &count);
+    assert(std::memcmp(first.data(), v, first.size() * sizeof(g4f_sprite_vertex)) == 0);
+
+    g4f_sprite_batch_clear(batch);
+    assert(g4f_sprite_batch_count(batch) == 0 && g4f_sprite_batch_range_count(batch) == 0);
+    assert(g4f_sprite_batch_build(batch) == 0);
+    g4f_sprite_batch_destroy(batch);
+}
+
+static void testTextureLimit() {
+    g4f_sprite_batch* batch = g4f_sprite_batch_create(G4F_SPRITE_SORT_TEXTURE);
+    const g4f_sprite s = tagged(0, 0);
+    for (uintptr_t i = 0; i < 65536; i++) g4f_sprite_batch_add(batch, fakeTexture(i + 1), &s);
+    assert(g4f_sprite_batch_count(batch) == 65536);
+    g4f_sprite_batch_add(batch, fakeTexture(70000), &s);
+    assert(g4f_sprite_batch_count(batch) == 65536);
+    assert(std::strstr(g4f_last_error(), "g4f_sprite_batch_add"));
+    g4f_sprite_batch_add(batch, fakeTexture(5), &s); // known textures still work
+    assert(g4f_sprite_batch_count(batch) == 65537);
+    assert(g4f_sprite_batch_build(batch) == 65536);
+    g4f_sprite_batch_destroy(batch);
+}
+
+int main() {
+    testExpand();
+    testTextureSort();
+    testSubmissionOrder();
+    testManySprites();
+    testTextureLimit();
+    std::printf("sprite_tests: OK\n");
+    return 0;
+}
@@ -0,0 +1,462 @@
+#include <atomic>
+#include <cassert>
+#include <cmath>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "g4f/g4f_stream.h"
+
+// Stand-in backend: payloads and resident handles are small heap records, every call is counted,
+// and residency calls are checked to run on the updating (main) thread.
+struct Payload {
+    int x, z;
+};
+
+struct Backend {
+    std::thread::id mainThread = std::this_thread::get_id();
+    size_t bytesPerCell = 1000;
+    std::atomic<int> generated{0};
+    std::atomic<bool> generatedOnMain{false};
+    int uploads = 0, evicts = 0, discards = 0;
+    std::vector<std::pair<int, int>> uploadOrder, evictOrder;
+    std::set<std::pair<int, int>> failGenerate, failUpload;
+
+    // Generators block while the gate is closed.
+    std::mutex gateMutex;
+    std::condition_variable gateCv;
+    bool gateOpen = true;
+    int blocked = 0;
+
+    void checkMain() const { assert(std::this_thread::get_id() == mainThread); }
+};
+
+static void* testGenerate(void* user, int x, int z, size_t* outBytes) {
+    auto* b = (Backend*)user;
+    if (std::this_thread::get_id() == b->mainThread) b->generatedOnMain = true;
+    {
+        std::unique_lock<std::mutex> lock(b->gateMutex);
+        if (!b->gateOpen) {
+            b->blocked++;
+            b->gateCv.notify_all();
+            b->gateCv.wait(lock, [&] { return b->gateOpen; });
+        }
+    }
+    if (b->failGenerate.count({x, z})) return nullptr;
+    b->generated += 1;
+    *outBytes = b->bytesPerCell;
+    return new Payload{x, z};
+}
+
+static void* testUpload(void* user, int x, int z, void* payload, size_t* outBytes) {
+    auto* b = (Backend*)user;
+    b->checkMain();
+    auto* p = (Payload*)payload;
+    assert(p->x == x && p->z == z);
+    b->uploads++;
+    b->uploadOrder.push_back({x, z});
+    if (b->failUpload.count({x, z})) {
+        delete p;
+        return nullptr;
+    }
+    *outBytes = b->bytesPerCell;
+    return p; // the payload doubles as the resident handle
+}
+
+static void testEvict(void* user, int x, int z, void* handle) {
+    auto* b = (Backend*)user;
+    b->checkMain();
+    auto* p = (Payload*)handle;
+    assert(p->x == x && p->z == z);
+    b->evicts++;
+    b->evictOrder.push_back({x, z});
+    delete p;
+}
+
+static void testDiscard(void* user, int x, int z, void* payload) {
+    auto* b = (Backend*)user;
+    b->checkMain();
+    auto* p = (Payload*)payload;
+    assert(p->x == x && p->z == z);
+    b->discards++;
+    delete p;
+}
+
+static g4f_stream_backend makeBackend(Backend* b) {
+    g4f_stream_backend backend{};
+    backend.generate = testGenerate;
+    backend.generateUser = b;
+    backend.upload = testUpload;
+    backend.evict = testEvict;
+    backend.discard = testDiscard;
+    backend.residencyUser = b;
+    return backend;
+}
+
+static g4f_stream_desc makeDesc(int radius) {
+    g4f_stream_desc d{};
+    d.cellSize = 10.0f;
+    d.loadRadius = radius;
+    d.generatorThreads = 2;
+    d.maxInFlight = 1000;
+    d.uploadBudgetBytes = 1u << 30;
+    d.memoryBudgetBytes = (size_t)1 << 30;
+    return d;
+}
+
+// Camera at the center of cell (x, z) for cellSize 10.
+static g4f_camera_fps cameraAt(int x, int z) {
+    g4f_camera_fps cam = g4f_camera_fps_default();
+    cam.position = g4f_vec3{(float)x * 10.0f + 5.0f, 2.0f, (float)z * 10.0f + 5.0f};
+    return cam;
+}
+
+static int cellsInRadius(int r) {
+    int n = 0;
+    for (int z = -r; z <= r; z++) {
+        for (int x = -r; x <= r; x++) n += x * x + z * z <= r * r ? 1 : 0;
+    }
+    return n;
+}
+
+// Updates (waiting for the generators in between) until nothing is in flight.
+static void settle(g4f_stream* stream, const g4f_camera_fps& cam) {
+    for (int i = 0; i < 1000; i++) {
+        g4f_stream_update(stream, &cam);
+        g4f_stream_wait_idle(stream);
+        g4f_stream_stats stats{};
+        g4f_stream_get_stats(stream, &stats);
+        if (stats.inFlight == 0 && stats.uploadsLastUpdate == 0) return;
+    }
+    assert(!"stream did not settle");
+}
+
+static void testLoadsNearestFirstWithinBudget() {
+    Backend b;
+    g4f_stream_backend backend = makeBackend(&b);
+    g4f_stream_desc desc = makeDesc(3);
+    desc.uploadBudgetBytes = 2500; // two 1000-byte cells per update
+    g4f_stream* stream = g4f_stream_create(&desc, &backend);
+    assert(stream);
+
+    const g4f_camera_fps cam = cameraAt(0, 0);
+    g4f_stream_update(stream, &cam); // requests everything in range
+    g4f_stream_wait_idle(stream);
+    const int expected = cellsInRadius(3);
+    g4f_stream_stats stats{};
+    for (int i = 0; i < 100; i++) {
+        g4f_stream_update(stream, &cam);
+        g4f_stream_get_stats(stream, &stats);
+        assert(stats.uploadsLastUpdate <= 2 && stats.uploadBytesLastUpdate <= 2500);
+        if (stats.resident == expected) break;
+        assert(stats.uploadsLastUpdate == 2);
+    }
+    assert(stats.resident == expected && stats.inFlight == 0);
+    assert(stats.residentBytes == (size_t)expected * 1000);
+    assert(b.generated == expected && !b.generatedOnMain);
+
+    // Everything was generated before the first upload, so uploads follow distance exactly.
+    assert(b.uploadOrder[0] == std::make_pair(0, 0));
+    for (size_t i = 1; i < b.uploadOrder.size(); i++) {
+        const auto& p = b.uploadOrder[i - 1];
+        const auto& q = b.uploadOrder[i];
+        assert(p.first * p.first + p.second * p.second <= q.first * q.first + q.second * q.second);
+    }
+    for (int z = -3; z <= 3; z++) {
+        for (int x = -3; x <= 3; x++) {
+            void* handle = g4f_stream_get(stream, x, z);
+            assert((handle != nullptr) == (x * x + z * z <= 9));
+            if (handle) assert(((Payload*)handle)->x == x && ((Payload*)handle)->z == z);
+        }
+    }
+
+    std::vector<g4f_stream_cell> cells((size_t)expected + 4);
+    const int n = g4f_stream_resident_cells(stream, cells.data(), (int)cells.size());
+    assert(n == expected);
+    assert(cells[0].x == 0 && cells[0].z == 0 && cells[0].handle == g4f_stream_get(stream, 0, 0));
+    for (int i = 1; i < n; i++) {
+        const g4f_stream_cell& p = cells[(size_t)i - 1];
+        const g4f_stream_cell& q = cells[(size_t)i];
+        assert(p.x * p.x + p.z * p.z <= q.x * q.x + q.z * q.z);
+    }
+    assert(g4f_stream_resident_cells(stream, cells.data(), 3) == 3);
+
+    g4f_stream_destroy(stream);
+    assert(b.uploads == expected && b.evicts == expected && b.discards == 0);
+}
+
+static void testUploadLimits() {
+    // A cell larger than the whole byte budget still uploads, one per update.
+    Backend b;
+    b.bytesPerCell = 1 << 20;
+    g4f_stream_backend backend = makeBackend(&b);
+    g4f_stream_desc desc = makeDesc(1);
+    desc.uploadBudgetBytes = 1000;
+    g4f_stream* stream = g4f_stream_create(&desc, &backend);
+    const g4f_camera_fps cam = cameraAt(5, -7);
+    g4f_stream_update(stream, &cam);
+    g4f_stream_wait_idle(stream);
+    for (int i = 0; i < 5; i++) {
+        g4f_stream_update(stream, &cam);
+        g4f_stream_stats stats{};
+        g4f_stream_get_stats(stream, &stats);
+        assert(stats.uploadsLastUpdate == 1 && stats.resident == i + 1);
+    }
+    assert(b.uploadOrder[0] == std::make_pair(5, -7));
+    g4f_stream_destroy(stream);
+    assert(b.uploads == 5 && b.evicts == 5);
+
+    // Count limit.
+    Backend c;
+    backend = makeBackend(&c);
+    desc = makeDesc(2);
+    desc.maxUploadsPerUpdate = 3;
+    stream = g4f_stream_create(&desc, &backend);
+    g4f_stream_update(stream, &cam);
+    g4f_stream_wait_idle(stream);
+    g4f_stream_update(stream, &cam);
+    g4f_stream_stats stats{};
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.uploadsLastUpdate == 3);
+    settle(stream, cam);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == cellsInRadius(2));
+    g4f_stream_destroy(stream);
+
+    // In-flight cap: requests go out nearest first, a few at a time.
+    Backend d;
+    backend = makeBackend(&d);
+    desc = makeDesc(3);
+    desc.maxInFlight = 4;
+    stream = g4f_stream_create(&desc, &backend);
+    g4f_stream_update(stream, &cam);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.inFlight == 4);
+    g4f_stream_wait_idle(stream);
+    g4f_stream_update(stream, &cam);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.uploadsLastUpdate == 4 && stats.resident == 4 && stats.inFlight == 4);
+    for (const auto& p : d.uploadOrder) assert((p.first - 5) * (p.first - 5) + (p.second + 7) * (p.second + 7) <= 1);
+    settle(stream, cam);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == cellsInRadius(3));
+    g4f_stream_destroy(stream);
+}
+
+static void testEvictsLeastRecentlyUsedUnderCap() {
+    Backend b;
+    g4f_stream_backend backend = makeBackend(&b);
+    g4f_stream_desc desc = makeDesc(1);       // 5 cells in range
+    desc.memoryBudgetBytes = 12 * 1000 + 500; // room for 12 cells
+    g4f_stream* stream = g4f_stream_create(&desc, &backend);
+
+    // Walk along +X: every step leaves 3 cells behind.
+    g4f_stream_stats stats{};
+    for (int x = 0; x < 12; x++) {
+        const g4f_camera_fps cam = cameraAt(x, 0);
+        settle(stream, cam);
+        g4f_stream_get_stats(stream, &stats);
+        assert(stats.residentBytes <= desc.memoryBudgetBytes && !stats.overBudget);
+        for (int dz = -1; dz <= 1; dz++) {
+            for (int dx = -1; dx <= 1; dx++) {
+                if (dx * dx + dz * dz <= 1) assert(g4f_stream_get(stream, x + dx, dz));
+            }
+        }
+    }
+    assert(stats.resident == 12 && b.evicts > 0);
+    assert(stats.evicted == b.evicts && stats.uploaded == b.uploads);
+
+    // Oldest first (cells behind the camera in walking order), farthest first within a step.
+    for (size_t i = 1; i < b.evictOrder.size(); i++) {
+        const auto& p = b.evictOrder[i - 1];
+        const auto& q = b.evictOrder[i];
+        assert(p.first + (p.second == 0 ? 1 : 0) <= q.first + (q.second == 0 ? 1 : 0));
+        if (p.first + (p.second == 0 ? 1 : 0) == q.first + (q.second == 0 ? 1 : 0)) assert(p.second == 0 || q.second != 0);
+    }
+    // The survivors outside the radius are the most recently left ones.
+    std::vector<g4f_stream_cell> cells(32);
+    const int n = g4f_stream_resident_cells(stream, cells.data(), 32);
+    assert(n == 12);
+    for (int i = 0; i < n; i++) assert(cells[(size_t)i].x >= 11 - 3);
+
+    // Walking back reloads evicted cells; cells still resident are reused.
+    const int uploadsBefore = b.uploads;
+    settle(stream, cameraAt(10, 0));
+    assert(b.uploads == uploadsBefore);
+    settle(stream, cameraAt(2, 0));
+    assert(b.uploads > uploadsBefore);
+
+    g4f_stream_destroy(stream);
+    assert(b.uploads == b.evicts && b.discards == 0 && b.generated == b.uploads);
+}
+
+static void testOverBudgetKeepsCellsInRange() {
+    Backend b;
+    g4f_stream_backend backend = makeBackend(&b);
+    g4f_stream_desc desc = makeDesc(1);
+    desc.memoryBudgetBytes = 2500;
+    g4f_stream* stream = g4f_stream_create(&desc, &backend);
+    settle(stream, cameraAt(0, 0));
+    g4f_stream_stats stats{};
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == 5 && stats.overBudget == 1 && b.evicts == 0);
+
+    // Moving on evicts everything left behind right away.
+    settle(stream, cameraAt(3, 0));
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == 5 && b.evicts == 5 && stats.overBudget == 1);
+    g4f_stream_destroy(stream);
+    assert(b.uploads == 10 && b.evicts == 10);
+}
+
+static void testDiscardsWorkForCellsLeftBehind() {
+    Backend b;
+    b.gateOpen = false;
+    g4f_stream_backend backend = makeBackend(&b);
+    g4f_stream_desc desc = makeDesc(1);
+    desc.generatorThreads = 1;
+    g4f_stream* stream = g4f_stream_create(&desc, &backend);
+
+    // One cell is stuck in the generator, four are queued.
+    const g4f_camera_fps home = cameraAt(0, 0);
+    g4f_stream_update(stream, &home);
+    {
+        std::unique_lock<std::mutex> lock(b.gateMutex);
+        b.gateCv.wait(lock, [&] { return b.blocked == 1; });
+    }
+    g4f_stream_stats stats{};
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.inFlight == 5);
+
+    // Teleport: queued requests are dropped, the running one is discarded when it finishes.
+    const g4f_camera_fps far = cameraAt(100, 100);
+    g4f_stream_update(stream, &far);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.inFlight == 1 + 5);
+    {
+        std::lock_guard<std::mutex> lock(b.gateMutex);
+        b.gateOpen = true;
+    }
+    b.gateCv.notify_all();
+    settle(stream, far);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == 5 && stats.discarded == 1 && b.discards == 1);
+    assert(b.generated == 6 && stats.generated == 6);
+    for (const auto& p : b.uploadOrder) assert(p.first >= 99 && p.second >= 99);
+    assert(g4f_stream_get(stream, 0, 0) == nullptr);
+
+    // Generated but not yet uploaded payloads are discarded on destroy.
+    desc.uploadBudgetBytes = 1;
+    g4f_stream* pending = g4f_stream_create(&desc, &backend);
+    g4f_stream_update(pending, &far);
+    g4f_stream_wait_idle(pending);
+    g4f_stream_update(pending, &far); // uploads one
+    g4f_stream_wait_idle(pending);
+    g4f_stream_destroy(pending);
+    g4f_stream_destroy(stream);
+    assert(b.generated == 11 && b.uploads + b.discards == 11 && b.uploads == b.evicts && b.discards == 1 + 4);
+}
+
+static void testFailuresAreRetried() {
+    Backend b;
+    b.failGenerate.insert({1, 0});
+    b.failUpload.insert({0, 1});
+    g4f_stream_backend backend = makeBackend(&b);
+    g4f_stream_desc desc = makeDesc(1);
+    g4f_stream* stream = g4f_stream_create(&desc, &backend);
+    const g4f_camera_fps cam = cameraAt(0, 0);
+    g4f_stream_update(stream, &cam);
+    g4f_stream_wait_idle(stream);
+    b.failGenerate.clear(); // generators are idle
+
+    // Both failed cells are requested again right away.
+    g4f_stream_update(stream, &cam);
+    g4f_stream_stats stats{};
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == 3 && stats.failed == 2 && stats.inFlight == 2);
+    assert(!g4f_stream_get(stream, 1, 0) && !g4f_stream_get(stream, 0, 1));
+    b.failUpload.clear();
+    settle(stream, cam);
+    g4f_stream_get_stats(stream, &stats);
+    assert(stats.resident == 5 && g4f_stream_get(stream, 1, 0) && g4f_stream_get(stream, 0, 1));
+    g4f_stream_destroy(stream);
+    assert(b.uploads == 6 && b.evicts == 5);
+}
+
+static void testChunks() {
+    g4f_stream_chunk* chunk = g4f_stream_chunk_create(4, 6, 8, 4);
+    assert(chunk);
+    assert(chunk->vertexCount == 4 && chunk->indexCount == 6 && chunk->textureWidth == 8 && chunk->textureHeight == 4);
+    assert(((uintptr_t)chunk->vertices & 15) == 0 && ((uintptr_t)chunk->rgba & 15) == 0);
+    assert((uint8_t*)chunk->indices >= (uint8_t*)(chunk->vertices + 4));
+    assert(chunk->rgba >= (uint8_t*)(chunk->indices + 6));
+    assert(chunk->model.m[0] == 1.0f && chunk->model.m[12] == 0.0f && chunk->material.tintRgba == 0xFFFFFFFFu);
+    std::memset(chunk->vertices, 0, sizeof(g4f_gfx_vertex_p3n3uv2) * 4);
+    std::memset(chunk->indices, 0, sizeof(uint16_t) * 6);
+    std::memset(chunk->rgba, 0xFF, 8 * 4 * 4);
+    assert(g4f_stream_chunk_bytes(chunk) == 4 * sizeof(g4f_gfx_vertex_p3n3uv2) + 12 + 8 * 4 * 4);
+    g4f_stream_chunk_destroy(chunk);
+
+    g4f_stream_chunk* plain = g4f_stream_chunk_create(3, 3, 0, 0);
+    assert(plain && !plain->rgba && plain->vertices && plain->indices);
+    g4f_stream_chunk_destroy(plain);
+    assert(!g4f_stream_chunk_create(3, 4, 0, 0));
+    assert(!g4f_stream_chunk_create(3, 3, 16, 0));
+    assert(!g4f_stream_chunk_create(70000, 3, 0, 0));
+    assert(g4f_stream_chunk_bytes(nullptr) == 0);
+    g4f_stream_chunk_destroy(nullptr);
+}
+
+static void testInvalidInput() {
+    Backend b;
+    g4f_stream_backend backend = makeBackend(&b);
+    assert(!g4f_stream_create(nullptr, nullptr));
+    assert(std::strstr(g4f_last_error(), "g4f_stream_create"));
+    g4f_stream_backend partial = backend;
+    partial.discard = nullptr;
+    assert(!g4f_stream_create(nullptr, &partial));
+    g4f_stream_desc desc = makeDesc(-1);
+    assert(!g4f_stream_create(&desc, &backend));
+    desc = makeDesc(2);
+    desc.cellSize = NAN;
+    assert(!g4f_stream_create(&desc, &backend));
+
+    const g4f_stream_desc d = g4f_stream_desc_default();
+    assert(d.cellSize == 16.0f && d.loadRadius == 4 && d.generatorThreads >= 1 && d.maxInFlight == 4 * d.generatorThreads);
+    g4f_stream* stream = g4f_stream_create(nullptr, &backend);
+    assert(stream);
+    int x = 0, z = 0;
+    g4f_stream_cell_of(stream, g4f_vec3{-0.5f, 0.0f, 31.9f}, &x, &z);
+    assert(x == -1 && z == 1);
+    g4f_stream_update(stream, nullptr);
+    g4f_stream_destroy(stream);
+
+    g4f_stream_update(nullptr, nullptr);
+    g4f_stream_wait_idle(nullptr);
+    g4f_stream_destroy(nullptr);
+    assert(!g4f_stream_get(nullptr, 0, 0));
+    assert(g4f_stream_resident_cells(nullptr, nullptr, 4) == 0);
+    g4f_stream_stats stats{};
+    stats.resident = 7;
+    g4f_stream_get_stats(nullptr, &stats);
+    assert(stats.resident == 0);
+    assert(b.uploads == 0 && b.evicts == 0);
+}
+
+int main() {
+    testLoadsNearestFirstWithinBudget();
+    testUploadLimits();
+    testEvictsLeastRecentlyUsedUnderCap();
+    testOverBudgetKeepsCellsInRange();
+    testDiscardsWorkForCellsLeftBehind();
+    testFailuresAreRetried();
+    testChunks();
+    testInvalidInput();
+    std::printf("stream_tests: OK\n");
+    return 0;
+}
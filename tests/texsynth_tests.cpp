@@ -0,0 +1,118 @@
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "g4f/g4f_texsynth.h"
+
+static void testFieldRangeAndDeterminism() {
+    const int w = 67, h = 45; // not tile- or SIMD-aligned on purpose
+    g4f_jobs* jobs = g4f_jobs_create(4);
+    for (int g = 0; g < G4F_TEXSYNTH_GENERATOR_COUNT; g++) {
+        g4f_texsynth_desc d = g4f_texsynth_desc_default(g);
+        d.octaves = 3;
+        std::vector<float> serial((size_t)w * h), parallel((size_t)w * h);
+        assert(g4f_texsynth_generate_r32f(&d, nullptr, w, h, serial.data(), 0) == 1);
+        assert(g4f_texsynth_generate_r32f(&d, jobs, w, h, parallel.data(), 0) == 1);
+        assert(std::memcmp(serial.data(), parallel.data(), serial.size() * sizeof(float)) == 0);
+        for (int y = 0; y < h; y++) {
+            for (int x = 0; x < w; x++) {
+                float v = serial[(size_t)y * w + x];
+                assert(v >= 0.0f && v <= 1.0f);
+                assert(v == g4f_texsynth_sample(&d, w, h, x, y));
+            }
+        }
+    }
+    g4f_jobs_destroy(jobs);
+}
+
+static void testSeedChangesNoise() {
+    g4f_texsynth_desc a = g4f_texsynth_desc_default(G4F_TEXSYNTH_SIMPLEX_NOISE);
+    g4f_texsynth_desc b = a;
+    b.seed = a.seed + 1;
+    int differing = 0;
+    for (int i = 0; i < 64; i++) {
+        if (g4f_texsynth_sample(&a, 64, 64, i, i / 2) != g4f_texsynth_sample(&b, 64, 64, i, i / 2)) differing++;
+    }
+    assert(differing > 32);
+}
+
+static void testCheckerMatchesIntegerPattern() {
+    // Same layout as the animated checker in samples/spin_cube.
+    const int w = 128, h = 128, cell = 16, phase = 37;
+    const uint32_t dark = g4f_rgba_u32(40, 40, 55, 255);
+    const uint32_t light = g4f_rgba_u32(240, 240, 255, 255);
+    const g4f_texsynth_ramp_stop ramp[] = {{0.0f, dark}, {1.0f, light}};
+    g4f_texsynth_desc d = g4f_texsynth_desc_default(G4F_TEXSYNTH_CHECKER);
+    d.frequency = (float)(w / cell);
+    d.offsetX = (float)phase;
+    d.offsetY = (float)phase;
+    d.ramp = ramp;
+    d.rampCount = 2;
+
+    std::vector<uint8_t> px((size_t)w * h * 4);
+    assert(g4f_texsynth_generate_rgba8(&d, nullptr, w, h, px.data(), 0) == 1);
+    for (int y = 0; y < h; y++) {
+        for (int x = 0; x < w; x++) {
+            int on = (((x + phase) / cell) ^ ((y + phase) / cell)) & 1;
+            uint32_t want = on ? light : dark;
+            const uint8_t* p = &px[((size_t)y * w + x) * 4];
+            assert(p[0] == ((want >> 24) & 0xFF));
+            assert(p[1] == ((want >> 16) & 0xFF));
+            assert(p[2] == ((want >> 8) & 0xFF));
+            assert(p[3] == (want & 0xFF));
+        }
+    }
+}
+
+static void testLinearGradientEndpointsAndRowPitch() {
+    const int w = 256, h = 4, pitch = w * 4 + 16;
+    g4f_texsynth_desc d = g4f_texsynth_desc_default(G4F_TEXSYNTH_LINEAR_GRADIENT);
+    std::vector<uint8_t> px((size_t)pitch * h, 0xAB);
+    assert(g4f_texsynth_generate_rgba8(&d, nullptr, w, h, px.data(), pitch) == 1);
+    for (int y = 0; y < h; y++) {
+        const uint8_t* row = &px[(size_t)y * pitch];
+        assert(row[0] == 0 && row[3] == 255);
+        assert(row[(w - 1) * 4] == 255);
+        for (int x = 1; x < w; x++) assert(row[x * 4] >= row[(x - 1) * 4]); // monotonic
+        for (int pad = w * 4; pad < pitch; pad++) assert(row[pad] == 0xAB);  // padding untouched
+    }
+}
+
+static void testSingleStopRampIsSolid() {
+    const g4f_texsynth_ramp_stop ramp[] = {{0.0f, g4f_rgba_u32(10, 20, 30, 40)}};
+    g4f_texsynth_desc d = g4f_texsynth_desc_default(G4F_TEXSYNTH_WORLEY);
+    d.ramp = ramp;
+    d.rampCount = 1;
+    std::vector<uint8_t> px(16 * 16 * 4);
+    assert(g4f_texsynth_generate_rgba8(&d, nullptr, 16, 16, px.data(), 0) == 1);
+    for (size_t i = 0; i < px.size(); i += 4) {
+        assert(px[i] == 10 && px[i + 1] == 20 && px[i + 2] == 30 && px[i + 3] == 40);
+    }
+}
+
+static void testInvalidArgs() {
+    g4f_texsynth_desc d = g4f_texsynth_desc_default(G4F_TEXSYNTH_VALUE_NOISE);
+    uint32_t px[4];
+    g4f_clear_error();
+    assert(g4f_texsynth_generate_rgba8(nullptr, nullptr, 2, 2, px, 0) == 0);
+    assert(std::strstr(g4f_last_error(), "g4f_texsynth_generate_rgba8") != nullptr);
+    g4f_clear_error();
+    assert(g4f_texsynth_generate_rgba8(&d, nullptr, 2, 2, px, 4) == 0);
+    assert(std::strstr(g4f_last_error(), "rowPitchBytes") != nullptr);
+    d.generator = 99;
+    g4f_clear_error();
+    assert(g4f_texsynth_generate_rgba8(&d, nullptr, 2, 2, px, 0) == 0);
+    assert(std::strstr(g4f_last_error(), "unknown generator") != nullptr);
+}
+
+int main() {
+    testFieldRangeAndDeterminism();
+    testSeedChangesNoise();
+    testCheckerMatchesIntegerPattern();
+    testLinearGradientEndpointsAndRowPitch();
+    testSingleStopRampIsSolid();
+    testInvalidArgs();
+    std::printf("texsynth_tests: OK\n");
+    return 0;
+}
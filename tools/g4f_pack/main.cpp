@@ -0,0 +1,292 @@
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <sstream>
+#include <string>
+#include <tuple>
+#include <vector>
+
+#include "g4f/g4f_bcn.h"
+#include "g4f/g4f_image.h"
+#include "g4f/g4f_jobs.h"
+#include "g4f/g4f_mipgen.h"
+#include "g4f/g4f_pack.h"
+
+// Asset pack writer: bakes loose files into one g4f pack (see g4f_pack.h).
+//
+//   g4f_pack out.pack [options] entries...
+//   g4f_pack --list in.pack
+//
+// Entries:
+//   --blob name=path         file contents as-is
+//   --obj name=path          Wavefront OBJ: triangulated, converted to the engine's left-handed
+//                            convention (Z negated, V flipped), up to 65536 unique vertices
+//   --rgba name=path:WxH     raw RGBA8 pixels, mip chain built at bake time
+//   --image name=path        PNG, TGA or QOI file (g4f_image), mip chain built at bake time
+// Texture options (apply to the --rgba and --image entries that follow):
+//   --mips N                 levels to store (0 = full chain, the default; 1 = no mips)
+//   --filter box|kaiser      mip filter (default box)
+//   --wrap | --clamp         tiling textures filter across edges (default clamp)
+//   --linear | --srgb        color channels are linear data (default sRGB)
+//   --format rgba8|bc1|bc3|bc7  stored format (default rgba8); BC needs multiple-of-4 sizes
+//   --quality fast|normal|high  block compression effort (default normal)
+
+static bool readFile(const std::string& path, std::vector<uint8_t>* out) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) return false;
+    out->assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool splitEntry(const char* arg, std::string* name, std::string* path) {
+    const char* eq = std::strchr(arg, '=');
+    if (!eq || eq == arg || !eq[1]) return false;
+    name->assign(arg, eq);
+    path->assign(eq + 1);
+    return true;
+}
+
+// OBJ face corner "v", "v/vt", "v//vn" or "v/vt/vn"; indices are 1-based, negative = from the end.
+static bool parseCorner(const std::string& token, int counts[3], int out[3]) {
+    out[0] = out[1] = out[2] = -1;
+    size_t start = 0;
+    for (int k = 0; k < 3 && start <= token.size(); k++) {
+        const size_t slash = token.find('/', start);
+        const std::string part = token.substr(start, slash == std::string::npos ? std::string::npos : slash - start);
+        if (!part.empty()) {
+            const long v = std::strtol(part.c_str(), nullptr, 10);
+            const long index = v > 0 ? v - 1 : counts[k] + v;
+            if (v == 0 || index < 0 || index >= counts[k]) return false;
+            out[k] = (int)index;
+        } else if (k == 0) {
+            return false;
+        }
+        if (slash == std::string::npos) break;
+        start = slash + 1;
+    }
+    return true;
+}
+
+static bool loadObj(const std::string& path, std::vector<g4f_gfx_vertex_p3n3uv2>* vertices, std::vector<uint16_t>* indices) {
+    std::ifstream in(path);
+    if (!in) return false;
+    std::vector<float> positions, uvs, normals;
+    std::map<std::tuple<int, int, int>, uint16_t> unique;
+    bool needNormals = false;
+    std::string line;
+    int lineNumber = 0;
+    while (std::getline(in, line)) {
+        lineNumber++;
+        std::istringstream ss(line);
+        std::string tag;
+        ss >> tag;
+        if (tag == "v" || tag == "vn") {
+            float x = 0.0f, y = 0.0f, z = 0.0f;
+            ss >> x >> y >> z;
+            std::vector<float>& dst = tag == "v" ? positions : normals;
+            dst.insert(dst.end(), {x, y, -z});
+        } else if (tag == "vt") {
+            float u = 0.0f, v = 0.0f;
+            ss >> u >> v;
+            uvs.insert(uvs.end(), {u, 1.0f - v});
+        } else if (tag == "f") {
+            int counts[3] = {(int)positions.size() / 3, (int)uvs.size() / 2, (int)normals.size() / 3};
+            std::vector<uint16_t> face;
+            std::string token;
+            while (ss >> token) {
+                int corner[3];
+                if (!parseCorner(token, counts, corner)) {
+                    std::fprintf(stderr, "%s:%d: bad face index '%s'\n", path.c_str(), lineNumber, token.c_str());
+                    return false;
+                }
+                auto it = unique.find({corner[0], corner[1], corner[2]});
+                if (it == unique.end()) {
+                    if (vertices->size() >= 65536) {
+                        std::fprintf(stderr, "%s: more than 65536 unique vertices\n", path.c_str());
+                        return false;
+                    }
+                    g4f_gfx_vertex_p3n3uv2 v{};
+                    v.px = positions[(size_t)corner[0] * 3];
+                    v.py = positions[(size_t)corner[0] * 3 + 1];
+                    v.pz = positions[(size_t)corner[0] * 3 + 2];
+                    if (corner[1] >= 0) {
+                        v.u = uvs[(size_t)corner[1] * 2];
+                        v.v = uvs[(size_t)corner[1] * 2 + 1];
+                    }
+                    if (corner[2] >= 0) {
+                        v.nx = normals[(size_t)corner[2] * 3];
+                        v.ny = normals[(size_t)corner[2] * 3 + 1];
+                        v.nz = normals[(size_t)corner[2] * 3 + 2];
+                    } else {
+                        needNormals = true;
+                    }
+                    it = unique.emplace(std::make_tuple(corner[0], corner[1], corner[2]), (uint16_t)vertices->size()).first;
+                    vertices->push_back(v);
+                }
+                face.push_back(it->second);
+            }
+            // Mirroring Z turns the file's counter-clockwise fronts into the engine's clockwise fronts.
+            for (size_t i = 2; i < face.size(); i++) indices->insert(indices->end(), {face[0], face[i - 1], face[i]});
+        }
+    }
+    if (needNormals) {
+        // Area-weighted vertex normals for corners without one.
+        std::vector<float> accum(vertices->size() * 3, 0.0f);
+        for (size_t i = 0; i + 2 < indices->size(); i += 3) {
+            const g4f_gfx_vertex_p3n3uv2& a = (*vertices)[(*indices)[i]];
+            const g4f_gfx_vertex_p3n3uv2& b = (*vertices)[(*indices)[i + 1]];
+            const g4f_gfx_vertex_p3n3uv2& c = (*vertices)[(*indices)[i + 2]];
+            const float e1[3] = {b.px - a.px, b.py - a.py, b.pz - a.pz};
+            const float e2[3] = {c.px - a.px, c.py - a.py, c.pz - a.pz};
+            // Clockwise front faces in a left-handed frame: e1 x e2 points outwards.
+            const float n[3] = {e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0]};
+            for (size_t k = 0; k < 3; k++) {
+                for (int j = 0; j < 3; j++) accum[(size_t)(*indices)[i + k] * 3 + (size_t)j] += n[j];
+            }
+        }
+        for (size_t v = 0; v < vertices->size(); v++) {
+            g4f_gfx_vertex_p3n3uv2& out = (*vertices)[v];
+            if (out.nx != 0.0f || out.ny != 0.0f || out.nz != 0.0f) continue;
+            const float len = std::sqrt(accum[v * 3] * accum[v * 3] + accum[v * 3 + 1] * accum[v * 3 + 1] + accum[v * 3 + 2] * accum[v * 3 + 2]);
+            if (len > 0.0f) {
+                out.nx = accum[v * 3] / len;
+                out.ny = accum[v * 3 + 1] / len;
+                out.nz = accum[v * 3 + 2] / len;
+            }
+        }
+    }
+    return !indices->empty();
+}
+
+// RGBA8 pixels -> mip chain -> optional block compression -> texture entry.
+static bool addTexture(g4f_pack_writer* writer, const char* name, int w, int h, const std::vector<uint8_t>& pixels, int mips, int filter,
+                       int flags, int format, int quality, g4f_jobs* jobs) {
+    if (format == G4F_PACK_FORMAT_RGBA8) return g4f_pack_writer_add_texture_rgba8(writer, name, w, h, pixels.data(), 0, mips, filter, flags, jobs);
+    const int full = g4f_mipgen_level_count(w, h);
+    const int levels = mips == 0 || mips > full ? full : mips;
+    std::vector<uint8_t> chain(g4f_mipgen_chain_bytes(w, h, levels));
+    if (g4f_mipgen_build_chain_rgba8(pixels.data(), w, h, 0, levels, filter, flags, jobs, chain.data()) != levels) return false;
+    std::vector<uint8_t> blocks(g4f_bcn_chain_bytes(format, w, h, levels));
+    return g4f_bcn_encode_chain_rgba8(chain.data(), w, h, levels, format, quality, jobs, blocks.data()) &&
+           g4f_pack_writer_add_texture(writer, name, format, w, h, levels, blocks.data(), blocks.size());
+}
+
+static int listPack(const char* path) {
+    g4f_pack* pack = g4f_pack_open(path);
+    if (!pack) {
+        std::fprintf(stderr, "%s\n", g4f_last_error());
+        return 1;
+    }
+    static const char* const kTypes[] = {"blob", "mesh", "texture"};
+    static const char* const kFormats[] = {"rgba8", "bc1", "bc3", "bc7"};
+    for (int i = 0; i < g4f_pack_entry_count(pack); i++) {
+        g4f_pack_entry e{};
+        g4f_pack_get(pack, i, &e);
+        std::printf("%-8s %10zu  %s", kTypes[e.type], e.size, e.name);
+        if (e.type == G4F_PACK_ENTRY_MESH) std::printf("  (%d vertices, %d triangles)", e.vertexCount, e.indexCount / 3);
+        if (e.type == G4F_PACK_ENTRY_TEXTURE) std::printf("  (%s %dx%d, %d levels)", kFormats[e.format], e.width, e.height, e.mipLevels);
+        std::printf("\n");
+    }
+    g4f_pack_close(pack);
+    return 0;
+}
+
+static int usage() {
+    std::fprintf(stderr,
+                 "usage: g4f_pack out.pack [--mips N] [--filter box|kaiser] [--wrap|--clamp] [--linear|--srgb]\n"
+                 "                [--format rgba8|bc1|bc3|bc7] [--quality fast|normal|high]\n"
+                 "                [--blob name=path] [--obj name=path] [--rgba name=path:WxH] [--image name=path] ...\n"
+                 "       g4f_pack --list in.pack\n");
+    return 2;
+}
+
+int main(int argc, char** argv) {
+    if (argc == 3 && std::strcmp(argv[1], "--list") == 0) return listPack(argv[2]);
+    if (argc < 2 || argv[1][0] == '-') return usage();
+
+    g4f_jobs* jobs = g4f_jobs_create(0);
+    g4f_pack_writer* writer = g4f_pack_writer_create();
+    int mips = 0, filter = G4F_MIPGEN_FILTER_BOX, flags = 0;
+    int format = G4F_PACK_FORMAT_RGBA8, quality = G4F_BCN_QUALITY_NORMAL;
+    int entries = 0;
+    bool ok = true;
+    for (int i = 2; i < argc && ok; i++) {
+        const std::string opt = argv[i];
+        const char* value = i + 1 < argc ? argv[i + 1] : nullptr;
+        std::string name, path;
+        if (opt == "--wrap") {
+            flags |= G4F_MIPGEN_FLAG_WRAP;
+        } else if (opt == "--clamp") {
+            flags &= ~G4F_MIPGEN_FLAG_WRAP;
+        } else if (opt == "--linear") {
+            flags |= G4F_MIPGEN_FLAG_LINEAR;
+        } else if (opt == "--srgb") {
+            flags &= ~G4F_MIPGEN_FLAG_LINEAR;
+        } else if (opt == "--mips" && value) {
+            mips = std::atoi(value);
+            i++;
+        } else if (opt == "--filter" && value) {
+            filter = std::strcmp(value, "kaiser") == 0 ? G4F_MIPGEN_FILTER_KAISER : G4F_MIPGEN_FILTER_BOX;
+            i++;
+        } else if (opt == "--format" && value) {
+            static const char* const kFormats[] = {"rgba8", "bc1", "bc3", "bc7"};
+            format = -1;
+            for (int f = 0; f < 4; f++) {
+                if (std::strcmp(value, kFormats[f]) == 0) format = f;
+            }
+            ok = format >= 0;
+            if (!ok) usage();
+            i++;
+        } else if (opt == "--quality" && value) {
+            quality = std::strcmp(value, "fast") == 0 ? G4F_BCN_QUALITY_FAST : (std::strcmp(value, "high") == 0 ? G4F_BCN_QUALITY_HIGH : G4F_BCN_QUALITY_NORMAL);
+            i++;
+        } else if ((opt == "--blob" || opt == "--obj" || opt == "--rgba" || opt == "--image") && value && splitEntry(value, &name, &path)) {
+            i++;
+            entries++;
+            g4f_clear_error();
+            if (opt == "--blob") {
+                std::vector<uint8_t> bytes;
+                ok = readFile(path, &bytes) && g4f_pack_writer_add_blob(writer, name.c_str(), bytes.data(), bytes.size());
+            } else if (opt == "--obj") {
+                std::vector<g4f_gfx_vertex_p3n3uv2> vertices;
+                std::vector<uint16_t> indices;
+                ok = loadObj(path, &vertices, &indices) &&
+                     g4f_pack_writer_add_mesh(writer, name.c_str(), vertices.data(), (int)vertices.size(), indices.data(), (int)indices.size());
+            } else if (opt == "--image") {
+                std::vector<uint8_t> bytes, pixels;
+                int imageFormat = 0, w = 0, h = 0;
+                ok = readFile(path, &bytes) && g4f_image_info(bytes.data(), bytes.size(), &imageFormat, &w, &h);
+                if (ok) pixels.resize((size_t)w * (size_t)h * 4);
+                ok = ok && g4f_image_decode_rgba8(bytes.data(), bytes.size(), pixels.data(), 0) &&
+                     addTexture(writer, name.c_str(), w, h, pixels, mips, filter, flags, format, quality, jobs);
+            } else {
+                int w = 0, h = 0;
+                const size_t colon = path.rfind(':');
+                std::vector<uint8_t> pixels;
+                ok = colon != std::string::npos && std::sscanf(path.c_str() + colon + 1, "%dx%d", &w, &h) == 2 && w > 0 && h > 0;
+                if (ok) path.resize(colon);
+                ok = ok && readFile(path, &pixels) && pixels.size() == (size_t)w * (size_t)h * 4 &&
+                     addTexture(writer, name.c_str(), w, h, pixels, mips, filter, flags, format, quality, jobs);
+            }
+            if (!ok) {
+                const char* reason = g4f_last_error()[0] ? g4f_last_error() : "cannot read or parse the input";
+                std::fprintf(stderr, "g4f_pack: cannot add %s '%s' from '%s': %s\n", opt.c_str() + 2, name.c_str(), path.c_str(), reason);
+            }
+        } else {
+            ok = false;
+            usage();
+        }
+    }
+    if (ok && !g4f_pack_writer_save(writer, argv[1])) {
+        std::fprintf(stderr, "g4f_pack: %s\n", g4f_last_error());
+        ok = false;
+    }
+    g4f_pack_writer_destroy(writer);
+    g4f_jobs_destroy(jobs);
+    if (ok) std::printf("g4f_pack: wrote %d entries to %s\n", entries, argv[1]);
+    return ok ? 0 : 1;
+}